@@ -67,6 +67,7 @@ SamplerState g_LinearClampSampler : register (s1);
 cbuffer cbSF : register( b0 )
 {
     float4    g_f4OutputSize;   // x = Width, y = Height, z = Inv Width, w = Inv Height
+    int4      g_i4DispatchOrigin; // xy = Coord of the first pixel of group ( 0, 0 ) in the CS, zw unused
 }
 
 
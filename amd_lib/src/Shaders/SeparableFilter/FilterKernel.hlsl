@@ -28,6 +28,66 @@
 //--------------------------------------------------------------------------------------
 
 
+//--------------------------------------------------------------------------------------
+// Offset of the bilinear sample that the approximate filter's PS path takes for an
+// iteration, between the texel of the iteration and the next. Filters can define this
+// per iteration, so that the merged pair of taps is weighted exactly.
+//--------------------------------------------------------------------------------------
+#ifndef KERNEL_SAMPLE_OFFSET
+    #define KERNEL_SAMPLE_OFFSET( _iIteration ) ( 0.5f )
+#endif
+
+
+//--------------------------------------------------------------------------------------
+// Filters that define KERNEL_LERP_SAMPLES( _RDI0, _RDI1, _fOffset, _RDIOut ) have the CS of
+// the approximate filter store the texels themselves in the LDS, and blend each pair it
+// reads by KERNEL_SAMPLE_OFFSET, as the bilinear sample of the PS does. Otherwise the LDS
+// holds the samples half way between texels.
+//--------------------------------------------------------------------------------------
+#if ( USE_APPROXIMATE_FILTER == 1 ) && defined( KERNEL_LERP_SAMPLES )
+
+    #define LERP_LDS_READS      ( 1 )
+    #define LDS_SAMPLE_OFFSET   ( 0.0f )
+
+#else
+
+    #define LERP_LDS_READS      ( 0 )
+    #define LDS_SAMPLE_OFFSET   ( 0.5f )
+
+#endif
+
+
+//--------------------------------------------------------------------------------------
+// Filters that define KERNEL_GATHER_RADIUS( _RAWDataItem ), the distance in texels that a
+// sample reaches, give taps beyond the reach of both it and the center no weight. The CS
+// then only iterates over the taps within the largest reach in the LDS of the group, so
+// every thread of a group runs the same number of iterations, and a group in which no
+// sample reaches past its center runs none. With the approximate filter the reach is that
+// of the merged samples in the LDS.
+//--------------------------------------------------------------------------------------
+#if ( USE_COMPUTE_SHADER == 1 ) && defined( KERNEL_GATHER_RADIUS )
+
+    groupshared uint g_uGatherRadius;
+
+    #define GATHER_RADIUS_CLEAR( _GTid ) \
+        if ( 0 == _GTid.x && 0 == _GTid.y ) { g_uGatherRadius = 0; } \
+        GroupMemoryBarrierWithGroupSync();
+
+    #define GATHER_RADIUS_SAMPLE( _RAWDataItem, _uRadius ) \
+        _uRadius = max( _uRadius, (uint)ceil( KERNEL_GATHER_RADIUS( _RAWDataItem ) ) );
+
+    #define GATHER_RADIUS_STORE( _uRadius ) \
+        InterlockedMax( g_uGatherRadius, _uRadius );
+
+#else
+
+    #define GATHER_RADIUS_CLEAR( _GTid )
+    #define GATHER_RADIUS_SAMPLE( _RAWDataItem, _uRadius )
+    #define GATHER_RADIUS_STORE( _uRadius )
+
+#endif
+
+
 //--------------------------------------------------------------------------------------
 // Samples from inputs defined by the SampleFromInput macro
 //--------------------------------------------------------------------------------------
@@ -63,6 +123,23 @@ RAWDataItem Sample( int2 i2Position, float2 f2Offset )
             READ_FROM_LDS( _iLineOffset, ( _iPixelOffset + _iIteration + iPixel ), _RDI[(PIXELS_PER_THREAD - STEP_SIZE + iPixel)] ) }
 
 
+    //--------------------------------------------------------------------------------------
+    // Macros for blending the pairs of texels of an iteration when the LDS holds texels. The
+    // PIXELS_PER_THREAD + 1 texels of an iteration are cached in the GPRs as above.
+    //--------------------------------------------------------------------------------------
+    #define CACHE_LDS_TEXELS( _iIteration, _iLineOffset, _iPixelOffset, _RDITexel ) \
+        /* Trickle LDS values down within the GPRs*/ \
+        [unroll] for ( iPixel = 0; iPixel < PIXELS_PER_THREAD + 1 - STEP_SIZE; ++iPixel ) { \
+            _RDITexel[iPixel] = _RDITexel[iPixel + STEP_SIZE]; } \
+        /* Load new LDS value(s) */ \
+        [unroll] for ( iPixel = 0; iPixel < STEP_SIZE; ++iPixel ) { \
+            READ_FROM_LDS( _iLineOffset, ( _iPixelOffset + _iIteration + iPixel ), _RDITexel[(PIXELS_PER_THREAD + 1 - STEP_SIZE + iPixel)] ) }
+
+    #define LERP_LDS_TEXELS( _iIteration, _RDITexel, _RDI ) \
+        [unroll] for ( iPixel = 0; iPixel < PIXELS_PER_THREAD; ++iPixel ) { \
+            KERNEL_LERP_SAMPLES( _RDITexel[iPixel], _RDITexel[iPixel + 1], KERNEL_SAMPLE_OFFSET( _iIteration ), _RDI[iPixel] ) }
+
+
     //--------------------------------------------------------------------------------------
     // Defines the filter kernel logic. User supplies macro's for custom filter
     //--------------------------------------------------------------------------------------
@@ -73,7 +150,7 @@ RAWDataItem Sample( int2 i2Position, float2 f2Offset )
         int iPixel, iIteration;
         RAWDataItem RDI[PIXELS_PER_THREAD];
 
-        #if ( USE_APPROXIMATE_FILTER == 1 )
+        #if ( USE_APPROXIMATE_FILTER == 1 ) && ( LERP_LDS_READS == 0 )
 
             // Read the kernel center values in directly from the input surface(s), as the LDS
             // values are pre-filtered, and therefore do not represent the kernel center
@@ -99,6 +176,113 @@ RAWDataItem Sample( int2 i2Position, float2 f2Offset )
         // Macro defines what happens at the kernel center
         KERNEL_CENTER( KD, iPixel, PIXELS_PER_THREAD, Output, RDI )
 
+    #if defined( KERNEL_GATHER_RADIUS )
+
+        // Only the iterations within the reach of the group, read straight from the LDS as
+        // the loops are not unrolled
+        int iGatherRadius = min( int( ( g_uGatherRadius + STEP_SIZE - 1 ) / STEP_SIZE ) * STEP_SIZE, KERNEL_RADIUS );
+
+        // First half of the kernel
+        [loop]
+        for ( iIteration = KERNEL_RADIUS - iGatherRadius; iIteration < KERNEL_RADIUS; iIteration += STEP_SIZE )
+        {
+            #if ( LERP_LDS_READS == 1 )
+
+                RAWDataItem RDITexel[PIXELS_PER_THREAD + 1];
+                [unroll]
+                for ( iPixel = 0; iPixel < PIXELS_PER_THREAD + 1; ++iPixel )
+                {
+                    READ_FROM_LDS( iLineOffset, ( iPixelOffset + iIteration + iPixel ), RDITexel[iPixel] )
+                }
+                LERP_LDS_TEXELS( iIteration, RDITexel, RDI )
+
+            #else
+
+                [unroll]
+                for ( iPixel = 0; iPixel < PIXELS_PER_THREAD; ++iPixel )
+                {
+                    READ_FROM_LDS( iLineOffset, ( iPixelOffset + iIteration + iPixel ), RDI[iPixel] )
+                }
+
+            #endif
+
+            KERNEL_ITERATION( iIteration, KD, iPixel, PIXELS_PER_THREAD, Output, RDI )
+        }
+
+        // Second half of the kernel
+        [loop]
+        for ( iIteration = KERNEL_RADIUS + 1; iIteration <= KERNEL_RADIUS + iGatherRadius; iIteration += STEP_SIZE )
+        {
+            #if ( LERP_LDS_READS == 1 )
+
+                RAWDataItem RDITexel[PIXELS_PER_THREAD + 1];
+                [unroll]
+                for ( iPixel = 0; iPixel < PIXELS_PER_THREAD + 1; ++iPixel )
+                {
+                    READ_FROM_LDS( iLineOffset, ( iPixelOffset + iIteration + iPixel ), RDITexel[iPixel] )
+                }
+                LERP_LDS_TEXELS( iIteration, RDITexel, RDI )
+
+            #else
+
+                [unroll]
+                for ( iPixel = 0; iPixel < PIXELS_PER_THREAD; ++iPixel )
+                {
+                    READ_FROM_LDS( iLineOffset, ( iPixelOffset + iIteration + iPixel ), RDI[iPixel] )
+                }
+
+            #endif
+
+            KERNEL_ITERATION( iIteration, KD, iPixel, PIXELS_PER_THREAD, Output, RDI )
+        }
+
+    #elif ( LERP_LDS_READS == 1 )
+
+        RAWDataItem RDITexel[PIXELS_PER_THREAD + 1];
+
+        // Prime the GPRs for the first half of the kernel
+        [unroll]
+        for ( iPixel = 0; iPixel < PIXELS_PER_THREAD + 1; ++iPixel )
+        {
+            READ_FROM_LDS( iLineOffset, ( iPixelOffset + iPixel ), RDITexel[iPixel] )
+        }
+
+        // Increment the LDS offset by PIXELS_PER_THREAD + 1
+        iPixelOffset += PIXELS_PER_THREAD + 1;
+
+        // First half of the kernel
+        [unroll]
+        for ( iIteration = 0; iIteration < KERNEL_RADIUS; iIteration += STEP_SIZE )
+        {
+            // Blend the pairs of texels, then the macro defines what happens for each kernel iteration
+            LERP_LDS_TEXELS( iIteration, RDITexel, RDI )
+            KERNEL_ITERATION( iIteration, KD, iPixel, PIXELS_PER_THREAD, Output, RDI )
+
+            // Macro to cache LDS reads in GPRs
+            CACHE_LDS_TEXELS( iIteration, iLineOffset, iPixelOffset, RDITexel )
+        }
+
+        // Prime the GPRs for the second half of the kernel
+        [unroll]
+        for ( iPixel = 0; iPixel < PIXELS_PER_THREAD + 1; ++iPixel )
+        {
+            READ_FROM_LDS( iLineOffset, ( iPixelOffset - ( PIXELS_PER_THREAD + 1 ) + iIteration + 1 + iPixel ), RDITexel[iPixel] )
+        }
+
+        // Second half of the kernel
+        [unroll]
+        for ( iIteration = KERNEL_RADIUS + 1; iIteration < KERNEL_DIAMETER; iIteration += STEP_SIZE )
+        {
+            // Blend the pairs of texels, then the macro defines what happens for each kernel iteration
+            LERP_LDS_TEXELS( iIteration, RDITexel, RDI )
+            KERNEL_ITERATION( iIteration, KD, iPixel, PIXELS_PER_THREAD, Output, RDI )
+
+            // Macro to cache LDS reads in GPRs
+            CACHE_LDS_TEXELS( iIteration, iLineOffset, iPixelOffset, RDITexel )
+        }
+
+    #else
+
         // Prime the GPRs for the first half of the kernel
         [unroll]
         for ( iPixel = 0; iPixel < PIXELS_PER_THREAD; ++iPixel )
@@ -138,6 +322,8 @@ RAWDataItem Sample( int2 i2Position, float2 f2Offset )
             CACHE_LDS_READS( iIteration, iLineOffset, iPixelOffset, RDI )
         }
 
+    #endif
+
         // Macros define final weighting and output
         KERNEL_FINAL_WEIGHT( KD, iPixel, PIXELS_PER_THREAD, Output )
         KERNEL_OUTPUT( i2Center, i2Inc, iPixel, PIXELS_PER_THREAD, Output, KD )
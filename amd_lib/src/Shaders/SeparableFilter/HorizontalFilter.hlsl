@@ -39,23 +39,33 @@
         int iSampleOffset = GTid.x * SAMPLES_PER_THREAD;
         int iLineOffset = GTid.y;
 
-        // Group and pixel coords from group IDs
-        int2 i2GroupCoord = int2( ( Gid.x * RUN_SIZE ) - KERNEL_RADIUS, ( Gid.y * RUN_LINES ) );
+        // Group and pixel coords from group IDs, offset to the origin of the dispatch
+        int2 i2GroupCoord = int2( ( Gid.x * RUN_SIZE ) - KERNEL_RADIUS, ( Gid.y * RUN_LINES ) ) + g_i4DispatchOrigin.xy;
         int2 i2Coord = int2( i2GroupCoord.x + iSampleOffset, i2GroupCoord.y );
 
+        // The reach of the group is gathered as the LDS is filled
+        uint uGatherRadius = 0;
+        GATHER_RADIUS_CLEAR( GTid )
+
         // Sample and store to LDS
         [unroll]
         for ( int i = 0; i < SAMPLES_PER_THREAD; ++i )
         {
-            WRITE_TO_LDS( Sample( i2Coord + int2( i, GTid.y ), float2( 0.5f, 0.0f ) ), iLineOffset, iSampleOffset + i )
+            RAWDataItem RDI = Sample( i2Coord + int2( i, GTid.y ), float2( LDS_SAMPLE_OFFSET, 0.0f ) );
+            WRITE_TO_LDS( RDI, iLineOffset, iSampleOffset + i )
+            GATHER_RADIUS_SAMPLE( RDI, uGatherRadius )
         }
 
         // Optionally load some extra texels as required by the exact kernel size
         if ( GTid.x < EXTRA_SAMPLES )
         {
-            WRITE_TO_LDS( Sample( i2GroupCoord + int2( RUN_SIZE_PLUS_KERNEL - 1 - GTid.x, GTid.y ), float2( 0.5f, 0.0f ) ), iLineOffset, RUN_SIZE_PLUS_KERNEL - 1 - GTid.x )
+            RAWDataItem RDI = Sample( i2GroupCoord + int2( RUN_SIZE_PLUS_KERNEL - 1 - GTid.x, GTid.y ), float2( LDS_SAMPLE_OFFSET, 0.0f ) );
+            WRITE_TO_LDS( RDI, iLineOffset, RUN_SIZE_PLUS_KERNEL - 1 - GTid.x )
+            GATHER_RADIUS_SAMPLE( RDI, uGatherRadius )
         }
 
+        GATHER_RADIUS_STORE( uGatherRadius )
+
         // Sync threads
         GroupMemoryBarrierWithGroupSync();
 
@@ -103,7 +113,7 @@
         for ( iIteration = 0; iIteration < KERNEL_RADIUS; iIteration += STEP_SIZE )
         {
             // Load the sample(s) for this iteration
-            RDI[0] = Sample( int2( i2KernelCenter.x + iIteration, i2KernelCenter.y ), float2( 0.5f, 0.0f ) );
+            RDI[0] = Sample( int2( i2KernelCenter.x + iIteration, i2KernelCenter.y ), float2( KERNEL_SAMPLE_OFFSET( iIteration ), 0.0f ) );
 
             // Macro defines what happens for each kernel iteration
             KERNEL_ITERATION( iIteration, KD, iPixel, 1, Output, RDI )
@@ -114,7 +124,7 @@
         for ( iIteration = KERNEL_RADIUS + 1; iIteration < KERNEL_DIAMETER; iIteration += STEP_SIZE )
         {
             // Load the sample(s) for this iteration
-            RDI[0] = Sample( int2( i2KernelCenter.x + iIteration, i2KernelCenter.y ), float2( 0.5f, 0.0f ) );
+            RDI[0] = Sample( int2( i2KernelCenter.x + iIteration, i2KernelCenter.y ), float2( KERNEL_SAMPLE_OFFSET( iIteration ), 0.0f ) );
 
             // Macro defines what happens for each kernel iteration
             KERNEL_ITERATION( iIteration, KD, iPixel, 1, Output, RDI )
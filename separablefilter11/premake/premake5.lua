@@ -20,6 +20,13 @@ externalproject "AMD_SDK_Minimal"
    filename ("AMD_SDK_Minimal" .. _AMD_VS_SUFFIX)
    uuid "EBB939DC-98E4-49DF-B1F1-D2E80A11F60A"
 
+externalproject "AMD_LIB_Minimal"
+   kind "StaticLib"
+   language "C++"
+   location "../../AMD_LIB/build"
+   filename ("AMD_LIB_Minimal" .. _AMD_VS_SUFFIX)
+   uuid "0D2AEA47-7909-69E3-8221-F4B9EE7FCF44"
+
 externalproject "DXUT"
    kind "StaticLib"
    language "C++"
@@ -53,7 +60,7 @@ project (_AMD_SAMPLE_NAME)
 
    files { "../src/**.h", "../src/**.cpp", "../src/**.rc", "../src/**.manifest", "../src/**.hlsl" }
    includedirs { "../src/ResourceFiles" }
-   links { "AMD_SDK_Minimal", "DXUT", "DXUTOpt", "d3dcompiler", "dxguid", "winmm", "comctl32", "Usp10", "Shlwapi" }
+   links { "AMD_LIB_Minimal", "AMD_SDK_Minimal", "DXUT", "DXUTOpt", "d3dcompiler", "dxguid", "winmm", "comctl32", "Usp10", "Shlwapi" }
 
    filter "configurations:Debug"
       defines { "WIN32", "_DEBUG", "DEBUG", "PROFILE", "_WINDOWS", "_WIN32_WINNT=0x0601" }
@@ -65,3 +72,31 @@ project (_AMD_SAMPLE_NAME)
       flags { "LinkTimeOptimization", "Symbols", "FatalWarnings", "Unicode", "WinMain" }
       targetsuffix ("_Release" .. _AMD_VS_SUFFIX)
       optimize "On"
+
+project "CPUFilterTest"
+   kind "ConsoleApp"
+   language "C++"
+   location "../build"
+   filename ("CPUFilterTest" .. _AMD_VS_SUFFIX)
+   targetdir "../bin"
+   objdir "../build/%{_AMD_SAMPLE_DIR_LAYOUT}/CPUFilterTest"
+   warnings "Extra"
+   floatingpoint "Fast"
+
+   -- Specify WindowsTargetPlatformVersion here for VS2015
+   windowstarget (_AMD_WIN_SDK_VERSION)
+
+   files { "../src/CPU/**.h", "../src/CPU/**.inl", "../src/CPU/**.cpp", "../test/**.h", "../test/**.cpp" }
+   vpaths { ["CPU"] = "../src/CPU/**", ["*"] = "../test/**" }
+   includedirs { "../src" }
+
+   filter "configurations:Debug"
+      defines { "WIN32", "_DEBUG", "DEBUG", "PROFILE", "_CONSOLE", "_WIN32_WINNT=0x0601" }
+      flags { "Symbols", "FatalWarnings", "Unicode" }
+      targetsuffix ("_Debug" .. _AMD_VS_SUFFIX)
+
+   filter "configurations:Release"
+      defines { "WIN32", "NDEBUG", "PROFILE", "_CONSOLE", "_WIN32_WINNT=0x0601" }
+      flags { "LinkTimeOptimization", "Symbols", "FatalWarnings", "Unicode" }
+      targetsuffix ("_Release" .. _AMD_VS_SUFFIX)
+      optimize "On"
@@ -0,0 +1,170 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: ApronSurface.cpp
+//
+// Implements the surface with an apron, and the filling of the apron.
+//--------------------------------------------------------------------------------------
+
+
+#include "ApronSurface.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Allocates the surface. The apron on the left is rounded up to whole alignments, so
+    // the texels inside stay aligned.
+    //--------------------------------------------------------------------------------------
+    bool ApronSurface::Create( unsigned int uWidth, unsigned int uHeight, int iApron )
+    {
+        assert( uWidth > 0 && uHeight > 0 && iApron >= 0 );
+
+        Release();
+
+        const unsigned int uTexelsPerAlignment = (unsigned int)( MEMORY_ALIGNMENT / sizeof( Float4 ) );
+        const unsigned int uLeft = DivRoundUp( (unsigned int)iApron, uTexelsPerAlignment ) * uTexelsPerAlignment;
+        const unsigned int uPitch = DivRoundUp( uLeft + uWidth + (unsigned int)iApron, uTexelsPerAlignment ) * uTexelsPerAlignment;
+
+        m_pData = (Float4*)AlignedMalloc( (size_t)uPitch * ( uHeight + 2 * iApron ) * sizeof( Float4 ) );
+        if( NULL == m_pData )
+        {
+            return false;
+        }
+
+        m_pOrigin = m_pData + (size_t)iApron * uPitch + uLeft;
+        m_uWidth = uWidth;
+        m_uHeight = uHeight;
+        m_uPitch = uPitch;
+        m_iApron = iApron;
+
+        return true;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Frees the surface
+    //--------------------------------------------------------------------------------------
+    void ApronSurface::Release()
+    {
+        AlignedFree( m_pData );
+
+        m_pData = m_pOrigin = NULL;
+        m_uWidth = m_uHeight = m_uPitch = 0;
+        m_iApron = 0;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Wraps the texels inside the apron
+    //--------------------------------------------------------------------------------------
+    void ApronSurface::GetInterior( Surface& View )
+    {
+        assert( NULL != m_pOrigin );
+
+        View.CreateView( m_pOrigin, m_uWidth, m_uHeight, m_uPitch );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Copies a surface inside the apron
+    //--------------------------------------------------------------------------------------
+    void ApronSurface::CopyFrom( const Surface& Source )
+    {
+        assert( Source.m_uWidth == m_uWidth && Source.m_uHeight == m_uHeight );
+
+        for( int iY = 0; iY < (int)m_uHeight; ++iY )
+        {
+            memcpy( Row( iY ), Source.Row( iY ), sizeof( Float4 ) * m_uWidth );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Fills the apron left and right of each row inside it
+    //--------------------------------------------------------------------------------------
+    void ApronSurface::FillApronColumns( BORDER_MODE_TYPE BorderMode, const Float4& BorderColor )
+    {
+        assert( BorderMode < BORDER_MODE_TYPE_MAX );
+
+        const int iWidth = (int)m_uWidth;
+
+        for( int iY = 0; iY < (int)m_uHeight; ++iY )
+        {
+            Float4* pRow = Row( iY );
+
+            for( int iX = 1; iX <= m_iApron; ++iX )
+            {
+                if( BORDER_MODE_TYPE_CONSTANT == BorderMode )
+                {
+                    pRow[-iX] = BorderColor;
+                    pRow[iWidth - 1 + iX] = BorderColor;
+                }
+                else
+                {
+                    pRow[-iX] = pRow[BorderTexel( BorderMode, -iX, iWidth )];
+                    pRow[iWidth - 1 + iX] = pRow[BorderTexel( BorderMode, iWidth - 1 + iX, iWidth )];
+                }
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Fills the rows of the apron above and below, across the full width including the
+    // apron, by copying the rows they map to
+    //--------------------------------------------------------------------------------------
+    void ApronSurface::FillApronRows( BORDER_MODE_TYPE BorderMode, const Float4& BorderColor )
+    {
+        assert( BorderMode < BORDER_MODE_TYPE_MAX );
+
+        const int iHeight = (int)m_uHeight;
+        const int iFullWidth = (int)m_uWidth + 2 * m_iApron;
+
+        for( int iY = 1; iY <= m_iApron; ++iY )
+        {
+            Float4* pAbove = Row( -iY ) - m_iApron;
+            Float4* pBelow = Row( iHeight - 1 + iY ) - m_iApron;
+
+            if( BORDER_MODE_TYPE_CONSTANT == BorderMode )
+            {
+                for( int iX = 0; iX < iFullWidth; ++iX )
+                {
+                    pAbove[iX] = BorderColor;
+                    pBelow[iX] = BorderColor;
+                }
+            }
+            else
+            {
+                memcpy( pAbove, Row( BorderTexel( BorderMode, -iY, iHeight ) ) - m_iApron, sizeof( Float4 ) * iFullWidth );
+                memcpy( pBelow, Row( BorderTexel( BorderMode, iHeight - 1 + iY, iHeight ) ) - m_iApron, sizeof( Float4 ) * iFullWidth );
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,130 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: ApronSurface.h
+//
+// A surface with an apron of texels around it, filled from the texels inside by one of
+// the border modes. Passes reading an apron surface fetch the texels beyond the edges
+// like any others, so their loops need no clamping, and border modes other than the
+// clamp of g_LinearClampSampler are supported, such as mirror and wrap for tiling
+// textures.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+
+
+namespace CPUFilter
+{
+    // Border mode enumeration, how texels beyond the edges are addressed
+    typedef enum _BORDER_MODE_TYPE
+    {
+        BORDER_MODE_TYPE_CLAMP,     // The edge texel, as g_LinearClampSampler
+        BORDER_MODE_TYPE_MIRROR,    // Reflected, repeating the edge texel, as D3D11_TEXTURE_ADDRESS_MIRROR
+        BORDER_MODE_TYPE_WRAP,      // Repeated, as D3D11_TEXTURE_ADDRESS_WRAP
+        BORDER_MODE_TYPE_CONSTANT,  // A constant color, as D3D11_TEXTURE_ADDRESS_BORDER
+        BORDER_MODE_TYPE_MAX
+    }BORDER_MODE_TYPE;
+
+
+    //--------------------------------------------------------------------------------------
+    // Maps a coordinate to one of iSize texels with a border mode other than constant
+    //--------------------------------------------------------------------------------------
+    inline int BorderTexel( BORDER_MODE_TYPE BorderMode, int iCoord, int iSize )
+    {
+        assert( BORDER_MODE_TYPE_CONSTANT != BorderMode && iSize > 0 );
+
+        switch( BorderMode )
+        {
+        case BORDER_MODE_TYPE_MIRROR:
+            {
+                const int iPeriod = 2 * iSize;
+                const int iMirrored = ( ( iCoord % iPeriod ) + iPeriod ) % iPeriod;
+                return ( iMirrored < iSize ) ? iMirrored : ( iPeriod - 1 - iMirrored );
+            }
+        case BORDER_MODE_TYPE_WRAP:
+            return ( ( iCoord % iSize ) + iSize ) % iSize;
+        default:
+            return Clamp( iCoord, 0, iSize - 1 );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // A 2D surface of Float4 texels with an apron on every side. Rows are addressed from -Apron
+    // to Height + Apron - 1, and texels from -Apron to Width + Apron - 1. The first texel
+    // inside the apron of every row is aligned to MEMORY_ALIGNMENT.
+    //--------------------------------------------------------------------------------------
+    class ApronSurface
+    {
+    public:
+
+        ApronSurface() : m_pData( NULL ), m_pOrigin( NULL ), m_uWidth( 0 ), m_uHeight( 0 ), m_uPitch( 0 ), m_iApron( 0 ) {}
+        ~ApronSurface() { Release(); }
+
+        // Allocates the surface, with an apron as wide as the largest kernel radius it is read with
+        bool Create( unsigned int uWidth, unsigned int uHeight, int iApron );
+        void Release();
+
+        // Wraps the texels inside the apron, for passes that write to them, or that clamp
+        void GetInterior( Surface& View );
+
+        // Copies a surface of the same size inside the apron
+        void CopyFrom( const Surface& Source );
+
+        // Fills the apron from the texels inside it. The columns left and right of the rows
+        // inside are all a horizontal pass reads, and the rows above and below are all a
+        // vertical pass reads. The rows are filled across the full width, so the corners are
+        // also right if the columns were filled first.
+        void FillApronColumns( BORDER_MODE_TYPE BorderMode, const Float4& BorderColor );
+        void FillApronRows( BORDER_MODE_TYPE BorderMode, const Float4& BorderColor );
+        void FillApron( BORDER_MODE_TYPE BorderMode, const Float4& BorderColor )
+        {
+            FillApronColumns( BorderMode, BorderColor );
+            FillApronRows( BorderMode, BorderColor );
+        }
+
+        Float4* Row( int iY ) { return m_pOrigin + (ptrdiff_t)iY * m_uPitch; }
+        const Float4* Row( int iY ) const { return m_pOrigin + (ptrdiff_t)iY * m_uPitch; }
+
+        Float4*         m_pData;
+        Float4*         m_pOrigin;      // Texel ( 0, 0 )
+        unsigned int    m_uWidth;       // Inside the apron
+        unsigned int    m_uHeight;
+        unsigned int    m_uPitch;       // In texels
+        int             m_iApron;
+
+    private:
+
+        ApronSurface( const ApronSurface& );
+        ApronSurface& operator=( const ApronSurface& );
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,244 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: BilateralFilter.h
+//
+// The CPU equivalent of BilateralFilter.hlsl. It uses the scene depth to compute a focal
+// region that is in turn used to determine how blurry a pixel should be. This mimics the
+// common DoF effect, with output identical to the shader. SetGather gives the variable
+// radius gather filter of BILATERAL_GATHER_FILTER, with all the taps evaluated as in the
+// pixel shaders.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "GaussianFilter.h"
+
+
+namespace CPUFilter
+{
+    // Defines
+    static const float FOCAL_END        = 20.0f;
+    static const float FOCAL_END_RAMP   = 5.0f;
+
+
+    //--------------------------------------------------------------------------------------
+    // HLSL smoothstep
+    //--------------------------------------------------------------------------------------
+    inline float SmoothStep( float fMin, float fMax, float fX )
+    {
+        float fT = Saturate( ( fX - fMin ) / ( fMax - fMin ) );
+
+        return fT * fT * ( 3.0f - 2.0f * fT );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Converts a depth buffer value to view space depth, with g_f4ProjParams
+    //--------------------------------------------------------------------------------------
+    inline float LinearizeDepth( float fDepth, const float fProjParams[4] )
+    {
+        return -fProjParams[0] / ( fDepth - fProjParams[1] );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Bilateral filter class. g_txColor is input 0, g_txDepth is input 1 (depth in x). The
+    // horizontal pass outputs the focal value in w, which the vertical pass reads back.
+    //--------------------------------------------------------------------------------------
+    template< PASS_TYPE Pass >
+    class BilateralFilter : public FilterPass
+    {
+    public:
+
+        // Uncompressed data as sampled from inputs
+        struct RAWDataItem
+        {
+            Float3 f3Color;
+            float fDepth;
+            float fFocal;
+        };
+
+        // Data stored in the LDS
+        typedef RAWDataItem LDSItem;
+
+        // Data stored for a kernel
+        struct KernelData
+        {
+            float fWeight;
+            float fWeightSum;
+            float fCenterDepth;
+            float fCenterFocal;
+        };
+
+        // CS output structure
+        struct Output
+        {
+            Float4 f4Color[PIXELS_PER_THREAD];
+        };
+
+        BilateralFilter() : m_bGather( false )
+        {
+            memset( m_fProjParams, 0, sizeof( m_fProjParams ) );
+            SetKernel( m_iKernelRadius, false );
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Sets g_f4ProjParams ( [0] = fQTimesZNear, [1] = fQ )
+        //--------------------------------------------------------------------------------------
+        void SetProjParams( const float fProjParams[4] )
+        {
+            memcpy( m_fProjParams, fProjParams, sizeof( m_fProjParams ) );
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Equivalent of the BILATERAL_GATHER_FILTER compile time define
+        //--------------------------------------------------------------------------------------
+        void SetGather( bool bGather ) { m_bGather = bGather; }
+
+
+        //--------------------------------------------------------------------------------------
+        // The weights get computed once per kernel, as the HLSL compiles them to constants
+        //--------------------------------------------------------------------------------------
+        virtual void SetKernel( int iKernelRadius, bool bApproximate )
+        {
+            FilterPass::SetKernel( iKernelRadius, bApproximate );
+
+            const float fDeviation = (float)m_iKernelRadius * 0.5f;
+            m_fCenterWeight = GaussianWeight( 0.0f, fDeviation );
+            for( int iIteration = 0; iIteration < KernelDiameter(); ++iIteration )
+            {
+                m_fOffsets[iIteration] = (float)( iIteration - m_iKernelRadius ) + ( 1.0f - 1.0f / (float)m_iStepSize );
+                m_fWeights[iIteration] = GaussianWeight( m_fOffsets[iIteration], fDeviation );
+            }
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // LDS access
+        //--------------------------------------------------------------------------------------
+        void WriteToLDS( const RAWDataItem& RDI, LDSItem& LDSValue ) const { LDSValue = RDI; }
+        void ReadFromLDS( const LDSItem& LDSValue, RAWDataItem& RDI ) const { RDI = LDSValue; }
+
+
+        //--------------------------------------------------------------------------------------
+        // Sample from chosen input(s). The horizontal pass computes the focal value, which the
+        // vertical pass reads back from the alpha of its color input.
+        //--------------------------------------------------------------------------------------
+        void SampleFromInput( SAMPLER_TYPE Sampler, float fX, float fY, RAWDataItem& RDI ) const
+        {
+            Float4 f4Sample = m_pInputs[0]->Sample( Sampler, fX, fY );
+            RDI.f3Color = XYZ( f4Sample );
+            RDI.fDepth = LinearizeDepth( m_pInputs[1]->Sample( Sampler, fX, fY ).x, m_fProjParams );
+            RDI.fFocal = ( PASS_TYPE_HORIZONTAL == Pass ) ? SmoothStep( FOCAL_END, FOCAL_END + FOCAL_END_RAMP, RDI.fDepth ) : f4Sample.w;
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Compute what happens at the kernels center
+        //--------------------------------------------------------------------------------------
+        void KernelCenter( KernelData* KD, int iNumPixels, Output& O, const RAWDataItem* RDI ) const
+        {
+            for( int iPixel = 0; iPixel < iNumPixels; ++iPixel )
+            {
+                KD[iPixel].fWeight = m_fCenterWeight;
+                KD[iPixel].fCenterDepth = RDI[iPixel].fDepth;
+                KD[iPixel].fCenterFocal = RDI[iPixel].fFocal;
+                KD[iPixel].fWeightSum = KD[iPixel].fWeight;
+                O.f4Color[iPixel] = MakeFloat4( RDI[iPixel].f3Color * KD[iPixel].fWeight, 0.0f );
+            }
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // TAP_REACH: in the gather filter, taps beyond the circle of confusion of the sample
+        // weighting them have no weight
+        //--------------------------------------------------------------------------------------
+        float TapReach( int iIteration, float fFocal ) const
+        {
+            return ( !m_bGather || fabsf( m_fOffsets[iIteration] ) <= fFocal * (float)m_iKernelRadius ) ? fFocal : 0.0f;
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Compute what happens for each iteration of the kernel. Samples in front of the
+        // center use their own focal value, so in focus foreground does not bleed.
+        //--------------------------------------------------------------------------------------
+        void KernelIteration( int iIteration, KernelData* KD, int iNumPixels, Output& O, const RAWDataItem* RDI ) const
+        {
+            for( int iPixel = 0; iPixel < iNumPixels; ++iPixel )
+            {
+                KD[iPixel].fWeight = m_fWeights[iIteration];
+                KD[iPixel].fWeight *= ( RDI[iPixel].fDepth < KD[iPixel].fCenterDepth ) ? TapReach( iIteration, RDI[iPixel].fFocal ) : TapReach( iIteration, KD[iPixel].fCenterFocal );
+                KD[iPixel].fWeightSum += KD[iPixel].fWeight;
+                O.f4Color[iPixel].x += RDI[iPixel].f3Color.x * KD[iPixel].fWeight;
+                O.f4Color[iPixel].y += RDI[iPixel].f3Color.y * KD[iPixel].fWeight;
+                O.f4Color[iPixel].z += RDI[iPixel].f3Color.z * KD[iPixel].fWeight;
+            }
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Perform final weighting operation
+        //--------------------------------------------------------------------------------------
+        void KernelFinalWeight( KernelData* KD, int iNumPixels, Output& O ) const
+        {
+            for( int iPixel = 0; iPixel < iNumPixels; ++iPixel )
+            {
+                O.f4Color[iPixel].w = ( PASS_TYPE_HORIZONTAL == Pass ) ? KD[iPixel].fCenterFocal : 1.0f;
+                O.f4Color[iPixel].x /= KD[iPixel].fWeightSum;
+                O.f4Color[iPixel].y /= KD[iPixel].fWeightSum;
+                O.f4Color[iPixel].z /= KD[iPixel].fWeightSum;
+            }
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Output to chosen surface
+        //--------------------------------------------------------------------------------------
+        void KernelOutput( int iCenterX, int iCenterY, int iIncX, int iIncY, int iNumPixels, const Output& O, const KernelData* /*KD*/ ) const
+        {
+            for( int iPixel = 0; iPixel < iNumPixels; ++iPixel )
+            {
+                m_pOutput->Row( iCenterY + iPixel * iIncY )[iCenterX + iPixel * iIncX] = O.f4Color[iPixel];
+            }
+        }
+
+    private:
+
+        float   m_fProjParams[4];
+        float   m_fCenterWeight;
+        float   m_fWeights[MAX_KERNEL_RADIUS * 2 + 1];
+        float   m_fOffsets[MAX_KERNEL_RADIUS * 2 + 1];
+        bool    m_bGather;
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,332 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: BilateralFilterSIMD.cpp
+//
+// Implements the vectorized bilateral filter passes.
+//--------------------------------------------------------------------------------------
+
+
+#include "BilateralFilterSIMD.h"
+#include "BilateralFilter.h"
+
+
+namespace CPUFilter
+{
+    // Planes per line: red, green, blue, view space depth and focal
+    static const int NUM_PLANES = 5;
+
+
+    //--------------------------------------------------------------------------------------
+    // Rounds a plane up to whole vectors of the widest instruction set
+    //--------------------------------------------------------------------------------------
+    static int PlaneStride( int iNumFloats )
+    {
+        return (int)( DivRoundUp( (unsigned int)iNumFloats, MAX_VECTOR_WIDTH ) * MAX_VECTOR_WIDTH );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    BilateralFilterSIMD::BilateralFilterSIMD()
+    {
+        m_pKernels = &GetFilterKernels();
+        memset( m_fProjParams, 0, sizeof( m_fProjParams ) );
+        m_bGather = false;
+        SetKernel( m_iKernelRadius, false );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Computes the Gaussian weights of BilateralFilter.hlsl
+    //--------------------------------------------------------------------------------------
+    void BilateralFilterSIMD::SetKernel( int iKernelRadius, bool /*bApproximate*/ )
+    {
+        FilterPass::SetKernel( iKernelRadius, false );
+
+        const float fDeviation = (float)m_iKernelRadius * 0.5f;
+        for( int iTap = 0; iTap < KernelDiameter(); ++iTap )
+        {
+            m_fWeights[iTap] = GaussianWeight( (float)( iTap - m_iKernelRadius ), fDeviation );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Forces the kernels of an instruction set supported by the CPU
+    //--------------------------------------------------------------------------------------
+    void BilateralFilterSIMD::SetISA( ISA_TYPE ISA )
+    {
+        m_pKernels = &GetFilterKernels( ISA );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sets g_f4ProjParams ( [0] = fQTimesZNear, [1] = fQ )
+    //--------------------------------------------------------------------------------------
+    void BilateralFilterSIMD::SetProjParams( const float fProjParams[4] )
+    {
+        memcpy( m_fProjParams, fProjParams, sizeof( m_fProjParams ) );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Converts part of a line to planes, clamped to the edges of the inputs
+    //--------------------------------------------------------------------------------------
+    void BilateralFilterSIMD::ConvertLine( int iY, int iX, int iCount, bool bFocalFromDepth, float* pPlanes, int iPlaneStride ) const
+    {
+        const Surface& Color = *m_pInputs[0];
+        const Surface& Depth = *m_pInputs[1];
+        const int iWidth = (int)Color.m_uWidth;
+        float* pRed = pPlanes;
+        float* pGreen = pPlanes + iPlaneStride;
+        float* pBlue = pPlanes + iPlaneStride * 2;
+        float* pDepth = pPlanes + iPlaneStride * 3;
+        float* pFocal = pPlanes + iPlaneStride * 4;
+
+        // The part of the planes that is inside the inputs
+        const int iBegin = ( iX < 0 ) ? -iX : 0;
+        const int iEnd = ( iX + iCount > iWidth ) ? ( iWidth - iX ) : iCount;
+        const Float4* pColorRow = Color.Row( Clamp( iY, 0, (int)Color.m_uHeight - 1 ) ) + iX + iBegin;
+        const Float4* pDepthRow = Depth.Row( Clamp( iY, 0, (int)Depth.m_uHeight - 1 ) ) + iX + iBegin;
+
+        m_pKernels->m_pfnDeinterleaveRow( pColorRow, iEnd - iBegin, pRed + iBegin, pGreen + iBegin, pBlue + iBegin, bFocalFromDepth ? NULL : pFocal + iBegin );
+        m_pKernels->m_pfnLinearizeDepthRow( pDepthRow, iEnd - iBegin, m_fProjParams, pDepth + iBegin, bFocalFromDepth ? pFocal + iBegin : NULL );
+
+        // The rest is clamped to the edges
+        for( int iPlane = 0; iPlane < NUM_PLANES; ++iPlane )
+        {
+            float* pPlane = pPlanes + iPlaneStride * iPlane;
+
+            for( int i = 0; i < iBegin; ++i )
+            {
+                pPlane[i] = pPlane[iBegin];
+            }
+            for( int i = iEnd; i < iCount; ++i )
+            {
+                pPlane[i] = pPlane[iEnd - 1];
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // In the gather filter, taps further away than the largest focal value times the kernel
+    // radius have no weight, and are left out. When all the samples reach the remaining taps
+    // their weights are those of the full filter, otherwise each vector of pixels is narrowed
+    // down, and masked, by the kernel.
+    //--------------------------------------------------------------------------------------
+    void BilateralFilterSIMD::FilterTaps( const float* const* ppTaps, float fMinFocal, float fMaxFocal, int iPlaneStride, int iNumPixels, bool bOutputFocal, Float4* pOutput ) const
+    {
+        const int iKernelRadius = KernelRadius();
+        if( !m_bGather )
+        {
+            m_pKernels->m_pfnBilateralTaps( m_fWeights, KernelDiameter(), ppTaps, iPlaneStride, iNumPixels, bOutputFocal, pOutput );
+
+            return;
+        }
+
+        int iReach = (int)( fMaxFocal * (float)iKernelRadius );
+        iReach = ( iReach < iKernelRadius ) ? iReach : iKernelRadius;
+        const int iFirstTap = iKernelRadius - iReach;
+
+        if( fMinFocal * (float)iKernelRadius >= (float)iReach )
+        {
+            m_pKernels->m_pfnBilateralTaps( m_fWeights + iFirstTap, iReach * 2 + 1, ppTaps + iFirstTap, iPlaneStride, iNumPixels, bOutputFocal, pOutput );
+        }
+        else
+        {
+            m_pKernels->m_pfnBilateralGatherTaps( m_fWeights + iFirstTap, iReach * 2 + 1, ppTaps + iFirstTap, iPlaneStride, iNumPixels, (float)iKernelRadius, bOutputFocal, pOutput );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Range of the focal values under a line of kernels
+    //--------------------------------------------------------------------------------------
+    void BilateralFilterSIMD::FocalRange( const float* pFocal, int iCount, float& fMinFocal, float& fMaxFocal )
+    {
+        fMinFocal = pFocal[0];
+        fMaxFocal = pFocal[0];
+        for( int i = 1; i < iCount; ++i )
+        {
+            fMinFocal = ( pFocal[i] < fMinFocal ) ? pFocal[i] : fMinFocal;
+            fMaxFocal = ( pFocal[i] > fMaxFocal ) ? pFocal[i] : fMaxFocal;
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Same dispatch as CSFilterX
+    //--------------------------------------------------------------------------------------
+    void BilateralFilterX::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = DivRoundUp( (unsigned int)OutputWidth(), RUN_SIZE );
+        uY = DivRoundUp( (unsigned int)OutputHeight(), RUN_LINES );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Filters RUN_LINES lines of RUN_SIZE pixels. The planes cover the kernel on either side,
+    // plus a vector of padding, and tap N of a pixel is N floats after the start of its plane.
+    //--------------------------------------------------------------------------------------
+    void BilateralFilterX::ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const
+    {
+        const int iKernelRadius = KernelRadius();
+        const int iGroupCoordX = (int)uGroupX * RUN_SIZE;
+        const int iNumPixels = ( OutputWidth() - iGroupCoordX < RUN_SIZE ) ? ( OutputWidth() - iGroupCoordX ) : RUN_SIZE;
+        const int iPlaneStride = PlaneStride( iNumPixels + 2 * iKernelRadius + MAX_VECTOR_WIDTH );
+        float* pPlanes = (float*)LDS.Reserve( sizeof( float ) * iPlaneStride * NUM_PLANES );
+
+        const float* pTaps[MAX_KERNEL_RADIUS * 2 + 1];
+        for( int iTap = 0; iTap < KernelDiameter(); ++iTap )
+        {
+            pTaps[iTap] = pPlanes + iTap;
+        }
+
+        for( int iLine = 0; iLine < RUN_LINES; ++iLine )
+        {
+            const int iY = (int)uGroupY * RUN_LINES + iLine;
+            if( iY >= OutputHeight() )
+            {
+                break;
+            }
+
+            ConvertLine( iY, iGroupCoordX - iKernelRadius, iPlaneStride, true, pPlanes, iPlaneStride );
+
+            // The focal values under the kernels of the line
+            float fMinFocal = 1.0f, fMaxFocal = 1.0f;
+            if( m_bGather )
+            {
+                FocalRange( pPlanes + iPlaneStride * 4, iNumPixels + 2 * iKernelRadius, fMinFocal, fMaxFocal );
+            }
+
+            FilterTaps( pTaps, fMinFocal, fMaxFocal, iPlaneStride, iNumPixels, true, m_pOutput->Row( iY ) + iGroupCoordX );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    BilateralFilterY::BilateralFilterY() :
+    m_iRequestedStripWidth( 0 )
+    {
+        SetKernel( m_iKernelRadius, false );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // The strip width depends on the size of the ring buffer
+    //--------------------------------------------------------------------------------------
+    void BilateralFilterY::SetKernel( int iKernelRadius, bool bApproximate )
+    {
+        BilateralFilterSIMD::SetKernel( iKernelRadius, bApproximate );
+
+        SetStripWidth( m_iRequestedStripWidth );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Overrides the strip width, or 0 to size them from the caches of the CPU
+    //--------------------------------------------------------------------------------------
+    void BilateralFilterY::SetStripWidth( int iStripWidth )
+    {
+        assert( iStripWidth >= 0 );
+
+        // The ring buffer holds the planes of the kernel lines, plus the output line
+        m_iRequestedStripWidth = iStripWidth;
+        m_iStripWidth = ( 0 == iStripWidth ) ? ComputeStripWidth( KernelDiameter() * NUM_PLANES * sizeof( float ) + sizeof( Float4 ) ) : iStripWidth;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // One group per strip of RUN_SIZE lines, as CSFilterY runs down RUN_SIZE lines
+    //--------------------------------------------------------------------------------------
+    void BilateralFilterY::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = DivRoundUp( (unsigned int)OutputWidth(), (unsigned int)m_iStripWidth );
+        uY = DivRoundUp( (unsigned int)OutputHeight(), RUN_SIZE );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Filters RUN_SIZE lines of a strip. Lines are converted to planes as the window slides
+    // down, and an output line is filtered as soon as the lines under its kernel are there.
+    //--------------------------------------------------------------------------------------
+    void BilateralFilterY::ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const
+    {
+        const int iKernelRadius = KernelRadius();
+        const int iKernelDiameter = KernelDiameter();
+
+        const int iGroupCoordX = (int)uGroupX * m_iStripWidth;
+        const int iStripWidth = ( OutputWidth() - iGroupCoordX < m_iStripWidth ) ? ( OutputWidth() - iGroupCoordX ) : m_iStripWidth;
+        const int iFirstLine = (int)uGroupY * RUN_SIZE;
+        const int iEndLine = ( iFirstLine + RUN_SIZE < OutputHeight() ) ? ( iFirstLine + RUN_SIZE ) : OutputHeight();
+
+        const int iPlaneStride = PlaneStride( iStripWidth );
+        const int iRingPitch = iPlaneStride * NUM_PLANES;
+        float* pRing = (float*)LDS.Reserve( sizeof( float ) * iRingPitch * iKernelDiameter );
+
+        const float* pTaps[MAX_KERNEL_RADIUS * 2 + 1];
+        float fSlotMinFocal[MAX_KERNEL_RADIUS * 2 + 1];
+        float fSlotMaxFocal[MAX_KERNEL_RADIUS * 2 + 1];
+
+        for( int iLine = iFirstLine - iKernelRadius; iLine < iEndLine + iKernelRadius; ++iLine )
+        {
+            const int iSlot = ( iLine - iFirstLine + iKernelRadius ) % iKernelDiameter;
+            ConvertLine( iLine, iGroupCoordX, iPlaneStride, false, pRing + iSlot * iRingPitch, iPlaneStride );
+
+            // The focal values of each line, in the gather filter
+            fSlotMinFocal[iSlot] = 1.0f;
+            fSlotMaxFocal[iSlot] = 1.0f;
+            if( m_bGather )
+            {
+                FocalRange( pRing + iSlot * iRingPitch + iPlaneStride * 4, iStripWidth, fSlotMinFocal[iSlot], fSlotMaxFocal[iSlot] );
+            }
+
+            // The kernel of this output line ends on the line just converted
+            const int iY = iLine - iKernelRadius;
+            if( iY >= iFirstLine )
+            {
+                float fMinFocal = 1.0f, fMaxFocal = 0.0f;
+                for( int iTap = 0; iTap < iKernelDiameter; ++iTap )
+                {
+                    const int iTapSlot = ( iY - iFirstLine + iTap ) % iKernelDiameter;
+                    pTaps[iTap] = pRing + iTapSlot * iRingPitch;
+                    fMinFocal = ( fSlotMinFocal[iTapSlot] < fMinFocal ) ? fSlotMinFocal[iTapSlot] : fMinFocal;
+                    fMaxFocal = ( fSlotMaxFocal[iTapSlot] > fMaxFocal ) ? fSlotMaxFocal[iTapSlot] : fMaxFocal;
+                }
+
+                FilterTaps( pTaps, fMinFocal, fMaxFocal, iPlaneStride, iStripWidth, false, m_pOutput->Row( iY ) + iGroupCoordX );
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,135 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: BilateralFilterSIMD.h
+//
+// Vectorized bilateral filter passes, with the semantics of BilateralFilter.hlsl, for
+// offline depth of field post processing. The inputs are the color surface (input 0) and
+// the depth buffer (input 1, depth in x), and the view space depth is computed from the
+// same projection parameters as g_f4ProjParams. SetGather gives the variable radius
+// gather filter of BILATERAL_GATHER_FILTER, which skips the taps beyond the reach of the
+// samples of each line, and of each vector of pixels in lines where the reach varies, so
+// in focus regions cost little more than converting the inputs.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+#include "SIMD.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Common state of the vectorized bilateral passes
+    //--------------------------------------------------------------------------------------
+    class BilateralFilterSIMD : public FilterPass
+    {
+    public:
+
+        BilateralFilterSIMD();
+
+        // The approximate filter only exists to halve the texture fetches of the GPU, so the
+        // full filter is always computed
+        virtual void SetKernel( int iKernelRadius, bool bApproximate );
+
+        // Defaults to the best instruction set of the CPU
+        void SetISA( ISA_TYPE ISA );
+        ISA_TYPE GetISA() const { return m_pKernels->m_ISA; }
+
+        // Sets g_f4ProjParams ( [0] = fQTimesZNear, [1] = fQ )
+        void SetProjParams( const float fProjParams[4] );
+
+        // Equivalent of the BILATERAL_GATHER_FILTER compile time define
+        void SetGather( bool bGather ) { m_bGather = bGather; }
+        bool GetGather() const { return m_bGather; }
+
+    protected:
+
+        // Converts iCount texels of line iY, starting at iX and clamped to the edges of the
+        // inputs, into planes of red, green, blue, view space depth and focal, iPlaneStride
+        // floats apart. The focal value is computed from the depth in the horizontal pass,
+        // and read back from the color alpha in the vertical pass.
+        void ConvertLine( int iY, int iX, int iCount, bool bFocalFromDepth, float* pPlanes, int iPlaneStride ) const;
+
+        // Filters planar pixels as m_pfnBilateralTaps, or in the gather filter with only the
+        // taps reached by the samples under the kernels, whose focal values span fMinFocal
+        // to fMaxFocal
+        void FilterTaps( const float* const* ppTaps, float fMinFocal, float fMaxFocal, int iPlaneStride, int iNumPixels, bool bOutputFocal, Float4* pOutput ) const;
+
+        // The smallest and largest of iCount focal values
+        static void FocalRange( const float* pFocal, int iCount, float& fMinFocal, float& fMaxFocal );
+
+        const FilterKernels*    m_pKernels;
+        float                   m_fWeights[MAX_KERNEL_RADIUS * 2 + 1];  // Center at KERNEL_RADIUS
+        float                   m_fProjParams[4];
+        bool                    m_bGather;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Horizontal pass: outputs the filtered color, with the focal value in w
+    //--------------------------------------------------------------------------------------
+    class BilateralFilterX : public BilateralFilterSIMD
+    {
+    public:
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void GetGroupSize( unsigned int& uWidth, unsigned int& uHeight ) const { uWidth = RUN_SIZE; uHeight = RUN_LINES; }
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Vertical pass: walks down a strip of columns, converting each input line to planes
+    // once, into a ring buffer of KERNEL_DIAMETER lines sized to stay in the cache
+    //--------------------------------------------------------------------------------------
+    class BilateralFilterY : public BilateralFilterSIMD
+    {
+    public:
+
+        BilateralFilterY();
+
+        virtual void SetKernel( int iKernelRadius, bool bApproximate );
+
+        // Width of the strips in texels, or 0 to size them from the caches of the CPU
+        void SetStripWidth( int iStripWidth );
+        int StripWidth() const { return m_iStripWidth; }
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void GetGroupSize( unsigned int& uWidth, unsigned int& uHeight ) const { uWidth = (unsigned int)m_iStripWidth; uHeight = RUN_SIZE; }
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+
+    private:
+
+        int m_iRequestedStripWidth;
+        int m_iStripWidth;
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
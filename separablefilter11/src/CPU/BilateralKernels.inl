@@ -0,0 +1,210 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: BilateralKernels.inl
+//
+// Vectorized bilateral filter kernels, written against the VecF type of the including
+// translation unit (Kernels_*.cpp). Each lane of a vector carries a different pixel.
+//--------------------------------------------------------------------------------------
+
+
+//--------------------------------------------------------------------------------------
+// Converts iCount depth texels (depth in x) to view space depth, and to the focal value
+// if pFocal is not NULL. The operations match LinearizeDepth and SmoothStep exactly.
+//--------------------------------------------------------------------------------------
+static void LinearizeDepthRow( const Float4* pDepth, int iCount, const float* pProjParams, float* pLinearDepth, float* pFocal )
+{
+    const VecF QTimesZNear = VecF::Set1( pProjParams[0] );
+    const VecF Q = VecF::Set1( pProjParams[1] );
+    const VecF FocalEnd = VecF::Set1( FOCAL_END );
+    const VecF FocalRamp = VecF::Set1( ( FOCAL_END + FOCAL_END_RAMP ) - FOCAL_END );
+    const VecF Zero = VecF::Zero();
+    const VecF One = VecF::Set1( 1.0f );
+    const VecF Two = VecF::Set1( 2.0f );
+    const VecF Three = VecF::Set1( 3.0f );
+    int i = 0;
+
+    for( ; i + VecF::WIDTH <= iCount; i += VecF::WIDTH )
+    {
+        VecF D, Unused0, Unused1, Unused2;
+        LoadDeinterleaved( pDepth + i, D, Unused0, Unused1, Unused2 );
+
+        VecF Z = ( Zero - QTimesZNear ) / ( D - Q );
+        Z.StoreU( pLinearDepth + i );
+
+        if( NULL != pFocal )
+        {
+            VecF T = Min( Max( ( Z - FocalEnd ) / FocalRamp, Zero ), One );
+            ( T * T * ( Three - Two * T ) ).StoreU( pFocal + i );
+        }
+    }
+
+    for( ; i < iCount; ++i )
+    {
+        pLinearDepth[i] = LinearizeDepth( pDepth[i].x, pProjParams );
+
+        if( NULL != pFocal )
+        {
+            pFocal[i] = SmoothStep( FOCAL_END, FOCAL_END + FOCAL_END_RAMP, pLinearDepth[i] );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Filters iNumPixels planar pixels. ppTaps holds one pointer per tap, to the red plane of
+// the samples for the first pixel, followed at iPlaneStride intervals by the green, blue,
+// view space depth and focal planes. The center tap is at KERNEL_RADIUS, and pWeights are
+// the Gaussian weights of each tap. The taps are accumulated in the order of
+// FilterKernel.hlsl, and the output alpha is the focal value of the center, or 1.
+//--------------------------------------------------------------------------------------
+static void BilateralTaps( const float* pWeights, int iKernelDiameter, const float* const* ppTaps, int iPlaneStride, int iNumPixels, bool bOutputFocal, Float4* pOutput )
+{
+    const int iKernelRadius = iKernelDiameter / 2;
+    const VecF One = VecF::Set1( 1.0f );
+
+    for( int iPixel = 0; iPixel < iNumPixels; iPixel += VecF::WIDTH )
+    {
+        const float* pCenter = ppTaps[iKernelRadius] + iPixel;
+        const VecF CenterDepth = VecF::LoadU( pCenter + iPlaneStride * 3 );
+        const VecF CenterFocal = VecF::LoadU( pCenter + iPlaneStride * 4 );
+
+        VecF WeightSum = VecF::Set1( pWeights[iKernelRadius] );
+        VecF R = WeightSum * VecF::LoadU( pCenter );
+        VecF G = WeightSum * VecF::LoadU( pCenter + iPlaneStride );
+        VecF B = WeightSum * VecF::LoadU( pCenter + iPlaneStride * 2 );
+
+        for( int iTap = 0; iTap < iKernelDiameter; ++iTap )
+        {
+            if( iTap == iKernelRadius )
+            {
+                continue;
+            }
+
+            // Samples in front of the center use their own focal value
+            const float* pTap = ppTaps[iTap] + iPixel;
+            VecF Depth = VecF::LoadU( pTap + iPlaneStride * 3 );
+            VecF Focal = VecF::LoadU( pTap + iPlaneStride * 4 );
+            VecF Weight = VecF::Set1( pWeights[iTap] ) * SelectLess( Depth, CenterDepth, Focal, CenterFocal );
+
+            WeightSum = WeightSum + Weight;
+            R = MulAdd( VecF::LoadU( pTap ), Weight, R );
+            G = MulAdd( VecF::LoadU( pTap + iPlaneStride ), Weight, G );
+            B = MulAdd( VecF::LoadU( pTap + iPlaneStride * 2 ), Weight, B );
+        }
+
+        StoreOutput( pOutput + iPixel, iNumPixels - iPixel, R / WeightSum, G / WeightSum, B / WeightSum, bOutputFocal ? CenterFocal : One );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// BilateralTaps for the gather filter, where taps beyond the circle of confusion of the
+// sample that weights them, its focal value times fKernelRadius, have no weight. The taps
+// may be a window of the kernel around its center, as long as no sample in the planes
+// reaches beyond it. Each vector of pixels only iterates over the taps within the reach
+// of the samples under it, which gives the same result, as the taps skipped add zeros,
+// and only masks the taps when some of those samples fall short of the reach.
+//--------------------------------------------------------------------------------------
+static void BilateralGatherTaps( const float* pWeights, int iKernelDiameter, const float* const* ppTaps, int iPlaneStride, int iNumPixels, float fKernelRadius, bool bOutputFocal, Float4* pOutput )
+{
+    const int iKernelRadius = iKernelDiameter / 2;
+    const VecF One = VecF::Set1( 1.0f );
+    const VecF Zero = VecF::Zero();
+    const VecF KernelRadius = VecF::Set1( fKernelRadius );
+    float fMaxLanes[VecF::WIDTH];
+    float fMinLanes[VecF::WIDTH];
+
+    for( int iPixel = 0; iPixel < iNumPixels; iPixel += VecF::WIDTH )
+    {
+        const float* pCenter = ppTaps[iKernelRadius] + iPixel;
+        const VecF CenterDepth = VecF::LoadU( pCenter + iPlaneStride * 3 );
+        const VecF CenterFocal = VecF::LoadU( pCenter + iPlaneStride * 4 );
+
+        // The furthest and the shortest any of the samples reach
+        VecF MaxFocal = CenterFocal;
+        VecF MinFocal = CenterFocal;
+        for( int iTap = 0; iTap < iKernelDiameter; ++iTap )
+        {
+            const VecF Focal = VecF::LoadU( ppTaps[iTap] + iPixel + iPlaneStride * 4 );
+            MaxFocal = Max( MaxFocal, Focal );
+            MinFocal = Min( MinFocal, Focal );
+        }
+
+        MaxFocal.StoreU( fMaxLanes );
+        MinFocal.StoreU( fMinLanes );
+        float fMaxFocal = fMaxLanes[0];
+        float fMinFocal = fMinLanes[0];
+        for( int iLane = 1; iLane < VecF::WIDTH; ++iLane )
+        {
+            fMaxFocal = ( fMaxLanes[iLane] > fMaxFocal ) ? fMaxLanes[iLane] : fMaxFocal;
+            fMinFocal = ( fMinLanes[iLane] < fMinFocal ) ? fMinLanes[iLane] : fMinFocal;
+        }
+
+        int iReach = (int)( fMaxFocal * fKernelRadius );
+        iReach = ( iReach < iKernelRadius ) ? iReach : iKernelRadius;
+        const int iFirstTap = iKernelRadius - iReach;
+        const int iEndTap = iKernelDiameter - iFirstTap;
+
+        VecF WeightSum = VecF::Set1( pWeights[iKernelRadius] );
+        VecF R = WeightSum * VecF::LoadU( pCenter );
+        VecF G = WeightSum * VecF::LoadU( pCenter + iPlaneStride );
+        VecF B = WeightSum * VecF::LoadU( pCenter + iPlaneStride * 2 );
+
+        // Without a mask when every sample reaches all the taps
+        const bool bMasked = fMinFocal * fKernelRadius < (float)iReach;
+
+        for( int iTap = iFirstTap; iTap < iEndTap; ++iTap )
+        {
+            if( iTap == iKernelRadius )
+            {
+                continue;
+            }
+
+            // Samples in front of the center use their own focal value, and circle of confusion
+            const float* pTap = ppTaps[iTap] + iPixel;
+            VecF Depth = VecF::LoadU( pTap + iPlaneStride * 3 );
+            VecF Focal = SelectLess( Depth, CenterDepth, VecF::LoadU( pTap + iPlaneStride * 4 ), CenterFocal );
+            if( bMasked )
+            {
+                const VecF Distance = VecF::Set1( (float)( ( iTap < iKernelRadius ) ? ( iKernelRadius - iTap ) : ( iTap - iKernelRadius ) ) );
+                Focal = SelectLess( Focal * KernelRadius, Distance, Zero, Focal );
+            }
+
+            VecF Weight = VecF::Set1( pWeights[iTap] ) * Focal;
+
+            WeightSum = WeightSum + Weight;
+            R = MulAdd( VecF::LoadU( pTap ), Weight, R );
+            G = MulAdd( VecF::LoadU( pTap + iPlaneStride ), Weight, G );
+            B = MulAdd( VecF::LoadU( pTap + iPlaneStride * 2 ), Weight, B );
+        }
+
+        StoreOutput( pOutput + iPixel, iNumPixels - iPixel, R / WeightSum, G / WeightSum, B / WeightSum, bOutputFocal ? CenterFocal : One );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,490 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: BoxFilter.cpp
+//
+// Implements the box filter cascade passes.
+//--------------------------------------------------------------------------------------
+
+
+#include "BoxFilter.h"
+#include "SIMD.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // A box of odd width w has a variance of ( w * w - 1 ) / 12, and the variances of the
+    // cascade add up. The widths are the odd widths either side of the ideal one, with as
+    // many of the lower as brings the sum closest to the variance of the Gaussian.
+    //--------------------------------------------------------------------------------------
+    void ComputeBoxRadii( float fDeviation, int iNumPasses, int* pRadii )
+    {
+        assert( fDeviation >= 0.0f );
+        assert( iNumPasses >= MIN_BOX_PASSES && iNumPasses <= MAX_BOX_PASSES );
+
+        const double dVariance = (double)fDeviation * fDeviation;
+        const double dIdealWidth = sqrt( 12.0 * dVariance / iNumPasses + 1.0 );
+
+        int iLower = (int)dIdealWidth;
+        iLower -= ( 0 == iLower % 2 ) ? 1 : 0;
+        iLower = ( iLower > 1 ) ? iLower : 1;
+        const int iUpper = iLower + 2;
+
+        const double dNumLower = ( 12.0 * dVariance - iNumPasses * ( iLower * iLower + 4.0 * iLower + 3.0 ) ) / ( -4.0 * iLower - 4.0 );
+        const int iNumLower = Clamp( (int)floor( dNumLower + 0.5 ), 0, iNumPasses );
+
+        for( int iPass = 0; iPass < iNumPasses; ++iPass )
+        {
+            pRadii[iPass] = ( ( iPass < iNumLower ) ? iLower : iUpper ) / 2;
+        }
+    }
+
+
+    // Lines per group of the horizontal pass, the width of the rows it sums in vectors
+    static const int BOX_LINES = 16;
+
+
+    //--------------------------------------------------------------------------------------
+    // The sums of a window, per channel. Floats are summed in doubles, so that the running
+    // sums do not drift along the lines, and 8 bit channels in integers, so that they are
+    // exact, and each box outputs the mean of its window rounded to nearest.
+    //--------------------------------------------------------------------------------------
+    template< typename T > struct BoxChannel;
+
+    template<> struct BoxChannel< float >
+    {
+        typedef double Sum;
+
+        static float One() { return 1.0f; }
+
+        struct Divisor
+        {
+            Divisor() : m_dScale( 1.0 ) {}
+            explicit Divisor( int iWidth ) : m_dScale( 1.0 / iWidth ) {}
+            float operator()( double dSum ) const { return (float)( dSum * m_dScale ); }
+
+            double m_dScale;
+        };
+    };
+
+    template<> struct BoxChannel< unsigned char >
+    {
+        typedef unsigned int Sum;
+
+        static unsigned char One() { return 255; }
+
+        // Odd widths never leave a tie to round, so the rounded mean is the integer part of
+        // ( sum + width / 2 ) / width, which is at least half a step from the next integer.
+        // Floats divide within that for widths below 8192, and do so in vectors.
+        struct Divisor
+        {
+            Divisor() : m_fHalf( 0.5f ), m_fReciprocal( 1.0f ) {}
+            explicit Divisor( int iWidth ) : m_fHalf( (float)iWidth * 0.5f ), m_fReciprocal( 1.0f / (float)iWidth )
+            {
+                assert( iWidth < 8192 );
+            }
+            unsigned char operator()( unsigned int uSum ) const { return (unsigned char)(int)( ( (float)(int)uSum + m_fHalf ) * m_fReciprocal ); }
+
+            float   m_fHalf;
+            float   m_fReciprocal;
+        };
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Rows of 4 channels per texel, of either kind of surface
+    //--------------------------------------------------------------------------------------
+    template< typename T >
+    struct BoxRows
+    {
+        T* Row( int iY ) const { return m_pData + (size_t)iY * m_uPitch; }
+
+        T*      m_pData;
+        size_t  m_uPitch;      // In channels
+    };
+
+    static BoxRows< const float > GetRows( const Surface& S ) { BoxRows< const float > Rows = { &S.m_pData->x, (size_t)S.m_uPitch * 4 }; return Rows; }
+    static BoxRows< float > GetRows( Surface& S ) { BoxRows< float > Rows = { &S.m_pData->x, (size_t)S.m_uPitch * 4 }; return Rows; }
+    static BoxRows< const unsigned char > GetRows( const SurfaceUNorm8& S ) { BoxRows< const unsigned char > Rows = { S.m_pData, (size_t)S.m_uPitch * 4 }; return Rows; }
+    static BoxRows< unsigned char > GetRows( SurfaceUNorm8& S ) { BoxRows< unsigned char > Rows = { S.m_pData, (size_t)S.m_uPitch * 4 }; return Rows; }
+
+
+    //--------------------------------------------------------------------------------------
+    // Outputs the means of iCount windows, and slides the windows on by a row
+    //--------------------------------------------------------------------------------------
+    template< typename T, typename Sum, typename Divisor >
+    static inline void BoxStep( Sum* pSums, const T* pAdd, const T* pRemove, const Divisor& Divide, T* pDst, int iCount )
+    {
+        for( int i = 0; i < iCount; ++i )
+        {
+            pDst[i] = Divide( pSums[i] );
+            pSums[i] += (Sum)pAdd[i] - (Sum)pRemove[i];
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Every box down a strip of columns, with the boxes chained a row at a time. Each box
+    // pulls the rows it needs from the one before, which keeps at least 2 * radius + 2 rows
+    // of its output in a ring buffer: the rows entering and leaving the next box's window.
+    //--------------------------------------------------------------------------------------
+    template< typename T >
+    class BoxColumnCascade
+    {
+    public:
+
+        typedef typename BoxChannel< T >::Sum Sum;
+        typedef typename BoxChannel< T >::Divisor Divisor;
+
+        // Rows in the ring buffer feeding a box of the radius, rounded up to a power of 2 so
+        // that the rows wrap with a mask
+        static int RingSize( int iRadius )
+        {
+            int iSize = 1;
+            while( iSize < 2 * iRadius + 2 )
+            {
+                iSize *= 2;
+            }
+
+            return iSize;
+        }
+
+        // Bytes of scratch memory needed per channel of the strip
+        static size_t GetScratchSize( const int* pRadii, int iNumPasses )
+        {
+            size_t uSize = sizeof( Sum ) * iNumPasses;
+
+            for( int iPass = 0; iPass < iNumPasses - 1; ++iPass )
+            {
+                uSize += sizeof( T ) * RingSize( pRadii[iPass + 1] );
+            }
+
+            return uSize;
+        }
+
+        BoxColumnCascade( const BoxRows< const T >& Input, const BoxRows< T >& Output, int iFirstChannel, int iNumChannels, int iHeight, const int* pRadii, int iNumPasses, void* pScratch ) :
+        m_Input( Input ),
+        m_Output( Output ),
+        m_iFirstChannel( iFirstChannel ),
+        m_iNumChannels( iNumChannels ),
+        m_iHeight( iHeight ),
+        m_iNumPasses( iNumPasses )
+        {
+            Sum* pSums = (Sum*)pScratch;
+            T* pRing = (T*)( pSums + iNumPasses * iNumChannels );
+
+            for( int iPass = 0; iPass < iNumPasses; ++iPass )
+            {
+                m_iRadii[iPass] = pRadii[iPass];
+                m_iProduced[iPass] = 0;
+                m_pSums[iPass] = pSums + iPass * iNumChannels;
+
+                m_Divisors[iPass] = Divisor( 2 * pRadii[iPass] + 1 );
+
+                // The output of the last box goes straight to the output surface
+                m_iRingMask[iPass] = ( iPass < iNumPasses - 1 ) ? ( RingSize( pRadii[iPass + 1] ) - 1 ) : -1;
+                m_pRings[iPass] = pRing;
+                pRing += ( m_iRingMask[iPass] + 1 ) * iNumChannels;
+            }
+        }
+
+        void Run()
+        {
+            for( int iY = 0; iY < m_iHeight; ++iY )
+            {
+                Produce( m_iNumPasses - 1 );
+            }
+        }
+
+    private:
+
+        // Row iY of the input of box iPass
+        const T* InputRow( int iPass, int iY )
+        {
+            if( 0 == iPass )
+            {
+                return m_Input.Row( iY ) + m_iFirstChannel;
+            }
+
+            while( m_iProduced[iPass - 1] <= iY )
+            {
+                Produce( iPass - 1 );
+            }
+
+            return m_pRings[iPass - 1] + ( iY & m_iRingMask[iPass - 1] ) * m_iNumChannels;
+        }
+
+        // Outputs the next row of box iPass, and slides its window down
+        void Produce( int iPass )
+        {
+            const int iY = m_iProduced[iPass];
+            const int iRadius = m_iRadii[iPass];
+            const int iLastLine = m_iHeight - 1;
+            const int iNumChannels = m_iNumChannels;
+            Sum* pSums = m_pSums[iPass];
+
+            if( 0 == iY )
+            {
+                const T* pFirst = InputRow( iPass, 0 );
+                for( int i = 0; i < iNumChannels; ++i )
+                {
+                    pSums[i] = (Sum)pFirst[i] * (Sum)( iRadius + 1 );
+                }
+                for( int iTap = 1; iTap <= iRadius; ++iTap )
+                {
+                    const T* pRow = InputRow( iPass, ( iTap < iLastLine ) ? iTap : iLastLine );
+                    for( int i = 0; i < iNumChannels; ++i )
+                    {
+                        pSums[i] += (Sum)pRow[i];
+                    }
+                }
+            }
+
+            // The row entering the window is pulled first, so the one leaving is still in the ring
+            const T* pAdd = InputRow( iPass, ( iY + iRadius + 1 < iLastLine ) ? ( iY + iRadius + 1 ) : iLastLine );
+            const T* pRemove = InputRow( iPass, ( iY - iRadius > 0 ) ? ( iY - iRadius ) : 0 );
+            T* pOut = ( iPass == m_iNumPasses - 1 ) ? ( m_Output.Row( iY ) + m_iFirstChannel ) : ( m_pRings[iPass] + ( iY & m_iRingMask[iPass] ) * m_iNumChannels );
+
+            BoxStep( pSums, pAdd, pRemove, m_Divisors[iPass], pOut, iNumChannels );
+
+            ++m_iProduced[iPass];
+        }
+
+        BoxRows< const T >  m_Input;
+        BoxRows< T >        m_Output;
+        int                 m_iFirstChannel;
+        int                 m_iNumChannels;
+        int                 m_iHeight;
+        int                 m_iNumPasses;
+        int                 m_iRadii[MAX_BOX_PASSES];
+        int                 m_iProduced[MAX_BOX_PASSES];   // Rows output by each box so far
+        int                 m_iRingMask[MAX_BOX_PASSES];   // Rows - 1
+        Divisor             m_Divisors[MAX_BOX_PASSES];
+        Sum*                m_pSums[MAX_BOX_PASSES];
+        T*                  m_pRings[MAX_BOX_PASSES];
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Every box along a group of lines. The lines are transposed into scratch memory, so
+    // that each texel position is a row of the cascade and the lines are its columns, and
+    // the window sums of all the lines slide along together in vectors. Alpha is output
+    // as 1.
+    //--------------------------------------------------------------------------------------
+    template< typename T >
+    static void BoxLines( const BoxRows< const T >& Input, const BoxRows< T >& Output, int iFirstLine, int iNumLines, int iWidth, const int* pRadii, int iNumPasses, Scratch& LDS )
+    {
+        const int iNumChannels = iNumLines * 4;
+        const size_t uLinesSize = sizeof( T ) * iNumChannels * iWidth;
+        T* pColumns = (T*)LDS.Reserve( uLinesSize * 2 + BoxColumnCascade< T >::GetScratchSize( pRadii, iNumPasses ) * iNumChannels );
+        T* pFiltered = pColumns + iNumChannels * iWidth;
+
+        for( int iLine = 0; iLine < iNumLines; ++iLine )
+        {
+            const T* pSrc = Input.Row( iFirstLine + iLine );
+            for( int iX = 0; iX < iWidth; ++iX )
+            {
+                memcpy( pColumns + iX * iNumChannels + iLine * 4, pSrc + iX * 4, sizeof( T ) * 4 );
+            }
+        }
+
+        const BoxRows< const T > Columns = { pColumns, (size_t)iNumChannels };
+        const BoxRows< T > Filtered = { pFiltered, (size_t)iNumChannels };
+        BoxColumnCascade< T > Cascade( Columns, Filtered, 0, iNumChannels, iWidth, pRadii, iNumPasses, pFiltered + iNumChannels * iWidth );
+        Cascade.Run();
+
+        for( int iLine = 0; iLine < iNumLines; ++iLine )
+        {
+            T* pDst = Output.Row( iFirstLine + iLine );
+            for( int iX = 0; iX < iWidth; ++iX )
+            {
+                memcpy( pDst + iX * 4, pFiltered + iX * iNumChannels + iLine * 4, sizeof( T ) * 3 );
+                pDst[iX * 4 + 3] = BoxChannel< T >::One();
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    BoxFilter::BoxFilter() :
+    m_fDeviation( 0.0f ),
+    m_iNumPasses( MIN_BOX_PASSES ),
+    m_pUNorm8Input( NULL ),
+    m_pUNorm8Output( NULL )
+    {
+        SetKernel( m_iKernelRadius, false );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // The radius only matters as the default deviation
+    //--------------------------------------------------------------------------------------
+    void BoxFilter::SetKernel( int iKernelRadius, bool /*bApproximate*/ )
+    {
+        FilterPass::SetKernel( iKernelRadius, false );
+
+        UpdateRadii();
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Overrides the deviation
+    //--------------------------------------------------------------------------------------
+    void BoxFilter::SetDeviation( float fDeviation )
+    {
+        assert( fDeviation >= 0.0f );
+
+        m_fDeviation = fDeviation;
+        UpdateRadii();
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // More boxes are closer to a Gaussian, at the cost of another running sum
+    //--------------------------------------------------------------------------------------
+    void BoxFilter::SetNumPasses( int iNumPasses )
+    {
+        assert( iNumPasses >= MIN_BOX_PASSES && iNumPasses <= MAX_BOX_PASSES );
+
+        m_iNumPasses = iNumPasses;
+        UpdateRadii();
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Switches between the bound surfaces and 8 bit surfaces
+    //--------------------------------------------------------------------------------------
+    void BoxFilter::SetUNorm8Surfaces( const SurfaceUNorm8* pInput, SurfaceUNorm8* pOutput )
+    {
+        assert( ( NULL == pInput ) == ( NULL == pOutput ) );
+
+        m_pUNorm8Input = pInput;
+        m_pUNorm8Output = pOutput;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Recomputes the radii of the boxes
+    //--------------------------------------------------------------------------------------
+    void BoxFilter::UpdateRadii()
+    {
+        ComputeBoxRadii( GetDeviation(), m_iNumPasses, m_iRadii );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Each group filters BOX_LINES whole lines
+    //--------------------------------------------------------------------------------------
+    void BoxFilterX::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = 1;
+        uY = DivRoundUp( (unsigned int)OutputHeight(), (unsigned int)BOX_LINES );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Filters a group of lines
+    //--------------------------------------------------------------------------------------
+    void BoxFilterX::ComputeGroup( unsigned int /*uGroupX*/, unsigned int uGroupY, Scratch& LDS ) const
+    {
+        const int iFirstLine = (int)uGroupY * BOX_LINES;
+        const int iNumLines = ( OutputHeight() - iFirstLine < BOX_LINES ) ? ( OutputHeight() - iFirstLine ) : BOX_LINES;
+
+        if( NULL != m_pUNorm8Input )
+        {
+            assert( m_pUNorm8Input->m_uWidth >= (unsigned int)OutputWidth() && NULL != m_pUNorm8Output );
+
+            BoxLines( GetRows( *m_pUNorm8Input ), GetRows( *m_pUNorm8Output ), iFirstLine, iNumLines, OutputWidth(), m_iRadii, m_iNumPasses, LDS );
+        }
+        else
+        {
+            assert( m_pInputs[0]->m_uWidth >= (unsigned int)OutputWidth() );
+
+            BoxLines( GetRows( *m_pInputs[0] ), GetRows( *m_pOutput ), iFirstLine, iNumLines, OutputWidth(), m_iRadii, m_iNumPasses, LDS );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // The rings of every box but the last, and the sums of every box, sized to stay in the
+    // caches of the CPU
+    //--------------------------------------------------------------------------------------
+    int BoxFilterY::StripWidth( size_t uChannelSize ) const
+    {
+        const size_t uBytesPerChannel = ( sizeof( unsigned char ) == uChannelSize ) ? BoxColumnCascade< unsigned char >::GetScratchSize( m_iRadii, m_iNumPasses ) :
+                                                                                      BoxColumnCascade< float >::GetScratchSize( m_iRadii, m_iNumPasses );
+
+        return ComputeStripWidth( (unsigned int)( uBytesPerChannel * 4 ) );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // One group per strip, down the whole height
+    //--------------------------------------------------------------------------------------
+    void BoxFilterY::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        const int iStripWidth = StripWidth( ( NULL != m_pUNorm8Input ) ? sizeof( unsigned char ) : sizeof( float ) );
+
+        uX = DivRoundUp( (unsigned int)OutputWidth(), (unsigned int)iStripWidth );
+        uY = 1;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Filters a strip of columns. Alpha is filtered with the rest, which keeps the alpha of
+    // 1 output by the horizontal pass exactly.
+    //--------------------------------------------------------------------------------------
+    void BoxFilterY::ComputeGroup( unsigned int uGroupX, unsigned int /*uGroupY*/, Scratch& LDS ) const
+    {
+        const bool bUNorm8 = ( NULL != m_pUNorm8Input );
+        const int iStripWidth = StripWidth( bUNorm8 ? sizeof( unsigned char ) : sizeof( float ) );
+        const int iGroupCoordX = (int)uGroupX * iStripWidth;
+        const int iNumTexels = ( OutputWidth() - iGroupCoordX < iStripWidth ) ? ( OutputWidth() - iGroupCoordX ) : iStripWidth;
+
+        if( bUNorm8 )
+        {
+            assert( m_pUNorm8Input->m_uHeight >= (unsigned int)OutputHeight() && NULL != m_pUNorm8Output );
+
+            void* pScratch = LDS.Reserve( BoxColumnCascade< unsigned char >::GetScratchSize( m_iRadii, m_iNumPasses ) * iNumTexels * 4 );
+            BoxColumnCascade< unsigned char > Cascade( GetRows( *m_pUNorm8Input ), GetRows( *m_pUNorm8Output ), iGroupCoordX * 4, iNumTexels * 4, OutputHeight(), m_iRadii, m_iNumPasses, pScratch );
+            Cascade.Run();
+        }
+        else
+        {
+            assert( m_pInputs[0]->m_uHeight >= (unsigned int)OutputHeight() );
+
+            void* pScratch = LDS.Reserve( BoxColumnCascade< float >::GetScratchSize( m_iRadii, m_iNumPasses ) * iNumTexels * 4 );
+            BoxColumnCascade< float > Cascade( GetRows( *m_pInputs[0] ), GetRows( *m_pOutput ), iGroupCoordX * 4, iNumTexels * 4, OutputHeight(), m_iRadii, m_iNumPasses, pScratch );
+            Cascade.Run();
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,124 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: BoxFilter.h
+//
+// Box filter cascade passes, for preview quality blurs. Three or four box filters in a
+// row approximate a Gaussian, and each is a running sum, so the cost per pixel does not
+// depend on the deviation. 8 bit surfaces are summed in integers, so each box outputs
+// exactly the rounded mean of its window.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+
+
+namespace CPUFilter
+{
+    static const int MIN_BOX_PASSES = 3;
+    static const int MAX_BOX_PASSES = 4;
+
+    // Computes the radii of iNumPasses boxes whose cascade has the variance of a Gaussian
+    // of the deviation, as closely as odd widths allow
+    void ComputeBoxRadii( float fDeviation, int iNumPasses, int* pRadii );
+
+
+    //--------------------------------------------------------------------------------------
+    // Common state of the box filter passes. Like the other filters, the deviation defaults
+    // to half the kernel radius, but can be set beyond MAX_KERNEL_RADIUS.
+    //--------------------------------------------------------------------------------------
+    class BoxFilter : public FilterPass
+    {
+    public:
+
+        BoxFilter();
+
+        // Only sets the default deviation, the approximate filter has no meaning here
+        virtual void SetKernel( int iKernelRadius, bool bApproximate );
+
+        // Overrides the deviation, or 0 for half the kernel radius
+        void SetDeviation( float fDeviation );
+        float GetDeviation() const { return ( m_fDeviation > 0.0f ) ? m_fDeviation : (float)m_iKernelRadius * 0.5f; }
+
+        // Number of boxes in the cascade, MIN_BOX_PASSES to MAX_BOX_PASSES (defaults to 3)
+        void SetNumPasses( int iNumPasses );
+        int GetNumPasses() const { return m_iNumPasses; }
+        int GetBoxRadius( int iPass ) const { return m_iRadii[iPass]; }
+
+        // Filters 8 bit surfaces instead of the bound input and output, which may then be
+        // NULL. NULL to filter the bound surfaces again.
+        void SetUNorm8Surfaces( const SurfaceUNorm8* pInput, SurfaceUNorm8* pOutput );
+
+    protected:
+
+        float                   m_fDeviation;
+        int                     m_iNumPasses;
+        int                     m_iRadii[MAX_BOX_PASSES];
+        const SurfaceUNorm8*    m_pUNorm8Input;
+        SurfaceUNorm8*          m_pUNorm8Output;
+
+    private:
+
+        void UpdateRadii();
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Horizontal pass: groups of lines are transposed into scratch memory, and filtered by
+    // the same cascade as the vertical pass
+    //--------------------------------------------------------------------------------------
+    class BoxFilterX : public BoxFilter
+    {
+    public:
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Vertical pass: each group walks down a strip of columns, with the boxes chained one
+    // row at a time, so only a window of each box's input rows is kept, in a ring buffer
+    // sized to stay in the cache
+    //--------------------------------------------------------------------------------------
+    class BoxFilterY : public BoxFilter
+    {
+    public:
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+
+    private:
+
+        // Width of the strips in texels, for the radii and the size of a channel
+        int StripWidth( size_t uChannelSize ) const;
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
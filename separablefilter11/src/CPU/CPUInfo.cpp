@@ -0,0 +1,237 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: CPUInfo.cpp
+//
+// Queries the capabilities of the CPU with CPUID.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUInfo.h"
+#include "SIMD.h"
+
+#include <thread>
+
+#if CPUFILTER_X86
+    #if defined( _MSC_VER )
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+
+namespace CPUFilter
+{
+#if CPUFILTER_X86
+
+    //--------------------------------------------------------------------------------------
+    // Executes CPUID for the given leaf and sub-leaf
+    //--------------------------------------------------------------------------------------
+    static void CPUID( unsigned int uLeaf, unsigned int uSubLeaf, unsigned int uRegs[4] )
+    {
+    #if defined( _MSC_VER )
+        __cpuidex( (int*)uRegs, (int)uLeaf, (int)uSubLeaf );
+    #else
+        __cpuid_count( uLeaf, uSubLeaf, uRegs[0], uRegs[1], uRegs[2], uRegs[3] );
+    #endif
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Reads XCR0, to find which register states the OS saves on a context switch
+    //--------------------------------------------------------------------------------------
+    static unsigned long long XGETBV0()
+    {
+    #if defined( _MSC_VER )
+        return _xgetbv( 0 );
+    #else
+        unsigned int uEAX, uEDX;
+        __asm__ __volatile__( "xgetbv" : "=a"( uEAX ), "=d"( uEDX ) : "c"( 0 ) );
+        return ( (unsigned long long)uEDX << 32 ) | uEAX;
+    #endif
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Fills out the CPU info using CPUID
+    //--------------------------------------------------------------------------------------
+    static void QueryCPUInfo( CPUInfo& Info )
+    {
+        unsigned int uRegs[4];
+
+        CPUID( 0, 0, uRegs );
+        unsigned int uMaxLeaf = uRegs[0];
+
+        CPUID( 1, 0, uRegs );
+        bool bSSE41 = ( uRegs[2] & ( 1u << 19 ) ) != 0;
+        bool bFMA = ( uRegs[2] & ( 1u << 12 ) ) != 0;
+        bool bOSXSAVE = ( uRegs[2] & ( 1u << 27 ) ) != 0;
+        bool bAVX = ( uRegs[2] & ( 1u << 28 ) ) != 0;
+        bool bF16C = ( uRegs[2] & ( 1u << 29 ) ) != 0;
+
+        // The OS must save the YMM (and ZMM) state for AVX (and AVX-512) to be usable
+        unsigned long long uXCR0 = bOSXSAVE ? XGETBV0() : 0;
+        bool bOSSavesYMM = ( uXCR0 & 0x06 ) == 0x06;
+        bool bOSSavesZMM = ( uXCR0 & 0xE6 ) == 0xE6;
+
+        bool bAVX2 = false;
+        bool bAVX512 = false;
+        if( uMaxLeaf >= 7 )
+        {
+            CPUID( 7, 0, uRegs );
+            bAVX2 = ( uRegs[1] & ( 1u << 5 ) ) != 0;
+            bAVX512 = ( uRegs[1] & ( 1u << 16 ) ) != 0 &&   // F
+                      ( uRegs[1] & ( 1u << 17 ) ) != 0 &&   // DQ
+                      ( uRegs[1] & ( 1u << 30 ) ) != 0 &&   // BW
+                      ( uRegs[1] & ( 1u << 31 ) ) != 0;     // VL
+        }
+
+        // Deterministic cache parameters (Intel), or the AMD extended leaves
+        bool bFoundCaches = false;
+        if( uMaxLeaf >= 4 )
+        {
+            for( unsigned int uSubLeaf = 0; uSubLeaf < 16; ++uSubLeaf )
+            {
+                CPUID( 4, uSubLeaf, uRegs );
+                unsigned int uType = uRegs[0] & 0x1F;
+                unsigned int uLevel = ( uRegs[0] >> 5 ) & 0x7;
+                if( 0 == uType )
+                {
+                    break;
+                }
+
+                unsigned int uLineSize = ( uRegs[1] & 0xFFF ) + 1;
+                unsigned int uSize = ( ( uRegs[1] >> 22 ) + 1 ) * ( ( ( uRegs[1] >> 12 ) & 0x3FF ) + 1 ) * uLineSize * ( uRegs[2] + 1 );
+                if( 1 == uLevel && 1 == uType )
+                {
+                    Info.m_uL1DataCacheSize = uSize;
+                    Info.m_uCacheLineSize = uLineSize;
+                    bFoundCaches = true;
+                }
+                else if( 2 == uLevel && 3 == uType )
+                {
+                    Info.m_uL2CacheSize = uSize;
+                }
+            }
+        }
+
+        CPUID( 0x80000000, 0, uRegs );
+        if( !bFoundCaches && uRegs[0] >= 0x80000006 )
+        {
+            CPUID( 0x80000005, 0, uRegs );
+            if( 0 != ( uRegs[2] >> 24 ) && 0 != ( uRegs[2] & 0xFF ) )
+            {
+                Info.m_uL1DataCacheSize = ( uRegs[2] >> 24 ) * 1024;
+                Info.m_uCacheLineSize = uRegs[2] & 0xFF;
+            }
+
+            CPUID( 0x80000006, 0, uRegs );
+            if( 0 != ( uRegs[2] >> 16 ) )
+            {
+                Info.m_uL2CacheSize = ( uRegs[2] >> 16 ) * 1024;
+            }
+        }
+
+        Info.m_bSupportsISA[ISA_TYPE_SSE41] = bSSE41;
+        Info.m_bSupportsISA[ISA_TYPE_AVX2] = bSSE41 && bAVX && bAVX2 && bFMA && bF16C && bOSSavesYMM;
+        Info.m_bSupportsISA[ISA_TYPE_AVX512] = Info.m_bSupportsISA[ISA_TYPE_AVX2] && bAVX512 && bOSSavesZMM;
+    }
+
+#endif
+
+
+    //--------------------------------------------------------------------------------------
+    // Builds the CPU info, and picks the best supported ISA
+    //--------------------------------------------------------------------------------------
+    static CPUInfo CreateCPUInfo()
+    {
+        CPUInfo Info;
+
+        for( int iISA = 0; iISA < ISA_TYPE_MAX; ++iISA )
+        {
+            Info.m_bSupportsISA[iISA] = ( ISA_TYPE_SCALAR == iISA );
+        }
+
+        unsigned int uNumLogicalCores = std::thread::hardware_concurrency();
+        Info.m_uNumLogicalCores = ( uNumLogicalCores > 0 ) ? uNumLogicalCores : 1;
+
+        // Typical of current desktop CPUs, when they cannot be queried
+        Info.m_uL1DataCacheSize = 32 * 1024;
+        Info.m_uL2CacheSize = 256 * 1024;
+        Info.m_uCacheLineSize = 64;
+
+    #if CPUFILTER_X86
+        QueryCPUInfo( Info );
+    #endif
+
+    #if !CPUFILTER_AVX512
+        Info.m_bSupportsISA[ISA_TYPE_AVX512] = false;
+    #endif
+
+        Info.m_BestISA = ISA_TYPE_SCALAR;
+        for( int iISA = 0; iISA < ISA_TYPE_MAX; ++iISA )
+        {
+            if( Info.m_bSupportsISA[iISA] )
+            {
+                Info.m_BestISA = (ISA_TYPE)iISA;
+            }
+        }
+
+        return Info;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Queried once, on first use
+    //--------------------------------------------------------------------------------------
+    const CPUInfo& GetCPUInfo()
+    {
+        static const CPUInfo s_Info = CreateCPUInfo();
+
+        return s_Info;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Human readable ISA name
+    //--------------------------------------------------------------------------------------
+    const char* GetISAName( ISA_TYPE ISA )
+    {
+        static const char* s_pszISAName[ISA_TYPE_MAX] =
+        {
+            "Scalar",
+            "SSE4.1",
+            "AVX2",
+            "AVX-512"
+        };
+
+        return ( ISA < ISA_TYPE_MAX ) ? s_pszISAName[ISA] : "Unknown";
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
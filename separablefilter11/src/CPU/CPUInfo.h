@@ -0,0 +1,71 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: CPUInfo.h
+//
+// Queries the capabilities of the CPU, so that the best kernels can be selected at runtime.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+
+namespace CPUFilter
+{
+    // Instruction set enumeration, in order of preference
+    typedef enum _ISA_TYPE
+    {
+        ISA_TYPE_SCALAR,
+        ISA_TYPE_SSE41,
+        ISA_TYPE_AVX2,      // AVX2 + FMA3 + F16C
+        ISA_TYPE_AVX512,    // AVX-512 F + BW + DQ + VL
+        ISA_TYPE_MAX
+    }ISA_TYPE;
+
+    class CPUInfo
+    {
+    public:
+
+        bool        m_bSupportsISA[ISA_TYPE_MAX];
+        ISA_TYPE    m_BestISA;
+
+        // Hardware threads
+        unsigned int m_uNumLogicalCores;
+
+        // Per core data caches, in bytes
+        unsigned int m_uL1DataCacheSize;
+        unsigned int m_uL2CacheSize;
+        unsigned int m_uCacheLineSize;
+    };
+
+    // Queried once, on first use
+    const CPUInfo& GetCPUInfo();
+
+    const char* GetISAName( ISA_TYPE ISA );
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,527 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: DualFilter.cpp
+//
+// Implements the dual filter chain, and the traffic estimates that compare it to the
+// Gaussian filter.
+//--------------------------------------------------------------------------------------
+
+
+#include "DualFilter.h"
+
+
+namespace CPUFilter
+{
+    // Variances of the downsample and upsample, in texels squared at the finer level
+    static const double DUAL_DOWNSAMPLE_VARIANCE    = 0.75;
+    static const double DUAL_UPSAMPLE_VARIANCE      = 25.0 / 12.0;
+
+
+    //--------------------------------------------------------------------------------------
+    // The downsample's samples sit between texels, adding a quarter texel squared of bilinear
+    // spread to the 1/2 of its diagonals. The upsample's sit a quarter texel off the coarse
+    // texels, adding 3/16 to the 1/3 of its taps, in coarse texels.
+    //--------------------------------------------------------------------------------------
+    float ComputeDualFilterDeviation( int iNumLevels )
+    {
+        assert( iNumLevels >= 0 );
+
+        double dVariance = 0.0;
+        double dScale = 1.0;
+        for( int iLevel = 0; iLevel < iNumLevels; ++iLevel )
+        {
+            dVariance += ( DUAL_DOWNSAMPLE_VARIANCE + DUAL_UPSAMPLE_VARIANCE ) * dScale;
+            dScale *= 4.0;
+        }
+
+        return (float)sqrt( dVariance );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Adds levels while the next one is nearer, by ratio, to the requested deviation. Images
+    // too small to halve get no levels, and are left as they are.
+    //--------------------------------------------------------------------------------------
+    int ComputeDualFilterLevels( float fDeviation, float* pChainDeviation, unsigned int uWidth, unsigned int uHeight )
+    {
+        assert( fDeviation > 0.0f );
+
+        // Stop before a level would be under 2 texels across, as ComputePyramidLevels
+        int iMaxLevels = MAX_DUAL_FILTER_LEVELS;
+        if( uWidth > 0 && uHeight > 0 )
+        {
+            unsigned int uSize = ( uWidth < uHeight ) ? uWidth : uHeight;
+            for( iMaxLevels = 0; iMaxLevels < MAX_DUAL_FILTER_LEVELS && uSize >= 4; ++iMaxLevels )
+            {
+                uSize = DivRoundUp( uSize, 2 );
+            }
+        }
+
+        int iNumLevels = ( iMaxLevels > 0 ) ? 1 : 0;
+        while( iNumLevels < iMaxLevels )
+        {
+            const float fNear = ComputeDualFilterDeviation( iNumLevels );
+            const float fFar = ComputeDualFilterDeviation( iNumLevels + 1 );
+            if( fFar * fNear > fDeviation * fDeviation )
+            {
+                break;
+            }
+
+            ++iNumLevels;
+        }
+
+        if( NULL != pChainDeviation )
+        {
+            *pChainDeviation = ComputeDualFilterDeviation( iNumLevels );
+        }
+
+        return iNumLevels;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Each pass reads its input and writes its output once
+    //--------------------------------------------------------------------------------------
+    static void AddPassTraffic( double dInputTexels, unsigned int uInputBytes, double dOutputTexels, unsigned int uOutputBytes,
+        double dTapsPerTexel, FilterTraffic* pTraffic )
+    {
+        pTraffic->iNumPasses++;
+        pTraffic->dBytesRead += dInputTexels * (double)uInputBytes;
+        pTraffic->dBytesWritten += dOutputTexels * (double)uOutputBytes;
+        pTraffic->dTaps += dOutputTexels * dTapsPerTexel;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Down and up through the levels, 5 samples per downsampled texel and 8 per upsampled
+    //--------------------------------------------------------------------------------------
+    void ComputeDualFilterTraffic( unsigned int uWidth, unsigned int uHeight, int iNumLevels, unsigned int uBytesPerTexel,
+        unsigned int uLevelBytesPerTexel, FilterTraffic* pTraffic )
+    {
+        assert( NULL != pTraffic );
+
+        memset( pTraffic, 0, sizeof( FilterTraffic ) );
+
+        unsigned int uFinerWidth = uWidth;
+        unsigned int uFinerHeight = uHeight;
+        for( int iLevel = 0; iLevel < iNumLevels; ++iLevel )
+        {
+            const unsigned int uFinerBytes = ( 0 == iLevel ) ? uBytesPerTexel : uLevelBytesPerTexel;
+            const double dFinerTexels = (double)uFinerWidth * (double)uFinerHeight;
+            uFinerWidth = DivRoundUp( uFinerWidth, 2 );
+            uFinerHeight = DivRoundUp( uFinerHeight, 2 );
+            const double dCoarserTexels = (double)uFinerWidth * (double)uFinerHeight;
+
+            AddPassTraffic( dFinerTexels, uFinerBytes, dCoarserTexels, uLevelBytesPerTexel, 5.0, pTraffic );
+            AddPassTraffic( dCoarserTexels, uLevelBytesPerTexel, dFinerTexels, uFinerBytes, 8.0, pTraffic );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Two passes of a tap per texel of the kernel, or per merged pair of them
+    //--------------------------------------------------------------------------------------
+    void ComputeSeparableFilterTraffic( unsigned int uWidth, unsigned int uHeight, int iKernelRadius, bool bApproximate,
+        unsigned int uBytesPerTexel, FilterTraffic* pTraffic )
+    {
+        assert( NULL != pTraffic );
+
+        memset( pTraffic, 0, sizeof( FilterTraffic ) );
+
+        const double dTexels = (double)uWidth * (double)uHeight;
+        const double dTaps = bApproximate ? (double)( iKernelRadius + 1 ) : (double)( iKernelRadius * 2 + 1 );
+
+        AddPassTraffic( dTexels, uBytesPerTexel, dTexels, uBytesPerTexel, dTaps, pTraffic );
+        AddPassTraffic( dTexels, uBytesPerTexel, dTexels, uBytesPerTexel, dTaps, pTraffic );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Down through the levels with 4 samples per texel, the separable filter at the coarse
+    // level, and up with a single sample per texel
+    //--------------------------------------------------------------------------------------
+    void ComputePyramidTraffic( unsigned int uWidth, unsigned int uHeight, int iNumLevels, int iCoarseRadius, bool bApproximate,
+        unsigned int uBytesPerTexel, unsigned int uLevelBytesPerTexel, FilterTraffic* pTraffic )
+    {
+        assert( NULL != pTraffic );
+
+        unsigned int uCoarseWidth = uWidth;
+        unsigned int uCoarseHeight = uHeight;
+        for( int iLevel = 0; iLevel < iNumLevels; ++iLevel )
+        {
+            uCoarseWidth = DivRoundUp( uCoarseWidth, 2 );
+            uCoarseHeight = DivRoundUp( uCoarseHeight, 2 );
+        }
+
+        ComputeSeparableFilterTraffic( uCoarseWidth, uCoarseHeight, iCoarseRadius, bApproximate,
+            ( 0 == iNumLevels ) ? uBytesPerTexel : uLevelBytesPerTexel, pTraffic );
+
+        unsigned int uFinerWidth = uWidth;
+        unsigned int uFinerHeight = uHeight;
+        for( int iLevel = 0; iLevel < iNumLevels; ++iLevel )
+        {
+            const unsigned int uFinerBytes = ( 0 == iLevel ) ? uBytesPerTexel : uLevelBytesPerTexel;
+            const double dFinerTexels = (double)uFinerWidth * (double)uFinerHeight;
+            uFinerWidth = DivRoundUp( uFinerWidth, 2 );
+            uFinerHeight = DivRoundUp( uFinerHeight, 2 );
+            const double dCoarserTexels = (double)uFinerWidth * (double)uFinerHeight;
+
+            AddPassTraffic( dFinerTexels, uFinerBytes, dCoarserTexels, uLevelBytesPerTexel, 4.0, pTraffic );
+            AddPassTraffic( dCoarserTexels, uLevelBytesPerTexel, dFinerTexels, uFinerBytes, 1.0, pTraffic );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Applies a 4 x 4 window of weights, at 4 rows and 4 float offsets into them
+    //--------------------------------------------------------------------------------------
+    static inline Float4 ApplyWindow( const float* const pRows[4], const int iX[4], const float fWeights[4][4] )
+    {
+        float fSum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for( int iRow = 0; iRow < 4; ++iRow )
+        {
+            const float* pRow = pRows[iRow];
+            for( int iColumn = 0; iColumn < 4; ++iColumn )
+            {
+                const float fWeight = fWeights[iRow][iColumn];
+                const float* pTexel = pRow + iX[iColumn];
+                for( int c = 0; c < 4; ++c )
+                {
+                    fSum[c] += fWeight * pTexel[c];
+                }
+            }
+        }
+
+        return MakeFloat4( fSum[0], fSum[1], fSum[2], fSum[3] );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Same dispatch as CSFilterX, over the output
+    //--------------------------------------------------------------------------------------
+    void DualDownsample::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = DivRoundUp( (unsigned int)OutputWidth(), RUN_SIZE );
+        uY = DivRoundUp( (unsigned int)OutputHeight(), RUN_LINES );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // The 4 x 4 input texels from 2i-1 to 2i+2 around each output texel
+    //--------------------------------------------------------------------------------------
+    void DualDownsample::ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& /*LDS*/ ) const
+    {
+        static const float s_fWeights[4][4] =
+        {
+            { 1.0f / 32.0f, 1.0f / 32.0f, 1.0f / 32.0f, 1.0f / 32.0f },
+            { 1.0f / 32.0f, 5.0f / 32.0f, 5.0f / 32.0f, 1.0f / 32.0f },
+            { 1.0f / 32.0f, 5.0f / 32.0f, 5.0f / 32.0f, 1.0f / 32.0f },
+            { 1.0f / 32.0f, 1.0f / 32.0f, 1.0f / 32.0f, 1.0f / 32.0f },
+        };
+
+        const Surface& Input = *m_pInputs[0];
+        const int iLastX = (int)Input.m_uWidth - 1;
+        const int iLastY = (int)Input.m_uHeight - 1;
+        const int iGroupCoordX = (int)uGroupX * RUN_SIZE;
+        const int iNumPixels = ( OutputWidth() - iGroupCoordX < RUN_SIZE ) ? ( OutputWidth() - iGroupCoordX ) : RUN_SIZE;
+
+        assert( DivRoundUp( Input.m_uWidth, 2 ) >= (unsigned int)OutputWidth() && DivRoundUp( Input.m_uHeight, 2 ) >= (unsigned int)OutputHeight() );
+
+        for( int iLine = 0; iLine < RUN_LINES; ++iLine )
+        {
+            const int iY = (int)uGroupY * RUN_LINES + iLine;
+            if( iY >= OutputHeight() )
+            {
+                break;
+            }
+
+            const float* pRows[4];
+            for( int iRow = 0; iRow < 4; ++iRow )
+            {
+                pRows[iRow] = &Input.Row( Clamp( iY * 2 - 1 + iRow, 0, iLastY ) )->x;
+            }
+
+            Float4* pOutput = m_pOutput->Row( iY ) + iGroupCoordX;
+
+            for( int iPixel = 0; iPixel < iNumPixels; ++iPixel )
+            {
+                const int iX = ( iGroupCoordX + iPixel ) * 2;
+
+                int iColumns[4];
+                for( int iColumn = 0; iColumn < 4; ++iColumn )
+                {
+                    iColumns[iColumn] = Clamp( iX - 1 + iColumn, 0, iLastX ) * 4;
+                }
+
+                pOutput[iPixel] = ApplyWindow( pRows, iColumns, s_fWeights );
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Splats the bilinear weights of the 8 samples into the window of each output parity.
+    // Even outputs lie at coarse texel k - 1/4 and take texels k-2 to k+1, odd outputs lie at
+    // k + 1/4 and take texels k-1 to k+2.
+    //--------------------------------------------------------------------------------------
+    DualUpsample::DualUpsample()
+    {
+        static const float s_fTaps[8][3] =
+        {
+            { -1.0f,  0.0f, 1.0f / 12.0f }, { 1.0f, 0.0f, 1.0f / 12.0f }, { 0.0f, -1.0f, 1.0f / 12.0f }, { 0.0f, 1.0f, 1.0f / 12.0f },
+            { -0.5f, -0.5f, 2.0f / 12.0f }, { 0.5f, -0.5f, 2.0f / 12.0f }, { -0.5f, 0.5f, 2.0f / 12.0f }, { 0.5f, 0.5f, 2.0f / 12.0f },
+        };
+
+        memset( m_fWeights, 0, sizeof( m_fWeights ) );
+
+        for( int iOddY = 0; iOddY < 2; ++iOddY )
+        {
+            for( int iOddX = 0; iOddX < 2; ++iOddX )
+            {
+                // The output's position within its window
+                const float fCenterX = iOddX ? 1.25f : 1.75f;
+                const float fCenterY = iOddY ? 1.25f : 1.75f;
+
+                for( int iTap = 0; iTap < 8; ++iTap )
+                {
+                    const float fX = fCenterX + s_fTaps[iTap][0];
+                    const float fY = fCenterY + s_fTaps[iTap][1];
+                    const int iX = (int)floorf( fX );
+                    const int iY = (int)floorf( fY );
+                    const float fFracX = fX - (float)iX;
+                    const float fFracY = fY - (float)iY;
+                    const float fWeight = s_fTaps[iTap][2];
+
+                    assert( iX >= 0 && iX < 3 && iY >= 0 && iY < 3 );
+
+                    m_fWeights[iOddY][iOddX][iY][iX] += fWeight * ( 1.0f - fFracX ) * ( 1.0f - fFracY );
+                    m_fWeights[iOddY][iOddX][iY][iX + 1] += fWeight * fFracX * ( 1.0f - fFracY );
+                    m_fWeights[iOddY][iOddX][iY + 1][iX] += fWeight * ( 1.0f - fFracX ) * fFracY;
+                    m_fWeights[iOddY][iOddX][iY + 1][iX + 1] += fWeight * fFracX * fFracY;
+                }
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Same dispatch as CSFilterX, over the output
+    //--------------------------------------------------------------------------------------
+    void DualUpsample::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = DivRoundUp( (unsigned int)OutputWidth(), RUN_SIZE );
+        uY = DivRoundUp( (unsigned int)OutputHeight(), RUN_LINES );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Applies the window of the output's parity
+    //--------------------------------------------------------------------------------------
+    void DualUpsample::ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& /*LDS*/ ) const
+    {
+        const Surface& Input = *m_pInputs[0];
+        const int iLastX = (int)Input.m_uWidth - 1;
+        const int iLastY = (int)Input.m_uHeight - 1;
+        const int iGroupCoordX = (int)uGroupX * RUN_SIZE;
+        const int iNumPixels = ( OutputWidth() - iGroupCoordX < RUN_SIZE ) ? ( OutputWidth() - iGroupCoordX ) : RUN_SIZE;
+
+        assert( Input.m_uWidth >= DivRoundUp( (unsigned int)OutputWidth(), 2 ) && Input.m_uHeight >= DivRoundUp( (unsigned int)OutputHeight(), 2 ) );
+
+        for( int iLine = 0; iLine < RUN_LINES; ++iLine )
+        {
+            const int iY = (int)uGroupY * RUN_LINES + iLine;
+            if( iY >= OutputHeight() )
+            {
+                break;
+            }
+
+            const int iOddY = iY & 1;
+            const int iFirstY = ( iY >> 1 ) - 2 + iOddY;
+
+            const float* pRows[4];
+            for( int iRow = 0; iRow < 4; ++iRow )
+            {
+                pRows[iRow] = &Input.Row( Clamp( iFirstY + iRow, 0, iLastY ) )->x;
+            }
+
+            Float4* pOutput = m_pOutput->Row( iY ) + iGroupCoordX;
+
+            for( int iPixel = 0; iPixel < iNumPixels; ++iPixel )
+            {
+                const int iX = iGroupCoordX + iPixel;
+                const int iOddX = iX & 1;
+                const int iFirstX = ( iX >> 1 ) - 2 + iOddX;
+
+                int iColumns[4];
+                for( int iColumn = 0; iColumn < 4; ++iColumn )
+                {
+                    iColumns[iColumn] = Clamp( iFirstX + iColumn, 0, iLastX ) * 4;
+                }
+
+                pOutput[iPixel] = ApplyWindow( pRows, iColumns, m_fWeights[iOddY][iOddX] );
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    DualFilter::DualFilter()
+    {
+        m_uWidth = m_uHeight = 0;
+        m_iMaxLevels = 0;
+        m_fDeviation = 16.0f;
+        m_iNumLevels = 1;
+        m_fChainDeviation = ComputeDualFilterDeviation( 1 );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Allocates every level the size allows, as GaussianPyramid::Create
+    //--------------------------------------------------------------------------------------
+    bool DualFilter::Create( unsigned int uWidth, unsigned int uHeight )
+    {
+        assert( uWidth > 0 && uHeight > 0 );
+
+        Release();
+
+        m_uWidth = uWidth;
+        m_uHeight = uHeight;
+        m_iMaxLevels = 0;
+
+        unsigned int uLevelWidth = uWidth;
+        unsigned int uLevelHeight = uHeight;
+        while( m_iMaxLevels < MAX_DUAL_FILTER_LEVELS && uLevelWidth >= 4 && uLevelHeight >= 4 )
+        {
+            uLevelWidth = DivRoundUp( uLevelWidth, 2 );
+            uLevelHeight = DivRoundUp( uLevelHeight, 2 );
+
+            if( !m_Levels[m_iMaxLevels].Create( uLevelWidth, uLevelHeight ) )
+            {
+                Release();
+                return false;
+            }
+
+            ++m_iMaxLevels;
+        }
+
+        UpdateLevels();
+
+        return true;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Frees the levels
+    //--------------------------------------------------------------------------------------
+    void DualFilter::Release()
+    {
+        for( int iLevel = 0; iLevel < MAX_DUAL_FILTER_LEVELS; ++iLevel )
+        {
+            m_Levels[iLevel].Release();
+        }
+
+        m_uWidth = m_uHeight = 0;
+        m_iMaxLevels = 0;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Requested deviation at full resolution
+    //--------------------------------------------------------------------------------------
+    void DualFilter::SetDeviation( float fDeviation )
+    {
+        assert( fDeviation > 0.0f );
+
+        m_fDeviation = fDeviation;
+        UpdateLevels();
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Picks the depth of the chain
+    //--------------------------------------------------------------------------------------
+    void DualFilter::UpdateLevels()
+    {
+        m_iNumLevels = ComputeDualFilterLevels( m_fDeviation, &m_fChainDeviation, m_uWidth, m_uHeight );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Halves the input down to the coarse level and doubles it straight back up to the
+    // output. Each upsample overwrites the level it upsamples to, which the downsamples are
+    // done with.
+    //--------------------------------------------------------------------------------------
+    void DualFilter::OnRender( const Surface& Input, Surface& Output )
+    {
+        assert( &Input != &Output );
+        assert( Input.m_uWidth >= m_uWidth && Input.m_uHeight >= m_uHeight );
+        assert( m_iNumLevels <= m_iMaxLevels );
+
+        if( 0 == m_iNumLevels )
+        {
+            for( int iY = 0; iY < (int)m_uHeight; ++iY )
+            {
+                memcpy( Output.Row( iY ), Input.Row( iY ), m_uWidth * sizeof( Float4 ) );
+            }
+            return;
+        }
+
+        const Surface* pFiner = &Input;
+        for( int iLevel = 0; iLevel < m_iNumLevels; ++iLevel )
+        {
+            RunPass( &m_Downsample, *pFiner, m_Levels[iLevel], m_Levels[iLevel].m_uWidth, m_Levels[iLevel].m_uHeight );
+            pFiner = &m_Levels[iLevel];
+        }
+
+        for( int iLevel = m_iNumLevels - 2; iLevel >= 0; --iLevel )
+        {
+            RunPass( &m_Upsample, m_Levels[iLevel + 1], m_Levels[iLevel], m_Levels[iLevel].m_uWidth, m_Levels[iLevel].m_uHeight );
+        }
+
+        RunPass( &m_Upsample, m_Levels[0], Output, m_uWidth, m_uHeight );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Runs one pass of the chain as the fused filter
+    //--------------------------------------------------------------------------------------
+    void DualFilter::RunPass( FilterPass* pPass, const Surface& Input, Surface& Output, unsigned int uWidth, unsigned int uHeight )
+    {
+        const Surface* pInputs[1] = { &Input };
+
+        m_Filter.SetOutputSize( uWidth, uHeight );
+        m_Filter.SetInputSurfaces( pInputs, pInputs, 1 );
+        m_Filter.SetOutputSurfaces( NULL, &Output );
+        m_Filter.SetFusedFilter( pPass );
+        m_Filter.OnRender();
+        m_Filter.SetFusedFilter( NULL );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
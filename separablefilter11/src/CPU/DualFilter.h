@@ -0,0 +1,181 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: DualFilter.h
+//
+// Dual filter chain for bloom, which needs a wide blur rather than an exact Gaussian. The
+// image is halved a number of times by a 5 tap downsample and doubled back up by an 8 tap
+// upsample, with no filtering at the coarse level, so each pass reads little more than
+// its input once. The width doubles with each level, so the depth of the chain is picked
+// from the requested deviation.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "SeparableFilterCPU.h"
+
+
+namespace CPUFilter
+{
+    // Defines
+    static const int MAX_DUAL_FILTER_LEVELS = 8;
+
+
+    //--------------------------------------------------------------------------------------
+    // Deviation of the blur of a chain of iNumLevels, in full resolution texels. Each level
+    // adds the variances of its downsample and upsample (3/4 and 25/12 texels squared at the
+    // finer level) times 4^l, so the deviation roughly doubles per level.
+    //--------------------------------------------------------------------------------------
+    float ComputeDualFilterDeviation( int iNumLevels );
+
+
+    //--------------------------------------------------------------------------------------
+    // Depth of the chain whose deviation is nearest to fDeviation, by ratio, and at least 1.
+    // The deviation of that chain is returned in pChainDeviation, and the depth is capped as
+    // ComputePyramidLevels by the size of the image, when given, which leaves images under 4
+    // texels across with none.
+    //--------------------------------------------------------------------------------------
+    int ComputeDualFilterLevels( float fDeviation, float* pChainDeviation, unsigned int uWidth = 0, unsigned int uHeight = 0 );
+
+
+    //--------------------------------------------------------------------------------------
+    // Memory traffic of a filter on the GPU, assuming the texture caches read each texel of
+    // a pass's input once. Taps are the samples taken by the shaders, from the textures or
+    // the LDS, so they measure the work that the caches absorb.
+    //--------------------------------------------------------------------------------------
+    struct FilterTraffic
+    {
+        int     iNumPasses;
+        double  dBytesRead;
+        double  dBytesWritten;
+        double  dTaps;
+
+        double BytesMoved() const { return dBytesRead + dBytesWritten; }
+    };
+
+    // The dual filter chain, with the input and output at uBytesPerTexel and the levels at
+    // uLevelBytesPerTexel
+    void ComputeDualFilterTraffic( unsigned int uWidth, unsigned int uHeight, int iNumLevels, unsigned int uBytesPerTexel,
+        unsigned int uLevelBytesPerTexel, FilterTraffic* pTraffic );
+
+    // The horizontal and vertical passes of GaussianFilter.hlsl, with an intermediate of the
+    // same format
+    void ComputeSeparableFilterTraffic( unsigned int uWidth, unsigned int uHeight, int iKernelRadius, bool bApproximate,
+        unsigned int uBytesPerTexel, FilterTraffic* pTraffic );
+
+    // The Gaussian pyramid, with GaussianFilter.hlsl of iCoarseRadius at its coarse level
+    void ComputePyramidTraffic( unsigned int uWidth, unsigned int uHeight, int iNumLevels, int iCoarseRadius, bool bApproximate,
+        unsigned int uBytesPerTexel, unsigned int uLevelBytesPerTexel, FilterTraffic* pTraffic );
+
+
+    //--------------------------------------------------------------------------------------
+    // Dual filter downsample: a bilinear sample at the center of each output texel, which
+    // lies between input texels 2i and 2i+1, weighted by 1/2, and 4 diagonal samples one
+    // input texel away weighted by 1/8. The samples fall between texels, so they cover the
+    // 4 x 4 input texels around the center by 1/32, and the inner 2 x 2 by 5/32. The output
+    // size is set through SeparableFilterCPU::SetOutputSize, as the input size halved and
+    // rounded up.
+    //--------------------------------------------------------------------------------------
+    class DualDownsample : public FilterPass
+    {
+    public:
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Dual filter upsample by 2: output texel x lies at coarse texel x / 2 - 1/4, and takes
+    // bilinear samples one coarse texel away along the axes weighted by 1/12, and half a
+    // coarse texel away along the diagonals weighted by 2/12. The samples are splatted into
+    // a 4 x 4 window of coarse texels per output parity at construction.
+    //--------------------------------------------------------------------------------------
+    class DualUpsample : public FilterPass
+    {
+    public:
+
+        DualUpsample();
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+
+    private:
+
+        float   m_fWeights[2][2][4][4];     // [Odd Y][Odd X][Row][Column]
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Runs the whole chain through a SeparableFilterCPU of its own, as GaussianPyramid. The
+    // levels for every depth are allocated by Create, so the deviation can change freely.
+    //--------------------------------------------------------------------------------------
+    class DualFilter
+    {
+    public:
+
+        DualFilter();
+        ~DualFilter() { Release(); }
+
+        // Allocates the levels for images of the given size
+        bool Create( unsigned int uWidth, unsigned int uHeight );
+        void Release();
+
+        // Requested deviation, which picks the depth of the chain
+        void SetDeviation( float fDeviation );
+        float GetDeviation() const { return m_fDeviation; }
+        int GetNumLevels() const { return m_iNumLevels; }
+        float GetChainDeviation() const { return m_fChainDeviation; }
+
+        // Takes a MAXCORES_TYPE, or an explicit number of threads (defaults to all cores)
+        void SetMaximumCores( int iMaxCores ) { m_Filter.SetMaximumCores( iMaxCores ); }
+
+        // Blurs the input into the output, which must be different surfaces of the created size
+        void OnRender( const Surface& Input, Surface& Output );
+
+    private:
+
+        void UpdateLevels();
+        void RunPass( FilterPass* pPass, const Surface& Input, Surface& Output, unsigned int uWidth, unsigned int uHeight );
+
+        DualFilter( const DualFilter& );
+        DualFilter& operator=( const DualFilter& );
+
+        Surface             m_Levels[MAX_DUAL_FILTER_LEVELS];   // Levels 1 and on, level 0 being the input
+        unsigned int        m_uWidth;
+        unsigned int        m_uHeight;
+        int                 m_iMaxLevels;                       // Allowed by the size of the image
+        float               m_fDeviation;
+        int                 m_iNumLevels;
+        float               m_fChainDeviation;
+        SeparableFilterCPU  m_Filter;
+        DualDownsample      m_Downsample;
+        DualUpsample        m_Upsample;
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,491 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: FilterCommon.h
+//
+// Common defines and types for the CPU separable filtering kernels. These mirror
+// FilterCommon.hlsl, so that the CPU and GPU paths tile the image identically.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined( _MSC_VER )
+    #include <malloc.h>
+#endif
+
+
+namespace CPUFilter
+{
+    // Defines that control the logic of the kernel, these must match FilterCommon.hlsl
+    static const int RUN_LINES              = 2;    // Needs to match RUN_LINES in FilterCommon.hlsl
+    static const int RUN_SIZE               = 128;  // Needs to match RUN_SIZE in FilterCommon.hlsl
+    static const int PIXELS_PER_THREAD      = 4;
+    static const int NUM_THREADS            = RUN_SIZE / PIXELS_PER_THREAD;
+    static const int MAX_INPUTS             = 4;
+    static const int MAX_KERNEL_RADIUS      = 64;   // The shader permutations stop at 32, see KERNEL_RADIUS_TYPE
+
+    // Alignment used for all surface rows and scratch memory (a cache line, and wide enough for AVX-512)
+    static const size_t MEMORY_ALIGNMENT    = 64;
+
+    // Pass type enumeration
+    typedef enum _PASS_TYPE
+    {
+        PASS_TYPE_HORIZONTAL,
+        PASS_TYPE_VERTICAL,
+        PASS_TYPE_MAX
+    }PASS_TYPE;
+
+    // Kernel radius enumeration, mirrors SeparableFilter::KERNEL_RADIUS_TYPE
+    typedef enum _KERNEL_RADIUS_TYPE
+    {
+        KERNEL_RADIUS_TYPE_2,
+        KERNEL_RADIUS_TYPE_4,
+        KERNEL_RADIUS_TYPE_6,
+        KERNEL_RADIUS_TYPE_8,
+        KERNEL_RADIUS_TYPE_10,
+        KERNEL_RADIUS_TYPE_12,
+        KERNEL_RADIUS_TYPE_14,
+        KERNEL_RADIUS_TYPE_16,
+        KERNEL_RADIUS_TYPE_18,
+        KERNEL_RADIUS_TYPE_20,
+        KERNEL_RADIUS_TYPE_22,
+        KERNEL_RADIUS_TYPE_24,
+        KERNEL_RADIUS_TYPE_26,
+        KERNEL_RADIUS_TYPE_28,
+        KERNEL_RADIUS_TYPE_30,
+        KERNEL_RADIUS_TYPE_32,
+        KERNEL_RADIUS_TYPE_MAX
+    }KERNEL_RADIUS_TYPE;
+
+    // LDS precision enumeration, mirrors SeparableFilter::LDS_PRECISION_TYPE
+    typedef enum _LDS_PRECISION_TYPE
+    {
+        LDS_PRECISION_TYPE_8_BIT,
+        LDS_PRECISION_TYPE_16_BIT,
+        LDS_PRECISION_TYPE_32_BIT,
+        LDS_PRECISION_TYPE_MAX
+    }LDS_PRECISION_TYPE;
+
+    // Size in bytes of each channel stored at an LDS precision
+    inline unsigned int GetLDSItemSize( LDS_PRECISION_TYPE LDSPrecision )
+    {
+        return ( LDS_PRECISION_TYPE_8_BIT == LDSPrecision ) ? 1 : ( ( LDS_PRECISION_TYPE_16_BIT == LDSPrecision ) ? 2 : 4 );
+    }
+
+    // Sampler type enumeration, mirrors g_PointSampler and g_LinearClampSampler
+    typedef enum _SAMPLER_TYPE
+    {
+        SAMPLER_TYPE_POINT,
+        SAMPLER_TYPE_LINEAR_CLAMP,
+        SAMPLER_TYPE_MAX
+    }SAMPLER_TYPE;
+
+
+    //--------------------------------------------------------------------------------------
+    // Vector types matching the HLSL float3 / float4
+    //--------------------------------------------------------------------------------------
+    struct Float3
+    {
+        float x, y, z;
+    };
+
+    struct Float4
+    {
+        float x, y, z, w;
+    };
+
+    inline Float3 MakeFloat3( float fX, float fY, float fZ ) { Float3 f3 = { fX, fY, fZ }; return f3; }
+    inline Float4 MakeFloat4( float fX, float fY, float fZ, float fW ) { Float4 f4 = { fX, fY, fZ, fW }; return f4; }
+    inline Float4 MakeFloat4( const Float3& f3, float fW ) { Float4 f4 = { f3.x, f3.y, f3.z, fW }; return f4; }
+    inline Float3 XYZ( const Float4& f4 ) { return MakeFloat3( f4.x, f4.y, f4.z ); }
+
+    inline Float3 operator+( const Float3& a, const Float3& b ) { return MakeFloat3( a.x + b.x, a.y + b.y, a.z + b.z ); }
+    inline Float3 operator*( const Float3& a, float f ) { return MakeFloat3( a.x * f, a.y * f, a.z * f ); }
+    inline Float3& operator+=( Float3& a, const Float3& b ) { a.x += b.x; a.y += b.y; a.z += b.z; return a; }
+    inline Float3& operator/=( Float3& a, float f ) { float fInv = 1.0f / f; a.x *= fInv; a.y *= fInv; a.z *= fInv; return a; }
+
+    inline Float4 operator+( const Float4& a, const Float4& b ) { return MakeFloat4( a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w ); }
+    inline Float4 operator*( const Float4& a, float f ) { return MakeFloat4( a.x * f, a.y * f, a.z * f, a.w * f ); }
+
+    inline int Clamp( int iValue, int iMin, int iMax ) { return ( iValue < iMin ) ? iMin : ( ( iValue > iMax ) ? iMax : iValue ); }
+    inline float Saturate( float fValue ) { return ( fValue < 0.0f ) ? 0.0f : ( ( fValue > 1.0f ) ? 1.0f : fValue ); }
+    inline unsigned int DivRoundUp( unsigned int uValue, unsigned int uDivisor ) { return ( uValue + uDivisor - 1 ) / uDivisor; }
+
+
+    //--------------------------------------------------------------------------------------
+    // A rectangle of texels, matching D3D11_RECT, so right and bottom are exclusive
+    //--------------------------------------------------------------------------------------
+    struct Rect
+    {
+        int left, top, right, bottom;
+    };
+
+    inline Rect MakeRect( int iLeft, int iTop, int iRight, int iBottom ) { Rect r = { iLeft, iTop, iRight, iBottom }; return r; }
+
+
+    //--------------------------------------------------------------------------------------
+    // The part of the output a compute shader pass recomputes for a dirty rectangle of the
+    // input: the horizontal pass ( iPass 0 ) within the kernel radius of it across, and the
+    // vertical pass within the kernel radius of that down, clipped to the output. Returns
+    // false if nothing is left. SeparableFilter::OnRenderDirty dispatches over it with its
+    // origin in g_i4DispatchOrigin, with the radius of the bound permutation.
+    //--------------------------------------------------------------------------------------
+    inline bool GrowDirtyRect( const Rect& Dirty, int iPass, int iKernelRadius, int iWidth, int iHeight, Rect& Grown )
+    {
+        const int iGrowX = iKernelRadius;
+        const int iGrowY = ( 0 == iPass ) ? 0 : iKernelRadius;
+
+        Grown.left = ( Dirty.left - iGrowX > 0 ) ? ( Dirty.left - iGrowX ) : 0;
+        Grown.top = ( Dirty.top - iGrowY > 0 ) ? ( Dirty.top - iGrowY ) : 0;
+        Grown.right = ( Dirty.right + iGrowX < iWidth ) ? ( Dirty.right + iGrowX ) : iWidth;
+        Grown.bottom = ( Dirty.bottom + iGrowY < iHeight ) ? ( Dirty.bottom + iGrowY ) : iHeight;
+
+        return Grown.left < Grown.right && Grown.top < Grown.bottom;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Aligned allocation helpers
+    //--------------------------------------------------------------------------------------
+    inline void* AlignedMalloc( size_t uBytes )
+    {
+    #if defined( _MSC_VER )
+        return _aligned_malloc( uBytes, MEMORY_ALIGNMENT );
+    #else
+        void* pMemory = NULL;
+        return ( 0 == posix_memalign( &pMemory, MEMORY_ALIGNMENT, uBytes ) ) ? pMemory : NULL;
+    #endif
+    }
+
+    inline void AlignedFree( void* pMemory )
+    {
+    #if defined( _MSC_VER )
+        _aligned_free( pMemory );
+    #else
+        free( pMemory );
+    #endif
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // A 2D surface of Float4 texels, the CPU equivalent of a Texture2D SRV / UAV pair.
+    // Either owns its memory (Create) or wraps memory owned by the caller (CreateView).
+    //--------------------------------------------------------------------------------------
+    class Surface
+    {
+    public:
+
+        Surface() : m_pData( NULL ), m_uWidth( 0 ), m_uHeight( 0 ), m_uPitch( 0 ), m_bOwnsData( false ) {}
+        ~Surface() { Release(); }
+
+        // Allocates a surface with each row aligned to MEMORY_ALIGNMENT
+        bool Create( unsigned int uWidth, unsigned int uHeight )
+        {
+            Release();
+
+            const unsigned int uTexelsPerAlignment = (unsigned int)( MEMORY_ALIGNMENT / sizeof( Float4 ) );
+            unsigned int uPitch = DivRoundUp( uWidth, uTexelsPerAlignment ) * uTexelsPerAlignment;
+
+            m_pData = (Float4*)AlignedMalloc( (size_t)uPitch * uHeight * sizeof( Float4 ) );
+            if( NULL == m_pData )
+            {
+                return false;
+            }
+
+            m_uWidth = uWidth;
+            m_uHeight = uHeight;
+            m_uPitch = uPitch;
+            m_bOwnsData = true;
+
+            return true;
+        }
+
+        // Wraps caller owned memory, the pitch is in texels
+        void CreateView( Float4* pData, unsigned int uWidth, unsigned int uHeight, unsigned int uPitch )
+        {
+            assert( NULL != pData );
+            assert( uPitch >= uWidth );
+
+            Release();
+
+            m_pData = pData;
+            m_uWidth = uWidth;
+            m_uHeight = uHeight;
+            m_uPitch = uPitch;
+            m_bOwnsData = false;
+        }
+
+        void Release()
+        {
+            if( m_bOwnsData )
+            {
+                AlignedFree( m_pData );
+            }
+
+            m_pData = NULL;
+            m_uWidth = m_uHeight = m_uPitch = 0;
+            m_bOwnsData = false;
+        }
+
+        Float4* Row( int iY ) { return m_pData + (size_t)iY * m_uPitch; }
+        const Float4* Row( int iY ) const { return m_pData + (size_t)iY * m_uPitch; }
+
+        // Point sample with clamp addressing
+        const Float4& Load( int iX, int iY ) const
+        {
+            return Row( Clamp( iY, 0, (int)m_uHeight - 1 ) )[Clamp( iX, 0, (int)m_uWidth - 1 )];
+        }
+
+        // Bilinear sample with clamp addressing, the position is in texels with integers at texel centers
+        Float4 SampleLinear( float fX, float fY ) const
+        {
+            float fFloorX = floorf( fX );
+            float fFloorY = floorf( fY );
+            float fFracX = fX - fFloorX;
+            float fFracY = fY - fFloorY;
+            int iX = (int)fFloorX;
+            int iY = (int)fFloorY;
+
+            Float4 f4Top = Load( iX, iY ) * ( 1.0f - fFracX ) + Load( iX + 1, iY ) * fFracX;
+            Float4 f4Bottom = Load( iX, iY + 1 ) * ( 1.0f - fFracX ) + Load( iX + 1, iY + 1 ) * fFracX;
+
+            return f4Top * ( 1.0f - fFracY ) + f4Bottom * fFracY;
+        }
+
+        // Samples using the given sampler
+        Float4 Sample( SAMPLER_TYPE Sampler, float fX, float fY ) const
+        {
+            if( SAMPLER_TYPE_POINT == Sampler || ( fX == floorf( fX ) && fY == floorf( fY ) ) )
+            {
+                return Load( (int)floorf( fX + 0.5f ), (int)floorf( fY + 0.5f ) );
+            }
+
+            return SampleLinear( fX, fY );
+        }
+
+        Float4*         m_pData;
+        unsigned int    m_uWidth;
+        unsigned int    m_uHeight;
+        unsigned int    m_uPitch;      // In texels
+        bool            m_bOwnsData;
+
+    private:
+
+        Surface( const Surface& );
+        Surface& operator=( const Surface& );
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // A 2D surface of texels of 4 unsigned chars, the CPU equivalent of an R8G8B8A8_UNORM
+    // texture. Either owns its memory (Create) or wraps memory owned by the caller.
+    //--------------------------------------------------------------------------------------
+    class SurfaceUNorm8
+    {
+    public:
+
+        SurfaceUNorm8() : m_pData( NULL ), m_uWidth( 0 ), m_uHeight( 0 ), m_uPitch( 0 ), m_bOwnsData( false ) {}
+        ~SurfaceUNorm8() { Release(); }
+
+        // Allocates a surface with each row aligned to MEMORY_ALIGNMENT
+        bool Create( unsigned int uWidth, unsigned int uHeight )
+        {
+            Release();
+
+            const unsigned int uTexelsPerAlignment = (unsigned int)( MEMORY_ALIGNMENT / 4 );
+            unsigned int uPitch = DivRoundUp( uWidth, uTexelsPerAlignment ) * uTexelsPerAlignment;
+
+            m_pData = (unsigned char*)AlignedMalloc( (size_t)uPitch * uHeight * 4 );
+            if( NULL == m_pData )
+            {
+                return false;
+            }
+
+            m_uWidth = uWidth;
+            m_uHeight = uHeight;
+            m_uPitch = uPitch;
+            m_bOwnsData = true;
+
+            return true;
+        }
+
+        // Wraps caller owned memory, the pitch is in texels
+        void CreateView( unsigned char* pData, unsigned int uWidth, unsigned int uHeight, unsigned int uPitch )
+        {
+            assert( NULL != pData );
+            assert( uPitch >= uWidth );
+
+            Release();
+
+            m_pData = pData;
+            m_uWidth = uWidth;
+            m_uHeight = uHeight;
+            m_uPitch = uPitch;
+            m_bOwnsData = false;
+        }
+
+        void Release()
+        {
+            if( m_bOwnsData )
+            {
+                AlignedFree( m_pData );
+            }
+
+            m_pData = NULL;
+            m_uWidth = m_uHeight = m_uPitch = 0;
+            m_bOwnsData = false;
+        }
+
+        // Each row holds 4 channels per texel
+        unsigned char* Row( int iY ) { return m_pData + (size_t)iY * m_uPitch * 4; }
+        const unsigned char* Row( int iY ) const { return m_pData + (size_t)iY * m_uPitch * 4; }
+
+        unsigned char*  m_pData;
+        unsigned int    m_uWidth;
+        unsigned int    m_uHeight;
+        unsigned int    m_uPitch;      // In texels
+        bool            m_bOwnsData;
+
+    private:
+
+        SurfaceUNorm8( const SurfaceUNorm8& );
+        SurfaceUNorm8& operator=( const SurfaceUNorm8& );
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Growable aligned scratch memory, the CPU stand in for the LDS of a thread group
+    //--------------------------------------------------------------------------------------
+    class Scratch
+    {
+    public:
+
+        Scratch() : m_pMemory( NULL ), m_uSize( 0 ) {}
+        ~Scratch() { AlignedFree( m_pMemory ); }
+
+        void* Reserve( size_t uBytes )
+        {
+            if( uBytes > m_uSize )
+            {
+                AlignedFree( m_pMemory );
+                m_pMemory = AlignedMalloc( uBytes );
+                m_uSize = ( NULL != m_pMemory ) ? uBytes : 0;
+            }
+
+            return m_pMemory;
+        }
+
+    private:
+
+        Scratch( const Scratch& );
+        Scratch& operator=( const Scratch& );
+
+        void*   m_pMemory;
+        size_t  m_uSize;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Base class for a filter pass, the CPU equivalent of a compute shader. Inputs and the
+    // output are bound by the SeparableFilterCPU class before the pass is dispatched.
+    //--------------------------------------------------------------------------------------
+    class FilterPass
+    {
+    public:
+
+        FilterPass() : m_iNumInputs( 0 ), m_pOutput( NULL ), m_iKernelRadius( 16 ), m_iStepSize( 1 )
+        {
+            memset( m_pInputs, 0, sizeof( m_pInputs ) );
+            memset( m_fOutputSize, 0, sizeof( m_fOutputSize ) );
+        }
+        virtual ~FilterPass() {}
+
+        // Equivalent of not defining KERNEL_LERP_SAMPLES. Filters that define it hide this with
+        // their own LERP_LDS_READS = true (see FilterKernel.h).
+        static const bool LERP_LDS_READS = false;
+
+        // Equivalent of the KERNEL_RADIUS and USE_APPROXIMATE_FILTER compile time defines
+        virtual void SetKernel( int iKernelRadius, bool bApproximate )
+        {
+            assert( iKernelRadius > 0 && iKernelRadius <= MAX_KERNEL_RADIUS );
+            assert( !bApproximate || ( iKernelRadius % 2 ) == 0 );
+
+            m_iKernelRadius = iKernelRadius;
+            m_iStepSize = bApproximate ? 2 : 1;
+        }
+
+        // Binds inputs in order provided (base 0), and the output, which may be NULL for a pass
+        // that writes to a surface of its own
+        void Bind( const Surface* const* ppInputs, int iNumInputs, Surface* pOutput, const float fOutputSize[4] )
+        {
+            assert( iNumInputs <= MAX_INPUTS );
+
+            for( int iInput = 0; iInput < MAX_INPUTS; ++iInput )
+            {
+                m_pInputs[iInput] = ( iInput < iNumInputs ) ? ppInputs[iInput] : NULL;
+            }
+            m_iNumInputs = iNumInputs;
+            m_pOutput = pOutput;
+            memcpy( m_fOutputSize, fOutputSize, sizeof( m_fOutputSize ) );
+        }
+
+        // Number of groups to dispatch
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const = 0;
+
+        // Size of the rectangle of the output computed by each group, in row major order from
+        // the origin. Passes returning 0, whose groups do not tile the output this way, are
+        // always dispatched whole by SeparableFilterCPU::OnRenderDirty.
+        virtual void GetGroupSize( unsigned int& uWidth, unsigned int& uHeight ) const { uWidth = 0; uHeight = 0; }
+
+        // Computes a single group, the scratch memory is owned by the calling thread
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const = 0;
+
+        int KernelRadius() const { return m_iKernelRadius; }
+        int KernelDiameter() const { return m_iKernelRadius * 2 + 1; }
+        int StepSize() const { return m_iStepSize; }
+        int OutputWidth() const { return (int)m_fOutputSize[0]; }
+        int OutputHeight() const { return (int)m_fOutputSize[1]; }
+
+    protected:
+
+        const Surface*  m_pInputs[MAX_INPUTS];
+        int             m_iNumInputs;
+        Surface*        m_pOutput;
+        float           m_fOutputSize[4];   // ( [0] = Width, [1] = Height, [2] = Inv Width, [3] = Inv Height )
+        int             m_iKernelRadius;
+        int             m_iStepSize;        // 2 when using the approximate filter
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,323 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: FilterKernel.h
+//
+// Defines the CPU filter kernel for a separable filter. It calls the hooks defined by the
+// user supplied filter class, such as GaussianFilter.h, in the same order as the macros
+// are called by FilterKernel.hlsl:
+//
+//  SampleFromInput( Sampler, fX, fY, RAWDataItem )
+//  WriteToLDS( RAWDataItem, LDSItem ) / ReadFromLDS( LDSItem, RAWDataItem )
+//  KernelCenter( KernelData[], iNumPixels, Output, RAWDataItem[] )
+//  KernelIteration( iIteration, KernelData[], iNumPixels, Output, RAWDataItem[] )
+//  KernelFinalWeight( KernelData[], iNumPixels, Output )
+//  KernelOutput( iCenterX, iCenterY, iIncX, iIncY, iNumPixels, Output, KernelData[] )
+//
+// Filters that set LERP_LDS_READS, the equivalent of defining KERNEL_LERP_SAMPLES, also
+// supply KernelSampleOffset( iIteration ) and LerpSamples( RAWDataItem, RAWDataItem,
+// fOffset, RAWDataItem ).
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Samples from inputs defined by the SampleFromInput hook
+    //--------------------------------------------------------------------------------------
+    template< class Filter >
+    inline void Sample( const Filter& F, int iX, int iY, float fOffsetX, float fOffsetY, typename Filter::RAWDataItem& RDI )
+    {
+        float fX = (float)iX;
+        float fY = (float)iY;
+
+        if( F.StepSize() == 2 )
+        {
+            fX += fOffsetX;
+            fY += fOffsetY;
+        }
+
+        F.SampleFromInput( SAMPLER_TYPE_LINEAR_CLAMP, fX, fY, RDI );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Offset of the samples stored in the LDS, mirroring LDS_SAMPLE_OFFSET. With the
+    // approximate filter, filters that set LERP_LDS_READS store the texels themselves and
+    // blend each pair as they read it, the others the samples half way between texels.
+    //--------------------------------------------------------------------------------------
+    template< class Filter >
+    inline float LDSSampleOffset()
+    {
+        return Filter::LERP_LDS_READS ? 0.0f : 0.5f;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Caches LDS reads in registers: trickles values down and loads the new value(s)
+    //--------------------------------------------------------------------------------------
+    template< class Filter >
+    inline void CacheLDSReads( const Filter& F, int iIteration, const typename Filter::LDSItem* pLDSLine, int iPixelOffset, typename Filter::RAWDataItem* RDI )
+    {
+        const int iStepSize = F.StepSize();
+        int iPixel;
+
+        // Trickle LDS values down within the registers
+        for( iPixel = 0; iPixel < PIXELS_PER_THREAD - iStepSize; ++iPixel )
+        {
+            RDI[iPixel] = RDI[iPixel + iStepSize];
+        }
+
+        // Load new LDS value(s)
+        for( iPixel = 0; iPixel < iStepSize; ++iPixel )
+        {
+            F.ReadFromLDS( pLDSLine[iPixelOffset + iIteration + iPixel], RDI[PIXELS_PER_THREAD - iStepSize + iPixel] );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // As CacheLDSReads, for the PIXELS_PER_THREAD + 1 texels blended by an iteration
+    //--------------------------------------------------------------------------------------
+    template< class Filter >
+    inline void CacheLDSTexels( const Filter& F, int iIteration, const typename Filter::LDSItem* pLDSLine, int iPixelOffset, typename Filter::RAWDataItem* RDITexel )
+    {
+        const int iStepSize = F.StepSize();
+        int iPixel;
+
+        // Trickle LDS values down within the registers
+        for( iPixel = 0; iPixel < PIXELS_PER_THREAD + 1 - iStepSize; ++iPixel )
+        {
+            RDITexel[iPixel] = RDITexel[iPixel + iStepSize];
+        }
+
+        // Load new LDS value(s)
+        for( iPixel = 0; iPixel < iStepSize; ++iPixel )
+        {
+            F.ReadFromLDS( pLDSLine[iPixelOffset + iIteration + iPixel], RDITexel[PIXELS_PER_THREAD + 1 - iStepSize + iPixel] );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Blends the pairs of texels of an iteration by its offset
+    //--------------------------------------------------------------------------------------
+    template< class Filter >
+    inline void LerpLDSTexels( const Filter& F, int iIteration, const typename Filter::RAWDataItem* RDITexel, typename Filter::RAWDataItem* RDI )
+    {
+        const float fOffset = F.KernelSampleOffset( iIteration );
+
+        for( int iPixel = 0; iPixel < PIXELS_PER_THREAD; ++iPixel )
+        {
+            F.LerpSamples( RDITexel[iPixel], RDITexel[iPixel + 1], fOffset, RDI[iPixel] );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Selects the kernel iterations at compile time, as LERP_LDS_READS does in the HLSL
+    //--------------------------------------------------------------------------------------
+    template< bool bLerpLDSReads > struct LerpLDSReads {};
+
+
+    //--------------------------------------------------------------------------------------
+    // The iterations of both halves of the kernel, reading the LDS as is
+    //--------------------------------------------------------------------------------------
+    template< class Filter >
+    void ComputeKernelIterations( const Filter& F, const typename Filter::LDSItem* pLDSLine, int iPixelOffset, typename Filter::KernelData* KD, typename Filter::Output& O, LerpLDSReads< false > )
+    {
+        typename Filter::RAWDataItem RDI[PIXELS_PER_THREAD];
+        const int iKernelRadius = F.KernelRadius();
+        const int iKernelDiameter = F.KernelDiameter();
+        const int iStepSize = F.StepSize();
+        int iPixel, iIteration;
+
+        // Prime the registers for the first half of the kernel
+        for( iPixel = 0; iPixel < PIXELS_PER_THREAD; ++iPixel )
+        {
+            F.ReadFromLDS( pLDSLine[iPixelOffset + iPixel], RDI[iPixel] );
+        }
+
+        // Increment the LDS offset by PIXELS_PER_THREAD
+        iPixelOffset += PIXELS_PER_THREAD;
+
+        // First half of the kernel
+        for( iIteration = 0; iIteration < iKernelRadius; iIteration += iStepSize )
+        {
+            // Hook defines what happens for each kernel iteration
+            F.KernelIteration( iIteration, KD, PIXELS_PER_THREAD, O, RDI );
+
+            // Cache LDS reads in registers
+            CacheLDSReads( F, iIteration, pLDSLine, iPixelOffset, RDI );
+        }
+
+        // Prime the registers for the second half of the kernel
+        for( iPixel = 0; iPixel < PIXELS_PER_THREAD; ++iPixel )
+        {
+            F.ReadFromLDS( pLDSLine[iPixelOffset - PIXELS_PER_THREAD + iIteration + 1 + iPixel], RDI[iPixel] );
+        }
+
+        // Second half of the kernel
+        for( iIteration = iKernelRadius + 1; iIteration < iKernelDiameter; iIteration += iStepSize )
+        {
+            // Hook defines what happens for each kernel iteration
+            F.KernelIteration( iIteration, KD, PIXELS_PER_THREAD, O, RDI );
+
+            // Cache LDS reads in registers
+            CacheLDSReads( F, iIteration, pLDSLine, iPixelOffset, RDI );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // The iterations of both halves of the kernel, blending the pairs of texels of the
+    // approximate filter from the LDS
+    //--------------------------------------------------------------------------------------
+    template< class Filter >
+    void ComputeKernelIterations( const Filter& F, const typename Filter::LDSItem* pLDSLine, int iPixelOffset, typename Filter::KernelData* KD, typename Filter::Output& O, LerpLDSReads< true > )
+    {
+        if( F.StepSize() != 2 )
+        {
+            ComputeKernelIterations( F, pLDSLine, iPixelOffset, KD, O, LerpLDSReads< false >() );
+            return;
+        }
+
+        typename Filter::RAWDataItem RDITexel[PIXELS_PER_THREAD + 1];
+        typename Filter::RAWDataItem RDI[PIXELS_PER_THREAD];
+        const int iKernelRadius = F.KernelRadius();
+        const int iKernelDiameter = F.KernelDiameter();
+        const int iStepSize = F.StepSize();
+        int iPixel, iIteration;
+
+        // Prime the registers for the first half of the kernel
+        for( iPixel = 0; iPixel < PIXELS_PER_THREAD + 1; ++iPixel )
+        {
+            F.ReadFromLDS( pLDSLine[iPixelOffset + iPixel], RDITexel[iPixel] );
+        }
+
+        // Increment the LDS offset by PIXELS_PER_THREAD + 1
+        iPixelOffset += PIXELS_PER_THREAD + 1;
+
+        // First half of the kernel
+        for( iIteration = 0; iIteration < iKernelRadius; iIteration += iStepSize )
+        {
+            // Blend the pairs of texels, then the hook defines what happens for each kernel iteration
+            LerpLDSTexels( F, iIteration, RDITexel, RDI );
+            F.KernelIteration( iIteration, KD, PIXELS_PER_THREAD, O, RDI );
+
+            // Cache LDS reads in registers
+            CacheLDSTexels( F, iIteration, pLDSLine, iPixelOffset, RDITexel );
+        }
+
+        // Prime the registers for the second half of the kernel
+        for( iPixel = 0; iPixel < PIXELS_PER_THREAD + 1; ++iPixel )
+        {
+            F.ReadFromLDS( pLDSLine[iPixelOffset - ( PIXELS_PER_THREAD + 1 ) + iIteration + 1 + iPixel], RDITexel[iPixel] );
+        }
+
+        // Second half of the kernel
+        for( iIteration = iKernelRadius + 1; iIteration < iKernelDiameter; iIteration += iStepSize )
+        {
+            // Blend the pairs of texels, then the hook defines what happens for each kernel iteration
+            LerpLDSTexels( F, iIteration, RDITexel, RDI );
+            F.KernelIteration( iIteration, KD, PIXELS_PER_THREAD, O, RDI );
+
+            // Cache LDS reads in registers
+            CacheLDSTexels( F, iIteration, pLDSLine, iPixelOffset, RDITexel );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Defines the filter kernel logic. User supplies hooks for custom filter.
+    // Computes PIXELS_PER_THREAD pixels starting at iCenter, of which iNumPixels are on screen.
+    //--------------------------------------------------------------------------------------
+    template< class Filter >
+    void ComputeFilterKernel( const Filter& F, const typename Filter::LDSItem* pLDSLine, int iPixelOffset, int iCenterX, int iCenterY, int iIncX, int iIncY, int iNumPixels )
+    {
+        typename Filter::Output O;
+        typename Filter::KernelData KD[PIXELS_PER_THREAD];
+        typename Filter::RAWDataItem RDI[PIXELS_PER_THREAD];
+        const int iKernelRadius = F.KernelRadius();
+        int iPixel;
+
+        if( F.StepSize() == 2 && !Filter::LERP_LDS_READS )
+        {
+            // Read the kernel center values in directly from the input surface(s), as the LDS
+            // values are pre-filtered, and therefore do not represent the kernel center
+            for( iPixel = 0; iPixel < PIXELS_PER_THREAD; ++iPixel )
+            {
+                F.SampleFromInput( SAMPLER_TYPE_POINT, (float)( iCenterX + iPixel * iIncX ), (float)( iCenterY + iPixel * iIncY ), RDI[iPixel] );
+            }
+        }
+        else
+        {
+            // Read the kernel center values in from the LDS
+            for( iPixel = 0; iPixel < PIXELS_PER_THREAD; ++iPixel )
+            {
+                F.ReadFromLDS( pLDSLine[iPixelOffset + iKernelRadius + iPixel], RDI[iPixel] );
+            }
+        }
+
+        // Hook defines what happens at the kernel center
+        F.KernelCenter( KD, PIXELS_PER_THREAD, O, RDI );
+
+        // Both halves of the kernel
+        ComputeKernelIterations( F, pLDSLine, iPixelOffset, KD, O, LerpLDSReads< Filter::LERP_LDS_READS >() );
+
+        // Hooks define final weighting and output
+        F.KernelFinalWeight( KD, PIXELS_PER_THREAD, O );
+        F.KernelOutput( iCenterX, iCenterY, iIncX, iIncY, iNumPixels, O, KD );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Number of LDS items sampled per line of a group
+    //--------------------------------------------------------------------------------------
+    inline int RunSizePlusKernel( int iKernelRadius )
+    {
+        return RUN_SIZE + iKernelRadius * 2;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Stride of an LDS line, in LDS items. The final CacheLDSReads or CacheLDSTexels of the
+    // last thread reads up to two items past the run, which on the GPU is harmless, so pad
+    // the line for it.
+    //--------------------------------------------------------------------------------------
+    inline int LDSLineStride( int iKernelRadius )
+    {
+        return RunSizePlusKernel( iKernelRadius ) + PIXELS_PER_THREAD;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,352 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: GaussianFilter.h
+//
+// Implements a classic Gaussian filter for the CPU kernel, mirroring GaussianFilter.hlsl.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+
+
+namespace CPUFilter
+{
+    // Defines
+    static const float PI = 3.1415927f;
+
+
+    //--------------------------------------------------------------------------------------
+    // Get a Gaussian weight
+    //--------------------------------------------------------------------------------------
+    inline float GaussianWeight( float fX, float fDeviation )
+    {
+        float fWeight = 1.0f / sqrtf( 2.0f * PI * fDeviation * fDeviation );
+        fWeight *= expf( -( fX * fX ) / ( 2.0f * fDeviation * fDeviation ) );
+
+        return fWeight;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Smallest kernel radius for which the weight the truncated taps would have had in the
+    // untruncated kernel is at most fTolerance of the total. Wide kernels have long tails
+    // of near zero weights, so this is often well under the 2 deviations of
+    // GAUSSIAN_DEVIATION. Clamped to MAX_KERNEL_RADIUS.
+    //--------------------------------------------------------------------------------------
+    inline int ComputeGaussianRadius( float fDeviation, float fTolerance )
+    {
+        assert( fDeviation > 0.0f && fTolerance > 0.0f );
+
+        // The normalization of GaussianWeight cancels out, and past 10 deviations the tail is
+        // far below any float tolerance
+        const double dScale = -1.0 / ( 2.0 * (double)fDeviation * (double)fDeviation );
+        const int iExtent = (int)ceil( 10.0 * (double)fDeviation ) + 1;
+
+        double dTotal = 1.0;
+        for( int iX = 1; iX <= iExtent; ++iX )
+        {
+            dTotal += 2.0 * exp( dScale * iX * iX );
+        }
+
+        // Grow the kernel until the weight left outside is under the tolerance
+        int iRadius = 1;
+        double dOutside = dTotal - 1.0 - 2.0 * exp( dScale );
+        while( dOutside > (double)fTolerance * dTotal && iRadius < MAX_KERNEL_RADIUS )
+        {
+            ++iRadius;
+            dOutside -= 2.0 * exp( dScale * iRadius * iRadius );
+        }
+
+        return iRadius;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Whether the radius ComputeGaussianRadius needs for a deviation is past the largest
+    // shader permutation, KERNEL_RADIUS_TYPE_32, so that only a pyramid (GaussianPyramid,
+    // or PyramidFilter on the GPU) holds it within the tolerance. 0 is the default
+    // deviation of each radius, so never needs one.
+    //--------------------------------------------------------------------------------------
+    inline bool RequiresPyramid( float fDeviation, float fTolerance )
+    {
+        return fDeviation > 0.0f && ComputeGaussianRadius( fDeviation, fTolerance ) > ( KERNEL_RADIUS_TYPE_32 + 1 ) * 2;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Weights of the iterations of a Gaussian kernel, indexed as in the HLSL. The approximate
+    // filter merges the texels of an iteration and the next into one bilinear sample, so
+    // its weight is the sum of both, w1 + w2, and the sample is taken at w2 / ( w1 + w2 )
+    // past the iteration's texel, where the blend gives each texel its own weight. The
+    // center, the full filter and the iterations the approximate filter steps over have
+    // offsets of 0. pOffsets can be NULL.
+    //--------------------------------------------------------------------------------------
+    inline void ComputeGaussianTaps( int iKernelRadius, int iStepSize, float fDeviation, float* pWeights, float* pOffsets )
+    {
+        assert( 1 == iStepSize || ( 2 == iStepSize && ( iKernelRadius % 2 ) == 0 ) );
+
+        for( int iIteration = 0; iIteration < iKernelRadius * 2 + 1; ++iIteration )
+        {
+            float fWeight = GaussianWeight( (float)( iIteration - iKernelRadius ), fDeviation );
+            float fOffset = 0.0f;
+
+            if( 2 == iStepSize && iIteration != iKernelRadius )
+            {
+                // The first half starts on the kernel's edge, the second half just past the center
+                const int iFirst = ( iIteration < iKernelRadius ) ? 0 : iKernelRadius + 1;
+                if( ( iIteration - iFirst ) % 2 == 0 )
+                {
+                    const float fNextWeight = GaussianWeight( (float)( iIteration + 1 - iKernelRadius ), fDeviation );
+                    fWeight += fNextWeight;
+                    fOffset = ( fWeight > 0.0f ) ? fNextWeight / fWeight : 0.5f;
+                }
+                else
+                {
+                    fWeight = 0.0f;
+                }
+            }
+
+            pWeights[iIteration] = fWeight;
+            if( pOffsets )
+            {
+                pOffsets[iIteration] = fOffset;
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Mirrors PSFilterX and PSFilterY of the approximate Gaussian filter, taking one bilinear
+    // sample per merged pair of texels at the offsets from ComputeGaussianTaps. Up to
+    // rounding this matches the full filter, so it serves to validate the merged taps.
+    // A deviation of 0 is half the kernel radius.
+    //--------------------------------------------------------------------------------------
+    inline void GaussianFilterLinear( const Surface& Input, Surface& Output, PASS_TYPE Pass, int iKernelRadius, float fDeviation )
+    {
+        assert( Input.m_uWidth == Output.m_uWidth && Input.m_uHeight == Output.m_uHeight );
+        assert( iKernelRadius > 0 && iKernelRadius <= MAX_KERNEL_RADIUS && ( iKernelRadius % 2 ) == 0 );
+
+        float fWeights[MAX_KERNEL_RADIUS * 2 + 1];
+        float fOffsets[MAX_KERNEL_RADIUS * 2 + 1];
+        fDeviation = ( fDeviation > 0.0f ) ? fDeviation : (float)iKernelRadius * 0.5f;
+        ComputeGaussianTaps( iKernelRadius, 2, fDeviation, fWeights, fOffsets );
+
+        const float fIncX = ( PASS_TYPE_HORIZONTAL == Pass ) ? 1.0f : 0.0f;
+        const float fIncY = 1.0f - fIncX;
+
+        for( int iY = 0; iY < (int)Output.m_uHeight; ++iY )
+        {
+            Float4* pOutputRow = Output.Row( iY );
+            for( int iX = 0; iX < (int)Output.m_uWidth; ++iX )
+            {
+                float fWeightSum = fWeights[iKernelRadius];
+                Float4 f4Color = Input.Load( iX, iY ) * fWeightSum;
+
+                for( int iIteration = 0; iIteration < iKernelRadius * 2 + 1; ++iIteration )
+                {
+                    // The iterations stepped over have no weight
+                    if( iIteration == iKernelRadius || fWeights[iIteration] == 0.0f )
+                    {
+                        continue;
+                    }
+
+                    const float fTap = (float)( iIteration - iKernelRadius ) + fOffsets[iIteration];
+                    f4Color = f4Color + Input.SampleLinear( (float)iX + fTap * fIncX, (float)iY + fTap * fIncY ) * fWeights[iIteration];
+                    fWeightSum += fWeights[iIteration];
+                }
+
+                pOutputRow[iX] = f4Color * ( 1.0f / fWeightSum );
+                pOutputRow[iX].w = 1.0f;
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Gaussian filter class, g_txInput is input 0
+    //--------------------------------------------------------------------------------------
+    class GaussianFilter : public FilterPass
+    {
+    public:
+
+        // Uncompressed data as sampled from inputs
+        struct RAWDataItem
+        {
+            Float3 f3Color;
+        };
+
+        // Data stored in the LDS
+        typedef RAWDataItem LDSItem;
+
+        // Data stored for a kernel
+        struct KernelData
+        {
+            float fWeight;
+            float fWeightSum;
+        };
+
+        // CS output structure
+        struct Output
+        {
+            Float4 f4Color[PIXELS_PER_THREAD];
+        };
+
+        GaussianFilter() : m_fDeviation( 0.0f )
+        {
+            SetKernel( m_iKernelRadius, false );
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Overrides GAUSSIAN_DEVIATION, or 0 for half the kernel radius. Use
+        // ComputeGaussianRadius to find the radius for a deviation.
+        //--------------------------------------------------------------------------------------
+        void SetDeviation( float fDeviation )
+        {
+            assert( fDeviation >= 0.0f );
+
+            m_fDeviation = fDeviation;
+            SetKernel( m_iKernelRadius, 2 == m_iStepSize );
+        }
+
+        float GetDeviation() const { return ( m_fDeviation > 0.0f ) ? m_fDeviation : (float)m_iKernelRadius * 0.5f; }
+
+
+        //--------------------------------------------------------------------------------------
+        // The weights get computed once per kernel, as the HLSL compiles them to constants
+        //--------------------------------------------------------------------------------------
+        virtual void SetKernel( int iKernelRadius, bool bApproximate )
+        {
+            FilterPass::SetKernel( iKernelRadius, bApproximate );
+
+            // The approximate filter blends the pairs of texels in the LDS by the offsets, as
+            // in the CS, and weights them by the merged weights
+            const float fDeviation = GetDeviation();
+            m_fCenterWeight = GaussianWeight( 0.0f, fDeviation );
+            ComputeGaussianTaps( m_iKernelRadius, m_iStepSize, fDeviation, m_fWeights, m_fOffsets );
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Offset of the merged taps, and the blend of a pair of texels read from the LDS
+        //--------------------------------------------------------------------------------------
+        static const bool LERP_LDS_READS = true;
+
+        float KernelSampleOffset( int iIteration ) const { return m_fOffsets[iIteration]; }
+
+        void LerpSamples( const RAWDataItem& RDI0, const RAWDataItem& RDI1, float fOffset, RAWDataItem& RDI ) const
+        {
+            RDI.f3Color = RDI0.f3Color * ( 1.0f - fOffset ) + RDI1.f3Color * fOffset;
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // LDS access
+        //--------------------------------------------------------------------------------------
+        void WriteToLDS( const RAWDataItem& RDI, LDSItem& LDSValue ) const { LDSValue = RDI; }
+        void ReadFromLDS( const LDSItem& LDSValue, RAWDataItem& RDI ) const { RDI = LDSValue; }
+
+
+        //--------------------------------------------------------------------------------------
+        // Sample from chosen input(s)
+        //--------------------------------------------------------------------------------------
+        void SampleFromInput( SAMPLER_TYPE Sampler, float fX, float fY, RAWDataItem& RDI ) const
+        {
+            RDI.f3Color = XYZ( m_pInputs[0]->Sample( Sampler, fX, fY ) );
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Compute what happens at the kernels center
+        //--------------------------------------------------------------------------------------
+        void KernelCenter( KernelData* KD, int iNumPixels, Output& O, const RAWDataItem* RDI ) const
+        {
+            for( int iPixel = 0; iPixel < iNumPixels; ++iPixel )
+            {
+                KD[iPixel].fWeight = m_fCenterWeight;
+                KD[iPixel].fWeightSum = KD[iPixel].fWeight;
+                O.f4Color[iPixel] = MakeFloat4( RDI[iPixel].f3Color * KD[iPixel].fWeight, 0.0f );
+            }
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Compute what happens for each iteration of the kernel
+        //--------------------------------------------------------------------------------------
+        void KernelIteration( int iIteration, KernelData* KD, int iNumPixels, Output& O, const RAWDataItem* RDI ) const
+        {
+            for( int iPixel = 0; iPixel < iNumPixels; ++iPixel )
+            {
+                KD[iPixel].fWeight = m_fWeights[iIteration];
+                KD[iPixel].fWeightSum += KD[iPixel].fWeight;
+                O.f4Color[iPixel].x += RDI[iPixel].f3Color.x * KD[iPixel].fWeight;
+                O.f4Color[iPixel].y += RDI[iPixel].f3Color.y * KD[iPixel].fWeight;
+                O.f4Color[iPixel].z += RDI[iPixel].f3Color.z * KD[iPixel].fWeight;
+            }
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Perform final weighting operation
+        //--------------------------------------------------------------------------------------
+        void KernelFinalWeight( KernelData* KD, int iNumPixels, Output& O ) const
+        {
+            for( int iPixel = 0; iPixel < iNumPixels; ++iPixel )
+            {
+                float fInvWeightSum = 1.0f / KD[iPixel].fWeightSum;
+                O.f4Color[iPixel].x *= fInvWeightSum;
+                O.f4Color[iPixel].y *= fInvWeightSum;
+                O.f4Color[iPixel].z *= fInvWeightSum;
+                O.f4Color[iPixel].w = 1.0f;
+            }
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Output to chosen surface
+        //--------------------------------------------------------------------------------------
+        void KernelOutput( int iCenterX, int iCenterY, int iIncX, int iIncY, int iNumPixels, const Output& O, const KernelData* /*KD*/ ) const
+        {
+            for( int iPixel = 0; iPixel < iNumPixels; ++iPixel )
+            {
+                m_pOutput->Row( iCenterY + iPixel * iIncY )[iCenterX + iPixel * iIncX] = O.f4Color[iPixel];
+            }
+        }
+
+    private:
+
+        float   m_fDeviation;
+        float   m_fCenterWeight;
+        float   m_fWeights[MAX_KERNEL_RADIUS * 2 + 1];
+        float   m_fOffsets[MAX_KERNEL_RADIUS * 2 + 1];
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,248 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: GaussianFilterFixedPoint.cpp
+//
+// Implements the fixed point Gaussian filter of 8 bit unorm surfaces.
+//--------------------------------------------------------------------------------------
+
+
+#include "GaussianFilterFixedPoint.h"
+
+
+namespace CPUFilter
+{
+    // The weights of a pair of taps, as loaded by pmaddwd
+    static inline int PackWeights( int iFirst, int iSecond )
+    {
+        return (int)( (unsigned int)iFirst | ( (unsigned int)iSecond << 16 ) );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    GaussianFilterFixedPoint::GaussianFilterFixedPoint() :
+    m_pUNorm8Input( NULL ),
+    m_pUNorm8Output( NULL ),
+    m_iRequestedStripWidth( 0 ),
+    m_iRequestedBandHeight( 0 )
+    {
+        SetKernel( m_iKernelRadius, false );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Rounds the weights to FIXED_POINT_WEIGHT_BITS fractional bits. The rounding error is
+    // added to the center weight, so the weights still sum to exactly 1 and flat areas keep
+    // their values.
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterFixedPoint::SetKernel( int iKernelRadius, bool bApproximate )
+    {
+        GaussianFilterSIMD::SetKernel( iKernelRadius, bApproximate );
+
+        const int iOne = 1 << FIXED_POINT_WEIGHT_BITS;
+        int iWeights[MAX_KERNEL_RADIUS * 2 + 1] = { 0 };
+        int iWeightSum = 0;
+
+        for( int iTap = 0; iTap < KernelDiameter(); ++iTap )
+        {
+            iWeights[iTap] = (int)( m_fWeights[iTap] * (float)iOne + 0.5f );
+            iWeightSum += iWeights[iTap];
+        }
+
+        iWeights[m_iKernelRadius] += iOne - iWeightSum;
+
+        // Taps are paired from the first, and the last tap is paired with the one before it,
+        // with a weight of 0 for the other
+        for( int iPair = 0; iPair < m_iKernelRadius; ++iPair )
+        {
+            m_iWeightPairs[iPair] = PackWeights( iWeights[iPair * 2], iWeights[iPair * 2 + 1] );
+        }
+        m_iWeightPairs[m_iKernelRadius] = PackWeights( 0, iWeights[KernelDiameter() - 1] );
+
+        SetStripWidth( m_iRequestedStripWidth );
+        SetBandHeight( m_iRequestedBandHeight );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Overrides the strip width, or 0 to size them from the caches of the CPU
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterFixedPoint::SetStripWidth( int iStripWidth )
+    {
+        assert( iStripWidth >= 0 );
+
+        // The ring buffer holds the kernel lines paired up, plus the input line widened and
+        // paired up, the last two filtered lines and the output row
+        const unsigned int uPairTexelSize = 4 * sizeof( int );
+        const unsigned int uLineTexelSize = 4 * sizeof( short );
+
+        m_iRequestedStripWidth = iStripWidth;
+        m_iStripWidth = ( 0 == iStripWidth ) ? ComputeStripWidth( ( KernelDiameter() + 1 ) * uPairTexelSize + 3 * uLineTexelSize + 4 ) : iStripWidth;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Overrides the band height, or 0 to size them from the kernel diameter
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterFixedPoint::SetBandHeight( int iBandHeight )
+    {
+        assert( iBandHeight >= 0 );
+
+        // As GaussianFilterFused, the bands are kept long compared to the kernel
+        const int iAutoBandHeight = 16 * KernelDiameter();
+
+        m_iRequestedBandHeight = iBandHeight;
+        m_iBandHeight = ( 0 != iBandHeight ) ? iBandHeight : ( ( iAutoBandHeight > RUN_SIZE ) ? iAutoBandHeight : RUN_SIZE );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sets the surfaces filtered
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterFixedPoint::SetUNorm8Surfaces( const SurfaceUNorm8* pInput, SurfaceUNorm8* pOutput )
+    {
+        m_pUNorm8Input = pInput;
+        m_pUNorm8Output = pOutput;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // One group per band of a strip
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterFixedPoint::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = DivRoundUp( (unsigned int)OutputWidth(), (unsigned int)m_iStripWidth );
+        uY = DivRoundUp( (unsigned int)OutputHeight(), (unsigned int)m_iBandHeight );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Filters a band of a strip. Each input line is widened to 16 bits with its apron, paired
+    // up with itself a texel to the right, and filtered horizontally. Each filtered line is
+    // paired up with the one before it into a ring buffer, and an output line is filtered
+    // vertically from the ring buffer as soon as the lines under its kernel are there.
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterFixedPoint::ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const
+    {
+        assert( NULL != m_pUNorm8Input && NULL != m_pUNorm8Output );
+        assert( m_pUNorm8Output->m_uWidth >= (unsigned int)OutputWidth() && m_pUNorm8Output->m_uHeight >= (unsigned int)OutputHeight() );
+
+        const SurfaceUNorm8& Input = *m_pUNorm8Input;
+        const int iKernelRadius = KernelRadius();
+        const int iKernelDiameter = KernelDiameter();
+        const int iNumPairs = iKernelRadius + 1;
+        const int iLastInputLine = (int)Input.m_uHeight - 1;
+        const int iInputWidth = (int)Input.m_uWidth;
+
+        const int iGroupCoordX = (int)uGroupX * m_iStripWidth;
+        const int iStripWidth = ( OutputWidth() - iGroupCoordX < m_iStripWidth ) ? ( OutputWidth() - iGroupCoordX ) : m_iStripWidth;
+        const int iFirstLine = (int)uGroupY * m_iBandHeight;
+        const int iEndLine = ( iFirstLine + m_iBandHeight < OutputHeight() ) ? ( iFirstLine + m_iBandHeight ) : OutputHeight();
+        const int iCount = iStripWidth * 4;
+
+        // Texels of the apron that are inside the input, the rest are clamped to its edges
+        const int iFirstTexel = iGroupCoordX - iKernelRadius;
+        const int iEndTexel = iGroupCoordX + iStripWidth + iKernelRadius;
+        const int iFirstInside = ( iFirstTexel > 0 ) ? iFirstTexel : 0;
+        const int iEndInside = ( iEndTexel < iInputWidth ) ? iEndTexel : iInputWidth;
+        const int iApronCount = ( iEndTexel - iFirstTexel ) * 4;
+
+        // The ring buffer, followed by the paired and widened input line and the last two
+        // filtered lines, each kept cache line aligned
+        const int iRingPitch = (int)( DivRoundUp( (unsigned int)( sizeof( int ) * iCount ), MEMORY_ALIGNMENT ) * MEMORY_ALIGNMENT / sizeof( int ) );
+        const size_t uRingSize = sizeof( int ) * iRingPitch * iKernelDiameter;
+        const size_t uPairedSize = DivRoundUp( (unsigned int)( sizeof( int ) * iApronCount ), MEMORY_ALIGNMENT ) * MEMORY_ALIGNMENT;
+        const size_t uWideSize = DivRoundUp( (unsigned int)( sizeof( short ) * iApronCount ), MEMORY_ALIGNMENT ) * MEMORY_ALIGNMENT;
+        const size_t uLineSize = DivRoundUp( (unsigned int)( sizeof( short ) * iCount ), MEMORY_ALIGNMENT ) * MEMORY_ALIGNMENT;
+        int* pRing = (int*)LDS.Reserve( uRingSize + uPairedSize + uWideSize + 2 * uLineSize );
+        int* pPaired = (int*)( (char*)pRing + uRingSize );
+        short* pWide = (short*)( (char*)pPaired + uPairedSize );
+        short* pLines[2] = { (short*)( (char*)pWide + uWideSize ), (short*)( (char*)pWide + uWideSize + uLineSize ) };
+
+        // Pair n of the horizontal kernel is taps 2n and 2n + 1, which is the paired line 2n
+        // texels on, and the last pair is the texel before the last tap
+        const int* pRowPairs[MAX_KERNEL_RADIUS + 1];
+        for( int iPair = 0; iPair < iKernelRadius; ++iPair )
+        {
+            pRowPairs[iPair] = pPaired + iPair * 2 * 4;
+        }
+        pRowPairs[iKernelRadius] = pPaired + ( iKernelDiameter - 2 ) * 4;
+
+        const int* pWindow[MAX_KERNEL_RADIUS + 1];
+
+        for( int iLine = iFirstLine - iKernelRadius; iLine < iEndLine + iKernelRadius; ++iLine )
+        {
+            // Lines above and below the input are clamped, as the vertical pass clamps its reads
+            const unsigned char* pInputRow = Input.Row( Clamp( iLine, 0, iLastInputLine ) );
+            short* pInside = pWide + ( iFirstInside - iFirstTexel ) * 4;
+            m_pKernels->m_pfnWidenRowUNorm8( pInputRow + iFirstInside * 4, ( iEndInside - iFirstInside ) * 4, pInside );
+
+            for( int iTexel = iFirstTexel; iTexel < iFirstInside; ++iTexel )
+            {
+                memcpy( pWide + ( iTexel - iFirstTexel ) * 4, pInside, 4 * sizeof( short ) );
+            }
+
+            for( int iTexel = iEndInside; iTexel < iEndTexel; ++iTexel )
+            {
+                memcpy( pWide + ( iTexel - iFirstTexel ) * 4, pWide + ( iEndInside - 1 - iFirstTexel ) * 4, 4 * sizeof( short ) );
+            }
+
+            // The last texel has nothing to pair with, and is never read
+            m_pKernels->m_pfnPairRows16( pWide, pWide + 4, iApronCount - 4, pPaired );
+
+            const int iBandLine = iLine - iFirstLine + iKernelRadius;
+            short* pLine = pLines[iBandLine & 1];
+            m_pKernels->m_pfnGaussianFixedPointRow( m_iWeightPairs, iNumPairs, pRowPairs, iCount, pLine );
+
+            if( 0 == iBandLine )
+            {
+                continue;
+            }
+
+            // The ring buffer slot of a line holds it paired with the line after it
+            m_pKernels->m_pfnPairRows16( pLines[( iBandLine - 1 ) & 1], pLine, iCount, pRing + ( ( iBandLine - 1 ) % iKernelDiameter ) * iRingPitch );
+
+            // The kernel of this output line ends on the line just filtered
+            const int iY = iLine - iKernelRadius;
+            if( iY >= iFirstLine )
+            {
+                const int iFirstBandLine = iY - iFirstLine;
+                for( int iPair = 0; iPair < iKernelRadius; ++iPair )
+                {
+                    pWindow[iPair] = pRing + ( ( iFirstBandLine + iPair * 2 ) % iKernelDiameter ) * iRingPitch;
+                }
+                pWindow[iKernelRadius] = pRing + ( ( iFirstBandLine + iKernelDiameter - 2 ) % iKernelDiameter ) * iRingPitch;
+
+                m_pKernels->m_pfnGaussianFixedPointColumn( m_iWeightPairs, iNumPairs, pWindow, iCount, m_pUNorm8Output->Row( iY ) + iGroupCoordX * 4 );
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,91 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: GaussianFilterFixedPoint.h
+//
+// Gaussian filter of 8 bit unorm surfaces in fixed point, with the weights of
+// GaussianFilterSIMD quantized to 16 bits. Channels stay integers from input to output,
+// held in 16 bit lanes for pmaddwd, so a vector holds twice as many channels as the float
+// passes, and the lines between the passes are 16 bits rather than floats.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "GaussianFilterSIMD.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Both passes fused, as GaussianFilterFused: each group walks down a band of a strip of
+    // columns, filtering the lines of its 8 bit input horizontally to FIXED_POINT_LINE_BITS
+    // fractional bits, and from a ring buffer of those lines vertically to its 8 bit output.
+    // Lines are stored paired up with their neighbors, so that the kernels weight two taps
+    // per pmaddwd without shuffling. Sums are 32 bits and rounded, so the output is within 1
+    // of the float passes, rounded to 8 bits. Alpha is filtered with the other channels, as
+    // BoxFilter does for 8 bit surfaces.
+    //--------------------------------------------------------------------------------------
+    class GaussianFilterFixedPoint : public GaussianFilterSIMD
+    {
+    public:
+
+        GaussianFilterFixedPoint();
+
+        // Quantizes the weights, and sizes the strips and bands
+        virtual void SetKernel( int iKernelRadius, bool bApproximate );
+
+        // Width of the strips in texels, or 0 to size them from the caches of the CPU
+        void SetStripWidth( int iStripWidth );
+        int StripWidth() const { return m_iStripWidth; }
+
+        // Height of the bands in lines, or 0 to size them from the kernel diameter
+        void SetBandHeight( int iBandHeight );
+        int BandHeight() const { return m_iBandHeight; }
+
+        // The surfaces filtered. The bound input and output are unused, so may be NULL.
+        void SetUNorm8Surfaces( const SurfaceUNorm8* pInput, SurfaceUNorm8* pOutput );
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void GetGroupSize( unsigned int& uWidth, unsigned int& uHeight ) const { uWidth = (unsigned int)m_iStripWidth; uHeight = (unsigned int)m_iBandHeight; }
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+
+    private:
+
+        const SurfaceUNorm8*    m_pUNorm8Input;
+        SurfaceUNorm8*          m_pUNorm8Output;
+        int                     m_iRequestedStripWidth;
+        int                     m_iStripWidth;
+        int                     m_iRequestedBandHeight;
+        int                     m_iBandHeight;
+
+        // Weights with FIXED_POINT_WEIGHT_BITS fractional bits, 2 taps per int
+        int                     m_iWeightPairs[MAX_KERNEL_RADIUS + 1];
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
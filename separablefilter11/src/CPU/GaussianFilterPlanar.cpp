@@ -0,0 +1,208 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: GaussianFilterPlanar.cpp
+//
+// Implements the Gaussian filter passes over planar surfaces.
+//--------------------------------------------------------------------------------------
+
+
+#include "GaussianFilterPlanar.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Sets the surfaces filtered
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterPlanarX::SetPlanarSurfaces( const PlanarSurface* pInput, PlanarSurface* pOutput )
+    {
+        assert( NULL != pInput && NULL != pOutput );
+        assert( pInput->m_iNumPlanes == pOutput->m_iNumPlanes );
+
+        m_pPlanarInput = pInput;
+        m_pPlanarOutput = pOutput;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Same dispatch as GaussianFilterX
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterPlanarX::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = DivRoundUp( (unsigned int)OutputWidth(), RUN_SIZE );
+        uY = DivRoundUp( (unsigned int)OutputHeight(), RUN_LINES );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Filters RUN_LINES lines of RUN_SIZE pixels of every plane
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterPlanarX::ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const
+    {
+        assert( NULL != m_pPlanarInput && NULL != m_pPlanarOutput );
+        assert( m_pPlanarOutput->m_uWidth >= (unsigned int)OutputWidth() && m_pPlanarOutput->m_uHeight >= (unsigned int)OutputHeight() );
+
+        const PlanarSurface& Input = *m_pPlanarInput;
+        const int iWidth = (int)Input.m_uWidth;
+        const int iGroupCoordX = (int)uGroupX * RUN_SIZE;
+        const int iNumPixels = ( OutputWidth() - iGroupCoordX < RUN_SIZE ) ? ( OutputWidth() - iGroupCoordX ) : RUN_SIZE;
+
+        // Groups whose apron is inside the input read the planes in place
+        const int iFirstX = iGroupCoordX - KernelRadius();
+        const int iApronSize = iNumPixels + 2 * KernelRadius();
+        const bool bInside = ( iFirstX >= 0 && iFirstX + iApronSize <= iWidth );
+        float* pApron = bInside ? NULL : (float*)LDS.Reserve( sizeof( float ) * iApronSize );
+
+        for( int iLine = 0; iLine < RUN_LINES; ++iLine )
+        {
+            const int iY = (int)uGroupY * RUN_LINES + iLine;
+            if( iY >= OutputHeight() )
+            {
+                break;
+            }
+
+            for( int iPlane = 0; iPlane < Input.m_iNumPlanes; ++iPlane )
+            {
+                const float* pSrc = Input.Row( iPlane, Clamp( iY, 0, (int)Input.m_uHeight - 1 ) );
+
+                if( !bInside )
+                {
+                    for( int i = 0; i < iApronSize; ++i )
+                    {
+                        pApron[i] = pSrc[Clamp( iFirstX + i, 0, iWidth - 1 )];
+                    }
+                }
+
+                m_pKernels->m_pfnGaussianRowPlane( m_fWeights, KernelDiameter(), bInside ? ( pSrc + iFirstX ) : pApron, iNumPixels,
+                    m_pPlanarOutput->Row( iPlane, iY ) + iGroupCoordX );
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    GaussianFilterPlanarY::GaussianFilterPlanarY() :
+    m_pPlanarInput( NULL ),
+    m_pPlanarOutput( NULL ),
+    m_iRequestedStripWidth( 0 ),
+    m_iStripWidth( ComputeStripWidth( ( KernelDiameter() + 1 ) * sizeof( float ) ) )
+    {
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // The strip width depends on the size of the window of rows
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterPlanarY::SetKernel( int iKernelRadius, bool bApproximate )
+    {
+        GaussianFilterSIMD::SetKernel( iKernelRadius, bApproximate );
+
+        SetStripWidth( m_iRequestedStripWidth );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Overrides the strip width, or 0 to size them from the caches of the CPU
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterPlanarY::SetStripWidth( int iStripWidth )
+    {
+        assert( iStripWidth >= 0 );
+
+        m_iRequestedStripWidth = iStripWidth;
+        // The window holds the kernel rows of one plane, plus the output row
+        m_iStripWidth = ( 0 == iStripWidth ) ? ComputeStripWidth( ( KernelDiameter() + 1 ) * sizeof( float ) ) : iStripWidth;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sets the surfaces filtered
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterPlanarY::SetPlanarSurfaces( const PlanarSurface* pInput, PlanarSurface* pOutput )
+    {
+        assert( NULL != pInput && NULL != pOutput );
+        assert( pInput->m_iNumPlanes == pOutput->m_iNumPlanes );
+
+        m_pPlanarInput = pInput;
+        m_pPlanarOutput = pOutput;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // One group per strip of RUN_SIZE lines, as GaussianFilterY
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterPlanarY::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = DivRoundUp( (unsigned int)OutputWidth(), (unsigned int)m_iStripWidth );
+        uY = DivRoundUp( (unsigned int)OutputHeight(), RUN_SIZE );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Filters RUN_SIZE lines of a strip of each plane in turn, sliding the window of rows
+    // down one row per output line
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterPlanarY::ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& /*LDS*/ ) const
+    {
+        assert( NULL != m_pPlanarInput && NULL != m_pPlanarOutput );
+        assert( m_pPlanarOutput->m_uWidth >= (unsigned int)OutputWidth() && m_pPlanarOutput->m_uHeight >= (unsigned int)OutputHeight() );
+
+        const PlanarSurface& Input = *m_pPlanarInput;
+        const int iKernelRadius = KernelRadius();
+        const int iLastInputLine = (int)Input.m_uHeight - 1;
+
+        const int iGroupCoordX = (int)uGroupX * m_iStripWidth;
+        const int iStripWidth = ( OutputWidth() - iGroupCoordX < m_iStripWidth ) ? ( OutputWidth() - iGroupCoordX ) : m_iStripWidth;
+        const int iFirstLine = (int)uGroupY * RUN_SIZE;
+        const int iEndLine = ( iFirstLine + RUN_SIZE < OutputHeight() ) ? ( iFirstLine + RUN_SIZE ) : OutputHeight();
+
+        for( int iPlane = 0; iPlane < Input.m_iNumPlanes; ++iPlane )
+        {
+            // Rows of the window, clamped to the edges of the input
+            const float* pWindow[MAX_KERNEL_RADIUS * 2 + 1];
+            for( int iTap = 0; iTap < KernelDiameter() - 1; ++iTap )
+            {
+                pWindow[iTap + 1] = Input.Row( iPlane, Clamp( iFirstLine - iKernelRadius + iTap, 0, iLastInputLine ) ) + iGroupCoordX;
+            }
+
+            for( int iY = iFirstLine; iY < iEndLine; ++iY )
+            {
+                for( int iTap = 0; iTap < KernelDiameter() - 1; ++iTap )
+                {
+                    pWindow[iTap] = pWindow[iTap + 1];
+                }
+                pWindow[KernelDiameter() - 1] = Input.Row( iPlane, Clamp( iY + iKernelRadius, 0, iLastInputLine ) ) + iGroupCoordX;
+
+                m_pKernels->m_pfnGaussianColumnPlane( m_fWeights, KernelDiameter(), pWindow, iStripWidth, m_pPlanarOutput->Row( iPlane, iY ) + iGroupCoordX );
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
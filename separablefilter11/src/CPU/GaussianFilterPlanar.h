@@ -0,0 +1,103 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: GaussianFilterPlanar.h
+//
+// Gaussian filter passes over planar surfaces, with the weights of GaussianFilterSIMD.
+// Every plane is filtered alike, so unlike the interleaved passes, which output alpha
+// as 1 as GaussianFilter.hlsl does, a fourth plane is filtered too.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "GaussianFilterSIMD.h"
+#include "PlanarSurface.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Horizontal pass: lines are filtered straight from the rows of the planes, only groups
+    // at the left and right edges copying their lines to scratch memory with the apron
+    // clamped
+    //--------------------------------------------------------------------------------------
+    class GaussianFilterPlanarX : public GaussianFilterSIMD
+    {
+    public:
+
+        GaussianFilterPlanarX() : m_pPlanarInput( NULL ), m_pPlanarOutput( NULL ) {}
+
+        // Filters these surfaces, which must have the same number of planes, instead of the bound
+        // input and output, which may then be NULL
+        void SetPlanarSurfaces( const PlanarSurface* pInput, PlanarSurface* pOutput );
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void GetGroupSize( unsigned int& uWidth, unsigned int& uHeight ) const { uWidth = RUN_SIZE; uHeight = RUN_LINES; }
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+
+    private:
+
+        const PlanarSurface*    m_pPlanarInput;
+        PlanarSurface*          m_pPlanarOutput;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Vertical pass: walks down strips of columns of each plane, as GaussianFilterY. Rows of
+    // a plane are a quarter the size of rows of texels, so the strips are up to 4 times as
+    // wide for the same cache.
+    //--------------------------------------------------------------------------------------
+    class GaussianFilterPlanarY : public GaussianFilterSIMD
+    {
+    public:
+
+        GaussianFilterPlanarY();
+
+        virtual void SetKernel( int iKernelRadius, bool bApproximate );
+
+        // Width of the strips in pixels, or 0 to size them from the caches of the CPU
+        void SetStripWidth( int iStripWidth );
+        int StripWidth() const { return m_iStripWidth; }
+
+        // As GaussianFilterPlanarX::SetPlanarSurfaces
+        void SetPlanarSurfaces( const PlanarSurface* pInput, PlanarSurface* pOutput );
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void GetGroupSize( unsigned int& uWidth, unsigned int& uHeight ) const { uWidth = (unsigned int)m_iStripWidth; uHeight = RUN_SIZE; }
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+
+    private:
+
+        const PlanarSurface*    m_pPlanarInput;
+        PlanarSurface*          m_pPlanarOutput;
+        int                     m_iRequestedStripWidth;
+        int                     m_iStripWidth;
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
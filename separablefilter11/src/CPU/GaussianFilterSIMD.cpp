@@ -0,0 +1,623 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: GaussianFilterSIMD.cpp
+//
+// Implements the vectorized Gaussian filter passes.
+//--------------------------------------------------------------------------------------
+
+
+#include "GaussianFilterSIMD.h"
+#include "GaussianFilter.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    GaussianFilterSIMD::GaussianFilterSIMD() :
+    m_pApronInput( NULL ),
+    m_fDeviation( 0.0f )
+    {
+        m_pKernels = &GetFilterKernels();
+        SetKernel( m_iKernelRadius, false );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Computes the weights of GaussianFilter.hlsl, pre-divided by their sum
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterSIMD::SetKernel( int iKernelRadius, bool /*bApproximate*/ )
+    {
+        FilterPass::SetKernel( iKernelRadius, false );
+
+        const float fDeviation = GetDeviation();
+        float fWeightSum = 0.0f;
+
+        for( int iTap = 0; iTap < KernelDiameter(); ++iTap )
+        {
+            m_fWeights[iTap] = GaussianWeight( (float)( iTap - m_iKernelRadius ), fDeviation );
+            fWeightSum += m_fWeights[iTap];
+        }
+
+        for( int iTap = 0; iTap < KernelDiameter(); ++iTap )
+        {
+            m_fWeights[iTap] /= fWeightSum;
+        }
+
+    #if !defined( NDEBUG )
+        // The specialized kernels have these weights compiled in
+        const KERNEL_RADIUS_TYPE RadiusType = ( 0.0f == m_fDeviation ) ? GetKernelRadiusType( m_iKernelRadius ) : KERNEL_RADIUS_TYPE_MAX;
+        for( int iTap = 0; iTap < KernelDiameter() && RadiusType < KERNEL_RADIUS_TYPE_MAX; ++iTap )
+        {
+            assert( fabsf( m_fWeights[iTap] - s_fGaussianWeights[RadiusType][iTap] ) <= 1.0e-6f * m_fWeights[iTap] );
+        }
+    #endif
+
+        SelectKernels();
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Overrides the deviation of the weights
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterSIMD::SetDeviation( float fDeviation )
+    {
+        assert( fDeviation >= 0.0f );
+
+        m_fDeviation = fDeviation;
+        SetKernel( m_iKernelRadius, false );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Forces the kernels of an instruction set supported by the CPU
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterSIMD::SetISA( ISA_TYPE ISA )
+    {
+        m_pKernels = &GetFilterKernels( ISA );
+
+        SelectKernels();
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Picks the kernels specialized for the radius, or the looped ones if there are none.
+    // The specialized kernels only have the weights of the default deviation.
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterSIMD::SelectKernels()
+    {
+        const KERNEL_RADIUS_TYPE RadiusType = ( 0.0f == m_fDeviation ) ? GetKernelRadiusType( m_iKernelRadius ) : KERNEL_RADIUS_TYPE_MAX;
+
+        m_pfnGaussianRow = m_pKernels->m_pfnGaussianRow;
+        m_pfnGaussianColumn = m_pKernels->m_pfnGaussianColumn;
+
+        if( RadiusType < KERNEL_RADIUS_TYPE_MAX && NULL != m_pKernels->m_pfnGaussianRowFixed[RadiusType] )
+        {
+            m_pfnGaussianRow = m_pKernels->m_pfnGaussianRowFixed[RadiusType];
+            m_pfnGaussianColumn = m_pKernels->m_pfnGaussianColumnFixed[RadiusType];
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Same dispatch as CSFilterX
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterX::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = DivRoundUp( (unsigned int)OutputWidth(), RUN_SIZE );
+        uY = DivRoundUp( (unsigned int)OutputHeight(), RUN_LINES );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Size of each of the planes used by FilterLine, in floats. The planes cover the kernel
+    // on either side, plus padding for the last vectors.
+    //--------------------------------------------------------------------------------------
+    int GaussianFilterSIMD::GetPlaneStride( int iNumPixels ) const
+    {
+        const int iPlaneSize = iNumPixels + 2 * KernelRadius() + 2 * MAX_VECTOR_WIDTH;
+
+        return (int)( DivRoundUp( (unsigned int)iPlaneSize, MAX_VECTOR_WIDTH ) * MAX_VECTOR_WIDTH );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Filters iNumPixels pixels of line iY of the input, starting at iX, through 3 planes of
+    // scratch memory, each GetPlaneStride floats
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterSIMD::FilterLine( int iY, int iX, int iNumPixels, float* pPlanes, Float4* pOutput ) const
+    {
+        if( NULL != m_pApronInput )
+        {
+            FilterApronLine( iY, iX, iNumPixels, pPlanes, pOutput );
+            return;
+        }
+
+        const Surface& Input = *m_pInputs[0];
+        const int iWidth = (int)Input.m_uWidth;
+        const int iPlaneStride = GetPlaneStride( iNumPixels );
+        float* pRed = pPlanes;
+        float* pGreen = pPlanes + iPlaneStride;
+        float* pBlue = pPlanes + iPlaneStride * 2;
+
+        // The part of the planes that is inside the input, the rest is clamped to the edges
+        const int iFirstX = iX - KernelRadius();
+        const int iBegin = ( iFirstX < 0 ) ? -iFirstX : 0;
+        const int iEnd = ( iFirstX + iPlaneStride > iWidth ) ? ( iWidth - iFirstX ) : iPlaneStride;
+
+        const Float4* pSrc = Input.Row( Clamp( iY, 0, (int)Input.m_uHeight - 1 ) );
+        m_pKernels->m_pfnDeinterleaveRow( pSrc + iFirstX + iBegin, iEnd - iBegin, pRed + iBegin, pGreen + iBegin, pBlue + iBegin, NULL );
+
+        for( int i = 0; i < iBegin; ++i )
+        {
+            pRed[i] = pSrc[0].x; pGreen[i] = pSrc[0].y; pBlue[i] = pSrc[0].z;
+        }
+        for( int i = iEnd; i < iPlaneStride; ++i )
+        {
+            pRed[i] = pSrc[iWidth - 1].x; pGreen[i] = pSrc[iWidth - 1].y; pBlue[i] = pSrc[iWidth - 1].z;
+        }
+
+        m_pfnGaussianRow( m_fWeights, KernelDiameter(), pRed, pGreen, pBlue, iNumPixels, pOutput );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // FilterLine from the apron input. The texels under the kernel are all there, so are
+    // converted in one run, and only the padding for the last vectors is filled.
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterSIMD::FilterApronLine( int iY, int iX, int iNumPixels, float* pPlanes, Float4* pOutput ) const
+    {
+        assert( m_pApronInput->m_iApron >= KernelRadius() );
+        assert( iY >= -KernelRadius() && iY < (int)m_pApronInput->m_uHeight + KernelRadius() );
+
+        const int iPlaneStride = GetPlaneStride( iNumPixels );
+        const int iNumTexels = iNumPixels + KernelDiameter() - 1;
+        float* pRed = pPlanes;
+        float* pGreen = pPlanes + iPlaneStride;
+        float* pBlue = pPlanes + iPlaneStride * 2;
+
+        m_pKernels->m_pfnDeinterleaveRow( m_pApronInput->Row( iY ) + iX - KernelRadius(), iNumTexels, pRed, pGreen, pBlue, NULL );
+
+        for( int i = iNumTexels; i < iPlaneStride; ++i )
+        {
+            pRed[i] = pRed[iNumTexels - 1]; pGreen[i] = pGreen[iNumTexels - 1]; pBlue[i] = pBlue[iNumTexels - 1];
+        }
+
+        m_pfnGaussianRow( m_fWeights, KernelDiameter(), pRed, pGreen, pBlue, iNumPixels, pOutput );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Filters RUN_LINES lines of RUN_SIZE pixels
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterX::ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const
+    {
+        const int iGroupCoordX = (int)uGroupX * RUN_SIZE;
+        const int iNumPixels = ( OutputWidth() - iGroupCoordX < RUN_SIZE ) ? ( OutputWidth() - iGroupCoordX ) : RUN_SIZE;
+
+        // Lines written as halves are filtered to a line of floats after the planes first
+        const size_t uPlanesSize = sizeof( float ) * GetPlaneStride( iNumPixels ) * 3;
+        const size_t uLineSize = ( NULL != m_pHalfOutput ) ? sizeof( Float4 ) * RUN_SIZE : 0;
+        float* pPlanes = (float*)LDS.Reserve( uPlanesSize + uLineSize );
+        Float4* pLine = (Float4*)( (char*)pPlanes + uPlanesSize );
+
+        assert( NULL == m_pHalfOutput || ( m_pHalfOutput->m_uWidth >= (unsigned int)OutputWidth() && m_pHalfOutput->m_uHeight >= (unsigned int)OutputHeight() ) );
+
+        for( int iLine = 0; iLine < RUN_LINES; ++iLine )
+        {
+            const int iY = (int)uGroupY * RUN_LINES + iLine;
+            if( iY >= OutputHeight() )
+            {
+                break;
+            }
+
+            if( NULL != m_pHalfOutput )
+            {
+                FilterLine( iY, iGroupCoordX, iNumPixels, pPlanes, pLine );
+                m_pKernels->m_pfnFloatToHalfRow( &pLine->x, iNumPixels * 4, m_pHalfOutput->Row( iY ) + iGroupCoordX * 4 );
+            }
+            else
+            {
+                FilterLine( iY, iGroupCoordX, iNumPixels, pPlanes, m_pOutput->Row( iY ) + iGroupCoordX );
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    GaussianFilterY::GaussianFilterY() :
+    m_pHalfInput( NULL ),
+    m_iRequestedStripWidth( 0 ),
+    m_iStripWidth( ComputeStripWidth( ( KernelDiameter() + 1 ) * sizeof( Float4 ) ) )
+    {
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // The strip width depends on the size of the window of rows
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterY::SetKernel( int iKernelRadius, bool bApproximate )
+    {
+        GaussianFilterSIMD::SetKernel( iKernelRadius, bApproximate );
+
+        SetStripWidth( m_iRequestedStripWidth );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Overrides the strip width, or 0 to size them from the caches of the CPU
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterY::SetStripWidth( int iStripWidth )
+    {
+        assert( iStripWidth >= 0 );
+
+        m_iRequestedStripWidth = iStripWidth;
+        // The window holds the kernel rows, plus the output row
+        const size_t uInputTexelSize = ( NULL != m_pHalfInput ) ? 4 * sizeof( unsigned short ) : sizeof( Float4 );
+        m_iStripWidth = ( 0 == iStripWidth ) ? ComputeStripWidth( KernelDiameter() * uInputTexelSize + sizeof( Float4 ) ) : iStripWidth;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Switches between the bound input and an intermediate of halves
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterY::SetHalfInput( const HalfSurface* pHalfInput )
+    {
+        assert( NULL == pHalfInput || NULL == m_pApronInput );
+
+        m_pHalfInput = pHalfInput;
+
+        SetStripWidth( m_iRequestedStripWidth );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // One group per strip of RUN_SIZE lines, as CSFilterY runs down RUN_SIZE lines
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterY::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = DivRoundUp( (unsigned int)OutputWidth(), (unsigned int)m_iStripWidth );
+        uY = DivRoundUp( (unsigned int)OutputHeight(), RUN_SIZE );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Filters RUN_SIZE lines of a strip. The window of rows slides down one row per output
+    // line, so only one new row of the strip is fetched from memory each time.
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterY::ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& /*LDS*/ ) const
+    {
+        if( NULL != m_pHalfInput )
+        {
+            ComputeGroupHalf( uGroupX, uGroupY );
+            return;
+        }
+        if( NULL != m_pApronInput )
+        {
+            ComputeGroupApron( uGroupX, uGroupY );
+            return;
+        }
+
+        const Surface& Input = *m_pInputs[0];
+        const int iKernelRadius = KernelRadius();
+        const int iLastInputLine = (int)Input.m_uHeight - 1;
+
+        const int iGroupCoordX = (int)uGroupX * m_iStripWidth;
+        const int iStripWidth = ( OutputWidth() - iGroupCoordX < m_iStripWidth ) ? ( OutputWidth() - iGroupCoordX ) : m_iStripWidth;
+        const int iFirstLine = (int)uGroupY * RUN_SIZE;
+        const int iEndLine = ( iFirstLine + RUN_SIZE < OutputHeight() ) ? ( iFirstLine + RUN_SIZE ) : OutputHeight();
+
+        // Rows of the window, clamped to the edges of the input
+        const float* pWindow[MAX_KERNEL_RADIUS * 2 + 1];
+        for( int iTap = 0; iTap < KernelDiameter() - 1; ++iTap )
+        {
+            pWindow[iTap + 1] = &Input.Row( Clamp( iFirstLine - iKernelRadius + iTap, 0, iLastInputLine ) )[iGroupCoordX].x;
+        }
+
+        for( int iY = iFirstLine; iY < iEndLine; ++iY )
+        {
+            for( int iTap = 0; iTap < KernelDiameter() - 1; ++iTap )
+            {
+                pWindow[iTap] = pWindow[iTap + 1];
+            }
+            pWindow[KernelDiameter() - 1] = &Input.Row( Clamp( iY + iKernelRadius, 0, iLastInputLine ) )[iGroupCoordX].x;
+
+            m_pfnGaussianColumn( m_fWeights, KernelDiameter(), pWindow, iStripWidth * 4, &m_pOutput->Row( iY )[iGroupCoordX].x );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // ComputeGroup over the apron input, whose rows above and below the edges are read as
+    // they are
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterY::ComputeGroupApron( unsigned int uGroupX, unsigned int uGroupY ) const
+    {
+        const ApronSurface& Input = *m_pApronInput;
+        const int iKernelRadius = KernelRadius();
+
+        assert( Input.m_iApron >= iKernelRadius );
+
+        const int iGroupCoordX = (int)uGroupX * m_iStripWidth;
+        const int iStripWidth = ( OutputWidth() - iGroupCoordX < m_iStripWidth ) ? ( OutputWidth() - iGroupCoordX ) : m_iStripWidth;
+        const int iFirstLine = (int)uGroupY * RUN_SIZE;
+        const int iEndLine = ( iFirstLine + RUN_SIZE < OutputHeight() ) ? ( iFirstLine + RUN_SIZE ) : OutputHeight();
+
+        const float* pWindow[MAX_KERNEL_RADIUS * 2 + 1];
+        for( int iY = iFirstLine; iY < iEndLine; ++iY )
+        {
+            for( int iTap = 0; iTap < KernelDiameter(); ++iTap )
+            {
+                pWindow[iTap] = &Input.Row( iY - iKernelRadius + iTap )[iGroupCoordX].x;
+            }
+
+            m_pfnGaussianColumn( m_fWeights, KernelDiameter(), pWindow, iStripWidth * 4, &m_pOutput->Row( iY )[iGroupCoordX].x );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // ComputeGroup over an intermediate of halves, which are converted as they are loaded
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterY::ComputeGroupHalf( unsigned int uGroupX, unsigned int uGroupY ) const
+    {
+        const HalfSurface& Input = *m_pHalfInput;
+        const int iKernelRadius = KernelRadius();
+        const int iLastInputLine = (int)Input.m_uHeight - 1;
+
+        const int iGroupCoordX = (int)uGroupX * m_iStripWidth;
+        const int iStripWidth = ( OutputWidth() - iGroupCoordX < m_iStripWidth ) ? ( OutputWidth() - iGroupCoordX ) : m_iStripWidth;
+        const int iFirstLine = (int)uGroupY * RUN_SIZE;
+        const int iEndLine = ( iFirstLine + RUN_SIZE < OutputHeight() ) ? ( iFirstLine + RUN_SIZE ) : OutputHeight();
+
+        const unsigned short* pWindow[MAX_KERNEL_RADIUS * 2 + 1];
+        for( int iTap = 0; iTap < KernelDiameter() - 1; ++iTap )
+        {
+            pWindow[iTap + 1] = Input.Row( Clamp( iFirstLine - iKernelRadius + iTap, 0, iLastInputLine ) ) + iGroupCoordX * 4;
+        }
+
+        for( int iY = iFirstLine; iY < iEndLine; ++iY )
+        {
+            for( int iTap = 0; iTap < KernelDiameter() - 1; ++iTap )
+            {
+                pWindow[iTap] = pWindow[iTap + 1];
+            }
+            pWindow[KernelDiameter() - 1] = Input.Row( Clamp( iY + iKernelRadius, 0, iLastInputLine ) ) + iGroupCoordX * 4;
+
+            m_pKernels->m_pfnGaussianColumnHalf( m_fWeights, KernelDiameter(), pWindow, iStripWidth * 4, &m_pOutput->Row( iY )[iGroupCoordX].x );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    GaussianFilterFused::GaussianFilterFused() :
+    m_iRequestedStripWidth( 0 ),
+    m_iRequestedBandHeight( 0 ),
+    m_LDSPrecision( LDS_PRECISION_TYPE_32_BIT ),
+    m_bRequireHDR( false )
+    {
+        SetKernel( m_iKernelRadius, false );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // The strip width and band height depend on the size of the ring buffer
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterFused::SetKernel( int iKernelRadius, bool bApproximate )
+    {
+        GaussianFilterSIMD::SetKernel( iKernelRadius, bApproximate );
+
+        SetStripWidth( m_iRequestedStripWidth );
+        SetBandHeight( m_iRequestedBandHeight );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Overrides the strip width, or 0 to size them from the caches of the CPU
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterFused::SetStripWidth( int iStripWidth )
+    {
+        assert( iStripWidth >= 0 );
+
+        // The ring buffer holds the kernel rows, plus the planes and the output row, and the
+        // reduced precisions also need a line to filter into before packing it
+        const unsigned int uTexelSize = 4 * GetLDSItemSize( m_LDSPrecision );
+        const unsigned int uExtraRows = ( LDS_PRECISION_TYPE_32_BIT == m_LDSPrecision ) ? 2 : 3;
+
+        m_iRequestedStripWidth = iStripWidth;
+        m_iStripWidth = ( 0 == iStripWidth ) ? ComputeStripWidth( KernelDiameter() * uTexelSize + uExtraRows * sizeof( Float4 ) ) : iStripWidth;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Overrides the band height, or 0 to size them from the kernel diameter
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterFused::SetBandHeight( int iBandHeight )
+    {
+        assert( iBandHeight >= 0 );
+
+        // Each band filters 2 * KERNEL_RADIUS more lines horizontally than it outputs, so
+        // the bands are kept long compared to the kernel
+        const int iAutoBandHeight = 16 * KernelDiameter();
+
+        m_iRequestedBandHeight = iBandHeight;
+        m_iBandHeight = ( 0 != iBandHeight ) ? iBandHeight : ( ( iAutoBandHeight > RUN_SIZE ) ? iAutoBandHeight : RUN_SIZE );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sets the precision of the ring buffer, which changes the automatic strip width
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterFused::SetLDSPrecision( LDS_PRECISION_TYPE LDSPrecision )
+    {
+        assert( LDSPrecision < LDS_PRECISION_TYPE_MAX );
+
+        m_LDSPrecision = LDSPrecision;
+        SetStripWidth( m_iRequestedStripWidth );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // One group per band of a strip
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterFused::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = DivRoundUp( (unsigned int)OutputWidth(), (unsigned int)m_iStripWidth );
+        uY = DivRoundUp( (unsigned int)OutputHeight(), (unsigned int)m_iBandHeight );
+    }
+
+
+    // A half channel of the ring buffer, as opposed to the 16 bit unorm unsigned short
+    struct HalfChannel
+    {
+        unsigned short uBits;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Converts a horizontally filtered line to the ring buffer's precision. The full
+    // precision ring buffer is filtered into directly, so has nothing to do.
+    //--------------------------------------------------------------------------------------
+    static inline void PackLine( const FilterKernels& /*Kernels*/, const Float4* /*pLine*/, int /*iCount*/, float* /*pDst*/ ) {}
+    static inline void PackLine( const FilterKernels& Kernels, const Float4* pLine, int iCount, HalfChannel* pDst ) { Kernels.m_pfnFloatToHalfRow( &pLine->x, iCount, &pDst->uBits ); }
+    static inline void PackLine( const FilterKernels& Kernels, const Float4* pLine, int iCount, unsigned short* pDst ) { Kernels.m_pfnPackRowUNorm16( &pLine->x, iCount, pDst ); }
+    static inline void PackLine( const FilterKernels& Kernels, const Float4* pLine, int iCount, unsigned char* pDst ) { Kernels.m_pfnPackRowUNorm8( &pLine->x, iCount, pDst ); }
+
+
+    //--------------------------------------------------------------------------------------
+    // Vertically filters the lines of the ring buffer, at its precision
+    //--------------------------------------------------------------------------------------
+    static inline void FilterColumn( const FilterKernels& /*Kernels*/, PFN_GAUSSIAN_COLUMN pfnGaussianColumn, const float* pWeights, int iKernelDiameter, const float* const* ppRows, int iCount, float* pOutput )
+    {
+        pfnGaussianColumn( pWeights, iKernelDiameter, ppRows, iCount, pOutput );
+    }
+
+    static inline void FilterColumn( const FilterKernels& Kernels, PFN_GAUSSIAN_COLUMN /*pfnGaussianColumn*/, const float* pWeights, int iKernelDiameter, const HalfChannel* const* ppRows, int iCount, float* pOutput )
+    {
+        Kernels.m_pfnGaussianColumnHalf( pWeights, iKernelDiameter, (const unsigned short* const*)ppRows, iCount, pOutput );
+    }
+
+    static inline void FilterColumn( const FilterKernels& Kernels, PFN_GAUSSIAN_COLUMN /*pfnGaussianColumn*/, const float* pWeights, int iKernelDiameter, const unsigned short* const* ppRows, int iCount, float* pOutput )
+    {
+        Kernels.m_pfnGaussianColumnUNorm16( pWeights, iKernelDiameter, ppRows, iCount, pOutput );
+    }
+
+    static inline void FilterColumn( const FilterKernels& Kernels, PFN_GAUSSIAN_COLUMN /*pfnGaussianColumn*/, const float* pWeights, int iKernelDiameter, const unsigned char* const* ppRows, int iCount, float* pOutput )
+    {
+        Kernels.m_pfnGaussianColumnUNorm8( pWeights, iKernelDiameter, ppRows, iCount, pOutput );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Filters a band of a strip, at the precision of the ring buffer. Reduced precision
+    // clips HDR inputs, unless the 16 bit ring buffer stores halves.
+    //--------------------------------------------------------------------------------------
+    void GaussianFilterFused::ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const
+    {
+        switch( m_LDSPrecision )
+        {
+        case LDS_PRECISION_TYPE_8_BIT:
+            assert( !m_bRequireHDR );
+            ComputeBand< unsigned char >( uGroupX, uGroupY, LDS );
+            break;
+        case LDS_PRECISION_TYPE_16_BIT:
+            if( m_bRequireHDR )
+            {
+                ComputeBand< HalfChannel >( uGroupX, uGroupY, LDS );
+            }
+            else
+            {
+                ComputeBand< unsigned short >( uGroupX, uGroupY, LDS );
+            }
+            break;
+        default:
+            ComputeBand< float >( uGroupX, uGroupY, LDS );
+            break;
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Filters a band of a strip. Each input line is filtered horizontally into a ring buffer
+    // of KERNEL_DIAMETER lines, and an output line is filtered vertically from the ring
+    // buffer as soon as the lines under its kernel are there.
+    //--------------------------------------------------------------------------------------
+    template< typename LDSItem >
+    void GaussianFilterFused::ComputeBand( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const
+    {
+        const bool bPacked = ( sizeof( LDSItem ) < sizeof( float ) );
+        const int iKernelRadius = KernelRadius();
+        const int iKernelDiameter = KernelDiameter();
+
+        const int iGroupCoordX = (int)uGroupX * m_iStripWidth;
+        const int iStripWidth = ( OutputWidth() - iGroupCoordX < m_iStripWidth ) ? ( OutputWidth() - iGroupCoordX ) : m_iStripWidth;
+        const int iFirstLine = (int)uGroupY * m_iBandHeight;
+        const int iEndLine = ( iFirstLine + m_iBandHeight < OutputHeight() ) ? ( iFirstLine + m_iBandHeight ) : OutputHeight();
+
+        // Ring buffer lines are kept cache line aligned, and are followed by the line to
+        // filter into when packed, then the planes. The pitch is in channels.
+        const int iRingPitch = (int)( DivRoundUp( (unsigned int)iStripWidth * 4, MEMORY_ALIGNMENT / sizeof( LDSItem ) ) * ( MEMORY_ALIGNMENT / sizeof( LDSItem ) ) );
+        const size_t uRingSize = sizeof( LDSItem ) * iRingPitch * iKernelDiameter;
+        const size_t uLineSize = bPacked ? DivRoundUp( (unsigned int)( sizeof( Float4 ) * iStripWidth ), MEMORY_ALIGNMENT ) * MEMORY_ALIGNMENT : 0;
+        LDSItem* pRing = (LDSItem*)LDS.Reserve( uRingSize + uLineSize + sizeof( float ) * GetPlaneStride( iStripWidth ) * 3 );
+        Float4* pPackLine = (Float4*)( (char*)pRing + uRingSize );
+        float* pPlanes = (float*)( (char*)pRing + uRingSize + uLineSize );
+
+        const LDSItem* pWindow[MAX_KERNEL_RADIUS * 2 + 1];
+
+        for( int iLine = iFirstLine - iKernelRadius; iLine < iEndLine + iKernelRadius; ++iLine )
+        {
+            // Lines above and below the input are clamped, as the vertical pass clamps its reads,
+            // or read from the apron input
+            const int iSlot = ( iLine - iFirstLine + iKernelRadius ) % iKernelDiameter;
+            LDSItem* pSlot = pRing + iSlot * iRingPitch;
+            Float4* pLine = bPacked ? pPackLine : (Float4*)pSlot;
+            FilterLine( iLine, iGroupCoordX, iStripWidth, pPlanes, pLine );
+            PackLine( *m_pKernels, pLine, iStripWidth * 4, pSlot );
+
+            // The kernel of this output line ends on the line just filtered
+            const int iY = iLine - iKernelRadius;
+            if( iY >= iFirstLine )
+            {
+                for( int iTap = 0; iTap < iKernelDiameter; ++iTap )
+                {
+                    pWindow[iTap] = pRing + ( ( iY - iFirstLine + iTap ) % iKernelDiameter ) * iRingPitch;
+                }
+
+                FilterColumn( *m_pKernels, m_pfnGaussianColumn, m_fWeights, iKernelDiameter, pWindow, iStripWidth * 4, &m_pOutput->Row( iY )[iGroupCoordX].x );
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
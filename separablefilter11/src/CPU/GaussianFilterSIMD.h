@@ -0,0 +1,210 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: GaussianFilterSIMD.h
+//
+// Vectorized Gaussian filter passes, with the semantics of GaussianFilter.hlsl. The
+// kernels are selected at runtime for the best instruction set of the CPU, and can be
+// forced to the scalar kernels to cross check the results.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+#include "SIMD.h"
+#include "HalfFloat.h"
+#include "ApronSurface.h"
+#include "GaussianWeights.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Common state of the vectorized Gaussian passes
+    //--------------------------------------------------------------------------------------
+    class GaussianFilterSIMD : public FilterPass
+    {
+    public:
+
+        GaussianFilterSIMD();
+
+        // The approximate filter only exists to halve the texture fetches of the GPU, so the
+        // full filter is always computed
+        virtual void SetKernel( int iKernelRadius, bool bApproximate );
+
+        // Overrides GAUSSIAN_DEVIATION, or 0 for half the kernel radius
+        void SetDeviation( float fDeviation );
+        float GetDeviation() const { return ( m_fDeviation > 0.0f ) ? m_fDeviation : (float)m_iKernelRadius * 0.5f; }
+
+        // Defaults to the best instruction set of the CPU
+        void SetISA( ISA_TYPE ISA );
+        ISA_TYPE GetISA() const { return m_pKernels->m_ISA; }
+
+        // Reads an apron surface instead of the bound input, which may then be NULL. The apron
+        // must be at least the kernel radius and filled for the pass, so the texels beyond the
+        // edges are read without clamping. NULL to read the bound input again.
+        void SetApronInput( const ApronSurface* pApronInput ) { m_pApronInput = pApronInput; }
+
+    protected:
+
+        // Horizontally filters part of a line, for the passes below
+        int GetPlaneStride( int iNumPixels ) const;
+        void FilterLine( int iY, int iX, int iNumPixels, float* pPlanes, Float4* pOutput ) const;
+        void FilterApronLine( int iY, int iX, int iNumPixels, float* pPlanes, Float4* pOutput ) const;
+
+        const FilterKernels*    m_pKernels;
+        const ApronSurface*     m_pApronInput;
+        PFN_GAUSSIAN_ROW        m_pfnGaussianRow;       // From m_pKernels, for this radius
+        PFN_GAUSSIAN_COLUMN     m_pfnGaussianColumn;
+        float                   m_fDeviation;
+        float                   m_fWeights[MAX_KERNEL_RADIUS * 2 + 1];  // Normalized
+
+    private:
+
+        void SelectKernels();
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Horizontal pass: each line of a group is converted to planar scratch memory, so that
+    // every lane of a vector computes a different output pixel
+    //--------------------------------------------------------------------------------------
+    class GaussianFilterX : public GaussianFilterSIMD
+    {
+    public:
+
+        GaussianFilterX() : m_pHalfOutput( NULL ) {}
+
+        // Writes the intermediate as halves instead of to the bound output, which may then be
+        // NULL. NULL to write to the bound output again.
+        void SetHalfOutput( HalfSurface* pHalfOutput ) { m_pHalfOutput = pHalfOutput; }
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void GetGroupSize( unsigned int& uWidth, unsigned int& uHeight ) const { uWidth = RUN_SIZE; uHeight = RUN_LINES; }
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+
+    private:
+
+        HalfSurface* m_pHalfOutput;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Vertical pass: rather than walking down single columns, which touches one cache line
+    // per tap per pixel, each group walks down a strip of columns with a sliding window of
+    // rows. The strip is sized so that the window fits the L1 cache (or the L2 cache for
+    // large kernels), so every cache line loaded is fully used before it is evicted.
+    //--------------------------------------------------------------------------------------
+    class GaussianFilterY : public GaussianFilterSIMD
+    {
+    public:
+
+        GaussianFilterY();
+
+        virtual void SetKernel( int iKernelRadius, bool bApproximate );
+
+        // Width of the strips in texels, or 0 to size them from the caches of the CPU
+        void SetStripWidth( int iStripWidth );
+        int StripWidth() const { return m_iStripWidth; }
+
+        // Reads the intermediate written by GaussianFilterX::SetHalfOutput instead of the bound
+        // input. Rows of halves are half the size, so the strips are up to twice as wide.
+        void SetHalfInput( const HalfSurface* pHalfInput );
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void GetGroupSize( unsigned int& uWidth, unsigned int& uHeight ) const { uWidth = (unsigned int)m_iStripWidth; uHeight = RUN_SIZE; }
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+
+    private:
+
+        void ComputeGroupApron( unsigned int uGroupX, unsigned int uGroupY ) const;
+        void ComputeGroupHalf( unsigned int uGroupX, unsigned int uGroupY ) const;
+
+        const HalfSurface*  m_pHalfInput;
+        int                 m_iRequestedStripWidth;
+        int                 m_iStripWidth;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Both passes fused into one: each group walks down a band of a strip of columns, keeping
+    // only the last KERNEL_DIAMETER horizontally filtered lines in a ring buffer in its
+    // scratch memory. This removes the intermediate surface, and its memory traffic, at the
+    // cost of filtering 2 * KERNEL_RADIUS extra lines per band horizontally.
+    //
+    // The ring buffer is the CPU's LDS, and can be stored at the precisions of LDS_PRECISION:
+    // 8 and 16 bit unorm quarter and halve its size, so the strips can be wider for the same
+    // cache, at the cost of quantizing the horizontal pass's output. As with REQUIRE_HDR, the
+    // 16 bit ring buffer stores halves instead for HDR inputs.
+    //--------------------------------------------------------------------------------------
+    class GaussianFilterFused : public GaussianFilterSIMD
+    {
+    public:
+
+        GaussianFilterFused();
+
+        virtual void SetKernel( int iKernelRadius, bool bApproximate );
+
+        // Width of the strips in texels, or 0 to size them from the caches of the CPU
+        void SetStripWidth( int iStripWidth );
+        int StripWidth() const { return m_iStripWidth; }
+
+        // Height of the bands in lines, or 0 to size them from the kernel diameter
+        void SetBandHeight( int iBandHeight );
+        int BandHeight() const { return m_iBandHeight; }
+
+        // Precision of the ring buffer, defaults to LDS_PRECISION_TYPE_32_BIT. The reduced
+        // precisions are unorm, so only suit inputs in [0,1], unless HDR is required.
+        void SetLDSPrecision( LDS_PRECISION_TYPE LDSPrecision );
+        LDS_PRECISION_TYPE GetLDSPrecision() const { return m_LDSPrecision; }
+
+        // Equivalent of REQUIRE_HDR: the 16 bit ring buffer stores halves, and the 8 bit one
+        // can't be used. Defaults to false.
+        void SetRequireHDR( bool bRequireHDR ) { m_bRequireHDR = bRequireHDR; }
+        bool GetRequireHDR() const { return m_bRequireHDR; }
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void GetGroupSize( unsigned int& uWidth, unsigned int& uHeight ) const { uWidth = (unsigned int)m_iStripWidth; uHeight = (unsigned int)m_iBandHeight; }
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+
+    private:
+
+        // ComputeGroup for a ring buffer of float, half, unsigned short or unsigned char channels
+        template< typename LDSItem >
+        void ComputeBand( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+
+        int                 m_iRequestedStripWidth;
+        int                 m_iStripWidth;
+        int                 m_iRequestedBandHeight;
+        int                 m_iBandHeight;
+        LDS_PRECISION_TYPE  m_LDSPrecision;
+        bool                m_bRequireHDR;
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,831 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: GaussianKernels.inl
+//
+// Vectorized Gaussian kernels, written against the VecF type of the including
+// translation unit (Kernels_*.cpp). Each lane of a vector carries a different pixel.
+//--------------------------------------------------------------------------------------
+
+
+//--------------------------------------------------------------------------------------
+// Converts iCount interleaved texels into planar red, green and blue, and alpha if pAlpha
+// is not NULL
+//--------------------------------------------------------------------------------------
+static void DeinterleaveRow( const Float4* pSrc, int iCount, float* pRed, float* pGreen, float* pBlue, float* pAlpha )
+{
+    int i = 0;
+
+    for( ; i + VecF::WIDTH <= iCount; i += VecF::WIDTH )
+    {
+        VecF R, G, B, A;
+        LoadDeinterleaved( pSrc + i, R, G, B, A );
+        R.StoreU( pRed + i );
+        G.StoreU( pGreen + i );
+        B.StoreU( pBlue + i );
+        if( NULL != pAlpha )
+        {
+            A.StoreU( pAlpha + i );
+        }
+    }
+
+    for( ; i < iCount; ++i )
+    {
+        pRed[i] = pSrc[i].x;
+        pGreen[i] = pSrc[i].y;
+        pBlue[i] = pSrc[i].z;
+        if( NULL != pAlpha )
+        {
+            pAlpha[i] = pSrc[i].w;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Stores a vector of output pixels, only iNumPixels of which are written
+//--------------------------------------------------------------------------------------
+static inline void StoreOutput( Float4* pOutput, int iNumPixels, VecF R, VecF G, VecF B, VecF A )
+{
+    if( iNumPixels >= VecF::WIDTH )
+    {
+        StoreInterleaved( pOutput, R, G, B, A );
+    }
+    else
+    {
+        Float4 Tail[VecF::WIDTH];
+        StoreInterleaved( Tail, R, G, B, A );
+        memcpy( pOutput, Tail, sizeof( Float4 ) * iNumPixels );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Convolves planar pixels with normalized weights. Two vectors of pixels are computed per
+// iteration, to hide the latency of the multiply-adds.
+//--------------------------------------------------------------------------------------
+static void GaussianRow( const float* pWeights, int iKernelDiameter, const float* pRed, const float* pGreen, const float* pBlue, int iNumPixels, Float4* pOutput )
+{
+    const VecF One = VecF::Set1( 1.0f );
+    int iPixel = 0;
+
+    for( ; iPixel + VecF::WIDTH < iNumPixels; iPixel += 2 * VecF::WIDTH )
+    {
+        VecF W = VecF::Set1( pWeights[0] );
+        VecF R0 = W * VecF::LoadU( pRed + iPixel );
+        VecF G0 = W * VecF::LoadU( pGreen + iPixel );
+        VecF B0 = W * VecF::LoadU( pBlue + iPixel );
+        VecF R1 = W * VecF::LoadU( pRed + iPixel + VecF::WIDTH );
+        VecF G1 = W * VecF::LoadU( pGreen + iPixel + VecF::WIDTH );
+        VecF B1 = W * VecF::LoadU( pBlue + iPixel + VecF::WIDTH );
+
+        for( int iTap = 1; iTap < iKernelDiameter; ++iTap )
+        {
+            const int iOffset = iPixel + iTap;
+            W = VecF::Set1( pWeights[iTap] );
+            R0 = MulAdd( W, VecF::LoadU( pRed + iOffset ), R0 );
+            G0 = MulAdd( W, VecF::LoadU( pGreen + iOffset ), G0 );
+            B0 = MulAdd( W, VecF::LoadU( pBlue + iOffset ), B0 );
+            R1 = MulAdd( W, VecF::LoadU( pRed + iOffset + VecF::WIDTH ), R1 );
+            G1 = MulAdd( W, VecF::LoadU( pGreen + iOffset + VecF::WIDTH ), G1 );
+            B1 = MulAdd( W, VecF::LoadU( pBlue + iOffset + VecF::WIDTH ), B1 );
+        }
+
+        StoreOutput( pOutput + iPixel, iNumPixels - iPixel, R0, G0, B0, One );
+        StoreOutput( pOutput + iPixel + VecF::WIDTH, iNumPixels - iPixel - VecF::WIDTH, R1, G1, B1, One );
+    }
+
+    for( ; iPixel < iNumPixels; iPixel += VecF::WIDTH )
+    {
+        VecF W = VecF::Set1( pWeights[0] );
+        VecF R = W * VecF::LoadU( pRed + iPixel );
+        VecF G = W * VecF::LoadU( pGreen + iPixel );
+        VecF B = W * VecF::LoadU( pBlue + iPixel );
+
+        for( int iTap = 1; iTap < iKernelDiameter; ++iTap )
+        {
+            W = VecF::Set1( pWeights[iTap] );
+            R = MulAdd( W, VecF::LoadU( pRed + iPixel + iTap ), R );
+            G = MulAdd( W, VecF::LoadU( pGreen + iPixel + iTap ), G );
+            B = MulAdd( W, VecF::LoadU( pBlue + iPixel + iTap ), B );
+        }
+
+        StoreOutput( pOutput + iPixel, iNumPixels - iPixel, R, G, B, One );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Convolves a strip of interleaved texels down a column of rows. ppRows holds the
+// kernel diameter rows, already offset to the strip, and iCount is in floats. Every
+// lane carries a different channel, so alpha is replaced with 1 afterwards. Four
+// vectors are computed per iteration, as there are only two loads per multiply-add.
+//--------------------------------------------------------------------------------------
+static const float s_fColorMask[16] = { 1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f };
+static const float s_fAlphaOne[16] = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+
+static inline VecF ColorMask( int iFloat )
+{
+    // Vectors as wide as a texel always start on a texel boundary
+    return VecF::LoadU( s_fColorMask + ( ( VecF::WIDTH >= 4 ) ? 0 : ( iFloat & 3 ) ) );
+}
+
+static inline VecF AlphaOne( int iFloat )
+{
+    return VecF::LoadU( s_fAlphaOne + ( ( VecF::WIDTH >= 4 ) ? 0 : ( iFloat & 3 ) ) );
+}
+
+static inline void StoreColumnOutput( float* pOutput, int iFloat, VecF Sum )
+{
+    MulAdd( Sum, ColorMask( iFloat ), AlphaOne( iFloat ) ).StoreU( pOutput + iFloat );
+}
+
+static void GaussianColumn( const float* pWeights, int iKernelDiameter, const float* const* ppRows, int iCount, float* pOutput )
+{
+    int i = 0;
+
+    for( ; i + 4 * VecF::WIDTH <= iCount; i += 4 * VecF::WIDTH )
+    {
+        VecF W = VecF::Set1( pWeights[0] );
+        const float* pRow = ppRows[0] + i;
+        VecF Sum0 = W * VecF::LoadU( pRow );
+        VecF Sum1 = W * VecF::LoadU( pRow + VecF::WIDTH );
+        VecF Sum2 = W * VecF::LoadU( pRow + VecF::WIDTH * 2 );
+        VecF Sum3 = W * VecF::LoadU( pRow + VecF::WIDTH * 3 );
+
+        for( int iTap = 1; iTap < iKernelDiameter; ++iTap )
+        {
+            W = VecF::Set1( pWeights[iTap] );
+            pRow = ppRows[iTap] + i;
+            Sum0 = MulAdd( W, VecF::LoadU( pRow ), Sum0 );
+            Sum1 = MulAdd( W, VecF::LoadU( pRow + VecF::WIDTH ), Sum1 );
+            Sum2 = MulAdd( W, VecF::LoadU( pRow + VecF::WIDTH * 2 ), Sum2 );
+            Sum3 = MulAdd( W, VecF::LoadU( pRow + VecF::WIDTH * 3 ), Sum3 );
+        }
+
+        StoreColumnOutput( pOutput, i, Sum0 );
+        StoreColumnOutput( pOutput, i + VecF::WIDTH, Sum1 );
+        StoreColumnOutput( pOutput, i + VecF::WIDTH * 2, Sum2 );
+        StoreColumnOutput( pOutput, i + VecF::WIDTH * 3, Sum3 );
+    }
+
+    for( ; i + VecF::WIDTH <= iCount; i += VecF::WIDTH )
+    {
+        VecF Sum = VecF::Set1( pWeights[0] ) * VecF::LoadU( ppRows[0] + i );
+
+        for( int iTap = 1; iTap < iKernelDiameter; ++iTap )
+        {
+            Sum = MulAdd( VecF::Set1( pWeights[iTap] ), VecF::LoadU( ppRows[iTap] + i ), Sum );
+        }
+
+        StoreColumnOutput( pOutput, i, Sum );
+    }
+
+    for( ; i < iCount; ++i )
+    {
+        float fSum = 0.0f;
+
+        for( int iTap = 0; iTap < iKernelDiameter; ++iTap )
+        {
+            fSum += pWeights[iTap] * ppRows[iTap][i];
+        }
+
+        pOutput[i] = s_fColorMask[i & 3] * fSum + s_fAlphaOne[i & 3];
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Interleaves iCount texels from planar red, green and blue, and alpha if pAlpha is not
+// NULL, or 1 otherwise. The reverse of DeinterleaveRow.
+//--------------------------------------------------------------------------------------
+static void InterleaveRow( const float* pRed, const float* pGreen, const float* pBlue, const float* pAlpha, int iCount, Float4* pDst )
+{
+    const VecF One = VecF::Set1( 1.0f );
+    int i = 0;
+
+    for( ; i + VecF::WIDTH <= iCount; i += VecF::WIDTH )
+    {
+        const VecF A = ( NULL != pAlpha ) ? VecF::LoadU( pAlpha + i ) : One;
+        StoreInterleaved( pDst + i, VecF::LoadU( pRed + i ), VecF::LoadU( pGreen + i ), VecF::LoadU( pBlue + i ), A );
+    }
+
+    for( ; i < iCount; ++i )
+    {
+        pDst[i].x = pRed[i];
+        pDst[i].y = pGreen[i];
+        pDst[i].z = pBlue[i];
+        pDst[i].w = ( NULL != pAlpha ) ? pAlpha[i] : 1.0f;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Convolves iCount values of a single plane with normalized weights, from pSrc, which
+// starts KERNEL_RADIUS values before the first output. Unlike GaussianRow nothing past
+// the last tap is read, so the source may be a row of a planar surface, used in place.
+//--------------------------------------------------------------------------------------
+static void GaussianRowPlane( const float* pWeights, int iKernelDiameter, const float* pSrc, int iCount, float* pDst )
+{
+    int i = 0;
+
+    for( ; i + 4 * VecF::WIDTH <= iCount; i += 4 * VecF::WIDTH )
+    {
+        VecF W = VecF::Set1( pWeights[0] );
+        VecF Sum0 = W * VecF::LoadU( pSrc + i );
+        VecF Sum1 = W * VecF::LoadU( pSrc + i + VecF::WIDTH );
+        VecF Sum2 = W * VecF::LoadU( pSrc + i + VecF::WIDTH * 2 );
+        VecF Sum3 = W * VecF::LoadU( pSrc + i + VecF::WIDTH * 3 );
+
+        for( int iTap = 1; iTap < iKernelDiameter; ++iTap )
+        {
+            const float* pTap = pSrc + i + iTap;
+            W = VecF::Set1( pWeights[iTap] );
+            Sum0 = MulAdd( W, VecF::LoadU( pTap ), Sum0 );
+            Sum1 = MulAdd( W, VecF::LoadU( pTap + VecF::WIDTH ), Sum1 );
+            Sum2 = MulAdd( W, VecF::LoadU( pTap + VecF::WIDTH * 2 ), Sum2 );
+            Sum3 = MulAdd( W, VecF::LoadU( pTap + VecF::WIDTH * 3 ), Sum3 );
+        }
+
+        Sum0.StoreU( pDst + i );
+        Sum1.StoreU( pDst + i + VecF::WIDTH );
+        Sum2.StoreU( pDst + i + VecF::WIDTH * 2 );
+        Sum3.StoreU( pDst + i + VecF::WIDTH * 3 );
+    }
+
+    for( ; i + VecF::WIDTH <= iCount; i += VecF::WIDTH )
+    {
+        VecF Sum = VecF::Set1( pWeights[0] ) * VecF::LoadU( pSrc + i );
+
+        for( int iTap = 1; iTap < iKernelDiameter; ++iTap )
+        {
+            Sum = MulAdd( VecF::Set1( pWeights[iTap] ), VecF::LoadU( pSrc + i + iTap ), Sum );
+        }
+
+        Sum.StoreU( pDst + i );
+    }
+
+    for( ; i < iCount; ++i )
+    {
+        float fSum = 0.0f;
+
+        for( int iTap = 0; iTap < iKernelDiameter; ++iTap )
+        {
+            fSum += pWeights[iTap] * pSrc[i + iTap];
+        }
+
+        pDst[i] = fSum;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// GaussianColumn over rows of a single plane, where every lane is a pixel of the same
+// channel, so there is no alpha to replace
+//--------------------------------------------------------------------------------------
+static void GaussianColumnPlane( const float* pWeights, int iKernelDiameter, const float* const* ppRows, int iCount, float* pOutput )
+{
+    int i = 0;
+
+    for( ; i + 4 * VecF::WIDTH <= iCount; i += 4 * VecF::WIDTH )
+    {
+        VecF W = VecF::Set1( pWeights[0] );
+        const float* pRow = ppRows[0] + i;
+        VecF Sum0 = W * VecF::LoadU( pRow );
+        VecF Sum1 = W * VecF::LoadU( pRow + VecF::WIDTH );
+        VecF Sum2 = W * VecF::LoadU( pRow + VecF::WIDTH * 2 );
+        VecF Sum3 = W * VecF::LoadU( pRow + VecF::WIDTH * 3 );
+
+        for( int iTap = 1; iTap < iKernelDiameter; ++iTap )
+        {
+            W = VecF::Set1( pWeights[iTap] );
+            pRow = ppRows[iTap] + i;
+            Sum0 = MulAdd( W, VecF::LoadU( pRow ), Sum0 );
+            Sum1 = MulAdd( W, VecF::LoadU( pRow + VecF::WIDTH ), Sum1 );
+            Sum2 = MulAdd( W, VecF::LoadU( pRow + VecF::WIDTH * 2 ), Sum2 );
+            Sum3 = MulAdd( W, VecF::LoadU( pRow + VecF::WIDTH * 3 ), Sum3 );
+        }
+
+        Sum0.StoreU( pOutput + i );
+        Sum1.StoreU( pOutput + i + VecF::WIDTH );
+        Sum2.StoreU( pOutput + i + VecF::WIDTH * 2 );
+        Sum3.StoreU( pOutput + i + VecF::WIDTH * 3 );
+    }
+
+    for( ; i + VecF::WIDTH <= iCount; i += VecF::WIDTH )
+    {
+        VecF Sum = VecF::Set1( pWeights[0] ) * VecF::LoadU( ppRows[0] + i );
+
+        for( int iTap = 1; iTap < iKernelDiameter; ++iTap )
+        {
+            Sum = MulAdd( VecF::Set1( pWeights[iTap] ), VecF::LoadU( ppRows[iTap] + i ), Sum );
+        }
+
+        Sum.StoreU( pOutput + i );
+    }
+
+    for( ; i < iCount; ++i )
+    {
+        float fSum = 0.0f;
+
+        for( int iTap = 0; iTap < iKernelDiameter; ++iTap )
+        {
+            fSum += pWeights[iTap] * ppRows[iTap][i];
+        }
+
+        pOutput[i] = fSum;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Converts iCount floats of interleaved texels to unorm, as the LDS of the reduced
+// LDS_PRECISION modes stores them. Rounds to nearest, where Float3ToUint truncates.
+//--------------------------------------------------------------------------------------
+template< typename UNORM >
+static inline void PackRowUNorm( const float* pSrc, int iCount, UNORM* pDst )
+{
+    const float fRange = (float)(UNORM)~0u;
+    const VecF Range = VecF::Set1( fRange );
+    const VecF Zero = VecF::Zero();
+    int i = 0;
+
+    for( ; i + VecF::WIDTH <= iCount; i += VecF::WIDTH )
+    {
+        StoreUNorm( pDst + i, Max( Min( VecF::LoadU( pSrc + i ) * Range, Range ), Zero ) );
+    }
+
+    for( ; i < iCount; ++i )
+    {
+        const float fValue = pSrc[i] * fRange;
+        pDst[i] = (UNORM)( ( ( fValue > 0.0f ) ? ( ( fValue < fRange ) ? fValue : fRange ) : 0.0f ) + 0.5f );
+    }
+}
+
+static void PackRowUNorm8( const float* pSrc, int iCount, unsigned char* pDst ) { PackRowUNorm( pSrc, iCount, pDst ); }
+static void PackRowUNorm16( const float* pSrc, int iCount, unsigned short* pDst ) { PackRowUNorm( pSrc, iCount, pDst ); }
+
+
+//--------------------------------------------------------------------------------------
+// Converts iCount floats to halves, and back
+//--------------------------------------------------------------------------------------
+static void FloatToHalfRow( const float* pSrc, int iCount, unsigned short* pDst )
+{
+    int i = 0;
+
+    for( ; i + VecF::WIDTH <= iCount; i += VecF::WIDTH )
+    {
+        StoreHalf( pDst + i, VecF::LoadU( pSrc + i ) );
+    }
+
+    for( ; i < iCount; ++i )
+    {
+        pDst[i] = FloatToHalf( pSrc[i] );
+    }
+}
+
+static void HalfToFloatRow( const unsigned short* pSrc, int iCount, float* pDst )
+{
+    int i = 0;
+
+    for( ; i + VecF::WIDTH <= iCount; i += VecF::WIDTH )
+    {
+        LoadHalf( pSrc + i ).StoreU( pDst + i );
+    }
+
+    for( ; i < iCount; ++i )
+    {
+        pDst[i] = HalfToFloat( pSrc[i] );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Formats of the rows read by GaussianColumnPacked: the type of a channel, how to load it
+// and the scale that brings it back to the float it was packed from
+//--------------------------------------------------------------------------------------
+template< typename UNORM >
+struct PackedUNorm
+{
+    typedef UNORM Type;
+    static float Scale() { return 1.0f / (float)(UNORM)~0u; }
+    static VecF Load( const UNORM* p ) { return LoadUNorm( p ); }
+    static float LoadScalar( const UNORM* p ) { return (float)*p; }
+};
+
+struct PackedHalf
+{
+    typedef unsigned short Type;
+    static float Scale() { return 1.0f; }
+    static VecF Load( const unsigned short* p ) { return LoadHalf( p ); }
+    static float LoadScalar( const unsigned short* p ) { return HalfToFloat( *p ); }
+};
+
+
+//--------------------------------------------------------------------------------------
+// GaussianColumn over packed rows. The scale back to floats is folded into the weights,
+// so the only extra work per tap is the conversion of the loads.
+//--------------------------------------------------------------------------------------
+template< typename FORMAT >
+static inline void GaussianColumnPacked( const float* pWeights, int iKernelDiameter, const typename FORMAT::Type* const* ppRows, int iCount, float* pOutput )
+{
+    typedef typename FORMAT::Type Item;
+
+    float fWeights[MAX_KERNEL_RADIUS * 2 + 1];
+    for( int iTap = 0; iTap < iKernelDiameter; ++iTap )
+    {
+        fWeights[iTap] = pWeights[iTap] * FORMAT::Scale();
+    }
+
+    int i = 0;
+
+    for( ; i + 4 * VecF::WIDTH <= iCount; i += 4 * VecF::WIDTH )
+    {
+        VecF W = VecF::Set1( fWeights[0] );
+        const Item* pRow = ppRows[0] + i;
+        VecF Sum0 = W * FORMAT::Load( pRow );
+        VecF Sum1 = W * FORMAT::Load( pRow + VecF::WIDTH );
+        VecF Sum2 = W * FORMAT::Load( pRow + VecF::WIDTH * 2 );
+        VecF Sum3 = W * FORMAT::Load( pRow + VecF::WIDTH * 3 );
+
+        for( int iTap = 1; iTap < iKernelDiameter; ++iTap )
+        {
+            W = VecF::Set1( fWeights[iTap] );
+            pRow = ppRows[iTap] + i;
+            Sum0 = MulAdd( W, FORMAT::Load( pRow ), Sum0 );
+            Sum1 = MulAdd( W, FORMAT::Load( pRow + VecF::WIDTH ), Sum1 );
+            Sum2 = MulAdd( W, FORMAT::Load( pRow + VecF::WIDTH * 2 ), Sum2 );
+            Sum3 = MulAdd( W, FORMAT::Load( pRow + VecF::WIDTH * 3 ), Sum3 );
+        }
+
+        StoreColumnOutput( pOutput, i, Sum0 );
+        StoreColumnOutput( pOutput, i + VecF::WIDTH, Sum1 );
+        StoreColumnOutput( pOutput, i + VecF::WIDTH * 2, Sum2 );
+        StoreColumnOutput( pOutput, i + VecF::WIDTH * 3, Sum3 );
+    }
+
+    for( ; i + VecF::WIDTH <= iCount; i += VecF::WIDTH )
+    {
+        VecF Sum = VecF::Set1( fWeights[0] ) * FORMAT::Load( ppRows[0] + i );
+
+        for( int iTap = 1; iTap < iKernelDiameter; ++iTap )
+        {
+            Sum = MulAdd( VecF::Set1( fWeights[iTap] ), FORMAT::Load( ppRows[iTap] + i ), Sum );
+        }
+
+        StoreColumnOutput( pOutput, i, Sum );
+    }
+
+    for( ; i < iCount; ++i )
+    {
+        float fSum = 0.0f;
+
+        for( int iTap = 0; iTap < iKernelDiameter; ++iTap )
+        {
+            fSum += fWeights[iTap] * FORMAT::LoadScalar( ppRows[iTap] + i );
+        }
+
+        pOutput[i] = s_fColorMask[i & 3] * fSum + s_fAlphaOne[i & 3];
+    }
+}
+
+static void GaussianColumnUNorm8( const float* pWeights, int iKernelDiameter, const unsigned char* const* ppRows, int iCount, float* pOutput )
+{
+    GaussianColumnPacked< PackedUNorm< unsigned char > >( pWeights, iKernelDiameter, ppRows, iCount, pOutput );
+}
+
+static void GaussianColumnUNorm16( const float* pWeights, int iKernelDiameter, const unsigned short* const* ppRows, int iCount, float* pOutput )
+{
+    GaussianColumnPacked< PackedUNorm< unsigned short > >( pWeights, iKernelDiameter, ppRows, iCount, pOutput );
+}
+
+static void GaussianColumnHalf( const float* pWeights, int iKernelDiameter, const unsigned short* const* ppRows, int iCount, float* pOutput )
+{
+    GaussianColumnPacked< PackedHalf >( pWeights, iKernelDiameter, ppRows, iCount, pOutput );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Widens iCount 8 bit unorm channels to 16 bits, for the fixed point kernels
+//--------------------------------------------------------------------------------------
+static void WidenRowUNorm8( const unsigned char* pSrc, int iCount, short* pDst )
+{
+    int i = 0;
+
+    for( ; i + VecI::WIDTH * 2 <= iCount; i += VecI::WIDTH * 2 )
+    {
+        VecI::LoadUNorm8( pSrc + i ).StoreI16( pDst + i );
+    }
+
+    for( ; i < iCount; ++i )
+    {
+        pDst[i] = (short)pSrc[i];
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Pairs up iCount 16 bit channels of two rows, so that a pair of taps can be weighted by
+// a single pmaddwd
+//--------------------------------------------------------------------------------------
+static void PairRows16( const short* pFirst, const short* pSecond, int iCount, int* pDst )
+{
+    int i = 0;
+
+    for( ; i + VecI::WIDTH * 2 <= iCount; i += VecI::WIDTH * 2 )
+    {
+        StorePairs( pDst + i, VecI::LoadI16( pFirst + i ), VecI::LoadI16( pSecond + i ) );
+    }
+
+    for( ; i < iCount; ++i )
+    {
+        pDst[i] = (int)( (unsigned int)(unsigned short)pFirst[i] | ( (unsigned int)(unsigned short)pSecond[i] << 16 ) );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Outputs of GaussianFixedPoint: saturated to 16 bits for the lines between the passes,
+// or to 8 bit unorm for the output
+//--------------------------------------------------------------------------------------
+static inline void StoreFixedPoint( short* p, VecI Lo, VecI Hi ) { StoreI16( p, Lo, Hi ); }
+static inline void StoreFixedPoint( unsigned char* p, VecI Lo, VecI Hi ) { StoreUNorm8( p, Lo, Hi ); }
+static inline void StoreFixedPoint( short* p, int iValue ) { *p = (short)Clamp( iValue, -32768, 32767 ); }
+static inline void StoreFixedPoint( unsigned char* p, int iValue ) { *p = (unsigned char)Clamp( iValue, 0, 255 ); }
+
+
+//--------------------------------------------------------------------------------------
+// Convolves iCount channels of rows paired up by PairRows16 with pairs of 16 bit weights.
+// Each pmaddwd weights both taps of WIDTH channels and adds them into 32 bits, so the
+// taps cost a load, a pmaddwd and an add per pair. The sums are rounded and shifted right
+// by SHIFT.
+//--------------------------------------------------------------------------------------
+template< int SHIFT, typename Output >
+static inline void GaussianFixedPoint( const int* pWeightPairs, int iNumPairs, const int* const* ppPairs, int iCount, Output* pOutput )
+{
+    const int iRound = 1 << ( SHIFT - 1 );
+    const VecI Round = VecI::Set1( iRound );
+    int i = 0;
+
+    for( ; i + VecI::WIDTH * 4 <= iCount; i += VecI::WIDTH * 4 )
+    {
+        VecI Sum0 = Round;
+        VecI Sum1 = Round;
+        VecI Sum2 = Round;
+        VecI Sum3 = Round;
+
+        for( int iPair = 0; iPair < iNumPairs; ++iPair )
+        {
+            const VecI Weights = VecI::Set1( pWeightPairs[iPair] );
+            const int* pPairs = ppPairs[iPair] + i;
+            Sum0 = Sum0 + MulAddPairs( VecI::Load( pPairs ), Weights );
+            Sum1 = Sum1 + MulAddPairs( VecI::Load( pPairs + VecI::WIDTH ), Weights );
+            Sum2 = Sum2 + MulAddPairs( VecI::Load( pPairs + VecI::WIDTH * 2 ), Weights );
+            Sum3 = Sum3 + MulAddPairs( VecI::Load( pPairs + VecI::WIDTH * 3 ), Weights );
+        }
+
+        StoreFixedPoint( pOutput + i, ShiftRight( Sum0, SHIFT ), ShiftRight( Sum1, SHIFT ) );
+        StoreFixedPoint( pOutput + i + VecI::WIDTH * 2, ShiftRight( Sum2, SHIFT ), ShiftRight( Sum3, SHIFT ) );
+    }
+
+    for( ; i + VecI::WIDTH * 2 <= iCount; i += VecI::WIDTH * 2 )
+    {
+        VecI Sum0 = Round;
+        VecI Sum1 = Round;
+
+        for( int iPair = 0; iPair < iNumPairs; ++iPair )
+        {
+            const VecI Weights = VecI::Set1( pWeightPairs[iPair] );
+            const int* pPairs = ppPairs[iPair] + i;
+            Sum0 = Sum0 + MulAddPairs( VecI::Load( pPairs ), Weights );
+            Sum1 = Sum1 + MulAddPairs( VecI::Load( pPairs + VecI::WIDTH ), Weights );
+        }
+
+        StoreFixedPoint( pOutput + i, ShiftRight( Sum0, SHIFT ), ShiftRight( Sum1, SHIFT ) );
+    }
+
+    for( ; i < iCount; ++i )
+    {
+        int iSum = iRound;
+
+        for( int iPair = 0; iPair < iNumPairs; ++iPair )
+        {
+            const int iWeights = pWeightPairs[iPair];
+            const int iChannels = ppPairs[iPair][i];
+            iSum += (short)( iWeights & 0xFFFF ) * (short)( iChannels & 0xFFFF ) + ( iWeights >> 16 ) * ( iChannels >> 16 );
+        }
+
+        StoreFixedPoint( pOutput + i, iSum >> SHIFT );
+    }
+}
+
+// Rows of 8 bit channels are filtered to lines of FIXED_POINT_LINE_BITS fractional bits,
+// and the lines back to 8 bits
+static void GaussianFixedPointRow( const int* pWeightPairs, int iNumPairs, const int* const* ppPairs, int iCount, short* pOutput )
+{
+    GaussianFixedPoint< FIXED_POINT_WEIGHT_BITS - FIXED_POINT_LINE_BITS >( pWeightPairs, iNumPairs, ppPairs, iCount, pOutput );
+}
+
+static void GaussianFixedPointColumn( const int* pWeightPairs, int iNumPairs, const int* const* ppPairs, int iCount, unsigned char* pOutput )
+{
+    GaussianFixedPoint< FIXED_POINT_WEIGHT_BITS + FIXED_POINT_LINE_BITS >( pWeightPairs, iNumPairs, ppPairs, iCount, pOutput );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Taps FIRST_TAP to FIRST_TAP + NUM_TAPS - 1 of the kernels of one radius, fully unrolled
+// with the weights as constants. The taps are split in halves rather than peeled one at a
+// time, so the inlining depth is only log2 of the kernel diameter.
+//--------------------------------------------------------------------------------------
+template< int RADIUS, int FIRST_TAP, int NUM_TAPS >
+struct GaussianTaps
+{
+    typedef GaussianTaps< RADIUS, FIRST_TAP, NUM_TAPS / 2 > Lower;
+    typedef GaussianTaps< RADIUS, FIRST_TAP + NUM_TAPS / 2, NUM_TAPS - NUM_TAPS / 2 > Upper;
+
+    static CPUFILTER_FORCEINLINE void Row( const float* pRed, const float* pGreen, const float* pBlue, VecF& R0, VecF& G0, VecF& B0, VecF& R1, VecF& G1, VecF& B1 )
+    {
+        Lower::Row( pRed, pGreen, pBlue, R0, G0, B0, R1, G1, B1 );
+        Upper::Row( pRed, pGreen, pBlue, R0, G0, B0, R1, G1, B1 );
+    }
+
+    static CPUFILTER_FORCEINLINE void Row( const float* pRed, const float* pGreen, const float* pBlue, VecF& R, VecF& G, VecF& B )
+    {
+        Lower::Row( pRed, pGreen, pBlue, R, G, B );
+        Upper::Row( pRed, pGreen, pBlue, R, G, B );
+    }
+
+    static CPUFILTER_FORCEINLINE void Column( const float* const* ppRows, int i, VecF& Sum0, VecF& Sum1, VecF& Sum2, VecF& Sum3 )
+    {
+        Lower::Column( ppRows, i, Sum0, Sum1, Sum2, Sum3 );
+        Upper::Column( ppRows, i, Sum0, Sum1, Sum2, Sum3 );
+    }
+
+    static CPUFILTER_FORCEINLINE void Column( const float* const* ppRows, int i, VecF& Sum )
+    {
+        Lower::Column( ppRows, i, Sum );
+        Upper::Column( ppRows, i, Sum );
+    }
+};
+
+template< int RADIUS, int TAP >
+struct GaussianTaps< RADIUS, TAP, 1 >
+{
+    static CPUFILTER_FORCEINLINE float Weight() { return s_fGaussianWeights[RADIUS / 2 - 1][TAP]; }
+
+    static CPUFILTER_FORCEINLINE void Row( const float* pRed, const float* pGreen, const float* pBlue, VecF& R0, VecF& G0, VecF& B0, VecF& R1, VecF& G1, VecF& B1 )
+    {
+        const VecF W = VecF::Set1( Weight() );
+        R0 = MulAdd( W, VecF::LoadU( pRed + TAP ), R0 );
+        G0 = MulAdd( W, VecF::LoadU( pGreen + TAP ), G0 );
+        B0 = MulAdd( W, VecF::LoadU( pBlue + TAP ), B0 );
+        R1 = MulAdd( W, VecF::LoadU( pRed + TAP + VecF::WIDTH ), R1 );
+        G1 = MulAdd( W, VecF::LoadU( pGreen + TAP + VecF::WIDTH ), G1 );
+        B1 = MulAdd( W, VecF::LoadU( pBlue + TAP + VecF::WIDTH ), B1 );
+    }
+
+    static CPUFILTER_FORCEINLINE void Row( const float* pRed, const float* pGreen, const float* pBlue, VecF& R, VecF& G, VecF& B )
+    {
+        const VecF W = VecF::Set1( Weight() );
+        R = MulAdd( W, VecF::LoadU( pRed + TAP ), R );
+        G = MulAdd( W, VecF::LoadU( pGreen + TAP ), G );
+        B = MulAdd( W, VecF::LoadU( pBlue + TAP ), B );
+    }
+
+    static CPUFILTER_FORCEINLINE void Column( const float* const* ppRows, int i, VecF& Sum0, VecF& Sum1, VecF& Sum2, VecF& Sum3 )
+    {
+        const VecF W = VecF::Set1( Weight() );
+        const float* pRow = ppRows[TAP] + i;
+        Sum0 = MulAdd( W, VecF::LoadU( pRow ), Sum0 );
+        Sum1 = MulAdd( W, VecF::LoadU( pRow + VecF::WIDTH ), Sum1 );
+        Sum2 = MulAdd( W, VecF::LoadU( pRow + VecF::WIDTH * 2 ), Sum2 );
+        Sum3 = MulAdd( W, VecF::LoadU( pRow + VecF::WIDTH * 3 ), Sum3 );
+    }
+
+    static CPUFILTER_FORCEINLINE void Column( const float* const* ppRows, int i, VecF& Sum )
+    {
+        Sum = MulAdd( VecF::Set1( Weight() ), VecF::LoadU( ppRows[TAP] + i ), Sum );
+    }
+};
+
+
+//--------------------------------------------------------------------------------------
+// GaussianRow for the radius of one KERNEL_RADIUS_TYPE. The sums start from zero, so the
+// first multiply-add rounds the same as the multiply of GaussianRow, and the results match.
+//--------------------------------------------------------------------------------------
+template< int RADIUS >
+static void GaussianRowFixed( const float* /*pWeights*/, int /*iKernelDiameter*/, const float* pRed, const float* pGreen, const float* pBlue, int iNumPixels, Float4* pOutput )
+{
+    typedef GaussianTaps< RADIUS, 0, RADIUS * 2 + 1 > Taps;
+
+    const VecF One = VecF::Set1( 1.0f );
+    int iPixel = 0;
+
+    for( ; iPixel + VecF::WIDTH < iNumPixels; iPixel += 2 * VecF::WIDTH )
+    {
+        VecF R0 = VecF::Zero(), G0 = VecF::Zero(), B0 = VecF::Zero();
+        VecF R1 = VecF::Zero(), G1 = VecF::Zero(), B1 = VecF::Zero();
+        Taps::Row( pRed + iPixel, pGreen + iPixel, pBlue + iPixel, R0, G0, B0, R1, G1, B1 );
+
+        StoreOutput( pOutput + iPixel, iNumPixels - iPixel, R0, G0, B0, One );
+        StoreOutput( pOutput + iPixel + VecF::WIDTH, iNumPixels - iPixel - VecF::WIDTH, R1, G1, B1, One );
+    }
+
+    for( ; iPixel < iNumPixels; iPixel += VecF::WIDTH )
+    {
+        VecF R = VecF::Zero(), G = VecF::Zero(), B = VecF::Zero();
+        Taps::Row( pRed + iPixel, pGreen + iPixel, pBlue + iPixel, R, G, B );
+
+        StoreOutput( pOutput + iPixel, iNumPixels - iPixel, R, G, B, One );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// GaussianColumn for the radius of one KERNEL_RADIUS_TYPE
+//--------------------------------------------------------------------------------------
+template< int RADIUS >
+static void GaussianColumnFixed( const float* /*pWeights*/, int /*iKernelDiameter*/, const float* const* ppRows, int iCount, float* pOutput )
+{
+    typedef GaussianTaps< RADIUS, 0, RADIUS * 2 + 1 > Taps;
+
+    int i = 0;
+
+    for( ; i + 4 * VecF::WIDTH <= iCount; i += 4 * VecF::WIDTH )
+    {
+        VecF Sum0 = VecF::Zero(), Sum1 = VecF::Zero(), Sum2 = VecF::Zero(), Sum3 = VecF::Zero();
+        Taps::Column( ppRows, i, Sum0, Sum1, Sum2, Sum3 );
+
+        StoreColumnOutput( pOutput, i, Sum0 );
+        StoreColumnOutput( pOutput, i + VecF::WIDTH, Sum1 );
+        StoreColumnOutput( pOutput, i + VecF::WIDTH * 2, Sum2 );
+        StoreColumnOutput( pOutput, i + VecF::WIDTH * 3, Sum3 );
+    }
+
+    for( ; i + VecF::WIDTH <= iCount; i += VecF::WIDTH )
+    {
+        VecF Sum = VecF::Zero();
+        Taps::Column( ppRows, i, Sum );
+
+        StoreColumnOutput( pOutput, i, Sum );
+    }
+
+    for( ; i < iCount; ++i )
+    {
+        float fSum = 0.0f;
+
+        for( int iTap = 0; iTap < RADIUS * 2 + 1; ++iTap )
+        {
+            fSum += s_fGaussianWeights[RADIUS / 2 - 1][iTap] * ppRows[iTap][i];
+        }
+
+        pOutput[i] = s_fColorMask[i & 3] * fSum + s_fAlphaOne[i & 3];
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Dispatch tables of the kernels above, indexed by KERNEL_RADIUS_TYPE. These only hold
+// addresses, so are initialized statically, without running any code.
+//--------------------------------------------------------------------------------------
+static const PFN_GAUSSIAN_ROW s_pfnGaussianRowFixed[KERNEL_RADIUS_TYPE_MAX] =
+{
+    GaussianRowFixed< 2 >,  GaussianRowFixed< 4 >,  GaussianRowFixed< 6 >,  GaussianRowFixed< 8 >,
+    GaussianRowFixed< 10 >, GaussianRowFixed< 12 >, GaussianRowFixed< 14 >, GaussianRowFixed< 16 >,
+    GaussianRowFixed< 18 >, GaussianRowFixed< 20 >, GaussianRowFixed< 22 >, GaussianRowFixed< 24 >,
+    GaussianRowFixed< 26 >, GaussianRowFixed< 28 >, GaussianRowFixed< 30 >, GaussianRowFixed< 32 >
+};
+
+static const PFN_GAUSSIAN_COLUMN s_pfnGaussianColumnFixed[KERNEL_RADIUS_TYPE_MAX] =
+{
+    GaussianColumnFixed< 2 >,  GaussianColumnFixed< 4 >,  GaussianColumnFixed< 6 >,  GaussianColumnFixed< 8 >,
+    GaussianColumnFixed< 10 >, GaussianColumnFixed< 12 >, GaussianColumnFixed< 14 >, GaussianColumnFixed< 16 >,
+    GaussianColumnFixed< 18 >, GaussianColumnFixed< 20 >, GaussianColumnFixed< 22 >, GaussianColumnFixed< 24 >,
+    GaussianColumnFixed< 26 >, GaussianColumnFixed< 28 >, GaussianColumnFixed< 30 >, GaussianColumnFixed< 32 >
+};
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,385 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: GaussianPyramid.cpp
+//
+// Implements the downsample, blur and upsample pyramid.
+//--------------------------------------------------------------------------------------
+
+
+#include "GaussianPyramid.h"
+#include "GaussianFilter.h"
+
+
+namespace CPUFilter
+{
+    // Variances of the downsample and upsample, in texels squared at the finer level
+    static const double DOWNSAMPLE_VARIANCE     = 0.75;
+    static const double UPSAMPLE_VARIANCE       = 2.0 / 3.0;
+
+    // Of the coarse kernel's weight, as g_fGaussianTolerance in the sample
+    static const float  COARSE_TOLERANCE        = 0.001f;
+
+
+    //--------------------------------------------------------------------------------------
+    // Adds levels until the deviation left fits the coarse kernel
+    //--------------------------------------------------------------------------------------
+    int ComputePyramidLevels( float fDeviation, float fMaxCoarseDeviation, float* pCoarseDeviation, unsigned int uWidth, unsigned int uHeight )
+    {
+        assert( fDeviation > 0.0f && fMaxCoarseDeviation > 0.0f );
+
+        // Stop before a level would be under 2 texels across
+        int iMaxLevels = MAX_PYRAMID_LEVELS;
+        if( uWidth > 0 && uHeight > 0 )
+        {
+            unsigned int uSize = ( uWidth < uHeight ) ? uWidth : uHeight;
+            for( iMaxLevels = 0; iMaxLevels < MAX_PYRAMID_LEVELS && uSize >= 4; ++iMaxLevels )
+            {
+                uSize = DivRoundUp( uSize, 2 );
+            }
+        }
+
+        // Level l halves texels of 2^l full resolution texels, so its passes add their
+        // variances times 4^l, and the coarse deviation is in texels of 2^L
+        const double dVariance = (double)fDeviation * (double)fDeviation;
+        const double dMaxCoarseVariance = (double)fMaxCoarseDeviation * (double)fMaxCoarseDeviation;
+        double dPyramidVariance = 0.0;
+        double dScale = 1.0;
+        double dCoarseVariance = dVariance;
+        int iNumLevels = 0;
+
+        while( iNumLevels < iMaxLevels && dCoarseVariance > dMaxCoarseVariance )
+        {
+            dPyramidVariance += ( DOWNSAMPLE_VARIANCE + UPSAMPLE_VARIANCE ) * dScale;
+            dScale *= 4.0;
+            ++iNumLevels;
+
+            dCoarseVariance = ( dVariance - dPyramidVariance ) / dScale;
+        }
+
+        // Keep at least half a texel, for a kernel that still blurs
+        if( NULL != pCoarseDeviation )
+        {
+            *pCoarseDeviation = ( dCoarseVariance > 0.25 ) ? (float)sqrt( dCoarseVariance ) : 0.5f;
+        }
+
+        return iNumLevels;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Same dispatch as CSFilterX, over the output
+    //--------------------------------------------------------------------------------------
+    void PyramidDownsample::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = DivRoundUp( (unsigned int)OutputWidth(), RUN_SIZE );
+        uY = DivRoundUp( (unsigned int)OutputHeight(), RUN_LINES );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Filters the 4 input lines of each output line horizontally at the kept texels only,
+    // then combines them vertically
+    //--------------------------------------------------------------------------------------
+    void PyramidDownsample::ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& /*LDS*/ ) const
+    {
+        const Surface& Input = *m_pInputs[0];
+        const int iLastX = (int)Input.m_uWidth - 1;
+        const int iLastY = (int)Input.m_uHeight - 1;
+        const int iGroupCoordX = (int)uGroupX * RUN_SIZE;
+        const int iNumPixels = ( OutputWidth() - iGroupCoordX < RUN_SIZE ) ? ( OutputWidth() - iGroupCoordX ) : RUN_SIZE;
+        const float fScale = 1.0f / 64.0f;
+
+        assert( DivRoundUp( Input.m_uWidth, 2 ) >= (unsigned int)OutputWidth() && DivRoundUp( Input.m_uHeight, 2 ) >= (unsigned int)OutputHeight() );
+
+        for( int iLine = 0; iLine < RUN_LINES; ++iLine )
+        {
+            const int iY = (int)uGroupY * RUN_LINES + iLine;
+            if( iY >= OutputHeight() )
+            {
+                break;
+            }
+
+            const float* pRows[4];
+            for( int iRow = 0; iRow < 4; ++iRow )
+            {
+                pRows[iRow] = &Input.Row( Clamp( iY * 2 - 1 + iRow, 0, iLastY ) )->x;
+            }
+
+            Float4* pOutput = m_pOutput->Row( iY ) + iGroupCoordX;
+
+            for( int iPixel = 0; iPixel < iNumPixels; ++iPixel )
+            {
+                const int iX = ( iGroupCoordX + iPixel ) * 2;
+                const int iX0 = Clamp( iX - 1, 0, iLastX ) * 4;
+                const int iX1 = iX * 4;
+                const int iX2 = Clamp( iX + 1, 0, iLastX ) * 4;
+                const int iX3 = Clamp( iX + 2, 0, iLastX ) * 4;
+
+                float fSum[4];
+                for( int c = 0; c < 4; ++c )
+                {
+                    float fRow[4];
+                    for( int iRow = 0; iRow < 4; ++iRow )
+                    {
+                        const float* pRow = pRows[iRow];
+                        fRow[iRow] = pRow[iX0 + c] + 3.0f * ( pRow[iX1 + c] + pRow[iX2 + c] ) + pRow[iX3 + c];
+                    }
+
+                    fSum[c] = ( fRow[0] + 3.0f * ( fRow[1] + fRow[2] ) + fRow[3] ) * fScale;
+                }
+
+                pOutput[iPixel] = MakeFloat4( fSum[0], fSum[1], fSum[2], fSum[3] );
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Same dispatch as CSFilterX, over the output
+    //--------------------------------------------------------------------------------------
+    void PyramidUpsample::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = DivRoundUp( (unsigned int)OutputWidth(), RUN_SIZE );
+        uY = DivRoundUp( (unsigned int)OutputHeight(), RUN_LINES );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Output texel x lies at coarse texel x / 2 - 1/4, so it takes 3/4 of the nearest coarse
+    // texel and 1/4 of the next one out, per axis
+    //--------------------------------------------------------------------------------------
+    void PyramidUpsample::ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& /*LDS*/ ) const
+    {
+        const Surface& Input = *m_pInputs[0];
+        const int iLastX = (int)Input.m_uWidth - 1;
+        const int iLastY = (int)Input.m_uHeight - 1;
+        const int iGroupCoordX = (int)uGroupX * RUN_SIZE;
+        const int iNumPixels = ( OutputWidth() - iGroupCoordX < RUN_SIZE ) ? ( OutputWidth() - iGroupCoordX ) : RUN_SIZE;
+
+        assert( Input.m_uWidth >= DivRoundUp( (unsigned int)OutputWidth(), 2 ) && Input.m_uHeight >= DivRoundUp( (unsigned int)OutputHeight(), 2 ) );
+
+        for( int iLine = 0; iLine < RUN_LINES; ++iLine )
+        {
+            const int iY = (int)uGroupY * RUN_LINES + iLine;
+            if( iY >= OutputHeight() )
+            {
+                break;
+            }
+
+            const int iNearY = Clamp( iY >> 1, 0, iLastY );
+            const int iFarY = Clamp( ( iY & 1 ) ? ( iNearY + 1 ) : ( iNearY - 1 ), 0, iLastY );
+            const float* pNear = &Input.Row( iNearY )->x;
+            const float* pFar = &Input.Row( iFarY )->x;
+
+            Float4* pOutput = m_pOutput->Row( iY ) + iGroupCoordX;
+
+            for( int iPixel = 0; iPixel < iNumPixels; ++iPixel )
+            {
+                const int iX = iGroupCoordX + iPixel;
+                const int iNearX = Clamp( iX >> 1, 0, iLastX ) * 4;
+                const int iFarX = Clamp( ( iX & 1 ) ? ( ( iX >> 1 ) + 1 ) : ( ( iX >> 1 ) - 1 ), 0, iLastX ) * 4;
+
+                float fSum[4];
+                for( int c = 0; c < 4; ++c )
+                {
+                    const float fNear = 0.75f * pNear[iNearX + c] + 0.25f * pNear[iFarX + c];
+                    const float fFar = 0.75f * pFar[iNearX + c] + 0.25f * pFar[iFarX + c];
+                    fSum[c] = 0.75f * fNear + 0.25f * fFar;
+                }
+
+                pOutput[iPixel] = MakeFloat4( fSum[0], fSum[1], fSum[2], fSum[3] );
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    GaussianPyramid::GaussianPyramid()
+    {
+        m_uWidth = m_uHeight = 0;
+        m_iMaxLevels = 0;
+        m_fDeviation = 16.0f;
+        m_fMaxCoarseDeviation = 4.0f;
+        m_iNumLevels = 0;
+        m_fCoarseDeviation = m_fDeviation;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Allocates every level the size allows, as ComputePyramidLevels, so the deviation can
+    // change without reallocating
+    //--------------------------------------------------------------------------------------
+    bool GaussianPyramid::Create( unsigned int uWidth, unsigned int uHeight )
+    {
+        assert( uWidth > 0 && uHeight > 0 );
+
+        Release();
+
+        m_uWidth = uWidth;
+        m_uHeight = uHeight;
+        m_iMaxLevels = 0;
+
+        unsigned int uLevelWidth = uWidth;
+        unsigned int uLevelHeight = uHeight;
+        while( m_iMaxLevels < MAX_PYRAMID_LEVELS && uLevelWidth >= 4 && uLevelHeight >= 4 )
+        {
+            uLevelWidth = DivRoundUp( uLevelWidth, 2 );
+            uLevelHeight = DivRoundUp( uLevelHeight, 2 );
+
+            if( !m_Levels[m_iMaxLevels].Create( uLevelWidth, uLevelHeight ) )
+            {
+                Release();
+                return false;
+            }
+
+            ++m_iMaxLevels;
+        }
+
+        if( m_iMaxLevels > 0 && !m_Blurred.Create( m_Levels[0].m_uWidth, m_Levels[0].m_uHeight ) )
+        {
+            Release();
+            return false;
+        }
+
+        UpdateLevels();
+
+        return true;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Frees the levels
+    //--------------------------------------------------------------------------------------
+    void GaussianPyramid::Release()
+    {
+        for( int iLevel = 0; iLevel < MAX_PYRAMID_LEVELS; ++iLevel )
+        {
+            m_Levels[iLevel].Release();
+        }
+        m_Blurred.Release();
+
+        m_uWidth = m_uHeight = 0;
+        m_iMaxLevels = 0;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Deviation at full resolution
+    //--------------------------------------------------------------------------------------
+    void GaussianPyramid::SetDeviation( float fDeviation )
+    {
+        assert( fDeviation > 0.0f );
+
+        m_fDeviation = fDeviation;
+        UpdateLevels();
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Largest deviation left for the coarse level, in coarse texels
+    //--------------------------------------------------------------------------------------
+    void GaussianPyramid::SetMaxCoarseDeviation( float fMaxCoarseDeviation )
+    {
+        assert( fMaxCoarseDeviation > 0.0f );
+
+        m_fMaxCoarseDeviation = fMaxCoarseDeviation;
+        UpdateLevels();
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Picks the depth of the pyramid, and the coarse kernel
+    //--------------------------------------------------------------------------------------
+    void GaussianPyramid::UpdateLevels()
+    {
+        m_iNumLevels = ComputePyramidLevels( m_fDeviation, m_fMaxCoarseDeviation, &m_fCoarseDeviation, m_uWidth, m_uHeight );
+
+        m_CoarseFilter.SetDeviation( m_fCoarseDeviation );
+        m_CoarseFilter.SetKernel( ComputeGaussianRadius( m_fCoarseDeviation, COARSE_TOLERANCE ), false );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Halves the input down to the coarse level, blurs it, and doubles it back up to the
+    // output. Each upsample overwrites the level it upsamples to, which the downsamples are
+    // done with.
+    //--------------------------------------------------------------------------------------
+    void GaussianPyramid::OnRender( const Surface& Input, Surface& Output )
+    {
+        assert( &Input != &Output );
+        assert( Input.m_uWidth >= m_uWidth && Input.m_uHeight >= m_uHeight );
+        assert( m_iNumLevels <= m_iMaxLevels );
+
+        if( 0 == m_iNumLevels )
+        {
+            RunPass( &m_CoarseFilter, Input, Output, m_uWidth, m_uHeight );
+            return;
+        }
+
+        const Surface* pFiner = &Input;
+        for( int iLevel = 0; iLevel < m_iNumLevels; ++iLevel )
+        {
+            RunPass( &m_Downsample, *pFiner, m_Levels[iLevel], m_Levels[iLevel].m_uWidth, m_Levels[iLevel].m_uHeight );
+            pFiner = &m_Levels[iLevel];
+        }
+
+        const Surface& Coarse = m_Levels[m_iNumLevels - 1];
+        Surface Blurred;
+        Blurred.CreateView( m_Blurred.m_pData, Coarse.m_uWidth, Coarse.m_uHeight, m_Blurred.m_uPitch );
+        RunPass( &m_CoarseFilter, Coarse, Blurred, Coarse.m_uWidth, Coarse.m_uHeight );
+
+        const Surface* pCoarser = &Blurred;
+        for( int iLevel = m_iNumLevels - 2; iLevel >= 0; --iLevel )
+        {
+            RunPass( &m_Upsample, *pCoarser, m_Levels[iLevel], m_Levels[iLevel].m_uWidth, m_Levels[iLevel].m_uHeight );
+            pCoarser = &m_Levels[iLevel];
+        }
+
+        RunPass( &m_Upsample, *pCoarser, Output, m_uWidth, m_uHeight );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Runs one pass of the chain as the fused filter
+    //--------------------------------------------------------------------------------------
+    void GaussianPyramid::RunPass( FilterPass* pPass, const Surface& Input, Surface& Output, unsigned int uWidth, unsigned int uHeight )
+    {
+        const Surface* pInputs[1] = { &Input };
+
+        m_Filter.SetOutputSize( uWidth, uHeight );
+        m_Filter.SetInputSurfaces( pInputs, pInputs, 1 );
+        m_Filter.SetOutputSurfaces( NULL, &Output );
+        m_Filter.SetFusedFilter( pPass );
+        m_Filter.OnRender();
+        m_Filter.SetFusedFilter( NULL );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,145 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: GaussianPyramid.h
+//
+// Downsample, blur and upsample pyramid for Gaussians too wide for the kernels. The image is
+// halved a number of times by passes that only compute the pixels they keep, blurred by a
+// small kernel at the coarse level, and upsampled back a level at a time, so the cost is
+// roughly that of the full resolution passes whatever the deviation.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "SeparableFilterCPU.h"
+#include "GaussianFilterSIMD.h"
+
+
+namespace CPUFilter
+{
+    // Defines
+    static const int MAX_PYRAMID_LEVELS     = 8;
+
+
+    //--------------------------------------------------------------------------------------
+    // Number of times to halve an image for a Gaussian of fDeviation, so that the deviation
+    // left for the coarse level, in coarse texels, is at most fMaxCoarseDeviation. Each
+    // downsample and upsample is itself a small blur, so their variances (0.75 and 2/3 of a
+    // texel squared at the finer level) are taken off before scaling down. The coarse
+    // deviation is returned in pCoarseDeviation, and may exceed the maximum when the levels
+    // are capped by the size of the image (the smaller of uWidth and uHeight, when given).
+    //--------------------------------------------------------------------------------------
+    int ComputePyramidLevels( float fDeviation, float fMaxCoarseDeviation, float* pCoarseDeviation, unsigned int uWidth = 0, unsigned int uHeight = 0 );
+
+
+    //--------------------------------------------------------------------------------------
+    // Fused blur and decimate: each output texel is the [1 3 3 1] / 8 binomial of the 4 x 4
+    // input texels around its center, which lies between input texels 2i and 2i+1. Only the
+    // kept texels are computed, so the pass reads the input once and writes a quarter of it.
+    // The output size is set through SeparableFilterCPU::SetOutputSize, and is the input size
+    // halved and rounded up.
+    //--------------------------------------------------------------------------------------
+    class PyramidDownsample : public FilterPass
+    {
+    public:
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Bilinear upsample by 2, the CPU equivalent of sampling the coarse level with a linear
+    // sampler: each output texel blends the 2 x 2 nearest coarse texels by 3/4 and 1/4 per
+    // axis.
+    //--------------------------------------------------------------------------------------
+    class PyramidUpsample : public FilterPass
+    {
+    public:
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Runs the whole chain through a SeparableFilterCPU of its own: the downsamples and
+    // upsamples as its fused filter, and a GaussianFilterFused of the coarse deviation at the
+    // coarse level. The deviation can change every frame, as the levels for every depth are
+    // allocated by Create, which add up to a third of the image.
+    //--------------------------------------------------------------------------------------
+    class GaussianPyramid
+    {
+    public:
+
+        GaussianPyramid();
+        ~GaussianPyramid() { Release(); }
+
+        // Allocates the levels for images of the given size
+        bool Create( unsigned int uWidth, unsigned int uHeight );
+        void Release();
+
+        // Deviation of the Gaussian at full resolution, and the largest deviation left for the
+        // coarse level (defaults to 4 texels, a kernel radius of 8)
+        void SetDeviation( float fDeviation );
+        void SetMaxCoarseDeviation( float fMaxCoarseDeviation );
+        float GetDeviation() const { return m_fDeviation; }
+        int GetNumLevels() const { return m_iNumLevels; }
+        float GetCoarseDeviation() const { return m_fCoarseDeviation; }
+
+        // Takes a MAXCORES_TYPE, or an explicit number of threads (defaults to all cores)
+        void SetMaximumCores( int iMaxCores ) { m_Filter.SetMaximumCores( iMaxCores ); }
+
+        // Blurs the input into the output, which must be different surfaces of the created size
+        void OnRender( const Surface& Input, Surface& Output );
+
+    private:
+
+        void UpdateLevels();
+        void RunPass( FilterPass* pPass, const Surface& Input, Surface& Output, unsigned int uWidth, unsigned int uHeight );
+
+        GaussianPyramid( const GaussianPyramid& );
+        GaussianPyramid& operator=( const GaussianPyramid& );
+
+        Surface             m_Levels[MAX_PYRAMID_LEVELS];   // Levels 1 and on, level 0 being the input
+        Surface             m_Blurred;                      // The coarse level blurred, allocated at the size of level 1
+        unsigned int        m_uWidth;
+        unsigned int        m_uHeight;
+        int                 m_iMaxLevels;                   // Allowed by the size of the image
+        float               m_fDeviation;
+        float               m_fMaxCoarseDeviation;
+        int                 m_iNumLevels;
+        float               m_fCoarseDeviation;
+        SeparableFilterCPU  m_Filter;
+        PyramidDownsample   m_Downsample;
+        PyramidUpsample     m_Upsample;
+        GaussianFilterFused m_CoarseFilter;
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,219 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+
+//--------------------------------------------------------------------------------------
+// File: GaussianWeights.h
+//
+// Normalized weights of GaussianFilter.hlsl for every KERNEL_RADIUS_TYPE, as compile time
+// constants for the kernels specialized per radius. These are GaussianWeight() with a
+// deviation of half the radius, divided by their sum in single precision, exactly as
+// GaussianFilterSIMD::SetKernel computes them (which checks them in debug builds).
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+
+
+namespace CPUFilter
+{
+    // Largest kernel of the radius types
+    static const int MAX_KERNEL_RADIUS_TYPE_DIAMETER = KERNEL_RADIUS_TYPE_MAX * 4 + 1;
+
+    //--------------------------------------------------------------------------------------
+    // Returns the radius type of a kernel radius, or KERNEL_RADIUS_TYPE_MAX if it has none
+    //--------------------------------------------------------------------------------------
+    inline KERNEL_RADIUS_TYPE GetKernelRadiusType( int iKernelRadius )
+    {
+        if( iKernelRadius < 2 || iKernelRadius > KERNEL_RADIUS_TYPE_MAX * 2 || 0 != ( iKernelRadius & 1 ) )
+        {
+            return KERNEL_RADIUS_TYPE_MAX;
+        }
+
+        return (KERNEL_RADIUS_TYPE)( iKernelRadius / 2 - 1 );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Indexed by KERNEL_RADIUS_TYPE, then tap (KERNEL_RADIUS is the center)
+    //--------------------------------------------------------------------------------------
+    static const float s_fGaussianWeights[KERNEL_RADIUS_TYPE_MAX][MAX_KERNEL_RADIUS_TYPE_DIAMETER] =
+    {
+        // KERNEL_RADIUS_TYPE_2
+        {
+            5.448868498e-02f, 2.442013472e-01f, 4.026199579e-01f, 2.442013472e-01f, 5.448868498e-02f,
+        },
+        // KERNEL_RADIUS_TYPE_4
+        {
+            2.763055079e-02f, 6.628224254e-02f, 1.238315329e-01f, 1.801738143e-01f, 2.041636854e-01f, 1.801738143e-01f,
+            1.238315329e-01f, 6.628224254e-02f, 2.763055079e-02f,
+        },
+        // KERNEL_RADIUS_TYPE_6
+        {
+            1.854402199e-02f, 3.416694328e-02f, 5.633176491e-02f, 8.310854435e-02f, 1.097192988e-01f, 1.296180338e-01f,
+            1.370228231e-01f, 1.296180338e-01f, 1.097192988e-01f, 8.310854435e-02f, 5.633176491e-02f, 3.416694328e-02f,
+            1.854402199e-02f,
+        },
+        // KERNEL_RADIUS_TYPE_8
+        {
+            1.396018919e-02f, 2.230831794e-02f, 3.348875046e-02f, 4.722670838e-02f, 6.256522983e-02f, 7.786368579e-02f,
+            9.103186429e-02f, 9.997894615e-02f, 1.031526178e-01f, 9.997894615e-02f, 9.103186429e-02f, 7.786368579e-02f,
+            6.256522983e-02f, 4.722670838e-02f, 3.348875046e-02f, 2.230831794e-02f, 1.396018919e-02f,
+        },
+        // KERNEL_RADIUS_TYPE_10
+        {
+            1.119472552e-02f, 1.636987738e-02f, 2.299881727e-02f, 3.104515746e-02f, 4.026339576e-02f, 5.017128214e-02f,
+            6.006592885e-02f, 6.909226626e-02f, 7.635876536e-02f, 8.108052611e-02f, 8.271846175e-02f, 8.108052611e-02f,
+            7.635876536e-02f, 6.909226626e-02f, 6.006592885e-02f, 5.017128214e-02f, 4.026339576e-02f, 3.104515746e-02f,
+            2.299881727e-02f, 1.636987738e-02f, 1.119472552e-02f,
+        },
+        // KERNEL_RADIUS_TYPE_12
+        {
+            9.344246238e-03f, 1.286107302e-02f, 1.721656322e-02f, 2.241567895e-02f, 2.838531137e-02f, 3.496002033e-02f,
+            4.187800363e-02f, 4.879064113e-02f, 5.528703704e-02f, 6.093213707e-02f, 6.531392038e-02f, 6.809282303e-02f,
+            6.904515624e-02f, 6.809282303e-02f, 6.531392038e-02f, 6.093213707e-02f, 5.528703704e-02f, 4.879064113e-02f,
+            4.187800363e-02f, 3.496002033e-02f, 2.838531137e-02f, 2.241567895e-02f, 1.721656322e-02f, 1.286107302e-02f,
+            9.344246238e-03f,
+        },
+        // KERNEL_RADIUS_TYPE_14
+        {
+            8.018952794e-03f, 1.056258474e-02f, 1.363200229e-02f, 1.723796129e-02f, 2.135743015e-02f, 2.592680231e-02f,
+            3.083796799e-02f, 3.593845293e-02f, 4.103646055e-02f, 4.591104761e-02f, 5.032704398e-02f, 5.405332893e-02f,
+            5.688271672e-02f, 5.865094811e-02f, 5.925249308e-02f, 5.865094811e-02f, 5.688271672e-02f, 5.405332893e-02f,
+            5.032704398e-02f, 4.591104761e-02f, 4.103646055e-02f, 3.593845293e-02f, 3.083796799e-02f, 2.592680231e-02f,
+            2.135743015e-02f, 1.723796129e-02f, 1.363200229e-02f, 1.056258474e-02f, 8.018952794e-03f,
+        },
+        // KERNEL_RADIUS_TYPE_16
+        {
+            7.022995967e-03f, 8.947529830e-03f, 1.122271642e-02f, 1.385820471e-02f, 1.684729196e-02f, 2.016356774e-02f,
+            2.375848964e-02f, 2.756032906e-02f, 3.147488460e-02f, 3.538816422e-02f, 3.917112947e-02f, 4.268627241e-02f,
+            4.579568654e-02f, 4.836988822e-02f, 5.029672384e-02f, 5.148947611e-02f, 5.189331248e-02f, 5.148947611e-02f,
+            5.029672384e-02f, 4.836988822e-02f, 4.579568654e-02f, 4.268627241e-02f, 3.917112947e-02f, 3.538816422e-02f,
+            3.147488460e-02f, 2.756032906e-02f, 2.375848964e-02f, 2.016356774e-02f, 1.684729196e-02f, 1.385820471e-02f,
+            1.122271642e-02f, 8.947529830e-03f, 7.022995967e-03f,
+        },
+        // KERNEL_RADIUS_TYPE_18
+        {
+            6.247154437e-03f, 7.753741927e-03f, 9.505581111e-03f, 1.151024178e-02f, 1.376665756e-02f, 1.626338437e-02f,
+            1.897718012e-02f, 2.187211439e-02f, 2.489935979e-02f, 2.799780481e-02f, 3.109553829e-02f, 3.411226347e-02f,
+            3.696249798e-02f, 3.955946863e-02f, 4.181941226e-02f, 4.366603121e-02f, 4.503476247e-02f, 4.587651044e-02f,
+            4.616057500e-02f, 4.587651044e-02f, 4.503476247e-02f, 4.366603121e-02f, 4.181941226e-02f, 3.955946863e-02f,
+            3.696249798e-02f, 3.411226347e-02f, 3.109553829e-02f, 2.799780481e-02f, 2.489935979e-02f, 2.187211439e-02f,
+            1.897718012e-02f, 1.626338437e-02f, 1.376665756e-02f, 1.151024178e-02f, 9.505581111e-03f, 7.753741927e-03f,
+            6.247154437e-03f,
+        },
+        // KERNEL_RADIUS_TYPE_20
+        {
+            5.625706166e-03f, 6.836983841e-03f, 8.226384409e-03f, 9.799648076e-03f, 1.155763865e-02f, 1.349536795e-02f,
+            1.560118049e-02f, 1.785612479e-02f, 2.023363858e-02f, 2.269958146e-02f, 2.521266788e-02f, 2.772533335e-02f,
+            3.018504195e-02f, 3.253598139e-02f, 3.472106531e-02f, 3.668421507e-02f, 3.837271035e-02f, 3.973953426e-02f,
+            4.074554518e-02f, 4.136133566e-02f, 4.156866297e-02f, 4.136133566e-02f, 4.074554518e-02f, 3.973953426e-02f,
+            3.837271035e-02f, 3.668421507e-02f, 3.472106531e-02f, 3.253598139e-02f, 3.018504195e-02f, 2.772533335e-02f,
+            2.521266788e-02f, 2.269958146e-02f, 2.023363858e-02f, 1.785612479e-02f, 1.560118049e-02f, 1.349536795e-02f,
+            1.155763865e-02f, 9.799648076e-03f, 8.226384409e-03f, 6.836983841e-03f, 5.625706166e-03f,
+        },
+        // KERNEL_RADIUS_TYPE_22
+        {
+            5.116728134e-03f, 6.111676805e-03f, 7.240010891e-03f, 8.506067097e-03f, 9.911267087e-03f, 1.145355683e-02f,
+            1.312690601e-02f, 1.492090430e-02f, 1.682049222e-02f, 1.880585402e-02f, 2.085250244e-02f, 2.293158695e-02f,
+            2.501040883e-02f, 2.705317922e-02f, 2.902194858e-02f, 3.087775223e-02f, 3.258183599e-02f, 3.409700096e-02f,
+            3.538894653e-02f, 3.642754257e-02f, 3.718800843e-02f, 3.765188530e-02f, 3.780779243e-02f, 3.765188530e-02f,
+            3.718800843e-02f, 3.642754257e-02f, 3.538894653e-02f, 3.409700096e-02f, 3.258183599e-02f, 3.087775223e-02f,
+            2.902194858e-02f, 2.705317922e-02f, 2.501040883e-02f, 2.293158695e-02f, 2.085250244e-02f, 1.880585402e-02f,
+            1.682049222e-02f, 1.492090430e-02f, 1.312690601e-02f, 1.145355683e-02f, 9.911267087e-03f, 8.506067097e-03f,
+            7.240010891e-03f, 6.111676805e-03f, 5.116728134e-03f,
+        },
+        // KERNEL_RADIUS_TYPE_24
+        {
+            4.692218266e-03f, 5.523986649e-03f, 6.458194926e-03f, 7.498143706e-03f, 8.645306341e-03f, 9.898995049e-03f,
+            1.125604566e-02f, 1.271056104e-02f, 1.425369922e-02f, 1.587357000e-02f, 1.755519398e-02f, 1.928060874e-02f,
+            2.102906257e-02f, 2.277734689e-02f, 2.450024709e-02f, 2.617109008e-02f, 2.776241675e-02f, 2.924669348e-02f,
+            3.059710748e-02f, 3.178834915e-02f, 3.279741853e-02f, 3.360434622e-02f, 3.419284895e-02f, 3.455088660e-02f,
+            3.467106447e-02f, 3.455088660e-02f, 3.419284895e-02f, 3.360434622e-02f, 3.279741853e-02f, 3.178834915e-02f,
+            3.059710748e-02f, 2.924669348e-02f, 2.776241675e-02f, 2.617109008e-02f, 2.450024709e-02f, 2.277734689e-02f,
+            2.102906257e-02f, 1.928060874e-02f, 1.755519398e-02f, 1.587357000e-02f, 1.425369922e-02f, 1.271056104e-02f,
+            1.125604566e-02f, 9.898995049e-03f, 8.645306341e-03f, 7.498143706e-03f, 6.458194926e-03f, 5.523986649e-03f,
+            4.692218266e-03f,
+        },
+        // KERNEL_RADIUS_TYPE_26
+        {
+            4.332758952e-03f, 5.038418341e-03f, 5.824437831e-03f, 6.693358533e-03f, 7.646529004e-03f, 8.683900349e-03f,
+            9.803825058e-03f, 1.100288238e-02f, 1.227573585e-02f, 1.361503918e-02f, 1.501137204e-02f, 1.645326801e-02f,
+            1.792726666e-02f, 1.941807941e-02f, 2.090877667e-02f, 2.238108963e-02f, 2.381573617e-02f, 2.519283444e-02f,
+            2.649233304e-02f, 2.769450843e-02f, 2.878043056e-02f, 2.973248065e-02f, 3.053480573e-02f, 3.117378056e-02f,
+            3.163835406e-02f, 3.192042187e-02f, 3.201499954e-02f, 3.192042187e-02f, 3.163835406e-02f, 3.117378056e-02f,
+            3.053480573e-02f, 2.973248065e-02f, 2.878043056e-02f, 2.769450843e-02f, 2.649233304e-02f, 2.519283444e-02f,
+            2.381573617e-02f, 2.238108963e-02f, 2.090877667e-02f, 1.941807941e-02f, 1.792726666e-02f, 1.645326801e-02f,
+            1.501137204e-02f, 1.361503918e-02f, 1.227573585e-02f, 1.100288238e-02f, 9.803825058e-03f, 8.683900349e-03f,
+            7.646529004e-03f, 6.693358533e-03f, 5.824437831e-03f, 5.038418341e-03f, 4.332758952e-03f,
+        },
+        // KERNEL_RADIUS_TYPE_28
+        {
+            4.024460912e-03f, 4.630648997e-03f, 5.301029887e-03f, 6.037579849e-03f, 6.841474213e-03f, 7.712953724e-03f,
+            8.651192300e-03f, 9.654180147e-03f, 1.071862411e-02f, 1.183987036e-02f, 1.301184855e-02f, 1.422706433e-02f,
+            1.547660865e-02f, 1.675021835e-02f, 1.803638227e-02f, 1.932246611e-02f, 2.059491165e-02f, 2.183943987e-02f,
+            2.304131538e-02f, 2.418562211e-02f, 2.525756508e-02f, 2.624278143e-02f, 2.712767012e-02f, 2.789968811e-02f,
+            2.854765020e-02f, 2.906200849e-02f, 2.943507209e-02f, 2.966120467e-02f, 2.973696776e-02f, 2.966120467e-02f,
+            2.943507209e-02f, 2.906200849e-02f, 2.854765020e-02f, 2.789968811e-02f, 2.712767012e-02f, 2.624278143e-02f,
+            2.525756508e-02f, 2.418562211e-02f, 2.304131538e-02f, 2.183943987e-02f, 2.059491165e-02f, 1.932246611e-02f,
+            1.803638227e-02f, 1.675021835e-02f, 1.547660865e-02f, 1.422706433e-02f, 1.301184855e-02f, 1.183987036e-02f,
+            1.071862411e-02f, 9.654180147e-03f, 8.651192300e-03f, 7.712953724e-03f, 6.841474213e-03f, 6.037579849e-03f,
+            5.301029887e-03f, 4.630648997e-03f, 4.024460912e-03f,
+        },
+        // KERNEL_RADIUS_TYPE_30
+        {
+            3.757124767e-03f, 4.283477087e-03f, 4.861912224e-03f, 5.493985955e-03f, 6.180702243e-03f, 6.922417786e-03f,
+            7.718761917e-03f, 8.568548597e-03f, 9.469711222e-03f, 1.041923929e-02f, 1.141313743e-02f, 1.244640443e-02f,
+            1.351302397e-02f, 1.460599154e-02f, 1.571734808e-02f, 1.683826558e-02f, 1.795912720e-02f, 1.906965859e-02f,
+            2.015906386e-02f, 2.121620066e-02f, 2.222975716e-02f, 2.318844385e-02f, 2.408120781e-02f, 2.489744499e-02f,
+            2.562719211e-02f, 2.626135387e-02f, 2.679186873e-02f, 2.721188962e-02f, 2.751593105e-02f, 2.769998275e-02f,
+            2.776160650e-02f, 2.769998275e-02f, 2.751593105e-02f, 2.721188962e-02f, 2.679186873e-02f, 2.626135387e-02f,
+            2.562719211e-02f, 2.489744499e-02f, 2.408120781e-02f, 2.318844385e-02f, 2.222975716e-02f, 2.121620066e-02f,
+            2.015906386e-02f, 1.906965859e-02f, 1.795912720e-02f, 1.683826558e-02f, 1.571734808e-02f, 1.460599154e-02f,
+            1.351302397e-02f, 1.244640443e-02f, 1.141313743e-02f, 1.041923929e-02f, 9.469711222e-03f, 8.568548597e-03f,
+            7.718761917e-03f, 6.922417786e-03f, 6.180702243e-03f, 5.493985955e-03f, 4.861912224e-03f, 4.283477087e-03f,
+            3.757124767e-03f,
+        },
+        // KERNEL_RADIUS_TYPE_32
+        {
+            3.523096675e-03f, 3.984401934e-03f, 4.488541745e-03f, 5.036755465e-03f, 5.629892461e-03f, 6.268343888e-03f,
+            6.951989140e-03f, 7.680135779e-03f, 8.451469243e-03f, 9.264011867e-03f, 1.011508424e-02f, 1.100128703e-02f,
+            1.191848237e-02f, 1.286180690e-02f, 1.382568106e-02f, 1.480384823e-02f, 1.578942314e-02f, 1.677495800e-02f,
+            1.775252633e-02f, 1.871381886e-02f, 1.965025626e-02f, 2.055310830e-02f, 2.141363360e-02f, 2.222320996e-02f,
+            2.297347598e-02f, 2.365648374e-02f, 2.426482737e-02f, 2.479178086e-02f, 2.523142658e-02f, 2.557875589e-02f,
+            2.582977340e-02f, 2.598156221e-02f, 2.603235841e-02f, 2.598156221e-02f, 2.582977340e-02f, 2.557875589e-02f,
+            2.523142658e-02f, 2.479178086e-02f, 2.426482737e-02f, 2.365648374e-02f, 2.297347598e-02f, 2.222320996e-02f,
+            2.141363360e-02f, 2.055310830e-02f, 1.965025626e-02f, 1.871381886e-02f, 1.775252633e-02f, 1.677495800e-02f,
+            1.578942314e-02f, 1.480384823e-02f, 1.382568106e-02f, 1.286180690e-02f, 1.191848237e-02f, 1.100128703e-02f,
+            1.011508424e-02f, 9.264011867e-03f, 8.451469243e-03f, 7.680135779e-03f, 6.951989140e-03f, 6.268343888e-03f,
+            5.629892461e-03f, 5.036755465e-03f, 4.488541745e-03f, 3.984401934e-03f, 3.523096675e-03f,
+        },
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,59 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+
+//--------------------------------------------------------------------------------------
+// File: HalfFloat.cpp
+//
+// Implements the batched half conversions.
+//--------------------------------------------------------------------------------------
+
+
+#include "HalfFloat.h"
+#include "SIMD.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Converts floats to halves with the kernels of this CPU
+    //--------------------------------------------------------------------------------------
+    void FloatToHalfRow( const float* pSrc, int iCount, unsigned short* pDst )
+    {
+        GetFilterKernels().m_pfnFloatToHalfRow( pSrc, iCount, pDst );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Converts halves to floats with the kernels of this CPU
+    //--------------------------------------------------------------------------------------
+    void HalfToFloatRow( const unsigned short* pSrc, int iCount, float* pDst )
+    {
+        GetFilterKernels().m_pfnHalfToFloatRow( pSrc, iCount, pDst );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,198 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+
+//--------------------------------------------------------------------------------------
+// File: HalfFloat.h
+//
+// Conversions between 32 bit and 16 bit floats, and a surface of 16 bit float texels
+// for HDR intermediates, the CPU equivalent of f32tof16 / f16tof32.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Converts a float to a half, rounding to nearest even. Unlike AMD::ConvertF32ToF16,
+    // values too small for a normal half become denormals, values too large become
+    // infinity, and infinities and NaNs are kept (NaNs as quiet NaNs).
+    //--------------------------------------------------------------------------------------
+    inline unsigned short FloatToHalf( float fValue )
+    {
+        unsigned int uBits;
+        memcpy( &uBits, &fValue, sizeof( uBits ) );
+
+        const unsigned int uSign = ( uBits >> 16 ) & 0x8000;
+        const unsigned int uAbs = uBits & 0x7FFFFFFF;
+
+        // Infinity or NaN
+        if( uAbs >= 0x7F800000 )
+        {
+            return (unsigned short)( uSign | 0x7C00 | ( ( uAbs > 0x7F800000 ) ? 0x200 | ( ( uAbs >> 13 ) & 0x3FF ) : 0 ) );
+        }
+
+        // At or above 65520, which rounds past the largest half of 65504
+        if( uAbs >= 0x477FF000 )
+        {
+            return (unsigned short)( uSign | 0x7C00 );
+        }
+
+        // Below the smallest normal half of 2^-14, the mantissa with its implicit bit is
+        // shifted down to units of 2^-24. Anything up to 2^-25 rounds to zero.
+        if( uAbs < 0x38800000 )
+        {
+            if( uAbs <= 0x33000000 )
+            {
+                return (unsigned short)uSign;
+            }
+
+            const unsigned int uMantissa = ( uAbs & 0x7FFFFF ) | 0x800000;
+            const unsigned int uShift = 126 - ( uAbs >> 23 );
+            const unsigned int uRemainder = uMantissa & ( ( 1u << uShift ) - 1 );
+            const unsigned int uHalfway = 1u << ( uShift - 1 );
+            unsigned int uHalf = uMantissa >> uShift;
+            if( uRemainder > uHalfway || ( uRemainder == uHalfway && ( uHalf & 1 ) ) )
+            {
+                ++uHalf;
+            }
+
+            return (unsigned short)( uSign | uHalf );
+        }
+
+        // Normal, rebias the exponent from 127 to 15. Rounding up may carry into the exponent,
+        // which is still the correctly rounded half.
+        unsigned int uHalf = ( uAbs - 0x38000000 ) >> 13;
+        const unsigned int uRemainder = uAbs & 0x1FFF;
+        if( uRemainder > 0x1000 || ( uRemainder == 0x1000 && ( uHalf & 1 ) ) )
+        {
+            ++uHalf;
+        }
+
+        return (unsigned short)( uSign | uHalf );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Converts a half to a float, which is always exact
+    //--------------------------------------------------------------------------------------
+    inline float HalfToFloat( unsigned short uHalf )
+    {
+        const unsigned int uSign = ( (unsigned int)uHalf & 0x8000 ) << 16;
+        const unsigned int uExponent = ( uHalf >> 10 ) & 0x1F;
+        const unsigned int uMantissa = uHalf & 0x3FF;
+
+        unsigned int uBits;
+        if( 0x1F == uExponent )
+        {
+            // NaNs are made quiet, as by F16C
+            uBits = uSign | 0x7F800000 | ( uMantissa << 13 ) | ( ( 0 != uMantissa ) ? 0x400000 : 0 );
+        }
+        else if( 0 == uExponent )
+        {
+            // Zero or denormal, in units of 2^-24
+            const float fValue = (float)uMantissa * ( 1.0f / 16777216.0f );
+            return uSign ? -fValue : fValue;
+        }
+        else
+        {
+            uBits = uSign | ( ( uExponent + 112 ) << 23 ) | ( uMantissa << 13 );
+        }
+
+        float fValue;
+        memcpy( &fValue, &uBits, sizeof( fValue ) );
+
+        return fValue;
+    }
+
+
+    // Convert iCount values with the best instruction set of this CPU (F16C on AVX2 and
+    // AVX-512), with the same results as FloatToHalf and HalfToFloat
+    void FloatToHalfRow( const float* pSrc, int iCount, unsigned short* pDst );
+    void HalfToFloatRow( const unsigned short* pSrc, int iCount, float* pDst );
+
+
+    //--------------------------------------------------------------------------------------
+    // A 2D surface of texels of 4 halves, the CPU equivalent of an R16G16B16A16_FLOAT
+    // texture. Half the size of a Surface, for intermediates that need the range of HDR.
+    //--------------------------------------------------------------------------------------
+    class HalfSurface
+    {
+    public:
+
+        HalfSurface() : m_pData( NULL ), m_uWidth( 0 ), m_uHeight( 0 ), m_uPitch( 0 ) {}
+        ~HalfSurface() { Release(); }
+
+        // Allocates a surface with each row aligned to MEMORY_ALIGNMENT
+        bool Create( unsigned int uWidth, unsigned int uHeight )
+        {
+            Release();
+
+            const unsigned int uTexelsPerAlignment = (unsigned int)( MEMORY_ALIGNMENT / ( 4 * sizeof( unsigned short ) ) );
+            unsigned int uPitch = DivRoundUp( uWidth, uTexelsPerAlignment ) * uTexelsPerAlignment;
+
+            m_pData = (unsigned short*)AlignedMalloc( (size_t)uPitch * uHeight * 4 * sizeof( unsigned short ) );
+            if( NULL == m_pData )
+            {
+                return false;
+            }
+
+            m_uWidth = uWidth;
+            m_uHeight = uHeight;
+            m_uPitch = uPitch;
+
+            return true;
+        }
+
+        void Release()
+        {
+            AlignedFree( m_pData );
+
+            m_pData = NULL;
+            m_uWidth = m_uHeight = m_uPitch = 0;
+        }
+
+        // Each row holds 4 halves per texel
+        unsigned short* Row( int iY ) { return m_pData + (size_t)iY * m_uPitch * 4; }
+        const unsigned short* Row( int iY ) const { return m_pData + (size_t)iY * m_uPitch * 4; }
+
+        unsigned short* m_pData;
+        unsigned int    m_uWidth;
+        unsigned int    m_uHeight;
+        unsigned int    m_uPitch;      // In texels
+
+    private:
+
+        HalfSurface( const HalfSurface& );
+        HalfSurface& operator=( const HalfSurface& );
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
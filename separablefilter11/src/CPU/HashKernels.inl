@@ -0,0 +1,115 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: HashKernels.inl
+//
+// Vectorized content hashing, written against the VecI type of the including translation
+// unit (Kernels_*.cpp). Used to find tiles whose inputs are unchanged since the last frame.
+//--------------------------------------------------------------------------------------
+
+
+// Number of independent hash chains, enough to hide the latency of the multiplies
+static const int HASH_CHAINS = 4;
+
+
+//--------------------------------------------------------------------------------------
+// Mixes a vector into a hash chain. The multiply by an odd constant and the xorshift are
+// both invertible, so any single changed vector always changes the chain.
+//--------------------------------------------------------------------------------------
+static inline VecI HashMix( VecI Hash, VecI Value )
+{
+    const VecI Hashed = MulLo( Hash ^ Value, VecI::Set1( (int)0x9E3779B1 ) );
+
+    return Hashed ^ ShiftRightLogical( Hashed, 15 );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Mixes 32 bits into a 64 bit hash
+//--------------------------------------------------------------------------------------
+static inline unsigned long long HashMix64( unsigned long long uHash, unsigned int uValue )
+{
+    uHash = ( uHash ^ uValue ) * 0x9E3779B97F4A7C15ull;
+
+    return uHash ^ ( uHash >> 29 );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Hashes the bits of iNumRows rows of iCount floats, uPitch floats apart, chained from
+// uSeed. The hash depends on the vector width, so is only comparable on one instruction set.
+//--------------------------------------------------------------------------------------
+static unsigned long long HashRows( const float* pSrc, size_t uPitch, int iCount, int iNumRows, unsigned long long uSeed )
+{
+    VecI Chains[HASH_CHAINS];
+    for( int iChain = 0; iChain < HASH_CHAINS; ++iChain )
+    {
+        Chains[iChain] = VecI::Set1( iChain + 1 );
+    }
+
+    unsigned long long uHash = HashMix64( HashMix64( uSeed, (unsigned int)iCount ), (unsigned int)iNumRows );
+
+    for( int iRow = 0; iRow < iNumRows; ++iRow )
+    {
+        const int* pRow = (const int*)( pSrc + uPitch * iRow );
+        int i = 0;
+
+        for( ; i + VecI::WIDTH * HASH_CHAINS <= iCount; i += VecI::WIDTH * HASH_CHAINS )
+        {
+            for( int iChain = 0; iChain < HASH_CHAINS; ++iChain )
+            {
+                Chains[iChain] = HashMix( Chains[iChain], VecI::Load( pRow + i + iChain * VecI::WIDTH ) );
+            }
+        }
+
+        for( ; i + VecI::WIDTH <= iCount; i += VecI::WIDTH )
+        {
+            Chains[0] = HashMix( Chains[0], VecI::Load( pRow + i ) );
+        }
+
+        for( ; i < iCount; ++i )
+        {
+            uHash = HashMix64( uHash, (unsigned int)pRow[i] );
+        }
+    }
+
+    // Fold the lanes of the chains into the 64 bit hash
+    int iLanes[VecI::WIDTH * HASH_CHAINS];
+    for( int iChain = 0; iChain < HASH_CHAINS; ++iChain )
+    {
+        Chains[iChain].Store( iLanes + iChain * VecI::WIDTH );
+    }
+
+    for( int iLane = 0; iLane < VecI::WIDTH * HASH_CHAINS; ++iLane )
+    {
+        uHash = HashMix64( uHash, (unsigned int)iLanes[iLane] );
+    }
+
+    return uHash;
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,271 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: JointBilateralFilter.h
+//
+// The CPU equivalent of JointBilateralFilter.hlsl, a joint (cross) bilateral filter for
+// denoising buffers such as AO or GI, with output identical to the shader. The range
+// weights come from a guide surface, such as depth, normals or albedo, through the same
+// table the application uploads to g_f4RangeWeights.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "BilateralFilter.h"
+
+
+namespace CPUFilter
+{
+    // Defines
+    static const int RANGE_TABLE_SIZE       = 256;      // Needs to match RANGE_TABLE_SIZE in JointBilateralFilter.hlsl
+    static const float RANGE_TABLE_SCALE    = 16.0f;    // Needs to match RANGE_TABLE_SCALE in JointBilateralFilter.hlsl
+
+
+    //--------------------------------------------------------------------------------------
+    // Index of the range weight of a squared guide distance, the nearest entry of the table
+    //--------------------------------------------------------------------------------------
+    inline int RangeTableIndex( float fDistanceSquared )
+    {
+        const float fIndex = fDistanceSquared * RANGE_TABLE_SCALE + 0.5f;
+
+        return ( fIndex < (float)( RANGE_TABLE_SIZE - 1 ) ) ? (int)fIndex : RANGE_TABLE_SIZE - 1;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Gaussian range weights, for guides scaled by one over their deviation. The last entry
+    // is 0, so that guides further apart than the table don't mix.
+    //--------------------------------------------------------------------------------------
+    inline void ComputeRangeWeights( float* pRangeWeights )
+    {
+        for( int iEntry = 0; iEntry < RANGE_TABLE_SIZE - 1; ++iEntry )
+        {
+            pRangeWeights[iEntry] = expf( -0.5f * (float)iEntry / RANGE_TABLE_SCALE );
+        }
+        pRangeWeights[RANGE_TABLE_SIZE - 1] = 0.0f;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Joint bilateral filter class. g_txInput is input 0 and g_txGuide is input 1. Both
+    // passes read the guide, so the horizontal pass outputs all four channels filtered.
+    //--------------------------------------------------------------------------------------
+    template< PASS_TYPE Pass >
+    class JointBilateralFilter : public FilterPass
+    {
+    public:
+
+        // Uncompressed data as sampled from inputs
+        struct RAWDataItem
+        {
+            Float4 f4Color;
+            Float4 f4Guide;     // Scaled by the guide scale
+        };
+
+        // Data stored in the LDS
+        typedef RAWDataItem LDSItem;
+
+        // Data stored for a kernel
+        struct KernelData
+        {
+            float fWeight;
+            float fWeightSum;
+            Float4 f4CenterGuide;
+        };
+
+        // CS output structure
+        struct Output
+        {
+            Float4 f4Color[PIXELS_PER_THREAD];
+        };
+
+        JointBilateralFilter() : m_bDepthGuide( false )
+        {
+            memset( m_fProjParams, 0, sizeof( m_fProjParams ) );
+            memset( m_fGuideScale, 0, sizeof( m_fGuideScale ) );
+            ComputeRangeWeights( m_fRangeWeights );
+            SetKernel( m_iKernelRadius, false );
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Sets g_f4GuideScale, one over the range deviation of each guide channel, or 0 to
+        // ignore it
+        //--------------------------------------------------------------------------------------
+        void SetGuideScale( const float fGuideScale[4] )
+        {
+            memcpy( m_fGuideScale, fGuideScale, sizeof( m_fGuideScale ) );
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Sets g_f4RangeWeights, RANGE_TABLE_SIZE weights of the squared guide distance
+        //--------------------------------------------------------------------------------------
+        void SetRangeWeights( const float* pRangeWeights )
+        {
+            memcpy( m_fRangeWeights, pRangeWeights, sizeof( m_fRangeWeights ) );
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Equivalent of GUIDE_IS_DEPTH with g_f4ProjParams ( [0] = fQTimesZNear, [1] = fQ ):
+        // the guide is a depth buffer, converted to view space depth. NULL reads the guide
+        // as it is.
+        //--------------------------------------------------------------------------------------
+        void SetDepthGuide( const float* pProjParams )
+        {
+            m_bDepthGuide = ( NULL != pProjParams );
+            if( m_bDepthGuide )
+            {
+                memcpy( m_fProjParams, pProjParams, sizeof( m_fProjParams ) );
+            }
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // The weights get computed once per kernel, as the HLSL compiles them to constants
+        //--------------------------------------------------------------------------------------
+        virtual void SetKernel( int iKernelRadius, bool bApproximate )
+        {
+            FilterPass::SetKernel( iKernelRadius, bApproximate );
+
+            const float fDeviation = (float)m_iKernelRadius * 0.5f;
+            m_fCenterWeight = GaussianWeight( 0.0f, fDeviation );
+            for( int iIteration = 0; iIteration < KernelDiameter(); ++iIteration )
+            {
+                m_fWeights[iIteration] = GaussianWeight( (float)( iIteration - m_iKernelRadius ) + ( 1.0f - 1.0f / (float)m_iStepSize ), fDeviation );
+            }
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // LDS access
+        //--------------------------------------------------------------------------------------
+        void WriteToLDS( const RAWDataItem& RDI, LDSItem& LDSValue ) const { LDSValue = RDI; }
+        void ReadFromLDS( const LDSItem& LDSValue, RAWDataItem& RDI ) const { RDI = LDSValue; }
+
+
+        //--------------------------------------------------------------------------------------
+        // Sample from chosen input(s)
+        //--------------------------------------------------------------------------------------
+        void SampleFromInput( SAMPLER_TYPE Sampler, float fX, float fY, RAWDataItem& RDI ) const
+        {
+            RDI.f4Color = m_pInputs[0]->Sample( Sampler, fX, fY );
+
+            Float4 f4Guide = m_pInputs[1]->Sample( Sampler, fX, fY );
+            if( m_bDepthGuide )
+            {
+                f4Guide = MakeFloat4( LinearizeDepth( f4Guide.x, m_fProjParams ), 0.0f, 0.0f, 0.0f );
+            }
+            RDI.f4Guide = MakeFloat4( f4Guide.x * m_fGuideScale[0], f4Guide.y * m_fGuideScale[1], f4Guide.z * m_fGuideScale[2], f4Guide.w * m_fGuideScale[3] );
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // The range weight of the distance between two scaled guides
+        //--------------------------------------------------------------------------------------
+        float RangeWeight( const Float4& f4Guide, const Float4& f4CenterGuide ) const
+        {
+            const float fX = f4Guide.x - f4CenterGuide.x;
+            const float fY = f4Guide.y - f4CenterGuide.y;
+            const float fZ = f4Guide.z - f4CenterGuide.z;
+            const float fW = f4Guide.w - f4CenterGuide.w;
+
+            return m_fRangeWeights[RangeTableIndex( fX * fX + fY * fY + fZ * fZ + fW * fW )];
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Compute what happens at the kernels center
+        //--------------------------------------------------------------------------------------
+        void KernelCenter( KernelData* KD, int iNumPixels, Output& O, const RAWDataItem* RDI ) const
+        {
+            for( int iPixel = 0; iPixel < iNumPixels; ++iPixel )
+            {
+                KD[iPixel].fWeight = m_fCenterWeight * m_fRangeWeights[0];
+                KD[iPixel].f4CenterGuide = RDI[iPixel].f4Guide;
+                KD[iPixel].fWeightSum = KD[iPixel].fWeight;
+                O.f4Color[iPixel] = RDI[iPixel].f4Color * KD[iPixel].fWeight;
+            }
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Compute what happens for each iteration of the kernel
+        //--------------------------------------------------------------------------------------
+        void KernelIteration( int iIteration, KernelData* KD, int iNumPixels, Output& O, const RAWDataItem* RDI ) const
+        {
+            for( int iPixel = 0; iPixel < iNumPixels; ++iPixel )
+            {
+                KD[iPixel].fWeight = m_fWeights[iIteration];
+                KD[iPixel].fWeight *= RangeWeight( RDI[iPixel].f4Guide, KD[iPixel].f4CenterGuide );
+                KD[iPixel].fWeightSum += KD[iPixel].fWeight;
+                O.f4Color[iPixel] = O.f4Color[iPixel] + RDI[iPixel].f4Color * KD[iPixel].fWeight;
+            }
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Perform final weighting operation
+        //--------------------------------------------------------------------------------------
+        void KernelFinalWeight( KernelData* KD, int iNumPixels, Output& O ) const
+        {
+            for( int iPixel = 0; iPixel < iNumPixels; ++iPixel )
+            {
+                O.f4Color[iPixel].x /= KD[iPixel].fWeightSum;
+                O.f4Color[iPixel].y /= KD[iPixel].fWeightSum;
+                O.f4Color[iPixel].z /= KD[iPixel].fWeightSum;
+                O.f4Color[iPixel].w /= KD[iPixel].fWeightSum;
+            }
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Output to chosen surface
+        //--------------------------------------------------------------------------------------
+        void KernelOutput( int iCenterX, int iCenterY, int iIncX, int iIncY, int iNumPixels, const Output& O, const KernelData* /*KD*/ ) const
+        {
+            for( int iPixel = 0; iPixel < iNumPixels; ++iPixel )
+            {
+                m_pOutput->Row( iCenterY + iPixel * iIncY )[iCenterX + iPixel * iIncX] = O.f4Color[iPixel];
+            }
+        }
+
+    private:
+
+        float   m_fProjParams[4];
+        float   m_fGuideScale[4];
+        float   m_fRangeWeights[RANGE_TABLE_SIZE];
+        float   m_fCenterWeight;
+        float   m_fWeights[MAX_KERNEL_RADIUS * 2 + 1];
+        bool    m_bDepthGuide;
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
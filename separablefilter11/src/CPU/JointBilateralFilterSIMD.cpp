@@ -0,0 +1,352 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: JointBilateralFilterSIMD.cpp
+//
+// Implements the vectorized joint bilateral filter passes.
+//--------------------------------------------------------------------------------------
+
+
+#include "JointBilateralFilterSIMD.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Rounds a plane up to whole vectors of the widest instruction set
+    //--------------------------------------------------------------------------------------
+    static int PlaneStride( int iNumFloats )
+    {
+        return (int)( DivRoundUp( (unsigned int)iNumFloats, MAX_VECTOR_WIDTH ) * MAX_VECTOR_WIDTH );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    JointBilateralFilterSIMD::JointBilateralFilterSIMD()
+    {
+        m_pKernels = &GetFilterKernels();
+        memset( m_fProjParams, 0, sizeof( m_fProjParams ) );
+        memset( m_fGuideScale, 0, sizeof( m_fGuideScale ) );
+        ComputeRangeWeights( m_fRangeWeights );
+        m_bDepthGuide = false;
+        UpdateGuidePlanes();
+        SetKernel( m_iKernelRadius, false );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Computes the Gaussian weights of JointBilateralFilter.hlsl
+    //--------------------------------------------------------------------------------------
+    void JointBilateralFilterSIMD::SetKernel( int iKernelRadius, bool /*bApproximate*/ )
+    {
+        FilterPass::SetKernel( iKernelRadius, false );
+
+        const float fDeviation = (float)m_iKernelRadius * 0.5f;
+        for( int iTap = 0; iTap < KernelDiameter(); ++iTap )
+        {
+            m_fWeights[iTap] = GaussianWeight( (float)( iTap - m_iKernelRadius ), fDeviation );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Forces the kernels of an instruction set supported by the CPU
+    //--------------------------------------------------------------------------------------
+    void JointBilateralFilterSIMD::SetISA( ISA_TYPE ISA )
+    {
+        m_pKernels = &GetFilterKernels( ISA );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sets g_f4GuideScale
+    //--------------------------------------------------------------------------------------
+    void JointBilateralFilterSIMD::SetGuideScale( const float fGuideScale[4] )
+    {
+        memcpy( m_fGuideScale, fGuideScale, sizeof( m_fGuideScale ) );
+        UpdateGuidePlanes();
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sets g_f4RangeWeights
+    //--------------------------------------------------------------------------------------
+    void JointBilateralFilterSIMD::SetRangeWeights( const float* pRangeWeights )
+    {
+        memcpy( m_fRangeWeights, pRangeWeights, sizeof( m_fRangeWeights ) );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Reads the guide as a depth buffer, or as it is
+    //--------------------------------------------------------------------------------------
+    void JointBilateralFilterSIMD::SetDepthGuide( const float* pProjParams )
+    {
+        m_bDepthGuide = ( NULL != pProjParams );
+        if( m_bDepthGuide )
+        {
+            memcpy( m_fProjParams, pProjParams, sizeof( m_fProjParams ) );
+        }
+        UpdateGuidePlanes();
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // A depth guide only has view space depth in x. Channels scaled by 0 add nothing to the
+    // guide distance, so are left out, but there is always at least one guide plane.
+    //--------------------------------------------------------------------------------------
+    void JointBilateralFilterSIMD::UpdateGuidePlanes()
+    {
+        m_iGuidePlanes = 0;
+        const int iNumChannels = m_bDepthGuide ? 1 : 4;
+        for( int iChannel = 0; iChannel < iNumChannels; ++iChannel )
+        {
+            if( 0.0f != m_fGuideScale[iChannel] )
+            {
+                m_iGuideChannels[m_iGuidePlanes++] = iChannel;
+            }
+        }
+
+        if( 0 == m_iGuidePlanes )
+        {
+            m_iGuideChannels[m_iGuidePlanes++] = 0;
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Converts part of a line to planes, clamped to the edges of the inputs
+    //--------------------------------------------------------------------------------------
+    void JointBilateralFilterSIMD::ConvertLine( int iY, int iX, int iCount, float* pPlanes, int iPlaneStride ) const
+    {
+        const Surface& Input = *m_pInputs[0];
+        const Surface& Guide = *m_pInputs[1];
+        const int iWidth = (int)Input.m_uWidth;
+        float* pGuidePlanes = pPlanes + iPlaneStride * 4;
+
+        // The part of the planes that is inside the inputs
+        const int iBegin = ( iX < 0 ) ? -iX : 0;
+        const int iEnd = ( iX + iCount > iWidth ) ? ( iWidth - iX ) : iCount;
+        const Float4* pInputRow = Input.Row( Clamp( iY, 0, (int)Input.m_uHeight - 1 ) ) + iX + iBegin;
+        const Float4* pGuideRow = Guide.Row( Clamp( iY, 0, (int)Guide.m_uHeight - 1 ) ) + iX + iBegin;
+
+        m_pKernels->m_pfnDeinterleaveRow( pInputRow, iEnd - iBegin, pPlanes + iBegin, pPlanes + iPlaneStride + iBegin, pPlanes + iPlaneStride * 2 + iBegin, pPlanes + iPlaneStride * 3 + iBegin );
+
+        if( m_bDepthGuide )
+        {
+            float* pDepth = pGuidePlanes + iBegin;
+            const float fScale = m_fGuideScale[0];
+            m_pKernels->m_pfnLinearizeDepthRow( pGuideRow, iEnd - iBegin, m_fProjParams, pDepth, NULL );
+            for( int i = 0; i < iEnd - iBegin; ++i )
+            {
+                pDepth[i] *= fScale;
+            }
+        }
+        else
+        {
+            for( int iGuide = 0; iGuide < m_iGuidePlanes; ++iGuide )
+            {
+                float* pGuide = pGuidePlanes + iPlaneStride * iGuide + iBegin;
+                const int iChannel = m_iGuideChannels[iGuide];
+                const float fScale = m_fGuideScale[iChannel];
+                for( int i = 0; i < iEnd - iBegin; ++i )
+                {
+                    pGuide[i] = ( &pGuideRow[i].x )[iChannel] * fScale;
+                }
+            }
+        }
+
+        // The rest is clamped to the edges
+        for( int iPlane = 0; iPlane < NumPlanes(); ++iPlane )
+        {
+            float* pPlane = pPlanes + iPlaneStride * iPlane;
+
+            for( int i = 0; i < iBegin; ++i )
+            {
+                pPlane[i] = pPlane[iBegin];
+            }
+            for( int i = iEnd; i < iCount; ++i )
+            {
+                pPlane[i] = pPlane[iEnd - 1];
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Same dispatch as CSFilterX
+    //--------------------------------------------------------------------------------------
+    void JointBilateralFilterX::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = DivRoundUp( (unsigned int)OutputWidth(), RUN_SIZE );
+        uY = DivRoundUp( (unsigned int)OutputHeight(), RUN_LINES );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Filters RUN_LINES lines of RUN_SIZE pixels. The planes cover the kernel on either side,
+    // plus a vector of padding, and tap N of a pixel is N floats after the start of its plane.
+    //--------------------------------------------------------------------------------------
+    void JointBilateralFilterX::ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const
+    {
+        const int iKernelRadius = KernelRadius();
+        const int iGroupCoordX = (int)uGroupX * RUN_SIZE;
+        const int iNumPixels = ( OutputWidth() - iGroupCoordX < RUN_SIZE ) ? ( OutputWidth() - iGroupCoordX ) : RUN_SIZE;
+        const int iPlaneStride = PlaneStride( iNumPixels + 2 * iKernelRadius + MAX_VECTOR_WIDTH );
+        float* pPlanes = (float*)LDS.Reserve( sizeof( float ) * iPlaneStride * NumPlanes() );
+
+        const float* pTaps[MAX_KERNEL_RADIUS * 2 + 1];
+        for( int iTap = 0; iTap < KernelDiameter(); ++iTap )
+        {
+            pTaps[iTap] = pPlanes + iTap;
+        }
+
+        for( int iLine = 0; iLine < RUN_LINES; ++iLine )
+        {
+            const int iY = (int)uGroupY * RUN_LINES + iLine;
+            if( iY >= OutputHeight() )
+            {
+                break;
+            }
+
+            ConvertLine( iY, iGroupCoordX - iKernelRadius, iPlaneStride, pPlanes, iPlaneStride );
+
+            m_pKernels->m_pfnJointBilateralTaps( m_fWeights, KernelDiameter(), pTaps, iPlaneStride, m_iGuidePlanes, m_fRangeWeights, iNumPixels, m_pOutput->Row( iY ) + iGroupCoordX );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    JointBilateralFilterY::JointBilateralFilterY() :
+    m_iRequestedStripWidth( 0 )
+    {
+        SetStripWidth( 0 );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Resizes the strips for the new ring buffer
+    //--------------------------------------------------------------------------------------
+    void JointBilateralFilterY::SetKernel( int iKernelRadius, bool bApproximate )
+    {
+        JointBilateralFilterSIMD::SetKernel( iKernelRadius, bApproximate );
+
+        SetStripWidth( m_iRequestedStripWidth );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Resizes the strips for the new ring buffer
+    //--------------------------------------------------------------------------------------
+    void JointBilateralFilterY::SetGuideScale( const float fGuideScale[4] )
+    {
+        JointBilateralFilterSIMD::SetGuideScale( fGuideScale );
+
+        SetStripWidth( m_iRequestedStripWidth );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Resizes the strips for the new ring buffer
+    //--------------------------------------------------------------------------------------
+    void JointBilateralFilterY::SetDepthGuide( const float* pProjParams )
+    {
+        JointBilateralFilterSIMD::SetDepthGuide( pProjParams );
+
+        SetStripWidth( m_iRequestedStripWidth );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Overrides the strip width, or 0 to size them from the caches of the CPU
+    //--------------------------------------------------------------------------------------
+    void JointBilateralFilterY::SetStripWidth( int iStripWidth )
+    {
+        assert( iStripWidth >= 0 );
+
+        // The ring buffer holds the planes of the kernel lines, plus the output line
+        m_iRequestedStripWidth = iStripWidth;
+        m_iStripWidth = ( 0 == iStripWidth ) ? ComputeStripWidth( KernelDiameter() * NumPlanes() * sizeof( float ) + sizeof( Float4 ) ) : iStripWidth;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // One group per strip of RUN_SIZE lines, as CSFilterY runs down RUN_SIZE lines
+    //--------------------------------------------------------------------------------------
+    void JointBilateralFilterY::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = DivRoundUp( (unsigned int)OutputWidth(), (unsigned int)m_iStripWidth );
+        uY = DivRoundUp( (unsigned int)OutputHeight(), RUN_SIZE );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Filters RUN_SIZE lines of a strip. Lines are converted to planes as the window slides
+    // down, and an output line is filtered as soon as the lines under its kernel are there.
+    //--------------------------------------------------------------------------------------
+    void JointBilateralFilterY::ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const
+    {
+        const int iKernelRadius = KernelRadius();
+        const int iKernelDiameter = KernelDiameter();
+
+        const int iGroupCoordX = (int)uGroupX * m_iStripWidth;
+        const int iStripWidth = ( OutputWidth() - iGroupCoordX < m_iStripWidth ) ? ( OutputWidth() - iGroupCoordX ) : m_iStripWidth;
+        const int iFirstLine = (int)uGroupY * RUN_SIZE;
+        const int iEndLine = ( iFirstLine + RUN_SIZE < OutputHeight() ) ? ( iFirstLine + RUN_SIZE ) : OutputHeight();
+
+        const int iPlaneStride = PlaneStride( iStripWidth );
+        const int iRingPitch = iPlaneStride * NumPlanes();
+        float* pRing = (float*)LDS.Reserve( sizeof( float ) * iRingPitch * iKernelDiameter );
+
+        const float* pTaps[MAX_KERNEL_RADIUS * 2 + 1];
+
+        for( int iLine = iFirstLine - iKernelRadius; iLine < iEndLine + iKernelRadius; ++iLine )
+        {
+            const int iSlot = ( iLine - iFirstLine + iKernelRadius ) % iKernelDiameter;
+            ConvertLine( iLine, iGroupCoordX, iPlaneStride, pRing + iSlot * iRingPitch, iPlaneStride );
+
+            // The kernel of this output line ends on the line just converted
+            const int iY = iLine - iKernelRadius;
+            if( iY >= iFirstLine )
+            {
+                for( int iTap = 0; iTap < iKernelDiameter; ++iTap )
+                {
+                    pTaps[iTap] = pRing + ( ( iY - iFirstLine + iTap ) % iKernelDiameter ) * iRingPitch;
+                }
+
+                m_pKernels->m_pfnJointBilateralTaps( m_fWeights, iKernelDiameter, pTaps, iPlaneStride, m_iGuidePlanes, m_fRangeWeights, iStripWidth, m_pOutput->Row( iY ) + iGroupCoordX );
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
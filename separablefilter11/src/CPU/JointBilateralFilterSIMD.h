@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: JointBilateralFilterSIMD.h
+//
+// Vectorized joint bilateral filter passes, with the semantics of
+// JointBilateralFilter.hlsl, for denoising buffers such as AO or GI. The inputs are the
+// surface to filter (input 0, all four channels) and the guide (input 1). Only the guide
+// channels with a non-zero scale are converted, so a depth guide costs one plane.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+#include "JointBilateralFilter.h"
+#include "SIMD.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Common state of the vectorized joint bilateral passes
+    //--------------------------------------------------------------------------------------
+    class JointBilateralFilterSIMD : public FilterPass
+    {
+    public:
+
+        JointBilateralFilterSIMD();
+
+        // The approximate filter only exists to halve the texture fetches of the GPU, so the
+        // full filter is always computed
+        virtual void SetKernel( int iKernelRadius, bool bApproximate );
+
+        // Defaults to the best instruction set of the CPU
+        void SetISA( ISA_TYPE ISA );
+        ISA_TYPE GetISA() const { return m_pKernels->m_ISA; }
+
+        // Sets g_f4GuideScale, one over the range deviation of each guide channel, or 0 to
+        // ignore it
+        virtual void SetGuideScale( const float fGuideScale[4] );
+
+        // Sets g_f4RangeWeights, RANGE_TABLE_SIZE weights of the squared guide distance
+        void SetRangeWeights( const float* pRangeWeights );
+
+        // Equivalent of GUIDE_IS_DEPTH with g_f4ProjParams ( [0] = fQTimesZNear, [1] = fQ ).
+        // NULL reads the guide as it is.
+        virtual void SetDepthGuide( const float* pProjParams );
+
+    protected:
+
+        // Planes per line: red, green, blue, alpha and the scaled guide channels
+        int NumPlanes() const { return 4 + m_iGuidePlanes; }
+
+        // Converts iCount texels of line iY, starting at iX and clamped to the edges of the
+        // inputs, into NumPlanes() planes, iPlaneStride floats apart
+        void ConvertLine( int iY, int iX, int iCount, float* pPlanes, int iPlaneStride ) const;
+
+        const FilterKernels*    m_pKernels;
+        float                   m_fWeights[MAX_KERNEL_RADIUS * 2 + 1];  // Center at KERNEL_RADIUS
+        float                   m_fRangeWeights[RANGE_TABLE_SIZE];
+        float                   m_fProjParams[4];
+        float                   m_fGuideScale[4];
+        int                     m_iGuideChannels[4];                    // Guide channel of each guide plane
+        int                     m_iGuidePlanes;
+        bool                    m_bDepthGuide;
+
+    private:
+
+        // Picks the guide channels to convert
+        void UpdateGuidePlanes();
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Horizontal pass
+    //--------------------------------------------------------------------------------------
+    class JointBilateralFilterX : public JointBilateralFilterSIMD
+    {
+    public:
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void GetGroupSize( unsigned int& uWidth, unsigned int& uHeight ) const { uWidth = RUN_SIZE; uHeight = RUN_LINES; }
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Vertical pass: walks down a strip of columns, converting each input line to planes
+    // once, into a ring buffer of KERNEL_DIAMETER lines sized to stay in the cache
+    //--------------------------------------------------------------------------------------
+    class JointBilateralFilterY : public JointBilateralFilterSIMD
+    {
+    public:
+
+        JointBilateralFilterY();
+
+        // The strip width depends on the kernel and on the number of guide planes
+        virtual void SetKernel( int iKernelRadius, bool bApproximate );
+        virtual void SetGuideScale( const float fGuideScale[4] );
+        virtual void SetDepthGuide( const float* pProjParams );
+
+        // Width of the strips in texels, or 0 to size them from the caches of the CPU
+        void SetStripWidth( int iStripWidth );
+        int StripWidth() const { return m_iStripWidth; }
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void GetGroupSize( unsigned int& uWidth, unsigned int& uHeight ) const { uWidth = (unsigned int)m_iStripWidth; uHeight = RUN_SIZE; }
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+
+    private:
+
+        int m_iRequestedStripWidth;
+        int m_iStripWidth;
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
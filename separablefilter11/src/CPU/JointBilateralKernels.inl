@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: JointBilateralKernels.inl
+//
+// Vectorized joint bilateral filter kernels, written against the VecF type of the
+// including translation unit (Kernels_*.cpp). Each lane of a vector carries a different
+// pixel.
+//--------------------------------------------------------------------------------------
+
+
+//--------------------------------------------------------------------------------------
+// Filters iNumPixels planar pixels. ppTaps holds one pointer per tap, to the red plane of
+// the samples for the first pixel, followed at iPlaneStride intervals by the green, blue
+// and alpha planes, and then iGuidePlanes planes of the scaled guide. The center is at
+// KERNEL_RADIUS, pWeights are the Gaussian weights of each tap, and the range weights are
+// looked up in pRangeWeights as RangeTableIndex does. The taps are accumulated in the
+// order of FilterKernel.hlsl.
+//--------------------------------------------------------------------------------------
+static void JointBilateralTaps( const float* pWeights, int iKernelDiameter, const float* const* ppTaps, int iPlaneStride, int iGuidePlanes, const float* pRangeWeights, int iNumPixels, Float4* pOutput )
+{
+    const int iKernelRadius = iKernelDiameter / 2;
+    const VecF TableScale = VecF::Set1( RANGE_TABLE_SCALE );
+    const VecF Half = VecF::Set1( 0.5f );
+    const VecF LastEntry = VecF::Set1( (float)( RANGE_TABLE_SIZE - 1 ) );
+    const float fCenterWeight = pWeights[iKernelRadius] * pRangeWeights[0];
+
+    for( int iPixel = 0; iPixel < iNumPixels; iPixel += VecF::WIDTH )
+    {
+        const float* pCenter = ppTaps[iKernelRadius] + iPixel;
+        VecF CenterGuide[4];
+        for( int iGuide = 0; iGuide < iGuidePlanes; ++iGuide )
+        {
+            CenterGuide[iGuide] = VecF::LoadU( pCenter + iPlaneStride * ( 4 + iGuide ) );
+        }
+
+        VecF WeightSum = VecF::Set1( fCenterWeight );
+        VecF R = WeightSum * VecF::LoadU( pCenter );
+        VecF G = WeightSum * VecF::LoadU( pCenter + iPlaneStride );
+        VecF B = WeightSum * VecF::LoadU( pCenter + iPlaneStride * 2 );
+        VecF A = WeightSum * VecF::LoadU( pCenter + iPlaneStride * 3 );
+
+        for( int iTap = 0; iTap < iKernelDiameter; ++iTap )
+        {
+            if( iTap == iKernelRadius )
+            {
+                continue;
+            }
+
+            // The squared distance of the guides, summed in the order of RangeWeight
+            const float* pTap = ppTaps[iTap] + iPixel;
+            VecF Delta = VecF::LoadU( pTap + iPlaneStride * 4 ) - CenterGuide[0];
+            VecF DistanceSquared = Delta * Delta;
+            for( int iGuide = 1; iGuide < iGuidePlanes; ++iGuide )
+            {
+                Delta = VecF::LoadU( pTap + iPlaneStride * ( 4 + iGuide ) ) - CenterGuide[iGuide];
+                DistanceSquared = DistanceSquared + Delta * Delta;
+            }
+
+            const VecF Index = Min( DistanceSquared * TableScale + Half, LastEntry );
+            VecF Weight = VecF::Set1( pWeights[iTap] ) * LookupTable( pRangeWeights, Index );
+
+            WeightSum = WeightSum + Weight;
+            R = MulAdd( VecF::LoadU( pTap ), Weight, R );
+            G = MulAdd( VecF::LoadU( pTap + iPlaneStride ), Weight, G );
+            B = MulAdd( VecF::LoadU( pTap + iPlaneStride * 2 ), Weight, B );
+            A = MulAdd( VecF::LoadU( pTap + iPlaneStride * 3 ), Weight, A );
+        }
+
+        StoreOutput( pOutput + iPixel, iNumPixels - iPixel, R / WeightSum, G / WeightSum, B / WeightSum, A / WeightSum );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,117 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: Kernels_AVX2.cpp
+//
+// Compiles the vectorized kernels for AVX2 and FMA3.
+//--------------------------------------------------------------------------------------
+
+
+#include "SIMD.h"
+#include "BilateralFilter.h"
+#include "JointBilateralFilter.h"
+#include "GaussianWeights.h"
+
+#if CPUFILTER_X86
+
+#include <immintrin.h>
+
+// Everything below this point may use AVX2, FMA3 and F16C instructions
+#if defined( __clang__ )
+    #pragma clang attribute push( __attribute__(( target( "avx2,fma,f16c" ) )), apply_to = function )
+#elif defined( __GNUC__ )
+    #pragma GCC push_options
+    #pragma GCC target( "avx2,fma,f16c" )
+#endif
+
+#include "SIMD_AVX2.h"
+
+
+namespace CPUFilter
+{
+namespace AVX2
+{
+    #include "GaussianKernels.inl"
+    #include "BilateralKernels.inl"
+    #include "JointBilateralKernels.inl"
+    #include "RecursiveKernels.inl"
+    #include "HashKernels.inl"
+}
+}
+
+// The table is filled out on any CPU, so must not use the instructions above
+#if defined( __clang__ )
+    #pragma clang attribute pop
+#elif defined( __GNUC__ )
+    #pragma GCC pop_options
+#endif
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Fills out the kernel table for AVX2 and FMA3
+    //--------------------------------------------------------------------------------------
+    void InitFilterKernels_AVX2( FilterKernels& Kernels )
+    {
+        Kernels.m_ISA = ISA_TYPE_AVX2;
+        Kernels.m_iVectorWidth = AVX2::VecF::WIDTH;
+        Kernels.m_pfnDeinterleaveRow = AVX2::DeinterleaveRow;
+        Kernels.m_pfnInterleaveRow = AVX2::InterleaveRow;
+        Kernels.m_pfnGaussianRow = AVX2::GaussianRow;
+        Kernels.m_pfnGaussianColumn = AVX2::GaussianColumn;
+        Kernels.m_pfnGaussianRowPlane = AVX2::GaussianRowPlane;
+        Kernels.m_pfnGaussianColumnPlane = AVX2::GaussianColumnPlane;
+        Kernels.m_pfnPackRowUNorm8 = AVX2::PackRowUNorm8;
+        Kernels.m_pfnPackRowUNorm16 = AVX2::PackRowUNorm16;
+        Kernels.m_pfnGaussianColumnUNorm8 = AVX2::GaussianColumnUNorm8;
+        Kernels.m_pfnGaussianColumnUNorm16 = AVX2::GaussianColumnUNorm16;
+        Kernels.m_pfnFloatToHalfRow = AVX2::FloatToHalfRow;
+        Kernels.m_pfnHalfToFloatRow = AVX2::HalfToFloatRow;
+        Kernels.m_pfnGaussianColumnHalf = AVX2::GaussianColumnHalf;
+        Kernels.m_pfnWidenRowUNorm8 = AVX2::WidenRowUNorm8;
+        Kernels.m_pfnPairRows16 = AVX2::PairRows16;
+        Kernels.m_pfnGaussianFixedPointRow = AVX2::GaussianFixedPointRow;
+        Kernels.m_pfnGaussianFixedPointColumn = AVX2::GaussianFixedPointColumn;
+        Kernels.m_pfnLinearizeDepthRow = AVX2::LinearizeDepthRow;
+        Kernels.m_pfnBilateralTaps = AVX2::BilateralTaps;
+        Kernels.m_pfnBilateralGatherTaps = AVX2::BilateralGatherTaps;
+        Kernels.m_pfnJointBilateralTaps = AVX2::JointBilateralTaps;
+        Kernels.m_pfnRecursiveGaussianLines = AVX2::RecursiveGaussianLines;
+        Kernels.m_pfnHashRows = AVX2::HashRows;
+
+        for( int iType = 0; iType < KERNEL_RADIUS_TYPE_MAX; ++iType )
+        {
+            Kernels.m_pfnGaussianRowFixed[iType] = AVX2::s_pfnGaussianRowFixed[iType];
+            Kernels.m_pfnGaussianColumnFixed[iType] = AVX2::s_pfnGaussianColumnFixed[iType];
+        }
+    }
+}
+
+#endif
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
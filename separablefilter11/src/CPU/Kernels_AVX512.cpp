@@ -0,0 +1,117 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: Kernels_AVX512.cpp
+//
+// Compiles the vectorized kernels for AVX-512.
+//--------------------------------------------------------------------------------------
+
+
+#include "SIMD.h"
+#include "BilateralFilter.h"
+#include "JointBilateralFilter.h"
+#include "GaussianWeights.h"
+
+#if CPUFILTER_AVX512
+
+#include <immintrin.h>
+
+// Everything below this point may use AVX-512 instructions
+#if defined( __clang__ )
+    #pragma clang attribute push( __attribute__(( target( "avx512f,avx512bw,avx512dq,avx512vl,avx2,fma" ) )), apply_to = function )
+#elif defined( __GNUC__ )
+    #pragma GCC push_options
+    #pragma GCC target( "avx512f,avx512bw,avx512dq,avx512vl,avx2,fma" )
+#endif
+
+#include "SIMD_AVX512.h"
+
+
+namespace CPUFilter
+{
+namespace AVX512
+{
+    #include "GaussianKernels.inl"
+    #include "BilateralKernels.inl"
+    #include "JointBilateralKernels.inl"
+    #include "RecursiveKernels.inl"
+    #include "HashKernels.inl"
+}
+}
+
+// The table is filled out on any CPU, so must not use the instructions above
+#if defined( __clang__ )
+    #pragma clang attribute pop
+#elif defined( __GNUC__ )
+    #pragma GCC pop_options
+#endif
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Fills out the kernel table for AVX-512
+    //--------------------------------------------------------------------------------------
+    void InitFilterKernels_AVX512( FilterKernels& Kernels )
+    {
+        Kernels.m_ISA = ISA_TYPE_AVX512;
+        Kernels.m_iVectorWidth = AVX512::VecF::WIDTH;
+        Kernels.m_pfnDeinterleaveRow = AVX512::DeinterleaveRow;
+        Kernels.m_pfnInterleaveRow = AVX512::InterleaveRow;
+        Kernels.m_pfnGaussianRow = AVX512::GaussianRow;
+        Kernels.m_pfnGaussianColumn = AVX512::GaussianColumn;
+        Kernels.m_pfnGaussianRowPlane = AVX512::GaussianRowPlane;
+        Kernels.m_pfnGaussianColumnPlane = AVX512::GaussianColumnPlane;
+        Kernels.m_pfnPackRowUNorm8 = AVX512::PackRowUNorm8;
+        Kernels.m_pfnPackRowUNorm16 = AVX512::PackRowUNorm16;
+        Kernels.m_pfnGaussianColumnUNorm8 = AVX512::GaussianColumnUNorm8;
+        Kernels.m_pfnGaussianColumnUNorm16 = AVX512::GaussianColumnUNorm16;
+        Kernels.m_pfnFloatToHalfRow = AVX512::FloatToHalfRow;
+        Kernels.m_pfnHalfToFloatRow = AVX512::HalfToFloatRow;
+        Kernels.m_pfnGaussianColumnHalf = AVX512::GaussianColumnHalf;
+        Kernels.m_pfnWidenRowUNorm8 = AVX512::WidenRowUNorm8;
+        Kernels.m_pfnPairRows16 = AVX512::PairRows16;
+        Kernels.m_pfnGaussianFixedPointRow = AVX512::GaussianFixedPointRow;
+        Kernels.m_pfnGaussianFixedPointColumn = AVX512::GaussianFixedPointColumn;
+        Kernels.m_pfnLinearizeDepthRow = AVX512::LinearizeDepthRow;
+        Kernels.m_pfnBilateralTaps = AVX512::BilateralTaps;
+        Kernels.m_pfnBilateralGatherTaps = AVX512::BilateralGatherTaps;
+        Kernels.m_pfnJointBilateralTaps = AVX512::JointBilateralTaps;
+        Kernels.m_pfnRecursiveGaussianLines = AVX512::RecursiveGaussianLines;
+        Kernels.m_pfnHashRows = AVX512::HashRows;
+
+        for( int iType = 0; iType < KERNEL_RADIUS_TYPE_MAX; ++iType )
+        {
+            Kernels.m_pfnGaussianRowFixed[iType] = AVX512::s_pfnGaussianRowFixed[iType];
+            Kernels.m_pfnGaussianColumnFixed[iType] = AVX512::s_pfnGaussianColumnFixed[iType];
+        }
+    }
+}
+
+#endif
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
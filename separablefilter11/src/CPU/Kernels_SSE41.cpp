@@ -0,0 +1,120 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: Kernels_SSE41.cpp
+//
+// Compiles the vectorized kernels for SSE4.1.
+//--------------------------------------------------------------------------------------
+
+
+#include "SIMD.h"
+#include "BilateralFilter.h"
+#include "JointBilateralFilter.h"
+#include "GaussianWeights.h"
+
+#if CPUFILTER_X86
+
+#include <immintrin.h>
+
+// Everything below this point may use SSE4.1 instructions
+#if defined( __clang__ )
+    #pragma clang attribute push( __attribute__(( target( "sse4.1" ) )), apply_to = function )
+#elif defined( __GNUC__ )
+    #pragma GCC push_options
+    #pragma GCC target( "sse4.1" )
+#endif
+
+#include "SIMD_SSE41.h"
+
+
+namespace CPUFilter
+{
+namespace SSE41
+{
+    #include "GaussianKernels.inl"
+    #include "BilateralKernels.inl"
+    #include "JointBilateralKernels.inl"
+    #include "RecursiveKernels.inl"
+    #include "HashKernels.inl"
+}
+}
+
+// The table is filled out on any CPU, so must not use the instructions above
+#if defined( __clang__ )
+    #pragma clang attribute pop
+#elif defined( __GNUC__ )
+    #pragma GCC pop_options
+#endif
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Fills out the kernel table for SSE4.1
+    //--------------------------------------------------------------------------------------
+    void InitFilterKernels_SSE41( FilterKernels& Kernels )
+    {
+        Kernels.m_ISA = ISA_TYPE_SSE41;
+        Kernels.m_iVectorWidth = SSE41::VecF::WIDTH;
+        Kernels.m_pfnDeinterleaveRow = SSE41::DeinterleaveRow;
+        Kernels.m_pfnInterleaveRow = SSE41::InterleaveRow;
+        Kernels.m_pfnGaussianRow = SSE41::GaussianRow;
+        Kernels.m_pfnGaussianColumn = SSE41::GaussianColumn;
+        Kernels.m_pfnGaussianRowPlane = SSE41::GaussianRowPlane;
+        Kernels.m_pfnGaussianColumnPlane = SSE41::GaussianColumnPlane;
+        Kernels.m_pfnPackRowUNorm8 = SSE41::PackRowUNorm8;
+        Kernels.m_pfnPackRowUNorm16 = SSE41::PackRowUNorm16;
+        Kernels.m_pfnGaussianColumnUNorm8 = SSE41::GaussianColumnUNorm8;
+        Kernels.m_pfnGaussianColumnUNorm16 = SSE41::GaussianColumnUNorm16;
+        Kernels.m_pfnFloatToHalfRow = SSE41::FloatToHalfRow;
+        Kernels.m_pfnHalfToFloatRow = SSE41::HalfToFloatRow;
+        Kernels.m_pfnGaussianColumnHalf = SSE41::GaussianColumnHalf;
+        Kernels.m_pfnWidenRowUNorm8 = SSE41::WidenRowUNorm8;
+        Kernels.m_pfnPairRows16 = SSE41::PairRows16;
+        Kernels.m_pfnGaussianFixedPointRow = SSE41::GaussianFixedPointRow;
+        Kernels.m_pfnGaussianFixedPointColumn = SSE41::GaussianFixedPointColumn;
+        Kernels.m_pfnLinearizeDepthRow = SSE41::LinearizeDepthRow;
+        Kernels.m_pfnBilateralTaps = SSE41::BilateralTaps;
+        Kernels.m_pfnBilateralGatherTaps = SSE41::BilateralGatherTaps;
+        Kernels.m_pfnJointBilateralTaps = SSE41::JointBilateralTaps;
+        Kernels.m_pfnRecursiveGaussianLines = SSE41::RecursiveGaussianLines;
+        Kernels.m_pfnHashRows = SSE41::HashRows;
+
+        // Without FMA the unrolled kernels spill beyond small radii, so are only used up to
+        // KERNEL_RADIUS_TYPE_8, where they measured faster than the looped kernels
+        for( int iType = 0; iType < KERNEL_RADIUS_TYPE_MAX; ++iType )
+        {
+            const bool bUnroll = ( iType <= KERNEL_RADIUS_TYPE_8 );
+            Kernels.m_pfnGaussianRowFixed[iType] = bUnroll ? SSE41::s_pfnGaussianRowFixed[iType] : NULL;
+            Kernels.m_pfnGaussianColumnFixed[iType] = bUnroll ? SSE41::s_pfnGaussianColumnFixed[iType] : NULL;
+        }
+    }
+}
+
+#endif
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: Kernels_Scalar.cpp
+//
+// Compiles the vectorized kernels for the scalar reference path.
+//--------------------------------------------------------------------------------------
+
+
+#include "SIMD.h"
+#include "BilateralFilter.h"
+#include "JointBilateralFilter.h"
+#include "GaussianWeights.h"
+
+#include "SIMD_Scalar.h"
+
+
+namespace CPUFilter
+{
+namespace Scalar
+{
+    #include "GaussianKernels.inl"
+    #include "BilateralKernels.inl"
+    #include "JointBilateralKernels.inl"
+    #include "RecursiveKernels.inl"
+    #include "HashKernels.inl"
+}
+
+
+    //--------------------------------------------------------------------------------------
+    // Fills out the kernel table for the scalar reference path
+    //--------------------------------------------------------------------------------------
+    void InitFilterKernels_Scalar( FilterKernels& Kernels )
+    {
+        Kernels.m_ISA = ISA_TYPE_SCALAR;
+        Kernels.m_iVectorWidth = Scalar::VecF::WIDTH;
+        Kernels.m_pfnDeinterleaveRow = Scalar::DeinterleaveRow;
+        Kernels.m_pfnInterleaveRow = Scalar::InterleaveRow;
+        Kernels.m_pfnGaussianRow = Scalar::GaussianRow;
+        Kernels.m_pfnGaussianColumn = Scalar::GaussianColumn;
+        Kernels.m_pfnGaussianRowPlane = Scalar::GaussianRowPlane;
+        Kernels.m_pfnGaussianColumnPlane = Scalar::GaussianColumnPlane;
+        Kernels.m_pfnPackRowUNorm8 = Scalar::PackRowUNorm8;
+        Kernels.m_pfnPackRowUNorm16 = Scalar::PackRowUNorm16;
+        Kernels.m_pfnGaussianColumnUNorm8 = Scalar::GaussianColumnUNorm8;
+        Kernels.m_pfnGaussianColumnUNorm16 = Scalar::GaussianColumnUNorm16;
+        Kernels.m_pfnFloatToHalfRow = Scalar::FloatToHalfRow;
+        Kernels.m_pfnHalfToFloatRow = Scalar::HalfToFloatRow;
+        Kernels.m_pfnGaussianColumnHalf = Scalar::GaussianColumnHalf;
+        Kernels.m_pfnWidenRowUNorm8 = Scalar::WidenRowUNorm8;
+        Kernels.m_pfnPairRows16 = Scalar::PairRows16;
+        Kernels.m_pfnGaussianFixedPointRow = Scalar::GaussianFixedPointRow;
+        Kernels.m_pfnGaussianFixedPointColumn = Scalar::GaussianFixedPointColumn;
+        Kernels.m_pfnLinearizeDepthRow = Scalar::LinearizeDepthRow;
+        Kernels.m_pfnBilateralTaps = Scalar::BilateralTaps;
+        Kernels.m_pfnBilateralGatherTaps = Scalar::BilateralGatherTaps;
+        Kernels.m_pfnJointBilateralTaps = Scalar::JointBilateralTaps;
+        Kernels.m_pfnRecursiveGaussianLines = Scalar::RecursiveGaussianLines;
+        Kernels.m_pfnHashRows = Scalar::HashRows;
+
+        // The unrolled kernels spill beyond small radii without vector registers, so are only
+        // used up to KERNEL_RADIUS_TYPE_8, where they measured faster than the looped kernels
+        for( int iType = 0; iType < KERNEL_RADIUS_TYPE_MAX; ++iType )
+        {
+            const bool bUnroll = ( iType <= KERNEL_RADIUS_TYPE_8 );
+            Kernels.m_pfnGaussianRowFixed[iType] = bUnroll ? Scalar::s_pfnGaussianRowFixed[iType] : NULL;
+            Kernels.m_pfnGaussianColumnFixed[iType] = bUnroll ? Scalar::s_pfnGaussianColumnFixed[iType] : NULL;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,294 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: OutOfCoreFilter.cpp
+//
+// Implements the OutOfCoreFilter class.
+//--------------------------------------------------------------------------------------
+
+
+#include "OutOfCoreFilter.h"
+
+#include <thread>
+
+
+namespace CPUFilter
+{
+    // Defines
+    static const size_t DEFAULT_MEMORY_BUDGET = (size_t)1 << 30;
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    OutOfCoreFilter::OutOfCoreFilter()
+    {
+        m_iRequestedBandHeight = 0;
+        m_uMemoryBudget = DEFAULT_MEMORY_BUDGET;
+        m_iBandHeight = 0;
+        m_iKernelRadius = 0;
+        m_iNumBands = 0;
+        m_iImageHeight = 0;
+        m_pInputFile = NULL;
+        m_pOutputFile = NULL;
+        m_bTransferFailed = false;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Destructor
+    //--------------------------------------------------------------------------------------
+    OutOfCoreFilter::~OutOfCoreFilter()
+    {
+        Release();
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Frees the band surfaces
+    //--------------------------------------------------------------------------------------
+    void OutOfCoreFilter::Release()
+    {
+        m_InputView.Release();
+        m_OutputView.Release();
+        m_IntermediateView.Release();
+
+        for( int i = 0; i < 2; ++i )
+        {
+            m_Input[i].Release();
+            m_Output[i].Release();
+        }
+        m_Intermediate.Release();
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Bytes of the band surfaces
+    //--------------------------------------------------------------------------------------
+    size_t OutOfCoreFilter::GetMemoryUsed() const
+    {
+        size_t uBytes = (size_t)m_Intermediate.m_uPitch * m_Intermediate.m_uHeight;
+
+        for( int i = 0; i < 2; ++i )
+        {
+            uBytes += (size_t)m_Input[i].m_uPitch * m_Input[i].m_uHeight;
+            uBytes += (size_t)m_Output[i].m_uPitch * m_Output[i].m_uHeight;
+        }
+
+        return uBytes * sizeof( Float4 );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Streams the image through the filters band by band. While band i is filtered, band
+    // i + 1 is loaded and band i - 1 stored, so each band waits on the slower of the two.
+    //--------------------------------------------------------------------------------------
+    bool OutOfCoreFilter::OnRender( SeparableFilterCPU& Filter, int iKernelRadius, const TiledImageFile& Input, TiledImageFile& Output )
+    {
+        assert( Input.IsOpen() );
+        assert( Output.IsOpen() && Output.IsWritable() );
+        assert( Input.GetWidth() == Output.GetWidth() && Input.GetHeight() == Output.GetHeight() );
+        assert( iKernelRadius >= 0 );
+
+        m_pInputFile = &Input;
+        m_pOutputFile = &Output;
+        m_iKernelRadius = iKernelRadius;
+        m_iImageHeight = (int)Input.GetHeight();
+
+        if( !CreateSurfaces( Input.GetWidth(), iKernelRadius, NULL == Filter.GetFusedFilter() ) )
+        {
+            return false;
+        }
+
+        m_iNumBands = (int)DivRoundUp( (unsigned int)m_iImageHeight, (unsigned int)m_iBandHeight );
+        m_bTransferFailed = false;
+
+        TransferBands( 0, -1 );
+
+        for( int iBand = 0; iBand < m_iNumBands && !m_bTransferFailed; ++iBand )
+        {
+            const int iLoadBand = ( iBand + 1 < m_iNumBands ) ? ( iBand + 1 ) : -1;
+            const int iStoreBand = iBand - 1;
+
+            if( iLoadBand < 0 && iStoreBand < 0 )
+            {
+                FilterBand( Filter, iBand );
+                continue;
+            }
+
+            std::thread Transfer( &OutOfCoreFilter::TransferBands, this, iLoadBand, iStoreBand );
+            FilterBand( Filter, iBand );
+            Transfer.join();
+        }
+
+        if( !m_bTransferFailed )
+        {
+            TransferBands( -1, m_iNumBands - 1 );
+        }
+
+        m_pInputFile = NULL;
+        m_pOutputFile = NULL;
+
+        return !m_bTransferFailed;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Lines of a band, and of its apron
+    //--------------------------------------------------------------------------------------
+    OutOfCoreFilter::Band OutOfCoreFilter::GetBand( int iBand ) const
+    {
+        Band B;
+
+        B.m_iFirstLine = iBand * m_iBandHeight;
+        B.m_iNumLines = ( B.m_iFirstLine + m_iBandHeight <= m_iImageHeight ) ? m_iBandHeight : ( m_iImageHeight - B.m_iFirstLine );
+        B.m_iFirstLoadedLine = ( B.m_iFirstLine > m_iKernelRadius ) ? ( B.m_iFirstLine - m_iKernelRadius ) : 0;
+
+        const int iEndLoadedLine = ( B.m_iFirstLine + B.m_iNumLines + m_iKernelRadius < m_iImageHeight ) ? ( B.m_iFirstLine + B.m_iNumLines + m_iKernelRadius ) : m_iImageHeight;
+        B.m_iNumLoadedLines = iEndLoadedLine - B.m_iFirstLoadedLine;
+
+        return B;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sizes the bands, and (re)allocates the surfaces for them. Each surface holds a band and
+    // both aprons, and there are 4 of them, or 5 with the intermediate.
+    //--------------------------------------------------------------------------------------
+    bool OutOfCoreFilter::CreateSurfaces( unsigned int uWidth, int iKernelRadius, bool bIntermediate )
+    {
+        const int iTileSize = (int)m_pInputFile->GetTileSize();
+        const int iMaxBandHeight = (int)DivRoundUp( (unsigned int)m_iImageHeight, (unsigned int)iTileSize ) * iTileSize;
+
+        if( m_iRequestedBandHeight > 0 )
+        {
+            m_iBandHeight = (int)DivRoundUp( (unsigned int)m_iRequestedBandHeight, (unsigned int)iTileSize ) * iTileSize;
+        }
+        else
+        {
+            const size_t uLineSize = (size_t)DivRoundUp( uWidth, (unsigned int)( MEMORY_ALIGNMENT / sizeof( Float4 ) ) ) * MEMORY_ALIGNMENT;
+            const size_t uLinesPerSurface = m_uMemoryBudget / ( uLineSize * ( bIntermediate ? 5 : 4 ) );
+
+            m_iBandHeight = ( uLinesPerSurface > (size_t)( 2 * iKernelRadius ) ) ? (int)( ( uLinesPerSurface - 2 * iKernelRadius ) / iTileSize ) * iTileSize : 0;
+            m_iBandHeight = ( m_iBandHeight > iTileSize ) ? m_iBandHeight : iTileSize;
+        }
+        m_iBandHeight = ( m_iBandHeight < iMaxBandHeight ) ? m_iBandHeight : iMaxBandHeight;
+
+        const int iSurfaceHeight = ( m_iBandHeight + 2 * iKernelRadius < m_iImageHeight ) ? ( m_iBandHeight + 2 * iKernelRadius ) : m_iImageHeight;
+
+        // Keep the surfaces of the last image when they are the right size
+        if( m_Input[0].m_uWidth != uWidth || m_Input[0].m_uHeight != (unsigned int)iSurfaceHeight )
+        {
+            Release();
+
+            for( int i = 0; i < 2; ++i )
+            {
+                if( !m_Input[i].Create( uWidth, iSurfaceHeight ) || !m_Output[i].Create( uWidth, iSurfaceHeight ) )
+                {
+                    Release();
+                    return false;
+                }
+            }
+        }
+
+        if( bIntermediate && ( m_Intermediate.m_uWidth != uWidth || m_Intermediate.m_uHeight != (unsigned int)iSurfaceHeight ) )
+        {
+            if( !m_Intermediate.Create( uWidth, iSurfaceHeight ) )
+            {
+                Release();
+                return false;
+            }
+        }
+        else if( !bIntermediate )
+        {
+            m_Intermediate.Release();
+        }
+
+        return true;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Filters a band and its aprons, from the lines loaded into its input surface. The lines
+    // of the aprons are output too, but only those of the band are stored.
+    //--------------------------------------------------------------------------------------
+    void OutOfCoreFilter::FilterBand( SeparableFilterCPU& Filter, int iBand )
+    {
+        const Band B = GetBand( iBand );
+        const unsigned int uWidth = m_pInputFile->GetWidth();
+        const Surface& Input = m_Input[iBand & 1];
+        Surface& Output = m_Output[iBand & 1];
+
+        m_InputView.CreateView( Input.m_pData, uWidth, B.m_iNumLoadedLines, Input.m_uPitch );
+        m_OutputView.CreateView( Output.m_pData, uWidth, B.m_iNumLoadedLines, Output.m_uPitch );
+
+        Surface* pIntermediate = NULL;
+        if( NULL != m_Intermediate.m_pData )
+        {
+            m_IntermediateView.CreateView( m_Intermediate.m_pData, uWidth, B.m_iNumLoadedLines, m_Intermediate.m_uPitch );
+            pIntermediate = &m_IntermediateView;
+        }
+
+        const Surface* pHorizInputs[1] = { &m_InputView };
+        const Surface* pVertInputs[1] = { pIntermediate };
+
+        Filter.SetOutputSize( uWidth, B.m_iNumLoadedLines );
+        Filter.SetInputSurfaces( pHorizInputs, pVertInputs, 1 );
+        Filter.SetOutputSurfaces( pIntermediate, &m_OutputView );
+        Filter.OnRender();
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Loads the lines of one band, with its aprons, and stores the filtered lines of another,
+    // -1 for none
+    //--------------------------------------------------------------------------------------
+    void OutOfCoreFilter::TransferBands( int iLoadBand, int iStoreBand )
+    {
+        if( iLoadBand >= 0 )
+        {
+            const Band B = GetBand( iLoadBand );
+
+            if( !m_pInputFile->ReadLines( B.m_iFirstLoadedLine, B.m_iNumLoadedLines, m_Input[iLoadBand & 1], 0 ) )
+            {
+                m_bTransferFailed = true;
+            }
+        }
+
+        if( iStoreBand >= 0 )
+        {
+            const Band B = GetBand( iStoreBand );
+
+            if( !m_pOutputFile->WriteLines( m_Output[iStoreBand & 1], B.m_iFirstLine - B.m_iFirstLoadedLine, B.m_iFirstLine, B.m_iNumLines ) )
+            {
+                m_bTransferFailed = true;
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,124 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: OutOfCoreFilter.h
+//
+// OutOfCoreFilter Class definition.
+// Filters images held in a TiledImageFile, which may be far larger than memory, through a
+// SeparableFilterCPU. The image is streamed through in horizontal bands, each loaded with
+// KERNEL_RADIUS lines of apron above and below, so memory is bounded by the size of a few
+// bands whatever the size of the image. The next band is loaded, and the last one stored,
+// on a thread of their own while the current band is filtered, so the disk and the cores
+// are kept busy at once.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "SeparableFilterCPU.h"
+#include "TiledImageFile.h"
+
+
+namespace CPUFilter
+{
+    class OutOfCoreFilter
+    {
+    public:
+
+        // Constructor / destructor
+        OutOfCoreFilter();
+        ~OutOfCoreFilter();
+
+        // Lines output per band, rounded up to whole tiles of the input, or 0 to size the bands
+        // from the memory budget
+        void SetBandHeight( int iBandHeight ) { assert( iBandHeight >= 0 ); m_iRequestedBandHeight = iBandHeight; }
+
+        // Bytes of band surfaces held in memory at once when sizing the bands, defaults to 1 GB.
+        // Bands are never less than a tile high, so small budgets may be exceeded.
+        void SetMemoryBudget( size_t uBytes ) { m_uMemoryBudget = uBytes; }
+
+        // The bands of the last call to OnRender, and the memory they took
+        int GetBandHeight() const { return m_iBandHeight; }
+        size_t GetMemoryUsed() const;
+
+        // Filters Input into Output, which must be open for writing and the same size, with
+        // the filters set on Filter. Its input, output surfaces and output size are set here
+        // for each band, so only filters of a single input that write the bound outputs can be
+        // streamed. iKernelRadius is the apron loaded for each band, which must cover the
+        // vertical reach of the filters. Returns false if the files could not be mapped, or
+        // the band surfaces allocated.
+        bool OnRender( SeparableFilterCPU& Filter, int iKernelRadius, const TiledImageFile& Input, TiledImageFile& Output );
+
+        // Frees the band surfaces, which are otherwise kept for the next image
+        void Release();
+
+    private:
+
+        OutOfCoreFilter( const OutOfCoreFilter& );
+        OutOfCoreFilter& operator=( const OutOfCoreFilter& );
+
+        // Lines of a band: those output, and those loaded with their apron, clamped to the image
+        struct Band
+        {
+            int m_iFirstLine;
+            int m_iNumLines;
+            int m_iFirstLoadedLine;
+            int m_iNumLoadedLines;
+        };
+
+        Band GetBand( int iBand ) const;
+        bool CreateSurfaces( unsigned int uWidth, int iKernelRadius, bool bIntermediate );
+        void FilterBand( SeparableFilterCPU& Filter, int iBand );
+        void TransferBands( int iLoadBand, int iStoreBand );
+
+        int                     m_iRequestedBandHeight;
+        size_t                  m_uMemoryBudget;
+        int                     m_iBandHeight;
+        int                     m_iKernelRadius;
+        int                     m_iNumBands;
+        int                     m_iImageHeight;
+
+        // Double buffered, so one band can be filtered while the next is loaded and the last
+        // one stored. The intermediate is only needed by filters that are not fused.
+        Surface                 m_Input[2];
+        Surface                 m_Output[2];
+        Surface                 m_Intermediate;
+
+        // Views of the above for the band being filtered, as high as the lines it loaded, so
+        // the filters clamp to the edges of the image
+        Surface                 m_InputView;
+        Surface                 m_OutputView;
+        Surface                 m_IntermediateView;
+
+        // Files of the current call, and the result of the transfers
+        const TiledImageFile*   m_pInputFile;
+        TiledImageFile*         m_pOutputFile;
+        bool                    m_bTransferFailed;
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: PlanarSurface.cpp
+//
+// Implements the conversions between interleaved and planar surfaces.
+//--------------------------------------------------------------------------------------
+
+
+#include "PlanarSurface.h"
+#include "SIMD.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Splits the channels of each texel into the planes
+    //--------------------------------------------------------------------------------------
+    void DeinterleaveSurface( const Surface& Input, PlanarSurface& Output )
+    {
+        assert( Output.m_iNumPlanes >= 3 );
+        assert( Output.m_uWidth >= Input.m_uWidth && Output.m_uHeight >= Input.m_uHeight );
+
+        const FilterKernels& Kernels = GetFilterKernels();
+
+        for( int iY = 0; iY < (int)Input.m_uHeight; ++iY )
+        {
+            Kernels.m_pfnDeinterleaveRow( Input.Row( iY ), (int)Input.m_uWidth, Output.Row( 0, iY ), Output.Row( 1, iY ), Output.Row( 2, iY ),
+                ( Output.m_iNumPlanes > 3 ) ? Output.Row( 3, iY ) : NULL );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Gathers the planes back into texels
+    //--------------------------------------------------------------------------------------
+    void InterleaveSurface( const PlanarSurface& Input, Surface& Output )
+    {
+        assert( Input.m_iNumPlanes >= 3 );
+        assert( Output.m_uWidth >= Input.m_uWidth && Output.m_uHeight >= Input.m_uHeight );
+
+        const FilterKernels& Kernels = GetFilterKernels();
+
+        for( int iY = 0; iY < (int)Input.m_uHeight; ++iY )
+        {
+            Kernels.m_pfnInterleaveRow( Input.Row( 0, iY ), Input.Row( 1, iY ), Input.Row( 2, iY ), ( Input.m_iNumPlanes > 3 ) ? Input.Row( 3, iY ) : NULL,
+                (int)Input.m_uWidth, Output.Row( iY ) );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
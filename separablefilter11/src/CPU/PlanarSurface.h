@@ -0,0 +1,167 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: PlanarSurface.h
+//
+// A surface of planar (structure of arrays) channels, one plane of floats per channel,
+// as an alternative to the interleaved (array of structures) texels of Surface. Planar
+// layouts let each lane of a vector carry a different pixel without any shuffles, and
+// only hold the channels that are needed, so a luminance image is a single plane.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+
+
+namespace CPUFilter
+{
+    // Pixel layout enumeration
+    typedef enum _PIXEL_LAYOUT_TYPE
+    {
+        PIXEL_LAYOUT_TYPE_INTERLEAVED,  // Surface, RGBA texels
+        PIXEL_LAYOUT_TYPE_PLANAR,       // PlanarSurface, a plane per channel
+        PIXEL_LAYOUT_TYPE_MAX
+    }PIXEL_LAYOUT_TYPE;
+
+    static const int MAX_PLANES = 4;
+
+
+    //--------------------------------------------------------------------------------------
+    // A 2D surface of up to 4 planes of floats, all the same size and pitch. Either owns its
+    // memory (Create) or wraps memory owned by the caller or by another planar surface
+    // (CreateView), so planar data from elsewhere is filtered in place, without a copy.
+    //--------------------------------------------------------------------------------------
+    class PlanarSurface
+    {
+    public:
+
+        PlanarSurface() : m_iNumPlanes( 0 ), m_uWidth( 0 ), m_uHeight( 0 ), m_uPitch( 0 ), m_bOwnsData( false ) { memset( m_pPlanes, 0, sizeof( m_pPlanes ) ); }
+        ~PlanarSurface() { Release(); }
+
+        // Allocates the planes in one block, with each row aligned to MEMORY_ALIGNMENT
+        bool Create( unsigned int uWidth, unsigned int uHeight, int iNumPlanes )
+        {
+            assert( iNumPlanes > 0 && iNumPlanes <= MAX_PLANES );
+
+            Release();
+
+            const unsigned int uFloatsPerAlignment = (unsigned int)( MEMORY_ALIGNMENT / sizeof( float ) );
+            unsigned int uPitch = DivRoundUp( uWidth, uFloatsPerAlignment ) * uFloatsPerAlignment;
+            const size_t uPlaneSize = (size_t)uPitch * uHeight;
+
+            float* pData = (float*)AlignedMalloc( uPlaneSize * iNumPlanes * sizeof( float ) );
+            if( NULL == pData )
+            {
+                return false;
+            }
+
+            for( int iPlane = 0; iPlane < iNumPlanes; ++iPlane )
+            {
+                m_pPlanes[iPlane] = pData + uPlaneSize * iPlane;
+            }
+
+            m_iNumPlanes = iNumPlanes;
+            m_uWidth = uWidth;
+            m_uHeight = uHeight;
+            m_uPitch = uPitch;
+            m_bOwnsData = true;
+
+            return true;
+        }
+
+        // Wraps caller owned planes, the pitch is in floats
+        void CreateView( float* const* ppPlanes, int iNumPlanes, unsigned int uWidth, unsigned int uHeight, unsigned int uPitch )
+        {
+            assert( NULL != ppPlanes );
+            assert( iNumPlanes > 0 && iNumPlanes <= MAX_PLANES );
+            assert( uPitch >= uWidth );
+
+            Release();
+
+            for( int iPlane = 0; iPlane < iNumPlanes; ++iPlane )
+            {
+                assert( NULL != ppPlanes[iPlane] );
+                m_pPlanes[iPlane] = ppPlanes[iPlane];
+            }
+
+            m_iNumPlanes = iNumPlanes;
+            m_uWidth = uWidth;
+            m_uHeight = uHeight;
+            m_uPitch = uPitch;
+            m_bOwnsData = false;
+        }
+
+        // Wraps some of the planes of another planar surface, such as a single channel
+        void CreateView( PlanarSurface& Source, int iFirstPlane, int iNumPlanes )
+        {
+            assert( iFirstPlane >= 0 && iFirstPlane + iNumPlanes <= Source.m_iNumPlanes );
+
+            CreateView( Source.m_pPlanes + iFirstPlane, iNumPlanes, Source.m_uWidth, Source.m_uHeight, Source.m_uPitch );
+        }
+
+        void Release()
+        {
+            if( m_bOwnsData )
+            {
+                AlignedFree( m_pPlanes[0] );
+            }
+
+            memset( m_pPlanes, 0, sizeof( m_pPlanes ) );
+            m_iNumPlanes = 0;
+            m_uWidth = m_uHeight = m_uPitch = 0;
+            m_bOwnsData = false;
+        }
+
+        float* Row( int iPlane, int iY ) { return m_pPlanes[iPlane] + (size_t)iY * m_uPitch; }
+        const float* Row( int iPlane, int iY ) const { return m_pPlanes[iPlane] + (size_t)iY * m_uPitch; }
+
+        float*          m_pPlanes[MAX_PLANES];
+        int             m_iNumPlanes;
+        unsigned int    m_uWidth;
+        unsigned int    m_uHeight;
+        unsigned int    m_uPitch;      // In floats
+        bool            m_bOwnsData;
+
+    private:
+
+        PlanarSurface( const PlanarSurface& );
+        PlanarSurface& operator=( const PlanarSurface& );
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Conversions between the layouts, for surfaces of 3 or 4 planes. Deinterleaving keeps
+    // alpha only if there is a fourth plane, and interleaving sets alpha to 1 if there is
+    // none. The output must be at least as large as the input.
+    //--------------------------------------------------------------------------------------
+    void DeinterleaveSurface( const Surface& Input, PlanarSurface& Output );
+    void InterleaveSurface( const PlanarSurface& Input, Surface& Output );
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
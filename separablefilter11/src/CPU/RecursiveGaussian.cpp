@@ -0,0 +1,221 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+
+//--------------------------------------------------------------------------------------
+// File: RecursiveGaussian.cpp
+//
+// Implements the recursive Gaussian filter passes.
+//--------------------------------------------------------------------------------------
+
+
+#include "RecursiveGaussian.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Young and van Vliet's recursion approximates a continuous filter whose poles are the
+    // roots of c0 + c1 * s + c2 * s^2 + c3 * s^3, scaled by q. The recursive coefficients
+    // are expanded from these here, as the published expansions were rounded separately
+    // and drift away from the filter as q grows. The boundary matrix is Triggs and Sdika's,
+    // rewritten for the differences of the state.
+    //--------------------------------------------------------------------------------------
+    void ComputeRecursiveGaussian( float fDeviation, RecursiveGaussianCoefficients& Coefficients )
+    {
+        assert( fDeviation >= MIN_RECURSIVE_DEVIATION );
+
+        const double c0 = 1.57825, c1 = 2.44413, c2 = 1.4281, c3 = 0.422205;
+        const double dDeviation = fDeviation;
+        const double q = ( dDeviation >= 2.5 ) ? ( 0.98711 * dDeviation - 0.96330 ) : ( 3.97156 - 4.14554 * sqrt( 1.0 - 0.26891 * dDeviation ) );
+
+        // y[n] = B * x[n] + a1 * y[n-1] + a2 * y[n-2] + a3 * y[n-3]
+        const double b0 = c0 + q * ( c1 + q * ( c2 + q * c3 ) );
+        const double a1 = q * ( c1 + q * ( 2.0 * c2 + q * 3.0 * c3 ) ) / b0;
+        const double a2 = -q * q * ( c2 + q * 3.0 * c3 ) / b0;
+        const double a3 = q * q * q * c3 / b0;
+        const double B = c0 / b0;
+
+        // The same recursion in differences, where K1 = -( 1 + a2 + 2 * a3 ) and K3 = a3 - 1
+        Coefficients.m_fB = (float)B;
+        Coefficients.m_fK1 = (float)( -( c0 + q * c1 ) / b0 );
+        Coefficients.m_fK3 = (float)( -( c0 + q * ( c1 + q * c2 ) ) / b0 );
+
+        // Triggs and Sdika: the last anti-causal output and the two past the end, from the
+        // last three causal outputs, relative to the last input
+        const double dScale = B / ( ( 1.0 + a1 - a2 + a3 ) * ( 1.0 - a1 - a2 - a3 ) * ( 1.0 + a2 + ( a1 - a3 ) * a3 ) );
+        const double M[3][3] =
+        {
+            { dScale * ( -a3 * a1 + 1.0 - a3 * a3 - a2 ), dScale * ( a3 + a1 ) * ( a2 + a3 * a1 ), dScale * a3 * ( a1 + a3 * a2 ) },
+            { dScale * ( a1 + a3 * a2 ), -dScale * ( a2 - 1.0 ) * ( a2 + a3 * a1 ), -dScale * a3 * ( a3 * a1 + a3 * a3 + a2 - 1.0 ) },
+            { dScale * ( a3 * a1 + a2 + a1 * a1 - a2 * a2 ), dScale * ( a1 * a2 + a3 * a2 * a2 - a1 * a3 * a3 - a3 * a3 * a3 - a3 * a2 + a3 ), dScale * a3 * ( a1 + a3 * a2 ) },
+        };
+
+        // The last three causal values are T times the causal state ( y, D, E ), and the
+        // anti-causal state is T times the three anti-causal values, so the boundary is T M T
+        const double T[3][3] = { { 1.0, 0.0, 0.0 }, { 1.0, -1.0, 0.0 }, { 1.0, -2.0, 1.0 } };
+        double MT[3][3];
+        for( int i = 0; i < 3; ++i )
+        {
+            for( int j = 0; j < 3; ++j )
+            {
+                MT[i][j] = M[i][0] * T[0][j] + M[i][1] * T[1][j] + M[i][2] * T[2][j];
+            }
+        }
+
+        for( int i = 0; i < 3; ++i )
+        {
+            for( int j = 0; j < 3; ++j )
+            {
+                Coefficients.m_fBoundary[i * 3 + j] = (float)( T[i][0] * MT[0][j] + T[i][1] * MT[1][j] + T[i][2] * MT[2][j] );
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    RecursiveGaussianFilter::RecursiveGaussianFilter() :
+    m_fDeviation( 0.0f )
+    {
+        m_pKernels = &GetFilterKernels();
+        SetKernel( m_iKernelRadius, false );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // The radius only matters as the default deviation
+    //--------------------------------------------------------------------------------------
+    void RecursiveGaussianFilter::SetKernel( int iKernelRadius, bool /*bApproximate*/ )
+    {
+        FilterPass::SetKernel( iKernelRadius, false );
+
+        ComputeRecursiveGaussian( GetDeviation(), m_Coefficients );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Overrides the deviation
+    //--------------------------------------------------------------------------------------
+    void RecursiveGaussianFilter::SetDeviation( float fDeviation )
+    {
+        assert( 0.0f == fDeviation || fDeviation >= MIN_RECURSIVE_DEVIATION );
+
+        m_fDeviation = fDeviation;
+        ComputeRecursiveGaussian( GetDeviation(), m_Coefficients );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // One group per vector width of lines, each filtered along its whole length
+    //--------------------------------------------------------------------------------------
+    void RecursiveGaussianX::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = 1;
+        uY = DivRoundUp( (unsigned int)OutputHeight(), (unsigned int)m_pKernels->m_iVectorWidth );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Transposes the lines into red, green and blue lanes per texel, filters them in place,
+    // and transposes them back. Lanes past the last line repeat it, and are not written.
+    //--------------------------------------------------------------------------------------
+    void RecursiveGaussianX::ComputeGroup( unsigned int /*uGroupX*/, unsigned int uGroupY, Scratch& LDS ) const
+    {
+        const Surface& Input = *m_pInputs[0];
+        const int iWidth = OutputWidth();
+        const int iLines = m_pKernels->m_iVectorWidth;
+        const int iLanes = 3 * iLines;
+        const int iFirstLine = (int)uGroupY * iLines;
+        const int iNumLines = ( OutputHeight() - iFirstLine < iLines ) ? ( OutputHeight() - iFirstLine ) : iLines;
+
+        assert( Input.m_uWidth >= (unsigned int)iWidth );
+
+        // The lines, followed by the state of the recursion
+        float* pLines = (float*)LDS.Reserve( sizeof( float ) * iLanes * ( iWidth + 4 ) );
+        float* pState = pLines + iLanes * iWidth;
+
+        for( int iLine = 0; iLine < iLines; ++iLine )
+        {
+            const Float4* pSrc = Input.Row( iFirstLine + ( ( iLine < iNumLines ) ? iLine : ( iNumLines - 1 ) ) );
+            float* pDst = pLines + iLine;
+
+            for( int iX = 0; iX < iWidth; ++iX, pDst += iLanes )
+            {
+                pDst[0] = pSrc[iX].x;
+                pDst[iLines] = pSrc[iX].y;
+                pDst[iLines * 2] = pSrc[iX].z;
+            }
+        }
+
+        m_pKernels->m_pfnRecursiveGaussianLines( m_Coefficients, pLines, iLanes, pLines, iLanes, iWidth, iLanes, pState );
+
+        for( int iLine = 0; iLine < iNumLines; ++iLine )
+        {
+            Float4* pDst = m_pOutput->Row( iFirstLine + iLine );
+            const float* pSrc = pLines + iLine;
+
+            for( int iX = 0; iX < iWidth; ++iX, pSrc += iLanes )
+            {
+                pDst[iX].x = pSrc[0];
+                pDst[iX].y = pSrc[iLines];
+                pDst[iX].z = pSrc[iLines * 2];
+                pDst[iX].w = 1.0f;
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // One group per strip of RUN_SIZE columns, down the whole height
+    //--------------------------------------------------------------------------------------
+    void RecursiveGaussianY::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = DivRoundUp( (unsigned int)OutputWidth(), (unsigned int)RUN_SIZE );
+        uY = 1;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Filters the columns of a strip a row at a time, 4 floats per texel. Alpha is filtered
+    // with the rest, which keeps the alpha of 1 output by the horizontal pass exactly.
+    //--------------------------------------------------------------------------------------
+    void RecursiveGaussianY::ComputeGroup( unsigned int uGroupX, unsigned int /*uGroupY*/, Scratch& LDS ) const
+    {
+        const Surface& Input = *m_pInputs[0];
+        const int iGroupCoordX = (int)uGroupX * RUN_SIZE;
+        const int iNumColumns = ( OutputWidth() - iGroupCoordX < RUN_SIZE ) ? ( OutputWidth() - iGroupCoordX ) : RUN_SIZE;
+        float* pState = (float*)LDS.Reserve( sizeof( float ) * 4 * 4 * RUN_SIZE );
+
+        assert( Input.m_uWidth >= (unsigned int)OutputWidth() && Input.m_uHeight >= (unsigned int)OutputHeight() );
+
+        m_pKernels->m_pfnRecursiveGaussianLines( m_Coefficients, &Input.Row( 0 )[iGroupCoordX].x, (int)Input.m_uPitch * 4,
+                                                 &m_pOutput->Row( 0 )[iGroupCoordX].x, (int)m_pOutput->m_uPitch * 4, OutputHeight(), iNumColumns * 4, pState );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+
+//--------------------------------------------------------------------------------------
+// File: RecursiveGaussian.h
+//
+// Recursive (IIR) Gaussian filter passes, after Young and van Vliet. Each pass runs a
+// third order recursion along the lines and back, so the cost per pixel does not depend
+// on the deviation, for the very wide blurs that are out of reach of KERNEL_RADIUS.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+#include "SIMD.h"
+
+
+namespace CPUFilter
+{
+    // Smallest deviation the recursion approximates well
+    static const float MIN_RECURSIVE_DEVIATION = 0.5f;
+
+    // Computes the coefficients of the recursion for a deviation, in pixels
+    void ComputeRecursiveGaussian( float fDeviation, RecursiveGaussianCoefficients& Coefficients );
+
+
+    //--------------------------------------------------------------------------------------
+    // Common state of the recursive Gaussian passes. Like the other filters, the deviation
+    // defaults to half the kernel radius, but can be set far beyond MAX_KERNEL_RADIUS.
+    //--------------------------------------------------------------------------------------
+    class RecursiveGaussianFilter : public FilterPass
+    {
+    public:
+
+        RecursiveGaussianFilter();
+
+        // Only sets the default deviation, the approximate filter has no meaning here
+        virtual void SetKernel( int iKernelRadius, bool bApproximate );
+
+        // Overrides the deviation, or 0 for half the kernel radius
+        void SetDeviation( float fDeviation );
+        float GetDeviation() const { return ( m_fDeviation > 0.0f ) ? m_fDeviation : (float)m_iKernelRadius * 0.5f; }
+
+        // Defaults to the best instruction set of the CPU
+        void SetISA( ISA_TYPE ISA ) { m_pKernels = &GetFilterKernels( ISA ); }
+        ISA_TYPE GetISA() const { return m_pKernels->m_ISA; }
+
+    protected:
+
+        const FilterKernels*            m_pKernels;
+        float                           m_fDeviation;
+        RecursiveGaussianCoefficients   m_Coefficients;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Horizontal pass: the lines of a group are transposed into scratch memory, a vector
+    // width of lines at a time, so that every lane of a vector carries a different line
+    //--------------------------------------------------------------------------------------
+    class RecursiveGaussianX : public RecursiveGaussianFilter
+    {
+    public:
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Vertical pass: the rows are already laid out with a column per lane, so each group
+    // sweeps down a strip of RUN_SIZE columns, a row at a time, in place in the output
+    //--------------------------------------------------------------------------------------
+    class RecursiveGaussianY : public RecursiveGaussianFilter
+    {
+    public:
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
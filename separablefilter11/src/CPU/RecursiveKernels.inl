@@ -0,0 +1,247 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+
+//--------------------------------------------------------------------------------------
+// File: RecursiveKernels.inl
+//
+// Vectorized recursive Gaussian kernels, written against the VecF type of the including
+// translation unit (Kernels_*.cpp). Each lane of a vector carries a different line.
+//--------------------------------------------------------------------------------------
+
+
+//--------------------------------------------------------------------------------------
+// Filters N vectors of lanes causally along the lines, then anti-causally back, keeping
+// the state of each lane in its value, difference and second difference. The anti-causal
+// state is started from the causal state at the end, as if the lines carried on with
+// their last value forever (Triggs and Sdika).
+//--------------------------------------------------------------------------------------
+template< int N >
+static CPUFILTER_FORCEINLINE void RecursiveGaussianVectors( const RecursiveGaussianCoefficients& C, const float* pInput, int iInputStride, float* pOutput, int iOutputStride, int iLength )
+{
+    const VecF B = VecF::Set1( C.m_fB );
+    const VecF K1 = VecF::Set1( C.m_fK1 );
+    const VecF K3 = VecF::Set1( C.m_fK3 );
+    VecF Y[N], D[N], E[N], U[N];
+
+    // The last input is read first, as the output may overwrite it
+    const float* pLast = pInput + (size_t)( iLength - 1 ) * iInputStride;
+    for( int k = 0; k < N; ++k )
+    {
+        U[k] = VecF::LoadU( pLast + k * VecF::WIDTH );
+        Y[k] = VecF::LoadU( pInput + k * VecF::WIDTH );
+        D[k] = VecF::Zero();
+        E[k] = VecF::Zero();
+    }
+
+    for( int n = 0; n < iLength; ++n )
+    {
+        const float* pIn = pInput + (size_t)n * iInputStride;
+        float* pOut = pOutput + (size_t)n * iOutputStride;
+
+        for( int k = 0; k < N; ++k )
+        {
+            VecF F = MulAdd( B, VecF::LoadU( pIn + k * VecF::WIDTH ) - Y[k], MulAdd( K1, D[k], K3 * E[k] ) );
+            E[k] = E[k] + F;
+            D[k] = D[k] + E[k];
+            Y[k] = Y[k] + D[k];
+            Y[k].StoreU( pOut + k * VecF::WIDTH );
+        }
+    }
+
+    float* pOut = pOutput + (size_t)( iLength - 1 ) * iOutputStride;
+    for( int k = 0; k < N; ++k )
+    {
+        const VecF Deviation = Y[k] - U[k];
+        const VecF D0 = D[k];
+        const VecF E0 = E[k];
+        Y[k] = U[k] + MulAdd( VecF::Set1( C.m_fBoundary[0] ), Deviation, MulAdd( VecF::Set1( C.m_fBoundary[1] ), D0, VecF::Set1( C.m_fBoundary[2] ) * E0 ) );
+        D[k] = MulAdd( VecF::Set1( C.m_fBoundary[3] ), Deviation, MulAdd( VecF::Set1( C.m_fBoundary[4] ), D0, VecF::Set1( C.m_fBoundary[5] ) * E0 ) );
+        E[k] = MulAdd( VecF::Set1( C.m_fBoundary[6] ), Deviation, MulAdd( VecF::Set1( C.m_fBoundary[7] ), D0, VecF::Set1( C.m_fBoundary[8] ) * E0 ) );
+        Y[k].StoreU( pOut + k * VecF::WIDTH );
+    }
+
+    for( int n = iLength - 2; n >= 0; --n )
+    {
+        float* pOut = pOutput + (size_t)n * iOutputStride;
+
+        for( int k = 0; k < N; ++k )
+        {
+            VecF F = MulAdd( B, VecF::LoadU( pOut + k * VecF::WIDTH ) - Y[k], MulAdd( K1, D[k], K3 * E[k] ) );
+            E[k] = E[k] + F;
+            D[k] = D[k] + E[k];
+            Y[k] = Y[k] + D[k];
+            Y[k].StoreU( pOut + k * VecF::WIDTH );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// RecursiveGaussianVectors for a single lane
+//--------------------------------------------------------------------------------------
+static void RecursiveGaussianLane( const RecursiveGaussianCoefficients& C, const float* pInput, int iInputStride, float* pOutput, int iOutputStride, int iLength )
+{
+    const float fU = pInput[(size_t)( iLength - 1 ) * iInputStride];
+    float fY = pInput[0];
+    float fD = 0.0f;
+    float fE = 0.0f;
+
+    for( int n = 0; n < iLength; ++n )
+    {
+        fE += C.m_fB * ( pInput[(size_t)n * iInputStride] - fY ) + C.m_fK1 * fD + C.m_fK3 * fE;
+        fD += fE;
+        fY += fD;
+        pOutput[(size_t)n * iOutputStride] = fY;
+    }
+
+    const float fDeviation = fY - fU;
+    const float fD0 = fD;
+    const float fE0 = fE;
+    fY = fU + C.m_fBoundary[0] * fDeviation + C.m_fBoundary[1] * fD0 + C.m_fBoundary[2] * fE0;
+    fD = C.m_fBoundary[3] * fDeviation + C.m_fBoundary[4] * fD0 + C.m_fBoundary[5] * fE0;
+    fE = C.m_fBoundary[6] * fDeviation + C.m_fBoundary[7] * fD0 + C.m_fBoundary[8] * fE0;
+    pOutput[(size_t)( iLength - 1 ) * iOutputStride] = fY;
+
+    for( int n = iLength - 2; n >= 0; --n )
+    {
+        float* pOut = pOutput + (size_t)n * iOutputStride;
+        fE += C.m_fB * ( *pOut - fY ) + C.m_fK1 * fD + C.m_fK3 * fE;
+        fD += fE;
+        fY += fD;
+        *pOut = fY;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// RecursiveGaussianVectors for any number of vectors, sweeping across all of them one
+// step of the lines at a time, with their state in memory rather than registers. For
+// lines down the rows of a surface, this reads whole rows rather than walking down the
+// surface one cache line at a time.
+//--------------------------------------------------------------------------------------
+static void RecursiveGaussianSweep( const RecursiveGaussianCoefficients& C, const float* pInput, int iInputStride, float* pOutput, int iOutputStride, int iLength, int iVectors, VecF* pState )
+{
+    const VecF B = VecF::Set1( C.m_fB );
+    const VecF K1 = VecF::Set1( C.m_fK1 );
+    const VecF K3 = VecF::Set1( C.m_fK3 );
+
+    // y, D, E and the last input of each vector, read first as the output may overwrite it
+    const float* pLast = pInput + (size_t)( iLength - 1 ) * iInputStride;
+    for( int k = 0; k < iVectors; ++k )
+    {
+        VecF* pY = pState + k * 4;
+        pY[0] = VecF::LoadU( pInput + k * VecF::WIDTH );
+        pY[1] = VecF::Zero();
+        pY[2] = VecF::Zero();
+        pY[3] = VecF::LoadU( pLast + k * VecF::WIDTH );
+    }
+
+    for( int n = 0; n < iLength; ++n )
+    {
+        const float* pIn = pInput + (size_t)n * iInputStride;
+        float* pOut = pOutput + (size_t)n * iOutputStride;
+
+        for( int k = 0; k < iVectors; ++k )
+        {
+            VecF* pY = pState + k * 4;
+            VecF F = MulAdd( B, VecF::LoadU( pIn + k * VecF::WIDTH ) - pY[0], MulAdd( K1, pY[1], K3 * pY[2] ) );
+            VecF E = pY[2] + F;
+            VecF D = pY[1] + E;
+            VecF Y = pY[0] + D;
+            pY[0] = Y; pY[1] = D; pY[2] = E;
+            Y.StoreU( pOut + k * VecF::WIDTH );
+        }
+    }
+
+    float* pOut = pOutput + (size_t)( iLength - 1 ) * iOutputStride;
+    for( int k = 0; k < iVectors; ++k )
+    {
+        VecF* pY = pState + k * 4;
+        const VecF Deviation = pY[0] - pY[3];
+        const VecF D0 = pY[1];
+        const VecF E0 = pY[2];
+        pY[0] = pY[3] + MulAdd( VecF::Set1( C.m_fBoundary[0] ), Deviation, MulAdd( VecF::Set1( C.m_fBoundary[1] ), D0, VecF::Set1( C.m_fBoundary[2] ) * E0 ) );
+        pY[1] = MulAdd( VecF::Set1( C.m_fBoundary[3] ), Deviation, MulAdd( VecF::Set1( C.m_fBoundary[4] ), D0, VecF::Set1( C.m_fBoundary[5] ) * E0 ) );
+        pY[2] = MulAdd( VecF::Set1( C.m_fBoundary[6] ), Deviation, MulAdd( VecF::Set1( C.m_fBoundary[7] ), D0, VecF::Set1( C.m_fBoundary[8] ) * E0 ) );
+        pY[0].StoreU( pOut + k * VecF::WIDTH );
+    }
+
+    for( int n = iLength - 2; n >= 0; --n )
+    {
+        float* pOut = pOutput + (size_t)n * iOutputStride;
+
+        for( int k = 0; k < iVectors; ++k )
+        {
+            VecF* pY = pState + k * 4;
+            VecF F = MulAdd( B, VecF::LoadU( pOut + k * VecF::WIDTH ) - pY[0], MulAdd( K1, pY[1], K3 * pY[2] ) );
+            VecF E = pY[2] + F;
+            VecF D = pY[1] + E;
+            VecF Y = pY[0] + D;
+            pY[0] = Y; pY[1] = D; pY[2] = E;
+            Y.StoreU( pOut + k * VecF::WIDTH );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Filters iCount lanes along lines of iLength values, iInputStride and iOutputStride
+// floats apart. Up to 4 vectors are kept in registers, which hides the latency of the
+// recursion; more are swept across with their state in pState.
+//--------------------------------------------------------------------------------------
+static void RecursiveGaussianLines( const RecursiveGaussianCoefficients& C, const float* pInput, int iInputStride, float* pOutput, int iOutputStride, int iLength, int iCount, float* pState )
+{
+    const int iVectors = iCount / VecF::WIDTH;
+
+    switch( iVectors )
+    {
+    case 0:
+        break;
+    case 1:
+        RecursiveGaussianVectors< 1 >( C, pInput, iInputStride, pOutput, iOutputStride, iLength );
+        break;
+    case 2:
+        RecursiveGaussianVectors< 2 >( C, pInput, iInputStride, pOutput, iOutputStride, iLength );
+        break;
+    case 3:
+        RecursiveGaussianVectors< 3 >( C, pInput, iInputStride, pOutput, iOutputStride, iLength );
+        break;
+    case 4:
+        RecursiveGaussianVectors< 4 >( C, pInput, iInputStride, pOutput, iOutputStride, iLength );
+        break;
+    default:
+        RecursiveGaussianSweep( C, pInput, iInputStride, pOutput, iOutputStride, iLength, iVectors, (VecF*)pState );
+        break;
+    }
+
+    for( int i = iVectors * VecF::WIDTH; i < iCount; ++i )
+    {
+        RecursiveGaussianLane( C, pInput + i, iInputStride, pOutput + i, iOutputStride, iLength );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
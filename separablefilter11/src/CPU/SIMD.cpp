@@ -0,0 +1,115 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: SIMD.cpp
+//
+// Runtime selection of the vectorized CPU kernels.
+//--------------------------------------------------------------------------------------
+
+
+#include "SIMD.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Fills out the tables of all instruction sets compiled on this platform
+    //--------------------------------------------------------------------------------------
+    class FilterKernelTables
+    {
+    public:
+
+        FilterKernelTables()
+        {
+            memset( m_Kernels, 0, sizeof( m_Kernels ) );
+
+            InitFilterKernels_Scalar( m_Kernels[ISA_TYPE_SCALAR] );
+        #if CPUFILTER_X86
+            InitFilterKernels_SSE41( m_Kernels[ISA_TYPE_SSE41] );
+            InitFilterKernels_AVX2( m_Kernels[ISA_TYPE_AVX2] );
+        #endif
+        #if CPUFILTER_AVX512
+            InitFilterKernels_AVX512( m_Kernels[ISA_TYPE_AVX512] );
+        #endif
+        }
+
+        FilterKernels m_Kernels[ISA_TYPE_MAX];
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Returns the kernels for the given instruction set, which must be supported
+    //--------------------------------------------------------------------------------------
+    const FilterKernels& GetFilterKernels( ISA_TYPE ISA )
+    {
+        static const FilterKernelTables s_Tables;
+
+        assert( ISA < ISA_TYPE_MAX );
+        assert( GetCPUInfo().m_bSupportsISA[ISA] );
+
+        return s_Tables.m_Kernels[ISA];
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Returns the kernels for the best instruction set of this CPU
+    //--------------------------------------------------------------------------------------
+    const FilterKernels& GetFilterKernels()
+    {
+        return GetFilterKernels( GetCPUInfo().m_BestISA );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sizes the strips of the vertical passes, so that the window fills half of the L1 cache,
+    // or an eighth of the L2 cache, which is shared with the other hardware thread and the
+    // prefetched rows. Strips narrower than MIN_STRIP_WIDTH texels are too short for the
+    // prefetcher, so large windows are sized for the L2 cache instead.
+    //--------------------------------------------------------------------------------------
+    int ComputeStripWidth( unsigned int uBytesPerColumn )
+    {
+        static const int MIN_STRIP_WIDTH = 128;
+
+        const CPUInfo& Info = GetCPUInfo();
+
+        // Whole cache lines, and whole iterations of the widest kernel
+        const int iTexelsPerLine = (int)( Info.m_uCacheLineSize / sizeof( Float4 ) );
+        const int iAlignment = ( iTexelsPerLine > MAX_VECTOR_WIDTH ) ? iTexelsPerLine : MAX_VECTOR_WIDTH;
+
+        int iStripWidth = (int)( Info.m_uL1DataCacheSize / 2 / uBytesPerColumn );
+        if( iStripWidth < MIN_STRIP_WIDTH )
+        {
+            iStripWidth = (int)( Info.m_uL2CacheSize / 8 / uBytesPerColumn );
+        }
+
+        iStripWidth -= iStripWidth % iAlignment;
+
+        return ( iStripWidth > iAlignment ) ? iStripWidth : iAlignment;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
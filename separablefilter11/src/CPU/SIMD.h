@@ -0,0 +1,207 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: SIMD.h
+//
+// Runtime selection of the vectorized CPU kernels. Each instruction set has its own
+// translation unit (Kernels_*.cpp) that compiles the shared kernel source (*Kernels.inl)
+// against its vector type, and fills out a FilterKernels table.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+#include "CPUInfo.h"
+#include "HalfFloat.h"
+
+
+// Instruction sets that can be compiled on this platform
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __x86_64__ ) || defined( __i386__ )
+    #define CPUFILTER_X86 1
+#else
+    #define CPUFILTER_X86 0
+#endif
+
+// AVX-512 intrinsics need VS2017 or newer
+#if CPUFILTER_X86 && ( !defined( _MSC_VER ) || ( _MSC_VER >= 1910 ) )
+    #define CPUFILTER_AVX512 1
+#else
+    #define CPUFILTER_AVX512 0
+#endif
+
+// Used by the kernels unrolled through templates, which are too large for the inlining heuristics
+#if defined( _MSC_VER )
+    #define CPUFILTER_FORCEINLINE __forceinline
+#else
+    #define CPUFILTER_FORCEINLINE inline __attribute__(( always_inline ))
+#endif
+
+
+namespace CPUFilter
+{
+    // Widest vector of any instruction set, in floats
+    static const int MAX_VECTOR_WIDTH = 16;
+
+    // Convolves iNumPixels planar pixels with iKernelDiameter normalized weights. The planes
+    // start KERNEL_RADIUS texels before the first output, and are padded to a whole vector.
+    typedef void ( *PFN_GAUSSIAN_ROW )( const float* pWeights, int iKernelDiameter, const float* pRed, const float* pGreen, const float* pBlue, int iNumPixels, Float4* pOutput );
+
+    // Convolves iCount floats of interleaved texels down the iKernelDiameter rows of ppRows,
+    // with normalized weights. Alpha is output as 1.
+    typedef void ( *PFN_GAUSSIAN_COLUMN )( const float* pWeights, int iKernelDiameter, const float* const* ppRows, int iCount, float* pOutput );
+
+    // Precision of the fixed point Gaussian of 8 bit unorm surfaces: the weights are 16 bit
+    // with FIXED_POINT_WEIGHT_BITS fractional bits, and the horizontally filtered lines keep
+    // FIXED_POINT_LINE_BITS fractional bits of each 8 bit channel, which still fits 16 bits
+    static const int FIXED_POINT_WEIGHT_BITS = 14;
+    static const int FIXED_POINT_LINE_BITS = 7;
+
+
+    //--------------------------------------------------------------------------------------
+    // Coefficients of the recursive Gaussian kernels, see ComputeRecursiveGaussian. The
+    // recursion is written in differences, F = B * ( x - y ) + K1 * D + K3 * E, then E += F,
+    // D += E and y += D, which keeps the precision of floats for poles close to 1.
+    //--------------------------------------------------------------------------------------
+    struct RecursiveGaussianCoefficients
+    {
+        float   m_fB;
+        float   m_fK1;
+        float   m_fK3;
+        float   m_fBoundary[9];     // Anti-causal state from the causal state at the end, row major
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Table of kernels compiled for one instruction set
+    //--------------------------------------------------------------------------------------
+    class FilterKernels
+    {
+    public:
+
+        ISA_TYPE    m_ISA;
+        int         m_iVectorWidth;     // In floats
+
+        // Converts iCount interleaved texels into planar red, green and blue, and alpha if
+        // pAlpha is not NULL
+        void ( *m_pfnDeinterleaveRow )( const Float4* pSrc, int iCount, float* pRed, float* pGreen, float* pBlue, float* pAlpha );
+
+        // The reverse, with alpha set to 1 if pAlpha is NULL
+        void ( *m_pfnInterleaveRow )( const float* pRed, const float* pGreen, const float* pBlue, const float* pAlpha, int iCount, Float4* pDst );
+
+        // Gaussian kernels for any weights, looping over the taps
+        PFN_GAUSSIAN_ROW        m_pfnGaussianRow;
+        PFN_GAUSSIAN_COLUMN     m_pfnGaussianColumn;
+
+        // The same kernels specialized for the radius of each KERNEL_RADIUS_TYPE, with the taps
+        // unrolled and the weights of GaussianWeights.h compiled in. pWeights and
+        // iKernelDiameter are ignored. NULL for the radii where the looped kernels are faster.
+        PFN_GAUSSIAN_ROW        m_pfnGaussianRowFixed[KERNEL_RADIUS_TYPE_MAX];
+        PFN_GAUSSIAN_COLUMN     m_pfnGaussianColumnFixed[KERNEL_RADIUS_TYPE_MAX];
+
+        // Gaussian kernels for planar layouts, over iCount values of a single channel. The row
+        // kernel reads from KERNEL_RADIUS values before the first output to KERNEL_RADIUS after
+        // the last, and no further.
+        void ( *m_pfnGaussianRowPlane )( const float* pWeights, int iKernelDiameter, const float* pSrc, int iCount, float* pDst );
+        PFN_GAUSSIAN_COLUMN     m_pfnGaussianColumnPlane;
+
+        // Convert iCount floats of interleaved texels to 8 or 16 bit unorm, for the ring buffer
+        // of the reduced LDS_PRECISION modes, rounding to nearest and saturating
+        void ( *m_pfnPackRowUNorm8 )( const float* pSrc, int iCount, unsigned char* pDst );
+        void ( *m_pfnPackRowUNorm16 )( const float* pSrc, int iCount, unsigned short* pDst );
+
+        // m_pfnGaussianColumn over rows packed by the above
+        void ( *m_pfnGaussianColumnUNorm8 )( const float* pWeights, int iKernelDiameter, const unsigned char* const* ppRows, int iCount, float* pOutput );
+        void ( *m_pfnGaussianColumnUNorm16 )( const float* pWeights, int iKernelDiameter, const unsigned short* const* ppRows, int iCount, float* pOutput );
+
+        // Convert iCount values between floats and halves, as FloatToHalf and HalfToFloat
+        void ( *m_pfnFloatToHalfRow )( const float* pSrc, int iCount, unsigned short* pDst );
+        void ( *m_pfnHalfToFloatRow )( const unsigned short* pSrc, int iCount, float* pDst );
+
+        // m_pfnGaussianColumn over rows of halves
+        void ( *m_pfnGaussianColumnHalf )( const float* pWeights, int iKernelDiameter, const unsigned short* const* ppRows, int iCount, float* pOutput );
+
+        // Widens iCount 8 bit unorm channels to 16 bits, and pairs up iCount 16 bit channels
+        // of two rows into ints, for the fixed point kernels below
+        void ( *m_pfnWidenRowUNorm8 )( const unsigned char* pSrc, int iCount, short* pDst );
+        void ( *m_pfnPairRows16 )( const short* pFirst, const short* pSecond, int iCount, int* pDst );
+
+        // Fixed point Gaussian over iCount channels of paired rows. Each pair of taps is
+        // weighted by a pair of 16 bit weights packed into one int of pWeightPairs, and the
+        // 32 bit sums are rounded to FIXED_POINT_LINE_BITS fractional bits (row), or to 8 bit
+        // unorm (column).
+        void ( *m_pfnGaussianFixedPointRow )( const int* pWeightPairs, int iNumPairs, const int* const* ppPairs, int iCount, short* pOutput );
+        void ( *m_pfnGaussianFixedPointColumn )( const int* pWeightPairs, int iNumPairs, const int* const* ppPairs, int iCount, unsigned char* pOutput );
+
+        // Converts iCount depth texels to view space depth with g_f4ProjParams, and to the focal
+        // value of BilateralFilter.hlsl if pFocal is not NULL
+        void ( *m_pfnLinearizeDepthRow )( const Float4* pDepth, int iCount, const float* pProjParams, float* pLinearDepth, float* pFocal );
+
+        // Bilateral filters iNumPixels planar pixels, from one pointer per tap to planes of red,
+        // green, blue, view space depth and focal, iPlaneStride floats apart. The planes must be
+        // padded to a whole vector.
+        void ( *m_pfnBilateralTaps )( const float* pWeights, int iKernelDiameter, const float* const* ppTaps, int iPlaneStride, int iNumPixels, bool bOutputFocal, Float4* pOutput );
+
+        // As m_pfnBilateralTaps, but taps beyond the circle of confusion of the sample that
+        // weights them, its focal value times fKernelRadius, have no weight, and are skipped
+        void ( *m_pfnBilateralGatherTaps )( const float* pWeights, int iKernelDiameter, const float* const* ppTaps, int iPlaneStride, int iNumPixels, float fKernelRadius, bool bOutputFocal, Float4* pOutput );
+
+        // Joint bilateral filter of planar pixels, with ppTaps as m_pfnBilateralTaps but to the
+        // red, green, blue and alpha planes, and iGuidePlanes planes of the scaled guide
+        void ( *m_pfnJointBilateralTaps )( const float* pWeights, int iKernelDiameter, const float* const* ppTaps, int iPlaneStride, int iGuidePlanes, const float* pRangeWeights, int iNumPixels, Float4* pOutput );
+
+        // Recursive Gaussian of iCount lanes along lines of iLength values, iInputStride and
+        // iOutputStride floats apart, clamped to the ends of the lines. The output may be the
+        // input. pState is scratch memory of 4 * iCount floats, aligned to MEMORY_ALIGNMENT.
+        void ( *m_pfnRecursiveGaussianLines )( const RecursiveGaussianCoefficients& Coefficients, const float* pInput, int iInputStride, float* pOutput, int iOutputStride, int iLength, int iCount, float* pState );
+
+        // Hashes the bits of iNumRows rows of iCount floats, uPitch floats apart, chained from uSeed
+        unsigned long long ( *m_pfnHashRows )( const float* pSrc, size_t uPitch, int iCount, int iNumRows, unsigned long long uSeed );
+    };
+
+    // Returns the kernels for the given instruction set, which must be supported
+    const FilterKernels& GetFilterKernels( ISA_TYPE ISA );
+
+    // Returns the kernels for the best instruction set of this CPU
+    const FilterKernels& GetFilterKernels();
+
+    // Width in texels of the column strips walked by the vertical passes, so that a window of
+    // uBytesPerColumn bytes per column stays in the caches of this CPU
+    int ComputeStripWidth( unsigned int uBytesPerColumn );
+
+    // Per instruction set tables, defined in Kernels_*.cpp
+    void InitFilterKernels_Scalar( FilterKernels& Kernels );
+#if CPUFILTER_X86
+    void InitFilterKernels_SSE41( FilterKernels& Kernels );
+    void InitFilterKernels_AVX2( FilterKernels& Kernels );
+#endif
+#if CPUFILTER_AVX512
+    void InitFilterKernels_AVX512( FilterKernels& Kernels );
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
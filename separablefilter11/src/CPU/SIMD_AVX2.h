@@ -0,0 +1,223 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: SIMD_AVX2.h
+//
+// 8 lane vector type for AVX2 + FMA3. Only include from Kernels_AVX2.cpp.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+#include "HalfFloat.h"
+
+#include <immintrin.h>
+
+
+namespace CPUFilter
+{
+namespace AVX2
+{
+    struct VecF
+    {
+        static const int WIDTH = 8;
+
+        __m256 v;
+
+        static VecF Make( __m256 m ) { VecF r; r.v = m; return r; }
+        static VecF Zero() { return Make( _mm256_setzero_ps() ); }
+        static VecF Set1( float f ) { return Make( _mm256_set1_ps( f ) ); }
+        static VecF Load( const float* p ) { return Make( _mm256_load_ps( p ) ); }
+        static VecF LoadU( const float* p ) { return Make( _mm256_loadu_ps( p ) ); }
+        void Store( float* p ) const { _mm256_store_ps( p, v ); }
+        void StoreU( float* p ) const { _mm256_storeu_ps( p, v ); }
+    };
+
+    inline VecF operator+( VecF a, VecF b ) { return VecF::Make( _mm256_add_ps( a.v, b.v ) ); }
+    inline VecF operator-( VecF a, VecF b ) { return VecF::Make( _mm256_sub_ps( a.v, b.v ) ); }
+    inline VecF operator*( VecF a, VecF b ) { return VecF::Make( _mm256_mul_ps( a.v, b.v ) ); }
+    inline VecF operator/( VecF a, VecF b ) { return VecF::Make( _mm256_div_ps( a.v, b.v ) ); }
+    inline VecF MulAdd( VecF a, VecF b, VecF c ) { return VecF::Make( _mm256_fmadd_ps( a.v, b.v, c.v ) ); }
+    inline VecF Min( VecF a, VecF b ) { return VecF::Make( _mm256_min_ps( a.v, b.v ) ); }
+    inline VecF Max( VecF a, VecF b ) { return VecF::Make( _mm256_max_ps( a.v, b.v ) ); }
+
+    // ( a < b ) ? x : y, per lane
+    inline VecF SelectLess( VecF a, VecF b, VecF x, VecF y ) { return VecF::Make( _mm256_blendv_ps( y.v, x.v, _mm256_cmp_ps( a.v, b.v, _CMP_LT_OQ ) ) ); }
+
+    // pTable[(int)Index], per lane. The indices must be within the table.
+    inline VecF LookupTable( const float* pTable, VecF Index ) { return VecF::Make( _mm256_i32gather_ps( pTable, _mm256_cvttps_epi32( Index.v ), 4 ) ); }
+
+    // Unorm values, converted to and from floats in the range of the format. The stores round
+    // to nearest, so the values must already be clamped to the range.
+    inline VecF LoadUNorm( const unsigned char* p )
+    {
+        return VecF::Make( _mm256_cvtepi32_ps( _mm256_cvtepu8_epi32( _mm_loadl_epi64( (const __m128i*)p ) ) ) );
+    }
+
+    inline VecF LoadUNorm( const unsigned short* p )
+    {
+        return VecF::Make( _mm256_cvtepi32_ps( _mm256_cvtepu16_epi32( _mm_loadu_si128( (const __m128i*)p ) ) ) );
+    }
+
+    // The packs work within 128 bit lanes, so the halves are packed together
+    inline __m128i PackUNorm16( VecF a )
+    {
+        __m256i m = _mm256_cvtps_epi32( a.v );
+        return _mm_packus_epi32( _mm256_castsi256_si128( m ), _mm256_extracti128_si256( m, 1 ) );
+    }
+
+    inline void StoreUNorm( unsigned char* p, VecF a )
+    {
+        __m128i m = PackUNorm16( a );
+        _mm_storel_epi64( (__m128i*)p, _mm_packus_epi16( m, m ) );
+    }
+
+    inline void StoreUNorm( unsigned short* p, VecF a )
+    {
+        _mm_storeu_si128( (__m128i*)p, PackUNorm16( a ) );
+    }
+
+    // Halves, converted with rounding to nearest even as FloatToHalf
+    inline VecF LoadHalf( const unsigned short* p )
+    {
+        return VecF::Make( _mm256_cvtph_ps( _mm_loadu_si128( (const __m128i*)p ) ) );
+    }
+
+    inline void StoreHalf( unsigned short* p, VecF a )
+    {
+        _mm_storeu_si128( (__m128i*)p, _mm256_cvtps_ph( a.v, _MM_FROUND_TO_NEAREST_INT ) );
+    }
+
+    //--------------------------------------------------------------------------------------
+    // 4x4 transpose within each 128 bit lane
+    //--------------------------------------------------------------------------------------
+    inline void Transpose4x4Lanes( __m256& m0, __m256& m1, __m256& m2, __m256& m3 )
+    {
+        __m256 t0 = _mm256_unpacklo_ps( m0, m1 );
+        __m256 t1 = _mm256_unpacklo_ps( m2, m3 );
+        __m256 t2 = _mm256_unpackhi_ps( m0, m1 );
+        __m256 t3 = _mm256_unpackhi_ps( m2, m3 );
+        m0 = _mm256_shuffle_ps( t0, t1, 0x44 );
+        m1 = _mm256_shuffle_ps( t0, t1, 0xEE );
+        m2 = _mm256_shuffle_ps( t2, t3, 0x44 );
+        m3 = _mm256_shuffle_ps( t2, t3, 0xEE );
+    }
+
+    // Texels i and i + 4 share a register, so the transpose within lanes leaves channels in order
+    inline __m256 LoadTexelPair( const Float4* p, int i )
+    {
+        return _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( &p[i].x ) ), _mm_loadu_ps( &p[i + 4].x ), 1 );
+    }
+
+    inline void StoreTexelPair( Float4* p, int i, __m256 m )
+    {
+        _mm_storeu_ps( &p[i].x, _mm256_castps256_ps128( m ) );
+        _mm_storeu_ps( &p[i + 4].x, _mm256_extractf128_ps( m, 1 ) );
+    }
+
+    inline void LoadDeinterleaved( const Float4* p, VecF& R, VecF& G, VecF& B, VecF& A )
+    {
+        __m256 m0 = LoadTexelPair( p, 0 );
+        __m256 m1 = LoadTexelPair( p, 1 );
+        __m256 m2 = LoadTexelPair( p, 2 );
+        __m256 m3 = LoadTexelPair( p, 3 );
+        Transpose4x4Lanes( m0, m1, m2, m3 );
+        R.v = m0; G.v = m1; B.v = m2; A.v = m3;
+    }
+
+    inline void StoreInterleaved( Float4* p, VecF R, VecF G, VecF B, VecF A )
+    {
+        __m256 m0 = R.v, m1 = G.v, m2 = B.v, m3 = A.v;
+        Transpose4x4Lanes( m0, m1, m2, m3 );
+        StoreTexelPair( p, 0, m0 );
+        StoreTexelPair( p, 1, m1 );
+        StoreTexelPair( p, 2, m2 );
+        StoreTexelPair( p, 3, m3 );
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Integer vector of the fixed point kernels: WIDTH 32 bit lanes, each holding a pair of
+    // 16 bit channels, one from each of two taps
+    //--------------------------------------------------------------------------------------
+    struct VecI
+    {
+        static const int WIDTH = 8;
+
+        __m256i v;
+
+        static VecI Make( __m256i m ) { VecI r; r.v = m; return r; }
+        static VecI Set1( int i ) { return Make( _mm256_set1_epi32( i ) ); }
+        static VecI Load( const int* p ) { return Make( _mm256_loadu_si256( (const __m256i*)p ) ); }
+        void Store( int* p ) const { _mm256_storeu_si256( (__m256i*)p, v ); }
+
+        // 2 * WIDTH 16 bit channels
+        static VecI LoadI16( const short* p ) { return Make( _mm256_loadu_si256( (const __m256i*)p ) ); }
+        static VecI LoadUNorm8( const unsigned char* p ) { return Make( _mm256_cvtepu8_epi16( _mm_loadu_si128( (const __m128i*)p ) ) ); }
+        void StoreI16( short* p ) const { _mm256_storeu_si256( (__m256i*)p, v ); }
+    };
+
+    inline VecI operator+( VecI a, VecI b ) { return VecI::Make( _mm256_add_epi32( a.v, b.v ) ); }
+    inline VecI ShiftRight( VecI a, int iShift ) { return VecI::Make( _mm256_sra_epi32( a.v, _mm_cvtsi32_si128( iShift ) ) ); }
+    inline VecI ShiftRightLogical( VecI a, int iShift ) { return VecI::Make( _mm256_srl_epi32( a.v, _mm_cvtsi32_si128( iShift ) ) ); }
+    inline VecI operator^( VecI a, VecI b ) { return VecI::Make( _mm256_xor_si256( a.v, b.v ) ); }
+    inline VecI MulLo( VecI a, VecI b ) { return VecI::Make( _mm256_mullo_epi32( a.v, b.v ) ); }
+
+    // Sums of the products of the pairs (pmaddwd)
+    inline VecI MulAddPairs( VecI a, VecI b ) { return VecI::Make( _mm256_madd_epi16( a.v, b.v ) ); }
+
+    // Pairs up the 2 * WIDTH channels of a and b, storing 2 * WIDTH pairs. The unpacks work
+    // within 128 bit lanes, so the lanes are put back in order.
+    inline void StorePairs( int* p, VecI a, VecI b )
+    {
+        const __m256i Lo = _mm256_unpacklo_epi16( a.v, b.v );
+        const __m256i Hi = _mm256_unpackhi_epi16( a.v, b.v );
+        _mm256_storeu_si256( (__m256i*)p, _mm256_permute2x128_si256( Lo, Hi, 0x20 ) );
+        _mm256_storeu_si256( (__m256i*)( p + 8 ), _mm256_permute2x128_si256( Lo, Hi, 0x31 ) );
+    }
+
+    // Saturates the lanes of Lo and then Hi to 2 * WIDTH channels. The pack works within
+    // 128 bit lanes, so the 64 bit halves are put back in order.
+    inline __m256i PackI16( VecI Lo, VecI Hi )
+    {
+        return _mm256_permute4x64_epi64( _mm256_packs_epi32( Lo.v, Hi.v ), 0xD8 );
+    }
+
+    inline void StoreI16( short* p, VecI Lo, VecI Hi )
+    {
+        _mm256_storeu_si256( (__m256i*)p, PackI16( Lo, Hi ) );
+    }
+
+    inline void StoreUNorm8( unsigned char* p, VecI Lo, VecI Hi )
+    {
+        const __m256i m = PackI16( Lo, Hi );
+        _mm_storeu_si128( (__m128i*)p, _mm_packus_epi16( _mm256_castsi256_si128( m ), _mm256_extracti128_si256( m, 1 ) ) );
+    }
+}
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
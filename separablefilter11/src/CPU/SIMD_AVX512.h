@@ -0,0 +1,213 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: SIMD_AVX512.h
+//
+// 16 lane vector type for AVX-512. Only include from Kernels_AVX512.cpp.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+#include "HalfFloat.h"
+
+#include <immintrin.h>
+
+
+namespace CPUFilter
+{
+namespace AVX512
+{
+    struct VecF
+    {
+        static const int WIDTH = 16;
+
+        __m512 v;
+
+        static VecF Make( __m512 m ) { VecF r; r.v = m; return r; }
+        static VecF Zero() { return Make( _mm512_setzero_ps() ); }
+        static VecF Set1( float f ) { return Make( _mm512_set1_ps( f ) ); }
+        static VecF Load( const float* p ) { return Make( _mm512_load_ps( p ) ); }
+        static VecF LoadU( const float* p ) { return Make( _mm512_loadu_ps( p ) ); }
+        void Store( float* p ) const { _mm512_store_ps( p, v ); }
+        void StoreU( float* p ) const { _mm512_storeu_ps( p, v ); }
+    };
+
+    inline VecF operator+( VecF a, VecF b ) { return VecF::Make( _mm512_add_ps( a.v, b.v ) ); }
+    inline VecF operator-( VecF a, VecF b ) { return VecF::Make( _mm512_sub_ps( a.v, b.v ) ); }
+    inline VecF operator*( VecF a, VecF b ) { return VecF::Make( _mm512_mul_ps( a.v, b.v ) ); }
+    inline VecF operator/( VecF a, VecF b ) { return VecF::Make( _mm512_div_ps( a.v, b.v ) ); }
+    inline VecF MulAdd( VecF a, VecF b, VecF c ) { return VecF::Make( _mm512_fmadd_ps( a.v, b.v, c.v ) ); }
+    inline VecF Min( VecF a, VecF b ) { return VecF::Make( _mm512_min_ps( a.v, b.v ) ); }
+    inline VecF Max( VecF a, VecF b ) { return VecF::Make( _mm512_max_ps( a.v, b.v ) ); }
+
+    // ( a < b ) ? x : y, per lane
+    inline VecF SelectLess( VecF a, VecF b, VecF x, VecF y ) { return VecF::Make( _mm512_mask_blend_ps( _mm512_cmp_ps_mask( a.v, b.v, _CMP_LT_OQ ), y.v, x.v ) ); }
+
+    // pTable[(int)Index], per lane. The indices must be within the table.
+    inline VecF LookupTable( const float* pTable, VecF Index ) { return VecF::Make( _mm512_i32gather_ps( _mm512_cvttps_epi32( Index.v ), pTable, 4 ) ); }
+
+    // Unorm values, converted to and from floats in the range of the format. The stores round
+    // to nearest, so the values must already be clamped to the range.
+    inline VecF LoadUNorm( const unsigned char* p )
+    {
+        return VecF::Make( _mm512_cvtepi32_ps( _mm512_cvtepu8_epi32( _mm_loadu_si128( (const __m128i*)p ) ) ) );
+    }
+
+    inline VecF LoadUNorm( const unsigned short* p )
+    {
+        return VecF::Make( _mm512_cvtepi32_ps( _mm512_cvtepu16_epi32( _mm256_loadu_si256( (const __m256i*)p ) ) ) );
+    }
+
+    inline void StoreUNorm( unsigned char* p, VecF a )
+    {
+        _mm_storeu_si128( (__m128i*)p, _mm512_cvtepi32_epi8( _mm512_cvtps_epi32( a.v ) ) );
+    }
+
+    inline void StoreUNorm( unsigned short* p, VecF a )
+    {
+        _mm256_storeu_si256( (__m256i*)p, _mm512_cvtepi32_epi16( _mm512_cvtps_epi32( a.v ) ) );
+    }
+
+    // Halves, converted with rounding to nearest even as FloatToHalf
+    inline VecF LoadHalf( const unsigned short* p )
+    {
+        return VecF::Make( _mm512_cvtph_ps( _mm256_loadu_si256( (const __m256i*)p ) ) );
+    }
+
+    inline void StoreHalf( unsigned short* p, VecF a )
+    {
+        _mm256_storeu_si256( (__m256i*)p, _mm512_cvtps_ph( a.v, _MM_FROUND_TO_NEAREST_INT ) );
+    }
+
+    //--------------------------------------------------------------------------------------
+    // 16 texels are deinterleaved in two steps: first into xy / zw halves of 8 texels,
+    // then into full registers of each channel
+    //--------------------------------------------------------------------------------------
+    inline void LoadDeinterleaved( const Float4* p, VecF& R, VecF& G, VecF& B, VecF& A )
+    {
+        const __m512i XY = _mm512_setr_epi32( 0, 4, 8, 12, 16, 20, 24, 28, 1, 5, 9, 13, 17, 21, 25, 29 );
+        const __m512i ZW = _mm512_setr_epi32( 2, 6, 10, 14, 18, 22, 26, 30, 3, 7, 11, 15, 19, 23, 27, 31 );
+        const __m512i Lo = _mm512_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7, 16, 17, 18, 19, 20, 21, 22, 23 );
+        const __m512i Hi = _mm512_setr_epi32( 8, 9, 10, 11, 12, 13, 14, 15, 24, 25, 26, 27, 28, 29, 30, 31 );
+
+        __m512 m0 = _mm512_loadu_ps( &p[0].x );
+        __m512 m1 = _mm512_loadu_ps( &p[4].x );
+        __m512 m2 = _mm512_loadu_ps( &p[8].x );
+        __m512 m3 = _mm512_loadu_ps( &p[12].x );
+
+        __m512 XY01 = _mm512_permutex2var_ps( m0, XY, m1 );
+        __m512 ZW01 = _mm512_permutex2var_ps( m0, ZW, m1 );
+        __m512 XY23 = _mm512_permutex2var_ps( m2, XY, m3 );
+        __m512 ZW23 = _mm512_permutex2var_ps( m2, ZW, m3 );
+
+        R.v = _mm512_permutex2var_ps( XY01, Lo, XY23 );
+        G.v = _mm512_permutex2var_ps( XY01, Hi, XY23 );
+        B.v = _mm512_permutex2var_ps( ZW01, Lo, ZW23 );
+        A.v = _mm512_permutex2var_ps( ZW01, Hi, ZW23 );
+    }
+
+    inline void StoreInterleaved( Float4* p, VecF R, VecF G, VecF B, VecF A )
+    {
+        const __m512i Lo = _mm512_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7, 16, 17, 18, 19, 20, 21, 22, 23 );
+        const __m512i Hi = _mm512_setr_epi32( 8, 9, 10, 11, 12, 13, 14, 15, 24, 25, 26, 27, 28, 29, 30, 31 );
+        const __m512i T0 = _mm512_setr_epi32( 0, 8, 16, 24, 1, 9, 17, 25, 2, 10, 18, 26, 3, 11, 19, 27 );
+        const __m512i T1 = _mm512_setr_epi32( 4, 12, 20, 28, 5, 13, 21, 29, 6, 14, 22, 30, 7, 15, 23, 31 );
+
+        __m512 XY01 = _mm512_permutex2var_ps( R.v, Lo, G.v );
+        __m512 XY23 = _mm512_permutex2var_ps( R.v, Hi, G.v );
+        __m512 ZW01 = _mm512_permutex2var_ps( B.v, Lo, A.v );
+        __m512 ZW23 = _mm512_permutex2var_ps( B.v, Hi, A.v );
+
+        _mm512_storeu_ps( &p[0].x, _mm512_permutex2var_ps( XY01, T0, ZW01 ) );
+        _mm512_storeu_ps( &p[4].x, _mm512_permutex2var_ps( XY01, T1, ZW01 ) );
+        _mm512_storeu_ps( &p[8].x, _mm512_permutex2var_ps( XY23, T0, ZW23 ) );
+        _mm512_storeu_ps( &p[12].x, _mm512_permutex2var_ps( XY23, T1, ZW23 ) );
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Integer vector of the fixed point kernels: WIDTH 32 bit lanes, each holding a pair of
+    // 16 bit channels, one from each of two taps
+    //--------------------------------------------------------------------------------------
+    struct VecI
+    {
+        static const int WIDTH = 16;
+
+        __m512i v;
+
+        static VecI Make( __m512i m ) { VecI r; r.v = m; return r; }
+        static VecI Set1( int i ) { return Make( _mm512_set1_epi32( i ) ); }
+        static VecI Load( const int* p ) { return Make( _mm512_loadu_si512( (const void*)p ) ); }
+        void Store( int* p ) const { _mm512_storeu_si512( (void*)p, v ); }
+
+        // 2 * WIDTH 16 bit channels
+        static VecI LoadI16( const short* p ) { return Make( _mm512_loadu_si512( (const void*)p ) ); }
+        static VecI LoadUNorm8( const unsigned char* p ) { return Make( _mm512_cvtepu8_epi16( _mm256_loadu_si256( (const __m256i*)p ) ) ); }
+        void StoreI16( short* p ) const { _mm512_storeu_si512( (void*)p, v ); }
+    };
+
+    inline VecI operator+( VecI a, VecI b ) { return VecI::Make( _mm512_add_epi32( a.v, b.v ) ); }
+    inline VecI ShiftRight( VecI a, int iShift ) { return VecI::Make( _mm512_sra_epi32( a.v, _mm_cvtsi32_si128( iShift ) ) ); }
+    inline VecI ShiftRightLogical( VecI a, int iShift ) { return VecI::Make( _mm512_srl_epi32( a.v, _mm_cvtsi32_si128( iShift ) ) ); }
+    inline VecI operator^( VecI a, VecI b ) { return VecI::Make( _mm512_xor_si512( a.v, b.v ) ); }
+    inline VecI MulLo( VecI a, VecI b ) { return VecI::Make( _mm512_mullo_epi32( a.v, b.v ) ); }
+
+    // Sums of the products of the pairs (pmaddwd)
+    inline VecI MulAddPairs( VecI a, VecI b ) { return VecI::Make( _mm512_madd_epi16( a.v, b.v ) ); }
+
+    // Pairs up the 2 * WIDTH channels of a and b, storing 2 * WIDTH pairs. The unpacks work
+    // within 128 bit lanes, so the lanes are put back in order.
+    inline void StorePairs( int* p, VecI a, VecI b )
+    {
+        const __m512i Lo = _mm512_unpacklo_epi16( a.v, b.v );
+        const __m512i Hi = _mm512_unpackhi_epi16( a.v, b.v );
+        _mm512_storeu_si512( (void*)p, _mm512_permutex2var_epi64( Lo, _mm512_setr_epi64( 0, 1, 8, 9, 2, 3, 10, 11 ), Hi ) );
+        _mm512_storeu_si512( (void*)( p + 16 ), _mm512_permutex2var_epi64( Lo, _mm512_setr_epi64( 4, 5, 12, 13, 6, 7, 14, 15 ), Hi ) );
+    }
+
+    // Saturates the lanes of Lo and then Hi to 2 * WIDTH channels. The pack works within
+    // 128 bit lanes, so the 64 bit quarters are put back in order.
+    inline __m512i PackI16( VecI Lo, VecI Hi )
+    {
+        return _mm512_permutexvar_epi64( _mm512_setr_epi64( 0, 2, 4, 6, 1, 3, 5, 7 ), _mm512_packs_epi32( Lo.v, Hi.v ) );
+    }
+
+    inline void StoreI16( short* p, VecI Lo, VecI Hi )
+    {
+        _mm512_storeu_si512( (void*)p, PackI16( Lo, Hi ) );
+    }
+
+    inline void StoreUNorm8( unsigned char* p, VecI Lo, VecI Hi )
+    {
+        const __m512i m = _mm512_max_epi16( PackI16( Lo, Hi ), _mm512_setzero_si512() );
+        _mm256_storeu_si256( (__m256i*)p, _mm512_cvtusepi16_epi8( m ) );
+    }
+}
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,192 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: SIMD_SSE41.h
+//
+// 4 lane vector type for SSE4.1. Only include from Kernels_SSE41.cpp.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+#include "HalfFloat.h"
+
+#include <smmintrin.h>
+
+
+namespace CPUFilter
+{
+namespace SSE41
+{
+    struct VecF
+    {
+        static const int WIDTH = 4;
+
+        __m128 v;
+
+        static VecF Make( __m128 m ) { VecF r; r.v = m; return r; }
+        static VecF Zero() { return Make( _mm_setzero_ps() ); }
+        static VecF Set1( float f ) { return Make( _mm_set1_ps( f ) ); }
+        static VecF Load( const float* p ) { return Make( _mm_load_ps( p ) ); }
+        static VecF LoadU( const float* p ) { return Make( _mm_loadu_ps( p ) ); }
+        void Store( float* p ) const { _mm_store_ps( p, v ); }
+        void StoreU( float* p ) const { _mm_storeu_ps( p, v ); }
+    };
+
+    inline VecF operator+( VecF a, VecF b ) { return VecF::Make( _mm_add_ps( a.v, b.v ) ); }
+    inline VecF operator-( VecF a, VecF b ) { return VecF::Make( _mm_sub_ps( a.v, b.v ) ); }
+    inline VecF operator*( VecF a, VecF b ) { return VecF::Make( _mm_mul_ps( a.v, b.v ) ); }
+    inline VecF operator/( VecF a, VecF b ) { return VecF::Make( _mm_div_ps( a.v, b.v ) ); }
+    inline VecF MulAdd( VecF a, VecF b, VecF c ) { return VecF::Make( _mm_add_ps( _mm_mul_ps( a.v, b.v ), c.v ) ); }
+    inline VecF Min( VecF a, VecF b ) { return VecF::Make( _mm_min_ps( a.v, b.v ) ); }
+    inline VecF Max( VecF a, VecF b ) { return VecF::Make( _mm_max_ps( a.v, b.v ) ); }
+
+    // ( a < b ) ? x : y, per lane
+    inline VecF SelectLess( VecF a, VecF b, VecF x, VecF y ) { return VecF::Make( _mm_blendv_ps( y.v, x.v, _mm_cmplt_ps( a.v, b.v ) ) ); }
+
+    // pTable[(int)Index], per lane. The indices must be within the table.
+    inline VecF LookupTable( const float* pTable, VecF Index )
+    {
+        const __m128i m = _mm_cvttps_epi32( Index.v );
+        return VecF::Make( _mm_setr_ps( pTable[_mm_cvtsi128_si32( m )], pTable[_mm_extract_epi32( m, 1 )], pTable[_mm_extract_epi32( m, 2 )], pTable[_mm_extract_epi32( m, 3 )] ) );
+    }
+
+    // Unorm values, converted to and from floats in the range of the format. The stores round
+    // to nearest, so the values must already be clamped to the range.
+    inline VecF LoadUNorm( const unsigned char* p )
+    {
+        int iPacked;
+        memcpy( &iPacked, p, sizeof( iPacked ) );
+        return VecF::Make( _mm_cvtepi32_ps( _mm_cvtepu8_epi32( _mm_cvtsi32_si128( iPacked ) ) ) );
+    }
+
+    inline VecF LoadUNorm( const unsigned short* p )
+    {
+        return VecF::Make( _mm_cvtepi32_ps( _mm_cvtepu16_epi32( _mm_loadl_epi64( (const __m128i*)p ) ) ) );
+    }
+
+    inline void StoreUNorm( unsigned char* p, VecF a )
+    {
+        __m128i m = _mm_cvtps_epi32( a.v );
+        m = _mm_packus_epi32( m, m );
+        int iPacked = _mm_cvtsi128_si32( _mm_packus_epi16( m, m ) );
+        memcpy( p, &iPacked, sizeof( iPacked ) );
+    }
+
+    inline void StoreUNorm( unsigned short* p, VecF a )
+    {
+        __m128i m = _mm_cvtps_epi32( a.v );
+        _mm_storel_epi64( (__m128i*)p, _mm_packus_epi32( m, m ) );
+    }
+
+    // Halves, converted with rounding to nearest even as FloatToHalf
+    // SSE4.1 has no conversion instructions, so these are done one lane at a time
+    inline VecF LoadHalf( const unsigned short* p )
+    {
+        return VecF::Make( _mm_setr_ps( HalfToFloat( p[0] ), HalfToFloat( p[1] ), HalfToFloat( p[2] ), HalfToFloat( p[3] ) ) );
+    }
+
+    inline void StoreHalf( unsigned short* p, VecF a )
+    {
+        float f[4];
+        _mm_storeu_ps( f, a.v );
+        p[0] = FloatToHalf( f[0] ); p[1] = FloatToHalf( f[1] ); p[2] = FloatToHalf( f[2] ); p[3] = FloatToHalf( f[3] );
+    }
+
+    inline void LoadDeinterleaved( const Float4* p, VecF& R, VecF& G, VecF& B, VecF& A )
+    {
+        __m128 m0 = _mm_loadu_ps( &p[0].x );
+        __m128 m1 = _mm_loadu_ps( &p[1].x );
+        __m128 m2 = _mm_loadu_ps( &p[2].x );
+        __m128 m3 = _mm_loadu_ps( &p[3].x );
+        _MM_TRANSPOSE4_PS( m0, m1, m2, m3 );
+        R.v = m0; G.v = m1; B.v = m2; A.v = m3;
+    }
+
+    inline void StoreInterleaved( Float4* p, VecF R, VecF G, VecF B, VecF A )
+    {
+        __m128 m0 = R.v, m1 = G.v, m2 = B.v, m3 = A.v;
+        _MM_TRANSPOSE4_PS( m0, m1, m2, m3 );
+        _mm_storeu_ps( &p[0].x, m0 );
+        _mm_storeu_ps( &p[1].x, m1 );
+        _mm_storeu_ps( &p[2].x, m2 );
+        _mm_storeu_ps( &p[3].x, m3 );
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Integer vector of the fixed point kernels: WIDTH 32 bit lanes, each holding a pair of
+    // 16 bit channels, one from each of two taps
+    //--------------------------------------------------------------------------------------
+    struct VecI
+    {
+        static const int WIDTH = 4;
+
+        __m128i v;
+
+        static VecI Make( __m128i m ) { VecI r; r.v = m; return r; }
+        static VecI Set1( int i ) { return Make( _mm_set1_epi32( i ) ); }
+        static VecI Load( const int* p ) { return Make( _mm_loadu_si128( (const __m128i*)p ) ); }
+        void Store( int* p ) const { _mm_storeu_si128( (__m128i*)p, v ); }
+
+        // 2 * WIDTH 16 bit channels
+        static VecI LoadI16( const short* p ) { return Make( _mm_loadu_si128( (const __m128i*)p ) ); }
+        static VecI LoadUNorm8( const unsigned char* p ) { return Make( _mm_cvtepu8_epi16( _mm_loadl_epi64( (const __m128i*)p ) ) ); }
+        void StoreI16( short* p ) const { _mm_storeu_si128( (__m128i*)p, v ); }
+    };
+
+    inline VecI operator+( VecI a, VecI b ) { return VecI::Make( _mm_add_epi32( a.v, b.v ) ); }
+    inline VecI ShiftRight( VecI a, int iShift ) { return VecI::Make( _mm_sra_epi32( a.v, _mm_cvtsi32_si128( iShift ) ) ); }
+    inline VecI ShiftRightLogical( VecI a, int iShift ) { return VecI::Make( _mm_srl_epi32( a.v, _mm_cvtsi32_si128( iShift ) ) ); }
+    inline VecI operator^( VecI a, VecI b ) { return VecI::Make( _mm_xor_si128( a.v, b.v ) ); }
+    inline VecI MulLo( VecI a, VecI b ) { return VecI::Make( _mm_mullo_epi32( a.v, b.v ) ); }
+
+    // Sums of the products of the pairs (pmaddwd)
+    inline VecI MulAddPairs( VecI a, VecI b ) { return VecI::Make( _mm_madd_epi16( a.v, b.v ) ); }
+
+    // Pairs up the 2 * WIDTH channels of a and b, storing 2 * WIDTH pairs
+    inline void StorePairs( int* p, VecI a, VecI b )
+    {
+        _mm_storeu_si128( (__m128i*)p, _mm_unpacklo_epi16( a.v, b.v ) );
+        _mm_storeu_si128( (__m128i*)( p + 4 ), _mm_unpackhi_epi16( a.v, b.v ) );
+    }
+
+    // Saturates the lanes of Lo and then Hi to 2 * WIDTH channels
+    inline void StoreI16( short* p, VecI Lo, VecI Hi )
+    {
+        _mm_storeu_si128( (__m128i*)p, _mm_packs_epi32( Lo.v, Hi.v ) );
+    }
+
+    inline void StoreUNorm8( unsigned char* p, VecI Lo, VecI Hi )
+    {
+        __m128i m = _mm_packs_epi32( Lo.v, Hi.v );
+        _mm_storel_epi64( (__m128i*)p, _mm_packus_epi16( m, m ) );
+    }
+}
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,150 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: SIMD_Scalar.h
+//
+// Single lane vector type, used by the scalar reference kernels. Only include from
+// Kernels_Scalar.cpp.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+#include "HalfFloat.h"
+
+
+namespace CPUFilter
+{
+namespace Scalar
+{
+    struct VecF
+    {
+        static const int WIDTH = 1;
+
+        float v;
+
+        static VecF Zero() { VecF r; r.v = 0.0f; return r; }
+        static VecF Set1( float f ) { VecF r; r.v = f; return r; }
+        static VecF Load( const float* p ) { VecF r; r.v = *p; return r; }
+        static VecF LoadU( const float* p ) { VecF r; r.v = *p; return r; }
+        void Store( float* p ) const { *p = v; }
+        void StoreU( float* p ) const { *p = v; }
+    };
+
+    inline VecF operator+( VecF a, VecF b ) { VecF r; r.v = a.v + b.v; return r; }
+    inline VecF operator-( VecF a, VecF b ) { VecF r; r.v = a.v - b.v; return r; }
+    inline VecF operator*( VecF a, VecF b ) { VecF r; r.v = a.v * b.v; return r; }
+    inline VecF operator/( VecF a, VecF b ) { VecF r; r.v = a.v / b.v; return r; }
+    inline VecF MulAdd( VecF a, VecF b, VecF c ) { VecF r; r.v = a.v * b.v + c.v; return r; }
+    inline VecF Min( VecF a, VecF b ) { VecF r; r.v = ( a.v < b.v ) ? a.v : b.v; return r; }
+    inline VecF Max( VecF a, VecF b ) { VecF r; r.v = ( a.v > b.v ) ? a.v : b.v; return r; }
+
+    // ( a < b ) ? x : y, per lane
+    inline VecF SelectLess( VecF a, VecF b, VecF x, VecF y ) { VecF r; r.v = ( a.v < b.v ) ? x.v : y.v; return r; }
+
+    // pTable[(int)Index], per lane. The indices must be within the table.
+    inline VecF LookupTable( const float* pTable, VecF Index ) { VecF r; r.v = pTable[(int)Index.v]; return r; }
+
+    // Unorm values, converted to and from floats in the range of the format. The stores round
+    // to nearest, so the values must already be clamped to the range.
+    inline VecF LoadUNorm( const unsigned char* p ) { VecF r; r.v = (float)*p; return r; }
+    inline VecF LoadUNorm( const unsigned short* p ) { VecF r; r.v = (float)*p; return r; }
+    inline void StoreUNorm( unsigned char* p, VecF a ) { *p = (unsigned char)( a.v + 0.5f ); }
+    inline void StoreUNorm( unsigned short* p, VecF a ) { *p = (unsigned short)( a.v + 0.5f ); }
+
+    // Halves, converted with rounding to nearest even as FloatToHalf
+    inline VecF LoadHalf( const unsigned short* p ) { VecF r; r.v = HalfToFloat( *p ); return r; }
+    inline void StoreHalf( unsigned short* p, VecF a ) { *p = FloatToHalf( a.v ); }
+
+    inline void LoadDeinterleaved( const Float4* p, VecF& R, VecF& G, VecF& B, VecF& A )
+    {
+        R.v = p->x; G.v = p->y; B.v = p->z; A.v = p->w;
+    }
+
+    inline void StoreInterleaved( Float4* p, VecF R, VecF G, VecF B, VecF A )
+    {
+        p->x = R.v; p->y = G.v; p->z = B.v; p->w = A.v;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Integer vector of the fixed point kernels: one 32 bit lane, holding a pair of 16 bit
+    // channels, one from each of two taps
+    //--------------------------------------------------------------------------------------
+    struct VecI
+    {
+        static const int WIDTH = 1;
+
+        int v;
+
+        static VecI Make( int i ) { VecI r; r.v = i; return r; }
+        static VecI Set1( int i ) { return Make( i ); }
+        static VecI Load( const int* p ) { return Make( *p ); }
+        void Store( int* p ) const { *p = v; }
+        static VecI Pair( int iLo, int iHi ) { return Make( (int)( (unsigned int)(unsigned short)iLo | ( (unsigned int)(unsigned short)iHi << 16 ) ) ); }
+
+        // 2 * WIDTH 16 bit channels
+        static VecI LoadI16( const short* p ) { return Pair( p[0], p[1] ); }
+        static VecI LoadUNorm8( const unsigned char* p ) { return Pair( p[0], p[1] ); }
+        void StoreI16( short* p ) const { p[0] = Lo16(); p[1] = Hi16(); }
+
+        short Lo16() const { return (short)( v & 0xFFFF ); }
+        short Hi16() const { return (short)( (unsigned int)v >> 16 ); }
+    };
+
+    inline VecI operator+( VecI a, VecI b ) { return VecI::Make( a.v + b.v ); }
+    inline VecI ShiftRight( VecI a, int iShift ) { return VecI::Make( a.v >> iShift ); }
+    inline VecI ShiftRightLogical( VecI a, int iShift ) { return VecI::Make( (int)( (unsigned int)a.v >> iShift ) ); }
+    inline VecI operator^( VecI a, VecI b ) { return VecI::Make( a.v ^ b.v ); }
+    inline VecI MulLo( VecI a, VecI b ) { return VecI::Make( (int)( (unsigned int)a.v * (unsigned int)b.v ) ); }
+
+    // Sums of the products of the pairs (pmaddwd)
+    inline VecI MulAddPairs( VecI a, VecI b ) { return VecI::Make( a.Lo16() * b.Lo16() + a.Hi16() * b.Hi16() ); }
+
+    // Pairs up the 2 * WIDTH channels of a and b, storing 2 * WIDTH pairs
+    inline void StorePairs( int* p, VecI a, VecI b )
+    {
+        p[0] = VecI::Pair( a.Lo16(), b.Lo16() ).v;
+        p[1] = VecI::Pair( a.Hi16(), b.Hi16() ).v;
+    }
+
+    // Saturates the lanes of Lo and then Hi to 2 * WIDTH channels
+    inline void StoreI16( short* p, VecI Lo, VecI Hi )
+    {
+        p[0] = (short)Clamp( Lo.v, -32768, 32767 );
+        p[1] = (short)Clamp( Hi.v, -32768, 32767 );
+    }
+
+    inline void StoreUNorm8( unsigned char* p, VecI Lo, VecI Hi )
+    {
+        p[0] = (unsigned char)Clamp( Lo.v, 0, 255 );
+        p[1] = (unsigned char)Clamp( Hi.v, 0, 255 );
+    }
+}
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,272 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: SeparableFilterBatch.cpp
+//
+// Implements the SeparableFilterBatch class.
+//--------------------------------------------------------------------------------------
+
+
+#include "SeparableFilterBatch.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Maps the tiles of the scheduler onto the groups of the passes of all images, image by
+    // image, so each worker starts on images of its own
+    //--------------------------------------------------------------------------------------
+    class BatchDispatchTask : public TileTask
+    {
+    public:
+
+        BatchDispatchTask( FilterPass* const* ppFilters, unsigned int uNumGroupsX, unsigned int uNumGroupsPerImage ) :
+            m_ppFilters( ppFilters ), m_uNumGroupsX( uNumGroupsX ), m_uNumGroupsPerImage( uNumGroupsPerImage ) {}
+
+        virtual void ComputeTile( unsigned int uTile, Scratch& LDS ) const
+        {
+            const unsigned int uGroup = uTile % m_uNumGroupsPerImage;
+
+            m_ppFilters[uTile / m_uNumGroupsPerImage]->ComputeGroup( uGroup % m_uNumGroupsX, uGroup / m_uNumGroupsX, LDS );
+        }
+
+    private:
+
+        BatchDispatchTask& operator=( const BatchDispatchTask& );
+
+        FilterPass* const*  m_ppFilters;
+        unsigned int        m_uNumGroupsX;
+        unsigned int        m_uNumGroupsPerImage;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    SeparableFilterBatch::SeparableFilterBatch()
+    {
+        m_iNumImages = 0;
+        m_iNumInputs = 0;
+        m_ppHorizInputs = NULL;
+        m_ppVertInputs = NULL;
+        m_ppOutputs[0] = NULL; m_ppOutputs[1] = NULL;
+        m_ppFilters[0] = NULL; m_ppFilters[1] = NULL;
+        m_ppFusedFilters = NULL;
+        m_bFused = false;
+        memset( m_fOutputSize, 0, sizeof( m_fOutputSize ) );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Destructor
+    //--------------------------------------------------------------------------------------
+    SeparableFilterBatch::~SeparableFilterBatch()
+    {
+        delete[] m_ppHorizInputs;
+        delete[] m_ppVertInputs;
+        delete[] m_ppOutputs[0];
+        delete[] m_ppOutputs[1];
+        delete[] m_ppFilters[0];
+        delete[] m_ppFilters[1];
+        delete[] m_ppFusedFilters;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sets the size of the images
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterBatch::SetOutputSize( unsigned int uWidth, unsigned int uHeight )
+    {
+        m_fOutputSize[0] = (float)uWidth;
+        m_fOutputSize[1] = (float)uHeight;
+        m_fOutputSize[2] = 1.0f / (float)uWidth;
+        m_fOutputSize[3] = 1.0f / (float)uHeight;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sets the inputs of all images, and (re)allocates the per image arrays when the size
+    // of the batch changes
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterBatch::SetInputSurfaces( const Surface* const* ppHorizInputs, const Surface* const* ppVertInputs, int iNumInputs, int iNumImages )
+    {
+        assert( NULL != ppHorizInputs );
+        assert( NULL != ppVertInputs );
+        assert( iNumInputs <= MAX_INPUTS );
+        assert( iNumImages > 0 );
+
+        if( iNumImages != m_iNumImages || iNumInputs != m_iNumInputs )
+        {
+            delete[] m_ppHorizInputs;
+            delete[] m_ppVertInputs;
+            m_ppHorizInputs = new const Surface*[iNumImages * MAX_INPUTS];
+            m_ppVertInputs = new const Surface*[iNumImages * MAX_INPUTS];
+        }
+
+        if( iNumImages != m_iNumImages )
+        {
+            for( int iPass = 0; iPass < 2; ++iPass )
+            {
+                delete[] m_ppOutputs[iPass];
+                delete[] m_ppFilters[iPass];
+                m_ppOutputs[iPass] = new Surface*[iNumImages];
+                m_ppFilters[iPass] = new FilterPass*[iNumImages];
+                memset( m_ppOutputs[iPass], 0, sizeof( Surface* ) * iNumImages );
+                memset( m_ppFilters[iPass], 0, sizeof( FilterPass* ) * iNumImages );
+            }
+
+            delete[] m_ppFusedFilters;
+            m_ppFusedFilters = new FilterPass*[iNumImages];
+            memset( m_ppFusedFilters, 0, sizeof( FilterPass* ) * iNumImages );
+            m_bFused = false;
+        }
+
+        m_iNumImages = iNumImages;
+        m_iNumInputs = iNumInputs;
+
+        // Stored MAX_INPUTS apart, so each image's inputs can be bound as they are
+        for( int iImage = 0; iImage < m_iNumImages; ++iImage )
+        {
+            for( int iInput = 0; iInput < MAX_INPUTS; ++iInput )
+            {
+                const bool bInput = ( iInput < m_iNumInputs );
+                m_ppHorizInputs[iImage * MAX_INPUTS + iInput] = bInput ? ppHorizInputs[iImage * m_iNumInputs + iInput] : NULL;
+                m_ppVertInputs[iImage * MAX_INPUTS + iInput] = bInput ? ppVertInputs[iImage * m_iNumInputs + iInput] : NULL;
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sets the outputs of both passes of all images
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterBatch::SetOutputSurfaces( Surface* const* ppHorizOutputs, Surface* const* ppVertOutputs )
+    {
+        assert( m_iNumImages > 0 );
+        assert( NULL != ppVertOutputs );
+
+        for( int iImage = 0; iImage < m_iNumImages; ++iImage )
+        {
+            m_ppOutputs[0][iImage] = ( NULL != ppHorizOutputs ) ? ppHorizOutputs[iImage] : NULL;
+            m_ppOutputs[1][iImage] = ppVertOutputs[iImage];
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sets the passes of all images
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterBatch::SetFilters( FilterPass* const* ppHorizFilters, FilterPass* const* ppVertFilters )
+    {
+        assert( m_iNumImages > 0 );
+        assert( NULL != ppHorizFilters );
+        assert( NULL != ppVertFilters );
+
+        for( int iImage = 0; iImage < m_iNumImages; ++iImage )
+        {
+            assert( NULL != ppHorizFilters[iImage] && NULL != ppVertFilters[iImage] );
+
+            m_ppFilters[0][iImage] = ppHorizFilters[iImage];
+            m_ppFilters[1][iImage] = ppVertFilters[iImage];
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sets the fused passes of all images, or clears them
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterBatch::SetFusedFilters( FilterPass* const* ppFusedFilters )
+    {
+        assert( m_iNumImages > 0 );
+
+        m_bFused = ( NULL != ppFusedFilters );
+
+        for( int iImage = 0; iImage < m_iNumImages; ++iImage )
+        {
+            assert( !m_bFused || NULL != ppFusedFilters[iImage] );
+
+            m_ppFusedFilters[iImage] = m_bFused ? ppFusedFilters[iImage] : NULL;
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Runs the horizontal pass of all images, followed by the vertical pass of all images
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterBatch::OnRender()
+    {
+        assert( m_iNumImages > 0 );
+
+        // Both passes at once, with no intermediate surfaces
+        if( m_bFused )
+        {
+            Dispatch( m_ppFusedFilters, m_ppHorizInputs, m_ppOutputs[1] );
+
+            return;
+        }
+
+        assert( NULL != m_ppFilters[0][0] && NULL != m_ppFilters[1][0] );
+
+        // Horizontal filter pass
+        Dispatch( m_ppFilters[0], m_ppHorizInputs, m_ppOutputs[0] );
+
+        // Vertical filter pass
+        Dispatch( m_ppFilters[1], m_ppVertInputs, m_ppOutputs[1] );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Binds the inputs and output of each image's pass, and computes the groups of all of
+    // them on the worker threads at once
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterBatch::Dispatch( FilterPass* const* ppFilters, const Surface* const* ppInputs, Surface* const* ppOutputs )
+    {
+        unsigned int uX = 0, uY = 0;
+
+        for( int iImage = 0; iImage < m_iNumImages; ++iImage )
+        {
+            Surface* pOutput = ppOutputs[iImage];
+
+            assert( NULL == pOutput || pOutput->m_uWidth >= (unsigned int)m_fOutputSize[0] );
+            assert( NULL == pOutput || pOutput->m_uHeight >= (unsigned int)m_fOutputSize[1] );
+
+            ppFilters[iImage]->Bind( ppInputs + iImage * MAX_INPUTS, m_iNumInputs, pOutput, m_fOutputSize );
+
+            // The images are the same size, so their passes must dispatch the same groups
+            unsigned int uImageX, uImageY;
+            ppFilters[iImage]->GetDispatchSize( uImageX, uImageY );
+            assert( 0 == iImage || ( uImageX == uX && uImageY == uY ) );
+            uX = uImageX;
+            uY = uImageY;
+        }
+
+        BatchDispatchTask Task( ppFilters, uX, uX * uY );
+        m_Scheduler.Run( Task, uX * uY * m_iNumImages );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,104 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: SeparableFilterBatch.h
+//
+// SeparableFilterBatch Class definition.
+// Filters a batch of equally sized images in one call, such as the slices of a texture
+// array, the cascades of a shadow map or a set of thumbnails. Rather than dispatching
+// each image in turn, the groups of every image are put in a single work queue, so small
+// images that would each leave most cores idle keep all of them busy, and the threads
+// are woken once per pass rather than once per image.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+#include "TileScheduler.h"
+
+
+namespace CPUFilter
+{
+    class SeparableFilterBatch
+    {
+    public:
+
+        // Constructor / destructor
+        SeparableFilterBatch();
+        ~SeparableFilterBatch();
+
+        // Must be called before rendering, all images of the batch are this size
+        void SetOutputSize( unsigned int uWidth, unsigned int uHeight );
+
+        // Sets iNumInputs inputs of each of iNumImages images, image by image, each in the
+        // order provided. This sizes the batch, so must be called before the outputs and filters
+        // are set.
+        void SetInputSurfaces( const Surface* const* ppHorizInputs, const Surface* const* ppVertInputs, int iNumInputs, int iNumImages );
+
+        // Sets the outputs of each image, as SeparableFilterCPU::SetOutputSurfaces. The
+        // horizontal outputs may be NULL when fused filters are set.
+        void SetOutputSurfaces( Surface* const* ppHorizOutputs, Surface* const* ppVertOutputs );
+
+        // Passes keep the surfaces they are bound to, as a shader keeps its views, so each image
+        // needs passes of its own. They are likely copies of one pass, set up once.
+        void SetFilters( FilterPass* const* ppHorizFilters, FilterPass* const* ppVertFilters );
+
+        // Filters performing both passes at once, one per image, as SeparableFilterCPU::
+        // SetFusedFilter. Used instead of the separate filters while set, NULL to clear.
+        void SetFusedFilters( FilterPass* const* ppFusedFilters );
+
+        // Takes a MAXCORES_TYPE, or an explicit number of threads (defaults to all cores)
+        void SetMaximumCores( int iMaxCores ) { m_Scheduler.SetMaximumCores( iMaxCores ); }
+        unsigned int GetNumThreads() const { return m_Scheduler.GetNumThreads(); }
+
+        int GetNumImages() const { return m_iNumImages; }
+
+        // Runs both passes over all images
+        void OnRender();
+
+    private:
+
+        SeparableFilterBatch( const SeparableFilterBatch& );
+        SeparableFilterBatch& operator=( const SeparableFilterBatch& );
+
+        void Dispatch( FilterPass* const* ppFilters, const Surface* const* ppInputs, Surface* const* ppOutputs );
+
+        int                 m_iNumImages;
+        int                 m_iNumInputs;
+        const Surface**     m_ppHorizInputs;        // m_iNumInputs per image
+        const Surface**     m_ppVertInputs;
+        Surface**           m_ppOutputs[2];         // One per image
+        FilterPass**        m_ppFilters[2];
+        FilterPass**        m_ppFusedFilters;
+        bool                m_bFused;
+        float               m_fOutputSize[4];       // ( [0] = Width, [1] = Height, [2] = Inv Width, [3] = Inv Height )
+        TileScheduler       m_Scheduler;
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,675 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: SeparableFilterCPU.cpp
+//
+// Implements the SeparableFilterCPU class.
+// Handles the setting of inputs and outputs for a user defined filter, and performs the
+// filtering on the CPU.
+//--------------------------------------------------------------------------------------
+
+
+#include "SeparableFilterCPU.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Maps the tiles of the scheduler onto the groups of a pass, in row major order
+    //--------------------------------------------------------------------------------------
+    class DispatchTask : public TileTask
+    {
+    public:
+
+        DispatchTask( const FilterPass& Filter, unsigned int uNumGroupsX ) : m_Filter( Filter ), m_uNumGroupsX( uNumGroupsX ) {}
+
+        virtual void ComputeTile( unsigned int uTile, Scratch& LDS ) const
+        {
+            m_Filter.ComputeGroup( uTile % m_uNumGroupsX, uTile / m_uNumGroupsX, LDS );
+        }
+
+    private:
+
+        DispatchTask& operator=( const DispatchTask& );
+
+        const FilterPass&   m_Filter;
+        unsigned int        m_uNumGroupsX;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Maps the tiles of the scheduler onto a list of the groups of a pass
+    //--------------------------------------------------------------------------------------
+    class DirtyDispatchTask : public TileTask
+    {
+    public:
+
+        DirtyDispatchTask( const FilterPass& Filter, unsigned int uNumGroupsX, const unsigned int* puGroups ) : m_Filter( Filter ), m_uNumGroupsX( uNumGroupsX ), m_puGroups( puGroups ) {}
+
+        virtual void ComputeTile( unsigned int uTile, Scratch& LDS ) const
+        {
+            m_Filter.ComputeGroup( m_puGroups[uTile] % m_uNumGroupsX, m_puGroups[uTile] / m_uNumGroupsX, LDS );
+        }
+
+    private:
+
+        DirtyDispatchTask& operator=( const DirtyDispatchTask& );
+
+        const FilterPass&   m_Filter;
+        unsigned int        m_uNumGroupsX;
+        const unsigned int* m_puGroups;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    SeparableFilterCPU::SeparableFilterCPU()
+    {
+        memset( m_pHorizInputs, 0, sizeof( m_pHorizInputs ) );
+        memset( m_pVertInputs, 0, sizeof( m_pVertInputs ) );
+        m_iNumInputs = 0;
+        m_pOutput[0] = NULL; m_pOutput[1] = NULL;
+        m_pApronSurfaces[0] = NULL; m_pApronSurfaces[1] = NULL;
+        m_BorderMode = BORDER_MODE_TYPE_CLAMP;
+        memset( &m_BorderColor, 0, sizeof( m_BorderColor ) );
+        m_pFilters[0] = NULL; m_pFilters[1] = NULL;
+        m_pFusedFilter = NULL;
+        memset( m_fOutputSize, 0, sizeof( m_fOutputSize ) );
+        m_puDirtyGroups = NULL;
+        m_uDirtyGroupCapacity = 0;
+        m_bTileHashing = false;
+        m_pHashedVertFilter = NULL;
+        m_pHashedVertOutput = NULL;
+        m_iHashedVertRadius = 0;
+        m_uHashedVertDispatch[0] = 0; m_uHashedVertDispatch[1] = 0;
+        m_uNumHashHits = 0;
+        m_uNumHashGroups = 0;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Destructor
+    //--------------------------------------------------------------------------------------
+    SeparableFilterCPU::~SeparableFilterCPU()
+    {
+        m_iNumInputs = 0;
+        m_pOutput[0] = NULL; m_pOutput[1] = NULL;
+        m_pFilters[0] = NULL; m_pFilters[1] = NULL;
+        m_pFusedFilter = NULL;
+        delete[] m_puDirtyGroups;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sets the size of the filtered region
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterCPU::SetOutputSize( unsigned int uWidth, unsigned int uHeight )
+    {
+        m_fOutputSize[0] = (float)uWidth;
+        m_fOutputSize[1] = (float)uHeight;
+        m_fOutputSize[2] = 1.0f / (float)uWidth;
+        m_fOutputSize[3] = 1.0f / (float)uHeight;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sets inputs in order provided (base 0)
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterCPU::SetInputSurfaces( const Surface** ppHorizInputs, const Surface** ppVertInputs, int iNumInputs )
+    {
+        assert( NULL != ppHorizInputs );
+        assert( NULL != ppVertInputs );
+        assert( iNumInputs <= MAX_INPUTS );
+
+        if( iNumInputs != m_iNumInputs )
+        {
+            ResetTileHashes();
+        }
+
+        m_iNumInputs = iNumInputs;
+
+        for( int iInput = 0; iInput < m_iNumInputs; ++iInput )
+        {
+            if( ppHorizInputs[iInput] != m_pHorizInputs[iInput] || ppVertInputs[iInput] != m_pVertInputs[iInput] )
+            {
+                ResetTileHashes();
+            }
+
+            m_pHorizInputs[iInput] = ppHorizInputs[iInput];
+            m_pVertInputs[iInput] = ppVertInputs[iInput];
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sets the outputs of both passes
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterCPU::SetOutputSurfaces( Surface* pHorizOutput, Surface* pVertOutput )
+    {
+        if( pHorizOutput != m_pOutput[0] || pVertOutput != m_pOutput[1] )
+        {
+            ResetTileHashes();
+        }
+
+        m_pOutput[0] = pHorizOutput;
+        m_pOutput[1] = pVertOutput;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sets the apron surfaces of the input and the intermediate
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterCPU::SetApronSurfaces( ApronSurface* pInput, ApronSurface* pIntermediate )
+    {
+        if( pInput != m_pApronSurfaces[0] || pIntermediate != m_pApronSurfaces[1] )
+        {
+            ResetTileHashes();
+        }
+
+        m_pApronSurfaces[0] = pInput;
+        m_pApronSurfaces[1] = pIntermediate;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sets how the aprons are filled, the color is only used by BORDER_MODE_TYPE_CONSTANT
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterCPU::SetBorderMode( BORDER_MODE_TYPE BorderMode, const Float4& BorderColor )
+    {
+        assert( BorderMode < BORDER_MODE_TYPE_MAX );
+
+        if( BorderMode != m_BorderMode || 0 != memcmp( &BorderColor, &m_BorderColor, sizeof( m_BorderColor ) ) )
+        {
+            ResetTileHashes();
+        }
+
+        m_BorderMode = BorderMode;
+        m_BorderColor = BorderColor;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Likely set the filters once after creation, though could be every frame
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterCPU::SetFilters( FilterPass* pHorizFilter, FilterPass* pVertFilter )
+    {
+        assert( NULL != pHorizFilter );
+        assert( NULL != pVertFilter );
+
+        if( pHorizFilter != m_pFilters[0] || pVertFilter != m_pFilters[1] )
+        {
+            ResetTileHashes();
+        }
+
+        m_pFilters[0] = pHorizFilter;
+        m_pFilters[1] = pVertFilter;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sets the filter of both passes at once, NULL to clear
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterCPU::SetFusedFilter( FilterPass* pFusedFilter )
+    {
+        if( pFusedFilter != m_pFusedFilter )
+        {
+            ResetTileHashes();
+        }
+
+        m_pFusedFilter = pFusedFilter;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Forgets the hashes of both passes, so the next render computes every group
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterCPU::ResetTileHashes()
+    {
+        m_TileHashes[0].Reset();
+        m_TileHashes[1].Reset();
+        m_pHashedVertFilter = NULL;
+        m_pHashedVertOutput = NULL;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Runs the horizontal pass, followed by the vertical pass
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterCPU::OnRender()
+    {
+        m_uNumHashHits = 0;
+        m_uNumHashGroups = 0;
+
+        // Both passes at once, with no intermediate surface
+        if( NULL != m_pFusedFilter )
+        {
+            if( NULL != m_pApronSurfaces[0] )
+            {
+                m_pApronSurfaces[0]->FillApron( m_BorderMode, m_BorderColor );
+            }
+
+            DispatchHashed( 0, m_pFusedFilter, m_pHorizInputs, m_pOutput[1], m_pFusedFilter->KernelRadius(), m_pFusedFilter->KernelRadius() );
+
+            return;
+        }
+
+        assert( NULL != m_pFilters[0] && NULL != m_pFilters[1] );
+
+        // Horizontal filter pass, which only reads the columns of the apron
+        if( NULL != m_pApronSurfaces[0] )
+        {
+            m_pApronSurfaces[0]->FillApronColumns( m_BorderMode, m_BorderColor );
+        }
+
+        Surface Intermediate;
+        if( NULL != m_pApronSurfaces[1] )
+        {
+            m_pApronSurfaces[1]->GetInterior( Intermediate );
+        }
+
+        const bool bHorizHashed = DispatchHashed( 0, m_pFilters[0], m_pHorizInputs, ( NULL != m_pApronSurfaces[1] ) ? &Intermediate : m_pOutput[0], m_pFilters[0]->KernelRadius(), 0 );
+
+        // Vertical filter pass, which only reads the rows of the apron
+        if( NULL != m_pApronSurfaces[1] )
+        {
+            m_pApronSurfaces[1]->FillApronRows( m_BorderMode, m_BorderColor );
+        }
+
+        // When the vertical pass only reads the intermediate, it changes only where the
+        // horizontal pass computed groups. A wrapped apron maps rows across the surface.
+        const bool bReadsIntermediate = ( 1 == m_iNumInputs ) && ( ( NULL != m_pApronSurfaces[1] ) ? ( BORDER_MODE_TYPE_WRAP != m_BorderMode ) : ( m_pVertInputs[0] == m_pOutput[0] ) );
+
+        // The groups over the horizontal hits are only as the last render wrote them if the
+        // vertical pass is the same, and its own hashes are stale otherwise
+        const bool bVertUnchanged = m_bTileHashing && VertPassUnchanged();
+        if( m_bTileHashing && !bVertUnchanged )
+        {
+            m_TileHashes[1].Reset();
+        }
+
+        if( bHorizHashed && bReadsIntermediate && bVertUnchanged )
+        {
+            m_TileHashes[1].Reset();
+            DispatchHashMisses( m_pFilters[1], m_pVertInputs, m_pOutput[1] );
+        }
+        else
+        {
+            DispatchHashed( 1, m_pFilters[1], m_pVertInputs, m_pOutput[1], 0, m_pFilters[1]->KernelRadius() );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Whether the vertical pass, its output and its dispatch are those of the last hashed
+    // render, and remembers them for the next
+    //--------------------------------------------------------------------------------------
+    bool SeparableFilterCPU::VertPassUnchanged()
+    {
+        m_pFilters[1]->Bind( m_pVertInputs, m_iNumInputs, m_pOutput[1], m_fOutputSize );
+
+        unsigned int uX, uY;
+        m_pFilters[1]->GetDispatchSize( uX, uY );
+
+        const bool bUnchanged = ( m_pFilters[1] == m_pHashedVertFilter ) && ( m_pOutput[1] == m_pHashedVertOutput ) &&
+            ( m_pFilters[1]->KernelRadius() == m_iHashedVertRadius ) && ( uX == m_uHashedVertDispatch[0] ) && ( uY == m_uHashedVertDispatch[1] );
+
+        m_pHashedVertFilter = m_pFilters[1];
+        m_pHashedVertOutput = m_pOutput[1];
+        m_iHashedVertRadius = m_pFilters[1]->KernelRadius();
+        m_uHashedVertDispatch[0] = uX;
+        m_uHashedVertDispatch[1] = uY;
+
+        return bUnchanged;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Runs both passes over the parts of the outputs affected by the dirty rectangles
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterCPU::OnRenderDirty( const Rect* pDirtyRects, int iNumRects )
+    {
+        assert( NULL != pDirtyRects || 0 == iNumRects );
+        assert( iNumRects <= MAX_DIRTY_RECTS );
+
+        // The groups outside the rectangles are not hashed, so the hashes no longer match
+        // what the outputs hold
+        ResetTileHashes();
+
+        Rect HorizRects[MAX_GROWN_RECTS];
+        Rect VertRects[MAX_GROWN_RECTS];
+
+        // A wrapped apron maps the texels past one edge of the input to the other edge
+        const bool bWrapInput = ( NULL != m_pApronSurfaces[0] ) && ( BORDER_MODE_TYPE_WRAP == m_BorderMode );
+        const bool bWrapIntermediate = ( NULL != m_pApronSurfaces[1] ) && ( BORDER_MODE_TYPE_WRAP == m_BorderMode );
+
+        // Both passes at once, so the output changes within both radii
+        if( NULL != m_pFusedFilter )
+        {
+            if( NULL != m_pApronSurfaces[0] )
+            {
+                m_pApronSurfaces[0]->FillApron( m_BorderMode, m_BorderColor );
+            }
+
+            const int iNumVertRects = GrowRects( pDirtyRects, iNumRects, m_pFusedFilter->KernelRadius(), m_pFusedFilter->KernelRadius(), bWrapInput, VertRects );
+            DispatchRects( m_pFusedFilter, m_pHorizInputs, m_pOutput[1], VertRects, iNumVertRects );
+
+            return;
+        }
+
+        assert( NULL != m_pFilters[0] && NULL != m_pFilters[1] );
+
+        // The apron and the intermediate are filled as OnRender fills them. Only apron texels
+        // mapped from the dirty rectangles change, but refilling is cheap next to filtering.
+        if( NULL != m_pApronSurfaces[0] )
+        {
+            m_pApronSurfaces[0]->FillApronColumns( m_BorderMode, m_BorderColor );
+        }
+
+        Surface Intermediate;
+        if( NULL != m_pApronSurfaces[1] )
+        {
+            m_pApronSurfaces[1]->GetInterior( Intermediate );
+        }
+
+        // The intermediate changes within the horizontal radius of the dirty input, and the
+        // output within the vertical radius of that
+        const int iNumHorizRects = GrowRects( pDirtyRects, iNumRects, m_pFilters[0]->KernelRadius(), 0, bWrapInput, HorizRects );
+        const bool bHorizDirty = DispatchRects( m_pFilters[0], m_pHorizInputs, ( NULL != m_pApronSurfaces[1] ) ? &Intermediate : m_pOutput[0], HorizRects, iNumHorizRects );
+
+        if( NULL != m_pApronSurfaces[1] )
+        {
+            m_pApronSurfaces[1]->FillApronRows( m_BorderMode, m_BorderColor );
+        }
+
+        if( bHorizDirty )
+        {
+            const int iNumVertRects = GrowRects( HorizRects, iNumHorizRects, 0, m_pFilters[1]->KernelRadius(), bWrapIntermediate, VertRects );
+            DispatchRects( m_pFilters[1], m_pVertInputs, m_pOutput[1], VertRects, iNumVertRects );
+        }
+        else
+        {
+            Dispatch( m_pFilters[1], m_pVertInputs, m_pOutput[1] );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Splits a span grown past the edges of a dimension into the spans inside it. Wrapped,
+    // the parts past one edge come back in at the other, otherwise they are clipped.
+    // Returns the number of spans, up to 3.
+    //--------------------------------------------------------------------------------------
+    static int WrapSpan( int iBegin, int iEnd, int iSize, bool bWrap, int* pBegins, int* pEnds )
+    {
+        if( bWrap && ( iEnd - iBegin >= iSize ) )
+        {
+            pBegins[0] = 0;
+            pEnds[0] = iSize;
+
+            return 1;
+        }
+
+        int iNumSpans = 0;
+        pBegins[iNumSpans] = ( iBegin > 0 ) ? iBegin : 0;
+        pEnds[iNumSpans] = ( iEnd < iSize ) ? iEnd : iSize;
+        iNumSpans += ( pBegins[iNumSpans] < pEnds[iNumSpans] ) ? 1 : 0;
+
+        if( bWrap && iBegin < 0 )
+        {
+            pBegins[iNumSpans] = iSize + iBegin;
+            pEnds[iNumSpans++] = iSize;
+        }
+        if( bWrap && iEnd > iSize )
+        {
+            pBegins[iNumSpans] = 0;
+            pEnds[iNumSpans++] = iEnd - iSize;
+        }
+
+        return iNumSpans;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Grows rectangles by a radius either side, and clips them to the output, or wraps the
+    // parts past its edges to the opposite edges. Rectangles outside the output are dropped,
+    // and the number left is returned, up to 9 per rectangle when wrapping.
+    //--------------------------------------------------------------------------------------
+    int SeparableFilterCPU::GrowRects( const Rect* pRects, int iNumRects, int iGrowX, int iGrowY, bool bWrap, Rect* pGrownRects ) const
+    {
+        const int iWidth = (int)m_fOutputSize[0];
+        const int iHeight = (int)m_fOutputSize[1];
+        int iNumGrownRects = 0;
+
+        for( int iRect = 0; iRect < iNumRects; ++iRect )
+        {
+            int iLeft[3], iRight[3], iTop[3], iBottom[3];
+            const int iNumSpansX = WrapSpan( pRects[iRect].left - iGrowX, pRects[iRect].right + iGrowX, iWidth, bWrap, iLeft, iRight );
+            const int iNumSpansY = WrapSpan( pRects[iRect].top - iGrowY, pRects[iRect].bottom + iGrowY, iHeight, bWrap, iTop, iBottom );
+
+            for( int iSpanY = 0; iSpanY < iNumSpansY; ++iSpanY )
+            {
+                for( int iSpanX = 0; iSpanX < iNumSpansX; ++iSpanX )
+                {
+                    pGrownRects[iNumGrownRects++] = MakeRect( iLeft[iSpanX], iTop[iSpanY], iRight[iSpanX], iBottom[iSpanY] );
+                }
+            }
+        }
+
+        return iNumGrownRects;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Dispatches the groups of a pass whose output overlaps any of the rectangles. Returns
+    // false if the pass has no group size, so was dispatched whole.
+    //--------------------------------------------------------------------------------------
+    bool SeparableFilterCPU::DispatchRects( FilterPass* pFilter, const Surface* const* ppInputs, Surface* pOutput, const Rect* pRects, int iNumRects )
+    {
+        unsigned int uGroupWidth, uGroupHeight;
+        pFilter->GetGroupSize( uGroupWidth, uGroupHeight );
+        if( 0 == uGroupWidth || 0 == uGroupHeight )
+        {
+            Dispatch( pFilter, ppInputs, pOutput );
+
+            return false;
+        }
+
+        pFilter->Bind( ppInputs, m_iNumInputs, pOutput, m_fOutputSize );
+
+        unsigned int uX, uY;
+        pFilter->GetDispatchSize( uX, uY );
+
+        // Flag the groups under each rectangle, then gather the flagged ones, so overlapping
+        // rectangles compute their groups once
+        ClearGroupFlags( uX * uY );
+
+        for( int iRect = 0; iRect < iNumRects; ++iRect )
+        {
+            FlagGroups( pRects[iRect], uGroupWidth, uGroupHeight, uX );
+        }
+
+        DispatchFlaggedGroups( pFilter, uX, uY );
+
+        return true;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Clears a flag for each group of a pass
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterCPU::ClearGroupFlags( unsigned int uNumGroups )
+    {
+        if( uNumGroups > m_uDirtyGroupCapacity )
+        {
+            delete[] m_puDirtyGroups;
+            m_uDirtyGroupCapacity = uNumGroups;
+            m_puDirtyGroups = new unsigned int[m_uDirtyGroupCapacity];
+        }
+
+        memset( m_puDirtyGroups, 0, sizeof( unsigned int ) * uNumGroups );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Flags the groups whose output overlaps a rectangle, which is inside the output
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterCPU::FlagGroups( const Rect& Area, unsigned int uGroupWidth, unsigned int uGroupHeight, unsigned int uNumGroupsX )
+    {
+        const unsigned int uEndX = DivRoundUp( (unsigned int)Area.right, uGroupWidth );
+        const unsigned int uEndY = DivRoundUp( (unsigned int)Area.bottom, uGroupHeight );
+
+        for( unsigned int uGroupY = (unsigned int)Area.top / uGroupHeight; uGroupY < uEndY; ++uGroupY )
+        {
+            for( unsigned int uGroupX = (unsigned int)Area.left / uGroupWidth; uGroupX < uEndX; ++uGroupX )
+            {
+                m_puDirtyGroups[uGroupY * uNumGroupsX + uGroupX] = 1;
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Gathers the flagged groups of a bound pass in row major order, and computes them.
+    // Returns the number computed.
+    //--------------------------------------------------------------------------------------
+    unsigned int SeparableFilterCPU::DispatchFlaggedGroups( FilterPass* pFilter, unsigned int uX, unsigned int uY )
+    {
+        unsigned int uNumGroups = 0;
+        for( unsigned int uGroup = 0; uGroup < uX * uY; ++uGroup )
+        {
+            if( 0 != m_puDirtyGroups[uGroup] )
+            {
+                m_puDirtyGroups[uNumGroups++] = uGroup;
+            }
+        }
+
+        if( uNumGroups > 0 )
+        {
+            DirtyDispatchTask Task( *pFilter, uX, m_puDirtyGroups );
+            m_Scheduler.Run( Task, uNumGroups );
+        }
+
+        return uNumGroups;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Dispatches a pass through its tile hash cache when hashing, or whole if it cannot be
+    // hashed. The apron surface a pass reads is the one filled before it.
+    //--------------------------------------------------------------------------------------
+    bool SeparableFilterCPU::DispatchHashed( int iPass, FilterPass* pFilter, const Surface* const* ppInputs, Surface* pOutput, int iGrowX, int iGrowY )
+    {
+        if( m_bTileHashing )
+        {
+            pFilter->Bind( ppInputs, m_iNumInputs, pOutput, m_fOutputSize );
+
+            if( m_TileHashes[iPass].Dispatch( m_Scheduler, *pFilter, ppInputs, m_iNumInputs, m_pApronSurfaces[iPass], pOutput, iGrowX, iGrowY ) )
+            {
+                m_uNumHashHits += m_TileHashes[iPass].GetNumHits();
+                m_uNumHashGroups += m_TileHashes[iPass].GetNumHits() + m_TileHashes[iPass].GetNumMisses();
+
+                return true;
+            }
+        }
+
+        Dispatch( pFilter, ppInputs, pOutput );
+
+        return false;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Dispatches the vertical pass over only the groups of the horizontal pass that its
+    // tile hash cache computed, grown by the vertical radius. The rest of the intermediate
+    // is as the last render wrote it, so hashing it again would find nothing new.
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterCPU::DispatchHashMisses( FilterPass* pFilter, const Surface* const* ppInputs, Surface* pOutput )
+    {
+        unsigned int uGroupWidth, uGroupHeight;
+        pFilter->GetGroupSize( uGroupWidth, uGroupHeight );
+        if( 0 == uGroupWidth || 0 == uGroupHeight )
+        {
+            Dispatch( pFilter, ppInputs, pOutput );
+
+            return;
+        }
+
+        pFilter->Bind( ppInputs, m_iNumInputs, pOutput, m_fOutputSize );
+
+        unsigned int uX, uY;
+        pFilter->GetDispatchSize( uX, uY );
+
+        unsigned int uHorizX, uHorizY, uHorizGroupWidth, uHorizGroupHeight;
+        m_TileHashes[0].GetDispatchSize( uHorizX, uHorizY );
+        m_TileHashes[0].GetGroupSize( uHorizGroupWidth, uHorizGroupHeight );
+
+        ClearGroupFlags( uX * uY );
+
+        Rect Missed;
+        for( unsigned int uGroup = 0; uGroup < uHorizX * uHorizY; ++uGroup )
+        {
+            if( m_TileHashes[0].GroupMissed( uGroup ) )
+            {
+                Missed.left = ( uGroup % uHorizX ) * uHorizGroupWidth;
+                Missed.top = ( uGroup / uHorizX ) * uHorizGroupHeight;
+                Missed.right = Missed.left + uHorizGroupWidth;
+                Missed.bottom = Missed.top + uHorizGroupHeight;
+
+                if( 1 == GrowRects( &Missed, 1, 0, pFilter->KernelRadius(), false, &Missed ) )
+                {
+                    FlagGroups( Missed, uGroupWidth, uGroupHeight, uX );
+                }
+            }
+        }
+
+        const unsigned int uNumMisses = DispatchFlaggedGroups( pFilter, uX, uY );
+
+        m_uNumHashHits += uX * uY - uNumMisses;
+        m_uNumHashGroups += uX * uY;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Binds the inputs and output of a pass, and computes all of its groups on the worker
+    // threads
+    //--------------------------------------------------------------------------------------
+    void SeparableFilterCPU::Dispatch( FilterPass* pFilter, const Surface* const* ppInputs, Surface* pOutput )
+    {
+        assert( NULL == pOutput || pOutput->m_uWidth >= (unsigned int)m_fOutputSize[0] );
+        assert( NULL == pOutput || pOutput->m_uHeight >= (unsigned int)m_fOutputSize[1] );
+
+        pFilter->Bind( ppInputs, m_iNumInputs, pOutput, m_fOutputSize );
+
+        unsigned int uX, uY;
+        pFilter->GetDispatchSize( uX, uY );
+
+        DispatchTask Task( *pFilter, uX );
+        m_Scheduler.Run( Task, uX * uY );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,157 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: SeparableFilterCPU.h
+//
+// SeparableFilterCPU Class definition.
+// The CPU counterpart of the SeparableFilter class: handles the setting of inputs and
+// outputs for a user defined filter, and dispatches the groups of both passes. It has no
+// dependency on Direct3D, so can be used for offline processing on any platform.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+#include "ApronSurface.h"
+#include "TileHashCache.h"
+#include "TileScheduler.h"
+
+
+namespace CPUFilter
+{
+    class SeparableFilterCPU
+    {
+    public:
+
+        static const int MAX_DIRTY_RECTS = 64;
+
+        // Constructor / destructor
+        SeparableFilterCPU();
+        ~SeparableFilterCPU();
+
+        // Must be called before rendering
+        void SetOutputSize( unsigned int uWidth, unsigned int uHeight );
+
+        // Sets in order provided
+        void SetInputSurfaces( const Surface** ppHorizInputs, const Surface** ppVertInputs, int iNumInputs );
+
+        // The horizontal output is the intermediate surface read by the vertical pass, which is
+        // not needed (so may be NULL) when a fused filter is set, or when the passes share an
+        // intermediate of their own (GaussianFilterX::SetHalfOutput). Neither output is needed
+        // by passes that write surfaces of their own (BoxFilter::SetUNorm8Surfaces).
+        void SetOutputSurfaces( Surface* pHorizOutput, Surface* pVertOutput );
+
+        // Apron surfaces for the input and the intermediate, either may be NULL. Their aprons are
+        // filled with the border mode each render, the input's before the horizontal pass (or
+        // the fused filter), and the intermediate's before the vertical pass. The horizontal
+        // pass writes inside the intermediate's apron instead of to its output. The passes
+        // read them through GaussianFilterSIMD::SetApronInput.
+        void SetApronSurfaces( ApronSurface* pInput, ApronSurface* pIntermediate );
+        void SetBorderMode( BORDER_MODE_TYPE BorderMode, const Float4& BorderColor );
+
+        // Likely set the filters once after creation, though could be every frame
+        void SetFilters( FilterPass* pHorizFilter, FilterPass* pVertFilter );
+
+        // A filter that performs both passes at once, from the horizontal inputs to the vertical
+        // output. Used instead of the separate filters while set, NULL to clear.
+        void SetFusedFilter( FilterPass* pFusedFilter );
+        FilterPass* GetFusedFilter() const { return m_pFusedFilter; }
+
+        // Takes a MAXCORES_TYPE, or an explicit number of threads (defaults to all cores)
+        void SetMaximumCores( int iMaxCores ) { m_Scheduler.SetMaximumCores( iMaxCores ); }
+        int GetMaximumCores() const { return m_Scheduler.GetMaximumCores(); }
+        unsigned int GetNumThreads() const { return m_Scheduler.GetNumThreads(); }
+
+        // Runs both passes
+        void OnRender();
+
+        // Runs both passes over only the part of the outputs affected by changes to the inputs
+        // inside the dirty rectangles, leaving the rest as the last render wrote it. Each pass
+        // computes the groups under the rectangles grown by its kernel radius, so a small edit
+        // costs a few groups rather than the whole surface. Passes without a group size are
+        // dispatched whole, and so are all passes after them. With a wrapped apron, the parts
+        // of the grown rectangles past an edge are filtered at the opposite edge. Up to
+        // MAX_DIRTY_RECTS rectangles.
+        void OnRenderDirty( const Rect* pDirtyRects, int iNumRects );
+
+        // Skips the groups of each pass whose inputs hash the same as in the last render,
+        // keeping what they wrote then, for video or captures that change little each frame.
+        // The outputs (and the intermediate) must be left as the last render wrote them. The
+        // hashes are forgotten when a pass or surface changes, but not when a pass's settings
+        // do, so ResetTileHashes must be called then. Passes that read half or UNorm8 surfaces
+        // of their own must not be hashed, passes without a group size always run whole.
+        void SetTileHashing( bool bTileHashing ) { m_bTileHashing = bTileHashing; ResetTileHashes(); }
+        bool GetTileHashing() const { return m_bTileHashing; }
+        void ResetTileHashes();
+
+        // Groups of the last render that were skipped, out of all those hashed
+        void GetTileHashCounters( unsigned int& uNumHits, unsigned int& uNumGroups ) const { uNumHits = m_uNumHashHits; uNumGroups = m_uNumHashGroups; }
+
+    private:
+
+        SeparableFilterCPU( const SeparableFilterCPU& );
+        SeparableFilterCPU& operator=( const SeparableFilterCPU& );
+
+        void Dispatch( FilterPass* pFilter, const Surface* const* ppInputs, Surface* pOutput );
+        bool DispatchHashed( int iPass, FilterPass* pFilter, const Surface* const* ppInputs, Surface* pOutput, int iGrowX, int iGrowY );
+        void DispatchHashMisses( FilterPass* pFilter, const Surface* const* ppInputs, Surface* pOutput );
+        void ClearGroupFlags( unsigned int uNumGroups );
+        void FlagGroups( const Rect& Area, unsigned int uGroupWidth, unsigned int uGroupHeight, unsigned int uNumGroupsX );
+        unsigned int DispatchFlaggedGroups( FilterPass* pFilter, unsigned int uX, unsigned int uY );
+        bool DispatchRects( FilterPass* pFilter, const Surface* const* ppInputs, Surface* pOutput, const Rect* pRects, int iNumRects );
+        bool VertPassUnchanged();
+        int GrowRects( const Rect* pRects, int iNumRects, int iGrowX, int iGrowY, bool bWrap, Rect* pGrownRects ) const;
+
+        // Dirty rectangles grown across the wrapped edges of both passes
+        static const int MAX_GROWN_RECTS = MAX_DIRTY_RECTS * 9;
+
+        const Surface*  m_pHorizInputs[MAX_INPUTS];
+        const Surface*  m_pVertInputs[MAX_INPUTS];
+        int             m_iNumInputs;
+        Surface*        m_pOutput[2];
+        ApronSurface*   m_pApronSurfaces[2];
+        BORDER_MODE_TYPE m_BorderMode;
+        Float4          m_BorderColor;
+        FilterPass*     m_pFilters[2];
+        FilterPass*     m_pFusedFilter;
+        float           m_fOutputSize[4];   // ( [0] = Width, [1] = Height, [2] = Inv Width, [3] = Inv Height )
+        unsigned int*   m_puDirtyGroups;    // Group indices of the dirty dispatches
+        unsigned int    m_uDirtyGroupCapacity;
+        bool            m_bTileHashing;
+        TileHashCache   m_TileHashes[2];    // Of the horizontal (or fused) and vertical passes
+        const FilterPass* m_pHashedVertFilter;  // The vertical pass of the last hashed render, and
+        const Surface*  m_pHashedVertOutput;    // its output, radius and dispatch
+        int             m_iHashedVertRadius;
+        unsigned int    m_uHashedVertDispatch[2];
+        unsigned int    m_uNumHashHits;
+        unsigned int    m_uNumHashGroups;
+        TileScheduler   m_Scheduler;
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
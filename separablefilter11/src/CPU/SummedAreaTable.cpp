@@ -0,0 +1,241 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: SummedAreaTable.cpp
+//
+// Implements the summed area table passes.
+//--------------------------------------------------------------------------------------
+
+
+#include "SummedAreaTable.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Allocates the table, with its extra row and column
+    //--------------------------------------------------------------------------------------
+    bool SummedAreaTable::Create( unsigned int uWidth, unsigned int uHeight )
+    {
+        Release();
+
+        const unsigned int uEntriesPerAlignment = (unsigned int)( MEMORY_ALIGNMENT / ( sizeof( double ) * 4 ) );
+        unsigned int uPitch = DivRoundUp( uWidth + 1, uEntriesPerAlignment ) * uEntriesPerAlignment;
+
+        m_pData = (double*)AlignedMalloc( (size_t)uPitch * ( uHeight + 1 ) * sizeof( double ) * 4 );
+        if( NULL == m_pData )
+        {
+            return false;
+        }
+
+        m_uWidth = uWidth;
+        m_uHeight = uHeight;
+        m_uPitch = uPitch;
+
+        return true;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Frees the table
+    //--------------------------------------------------------------------------------------
+    void SummedAreaTable::Release()
+    {
+        AlignedFree( m_pData );
+
+        m_pData = NULL;
+        m_uWidth = m_uHeight = m_uPitch = 0;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Four lookups, whatever the size of the rectangle
+    //--------------------------------------------------------------------------------------
+    Float4 SummedAreaTable::Mean( int iX0, int iY0, int iX1, int iY1 ) const
+    {
+        assert( iX0 >= 0 && iX0 <= iX1 && iX1 < (int)m_uWidth );
+        assert( iY0 >= 0 && iY0 <= iY1 && iY1 < (int)m_uHeight );
+
+        const double* pTop = Row( iY0 );
+        const double* pBottom = Row( iY1 + 1 );
+        const double dScale = 1.0 / ( (double)( iX1 - iX0 + 1 ) * (double)( iY1 - iY0 + 1 ) );
+
+        double dMean[4];
+        for( int c = 0; c < 4; ++c )
+        {
+            dMean[c] = ( ( pBottom[( iX1 + 1 ) * 4 + c] - pBottom[iX0 * 4 + c] ) - ( pTop[( iX1 + 1 ) * 4 + c] - pTop[iX0 * 4 + c] ) ) * dScale;
+        }
+
+        return MakeFloat4( (float)dMean[0], (float)dMean[1], (float)dMean[2], (float)dMean[3] );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Each group sums RUN_LINES lines
+    //--------------------------------------------------------------------------------------
+    void SummedAreaTableX::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        assert( NULL != m_pTable );
+
+        uX = 1;
+        uY = DivRoundUp( m_pTable->m_uHeight, RUN_LINES );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Running sums along the lines, into rows 1 and on of the table. The first group also
+    // clears row 0.
+    //--------------------------------------------------------------------------------------
+    void SummedAreaTableX::ComputeGroup( unsigned int /*uGroupX*/, unsigned int uGroupY, Scratch& /*LDS*/ ) const
+    {
+        const int iWidth = (int)m_pTable->m_uWidth;
+
+        assert( m_pInputs[0]->m_uWidth >= m_pTable->m_uWidth && m_pInputs[0]->m_uHeight >= m_pTable->m_uHeight );
+
+        if( 0 == uGroupY )
+        {
+            memset( m_pTable->Row( 0 ), 0, sizeof( double ) * 4 * ( iWidth + 1 ) );
+        }
+
+        for( int iLine = 0; iLine < RUN_LINES; ++iLine )
+        {
+            const int iY = (int)uGroupY * RUN_LINES + iLine;
+            if( iY >= (int)m_pTable->m_uHeight )
+            {
+                break;
+            }
+
+            const Float4* pSrc = m_pInputs[0]->Row( iY );
+            double* pDst = m_pTable->Row( iY + 1 );
+            double dSum[4] = { 0.0, 0.0, 0.0, 0.0 };
+
+            memset( pDst, 0, sizeof( double ) * 4 );
+            for( int iX = 0; iX < iWidth; ++iX )
+            {
+                const float* pTexel = &pSrc[iX].x;
+                for( int c = 0; c < 4; ++c )
+                {
+                    dSum[c] += (double)pTexel[c];
+                    pDst[( iX + 1 ) * 4 + c] = dSum[c];
+                }
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Each group sums a strip of RUN_SIZE columns
+    //--------------------------------------------------------------------------------------
+    void SummedAreaTableY::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        assert( NULL != m_pTable );
+
+        uX = DivRoundUp( m_pTable->m_uWidth + 1, RUN_SIZE );
+        uY = 1;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Adds each row of the strip to the one below, down the table
+    //--------------------------------------------------------------------------------------
+    void SummedAreaTableY::ComputeGroup( unsigned int uGroupX, unsigned int /*uGroupY*/, Scratch& /*LDS*/ ) const
+    {
+        const int iGroupCoordX = (int)uGroupX * RUN_SIZE;
+        const int iNumEntries = ( (int)m_pTable->m_uWidth + 1 - iGroupCoordX < RUN_SIZE ) ? ( (int)m_pTable->m_uWidth + 1 - iGroupCoordX ) : RUN_SIZE;
+        const int iNumChannels = iNumEntries * 4;
+
+        for( int iY = 2; iY <= (int)m_pTable->m_uHeight; ++iY )
+        {
+            const double* pAbove = m_pTable->Row( iY - 1 ) + iGroupCoordX * 4;
+            double* pRow = m_pTable->Row( iY ) + iGroupCoordX * 4;
+
+            for( int i = 0; i < iNumChannels; ++i )
+            {
+                pRow[i] += pAbove[i];
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Same dispatch as CSFilterX
+    //--------------------------------------------------------------------------------------
+    void VariableBlurSAT::GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+    {
+        uX = DivRoundUp( (unsigned int)OutputWidth(), RUN_SIZE );
+        uY = DivRoundUp( (unsigned int)OutputHeight(), RUN_LINES );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Looks up the box of each pixel's radius, and of the next radius up
+    //--------------------------------------------------------------------------------------
+    void VariableBlurSAT::ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& /*LDS*/ ) const
+    {
+        assert( NULL != m_pTable && NULL != m_pInputs[1] );
+        assert( m_pTable->m_uWidth >= (unsigned int)OutputWidth() && m_pTable->m_uHeight >= (unsigned int)OutputHeight() );
+
+        const int iLastX = (int)m_pTable->m_uWidth - 1;
+        const int iLastY = (int)m_pTable->m_uHeight - 1;
+        const float fMaxRadius = GetMaxRadius();
+        const int iGroupCoordX = (int)uGroupX * RUN_SIZE;
+        const int iEndX = ( OutputWidth() - iGroupCoordX < RUN_SIZE ) ? OutputWidth() : ( iGroupCoordX + RUN_SIZE );
+
+        for( int iLine = 0; iLine < RUN_LINES; ++iLine )
+        {
+            const int iY = (int)uGroupY * RUN_LINES + iLine;
+            if( iY >= OutputHeight() )
+            {
+                break;
+            }
+
+            const Float4* pRadii = m_pInputs[1]->Row( iY );
+            Float4* pDst = m_pOutput->Row( iY );
+
+            for( int iX = iGroupCoordX; iX < iEndX; ++iX )
+            {
+                const float fRadius = Saturate( pRadii[iX].w ) * fMaxRadius;
+                const int iRadius = (int)fRadius;
+                const float fBlend = fRadius - (float)iRadius;
+
+                Float4 f4Color = m_pTable->Mean( Clamp( iX - iRadius, 0, iLastX ), Clamp( iY - iRadius, 0, iLastY ),
+                                                 Clamp( iX + iRadius, 0, iLastX ), Clamp( iY + iRadius, 0, iLastY ) );
+                if( fBlend > 0.0f )
+                {
+                    const int iNext = iRadius + 1;
+                    const Float4 f4Next = m_pTable->Mean( Clamp( iX - iNext, 0, iLastX ), Clamp( iY - iNext, 0, iLastY ),
+                                                          Clamp( iX + iNext, 0, iLastX ), Clamp( iY + iNext, 0, iLastY ) );
+                    f4Color = f4Color * ( 1.0f - fBlend ) + f4Next * fBlend;
+                }
+
+                pDst[iX] = MakeFloat4( f4Color.x, f4Color.y, f4Color.z, 1.0f );
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
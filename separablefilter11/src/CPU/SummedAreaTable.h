@@ -0,0 +1,150 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: SummedAreaTable.h
+//
+// Summed area table passes, for blurs whose radius varies per pixel. The table is built
+// once by a horizontal and a vertical pass, after which the mean of any rectangle costs
+// four lookups, so a pixel in focus costs as little as one blurred by a wide radius.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Sums of the 4 channels of every rectangle from the origin, in doubles, so that the
+    // differences of large sums keep the precision of the input. Has a row and a column of
+    // zeros in front of the image, so entry ( x, y ) sums the texels above and left of it.
+    //--------------------------------------------------------------------------------------
+    class SummedAreaTable
+    {
+    public:
+
+        SummedAreaTable() : m_pData( NULL ), m_uWidth( 0 ), m_uHeight( 0 ), m_uPitch( 0 ) {}
+        ~SummedAreaTable() { Release(); }
+
+        // Allocates the table of an image, with each row aligned to MEMORY_ALIGNMENT
+        bool Create( unsigned int uWidth, unsigned int uHeight );
+        void Release();
+
+        // Each row holds 4 channels per entry, and has m_uWidth + 1 entries
+        double* Row( int iY ) { return m_pData + (size_t)iY * m_uPitch * 4; }
+        const double* Row( int iY ) const { return m_pData + (size_t)iY * m_uPitch * 4; }
+
+        // Mean of the texels in [iX0, iX1] x [iY0, iY1], which must lie in the image
+        Float4 Mean( int iX0, int iY0, int iX1, int iY1 ) const;
+
+        double*         m_pData;
+        unsigned int    m_uWidth;       // Of the image
+        unsigned int    m_uHeight;      // Of the image
+        unsigned int    m_uPitch;       // In entries
+
+    private:
+
+        SummedAreaTable( const SummedAreaTable& );
+        SummedAreaTable& operator=( const SummedAreaTable& );
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Horizontal pass: sums each line of input 0 into a row of the table. Has no output.
+    //--------------------------------------------------------------------------------------
+    class SummedAreaTableX : public FilterPass
+    {
+    public:
+
+        SummedAreaTableX() : m_pTable( NULL ) {}
+
+        void SetTable( SummedAreaTable* pTable ) { m_pTable = pTable; }
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+
+    private:
+
+        SummedAreaTable* m_pTable;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Vertical pass: sums the rows of the table down strips of columns, in place. Has no
+    // output.
+    //--------------------------------------------------------------------------------------
+    class SummedAreaTableY : public FilterPass
+    {
+    public:
+
+        SummedAreaTableY() : m_pTable( NULL ) {}
+
+        void SetTable( SummedAreaTable* pTable ) { m_pTable = pTable; }
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+
+    private:
+
+        SummedAreaTable* m_pTable;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Blurs each pixel by the box of its own radius, read from a built table. Input 1 is the
+    // radius map, with the radius as a fraction of the maximum radius in w, like the focal
+    // value output by BilateralFilterX. Fractional radii blend the two nearest boxes, and
+    // boxes are clipped to the image. Alpha is output as 1.
+    //
+    // Runs as the fused filter of SeparableFilterCPU, once SummedAreaTableX and
+    // SummedAreaTableY have built the table.
+    //--------------------------------------------------------------------------------------
+    class VariableBlurSAT : public FilterPass
+    {
+    public:
+
+        VariableBlurSAT() : m_pTable( NULL ), m_fMaxRadius( 0.0f ) {}
+
+        void SetTable( const SummedAreaTable* pTable ) { m_pTable = pTable; }
+
+        // Overrides the radius of a focal value of 1, or 0 for the kernel radius
+        void SetMaxRadius( float fMaxRadius ) { assert( fMaxRadius >= 0.0f ); m_fMaxRadius = fMaxRadius; }
+        float GetMaxRadius() const { return ( m_fMaxRadius > 0.0f ) ? m_fMaxRadius : (float)m_iKernelRadius; }
+
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const;
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const;
+
+    private:
+
+        const SummedAreaTable*  m_pTable;
+        float                   m_fMaxRadius;
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
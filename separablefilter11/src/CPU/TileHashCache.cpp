@@ -0,0 +1,217 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: TileHashCache.cpp
+//
+// Implements the TileHashCache class.
+//--------------------------------------------------------------------------------------
+
+
+#include "TileHashCache.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Hashes the inputs of each group, and computes the group only if they changed
+    //--------------------------------------------------------------------------------------
+    class TileHashTask : public TileTask
+    {
+    public:
+
+        TileHashTask( TileHashCache& Cache, const FilterPass& Filter, const Surface* const* ppInputs, int iNumInputs, const ApronSurface* pApronInput ) :
+        m_Cache( Cache ), m_Filter( Filter ), m_ppInputs( ppInputs ), m_iNumInputs( iNumInputs ), m_pApronInput( pApronInput ) {}
+
+        virtual void ComputeTile( unsigned int uTile, Scratch& LDS ) const
+        {
+            const TileHashCache::Key& Key = m_Cache.m_Key;
+            const unsigned int uGroupX = uTile % Key.m_uDispatchSize[0];
+            const unsigned int uGroupY = uTile / Key.m_uDispatchSize[0];
+            const int iLeft = (int)( uGroupX * Key.m_uGroupSize[0] ) - Key.m_iGrow[0];
+            const int iTop = (int)( uGroupY * Key.m_uGroupSize[1] ) - Key.m_iGrow[1];
+            const int iRight = (int)( ( uGroupX + 1 ) * Key.m_uGroupSize[0] ) + Key.m_iGrow[0];
+            const int iBottom = (int)( ( uGroupY + 1 ) * Key.m_uGroupSize[1] ) + Key.m_iGrow[1];
+
+            unsigned long long uHash = 0;
+            if( NULL != m_pApronInput )
+            {
+                // The border texels a group reads are all in the apron, which was filled first
+                const int iApron = m_pApronInput->m_iApron;
+                const int iX0 = Clamp( iLeft, -iApron, (int)m_pApronInput->m_uWidth + iApron );
+                const int iY0 = Clamp( iTop, -iApron, (int)m_pApronInput->m_uHeight + iApron );
+                const int iX1 = Clamp( iRight, -iApron, (int)m_pApronInput->m_uWidth + iApron );
+                const int iY1 = Clamp( iBottom, -iApron, (int)m_pApronInput->m_uHeight + iApron );
+
+                uHash = m_Cache.m_pKernels->m_pfnHashRows( &m_pApronInput->Row( iY0 )[iX0].x, (size_t)m_pApronInput->m_uPitch * 4, ( iX1 - iX0 ) * 4, iY1 - iY0, uHash );
+            }
+
+            // Reads beyond the edges are clamped to texels inside this rectangle
+            for( int iInput = 0; NULL == m_pApronInput && iInput < m_iNumInputs; ++iInput )
+            {
+                const Surface& Input = *m_ppInputs[iInput];
+                const int iX0 = Clamp( iLeft, 0, (int)Input.m_uWidth );
+                const int iY0 = Clamp( iTop, 0, (int)Input.m_uHeight );
+                const int iX1 = Clamp( iRight, 0, (int)Input.m_uWidth );
+                const int iY1 = Clamp( iBottom, 0, (int)Input.m_uHeight );
+
+                uHash = m_Cache.m_pKernels->m_pfnHashRows( &Input.Row( iY0 )[iX0].x, (size_t)Input.m_uPitch * 4, ( iX1 - iX0 ) * 4, iY1 - iY0, uHash );
+            }
+
+            if( m_Cache.m_bValid && m_Cache.m_puHashes[uTile] == uHash )
+            {
+                m_Cache.m_pbMissed[uTile] = false;
+                ++m_Cache.m_uNumHits;
+                return;
+            }
+
+            m_Filter.ComputeGroup( uGroupX, uGroupY, LDS );
+            m_Cache.m_puHashes[uTile] = uHash;
+            m_Cache.m_pbMissed[uTile] = true;
+        }
+
+    private:
+
+        TileHashTask& operator=( const TileHashTask& );
+
+        TileHashCache&          m_Cache;
+        const FilterPass&       m_Filter;
+        const Surface* const*   m_ppInputs;
+        int                     m_iNumInputs;
+        const ApronSurface*     m_pApronInput;
+    };
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    TileHashCache::TileHashCache() :
+    m_pKernels( &GetFilterKernels() ),
+    m_bValid( false ),
+    m_puHashes( NULL ),
+    m_pbMissed( NULL ),
+    m_uGroupCapacity( 0 ),
+    m_uNumGroups( 0 ),
+    m_uNumHits( 0 )
+    {
+        memset( &m_Key, 0, sizeof( m_Key ) );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Destructor
+    //--------------------------------------------------------------------------------------
+    TileHashCache::~TileHashCache()
+    {
+        delete[] m_puHashes;
+        delete[] m_pbMissed;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Forgets the hashes
+    //--------------------------------------------------------------------------------------
+    void TileHashCache::Reset()
+    {
+        m_bValid = false;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Computes the groups whose inputs changed. The hashes are only compared while the pass,
+    // its surfaces and its dispatch stay the same.
+    //--------------------------------------------------------------------------------------
+    bool TileHashCache::Dispatch( TileScheduler& Scheduler, const FilterPass& Filter, const Surface* const* ppInputs, int iNumInputs, const ApronSurface* pApronInput, const Surface* pOutput, int iGrowX, int iGrowY )
+    {
+        assert( iNumInputs <= MAX_INPUTS );
+
+        Key NewKey;
+        memset( &NewKey, 0, sizeof( NewKey ) );
+
+        Filter.GetGroupSize( NewKey.m_uGroupSize[0], NewKey.m_uGroupSize[1] );
+        if( 0 == NewKey.m_uGroupSize[0] || 0 == NewKey.m_uGroupSize[1] )
+        {
+            return false;
+        }
+
+        if( NULL != pApronInput )
+        {
+            NewKey.m_pApronInput = pApronInput->m_pData;
+        }
+        else
+        {
+            if( 0 == iNumInputs )
+            {
+                return false;
+            }
+
+            for( int iInput = 0; iInput < iNumInputs; ++iInput )
+            {
+                if( NULL == ppInputs[iInput] )
+                {
+                    return false;
+                }
+                NewKey.m_pInputs[iInput] = ppInputs[iInput]->m_pData;
+            }
+        }
+
+        NewKey.m_pFilter = &Filter;
+        NewKey.m_pOutput = ( NULL != pOutput ) ? pOutput->m_pData : NULL;
+        Filter.GetDispatchSize( NewKey.m_uDispatchSize[0], NewKey.m_uDispatchSize[1] );
+        NewKey.m_iGrow[0] = iGrowX;
+        NewKey.m_iGrow[1] = iGrowY;
+        NewKey.m_iKernelRadius = Filter.KernelRadius();
+
+        const unsigned int uNumGroups = NewKey.m_uDispatchSize[0] * NewKey.m_uDispatchSize[1];
+
+        if( 0 != memcmp( &NewKey, &m_Key, sizeof( Key ) ) )
+        {
+            if( uNumGroups > m_uGroupCapacity )
+            {
+                delete[] m_puHashes;
+                delete[] m_pbMissed;
+                m_uGroupCapacity = uNumGroups;
+                m_puHashes = new unsigned long long[m_uGroupCapacity];
+                m_pbMissed = new bool[m_uGroupCapacity];
+            }
+
+            m_Key = NewKey;
+            m_bValid = false;
+        }
+
+        m_uNumGroups = uNumGroups;
+        m_uNumHits = 0;
+
+        TileHashTask Task( *this, Filter, ppInputs, iNumInputs, pApronInput );
+        Scheduler.Run( Task, uNumGroups );
+
+        m_bValid = true;
+
+        return true;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: TileHashCache.h
+//
+// TileHashCache Class definition.
+// Skips the groups of a pass whose inputs are unchanged since its last dispatch, keeping
+// the output they wrote then. Each group hashes the part of the inputs it reads, and is
+// only computed if the hash differs, which suits video and mostly static captures.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+#include "ApronSurface.h"
+#include "TileScheduler.h"
+#include "SIMD.h"
+
+
+namespace CPUFilter
+{
+    class TileHashCache
+    {
+    public:
+
+        // Constructor / destructor
+        TileHashCache();
+        ~TileHashCache();
+
+        // Forgets the hashes, so every group is computed by the next dispatch
+        void Reset();
+
+        // Computes the groups of a pass, bound to the inputs and output given, whose inputs
+        // differ from the last dispatch. Each group hashes its output rectangle grown by iGrowX
+        // and iGrowY texels, of the apron input instead of the inputs if the pass reads one.
+        // Returns false without dispatching anything if the pass has no group size, or no
+        // input to hash. Surfaces of a pass's own (half or UNorm8) are not seen, so such
+        // passes must not be dispatched through the cache.
+        bool Dispatch( TileScheduler& Scheduler, const FilterPass& Filter, const Surface* const* ppInputs, int iNumInputs, const ApronSurface* pApronInput, const Surface* pOutput, int iGrowX, int iGrowY );
+
+        // Groups of the last dispatch that were skipped, and computed
+        unsigned int GetNumHits() const { return m_uNumHits; }
+        unsigned int GetNumMisses() const { return m_uNumGroups - m_uNumHits; }
+
+        // The groups of the last dispatch, and whether each was computed, in row major order
+        void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const { uX = m_Key.m_uDispatchSize[0]; uY = m_Key.m_uDispatchSize[1]; }
+        void GetGroupSize( unsigned int& uWidth, unsigned int& uHeight ) const { uWidth = m_Key.m_uGroupSize[0]; uHeight = m_Key.m_uGroupSize[1]; }
+        bool GroupMissed( unsigned int uGroup ) const { return m_pbMissed[uGroup]; }
+
+    private:
+
+        TileHashCache( const TileHashCache& );
+        TileHashCache& operator=( const TileHashCache& );
+
+        // Everything that makes the hashes of a dispatch comparable to the last one
+        class Key
+        {
+        public:
+
+            const FilterPass*   m_pFilter;
+            const void*         m_pInputs[MAX_INPUTS];
+            const void*         m_pApronInput;
+            const void*         m_pOutput;
+            unsigned int        m_uDispatchSize[2];
+            unsigned int        m_uGroupSize[2];
+            int                 m_iGrow[2];
+            int                 m_iKernelRadius;
+        };
+
+        friend class TileHashTask;
+
+        const FilterKernels*        m_pKernels;
+        Key                         m_Key;
+        bool                        m_bValid;           // The hashes are those of the last dispatch with m_Key
+        unsigned long long*         m_puHashes;         // One per group
+        bool*                       m_pbMissed;         // One per group
+        unsigned int                m_uGroupCapacity;
+        unsigned int                m_uNumGroups;
+        std::atomic<unsigned int>   m_uNumHits;
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,338 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: TileScheduler.cpp
+//
+// Implements the TileScheduler class.
+//--------------------------------------------------------------------------------------
+
+
+#include "TileScheduler.h"
+#include "CPUInfo.h"
+
+
+namespace CPUFilter
+{
+    static inline unsigned long long PackRange( unsigned int uBegin, unsigned int uEnd )
+    {
+        return ( (unsigned long long)uEnd << 32 ) | uBegin;
+    }
+
+    static inline void UnpackRange( unsigned long long uRange, unsigned int& uBegin, unsigned int& uEnd )
+    {
+        uBegin = (unsigned int)( uRange & 0xFFFFFFFF );
+        uEnd = (unsigned int)( uRange >> 32 );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    TileScheduler::TileScheduler()
+    {
+        m_iMaxCores = MAXCORES_USE_ALL_CORES;
+        m_uNumThreads = 0;
+        m_pWorkers = NULL;
+        m_pTask = NULL;
+        m_uGeneration = 0;
+        m_uNumBusyWorkers = 0;
+        m_bQuit = false;
+
+        SetMaximumCores( MAXCORES_USE_ALL_CORES );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Destructor
+    //--------------------------------------------------------------------------------------
+    TileScheduler::~TileScheduler()
+    {
+        StopThreads();
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Maps the max cores type onto a number of threads, as ShaderCache does for the shader
+    // compiler processes
+    //--------------------------------------------------------------------------------------
+    void TileScheduler::SetMaximumCores( int iMaxCores )
+    {
+        const unsigned int uNumCores = GetCPUInfo().m_uNumLogicalCores;
+        unsigned int uNumThreads = 1;
+
+        switch( iMaxCores )
+        {
+        case MAXCORES_NO_LIMIT:
+            m_iMaxCores = MAXCORES_NO_LIMIT;
+            uNumThreads = MAX_WORKER_THREADS;
+            break;
+        case MAXCORES_2X_CPU_CORES:
+            m_iMaxCores = MAXCORES_2X_CPU_CORES;
+            uNumThreads = uNumCores * 2;
+            break;
+        case MAXCORES_USE_ALL_CORES:
+            m_iMaxCores = MAXCORES_USE_ALL_CORES;
+            uNumThreads = uNumCores;
+            break;
+        case MAXCORES_MULTI_THREADED:
+        case MAXCORES_USE_ALL_BUT_ONE:
+            m_iMaxCores = MAXCORES_USE_ALL_BUT_ONE;
+            uNumThreads = ( uNumCores > 1 ) ? ( uNumCores - 1 ) : 1;
+            break;
+        case MAXCORES_SINGLE_THREADED:
+            m_iMaxCores = MAXCORES_SINGLE_THREADED;
+            uNumThreads = 1;
+            break;
+        default:
+            assert( iMaxCores > 0 );
+            m_iMaxCores = iMaxCores;
+            uNumThreads = ( iMaxCores > 0 ) ? (unsigned int)iMaxCores : 1;
+            break;
+        }
+
+        uNumThreads = ( uNumThreads < MAX_WORKER_THREADS ) ? uNumThreads : MAX_WORKER_THREADS;
+
+        if( uNumThreads != m_uNumThreads )
+        {
+            StopThreads();
+            StartThreads( uNumThreads );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Splits the tiles into contiguous ranges, one per thread, so neighbouring tiles (which
+    // share input rows) are mostly computed by the same thread. The calling thread computes
+    // the first range.
+    //--------------------------------------------------------------------------------------
+    void TileScheduler::Run( const TileTask& Task, unsigned int uNumTiles )
+    {
+        if( 0 == uNumTiles )
+        {
+            return;
+        }
+
+        for( unsigned int uWorker = 0; uWorker < m_uNumThreads; ++uWorker )
+        {
+            unsigned int uBegin = (unsigned int)( (unsigned long long)uNumTiles * uWorker / m_uNumThreads );
+            unsigned int uEnd = (unsigned int)( (unsigned long long)uNumTiles * ( uWorker + 1 ) / m_uNumThreads );
+            m_pWorkers[uWorker].m_uRange.store( PackRange( uBegin, uEnd ) );
+        }
+
+        if( 1 == m_uNumThreads )
+        {
+            ComputeTiles( Task, 0 );
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> Lock( m_Mutex );
+            m_pTask = &Task;
+            m_uNumBusyWorkers = m_uNumThreads - 1;
+            ++m_uGeneration;
+        }
+        m_TaskReady.notify_all();
+
+        ComputeTiles( Task, 0 );
+
+        std::unique_lock<std::mutex> Lock( m_Mutex );
+        while( 0 != m_uNumBusyWorkers )
+        {
+            m_TaskDone.wait( Lock );
+        }
+        m_pTask = NULL;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // The calling thread is worker 0, so only the others need a thread
+    //--------------------------------------------------------------------------------------
+    void TileScheduler::StartThreads( unsigned int uNumThreads )
+    {
+        assert( NULL == m_pWorkers );
+
+        m_uNumThreads = uNumThreads;
+        m_pWorkers = new Worker[m_uNumThreads];
+
+        for( unsigned int uWorker = 0; uWorker < m_uNumThreads; ++uWorker )
+        {
+            m_pWorkers[uWorker].m_uRange.store( 0 );
+        }
+
+        for( unsigned int uWorker = 1; uWorker < m_uNumThreads; ++uWorker )
+        {
+            m_pWorkers[uWorker].m_Thread = std::thread( &TileScheduler::ThreadMain, this, uWorker, m_uGeneration );
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Waits for all threads to exit
+    //--------------------------------------------------------------------------------------
+    void TileScheduler::StopThreads()
+    {
+        if( NULL == m_pWorkers )
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> Lock( m_Mutex );
+            m_bQuit = true;
+        }
+        m_TaskReady.notify_all();
+
+        for( unsigned int uWorker = 1; uWorker < m_uNumThreads; ++uWorker )
+        {
+            m_pWorkers[uWorker].m_Thread.join();
+        }
+
+        delete[] m_pWorkers;
+        m_pWorkers = NULL;
+        m_uNumThreads = 0;
+        m_bQuit = false;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Sleeps until a new task is published, then helps to complete it
+    //--------------------------------------------------------------------------------------
+    void TileScheduler::ThreadMain( unsigned int uWorker, unsigned int uGeneration )
+    {
+        for( ;; )
+        {
+            const TileTask* pTask = NULL;
+            {
+                std::unique_lock<std::mutex> Lock( m_Mutex );
+                while( !m_bQuit && uGeneration == m_uGeneration )
+                {
+                    m_TaskReady.wait( Lock );
+                }
+
+                if( m_bQuit )
+                {
+                    return;
+                }
+
+                uGeneration = m_uGeneration;
+                pTask = m_pTask;
+            }
+
+            ComputeTiles( *pTask, uWorker );
+
+            {
+                std::lock_guard<std::mutex> Lock( m_Mutex );
+                if( 0 == --m_uNumBusyWorkers )
+                {
+                    m_TaskDone.notify_one();
+                }
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Works through the range of the worker, then steals from the others until all ranges
+    // are empty
+    //--------------------------------------------------------------------------------------
+    void TileScheduler::ComputeTiles( const TileTask& Task, unsigned int uWorker )
+    {
+        Scratch& LDS = m_pWorkers[uWorker].m_LDS;
+        unsigned int uTile;
+
+        do
+        {
+            while( PopTile( uWorker, uTile ) )
+            {
+                Task.ComputeTile( uTile, LDS );
+            }
+        }
+        while( StealTiles( uWorker ) );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Takes the tile at the front of the range of the worker
+    //--------------------------------------------------------------------------------------
+    bool TileScheduler::PopTile( unsigned int uWorker, unsigned int& uTile )
+    {
+        std::atomic<unsigned long long>& Range = m_pWorkers[uWorker].m_uRange;
+        unsigned long long uRange = Range.load();
+
+        for( ;; )
+        {
+            unsigned int uBegin, uEnd;
+            UnpackRange( uRange, uBegin, uEnd );
+            if( uBegin >= uEnd )
+            {
+                return false;
+            }
+
+            if( Range.compare_exchange_weak( uRange, PackRange( uBegin + 1, uEnd ) ) )
+            {
+                uTile = uBegin;
+                return true;
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Takes the back half of the range of the next worker that has tiles left. The victim
+    // keeps the front half, so it carries on with the tiles next to its last one. Only the
+    // owner stores to its own range, and only while it is empty, which thieves never update.
+    //--------------------------------------------------------------------------------------
+    bool TileScheduler::StealTiles( unsigned int uWorker )
+    {
+        for( unsigned int uOffset = 1; uOffset < m_uNumThreads; ++uOffset )
+        {
+            std::atomic<unsigned long long>& Range = m_pWorkers[( uWorker + uOffset ) % m_uNumThreads].m_uRange;
+            unsigned long long uRange = Range.load();
+
+            for( ;; )
+            {
+                unsigned int uBegin, uEnd;
+                UnpackRange( uRange, uBegin, uEnd );
+                if( uBegin >= uEnd )
+                {
+                    break;
+                }
+
+                unsigned int uMiddle = uBegin + ( uEnd - uBegin ) / 2;
+                if( Range.compare_exchange_weak( uRange, PackRange( uBegin, uMiddle ) ) )
+                {
+                    m_pWorkers[uWorker].m_uRange.store( PackRange( uMiddle, uEnd ) );
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,135 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: TileScheduler.h
+//
+// TileScheduler Class definition.
+// Maps the groups of a dispatch onto a pool of worker threads. Each worker starts on a
+// contiguous range of tiles, and steals half of the remaining range of another worker when
+// its own runs out, so uneven tiles do not leave threads idle.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+namespace CPUFilter
+{
+    // Max cores type enumeration, the same vocabulary as AMD::ShaderCache. Positive values
+    // other than MAXCORES_SINGLE_THREADED request that many threads explicitly.
+    typedef enum _MAXCORES_TYPE
+    {
+        MAXCORES_NO_LIMIT           = -4,   // MAX_WORKER_THREADS
+        MAXCORES_2X_CPU_CORES       = -3,
+        MAXCORES_USE_ALL_CORES      = -2,
+        MAXCORES_USE_ALL_BUT_ONE    = -1,
+        MAXCORES_MULTI_THREADED     =  0,   // Same as MAXCORES_USE_ALL_BUT_ONE
+        MAXCORES_SINGLE_THREADED    =  1
+    }MAXCORES_TYPE;
+
+    static const unsigned int MAX_WORKER_THREADS = 256;
+
+
+    //--------------------------------------------------------------------------------------
+    // A unit of work split into tiles, which may be computed in any order on any thread
+    //--------------------------------------------------------------------------------------
+    class TileTask
+    {
+    public:
+
+        virtual ~TileTask() {}
+
+        virtual void ComputeTile( unsigned int uTile, Scratch& LDS ) const = 0;
+    };
+
+
+    class TileScheduler
+    {
+    public:
+
+        // Constructor / destructor
+        TileScheduler();
+        ~TileScheduler();
+
+        // Takes a MAXCORES_TYPE, or an explicit number of threads. The calling thread counts as
+        // one of them. GetMaximumCores returns the value set, so an explicit count is reported
+        // as itself rather than as a MAXCORES_TYPE.
+        void SetMaximumCores( int iMaxCores );
+        int GetMaximumCores() const { return m_iMaxCores; }
+        unsigned int GetNumThreads() const { return m_uNumThreads; }
+
+        // Computes all tiles of the task, and returns once they are complete
+        void Run( const TileTask& Task, unsigned int uNumTiles );
+
+    private:
+
+        TileScheduler( const TileScheduler& );
+        TileScheduler& operator=( const TileScheduler& );
+
+        // Ranges of tiles are packed as ( end << 32 ) | begin, so they can be updated atomically.
+        // The padding keeps the ranges of different workers on different cache lines.
+        class Worker
+        {
+        public:
+
+            char                                m_Padding0[MEMORY_ALIGNMENT];
+            std::atomic<unsigned long long>     m_uRange;
+            char                                m_Padding1[MEMORY_ALIGNMENT];
+            Scratch                             m_LDS;
+            std::thread                         m_Thread;
+        };
+
+        void StartThreads( unsigned int uNumThreads );
+        void StopThreads();
+        void ThreadMain( unsigned int uWorker, unsigned int uGeneration );
+        void ComputeTiles( const TileTask& Task, unsigned int uWorker );
+        bool PopTile( unsigned int uWorker, unsigned int& uTile );
+        bool StealTiles( unsigned int uWorker );
+
+        int                         m_iMaxCores;
+        unsigned int                m_uNumThreads;
+        Worker*                     m_pWorkers;
+
+        // Current task, published to the workers by bumping the generation
+        const TileTask*             m_pTask;
+        unsigned int                m_uGeneration;
+        unsigned int                m_uNumBusyWorkers;
+        bool                        m_bQuit;
+        std::mutex                  m_Mutex;
+        std::condition_variable     m_TaskReady;
+        std::condition_variable     m_TaskDone;
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
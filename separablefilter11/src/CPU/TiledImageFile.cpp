@@ -0,0 +1,424 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: TiledImageFile.cpp
+//
+// Implements the TiledImageFile class, over the file mapping of Windows or mmap.
+//--------------------------------------------------------------------------------------
+
+
+#include "TiledImageFile.h"
+#include "SIMD.h"
+
+#if defined( _WIN32 )
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Granularity of the offsets of mapped views
+    //--------------------------------------------------------------------------------------
+    static unsigned long long GetMapGranularity()
+    {
+    #if defined( _WIN32 )
+        SYSTEM_INFO SystemInfo;
+        GetSystemInfo( &SystemInfo );
+        return SystemInfo.dwAllocationGranularity;
+    #else
+        return (unsigned long long)sysconf( _SC_PAGESIZE );
+    #endif
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Constructor
+    //--------------------------------------------------------------------------------------
+    TiledImageFile::TiledImageFile()
+    {
+        memset( &m_Header, 0, sizeof( m_Header ) );
+        m_uNumTilesX = 0;
+        m_bOpen = false;
+        m_bWritable = false;
+    #if defined( _WIN32 )
+        m_hFile = INVALID_HANDLE_VALUE;
+        m_hMapping = NULL;
+    #else
+        m_iFile = -1;
+    #endif
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Destructor
+    //--------------------------------------------------------------------------------------
+    TiledImageFile::~TiledImageFile()
+    {
+        Close();
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Writes the header of a file of zero texels, sized for all of its tiles, then opens it.
+    // Extending the file leaves it sparse where the file system allows, so the texels take
+    // no disk space until they are written.
+    //--------------------------------------------------------------------------------------
+    bool TiledImageFile::Create( const char* szPath, unsigned int uWidth, unsigned int uHeight, TEXEL_FORMAT_TYPE Format, unsigned int uTileSize )
+    {
+        assert( NULL != szPath );
+        assert( uWidth > 0 && uHeight > 0 );
+        assert( uTileSize > 0 );
+        assert( Format < TEXEL_FORMAT_TYPE_MAX );
+
+        Close();
+
+        TiledImageHeader Header;
+        memset( &Header, 0, sizeof( Header ) );
+        Header.m_uMagic = TILED_IMAGE_MAGIC;
+        Header.m_uVersion = TILED_IMAGE_VERSION;
+        Header.m_uWidth = uWidth;
+        Header.m_uHeight = uHeight;
+        Header.m_uTileSize = uTileSize;
+        Header.m_uFormat = (unsigned int)Format;
+        Header.m_uDataOffset = TILED_IMAGE_DATA_OFFSET;
+
+        const unsigned long long uNumTiles = (unsigned long long)DivRoundUp( uWidth, uTileSize ) * DivRoundUp( uHeight, uTileSize );
+        const unsigned long long uFileSize = Header.m_uDataOffset + uNumTiles * uTileSize * uTileSize * GetTexelSize( Format );
+
+    #if defined( _WIN32 )
+        HANDLE hFile = CreateFileA( szPath, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL );
+        if( INVALID_HANDLE_VALUE == hFile )
+        {
+            return false;
+        }
+
+        DWORD dwWritten = 0;
+        LARGE_INTEGER FileSize;
+        FileSize.QuadPart = (LONGLONG)uFileSize;
+        bool bCreated = ( FALSE != WriteFile( hFile, &Header, sizeof( Header ), &dwWritten, NULL ) ) && ( sizeof( Header ) == dwWritten ) &&
+            ( FALSE != SetFilePointerEx( hFile, FileSize, NULL, FILE_BEGIN ) ) && ( FALSE != SetEndOfFile( hFile ) );
+        CloseHandle( hFile );
+    #else
+        int iFile = open( szPath, O_RDWR | O_CREAT | O_TRUNC, 0644 );
+        if( iFile < 0 )
+        {
+            return false;
+        }
+
+        bool bCreated = ( (ssize_t)sizeof( Header ) == pwrite( iFile, &Header, sizeof( Header ), 0 ) ) && ( 0 == ftruncate( iFile, (off_t)uFileSize ) );
+        close( iFile );
+    #endif
+
+        return bCreated && Open( szPath, true );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Opens a file, and maps it as a whole. Only the views of ReadLines and WriteLines take
+    // address space, and memory only for the pages they touch.
+    //--------------------------------------------------------------------------------------
+    bool TiledImageFile::Open( const char* szPath, bool bWritable )
+    {
+        assert( NULL != szPath );
+
+        Close();
+
+        unsigned long long uFileSize = 0;
+
+    #if defined( _WIN32 )
+        m_hFile = CreateFileA( szPath, bWritable ? ( GENERIC_READ | GENERIC_WRITE ) : GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+        if( INVALID_HANDLE_VALUE == m_hFile )
+        {
+            return false;
+        }
+
+        DWORD dwRead = 0;
+        LARGE_INTEGER FileSize;
+        if( !ReadFile( m_hFile, &m_Header, sizeof( m_Header ), &dwRead, NULL ) || sizeof( m_Header ) != dwRead || !GetFileSizeEx( m_hFile, &FileSize ) )
+        {
+            Close();
+            return false;
+        }
+        uFileSize = (unsigned long long)FileSize.QuadPart;
+    #else
+        m_iFile = open( szPath, bWritable ? O_RDWR : O_RDONLY );
+        if( m_iFile < 0 )
+        {
+            return false;
+        }
+
+        struct stat FileStat;
+        if( (ssize_t)sizeof( m_Header ) != pread( m_iFile, &m_Header, sizeof( m_Header ), 0 ) || 0 != fstat( m_iFile, &FileStat ) )
+        {
+            Close();
+            return false;
+        }
+        uFileSize = (unsigned long long)FileStat.st_size;
+    #endif
+
+        m_bOpen = true;
+        m_bWritable = bWritable;
+
+        // Validate the header against the size of the file
+        if( TILED_IMAGE_MAGIC != m_Header.m_uMagic || TILED_IMAGE_VERSION != m_Header.m_uVersion || m_Header.m_uFormat >= TEXEL_FORMAT_TYPE_MAX ||
+            0 == m_Header.m_uWidth || 0 == m_Header.m_uHeight || 0 == m_Header.m_uTileSize )
+        {
+            Close();
+            return false;
+        }
+
+        m_uNumTilesX = DivRoundUp( m_Header.m_uWidth, m_Header.m_uTileSize );
+
+        if( uFileSize < m_Header.m_uDataOffset + (unsigned long long)GetTileRowSize() * DivRoundUp( m_Header.m_uHeight, m_Header.m_uTileSize ) )
+        {
+            Close();
+            return false;
+        }
+
+    #if defined( _WIN32 )
+        m_hMapping = CreateFileMappingA( m_hFile, NULL, bWritable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL );
+        if( NULL == m_hMapping )
+        {
+            Close();
+            return false;
+        }
+    #endif
+
+        return true;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Closes the file, any lines written are flushed by the system in its own time
+    //--------------------------------------------------------------------------------------
+    void TiledImageFile::Close()
+    {
+    #if defined( _WIN32 )
+        if( NULL != m_hMapping )
+        {
+            CloseHandle( m_hMapping );
+            m_hMapping = NULL;
+        }
+        if( INVALID_HANDLE_VALUE != m_hFile )
+        {
+            CloseHandle( m_hFile );
+            m_hFile = INVALID_HANDLE_VALUE;
+        }
+    #else
+        if( m_iFile >= 0 )
+        {
+            close( m_iFile );
+            m_iFile = -1;
+        }
+    #endif
+
+        memset( &m_Header, 0, sizeof( m_Header ) );
+        m_uNumTilesX = 0;
+        m_bOpen = false;
+        m_bWritable = false;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Converts lines of the image to float texels
+    //--------------------------------------------------------------------------------------
+    bool TiledImageFile::ReadLines( int iFirstLine, int iNumLines, Surface& Output, int iSurfaceLine ) const
+    {
+        assert( m_bOpen );
+        assert( iFirstLine >= 0 && iNumLines > 0 && iFirstLine + iNumLines <= (int)m_Header.m_uHeight );
+        assert( iSurfaceLine >= 0 && iSurfaceLine + iNumLines <= (int)Output.m_uHeight );
+        assert( Output.m_uWidth >= m_Header.m_uWidth );
+
+        const int iTileSize = (int)m_Header.m_uTileSize;
+        const int iFirstTileRow = iFirstLine / iTileSize;
+        const int iNumTileRows = ( iFirstLine + iNumLines - 1 ) / iTileSize - iFirstTileRow + 1;
+        const unsigned int uTexelSize = GetTexelSize( GetFormat() );
+
+        View V;
+        if( !MapView( m_Header.m_uDataOffset + (unsigned long long)GetTileRowSize() * iFirstTileRow, GetTileRowSize() * iNumTileRows, V ) )
+        {
+            return false;
+        }
+
+        for( int iLine = 0; iLine < iNumLines; ++iLine )
+        {
+            const int iY = iFirstLine + iLine;
+            const unsigned char* pTileRow = V.m_pData + GetTileRowSize() * ( iY / iTileSize - iFirstTileRow ) + (size_t)( iY % iTileSize ) * iTileSize * uTexelSize;
+            Float4* pDst = Output.Row( iSurfaceLine + iLine );
+
+            for( unsigned int uTileX = 0; uTileX < m_uNumTilesX; ++uTileX )
+            {
+                const unsigned char* pSrc = pTileRow + (size_t)uTileX * iTileSize * iTileSize * uTexelSize;
+                const int iX = (int)uTileX * iTileSize;
+                const int iCount = ( iX + iTileSize <= (int)m_Header.m_uWidth ) ? iTileSize : ( (int)m_Header.m_uWidth - iX );
+
+                if( TEXEL_FORMAT_TYPE_R32G32B32A32_FLOAT == GetFormat() )
+                {
+                    memcpy( pDst + iX, pSrc, (size_t)iCount * sizeof( Float4 ) );
+                }
+                else
+                {
+                    float* pChannels = &pDst[iX].x;
+                    for( int i = 0; i < iCount * 4; ++i )
+                    {
+                        pChannels[i] = (float)pSrc[i] * ( 1.0f / 255.0f );
+                    }
+                }
+            }
+        }
+
+        UnmapView( V );
+
+        return true;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Converts float texels to lines of the image
+    //--------------------------------------------------------------------------------------
+    bool TiledImageFile::WriteLines( const Surface& Input, int iSurfaceLine, int iFirstLine, int iNumLines )
+    {
+        assert( m_bOpen && m_bWritable );
+        assert( iFirstLine >= 0 && iNumLines > 0 && iFirstLine + iNumLines <= (int)m_Header.m_uHeight );
+        assert( iSurfaceLine >= 0 && iSurfaceLine + iNumLines <= (int)Input.m_uHeight );
+        assert( Input.m_uWidth >= m_Header.m_uWidth );
+
+        const int iTileSize = (int)m_Header.m_uTileSize;
+        const int iFirstTileRow = iFirstLine / iTileSize;
+        const int iNumTileRows = ( iFirstLine + iNumLines - 1 ) / iTileSize - iFirstTileRow + 1;
+        const unsigned int uTexelSize = GetTexelSize( GetFormat() );
+        const FilterKernels& Kernels = GetFilterKernels();
+
+        View V;
+        if( !MapView( m_Header.m_uDataOffset + (unsigned long long)GetTileRowSize() * iFirstTileRow, GetTileRowSize() * iNumTileRows, V ) )
+        {
+            return false;
+        }
+
+        for( int iLine = 0; iLine < iNumLines; ++iLine )
+        {
+            const int iY = iFirstLine + iLine;
+            unsigned char* pTileRow = V.m_pData + GetTileRowSize() * ( iY / iTileSize - iFirstTileRow ) + (size_t)( iY % iTileSize ) * iTileSize * uTexelSize;
+            const Float4* pSrc = Input.Row( iSurfaceLine + iLine );
+
+            for( unsigned int uTileX = 0; uTileX < m_uNumTilesX; ++uTileX )
+            {
+                unsigned char* pDst = pTileRow + (size_t)uTileX * iTileSize * iTileSize * uTexelSize;
+                const int iX = (int)uTileX * iTileSize;
+                const int iCount = ( iX + iTileSize <= (int)m_Header.m_uWidth ) ? iTileSize : ( (int)m_Header.m_uWidth - iX );
+
+                if( TEXEL_FORMAT_TYPE_R32G32B32A32_FLOAT == GetFormat() )
+                {
+                    memcpy( pDst, pSrc + iX, (size_t)iCount * sizeof( Float4 ) );
+                }
+                else
+                {
+                    Kernels.m_pfnPackRowUNorm8( &pSrc[iX].x, iCount * 4, pDst );
+                }
+            }
+        }
+
+        UnmapView( V );
+
+        return true;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Bytes of a row of tiles, which is contiguous in the file
+    //--------------------------------------------------------------------------------------
+    size_t TiledImageFile::GetTileRowSize() const
+    {
+        return (size_t)m_uNumTilesX * m_Header.m_uTileSize * m_Header.m_uTileSize * GetTexelSize( GetFormat() );
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Maps a range of the file. The lines are walked in order, so the system is told to read
+    // ahead of them, and may drop the pages behind them.
+    //--------------------------------------------------------------------------------------
+    bool TiledImageFile::MapView( unsigned long long uOffset, size_t uSize, View& V ) const
+    {
+        const unsigned long long uGranularity = GetMapGranularity();
+        const unsigned long long uBase = uOffset - uOffset % uGranularity;
+        const size_t uDelta = (size_t)( uOffset - uBase );
+
+        V.m_uSize = uSize + uDelta;
+
+    #if defined( _WIN32 )
+        V.m_pBase = MapViewOfFile( m_hMapping, m_bWritable ? FILE_MAP_WRITE : FILE_MAP_READ, (DWORD)( uBase >> 32 ), (DWORD)uBase, V.m_uSize );
+        if( NULL == V.m_pBase )
+        {
+            return false;
+        }
+    #else
+        V.m_pBase = mmap( NULL, V.m_uSize, m_bWritable ? ( PROT_READ | PROT_WRITE ) : PROT_READ, MAP_SHARED, m_iFile, (off_t)uBase );
+        if( MAP_FAILED == V.m_pBase )
+        {
+            V.m_pBase = NULL;
+            return false;
+        }
+        madvise( V.m_pBase, V.m_uSize, MADV_SEQUENTIAL );
+    #endif
+
+        V.m_pData = (unsigned char*)V.m_pBase + uDelta;
+
+        return true;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // Unmaps a view, leaving its written pages to be flushed by the system
+    //--------------------------------------------------------------------------------------
+    void TiledImageFile::UnmapView( View& V ) const
+    {
+    #if defined( _WIN32 )
+        UnmapViewOfFile( V.m_pBase );
+    #else
+        munmap( V.m_pBase, V.m_uSize );
+    #endif
+
+        V.m_pBase = NULL;
+        V.m_pData = NULL;
+        V.m_uSize = 0;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: TiledImageFile.h
+//
+// TiledImageFile Class definition.
+// A container file for images too large to hold in memory. The texels are stored in
+// square tiles, tile row by tile row, so any band of lines is one contiguous range of
+// the file, which is memory mapped one band at a time rather than read into a copy.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterCommon.h"
+
+
+namespace CPUFilter
+{
+    // Texel format enumeration, the formats the container can store
+    typedef enum _TEXEL_FORMAT_TYPE
+    {
+        TEXEL_FORMAT_TYPE_R8G8B8A8_UNORM,
+        TEXEL_FORMAT_TYPE_R32G32B32A32_FLOAT,
+        TEXEL_FORMAT_TYPE_MAX
+    }TEXEL_FORMAT_TYPE;
+
+    // Size in bytes of a texel of each format
+    inline unsigned int GetTexelSize( TEXEL_FORMAT_TYPE Format )
+    {
+        return ( TEXEL_FORMAT_TYPE_R8G8B8A8_UNORM == Format ) ? 4 : 16;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    // The file starts with this header, and the tiles follow at m_uDataOffset. Tiles on
+    // the right and bottom edges are stored whole, with their texels past the image left
+    // as zero.
+    //--------------------------------------------------------------------------------------
+    struct TiledImageHeader
+    {
+        unsigned int        m_uMagic;           // TILED_IMAGE_MAGIC
+        unsigned int        m_uVersion;
+        unsigned int        m_uWidth;
+        unsigned int        m_uHeight;
+        unsigned int        m_uTileSize;        // In texels, tiles are square
+        unsigned int        m_uFormat;          // TEXEL_FORMAT_TYPE
+        unsigned long long  m_uDataOffset;      // In bytes, from the start of the file
+    };
+
+    static const unsigned int TILED_IMAGE_MAGIC         = 0x49544653;   // "SFTI"
+    static const unsigned int TILED_IMAGE_VERSION       = 1;
+    static const unsigned int TILED_IMAGE_DATA_OFFSET   = 4096;         // Keeps the tiles page aligned
+
+
+    class TiledImageFile
+    {
+    public:
+
+        // Constructor / destructor
+        TiledImageFile();
+        ~TiledImageFile();
+
+        // Creates a file of zero texels, replacing any file at the path, and leaves it open for
+        // writing. Returns false if it could not be created at its full size.
+        bool Create( const char* szPath, unsigned int uWidth, unsigned int uHeight, TEXEL_FORMAT_TYPE Format, unsigned int uTileSize = 256 );
+
+        // Opens an existing file, returns false if it is not a valid container
+        bool Open( const char* szPath, bool bWritable );
+        void Close();
+
+        bool IsOpen() const { return m_bOpen; }
+        bool IsWritable() const { return m_bWritable; }
+        unsigned int GetWidth() const { return m_Header.m_uWidth; }
+        unsigned int GetHeight() const { return m_Header.m_uHeight; }
+        unsigned int GetTileSize() const { return m_Header.m_uTileSize; }
+        TEXEL_FORMAT_TYPE GetFormat() const { return (TEXEL_FORMAT_TYPE)m_Header.m_uFormat; }
+
+        // Converts iNumLines lines of the image, from iFirstLine, to the lines of the surface
+        // from iSurfaceLine. Maps the tile rows covering the lines for the duration of the call
+        // only, so calls for different lines may run on different threads at once.
+        bool ReadLines( int iFirstLine, int iNumLines, Surface& Output, int iSurfaceLine ) const;
+
+        // Converts lines of the surface to the image, the reverse of ReadLines. 8 bit texels are
+        // rounded to nearest and saturated.
+        bool WriteLines( const Surface& Input, int iSurfaceLine, int iFirstLine, int iNumLines );
+
+    private:
+
+        TiledImageFile( const TiledImageFile& );
+        TiledImageFile& operator=( const TiledImageFile& );
+
+        // A view of a range of the file, from an offset rounded down to the granularity the
+        // platform maps at
+        struct View
+        {
+            void*           m_pBase;
+            size_t          m_uSize;
+            unsigned char*  m_pData;            // The first byte asked for
+        };
+
+        size_t GetTileRowSize() const;
+        bool MapView( unsigned long long uOffset, size_t uSize, View& V ) const;
+        void UnmapView( View& V ) const;
+
+        TiledImageHeader    m_Header;
+        unsigned int        m_uNumTilesX;
+        bool                m_bOpen;
+        bool                m_bWritable;
+    #if defined( _WIN32 )
+        void*               m_hFile;            // HANDLEs, kept as void* so windows.h stays out of the header
+        void*               m_hMapping;
+    #else
+        int                 m_iFile;
+    #endif
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
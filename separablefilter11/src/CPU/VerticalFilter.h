@@ -0,0 +1,131 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: VerticalFilter.h
+//
+// Implements the vertical pass of the CPU kernel, mirroring CSFilterY in VerticalFilter.hlsl.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "FilterKernel.h"
+
+
+namespace CPUFilter
+{
+    //--------------------------------------------------------------------------------------
+    // Wraps a user filter class as the vertical pass of a separable filter
+    //--------------------------------------------------------------------------------------
+    template< class Filter >
+    class VerticalFilter : public Filter
+    {
+    public:
+
+        typedef typename Filter::LDSItem        LDSItem;
+        typedef typename Filter::RAWDataItem    RAWDataItem;
+
+        VerticalFilter() { m_iDispatchOrigin[0] = 0; m_iDispatchOrigin[1] = 0; }
+
+        // Equivalent of g_i4DispatchOrigin, the coord of the first pixel of group ( 0, 0 ), so
+        // the groups of SeparableFilter::OnRenderDirty can be computed
+        void SetDispatchOrigin( int iX, int iY ) { m_iDispatchOrigin[0] = iX; m_iDispatchOrigin[1] = iY; }
+
+        //--------------------------------------------------------------------------------------
+        // ceil( Width / RUN_LINES ) x ceil( Height / RUN_SIZE ) groups, as SeparableFilter::OnRender
+        //--------------------------------------------------------------------------------------
+        virtual void GetDispatchSize( unsigned int& uX, unsigned int& uY ) const
+        {
+            uX = DivRoundUp( (unsigned int)this->OutputWidth(), RUN_LINES );
+            uY = DivRoundUp( (unsigned int)this->OutputHeight(), RUN_SIZE );
+        }
+
+        virtual void GetGroupSize( unsigned int& uWidth, unsigned int& uHeight ) const
+        {
+            uWidth = RUN_LINES;
+            uHeight = RUN_SIZE;
+        }
+
+
+        //--------------------------------------------------------------------------------------
+        // Equivalent of CSFilterY for one group
+        //--------------------------------------------------------------------------------------
+        virtual void ComputeGroup( unsigned int uGroupX, unsigned int uGroupY, Scratch& LDS ) const
+        {
+            const int iKernelRadius = this->KernelRadius();
+            const int iRunSizePlusKernel = RunSizePlusKernel( iKernelRadius );
+            const int iLDSLineStride = LDSLineStride( iKernelRadius );
+            LDSItem* pLDS = (LDSItem*)LDS.Reserve( sizeof( LDSItem ) * iLDSLineStride * RUN_LINES );
+            RAWDataItem RDI;
+
+            // Group coords from group IDs, offset to the origin of the dispatch
+            int iGroupCoordX = (int)uGroupX * RUN_LINES + m_iDispatchOrigin[0];
+            int iGroupCoordY = (int)uGroupY * RUN_SIZE - iKernelRadius + m_iDispatchOrigin[1];
+            int iNumLines = this->OutputWidth() - iGroupCoordX;
+            iNumLines = ( iNumLines < RUN_LINES ) ? iNumLines : RUN_LINES;
+
+            // Sample and store to LDS
+            for( int iLineOffset = 0; iLineOffset < iNumLines; ++iLineOffset )
+            {
+                LDSItem* pLDSLine = pLDS + iLineOffset * iLDSLineStride;
+
+                for( int i = 0; i < iRunSizePlusKernel; ++i )
+                {
+                    Sample( *this, iGroupCoordX + iLineOffset, iGroupCoordY + i, 0.0f, LDSSampleOffset< Filter >(), RDI );
+                    this->WriteToLDS( RDI, pLDSLine[i] );
+                }
+                memset( pLDSLine + iRunSizePlusKernel, 0, sizeof( LDSItem ) * ( iLDSLineStride - iRunSizePlusKernel ) );
+            }
+
+            // Compute PIXELS_PER_THREAD pixels per thread
+            for( int iLineOffset = 0; iLineOffset < iNumLines; ++iLineOffset )
+            {
+                for( int iThread = 0; iThread < NUM_THREADS; ++iThread )
+                {
+                    int iPixelOffset = iThread * PIXELS_PER_THREAD;
+                    int iCenterY = iGroupCoordY + iPixelOffset + iKernelRadius;
+
+                    // Ensure we don't compute pixels off screen
+                    if( iCenterY < this->OutputHeight() )
+                    {
+                        int iNumPixels = this->OutputHeight() - iCenterY;
+                        iNumPixels = ( iNumPixels < PIXELS_PER_THREAD ) ? iNumPixels : PIXELS_PER_THREAD;
+
+                        // Compute the filter kernel using LDS values
+                        ComputeFilterKernel( *this, pLDS + iLineOffset * iLDSLineStride, iPixelOffset, iGroupCoordX + iLineOffset, iCenterY, 0, 1, iNumPixels );
+                    }
+                }
+            }
+        }
+
+    private:
+
+        int m_iDispatchOrigin[2];
+    };
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
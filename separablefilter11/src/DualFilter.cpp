@@ -0,0 +1,330 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: DualFilter.cpp
+//
+// Implements the DualFilter class.
+// Renders the downsample and upsample passes of the dual filter chain into its
+// AMD::Texture2D levels.
+//--------------------------------------------------------------------------------------
+
+
+#include "..\\..\\DXUT\\Core\\DXUT.h"
+#include "..\\..\\AMD_SDK\\inc\\AMD_SDK.h"
+#include "DualFilter.h"
+#include "CPU\\DualFilter.h"
+
+
+using namespace DirectX;
+
+//--------------------------------------------------------------------------------------
+// Constructor
+//--------------------------------------------------------------------------------------
+DualFilter::DualFilter()
+{
+    m_uWidth = 0;
+    m_uHeight = 0;
+    m_iMaxLevels = 0;
+    m_fDeviation = 16.0f;
+    m_iNumLevels = 0;
+    m_fChainDeviation = 0.0f;
+    m_pDownsampleShader = NULL;
+    m_pUpsampleShader = NULL;
+    m_pScreenQuadVertexBuffer = NULL;
+    m_pScreenInputLayout = NULL;
+    m_pVSTexturedScreenQuad = NULL;
+    m_pLinearClampSampler = NULL;
+    m_pDualFilterCB = NULL;
+}
+
+
+//--------------------------------------------------------------------------------------
+// destructor
+//--------------------------------------------------------------------------------------
+DualFilter::~DualFilter()
+{
+    OnReleasingSwapChain();
+    OnDestroyDevice();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Picks the depth of the chain with the same rule as the CPU chain
+//--------------------------------------------------------------------------------------
+void DualFilter::SetDeviation( float fDeviation )
+{
+    assert( fDeviation > 0.0f );
+
+    m_fDeviation = fDeviation;
+    m_iNumLevels = CPUFilter::ComputeDualFilterLevels( fDeviation, &m_fChainDeviation, m_uWidth, m_uHeight );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Likely set the shaders once after creation, though could be every frame
+//--------------------------------------------------------------------------------------
+void DualFilter::SetPixelShaders( ID3D11PixelShader* pDownsampleShader, ID3D11PixelShader* pUpsampleShader )
+{
+    assert( NULL != pDownsampleShader );
+    assert( NULL != pUpsampleShader );
+
+    m_pDownsampleShader = pDownsampleShader;
+    m_pUpsampleShader = pUpsampleShader;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Device hook method
+//--------------------------------------------------------------------------------------
+HRESULT DualFilter::OnCreateDevice( ID3D11Device* pd3dDevice )
+{
+    HRESULT hr = E_FAIL;
+
+    // Linear Clamp sampler
+    D3D11_SAMPLER_DESC samDesc;
+    ZeroMemory( &samDesc, sizeof(samDesc) );
+    samDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+    samDesc.AddressU = samDesc.AddressV = samDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+    samDesc.MaxAnisotropy = 1;
+    samDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+    samDesc.MaxLOD = D3D11_FLOAT32_MAX;
+    V_RETURN( pd3dDevice->CreateSamplerState( &samDesc, &m_pLinearClampSampler ) );
+
+    // Create constant buffer
+    D3D11_BUFFER_DESC cbDesc;
+    ZeroMemory( &cbDesc, sizeof(cbDesc) );
+    cbDesc.Usage = D3D11_USAGE_DYNAMIC;
+    cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    cbDesc.ByteWidth = sizeof( DualFilterConstantBuffer );
+    V_RETURN( pd3dDevice->CreateBuffer( &cbDesc, NULL, &m_pDualFilterCB ) );
+
+    // Fill out a unit quad
+    ScreenQuadVertex QuadVertices[6];
+    QuadVertices[0].v3Pos = XMFLOAT3( -1.0f, -1.0f, 0.5f );
+    QuadVertices[0].v2TexCoord = XMFLOAT2( 0.0f, 1.0f );
+    QuadVertices[1].v3Pos = XMFLOAT3( -1.0f, 1.0f, 0.5f );
+    QuadVertices[1].v2TexCoord = XMFLOAT2( 0.0f, 0.0f );
+    QuadVertices[2].v3Pos = XMFLOAT3( 1.0f, -1.0f, 0.5f );
+    QuadVertices[2].v2TexCoord = XMFLOAT2( 1.0f, 1.0f );
+    QuadVertices[3].v3Pos = XMFLOAT3( -1.0f, 1.0f, 0.5f );
+    QuadVertices[3].v2TexCoord = XMFLOAT2( 0.0f, 0.0f );
+    QuadVertices[4].v3Pos = XMFLOAT3( 1.0f, 1.0f, 0.5f );
+    QuadVertices[4].v2TexCoord = XMFLOAT2( 1.0f, 0.0f );
+    QuadVertices[5].v3Pos = XMFLOAT3( 1.0f, -1.0f, 0.5f );
+    QuadVertices[5].v2TexCoord = XMFLOAT2( 1.0f, 1.0f );
+
+    // Create the vertex buffer
+    D3D11_BUFFER_DESC BD;
+    BD.Usage = D3D11_USAGE_DYNAMIC;
+    BD.ByteWidth = sizeof( ScreenQuadVertex ) * 6;
+    BD.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    BD.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    BD.MiscFlags = 0;
+    D3D11_SUBRESOURCE_DATA InitData;
+    InitData.pSysMem = QuadVertices;
+    V_RETURN( pd3dDevice->CreateBuffer( &BD, &InitData, &m_pScreenQuadVertexBuffer ) )
+
+    // Input layout and VS for Screen quads
+    ID3DBlob* pBlob = NULL;
+    V_RETURN( AMD::CompileShaderFromFile( L"..\\src\\Shaders\\SeparableFilter11.hlsl", "VSTexturedScreenQuad", "vs_5_0", &pBlob, NULL ) );
+    V_RETURN( pd3dDevice->CreateVertexShader( pBlob->GetBufferPointer(), pBlob->GetBufferSize(), NULL, &m_pVSTexturedScreenQuad ) );
+    const D3D11_INPUT_ELEMENT_DESC Layout[] =
+    {
+        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0,  0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+        { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    };
+    V_RETURN( pd3dDevice->CreateInputLayout( Layout, ARRAYSIZE( Layout ), pBlob->GetBufferPointer(), pBlob->GetBufferSize(), &m_pScreenInputLayout ) );
+    SAFE_RELEASE( pBlob );
+
+    return hr;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Device hook method
+//--------------------------------------------------------------------------------------
+void DualFilter::OnDestroyDevice()
+{
+    SAFE_RELEASE( m_pLinearClampSampler );
+    SAFE_RELEASE( m_pDualFilterCB );
+    SAFE_RELEASE( m_pScreenQuadVertexBuffer );
+    SAFE_RELEASE( m_pVSTexturedScreenQuad );
+    SAFE_RELEASE( m_pScreenInputLayout );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Device hook method
+// Creates every level the back buffer size allows, as PyramidFilter, so the deviation can
+// change without recreating them. The levels only need to be sampled and rendered to, and
+// are stored as halves, so keep the range of HDR inputs.
+//--------------------------------------------------------------------------------------
+HRESULT DualFilter::OnResizedSwapChain( ID3D11Device* pd3dDevice, const DXGI_SURFACE_DESC* pBackBufferSurfaceDesc )
+{
+    OnReleasingSwapChain();
+
+    m_uWidth = pBackBufferSurfaceDesc->Width;
+    m_uHeight = pBackBufferSurfaceDesc->Height;
+
+    // Stop before a level would be under 2 texels across, as CPUFilter::ComputeDualFilterLevels
+    while( m_iMaxLevels < m_iMAX_LEVELS && LevelWidth( m_iMaxLevels ) >= 4 && LevelHeight( m_iMaxLevels ) >= 4 )
+    {
+        const int iLevel = m_iMaxLevels + 1;
+
+        HRESULT hr = m_Levels[iLevel].CreateSurface( pd3dDevice, ( LevelWidth( iLevel - 1 ) + 1 ) / 2, ( LevelHeight( iLevel - 1 ) + 1 ) / 2, 1, 1, 1,
+            DXGI_FORMAT_R16G16B16A16_FLOAT, DXGI_FORMAT_R16G16B16A16_FLOAT, DXGI_FORMAT_R16G16B16A16_FLOAT,
+            DXGI_FORMAT_UNKNOWN, DXGI_FORMAT_UNKNOWN, DXGI_FORMAT_UNKNOWN, D3D11_USAGE_DEFAULT, false, 0, NULL, NULL, 0 );
+        if( FAILED( hr ) )
+        {
+            return hr;
+        }
+        DXUT_SetDebugName( m_Levels[iLevel]._t2d, "Dual Filter Level" );
+        DXUT_SetDebugName( m_Levels[iLevel]._srv, "Dual Filter Level SRV" );
+        DXUT_SetDebugName( m_Levels[iLevel]._rtv, "Dual Filter Level RTV" );
+
+        m_iMaxLevels = iLevel;
+    }
+
+    SetDeviation( m_fDeviation );
+
+    return S_OK;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Releases the levels created in OnResizedSwapChain
+//--------------------------------------------------------------------------------------
+void DualFilter::OnReleasingSwapChain()
+{
+    for( int iLevel = 0; iLevel <= m_iMAX_LEVELS; ++iLevel )
+    {
+        m_Levels[iLevel].Release();
+    }
+
+    m_iMaxLevels = 0;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Halves the input down to the coarse level and doubles it straight back up to the
+// output. Each upsample overwrites the level it upsamples to, which the downsamples are
+// done with.
+//--------------------------------------------------------------------------------------
+void DualFilter::OnRender( ID3D11ShaderResourceView* pInputSRV, ID3D11RenderTargetView* pOutputRTV )
+{
+    assert( m_iNumLevels > 0 && m_iNumLevels <= m_iMaxLevels );
+    assert( NULL != m_pDownsampleShader && NULL != m_pUpsampleShader );
+
+    ID3D11DeviceContext* pd3dContext = DXUTGetD3D11DeviceContext();
+
+    // Store the currently set render target and viewport
+    ID3D11RenderTargetView* pOrigRTV = NULL;
+    pd3dContext->OMGetRenderTargets( 1, &pOrigRTV, NULL );
+    UINT uNumViewports = 1;
+    D3D11_VIEWPORT OrigViewport;
+    pd3dContext->RSGetViewports( &uNumViewports, &OrigViewport );
+
+    // Input layout, VS, sampler and constant buffer for the screen quads of the chain
+    UINT Stride = sizeof( ScreenQuadVertex );
+    UINT Offset = 0;
+    pd3dContext->IASetInputLayout( m_pScreenInputLayout );
+    pd3dContext->IASetVertexBuffers( 0, 1, &m_pScreenQuadVertexBuffer, &Stride, &Offset );
+    pd3dContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+    pd3dContext->VSSetShader( m_pVSTexturedScreenQuad, NULL, 0 );
+    pd3dContext->PSSetSamplers( 0, 1, &m_pLinearClampSampler );
+    pd3dContext->PSSetConstantBuffers( 5, 1, &m_pDualFilterCB );
+
+    TIMER_Begin( 0, L"Downsample" )
+
+    for( int iLevel = 1; iLevel <= m_iNumLevels; ++iLevel )
+    {
+        RenderLevel( m_pDownsampleShader, ( 1 == iLevel ) ? pInputSRV : m_Levels[iLevel - 1]._srv, iLevel - 1, m_Levels[iLevel]._rtv, iLevel );
+    }
+
+    TIMER_End() // Downsample
+
+    TIMER_Begin( 0, L"Upsample" )
+
+    for( int iLevel = m_iNumLevels - 1; iLevel >= 0; --iLevel )
+    {
+        RenderLevel( m_pUpsampleShader, m_Levels[iLevel + 1]._srv, iLevel + 1, ( 0 == iLevel ) ? pOutputRTV : m_Levels[iLevel]._rtv, iLevel );
+    }
+
+    TIMER_End() // Upsample
+
+    // Set back to the original RT and viewport
+    pd3dContext->RSSetViewports( 1, &OrigViewport );
+    pd3dContext->OMSetRenderTargets( 1, &pOrigRTV, NULL );
+    SAFE_RELEASE( pOrigRTV );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Renders one pass of the chain, from a level to the next one up or down
+//--------------------------------------------------------------------------------------
+void DualFilter::RenderLevel( ID3D11PixelShader* pShader, ID3D11ShaderResourceView* pInputSRV, int iInputLevel, ID3D11RenderTargetView* pOutputRTV, int iOutputLevel )
+{
+    ID3D11DeviceContext* pd3dContext = DXUTGetD3D11DeviceContext();
+    ID3D11RenderTargetView* pNULLRTV = NULL;
+    ID3D11ShaderResourceView* pNULLSRV = NULL;
+
+    D3D11_MAPPED_SUBRESOURCE MappedResource;
+    pd3dContext->Map( m_pDualFilterCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &MappedResource );
+    DualFilterConstantBuffer* pDualFilterCB = ( DualFilterConstantBuffer* )MappedResource.pData;
+    pDualFilterCB->fInputSize[0] = (float)LevelWidth( iInputLevel );
+    pDualFilterCB->fInputSize[1] = (float)LevelHeight( iInputLevel );
+    pDualFilterCB->fInputSize[2] = 1.0f / (float)LevelWidth( iInputLevel );
+    pDualFilterCB->fInputSize[3] = 1.0f / (float)LevelHeight( iInputLevel );
+    pd3dContext->Unmap( m_pDualFilterCB, 0 );
+
+    SetViewport( iOutputLevel );
+    pd3dContext->OMSetRenderTargets( 1, &pOutputRTV, NULL );
+    pd3dContext->PSSetShaderResources( 0, 1, &pInputSRV );
+    pd3dContext->PSSetShader( pShader, NULL, 0 );
+    pd3dContext->Draw( 6, 0 );
+    pd3dContext->OMSetRenderTargets( 1, &pNULLRTV, NULL );
+    pd3dContext->PSSetShaderResources( 0, 1, &pNULLSRV );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Covers the whole of a level
+//--------------------------------------------------------------------------------------
+void DualFilter::SetViewport( int iLevel )
+{
+    D3D11_VIEWPORT Viewport;
+    Viewport.TopLeftX = 0.0f;
+    Viewport.TopLeftY = 0.0f;
+    Viewport.Width = (float)LevelWidth( iLevel );
+    Viewport.Height = (float)LevelHeight( iLevel );
+    Viewport.MinDepth = 0.0f;
+    Viewport.MaxDepth = 1.0f;
+
+    DXUTGetD3D11DeviceContext()->RSSetViewports( 1, &Viewport );
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
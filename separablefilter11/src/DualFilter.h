@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: DualFilter.h
+//
+// DualFilter Class definition.
+// Blurs for bloom with a dual filter chain: the image is halved a number of times and
+// doubled straight back up, with no filtering at the coarse level. The levels are
+// AMD::Texture2D surfaces, and the depth of the chain is picked from the deviation asked
+// for.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "..\\..\\AMD_LIB\\src\\AMD_Texture2D.h"
+
+
+class DualFilter
+{
+public:
+
+    // Needs to match MAX_DUAL_FILTER_LEVELS in CPU\DualFilter.h
+    static const int m_iMAX_LEVELS = 8;
+
+    // Constructor / destructor
+    DualFilter();
+    ~DualFilter();
+
+    // Requested deviation at full resolution, which picks the depth of the chain. The chain's
+    // own deviation is that of the nearest depth.
+    void SetDeviation( float fDeviation );
+    float GetDeviation() const { return m_fDeviation; }
+    int GetNumLevels() const { return m_iNumLevels; }
+    float GetChainDeviation() const { return m_fChainDeviation; }
+
+    // The PSDualDownsample and PSDualUpsample shaders of DualFilter.hlsl
+    void SetPixelShaders( ID3D11PixelShader* pDownsampleShader, ID3D11PixelShader* pUpsampleShader );
+
+    // Device hook methods
+    HRESULT OnCreateDevice( ID3D11Device* pd3dDevice );
+    void OnDestroyDevice();
+    HRESULT OnResizedSwapChain( ID3D11Device* pd3dDevice, const DXGI_SURFACE_DESC* pBackBufferSurfaceDesc );
+    void OnReleasingSwapChain();
+
+    // Blurs the input into the output, both of the back buffer size. They may be views of
+    // the same texture, as the input is only read by the first downsample.
+    void OnRender( ID3D11ShaderResourceView* pInputSRV, ID3D11RenderTargetView* pOutputRTV );
+
+private:
+
+    void RenderLevel( ID3D11PixelShader* pShader, ID3D11ShaderResourceView* pInputSRV, int iInputLevel, ID3D11RenderTargetView* pOutputRTV, int iOutputLevel );
+    void SetViewport( int iLevel );
+    unsigned int LevelWidth( int iLevel ) const { return ( 0 == iLevel ) ? m_uWidth : m_Levels[iLevel]._width; }
+    unsigned int LevelHeight( int iLevel ) const { return ( 0 == iLevel ) ? m_uHeight : m_Levels[iLevel]._height; }
+
+    class ScreenQuadVertex
+    {
+    public:
+        DirectX::XMFLOAT3 v3Pos;
+        DirectX::XMFLOAT2 v2TexCoord;
+    };
+
+    class DualFilterConstantBuffer
+    {
+    public:
+        float fInputSize[4]; // ( [0] = Width, [1] = Height, [2] = Inv Width, [3] = Inv Height )
+    };
+
+    // Level 0 is the input and output, so has no surface
+    AMD::Texture2D              m_Levels[m_iMAX_LEVELS + 1];
+    unsigned int                m_uWidth;
+    unsigned int                m_uHeight;
+    int                         m_iMaxLevels;       // Allowed by the size of the back buffer
+    float                       m_fDeviation;
+    int                         m_iNumLevels;
+    float                       m_fChainDeviation;
+    ID3D11PixelShader*          m_pDownsampleShader;
+    ID3D11PixelShader*          m_pUpsampleShader;
+    ID3D11Buffer*               m_pScreenQuadVertexBuffer;
+    ID3D11InputLayout*          m_pScreenInputLayout;
+    ID3D11VertexShader*         m_pVSTexturedScreenQuad;
+    ID3D11SamplerState*         m_pLinearClampSampler;
+    ID3D11Buffer*               m_pDualFilterCB;
+};
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
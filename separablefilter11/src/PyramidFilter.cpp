@@ -0,0 +1,412 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: PyramidFilter.cpp
+//
+// Implements the PyramidFilter class.
+// Renders the downsample and upsample passes of the pyramid, and the Gaussian filter at its
+// coarse level through a SeparableFilter.
+//--------------------------------------------------------------------------------------
+
+
+#include "..\\..\\DXUT\\Core\\DXUT.h"
+#include "..\\..\\AMD_SDK\\inc\\AMD_SDK.h"
+#include "SeparableFilter.h"
+#include "PyramidFilter.h"
+#include "CPU\\GaussianPyramid.h"
+
+
+using namespace DirectX;
+
+//--------------------------------------------------------------------------------------
+// Constructor
+//--------------------------------------------------------------------------------------
+PyramidFilter::PyramidFilter()
+{
+    memset( m_pLevelTexture, 0, sizeof( m_pLevelTexture ) );
+    memset( m_pLevelSRV, 0, sizeof( m_pLevelSRV ) );
+    memset( m_pLevelRTV, 0, sizeof( m_pLevelRTV ) );
+    memset( m_pLevelUAV, 0, sizeof( m_pLevelUAV ) );
+    memset( m_uLevelWidth, 0, sizeof( m_uLevelWidth ) );
+    memset( m_uLevelHeight, 0, sizeof( m_uLevelHeight ) );
+    m_iMaxLevels = 0;
+    m_fDeviation = 16.0f;
+    m_iNumLevels = 0;
+    m_fCoarseDeviation = 0.0f;
+    m_pDownsampleShader = NULL;
+    m_pUpsampleShader = NULL;
+    m_pCoarsePixelShaders[0] = NULL; m_pCoarsePixelShaders[1] = NULL;
+    m_pCoarseComputeShaders[0] = NULL; m_pCoarseComputeShaders[1] = NULL;
+    m_eCoarseKernelRadius = SeparableFilter::KERNEL_RADIUS_TYPE_2;
+    m_pScreenQuadVertexBuffer = NULL;
+    m_pScreenInputLayout = NULL;
+    m_pVSTexturedScreenQuad = NULL;
+    m_pLinearClampSampler = NULL;
+    m_pPyramidCB = NULL;
+}
+
+
+//--------------------------------------------------------------------------------------
+// destructor
+//--------------------------------------------------------------------------------------
+PyramidFilter::~PyramidFilter()
+{
+    OnReleasingSwapChain();
+    OnDestroyDevice();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Picks the number of levels with the same rule as the CPU pyramid
+//--------------------------------------------------------------------------------------
+void PyramidFilter::SetDeviation( float fDeviation )
+{
+    assert( fDeviation > 0.0f );
+
+    m_fDeviation = fDeviation;
+
+    const float fMaxCoarseDeviation = ( fDeviation * 0.5f < 4.0f ) ? fDeviation * 0.5f : 4.0f;
+    m_iNumLevels = CPUFilter::ComputePyramidLevels( fDeviation, fMaxCoarseDeviation, &m_fCoarseDeviation, m_uLevelWidth[0], m_uLevelHeight[0] );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Likely set the shaders once after creation, though could be every frame
+//--------------------------------------------------------------------------------------
+void PyramidFilter::SetPixelShaders( ID3D11PixelShader* pDownsampleShader, ID3D11PixelShader* pUpsampleShader )
+{
+    assert( NULL != pDownsampleShader );
+    assert( NULL != pUpsampleShader );
+
+    m_pDownsampleShader = pDownsampleShader;
+    m_pUpsampleShader = pUpsampleShader;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Set every frame, as the radius follows the coarse deviation
+//--------------------------------------------------------------------------------------
+void PyramidFilter::SetCoarsePixelShaders( ID3D11PixelShader* pHorizShader, ID3D11PixelShader* pVertShader )
+{
+    assert( NULL != pHorizShader );
+    assert( NULL != pVertShader );
+
+    m_pCoarsePixelShaders[0] = pHorizShader;
+    m_pCoarsePixelShaders[1] = pVertShader;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Set every frame, as the radius follows the coarse deviation
+//--------------------------------------------------------------------------------------
+void PyramidFilter::SetCoarseComputeShaders( ID3D11ComputeShader* pHorizShader, ID3D11ComputeShader* pVertShader, SeparableFilter::KERNEL_RADIUS_TYPE KernelRadius )
+{
+    assert( NULL != pHorizShader );
+    assert( NULL != pVertShader );
+
+    m_pCoarseComputeShaders[0] = pHorizShader;
+    m_pCoarseComputeShaders[1] = pVertShader;
+    m_eCoarseKernelRadius = KernelRadius;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Device hook method
+//--------------------------------------------------------------------------------------
+HRESULT PyramidFilter::OnCreateDevice( ID3D11Device* pd3dDevice )
+{
+    HRESULT hr = E_FAIL;
+
+    // Linear Clamp sampler
+    D3D11_SAMPLER_DESC samDesc;
+    ZeroMemory( &samDesc, sizeof(samDesc) );
+    samDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+    samDesc.AddressU = samDesc.AddressV = samDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+    samDesc.MaxAnisotropy = 1;
+    samDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+    samDesc.MaxLOD = D3D11_FLOAT32_MAX;
+    V_RETURN( pd3dDevice->CreateSamplerState( &samDesc, &m_pLinearClampSampler ) );
+
+    // Create constant buffer
+    D3D11_BUFFER_DESC cbDesc;
+    ZeroMemory( &cbDesc, sizeof(cbDesc) );
+    cbDesc.Usage = D3D11_USAGE_DYNAMIC;
+    cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    cbDesc.ByteWidth = sizeof( PyramidConstantBuffer );
+    V_RETURN( pd3dDevice->CreateBuffer( &cbDesc, NULL, &m_pPyramidCB ) );
+
+    // Fill out a unit quad
+    ScreenQuadVertex QuadVertices[6];
+    QuadVertices[0].v3Pos = XMFLOAT3( -1.0f, -1.0f, 0.5f );
+    QuadVertices[0].v2TexCoord = XMFLOAT2( 0.0f, 1.0f );
+    QuadVertices[1].v3Pos = XMFLOAT3( -1.0f, 1.0f, 0.5f );
+    QuadVertices[1].v2TexCoord = XMFLOAT2( 0.0f, 0.0f );
+    QuadVertices[2].v3Pos = XMFLOAT3( 1.0f, -1.0f, 0.5f );
+    QuadVertices[2].v2TexCoord = XMFLOAT2( 1.0f, 1.0f );
+    QuadVertices[3].v3Pos = XMFLOAT3( -1.0f, 1.0f, 0.5f );
+    QuadVertices[3].v2TexCoord = XMFLOAT2( 0.0f, 0.0f );
+    QuadVertices[4].v3Pos = XMFLOAT3( 1.0f, 1.0f, 0.5f );
+    QuadVertices[4].v2TexCoord = XMFLOAT2( 1.0f, 0.0f );
+    QuadVertices[5].v3Pos = XMFLOAT3( 1.0f, -1.0f, 0.5f );
+    QuadVertices[5].v2TexCoord = XMFLOAT2( 1.0f, 1.0f );
+
+    // Create the vertex buffer
+    D3D11_BUFFER_DESC BD;
+    BD.Usage = D3D11_USAGE_DYNAMIC;
+    BD.ByteWidth = sizeof( ScreenQuadVertex ) * 6;
+    BD.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    BD.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    BD.MiscFlags = 0;
+    D3D11_SUBRESOURCE_DATA InitData;
+    InitData.pSysMem = QuadVertices;
+    V_RETURN( pd3dDevice->CreateBuffer( &BD, &InitData, &m_pScreenQuadVertexBuffer ) )
+
+    // Input layout and VS for Screen quads
+    ID3DBlob* pBlob = NULL;
+    V_RETURN( AMD::CompileShaderFromFile( L"..\\src\\Shaders\\SeparableFilter11.hlsl", "VSTexturedScreenQuad", "vs_5_0", &pBlob, NULL ) );
+    V_RETURN( pd3dDevice->CreateVertexShader( pBlob->GetBufferPointer(), pBlob->GetBufferSize(), NULL, &m_pVSTexturedScreenQuad ) );
+    const D3D11_INPUT_ELEMENT_DESC Layout[] =
+    {
+        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0,  0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+        { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    };
+    V_RETURN( pd3dDevice->CreateInputLayout( Layout, ARRAYSIZE( Layout ), pBlob->GetBufferPointer(), pBlob->GetBufferSize(), &m_pScreenInputLayout ) );
+    SAFE_RELEASE( pBlob );
+
+    return hr;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Device hook method
+//--------------------------------------------------------------------------------------
+void PyramidFilter::OnDestroyDevice()
+{
+    SAFE_RELEASE( m_pLinearClampSampler );
+    SAFE_RELEASE( m_pPyramidCB );
+    SAFE_RELEASE( m_pScreenQuadVertexBuffer );
+    SAFE_RELEASE( m_pVSTexturedScreenQuad );
+    SAFE_RELEASE( m_pScreenInputLayout );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Device hook method
+// Creates every level the back buffer size allows, halving it and rounding up, so the
+// deviation can change without recreating them. The levels are stored as halves, so keep
+// the range of HDR inputs.
+//--------------------------------------------------------------------------------------
+HRESULT PyramidFilter::OnResizedSwapChain( ID3D11Device* pd3dDevice, const DXGI_SURFACE_DESC* pBackBufferSurfaceDesc )
+{
+    HRESULT hr;
+
+    OnReleasingSwapChain();
+
+    m_uLevelWidth[0] = pBackBufferSurfaceDesc->Width;
+    m_uLevelHeight[0] = pBackBufferSurfaceDesc->Height;
+
+    // Stop before a level would be under 2 texels across, as CPUFilter::ComputePyramidLevels
+    while( m_iMaxLevels < m_iMAX_LEVELS && m_uLevelWidth[m_iMaxLevels] >= 4 && m_uLevelHeight[m_iMaxLevels] >= 4 )
+    {
+        const int iLevel = m_iMaxLevels + 1;
+
+        m_uLevelWidth[iLevel] = ( m_uLevelWidth[iLevel - 1] + 1 ) / 2;
+        m_uLevelHeight[iLevel] = ( m_uLevelHeight[iLevel - 1] + 1 ) / 2;
+
+        for( int iTexture = 0; iTexture < 2; ++iTexture )
+        {
+            V_RETURN( AMD::CreateSurface( &m_pLevelTexture[iTexture][iLevel], &m_pLevelSRV[iTexture][iLevel], &m_pLevelRTV[iTexture][iLevel], &m_pLevelUAV[iTexture][iLevel],
+                DXGI_FORMAT_R16G16B16A16_FLOAT, m_uLevelWidth[iLevel], m_uLevelHeight[iLevel], 1 ) );
+            DXUT_SetDebugName( m_pLevelTexture[iTexture][iLevel], "Pyramid Level" );
+            DXUT_SetDebugName( m_pLevelSRV[iTexture][iLevel], "Pyramid Level SRV" );
+            DXUT_SetDebugName( m_pLevelRTV[iTexture][iLevel], "Pyramid Level RTV" );
+            DXUT_SetDebugName( m_pLevelUAV[iTexture][iLevel], "Pyramid Level UAV" );
+        }
+
+        m_iMaxLevels = iLevel;
+    }
+
+    SetDeviation( m_fDeviation );
+
+    return S_OK;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Releases the levels created in OnResizedSwapChain
+//--------------------------------------------------------------------------------------
+void PyramidFilter::OnReleasingSwapChain()
+{
+    for( int iTexture = 0; iTexture < 2; ++iTexture )
+    {
+        for( int iLevel = 0; iLevel <= m_iMAX_LEVELS; ++iLevel )
+        {
+            SAFE_RELEASE( m_pLevelTexture[iTexture][iLevel] );
+            SAFE_RELEASE( m_pLevelSRV[iTexture][iLevel] );
+            SAFE_RELEASE( m_pLevelRTV[iTexture][iLevel] );
+            SAFE_RELEASE( m_pLevelUAV[iTexture][iLevel] );
+        }
+    }
+
+    m_iMaxLevels = 0;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Halves the input down to the coarse level, filters it, and doubles it back up to the
+// output. Each upsample overwrites the level it upsamples to, which the downsamples are
+// done with.
+//--------------------------------------------------------------------------------------
+void PyramidFilter::OnRender( SeparableFilter& Filter, SeparableFilter::SHADER_TYPE ShaderType, ID3D11ShaderResourceView* pInputSRV, ID3D11RenderTargetView* pOutputRTV )
+{
+    assert( m_iNumLevels > 0 && m_iNumLevels <= m_iMaxLevels );
+    assert( NULL != m_pDownsampleShader && NULL != m_pUpsampleShader );
+
+    ID3D11DeviceContext* pd3dContext = DXUTGetD3D11DeviceContext();
+
+    // Store the currently set render target and viewport
+    ID3D11RenderTargetView* pOrigRTV = NULL;
+    pd3dContext->OMGetRenderTargets( 1, &pOrigRTV, NULL );
+    UINT uNumViewports = 1;
+    D3D11_VIEWPORT OrigViewport;
+    pd3dContext->RSGetViewports( &uNumViewports, &OrigViewport );
+
+    TIMER_Begin( 0, L"Downsample" )
+
+    SetQuadState();
+    for( int iLevel = 1; iLevel <= m_iNumLevels; ++iLevel )
+    {
+        RenderLevel( m_pDownsampleShader, ( 1 == iLevel ) ? pInputSRV : m_pLevelSRV[0][iLevel - 1], iLevel - 1, m_pLevelRTV[0][iLevel], iLevel );
+    }
+
+    TIMER_End() // Downsample
+
+    // The SeparableFilter filters the coarse level from [0] to [1] and back, with a viewport
+    // of its size for the pixel shaders
+    const int iCoarse = m_iNumLevels;
+    ID3D11ShaderResourceView* pHorizSRVs[1] = { m_pLevelSRV[0][iCoarse] };
+    ID3D11ShaderResourceView* pVertSRVs[1] = { m_pLevelSRV[1][iCoarse] };
+    SetViewport( iCoarse );
+    Filter.SetOutputSize( m_uLevelWidth[iCoarse], m_uLevelHeight[iCoarse] );
+    Filter.SetShaderResourceViews( pHorizSRVs, pVertSRVs, 1 );
+
+    if( ShaderType == SeparableFilter::SHADER_TYPE_COMPUTE )
+    {
+        Filter.SetUnorderedAccessViews( m_pLevelUAV[1][iCoarse], m_pLevelUAV[0][iCoarse] );
+        Filter.SetComputeShaders( m_pCoarseComputeShaders[0], m_pCoarseComputeShaders[1], m_eCoarseKernelRadius );
+    }
+    else
+    {
+        Filter.SetRenderTargetViews( m_pLevelRTV[1][iCoarse], m_pLevelRTV[0][iCoarse] );
+        Filter.SetPixelShaders( m_pCoarsePixelShaders[0], m_pCoarsePixelShaders[1] );
+    }
+
+    Filter.OnRender( ShaderType );
+    Filter.SetOutputSize( m_uLevelWidth[0], m_uLevelHeight[0] );
+
+    TIMER_Begin( 0, L"Upsample" )
+
+    // The filter sets state of its own
+    SetQuadState();
+    for( int iLevel = iCoarse - 1; iLevel >= 0; --iLevel )
+    {
+        RenderLevel( m_pUpsampleShader, m_pLevelSRV[0][iLevel + 1], iLevel + 1, ( 0 == iLevel ) ? pOutputRTV : m_pLevelRTV[0][iLevel], iLevel );
+    }
+
+    TIMER_End() // Upsample
+
+    // Set back to the original RT and viewport
+    pd3dContext->RSSetViewports( 1, &OrigViewport );
+    pd3dContext->OMSetRenderTargets( 1, &pOrigRTV, NULL );
+    SAFE_RELEASE( pOrigRTV );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Renders one pass of the chain, from a level to the next one up or down
+//--------------------------------------------------------------------------------------
+void PyramidFilter::RenderLevel( ID3D11PixelShader* pShader, ID3D11ShaderResourceView* pInputSRV, int iInputLevel, ID3D11RenderTargetView* pOutputRTV, int iOutputLevel )
+{
+    ID3D11DeviceContext* pd3dContext = DXUTGetD3D11DeviceContext();
+    ID3D11RenderTargetView* pNULLRTV = NULL;
+    ID3D11ShaderResourceView* pNULLSRV = NULL;
+
+    D3D11_MAPPED_SUBRESOURCE MappedResource;
+    pd3dContext->Map( m_pPyramidCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &MappedResource );
+    PyramidConstantBuffer* pPyramidCB = ( PyramidConstantBuffer* )MappedResource.pData;
+    pPyramidCB->fInputSize[0] = (float)m_uLevelWidth[iInputLevel];
+    pPyramidCB->fInputSize[1] = (float)m_uLevelHeight[iInputLevel];
+    pPyramidCB->fInputSize[2] = 1.0f / (float)m_uLevelWidth[iInputLevel];
+    pPyramidCB->fInputSize[3] = 1.0f / (float)m_uLevelHeight[iInputLevel];
+    pd3dContext->Unmap( m_pPyramidCB, 0 );
+
+    SetViewport( iOutputLevel );
+    pd3dContext->OMSetRenderTargets( 1, &pOutputRTV, NULL );
+    pd3dContext->PSSetShaderResources( 0, 1, &pInputSRV );
+    pd3dContext->PSSetShader( pShader, NULL, 0 );
+    pd3dContext->Draw( 6, 0 );
+    pd3dContext->OMSetRenderTargets( 1, &pNULLRTV, NULL );
+    pd3dContext->PSSetShaderResources( 0, 1, &pNULLSRV );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Covers the whole of a level
+//--------------------------------------------------------------------------------------
+void PyramidFilter::SetViewport( int iLevel )
+{
+    D3D11_VIEWPORT Viewport;
+    Viewport.TopLeftX = 0.0f;
+    Viewport.TopLeftY = 0.0f;
+    Viewport.Width = (float)m_uLevelWidth[iLevel];
+    Viewport.Height = (float)m_uLevelHeight[iLevel];
+    Viewport.MinDepth = 0.0f;
+    Viewport.MaxDepth = 1.0f;
+
+    DXUTGetD3D11DeviceContext()->RSSetViewports( 1, &Viewport );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Input layout, VS, sampler and constant buffer for the screen quads of the chain
+//--------------------------------------------------------------------------------------
+void PyramidFilter::SetQuadState()
+{
+    ID3D11DeviceContext* pd3dContext = DXUTGetD3D11DeviceContext();
+
+    UINT Stride = sizeof( ScreenQuadVertex );
+    UINT Offset = 0;
+    pd3dContext->IASetInputLayout( m_pScreenInputLayout );
+    pd3dContext->IASetVertexBuffers( 0, 1, &m_pScreenQuadVertexBuffer, &Stride, &Offset );
+    pd3dContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+    pd3dContext->VSSetShader( m_pVSTexturedScreenQuad, NULL, 0 );
+    pd3dContext->PSSetSamplers( 0, 1, &m_pLinearClampSampler );
+    pd3dContext->PSSetConstantBuffers( 4, 1, &m_pPyramidCB );
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: PyramidFilter.h
+//
+// PyramidFilter Class definition.
+// Blurs by Gaussians wider than the kernel radius permutations allow, by halving the image
+// a number of times, running a SeparableFilter with a small kernel at the coarse level, and
+// upsampling back to full resolution a level at a time.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+
+class PyramidFilter
+{
+public:
+
+    // Needs to match MAX_PYRAMID_LEVELS in CPU\GaussianPyramid.h
+    static const int m_iMAX_LEVELS = 8;
+
+    // Constructor / destructor
+    PyramidFilter();
+    ~PyramidFilter();
+
+    // Deviation of the Gaussian at full resolution, which picks the number of levels, and the
+    // deviation left for the coarse level. The coarse deviation is at most half of it, so
+    // there is always at least one level.
+    void SetDeviation( float fDeviation );
+    int GetNumLevels() const { return m_iNumLevels; }
+    float GetCoarseDeviation() const { return m_fCoarseDeviation; }
+
+    // The PSPyramidDownsample and PSPyramidUpsample shaders of PyramidFilter.hlsl
+    void SetPixelShaders( ID3D11PixelShader* pDownsampleShader, ID3D11PixelShader* pUpsampleShader );
+
+    // The Gaussian filter shaders run at the coarse level, with a radius that covers the
+    // coarse deviation
+    void SetCoarsePixelShaders( ID3D11PixelShader* pHorizShader, ID3D11PixelShader* pVertShader );
+    void SetCoarseComputeShaders( ID3D11ComputeShader* pHorizShader, ID3D11ComputeShader* pVertShader, SeparableFilter::KERNEL_RADIUS_TYPE KernelRadius );
+
+    // Device hook methods
+    HRESULT OnCreateDevice( ID3D11Device* pd3dDevice );
+    void OnDestroyDevice();
+    HRESULT OnResizedSwapChain( ID3D11Device* pd3dDevice, const DXGI_SURFACE_DESC* pBackBufferSurfaceDesc );
+    void OnReleasingSwapChain();
+
+    // Blurs the input into the output, both of the back buffer size. They may be views of
+    // the same texture, as the input is only read by the first downsample. The coarse level
+    // is filtered by the given SeparableFilter, whose output size is set back to the back
+    // buffer size afterwards.
+    void OnRender( SeparableFilter& Filter, SeparableFilter::SHADER_TYPE ShaderType, ID3D11ShaderResourceView* pInputSRV, ID3D11RenderTargetView* pOutputRTV );
+
+private:
+
+    void RenderLevel( ID3D11PixelShader* pShader, ID3D11ShaderResourceView* pInputSRV, int iInputLevel, ID3D11RenderTargetView* pOutputRTV, int iOutputLevel );
+    void SetViewport( int iLevel );
+    void SetQuadState();
+
+    class ScreenQuadVertex
+    {
+    public:
+        DirectX::XMFLOAT3 v3Pos;
+        DirectX::XMFLOAT2 v2TexCoord;
+    };
+
+    class PyramidConstantBuffer
+    {
+    public:
+        float fInputSize[4]; // ( [0] = Width, [1] = Height, [2] = Inv Width, [3] = Inv Height )
+    };
+
+    // Two textures per level, as the coarse level is filtered from [0] to [1] and back.
+    // Level 0 is the input and output, so has none.
+    ID3D11Texture2D*            m_pLevelTexture[2][m_iMAX_LEVELS + 1];
+    ID3D11ShaderResourceView*   m_pLevelSRV[2][m_iMAX_LEVELS + 1];
+    ID3D11RenderTargetView*     m_pLevelRTV[2][m_iMAX_LEVELS + 1];
+    ID3D11UnorderedAccessView*  m_pLevelUAV[2][m_iMAX_LEVELS + 1];
+    unsigned int                m_uLevelWidth[m_iMAX_LEVELS + 1];
+    unsigned int                m_uLevelHeight[m_iMAX_LEVELS + 1];
+    int                         m_iMaxLevels;       // Allowed by the size of the back buffer
+    float                       m_fDeviation;
+    int                         m_iNumLevels;
+    float                       m_fCoarseDeviation;
+    ID3D11PixelShader*          m_pDownsampleShader;
+    ID3D11PixelShader*          m_pUpsampleShader;
+    ID3D11PixelShader*          m_pCoarsePixelShaders[2];
+    ID3D11ComputeShader*        m_pCoarseComputeShaders[2];
+    SeparableFilter::KERNEL_RADIUS_TYPE m_eCoarseKernelRadius;
+    ID3D11Buffer*               m_pScreenQuadVertexBuffer;
+    ID3D11InputLayout*          m_pScreenInputLayout;
+    ID3D11VertexShader*         m_pVSTexturedScreenQuad;
+    ID3D11SamplerState*         m_pLinearClampSampler;
+    ID3D11Buffer*               m_pPyramidCB;
+};
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -31,6 +31,7 @@
 #include "..\\..\\DXUT\\Core\\DXUT.h"
 #include "..\\..\\AMD_SDK\\inc\\AMD_SDK.h"
 #include "SeparableFilter.h"
+#include "CPU\\FilterCommon.h"
 
 
 using namespace DirectX;
@@ -50,6 +51,7 @@ SeparableFilter::SeparableFilter()
     m_pUAVNULL = NULL;
     m_pPixelShaders[0] = NULL; m_pPixelShaders[1] = NULL;
     m_pComputeShaders[0] = NULL; m_pComputeShaders[1] = NULL;
+    m_iComputeKernelRadius = 0;
     m_pScreenQuadVertexBuffer = NULL;
     m_pScreenInputLayout = NULL;
     m_pVSTexturedScreenQuad = NULL;
@@ -93,13 +95,18 @@ void SeparableFilter::SetOutputSize( unsigned int uWidth, unsigned int uHeight )
     m_CommonCB.fOutputSize[2] = 1.0f / uWidth;
     m_CommonCB.fOutputSize[3] = 1.0f / uHeight;
 
+    UpdateCommonCB();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Copies m_CommonCB to the constant buffer
+//--------------------------------------------------------------------------------------
+void SeparableFilter::UpdateCommonCB()
+{
     D3D11_MAPPED_SUBRESOURCE MappedResource;
     DXUTGetD3D11DeviceContext()->Map( m_pCommonCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &MappedResource );
-    CommonConstantBuffer* pCommonCB = ( CommonConstantBuffer* )MappedResource.pData;
-    pCommonCB->fOutputSize[0] = (float)uWidth; 
-    pCommonCB->fOutputSize[1] = (float)uHeight;
-    pCommonCB->fOutputSize[2] = 1.0f / (float)uWidth;
-    pCommonCB->fOutputSize[3] = 1.0f / (float)uHeight;
+    memcpy( MappedResource.pData, &m_CommonCB, sizeof( CommonConstantBuffer ) );
     DXUTGetD3D11DeviceContext()->Unmap( m_pCommonCB, 0 );
 }
 
@@ -180,13 +187,15 @@ void SeparableFilter::SetPixelShaders( ID3D11PixelShader* pHorizShader, ID3D11Pi
 //--------------------------------------------------------------------------------------
 // Likely set the shaders once after creation, though could be every frame
 //--------------------------------------------------------------------------------------
-void SeparableFilter::SetComputeShaders( ID3D11ComputeShader* pHorizShader, ID3D11ComputeShader* pVertShader )
+void SeparableFilter::SetComputeShaders( ID3D11ComputeShader* pHorizShader, ID3D11ComputeShader* pVertShader, KERNEL_RADIUS_TYPE KernelRadius )
 {
     assert( NULL != pHorizShader );
     assert( NULL != pVertShader );
+    assert( KernelRadius < KERNEL_RADIUS_TYPE_MAX );
 
     m_pComputeShaders[0] = pHorizShader;
     m_pComputeShaders[1] = pVertShader;
+    m_iComputeKernelRadius = GetKernelRadius( KernelRadius );
 }
 
 
@@ -378,6 +387,84 @@ void SeparableFilter::OnRender( SHADER_TYPE ShaderType )
 }
 
 
+//--------------------------------------------------------------------------------------
+// Re-filters the parts of the outputs affected by the dirty rectangles. The horizontal
+// pass recomputes the intermediate within the kernel radius of them across, and the
+// vertical pass the output within the kernel radius of that down. The radius is that of
+// the bound compute shaders, whatever the filter's weights reach. Groups running past a
+// rectangle recompute pixels that have not changed, so rectangles need no alignment.
+//--------------------------------------------------------------------------------------
+void SeparableFilter::OnRenderDirty( SHADER_TYPE ShaderType, const D3D11_RECT* pDirtyRects, int iNumRects )
+{
+    assert( NULL != pDirtyRects || 0 == iNumRects );
+
+    if( ShaderType != SHADER_TYPE_COMPUTE )
+    {
+        OnRender( ShaderType );
+        return;
+    }
+
+    const int iWidth = (int)m_CommonCB.fOutputSize[0];
+    const int iHeight = (int)m_CommonCB.fOutputSize[1];
+
+    DXUTGetD3D11DeviceContext()->CSSetSamplers( 0, 1, &m_pPointSampler );
+    DXUTGetD3D11DeviceContext()->CSSetSamplers( 1, 1, &m_pLinearClampSampler );
+    DXUTGetD3D11DeviceContext()->CSSetConstantBuffers( 0, 1, &m_pCommonCB );
+
+    for( int iPass = 0; iPass < 2; iPass++ )
+    {
+        TIMER_Begin( 0, ( 0 == iPass ) ? L"Horizontal Pass" : L"Vertical Pass" )
+
+        DXUTGetD3D11DeviceContext()->CSSetUnorderedAccessViews( 0, 1, &m_pUAVOutput[iPass], NULL );
+        DXUTGetD3D11DeviceContext()->CSSetShaderResources( 0, m_iNumInputViews, ( 0 == iPass ) ? m_ppHorizInputViews : m_ppVertInputViews );
+        DXUTGetD3D11DeviceContext()->CSSetShader( m_pComputeShaders[iPass], NULL, 0 );
+
+        for( int iRect = 0; iRect < iNumRects; iRect++ )
+        {
+            // Shared with the CPU library, whose tests run the HLSL mirrors over the same groups
+            const CPUFilter::Rect Dirty = CPUFilter::MakeRect( (int)pDirtyRects[iRect].left, (int)pDirtyRects[iRect].top, (int)pDirtyRects[iRect].right, (int)pDirtyRects[iRect].bottom );
+            CPUFilter::Rect Grown;
+            if( !CPUFilter::GrowDirtyRect( Dirty, iPass, m_iComputeKernelRadius, iWidth, iHeight, Grown ) )
+            {
+                continue;
+            }
+
+            m_CommonCB.iDispatchOrigin[0] = Grown.left;
+            m_CommonCB.iDispatchOrigin[1] = Grown.top;
+            UpdateCommonCB();
+
+            // Groups of the horizontal pass run across lines, and of the vertical pass down them
+            const UINT uRunSizeX = ( 0 == iPass ) ? m_uRUN_SIZE : m_uRUN_LINES;
+            const UINT uRunSizeY = ( 0 == iPass ) ? m_uRUN_LINES : m_uRUN_SIZE;
+            DXUTGetD3D11DeviceContext()->Dispatch( ( (UINT)( Grown.right - Grown.left ) + uRunSizeX - 1 ) / uRunSizeX, ( (UINT)( Grown.bottom - Grown.top ) + uRunSizeY - 1 ) / uRunSizeY, 1 );
+        }
+
+        DXUTGetD3D11DeviceContext()->CSSetUnorderedAccessViews( 0, 1, &m_pUAVNULL, NULL );
+        DXUTGetD3D11DeviceContext()->CSSetShaderResources( 0, m_iNumInputViews, m_ppNULLInputViews );
+
+        TIMER_End()
+    }
+
+    // Back to the whole output for OnRender
+    m_CommonCB.iDispatchOrigin[0] = 0;
+    m_CommonCB.iDispatchOrigin[1] = 0;
+    UpdateCommonCB();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Rounds a kernel radius up to one of the shader permutations
+//--------------------------------------------------------------------------------------
+SeparableFilter::KERNEL_RADIUS_TYPE SeparableFilter::GetKernelRadiusType( int iKernelRadius )
+{
+    int iKernelRadiusType = ( iKernelRadius + 1 ) / 2 - 1;
+
+    iKernelRadiusType = ( iKernelRadiusType < KERNEL_RADIUS_TYPE_2 ) ? KERNEL_RADIUS_TYPE_2 : iKernelRadiusType;
+    iKernelRadiusType = ( iKernelRadiusType > KERNEL_RADIUS_TYPE_32 ) ? KERNEL_RADIUS_TYPE_32 : iKernelRadiusType;
+
+    return (KERNEL_RADIUS_TYPE)iKernelRadiusType;
+}
+
 //--------------------------------------------------------------------------------------
 // EOF
 //--------------------------------------------------------------------------------------
\ No newline at end of file
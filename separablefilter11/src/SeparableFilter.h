@@ -82,6 +82,11 @@ public:
         KERNEL_RADIUS_TYPE_MAX
     }KERNEL_RADIUS_TYPE;
 
+    // Smallest kernel radius permutation that covers iKernelRadius taps either side of the
+    // center, or the largest permutation if none does
+    static KERNEL_RADIUS_TYPE GetKernelRadiusType( int iKernelRadius );
+    static int GetKernelRadius( KERNEL_RADIUS_TYPE KernelRadius ) { return ( KernelRadius + 1 ) * 2; }
+
     // Constructor / destructor
     SeparableFilter();
     ~SeparableFilter();
@@ -98,9 +103,10 @@ public:
     // For the Compute Shader versions
     void SetUnorderedAccessViews( ID3D11UnorderedAccessView* pHorizOutput, ID3D11UnorderedAccessView* pVertOutput ); 
     
-    // Likely set the shaders once after creation, though could be every frame
+    // Likely set the shaders once after creation, though could be every frame. The compute
+    // shaders come with the KERNEL_RADIUS permutation they were compiled with.
     void SetPixelShaders( ID3D11PixelShader* pHorizShader, ID3D11PixelShader* pVertShader ); 
-    void SetComputeShaders( ID3D11ComputeShader* pHorizShader, ID3D11ComputeShader* pVertShader ); 
+    void SetComputeShaders( ID3D11ComputeShader* pHorizShader, ID3D11ComputeShader* pVertShader, KERNEL_RADIUS_TYPE KernelRadius ); 
     
     // Device hook methods
     HRESULT OnCreateDevice( ID3D11Device* pd3dDevice );
@@ -108,8 +114,16 @@ public:
     void OnResizedSwapChain( const DXGI_SURFACE_DESC* pBackBufferSurfaceDesc );
     void OnRender( SHADER_TYPE ShaderType );
 
+    // Re-filters only the part of the outputs affected by changes to the inputs inside the
+    // dirty rectangles, leaving the rest as the last render wrote it. The compute shaders are
+    // dispatched over each rectangle grown by the radius of their permutation, with its
+    // origin in the constant buffer. The pixel shaders filter everything, as OnRender.
+    void OnRenderDirty( SHADER_TYPE ShaderType, const D3D11_RECT* pDirtyRects, int iNumRects );
+
 private:
 
+    void UpdateCommonCB();
+
     static const unsigned int   m_uRUN_SIZE  = 128;  // Needs to match RUN_LINES in FilterCommon.hlsl  
     static const unsigned int   m_uRUN_LINES = 2;    // Needs to match RUN_SIZE in FilterCommon.hlsl  
 
@@ -124,6 +138,7 @@ private:
     {
     public:
         float fOutputSize[4]; // ( [0] = Width, [1] = Height, [2] = Inv Width, [3] = Inv Height )
+        int iDispatchOrigin[4]; // ( [0] = X, [1] = Y of the first pixel of group ( 0, 0 ), [2], [3] unused )
     };
 
     ID3D11ShaderResourceView**  m_ppHorizInputViews;
@@ -137,6 +152,7 @@ private:
     SHADER_TYPE                 m_ShaderType;
     ID3D11PixelShader*          m_pPixelShaders[2];
     ID3D11ComputeShader*        m_pComputeShaders[2];
+    int                         m_iComputeKernelRadius;
     ID3D11Buffer*	            m_pScreenQuadVertexBuffer;
     ID3D11InputLayout*          m_pScreenInputLayout;
     ID3D11VertexShader*         m_pVSTexturedScreenQuad;
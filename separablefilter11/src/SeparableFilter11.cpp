@@ -42,6 +42,11 @@
 // Project includes
 #include "resource.h"
 #include "SeparableFilter.h"
+#include "PyramidFilter.h"
+#include "DualFilter.h"
+#include "CPU\\GaussianFilter.h"
+#include "CPU\\JointBilateralFilter.h"
+#include "CPU\\DualFilter.h"
 
 #pragma warning( disable : 4100 ) // disable unreference formal parameter warnings for /W4 builds
 
@@ -75,6 +80,8 @@ typedef enum _FILTER_TYPE
 {
     FILTER_TYPE_GAUSSIAN,
     FILTER_TYPE_BILATERAL,
+    FILTER_TYPE_BILATERAL_GATHER,
+    FILTER_TYPE_JOINT_BILATERAL,
     FILTER_TYPE_MAX
 }FILTER_TYPE;
 
@@ -91,9 +98,21 @@ enum
     IDC_CHECKBOX_APPROXIMATE_FILTER,
     IDC_STATIC_FILTER_RADIUS,
     IDC_SLIDER_FILTER_RADIUS,
+    IDC_STATIC_GAUSSIAN_DEVIATION,
+    IDC_SLIDER_GAUSSIAN_DEVIATION,
     IDC_RADIO_FILTER_NONE,
     IDC_RADIO_FILTER_GAUSSIAN,
     IDC_RADIO_FILTER_BILATERAL,
+    IDC_RADIO_FILTER_BILATERAL_GATHER,
+    IDC_RADIO_FILTER_JOINT_BILATERAL,
+    IDC_CHECKBOX_PYRAMID,
+    IDC_STATIC_PYRAMID_DEVIATION,
+    IDC_SLIDER_PYRAMID_DEVIATION,
+    IDC_CHECKBOX_DUAL_FILTER,
+    IDC_STATIC_DUAL_FILTER_DEVIATION,
+    IDC_SLIDER_DUAL_FILTER_DEVIATION,
+    IDC_CHECKBOX_BENCHMARK,
+    IDC_CHECKBOX_DIRTY_RECT,
     IDC_NUM_CONTROL_IDS
 };
 
@@ -148,6 +167,12 @@ ID3D11PixelShader*          g_pPSVerticalFilter[FILTER_TYPE_MAX][SeparableFilter
 // CS
 ID3D11ComputeShader*        g_pCSHorizontalFilter[FILTER_TYPE_MAX][SeparableFilter::FILTER_PRECISION_TYPE_MAX][SeparableFilter::KERNEL_RADIUS_TYPE_MAX][SeparableFilter::LDS_PRECISION_TYPE_MAX];
 ID3D11ComputeShader*        g_pCSVerticalFilter[FILTER_TYPE_MAX][SeparableFilter::FILTER_PRECISION_TYPE_MAX][SeparableFilter::KERNEL_RADIUS_TYPE_MAX][SeparableFilter::LDS_PRECISION_TYPE_MAX];
+// Pyramid
+ID3D11PixelShader*          g_pPSPyramidDownsample = NULL;
+ID3D11PixelShader*          g_pPSPyramidUpsample = NULL;
+// Dual filter
+ID3D11PixelShader*          g_pPSDualDownsample = NULL;
+ID3D11PixelShader*          g_pPSDualUpsample = NULL;
 
 // Vertex structure, buffer and input layout for rendering full screen quads 
 struct QuadVertex
@@ -165,6 +190,32 @@ FILTER_TYPE                             g_eFilterType           = FILTER_TYPE_GA
 SeparableFilter::FILTER_PRECISION_TYPE  g_eFilterPrecisionType  = SeparableFilter::FILTER_PRECISION_TYPE_FULL;
 SeparableFilter::KERNEL_RADIUS_TYPE     g_eKernelRadius         = SeparableFilter::KERNEL_RADIUS_TYPE_16;
 
+// The Gaussian filter can be given a deviation instead of a radius, in which case the radius
+// is the smallest permutation that leaves out less than the tolerance of the kernel's weight
+float                                   g_fGaussianDeviation    = 0.0f;     // 0 = Half the filter radius
+const float                             g_fGaussianTolerance    = 0.001f;
+
+// Gaussians wider than the radius permutations allow go through the pyramid, which blurs
+// at a coarse level by the deviation it leaves
+bool                                    g_bUsePyramid           = false;
+float                                   g_fPyramidDeviation     = 32.0f;
+
+// The joint bilateral filter is guided by view space depth, and mixes samples within about
+// this deviation in world units
+const float                             g_fJointBilateralDepthDeviation = 0.5f;
+
+// Bloom can replace the Gaussian by the dual filter chain, and benchmark it against the
+// Gaussian of the chain's deviation, whose memory traffic is estimated alongside
+bool                                    g_bUseDualFilter        = false;
+float                                   g_fDualFilterDeviation  = 32.0f;
+bool                                    g_bBenchmarkDualFilter  = false;
+CPUFilter::FilterTraffic                g_DualFilterTraffic;
+CPUFilter::FilterTraffic                g_BenchmarkTraffic;
+
+// The compute shaders can re-filter just a dirty rectangle in the middle of the screen,
+// leaving the rest of the scene unfiltered
+bool                                    g_bFilterDirtyRect      = false;
+
 //--------------------------------------------------------------------------------------
 // Set up AMD shader cache here
 //--------------------------------------------------------------------------------------
@@ -176,6 +227,8 @@ AMD::ShaderCache            g_ShaderCache(AMD::ShaderCache::SHADER_AUTO_RECOMPIL
 static AMD::MagnifyTool     g_MagnifyTool;
 static AMD::HUD             g_HUD;
 static SeparableFilter      g_SeparableFilter;
+static PyramidFilter        g_PyramidFilter;
+static DualFilter           g_DualFilter;
 
 // Global boolean for HUD rendering
 bool                        g_bRenderHUD = true;
@@ -201,6 +254,22 @@ struct CB_BILATERAL_FILTER
 };
 static ID3D11Buffer*    g_pCBBilateralFilter = NULL;
 
+// Constants specific to joint bilateral filters
+struct CB_JOINT_BILATERAL_FILTER
+{
+    float   fGuideScale[4];                                 // One over the range deviation of each guide channel
+    float   fRangeWeights[CPUFilter::RANGE_TABLE_SIZE];     // Matches g_f4RangeWeights
+};
+static ID3D11Buffer*    g_pCBJointBilateralFilter = NULL;
+
+// Constants specific to Gaussian filters
+struct CB_GAUSSIAN_FILTER
+{
+    float   fWeights[68];   // One per iteration, matches g_f4GaussianWeights
+    float   fOffsets[68];   // Bilinear offsets of the approximate filter, matches g_f4GaussianOffsets
+};
+static ID3D11Buffer*    g_pCBGaussianFilter = NULL;
+
 
 //--------------------------------------------------------------------------------------
 // Forward declarations 
@@ -225,6 +294,9 @@ void CALLBACK OnD3D11FrameRender( ID3D11Device* pd3dDevice, ID3D11DeviceContext*
 
 void InitApp();
 void RenderText();
+void FillGaussianWeights( CB_GAUSSIAN_FILTER* pCBGaussianFilter, int iKernelRadius, int iStepSize, float fDeviation );
+void RenderScene( ID3D11DeviceContext* pd3dImmediateContext );
+void RenderGaussianFilter( bool bUsePyramid, SeparableFilter::KERNEL_RADIUS_TYPE eKernelRadius );
 
 HRESULT AddShadersToCache();
 
@@ -303,17 +375,29 @@ void InitApp()
     
     g_HUD.m_GUI.AddCheckBox( IDC_CHECKBOX_COMPUTE_SHADER, L"Use Compute Shader", AMD::HUD::iElementOffset, iY, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight, true );
     g_HUD.m_GUI.AddCheckBox( IDC_CHECKBOX_APPROXIMATE_FILTER, L"Approximate Filter", AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight, ( g_eFilterPrecisionType == SeparableFilter::FILTER_PRECISION_TYPE_APPROXIMATE ) );
+    g_HUD.m_GUI.AddCheckBox( IDC_CHECKBOX_DIRTY_RECT, L"Filter Dirty Rectangle", AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight, g_bFilterDirtyRect );
 
     iY += AMD::HUD::iGroupDelta;
 
     g_HUD.m_GUI.AddRadioButton( IDC_RADIO_FILTER_NONE, 1, L"No Filter", AMD::HUD::iElementOffset, iY, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight, false, L'1' );
     g_HUD.m_GUI.AddRadioButton( IDC_RADIO_FILTER_GAUSSIAN, 1, L"Gaussian Filter", AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight, ( g_eFilterType == FILTER_TYPE_GAUSSIAN ), L'2' );
     g_HUD.m_GUI.AddRadioButton( IDC_RADIO_FILTER_BILATERAL, 1, L"Bilateral Filter", AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight, ( g_eFilterType == FILTER_TYPE_BILATERAL ), L'3' );
+    g_HUD.m_GUI.AddRadioButton( IDC_RADIO_FILTER_BILATERAL_GATHER, 1, L"Variable Radius DoF", AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight, ( g_eFilterType == FILTER_TYPE_BILATERAL_GATHER ), L'4' );
+    g_HUD.m_GUI.AddRadioButton( IDC_RADIO_FILTER_JOINT_BILATERAL, 1, L"Joint Bilateral Filter", AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight, ( g_eFilterType == FILTER_TYPE_JOINT_BILATERAL ), L'5' );
     
     iY += AMD::HUD::iGroupDelta;
 
     g_HUD.m_GUI.AddStatic( IDC_STATIC_FILTER_RADIUS, L"Filter Radius : 16", AMD::HUD::iElementOffset, iY, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight );
     g_HUD.m_GUI.AddSlider( IDC_SLIDER_FILTER_RADIUS, AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight, SeparableFilter::KERNEL_RADIUS_TYPE_2, SeparableFilter::KERNEL_RADIUS_TYPE_32, g_eKernelRadius, false );
+    g_HUD.m_GUI.AddStatic( IDC_STATIC_GAUSSIAN_DEVIATION, L"Gaussian Deviation : Radius / 2", AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight );
+    g_HUD.m_GUI.AddSlider( IDC_SLIDER_GAUSSIAN_DEVIATION, AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight, 0, 32, (int)( g_fGaussianDeviation * 2.0f ), false );
+    g_HUD.m_GUI.AddCheckBox( IDC_CHECKBOX_PYRAMID, L"Gaussian Pyramid", AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight, g_bUsePyramid );
+    g_HUD.m_GUI.AddStatic( IDC_STATIC_PYRAMID_DEVIATION, L"Pyramid Deviation : 32", AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight );
+    g_HUD.m_GUI.AddSlider( IDC_SLIDER_PYRAMID_DEVIATION, AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight, 8, 128, (int)g_fPyramidDeviation, false );
+    g_HUD.m_GUI.AddCheckBox( IDC_CHECKBOX_DUAL_FILTER, L"Dual Filter (Bloom)", AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight, g_bUseDualFilter );
+    g_HUD.m_GUI.AddStatic( IDC_STATIC_DUAL_FILTER_DEVIATION, L"Dual Filter Deviation : 32", AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight );
+    g_HUD.m_GUI.AddSlider( IDC_SLIDER_DUAL_FILTER_DEVIATION, AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight, 2, 128, (int)g_fDualFilterDeviation, false );
+    g_HUD.m_GUI.AddCheckBox( IDC_CHECKBOX_BENCHMARK, L"Benchmark Against Gaussian", AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight, g_bBenchmarkDualFilter );
     
     iY += AMD::HUD::iGroupDelta;
     
@@ -374,6 +458,29 @@ void RenderText()
 	swprintf_s( wcbuf, 256, L"Filter cost in milliseconds( Total = %.3f, Horizontal Pass = %.3f, Vertical Pass = %.3f )", fFilterTime, fHorizontalPassTime, fVerticalPassTime );
 	g_pTxtHelper->DrawTextLine( wcbuf );
 
+    if( FILTER_TYPE_GAUSSIAN == g_eFilterType && g_bUseDualFilter && !g_HUD.m_GUI.GetRadioButton( IDC_RADIO_FILTER_NONE )->GetChecked() )
+    {
+        swprintf_s( wcbuf, 256, L"Dual filter( Levels = %d, Deviation = %.2f, Passes = %d, MB Moved = %.1f, Million Taps = %.1f )", g_DualFilter.GetNumLevels(),
+            g_DualFilter.GetChainDeviation(), g_DualFilterTraffic.iNumPasses, g_DualFilterTraffic.BytesMoved() / 1.0e6, g_DualFilterTraffic.dTaps / 1.0e6 );
+        g_pTxtHelper->DrawTextLine( wcbuf );
+
+        if( g_bBenchmarkDualFilter )
+        {
+            float fBenchmarkTime = (float)TIMER_GetTime( Gpu, L"Benchmark" ) * 1000.0f;
+            swprintf_s( wcbuf, 256, L"Gaussian of equal deviation( Milliseconds = %.3f, Passes = %d, MB Moved = %.1f, Million Taps = %.1f )", fBenchmarkTime,
+                g_BenchmarkTraffic.iNumPasses, g_BenchmarkTraffic.BytesMoved() / 1.0e6, g_BenchmarkTraffic.dTaps / 1.0e6 );
+            g_pTxtHelper->DrawTextLine( wcbuf );
+        }
+    }
+
+    // The demo breaks the contract of OnRenderDirty, that nothing changed outside the rectangle,
+    // so say what is left stale rather than leave it looking like a bug
+    if( g_bFilterDirtyRect && g_HUD.m_GUI.GetCheckBox( IDC_CHECKBOX_COMPUTE_SHADER )->GetChecked() && !g_HUD.m_GUI.GetRadioButton( IDC_RADIO_FILTER_NONE )->GetChecked() )
+    {
+        g_pTxtHelper->DrawTextLine( L"Dirty rectangle: only the middle of the screen is filtered. The scene is rendered anew each frame, so outside it is" );
+        g_pTxtHelper->DrawTextLine( L"unfiltered, and within the filter radius above and below it the last frame's horizontal pass is blended in." );
+    }
+
     g_pTxtHelper->SetInsertionPos( 5, DXUTGetDXGIBackBufferSurfaceDesc()->Height - AMD::HUD::iElementDelta );
 	g_pTxtHelper->DrawTextLine( L"Toggle GUI    : F1" );
 
@@ -381,6 +488,93 @@ void RenderText()
 }
 
 
+//--------------------------------------------------------------------------------------
+// Fills out the weights and offsets read by GaussianFilter.hlsl, the same taps as the CPU
+// GaussianFilter class. A deviation of 0 is half the kernel radius.
+//--------------------------------------------------------------------------------------
+void FillGaussianWeights( CB_GAUSSIAN_FILTER* pCBGaussianFilter, int iKernelRadius, int iStepSize, float fDeviation )
+{
+    fDeviation = ( fDeviation > 0.0f ) ? fDeviation : (float)iKernelRadius * 0.5f;
+
+    memset( pCBGaussianFilter, 0, sizeof( CB_GAUSSIAN_FILTER ) );
+
+    CPUFilter::ComputeGaussianTaps( iKernelRadius, iStepSize, fDeviation, pCBGaussianFilter->fWeights, pCBGaussianFilter->fOffsets );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Renders the scene meshes into the scene texture of the current format
+//--------------------------------------------------------------------------------------
+void RenderScene( ID3D11DeviceContext* pd3dImmediateContext )
+{
+    ID3D11RenderTargetView* pNULLRTV = NULL;
+
+    pd3dImmediateContext->PSSetSamplers( 0, 1, &g_pLinearSampler );
+    pd3dImmediateContext->OMSetRenderTargets( 1, &g_pSceneTextureRTV[0][g_eSurfacePrecisionType], g_pDepthStencilView );
+    pd3dImmediateContext->IASetInputLayout( g_pSceneVertexLayout );
+    pd3dImmediateContext->VSSetShader( g_pSceneVS, NULL, 0 );
+    pd3dImmediateContext->PSSetShader( g_pScenePS, NULL, 0 );
+    g_SceneMesh.Render( pd3dImmediateContext, 1, 2 );
+    pd3dImmediateContext->PSSetShader( g_pSkyPS, NULL, 0 );
+    g_SkyMesh.Render( pd3dImmediateContext, 1, 2 );
+    pd3dImmediateContext->OMSetRenderTargets( 1, &pNULLRTV, NULL );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Filters the scene texture in place with the selected filter, through the pyramid for
+// Gaussians too wide for the radius permutations
+//--------------------------------------------------------------------------------------
+void RenderGaussianFilter( bool bUsePyramid, SeparableFilter::KERNEL_RADIUS_TYPE eKernelRadius )
+{
+    if( bUsePyramid )
+    {
+        // From the scene texture back into it, through the levels of the pyramid
+        g_PyramidFilter.SetPixelShaders( g_pPSPyramidDownsample, g_pPSPyramidUpsample );
+        g_PyramidFilter.SetCoarsePixelShaders( g_pPSHorizontalFilter[g_eFilterType][g_eFilterPrecisionType][eKernelRadius],
+            g_pPSVerticalFilter[g_eFilterType][g_eFilterPrecisionType][eKernelRadius] );
+        g_PyramidFilter.SetCoarseComputeShaders( g_pCSHorizontalFilter[g_eFilterType][g_eFilterPrecisionType][eKernelRadius][g_eLDSPrecisionType],
+            g_pCSVerticalFilter[g_eFilterType][g_eFilterPrecisionType][eKernelRadius][g_eLDSPrecisionType], eKernelRadius );
+        g_PyramidFilter.OnRender( g_SeparableFilter, g_HUD.m_GUI.GetCheckBox( IDC_CHECKBOX_COMPUTE_SHADER )->GetChecked() ? SeparableFilter::SHADER_TYPE_COMPUTE : SeparableFilter::SHADER_TYPE_PIXEL,
+            g_pSceneTextureSRV[0][g_eSurfacePrecisionType], g_pSceneTextureRTV[0][g_eSurfacePrecisionType] );
+        return;
+    }
+
+    ID3D11ShaderResourceView* pHorizSRVs[2] = { g_pSceneTextureSRV[0][g_eSurfacePrecisionType], g_pDepthStencilSRV };
+    ID3D11ShaderResourceView* pVertSRVs[2] = { g_pSceneTextureSRV[1][g_eSurfacePrecisionType], g_pDepthStencilSRV };
+    g_SeparableFilter.SetShaderResourceViews( pHorizSRVs, pVertSRVs, 2 );
+    
+    if( g_HUD.m_GUI.GetCheckBox( IDC_CHECKBOX_COMPUTE_SHADER )->GetChecked() )
+    {
+        g_SeparableFilter.SetUnorderedAccessViews( g_pSceneTextureUAV[1][g_eSurfacePrecisionType], g_pSceneTextureUAV[0][g_eSurfacePrecisionType] );
+        g_SeparableFilter.SetComputeShaders( g_pCSHorizontalFilter[g_eFilterType][g_eFilterPrecisionType][eKernelRadius][g_eLDSPrecisionType], 
+            g_pCSVerticalFilter[g_eFilterType][g_eFilterPrecisionType][eKernelRadius][g_eLDSPrecisionType], eKernelRadius );
+
+        if( g_bFilterDirtyRect )
+        {
+            // The scene is rendered anew every frame, so outside the middle half of the screen
+            // it stays unfiltered, and the vertical pass blends in the intermediate as the last
+            // frame left it within the kernel radius above and below. RenderText says so.
+            const LONG lWidth = (LONG)DXUTGetDXGIBackBufferSurfaceDesc()->Width;
+            const LONG lHeight = (LONG)DXUTGetDXGIBackBufferSurfaceDesc()->Height;
+            const D3D11_RECT DirtyRect = { lWidth / 4, lHeight / 4, lWidth - lWidth / 4, lHeight - lHeight / 4 };
+            g_SeparableFilter.OnRenderDirty( SeparableFilter::SHADER_TYPE_COMPUTE, &DirtyRect, 1 );
+        }
+        else
+        {
+            g_SeparableFilter.OnRender( SeparableFilter::SHADER_TYPE_COMPUTE );
+        }
+    }
+    else
+    {
+        g_SeparableFilter.SetRenderTargetViews( g_pSceneTextureRTV[1][g_eSurfacePrecisionType], g_pSceneTextureRTV[0][g_eSurfacePrecisionType] );
+        g_SeparableFilter.SetPixelShaders( g_pPSHorizontalFilter[g_eFilterType][g_eFilterPrecisionType][eKernelRadius], 
+            g_pPSVerticalFilter[g_eFilterType][g_eFilterPrecisionType][eKernelRadius] );
+        g_SeparableFilter.OnRender( SeparableFilter::SHADER_TYPE_PIXEL );
+    }
+}
+
+
 //--------------------------------------------------------------------------------------
 // Reject any D3D11 devices that aren't acceptable by returning false
 //--------------------------------------------------------------------------------------
@@ -431,6 +625,12 @@ HRESULT CALLBACK OnD3D11CreateDevice( ID3D11Device* pd3dDevice, const DXGI_SURFA
     cbDesc.ByteWidth = sizeof( CB_BILATERAL_FILTER );
     V_RETURN( pd3dDevice->CreateBuffer( &cbDesc, NULL, &g_pCBBilateralFilter ) );
     DXUT_SetDebugName( g_pCBBilateralFilter, "CB_BILATERAL_FILTER" );
+    cbDesc.ByteWidth = sizeof( CB_JOINT_BILATERAL_FILTER );
+    V_RETURN( pd3dDevice->CreateBuffer( &cbDesc, NULL, &g_pCBJointBilateralFilter ) );
+    DXUT_SetDebugName( g_pCBJointBilateralFilter, "CB_JOINT_BILATERAL_FILTER" );
+    cbDesc.ByteWidth = sizeof( CB_GAUSSIAN_FILTER );
+    V_RETURN( pd3dDevice->CreateBuffer( &cbDesc, NULL, &g_pCBGaussianFilter ) );
+    DXUT_SetDebugName( g_pCBGaussianFilter, "CB_GAUSSIAN_FILTER" );
 
     // Fill out a unit quad
     QuadVertex QuadVertices[6];
@@ -466,6 +666,8 @@ HRESULT CALLBACK OnD3D11CreateDevice( ID3D11Device* pd3dDevice, const DXGI_SURFA
     g_MagnifyTool.OnCreateDevice( pd3dDevice );
     g_HUD.OnCreateDevice( pd3dDevice );
     g_SeparableFilter.OnCreateDevice( pd3dDevice );
+    g_PyramidFilter.OnCreateDevice( pd3dDevice );
+    g_DualFilter.OnCreateDevice( pd3dDevice );
 
     // Create blend states 
     D3D11_BLEND_DESC BlendStateDesc;
@@ -582,6 +784,12 @@ HRESULT CALLBACK OnD3D11ResizedSwapChain( ID3D11Device* pd3dDevice, IDXGISwapCha
 
     // AMD SeparableFilter hook
     g_SeparableFilter.OnResizedSwapChain( pBackBufferSurfaceDesc );
+
+    // AMD PyramidFilter hook
+    V_RETURN( g_PyramidFilter.OnResizedSwapChain( pd3dDevice, pBackBufferSurfaceDesc ) );
+
+    // AMD DualFilter hook
+    V_RETURN( g_DualFilter.OnResizedSwapChain( pd3dDevice, pBackBufferSurfaceDesc ) );
       
     return S_OK;
 }
@@ -628,6 +836,76 @@ void CALLBACK OnD3D11FrameRender( ID3D11Device* pd3dDevice, ID3D11DeviceContext*
     pd3dImmediateContext->PSSetConstantBuffers( 2, 1, &g_pCBBilateralFilter );
     pd3dImmediateContext->CSSetConstantBuffers( 2, 1, &g_pCBBilateralFilter );
 
+    // Joint bilateral filter cb, a Gaussian range of the view space depth
+    V( pd3dImmediateContext->Map( g_pCBJointBilateralFilter, 0, D3D11_MAP_WRITE_DISCARD, 0, &MappedResource ) );
+    CB_JOINT_BILATERAL_FILTER* pCBJointBilateralFilter = ( CB_JOINT_BILATERAL_FILTER* )MappedResource.pData;
+    pCBJointBilateralFilter->fGuideScale[0] = 1.0f / g_fJointBilateralDepthDeviation;
+    pCBJointBilateralFilter->fGuideScale[1] = 0.0f;
+    pCBJointBilateralFilter->fGuideScale[2] = 0.0f;
+    pCBJointBilateralFilter->fGuideScale[3] = 0.0f;
+    CPUFilter::ComputeRangeWeights( pCBJointBilateralFilter->fRangeWeights );
+    pd3dImmediateContext->Unmap( g_pCBJointBilateralFilter, 0 );
+    pd3dImmediateContext->PSSetConstantBuffers( 6, 1, &g_pCBJointBilateralFilter );
+    pd3dImmediateContext->CSSetConstantBuffers( 6, 1, &g_pCBJointBilateralFilter );
+
+    // Gaussian filter cb, and the radius that covers the deviation. Deviations whose kernel
+    // would outgrow the radius permutations go through the pyramid, which filters its coarse
+    // level by the deviation it leaves. The dual filter doesn't use it, but its benchmark
+    // runs the Gaussian of the chain's deviation.
+    SeparableFilter::KERNEL_RADIUS_TYPE eKernelRadius = g_eKernelRadius;
+    const bool bUseDualFilter = ( FILTER_TYPE_GAUSSIAN == g_eFilterType && g_bUseDualFilter && g_DualFilter.GetNumLevels() > 0 );
+    const bool bBenchmark = ( bUseDualFilter && g_bBenchmarkDualFilter );
+    bool bUsePyramid = ( FILTER_TYPE_GAUSSIAN == g_eFilterType && g_bUsePyramid );
+    float fGaussianDeviation = g_fGaussianDeviation;
+    float fPyramidDeviation = g_fPyramidDeviation;
+    if( bUseDualFilter )
+    {
+        g_DualFilter.SetDeviation( g_fDualFilterDeviation );
+        fGaussianDeviation = g_DualFilter.GetChainDeviation();
+        fPyramidDeviation = fGaussianDeviation;
+        bUsePyramid = CPUFilter::RequiresPyramid( fGaussianDeviation, g_fGaussianTolerance );
+    }
+    else if( FILTER_TYPE_GAUSSIAN == g_eFilterType && !bUsePyramid && CPUFilter::RequiresPyramid( fGaussianDeviation, g_fGaussianTolerance ) )
+    {
+        bUsePyramid = true;
+        fPyramidDeviation = fGaussianDeviation;
+    }
+    if( bUsePyramid )
+    {
+        g_PyramidFilter.SetDeviation( fPyramidDeviation );
+        fGaussianDeviation = g_PyramidFilter.GetCoarseDeviation();
+    }
+    if( FILTER_TYPE_GAUSSIAN == g_eFilterType && fGaussianDeviation > 0.0f )
+    {
+        eKernelRadius = SeparableFilter::GetKernelRadiusType( CPUFilter::ComputeGaussianRadius( fGaussianDeviation, g_fGaussianTolerance ) );
+    }
+    V( pd3dImmediateContext->Map( g_pCBGaussianFilter, 0, D3D11_MAP_WRITE_DISCARD, 0, &MappedResource ) );
+    FillGaussianWeights( ( CB_GAUSSIAN_FILTER* )MappedResource.pData, SeparableFilter::GetKernelRadius( eKernelRadius ),
+        ( g_eFilterPrecisionType == SeparableFilter::FILTER_PRECISION_TYPE_APPROXIMATE ) ? 2 : 1, fGaussianDeviation );
+    pd3dImmediateContext->Unmap( g_pCBGaussianFilter, 0 );
+    pd3dImmediateContext->PSSetConstantBuffers( 3, 1, &g_pCBGaussianFilter );
+    pd3dImmediateContext->CSSetConstantBuffers( 3, 1, &g_pCBGaussianFilter );
+
+    // Traffic estimates for the dual filter and its benchmark, at the scene's format
+    if( bUseDualFilter )
+    {
+        const unsigned int uBytesPerTexel = ( SURFACE_FORMAT_TYPE_FLOAT_32 == g_eSurfacePrecisionType ) ? 16 : ( ( SURFACE_FORMAT_TYPE_FLOAT_16 == g_eSurfacePrecisionType ) ? 8 : 4 );
+        const unsigned int uWidth = DXUTGetDXGIBackBufferSurfaceDesc()->Width;
+        const unsigned int uHeight = DXUTGetDXGIBackBufferSurfaceDesc()->Height;
+        const bool bApproximate = ( g_eFilterPrecisionType == SeparableFilter::FILTER_PRECISION_TYPE_APPROXIMATE );
+
+        CPUFilter::ComputeDualFilterTraffic( uWidth, uHeight, g_DualFilter.GetNumLevels(), uBytesPerTexel, 8, &g_DualFilterTraffic );
+        if( bUsePyramid )
+        {
+            CPUFilter::ComputePyramidTraffic( uWidth, uHeight, g_PyramidFilter.GetNumLevels(), SeparableFilter::GetKernelRadius( eKernelRadius ), bApproximate,
+                uBytesPerTexel, 8, &g_BenchmarkTraffic );
+        }
+        else
+        {
+            CPUFilter::ComputeSeparableFilterTraffic( uWidth, uHeight, SeparableFilter::GetKernelRadius( eKernelRadius ), bApproximate, uBytesPerTexel, &g_BenchmarkTraffic );
+        }
+    }
+
 	XMMATRIX mWorld = g_Camera.GetWorldMatrix();
     XMMATRIX mView = g_Camera.GetViewMatrix();
     XMMATRIX mProj = g_Camera.GetProjMatrix();
@@ -643,45 +921,37 @@ void CALLBACK OnD3D11FrameRender( ID3D11Device* pd3dDevice, ID3D11DeviceContext*
     pd3dImmediateContext->VSSetConstantBuffers( 1, 1, &g_pcbUtility );
 	pd3dImmediateContext->PSSetConstantBuffers( 1, 1, &g_pcbUtility );
 
-    // NULL RTV and SRV
-    ID3D11RenderTargetView* pNULLRTV = NULL;
+    // NULL SRV
     ID3D11ShaderResourceView* pNULLSRV = NULL;
 
     if( g_ShaderCache.ShadersReady() )
     {
         // Render the scene mesh 
-        pd3dImmediateContext->PSSetSamplers( 0, 1, &g_pLinearSampler );
-        pd3dImmediateContext->OMSetRenderTargets( 1, &g_pSceneTextureRTV[0][g_eSurfacePrecisionType], g_pDepthStencilView );
-        pd3dImmediateContext->IASetInputLayout( g_pSceneVertexLayout );
-        pd3dImmediateContext->VSSetShader( g_pSceneVS, NULL, 0 );
-	    pd3dImmediateContext->PSSetShader( g_pScenePS, NULL, 0 );
-	    g_SceneMesh.Render( pd3dImmediateContext, 1, 2 );
-        pd3dImmediateContext->PSSetShader( g_pSkyPS, NULL, 0 );
-        g_SkyMesh.Render( pd3dImmediateContext, 1, 2 );
-        pd3dImmediateContext->OMSetRenderTargets( 1, &pNULLRTV, NULL );
+        RenderScene( pd3dImmediateContext );
+
+        // The Gaussian of equal deviation runs first, over the scene that is then rendered
+        // again for the dual filter
+        if( bBenchmark && !g_HUD.m_GUI.GetRadioButton( IDC_RADIO_FILTER_NONE )->GetChecked() )
+        {
+            TIMER_Begin( 0, L"Benchmark" )
+            RenderGaussianFilter( bUsePyramid, eKernelRadius );
+            TIMER_End() // Benchmark
+
+            pd3dImmediateContext->ClearDepthStencilView( g_pDepthStencilView, D3D11_CLEAR_DEPTH, 1.0, 0 );
+            RenderScene( pd3dImmediateContext );
+        }
         
         TIMER_Begin( 0, L"Filtering" )
         
-        if( !g_HUD.m_GUI.GetRadioButton( IDC_RADIO_FILTER_NONE )->GetChecked() )
+        if( !g_HUD.m_GUI.GetRadioButton( IDC_RADIO_FILTER_NONE )->GetChecked() && bUseDualFilter )
         {
-            ID3D11ShaderResourceView* pHorizSRVs[2] = { g_pSceneTextureSRV[0][g_eSurfacePrecisionType], g_pDepthStencilSRV };
-            ID3D11ShaderResourceView* pVertSRVs[2] = { g_pSceneTextureSRV[1][g_eSurfacePrecisionType], g_pDepthStencilSRV };
-            g_SeparableFilter.SetShaderResourceViews( pHorizSRVs, pVertSRVs, 2 );
-            
-            if( g_HUD.m_GUI.GetCheckBox( IDC_CHECKBOX_COMPUTE_SHADER )->GetChecked() )
-            {
-                g_SeparableFilter.SetUnorderedAccessViews( g_pSceneTextureUAV[1][g_eSurfacePrecisionType], g_pSceneTextureUAV[0][g_eSurfacePrecisionType] );
-                g_SeparableFilter.SetComputeShaders( g_pCSHorizontalFilter[g_eFilterType][g_eFilterPrecisionType][g_eKernelRadius][g_eLDSPrecisionType], 
-                    g_pCSVerticalFilter[g_eFilterType][g_eFilterPrecisionType][g_eKernelRadius][g_eLDSPrecisionType] );
-                g_SeparableFilter.OnRender( SeparableFilter::SHADER_TYPE_COMPUTE );
-            }
-            else
-            {
-                g_SeparableFilter.SetRenderTargetViews( g_pSceneTextureRTV[1][g_eSurfacePrecisionType], g_pSceneTextureRTV[0][g_eSurfacePrecisionType] );
-                g_SeparableFilter.SetPixelShaders( g_pPSHorizontalFilter[g_eFilterType][g_eFilterPrecisionType][g_eKernelRadius], 
-                    g_pPSVerticalFilter[g_eFilterType][g_eFilterPrecisionType][g_eKernelRadius] );
-                g_SeparableFilter.OnRender( SeparableFilter::SHADER_TYPE_PIXEL );
-            }
+            // From the scene texture back into it, through the levels of the chain
+            g_DualFilter.SetPixelShaders( g_pPSDualDownsample, g_pPSDualUpsample );
+            g_DualFilter.OnRender( g_pSceneTextureSRV[0][g_eSurfacePrecisionType], g_pSceneTextureRTV[0][g_eSurfacePrecisionType] );
+        }
+        else if( !g_HUD.m_GUI.GetRadioButton( IDC_RADIO_FILTER_NONE )->GetChecked() )
+        {
+            RenderGaussianFilter( bUsePyramid, eKernelRadius );
         }
 
         TIMER_End() // Filtering
@@ -755,6 +1025,9 @@ void CALLBACK OnD3D11ReleasingSwapChain( void* pUserContext )
         SAFE_RELEASE( g_pSceneTextureRTV[1][iSurface] );
         SAFE_RELEASE( g_pSceneTextureUAV[1][iSurface] );
     }
+
+    g_PyramidFilter.OnReleasingSwapChain();
+    g_DualFilter.OnReleasingSwapChain();
 }
 
 
@@ -799,6 +1072,11 @@ void CALLBACK OnD3D11DestroyDevice( void* pUserContext )
         }
     }
 
+    SAFE_RELEASE( g_pPSPyramidDownsample );
+    SAFE_RELEASE( g_pPSPyramidUpsample );
+    SAFE_RELEASE( g_pPSDualDownsample );
+    SAFE_RELEASE( g_pPSDualUpsample );
+
     SAFE_RELEASE( g_pQuadVertexBuffer );
 
     SAFE_RELEASE( g_pDepthStencilTexture );
@@ -819,6 +1097,8 @@ void CALLBACK OnD3D11DestroyDevice( void* pUserContext )
         SAFE_RELEASE( g_pSceneTextureUAV[1][iSurface] );
     }
 
+    SAFE_RELEASE( g_pCBGaussianFilter );
+    SAFE_RELEASE( g_pCBJointBilateralFilter );
     SAFE_RELEASE( g_pCBBilateralFilter );
     SAFE_RELEASE( g_pcbUtility );
 
@@ -827,6 +1107,10 @@ void CALLBACK OnD3D11DestroyDevice( void* pUserContext )
     g_HUD.OnDestroyDevice();
 
     g_SeparableFilter.OnDestroyDevice();
+    g_PyramidFilter.OnReleasingSwapChain();
+    g_PyramidFilter.OnDestroyDevice();
+    g_DualFilter.OnReleasingSwapChain();
+    g_DualFilter.OnDestroyDevice();
 
     SAFE_RELEASE( g_pAlphaState );
     SAFE_RELEASE( g_pOpaqueState );
@@ -960,12 +1244,41 @@ void CALLBACK OnGUIEvent( UINT nEvent, int nControlID, CDXUTControl* pControl, v
             g_eFilterPrecisionType = (SeparableFilter::FILTER_PRECISION_TYPE)((CDXUTCheckBox*)pControl)->GetChecked();
             break;
 
+        case IDC_CHECKBOX_DIRTY_RECT:
+            g_bFilterDirtyRect = ((CDXUTCheckBox*)pControl)->GetChecked();
+            break;
+
         case IDC_SLIDER_FILTER_RADIUS:
             nTemp = ((CDXUTSlider*)pControl)->GetValue();
             swprintf_s( szTemp, L"Filter Radius : %d", ( nTemp + 1 ) * 2 );
             g_HUD.m_GUI.GetStatic( IDC_STATIC_FILTER_RADIUS )->SetText( szTemp );
             g_eKernelRadius = (SeparableFilter::KERNEL_RADIUS_TYPE)nTemp;
             break;
+
+        case IDC_SLIDER_GAUSSIAN_DEVIATION:
+            nTemp = ((CDXUTSlider*)pControl)->GetValue();
+            g_fGaussianDeviation = (float)nTemp * 0.5f;
+            if( nTemp > 0 )
+            {
+                // The radius of the permutation that holds the deviation within the tolerance,
+                // or the pyramid when none can
+                if( CPUFilter::RequiresPyramid( g_fGaussianDeviation, g_fGaussianTolerance ) )
+                {
+                    swprintf_s( szTemp, L"Gaussian Deviation : %.1f (Pyramid)", g_fGaussianDeviation );
+                }
+                else
+                {
+                    const int iRadius = CPUFilter::ComputeGaussianRadius( g_fGaussianDeviation, g_fGaussianTolerance );
+                    swprintf_s( szTemp, L"Gaussian Deviation : %.1f (Radius %d)", g_fGaussianDeviation,
+                        SeparableFilter::GetKernelRadius( SeparableFilter::GetKernelRadiusType( iRadius ) ) );
+                }
+            }
+            else
+            {
+                swprintf_s( szTemp, L"Gaussian Deviation : Radius / 2" );
+            }
+            g_HUD.m_GUI.GetStatic( IDC_STATIC_GAUSSIAN_DEVIATION )->SetText( szTemp );
+            break;
         
         case IDC_RADIO_FILTER_GAUSSIAN:
             g_eFilterType = ((CDXUTRadioButton*)pControl)->GetChecked() ? ( FILTER_TYPE_GAUSSIAN ) : ( g_eFilterType );
@@ -975,6 +1288,40 @@ void CALLBACK OnGUIEvent( UINT nEvent, int nControlID, CDXUTControl* pControl, v
             g_eFilterType = ((CDXUTRadioButton*)pControl)->GetChecked() ? ( FILTER_TYPE_BILATERAL ) : ( g_eFilterType );
             break;
 
+        case IDC_RADIO_FILTER_BILATERAL_GATHER:
+            g_eFilterType = ((CDXUTRadioButton*)pControl)->GetChecked() ? ( FILTER_TYPE_BILATERAL_GATHER ) : ( g_eFilterType );
+            break;
+
+        case IDC_RADIO_FILTER_JOINT_BILATERAL:
+            g_eFilterType = ((CDXUTRadioButton*)pControl)->GetChecked() ? ( FILTER_TYPE_JOINT_BILATERAL ) : ( g_eFilterType );
+            break;
+
+        case IDC_CHECKBOX_PYRAMID:
+            g_bUsePyramid = ((CDXUTCheckBox*)pControl)->GetChecked();
+            break;
+
+        case IDC_SLIDER_PYRAMID_DEVIATION:
+            nTemp = ((CDXUTSlider*)pControl)->GetValue();
+            g_fPyramidDeviation = (float)nTemp;
+            swprintf_s( szTemp, L"Pyramid Deviation : %d", nTemp );
+            g_HUD.m_GUI.GetStatic( IDC_STATIC_PYRAMID_DEVIATION )->SetText( szTemp );
+            break;
+
+        case IDC_CHECKBOX_DUAL_FILTER:
+            g_bUseDualFilter = ((CDXUTCheckBox*)pControl)->GetChecked();
+            break;
+
+        case IDC_SLIDER_DUAL_FILTER_DEVIATION:
+            nTemp = ((CDXUTSlider*)pControl)->GetValue();
+            g_fDualFilterDeviation = (float)nTemp;
+            swprintf_s( szTemp, L"Dual Filter Deviation : %d", nTemp );
+            g_HUD.m_GUI.GetStatic( IDC_STATIC_DUAL_FILTER_DEVIATION )->SetText( szTemp );
+            break;
+
+        case IDC_CHECKBOX_BENCHMARK:
+            g_bBenchmarkDualFilter = ((CDXUTCheckBox*)pControl)->GetChecked();
+            break;
+
 		default:
 			AMD::OnGUIEvent( nEvent, nControlID, pControl, pUserContext );
 			break;
@@ -1021,6 +1368,11 @@ HRESULT AddShadersToCache()
         }
     }
 
+    SAFE_RELEASE( g_pPSPyramidDownsample );
+    SAFE_RELEASE( g_pPSPyramidUpsample );
+    SAFE_RELEASE( g_pPSDualDownsample );
+    SAFE_RELEASE( g_pPSDualUpsample );
+
     const D3D11_INPUT_ELEMENT_DESC SceneLayout[] =
     {
         { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
@@ -1049,6 +1401,18 @@ HRESULT AddShadersToCache()
 
     g_ShaderCache.AddShader( (ID3D11DeviceChild**)&g_pPSTexturedScreenQuad, AMD::ShaderCache::SHADER_TYPE_PIXEL, L"ps_5_0", L"PSTexturedScreenQuad",
         L"SeparableFilter11.hlsl", 0, NULL, NULL, NULL, 0 );
+
+    g_ShaderCache.AddShader( (ID3D11DeviceChild**)&g_pPSPyramidDownsample, AMD::ShaderCache::SHADER_TYPE_PIXEL, L"ps_5_0", L"PSPyramidDownsample",
+        L"PyramidFilter.hlsl", 0, NULL, NULL, NULL, 0 );
+
+    g_ShaderCache.AddShader( (ID3D11DeviceChild**)&g_pPSPyramidUpsample, AMD::ShaderCache::SHADER_TYPE_PIXEL, L"ps_5_0", L"PSPyramidUpsample",
+        L"PyramidFilter.hlsl", 0, NULL, NULL, NULL, 0 );
+
+    g_ShaderCache.AddShader( (ID3D11DeviceChild**)&g_pPSDualDownsample, AMD::ShaderCache::SHADER_TYPE_PIXEL, L"ps_5_0", L"PSDualDownsample",
+        L"DualFilter.hlsl", 0, NULL, NULL, NULL, 0 );
+
+    g_ShaderCache.AddShader( (ID3D11DeviceChild**)&g_pPSDualUpsample, AMD::ShaderCache::SHADER_TYPE_PIXEL, L"ps_5_0", L"PSDualUpsample",
+        L"DualFilter.hlsl", 0, NULL, NULL, NULL, 0 );
     
     for( int iFilter = 0; iFilter < FILTER_TYPE_MAX; ++iFilter )
     //int iFilter = FILTER_TYPE_GAUSSIAN;   // Compile a specific shader
@@ -1066,6 +1430,14 @@ HRESULT AddShadersToCache()
             wcscpy_s( wsSourceFile, AMD::ShaderCache::m_uFILENAME_MAX_LENGTH, L"BilateralFilter.hlsl" ); 
             wcscpy_s( wsFilterType, AMD::ShaderCache::m_uFILENAME_MAX_LENGTH, L"BILATERAL_FILTER" ); 
             break;
+        case FILTER_TYPE_BILATERAL_GATHER:
+            wcscpy_s( wsSourceFile, AMD::ShaderCache::m_uFILENAME_MAX_LENGTH, L"BilateralFilter.hlsl" ); 
+            wcscpy_s( wsFilterType, AMD::ShaderCache::m_uFILENAME_MAX_LENGTH, L"BILATERAL_GATHER_FILTER" ); 
+            break;
+        case FILTER_TYPE_JOINT_BILATERAL:
+            wcscpy_s( wsSourceFile, AMD::ShaderCache::m_uFILENAME_MAX_LENGTH, L"JointBilateralFilter.hlsl" ); 
+            wcscpy_s( wsFilterType, AMD::ShaderCache::m_uFILENAME_MAX_LENGTH, L"JOINT_BILATERAL_FILTER" ); 
+            break;
         };
         
         for( int iFilterPrecision = 0; iFilterPrecision < SeparableFilter::FILTER_PRECISION_TYPE_MAX; ++iFilterPrecision )
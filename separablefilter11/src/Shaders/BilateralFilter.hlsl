@@ -26,7 +26,9 @@
 // Implements a simple bilateral filter. It uses the scene depth to compute a focal 
 // region that is in turn used to determine how blurry a pixel should be. This mimics
 // the common DoF effect, but is only intended as an example of how to manipulate the 
-// filter macros to perform custom filters.
+// filter macros to perform custom filters. Compiled with BILATERAL_GATHER_FILTER, each
+// sample only reaches as far as its circle of confusion, and the compute shaders only
+// iterate over the reach of their group (see KERNEL_GATHER_RADIUS in FilterKernel.hlsl).
 //--------------------------------------------------------------------------------------
 
 #include "..\\..\\..\\AMD_LIB\\src\\Shaders\\SeparableFilter\\FilterCommon.hlsl"
@@ -202,13 +204,31 @@ struct KernelData
         _O.f4Color[_iPixel].xyz = _RAWDataItem[_iPixel].f3Color * _KernelData[_iPixel].fWeight; }     
         
 
+//--------------------------------------------------------------------------------------
+// The circle of confusion of a sample is its focal value times KERNEL_RADIUS, and in the
+// gather filter taps beyond it have no weight
+//--------------------------------------------------------------------------------------
+#if defined( BILATERAL_GATHER_FILTER )
+
+    #define KERNEL_GATHER_RADIUS( _RAWDataItem ) ( _RAWDataItem.fFocal * KERNEL_RADIUS )
+    #define TAP_REACH( _fX, _fFocal ) ( ( abs( _fX ) <= ( _fFocal ) * KERNEL_RADIUS ) ? ( _fFocal ) : 0.0f )
+
+#else
+
+    #define TAP_REACH( _fX, _fFocal ) ( _fFocal )
+
+#endif
+
+
 //--------------------------------------------------------------------------------------
 // Compute what happens for each iteration of the kernel 
 //--------------------------------------------------------------------------------------
+#define TAP_OFFSET( _iIteration ) ( _iIteration - KERNEL_RADIUS + ( 1.0f - 1.0f / float( STEP_SIZE ) ) )
+
 #define KERNEL_ITERATION( _iIteration, _KernelData, _iPixel, _iNumPixels, _O, _RAWDataItem ) \
     [unroll] for( _iPixel = 0; _iPixel < _iNumPixels; ++_iPixel ) { \
-        GAUSSIAN_WEIGHT( ( _iIteration - KERNEL_RADIUS + ( 1.0f - 1.0f / float( STEP_SIZE ) ) ), GAUSSIAN_DEVIATION, _KernelData[_iPixel].fWeight ) \
-        _KernelData[_iPixel].fWeight *= ( _RAWDataItem[_iPixel].fDepth < _KernelData[_iPixel].fCenterDepth ) ? ( _RAWDataItem[_iPixel].fFocal ) : ( _KernelData[_iPixel].fCenterFocal ); \
+        GAUSSIAN_WEIGHT( TAP_OFFSET( _iIteration ), GAUSSIAN_DEVIATION, _KernelData[_iPixel].fWeight ) \
+        _KernelData[_iPixel].fWeight *= ( _RAWDataItem[_iPixel].fDepth < _KernelData[_iPixel].fCenterDepth ) ? TAP_REACH( TAP_OFFSET( _iIteration ), _RAWDataItem[_iPixel].fFocal ) : TAP_REACH( TAP_OFFSET( _iIteration ), _KernelData[_iPixel].fCenterFocal ); \
         _KernelData[_iPixel].fWeightSum += _KernelData[_iPixel].fWeight; \
         _O.f4Color[_iPixel].xyz += _RAWDataItem[_iPixel].f3Color * _KernelData[_iPixel].fWeight; }
         
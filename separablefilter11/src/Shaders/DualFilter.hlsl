@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: DualFilter.hlsl
+//
+// Implements the downsample and upsample passes of the dual filter chain used for bloom,
+// the GPU equivalents of CPUFilter::DualDownsample and CPUFilter::DualUpsample.
+//--------------------------------------------------------------------------------------
+
+
+// Size of the level sampled by a pass
+cbuffer cbDualFilter : register( b5 )
+{
+    float4 g_f4InputSize;   // ( [0] = Width, [1] = Height, [2] = Inv Width, [3] = Inv Height )
+}
+
+// The input texture
+Texture2D g_txInput : register( t0 );
+
+// Samplers
+SamplerState g_LinearClampSampler : register( s0 );
+
+// Input structure used by the screen quad PS
+struct PS_RenderQuadInput
+{
+    float4 f4Position : SV_POSITION;
+    float2 f2TexCoord : TEXCOORD0;
+};
+
+
+//--------------------------------------------------------------------------------------
+// Output texel i is centered between input texels 2i and 2i+1, so a bilinear sample there
+// and at one input texel along each diagonal each average 2 x 2 texels. The center takes
+// half the weight and the diagonals an eighth each.
+//--------------------------------------------------------------------------------------
+float4 PSDualDownsample( PS_RenderQuadInput I ) : SV_TARGET
+{
+    float2 f2Center = I.f4Position.xy * 2.0f * g_f4InputSize.zw;
+    float2 f2Offset = g_f4InputSize.zw;
+
+    float4 f4Output = g_txInput.SampleLevel( g_LinearClampSampler, f2Center, 0 ) * 4.0f;
+    f4Output += g_txInput.SampleLevel( g_LinearClampSampler, f2Center + float2( -f2Offset.x, -f2Offset.y ), 0 );
+    f4Output += g_txInput.SampleLevel( g_LinearClampSampler, f2Center + float2( f2Offset.x, -f2Offset.y ), 0 );
+    f4Output += g_txInput.SampleLevel( g_LinearClampSampler, f2Center + float2( -f2Offset.x, f2Offset.y ), 0 );
+    f4Output += g_txInput.SampleLevel( g_LinearClampSampler, f2Center + float2( f2Offset.x, f2Offset.y ), 0 );
+
+    return f4Output * ( 1.0f / 8.0f );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Output texel x lies at coarse texel x / 2 - 1/4, as in PSPyramidUpsample. Samples one
+// coarse texel away along the axes take a twelfth of the weight each, and samples half a
+// coarse texel away along the diagonals a sixth each.
+//--------------------------------------------------------------------------------------
+float4 PSDualUpsample( PS_RenderQuadInput I ) : SV_TARGET
+{
+    float2 f2Center = I.f4Position.xy * 0.5f * g_f4InputSize.zw;
+    float2 f2Offset = g_f4InputSize.zw;
+    float2 f2HalfOffset = 0.5f * g_f4InputSize.zw;
+
+    float4 f4Output = g_txInput.SampleLevel( g_LinearClampSampler, f2Center + float2( -f2Offset.x, 0.0f ), 0 );
+    f4Output += g_txInput.SampleLevel( g_LinearClampSampler, f2Center + float2( f2Offset.x, 0.0f ), 0 );
+    f4Output += g_txInput.SampleLevel( g_LinearClampSampler, f2Center + float2( 0.0f, -f2Offset.y ), 0 );
+    f4Output += g_txInput.SampleLevel( g_LinearClampSampler, f2Center + float2( 0.0f, f2Offset.y ), 0 );
+    f4Output += g_txInput.SampleLevel( g_LinearClampSampler, f2Center + float2( -f2HalfOffset.x, -f2HalfOffset.y ), 0 ) * 2.0f;
+    f4Output += g_txInput.SampleLevel( g_LinearClampSampler, f2Center + float2( f2HalfOffset.x, -f2HalfOffset.y ), 0 ) * 2.0f;
+    f4Output += g_txInput.SampleLevel( g_LinearClampSampler, f2Center + float2( -f2HalfOffset.x, f2HalfOffset.y ), 0 ) * 2.0f;
+    f4Output += g_txInput.SampleLevel( g_LinearClampSampler, f2Center + float2( f2HalfOffset.x, f2HalfOffset.y ), 0 ) * 2.0f;
+
+    return f4Output * ( 1.0f / 12.0f );
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
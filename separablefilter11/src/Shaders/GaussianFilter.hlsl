@@ -29,8 +29,17 @@
 #include "..\\..\\..\\AMD_LIB\\src\\Shaders\\SeparableFilter\\FilterCommon.hlsl"
 
 // Defines
-#define PI                      ( 3.1415927f )
-#define GAUSSIAN_DEVIATION      ( KERNEL_RADIUS * 0.5f )
+#define MAX_KERNEL_DIAMETER     ( 65 )
+
+// The weights of the taps, for the deviation chosen by the application. Indexed by
+// iteration, so the center is at KERNEL_RADIUS. For the approximate filter each weight
+// is the sum of the pair of texels merged by the iteration, and the offset is where the
+// bilinear sample between them gives each texel its own weight.
+cbuffer cbGF : register( b3 )
+{
+    float4 g_f4GaussianWeights[( MAX_KERNEL_DIAMETER + 3 ) / 4];
+    float4 g_f4GaussianOffsets[( MAX_KERNEL_DIAMETER + 3 ) / 4];
+}
 
 // The input texture
 Texture2D g_txInput : register( t0 ); 
@@ -106,11 +115,25 @@ struct KernelData
 
 //--------------------------------------------------------------------------------------
 // Get a Gaussian weight
-// The weights get compiled to constants, so the cost for this macro disappears 
+// The iterations are unrolled, so this is a constant buffer read at a fixed offset
+//--------------------------------------------------------------------------------------
+#define GAUSSIAN_WEIGHT( _iIteration, _fWeight ) \
+    _fWeight = g_f4GaussianWeights[( _iIteration ) / 4][( _iIteration ) % 4];
+
+
+//--------------------------------------------------------------------------------------
+// Offset of the merged taps of the approximate filter. The PS takes its bilinear sample
+// there, and the CS blends the pair of texels it reads from the LDS by it.
+//--------------------------------------------------------------------------------------
+#define KERNEL_SAMPLE_OFFSET( _iIteration ) \
+    ( g_f4GaussianOffsets[( _iIteration ) / 4][( _iIteration ) % 4] )
+
+
+//--------------------------------------------------------------------------------------
+// Blend a pair of texels read from the LDS
 //--------------------------------------------------------------------------------------
-#define GAUSSIAN_WEIGHT( _fX, _fDeviation, _fWeight ) \
-    _fWeight = 1.0f / sqrt( 2.0f * PI * _fDeviation * _fDeviation ); \
-    _fWeight *= exp( -( _fX * _fX ) / ( 2.0f * _fDeviation * _fDeviation ) );
+#define KERNEL_LERP_SAMPLES( _RDI0, _RDI1, _fOffset, _RDIOut ) \
+    _RDIOut.f3Color = lerp( _RDI0.f3Color, _RDI1.f3Color, _fOffset );
 
 
 //--------------------------------------------------------------------------------------
@@ -125,7 +148,7 @@ struct KernelData
 //--------------------------------------------------------------------------------------
 #define KERNEL_CENTER( _KernelData, _iPixel, _iNumPixels, _O, _RAWDataItem ) \
     [unroll] for( _iPixel = 0; _iPixel < _iNumPixels; ++_iPixel ) { \
-        GAUSSIAN_WEIGHT( 0, GAUSSIAN_DEVIATION, _KernelData[_iPixel].fWeight ) \
+        GAUSSIAN_WEIGHT( KERNEL_RADIUS, _KernelData[_iPixel].fWeight ) \
         _KernelData[_iPixel].fWeightSum = _KernelData[_iPixel].fWeight; \
         _O.f4Color[_iPixel].xyz = _RAWDataItem[_iPixel].f3Color * _KernelData[_iPixel].fWeight; }     
 
@@ -135,7 +158,7 @@ struct KernelData
 //--------------------------------------------------------------------------------------
 #define KERNEL_ITERATION( _iIteration, _KernelData, _iPixel, _iNumPixels, _O, _RAWDataItem ) \
     [unroll] for( _iPixel = 0; _iPixel < _iNumPixels; ++_iPixel ) { \
-        GAUSSIAN_WEIGHT( ( _iIteration - KERNEL_RADIUS + ( 1.0f - 1.0f / float( STEP_SIZE ) ) ), GAUSSIAN_DEVIATION, _KernelData[_iPixel].fWeight ) \
+        GAUSSIAN_WEIGHT( _iIteration, _KernelData[_iPixel].fWeight ) \
         _KernelData[_iPixel].fWeightSum += _KernelData[_iPixel].fWeight; \
         _O.f4Color[_iPixel].xyz += _RAWDataItem[_iPixel].f3Color * _KernelData[_iPixel].fWeight; }
 
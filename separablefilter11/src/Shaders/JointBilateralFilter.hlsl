@@ -0,0 +1,261 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: JointBilateralFilter.hlsl
+//
+// Implements a joint (cross) bilateral filter, for denoising buffers such as AO or GI.
+// The signal (t0) is weighted by the Gaussian of the tap's distance, and by a range
+// weight looked up from the distance between the guide (t1) of the tap and of the center,
+// so the edges of the guide are kept. The guide may be depth, normals or albedo: each of
+// its channels is scaled by g_f4GuideScale, and the squared length of the difference
+// indexes the range weight table of the application.
+//--------------------------------------------------------------------------------------
+
+#include "..\\..\\..\\AMD_LIB\\src\\Shaders\\SeparableFilter\\FilterCommon.hlsl"
+
+// Defines
+#define PI                      ( 3.1415927f )
+#define GAUSSIAN_DEVIATION      ( KERNEL_RADIUS * 0.5f )
+#define RANGE_TABLE_SIZE        ( 256 )
+#define RANGE_TABLE_SCALE       ( 16.0f )
+
+// The sample guides the filter with its depth buffer, converted to view space depth. Other
+// guides are read as they are with GUIDE_IS_DEPTH defined to 0.
+#ifndef GUIDE_IS_DEPTH
+    #define GUIDE_IS_DEPTH      ( 1 )
+#endif
+
+// Constant buffer used by bilateral filters, for the depth guide
+cbuffer cbBF : register( b2 )
+{
+    float4 g_f4ProjParams;  //  x = fQTimesZNear, y = fQ
+}
+
+// The range weights, one per 1 / RANGE_TABLE_SCALE of squared guide distance, so that
+// any range function can be used. Distances past the end get the last weight.
+cbuffer cbJBF : register( b6 )
+{
+    float4 g_f4GuideScale;                                  // Per guide channel, 0 to ignore it
+    float4 g_f4RangeWeights[RANGE_TABLE_SIZE / 4];
+}
+
+// The input textures
+Texture2D g_txInput : register( t0 ); 
+Texture2D g_txGuide : register( t1 ); 
+
+// The output UAV used by the CS 
+RWTexture2D<float4> g_uavOutput : register( u0 );
+
+// CS output structure
+struct CS_Output
+{
+    float4 f4Color[PIXELS_PER_THREAD]; 
+};
+
+// PS output structure
+struct PS_Output
+{
+    float4 f4Color[1]; 
+};
+
+// Uncompressed data as sampled from inputs
+struct RAWDataItem
+{
+    float4 f4Color;
+    float4 f4Guide;     // Scaled by g_f4GuideScale
+};
+
+// Data stored for the kernel
+struct KernelData
+{
+    float fWeight;
+    float fWeightSum;
+    float4 f4CenterGuide;
+};
+
+
+//--------------------------------------------------------------------------------------
+// LDS definition and access macros. The guide is scaled, so is kept as halves at the
+// reduced precisions.
+//--------------------------------------------------------------------------------------
+#ifdef USE_COMPUTE_SHADER
+
+    #if( LDS_PRECISION == 32 )
+
+        struct LDS_Layout
+        {
+            float4  f4Color;
+            float4  f4Guide;
+        };
+    
+        groupshared struct
+        {
+            LDS_Layout Item[RUN_LINES][RUN_SIZE_PLUS_KERNEL];
+        }g_LDS;
+
+        #define WRITE_TO_LDS( _RAWDataItem, _iLineOffset, _iPixelOffset ) \
+            g_LDS.Item[_iLineOffset][_iPixelOffset].f4Color = _RAWDataItem.f4Color; \
+            g_LDS.Item[_iLineOffset][_iPixelOffset].f4Guide = _RAWDataItem.f4Guide;
+            
+        #define READ_FROM_LDS( _iLineOffset, _iPixelOffset, _RAWDataItem ) \
+            _RAWDataItem.f4Color = g_LDS.Item[_iLineOffset][_iPixelOffset].f4Color; \
+            _RAWDataItem.f4Guide = g_LDS.Item[_iLineOffset][_iPixelOffset].f4Guide;
+            
+    #elif( LDS_PRECISION == 16 )
+
+        struct LDS_Layout
+        {
+            uint2   u2Color;
+            uint2   u2Guide;
+        };
+    
+        groupshared struct
+        {
+            LDS_Layout Item[RUN_LINES][RUN_SIZE_PLUS_KERNEL];
+        }g_LDS;
+
+        #define WRITE_TO_LDS( _RAWDataItem, _iLineOffset, _iPixelOffset ) \
+            g_LDS.Item[_iLineOffset][_iPixelOffset].u2Color = uint2( Float2ToUint( _RAWDataItem.f4Color.xy ), Float2ToUint( _RAWDataItem.f4Color.zw ) ); \
+            g_LDS.Item[_iLineOffset][_iPixelOffset].u2Guide = f32tof16( _RAWDataItem.f4Guide.xz ) + ( f32tof16( _RAWDataItem.f4Guide.yw ) << 16 );
+            
+        #define READ_FROM_LDS( _iLineOffset, _iPixelOffset, _RAWDataItem ) \
+            _RAWDataItem.f4Color = float4( UintToFloat2( g_LDS.Item[_iLineOffset][_iPixelOffset].u2Color.x ), UintToFloat2( g_LDS.Item[_iLineOffset][_iPixelOffset].u2Color.y ) ); \
+            _RAWDataItem.f4Guide.xz = f16tof32( g_LDS.Item[_iLineOffset][_iPixelOffset].u2Guide ); \
+            _RAWDataItem.f4Guide.yw = f16tof32( g_LDS.Item[_iLineOffset][_iPixelOffset].u2Guide >> 16 );
+                        
+    #else //( LDS_PRECISION == 8 )
+
+        struct LDS_Layout
+        {
+            uint    uColor;
+            uint2   u2Guide;
+        };
+    
+        groupshared struct
+        {
+            LDS_Layout Item[RUN_LINES][RUN_SIZE_PLUS_KERNEL];
+        }g_LDS;
+
+        #define WRITE_TO_LDS( _RAWDataItem, _iLineOffset, _iPixelOffset ) \
+            g_LDS.Item[_iLineOffset][_iPixelOffset].uColor = Float4ToUint( _RAWDataItem.f4Color ); \
+            g_LDS.Item[_iLineOffset][_iPixelOffset].u2Guide = f32tof16( _RAWDataItem.f4Guide.xz ) + ( f32tof16( _RAWDataItem.f4Guide.yw ) << 16 );
+            
+        #define READ_FROM_LDS( _iLineOffset, _iPixelOffset, _RAWDataItem ) \
+            _RAWDataItem.f4Color = UintToFloat4( g_LDS.Item[_iLineOffset][_iPixelOffset].uColor ); \
+            _RAWDataItem.f4Guide.xz = f16tof32( g_LDS.Item[_iLineOffset][_iPixelOffset].u2Guide ); \
+            _RAWDataItem.f4Guide.yw = f16tof32( g_LDS.Item[_iLineOffset][_iPixelOffset].u2Guide >> 16 );
+
+    #endif
+
+#endif
+
+
+//--------------------------------------------------------------------------------------
+// Get a Gaussian weight. The iterations are unrolled, so these fold to constants.
+//--------------------------------------------------------------------------------------
+#define GAUSSIAN_WEIGHT( _fX, _fDeviation, _fWeight ) \
+    _fWeight = 1.0f / sqrt( 2.0f * PI * _fDeviation * _fDeviation ); \
+    _fWeight *= exp( -( _fX * _fX ) / ( 2.0f * _fDeviation * _fDeviation ) ); 
+
+
+//--------------------------------------------------------------------------------------
+// Get the range weight of a tap, from the nearest entry of the table
+//--------------------------------------------------------------------------------------
+float RangeWeight( float4 f4GuideDelta )
+{
+    uint uIndex = (uint)min( dot( f4GuideDelta, f4GuideDelta ) * RANGE_TABLE_SCALE + 0.5f, RANGE_TABLE_SIZE - 1.0f );
+
+    return g_f4RangeWeights[uIndex / 4][uIndex % 4];
+}
+    
+
+//--------------------------------------------------------------------------------------
+// Sample from chosen input(s)
+//--------------------------------------------------------------------------------------
+#if ( GUIDE_IS_DEPTH == 1 )
+
+    #define SAMPLE_GUIDE( _Sampler, _f2SamplePosition ) \
+        float4( -g_f4ProjParams.x / ( g_txGuide.SampleLevel( _Sampler, _f2SamplePosition, 0 ).x - g_f4ProjParams.y ), 0.0f, 0.0f, 0.0f )
+
+#else
+
+    #define SAMPLE_GUIDE( _Sampler, _f2SamplePosition ) \
+        g_txGuide.SampleLevel( _Sampler, _f2SamplePosition, 0 )
+
+#endif
+
+#define SAMPLE_FROM_INPUT( _Sampler, _f2SamplePosition, _RAWDataItem ) \
+    _RAWDataItem.f4Color = g_txInput.SampleLevel( _Sampler, _f2SamplePosition, 0 ); \
+    _RAWDataItem.f4Guide = SAMPLE_GUIDE( _Sampler, _f2SamplePosition ) * g_f4GuideScale;
+
+
+//--------------------------------------------------------------------------------------
+// Compute what happens at the kernels center 
+//--------------------------------------------------------------------------------------
+#define KERNEL_CENTER( _KernelData, _iPixel, _iNumPixels, _O, _RAWDataItem ) \
+    [unroll] for( _iPixel = 0; _iPixel < _iNumPixels; ++_iPixel ) { \
+        GAUSSIAN_WEIGHT( 0, GAUSSIAN_DEVIATION, _KernelData[_iPixel].fWeight ) \
+        _KernelData[_iPixel].fWeight *= g_f4RangeWeights[0].x; \
+        _KernelData[_iPixel].f4CenterGuide = _RAWDataItem[_iPixel].f4Guide; \
+        _KernelData[_iPixel].fWeightSum = _KernelData[_iPixel].fWeight; \
+        _O.f4Color[_iPixel] = _RAWDataItem[_iPixel].f4Color * _KernelData[_iPixel].fWeight; }     
+        
+
+//--------------------------------------------------------------------------------------
+// Compute what happens for each iteration of the kernel 
+//--------------------------------------------------------------------------------------
+#define KERNEL_ITERATION( _iIteration, _KernelData, _iPixel, _iNumPixels, _O, _RAWDataItem ) \
+    [unroll] for( _iPixel = 0; _iPixel < _iNumPixels; ++_iPixel ) { \
+        GAUSSIAN_WEIGHT( ( _iIteration - KERNEL_RADIUS + ( 1.0f - 1.0f / float( STEP_SIZE ) ) ), GAUSSIAN_DEVIATION, _KernelData[_iPixel].fWeight ) \
+        _KernelData[_iPixel].fWeight *= RangeWeight( _RAWDataItem[_iPixel].f4Guide - _KernelData[_iPixel].f4CenterGuide ); \
+        _KernelData[_iPixel].fWeightSum += _KernelData[_iPixel].fWeight; \
+        _O.f4Color[_iPixel] += _RAWDataItem[_iPixel].f4Color * _KernelData[_iPixel].fWeight; }
+        
+
+//--------------------------------------------------------------------------------------
+// Perform final weighting operation 
+//--------------------------------------------------------------------------------------
+#define KERNEL_FINAL_WEIGHT( _KernelData, _iPixel, _iNumPixels, _O ) \
+    [unroll] for( _iPixel = 0; _iPixel < _iNumPixels; ++_iPixel ) { \
+        _O.f4Color[_iPixel] /= _KernelData[_iPixel].fWeightSum; }
+                
+
+//--------------------------------------------------------------------------------------
+// Output to chosen UAV 
+//--------------------------------------------------------------------------------------
+#define KERNEL_OUTPUT( _i2Center, _i2Inc, _iPixel, _iNumPixels, _O, _KernelData ) \
+    [unroll] for( _iPixel = 0; _iPixel < _iNumPixels; ++_iPixel ) \
+        g_uavOutput[_i2Center + _iPixel * _i2Inc] = _O.f4Color[_iPixel];
+
+
+//--------------------------------------------------------------------------------------
+// Include the filter kernel logic that uses the above macros
+//--------------------------------------------------------------------------------------
+#include "..\\..\\..\\AMD_LIB\\src\\Shaders\\SeparableFilter\\FilterKernel.hlsl"
+#include "..\\..\\..\\AMD_LIB\\src\\Shaders\\SeparableFilter\\HorizontalFilter.hlsl"
+#include "..\\..\\..\\AMD_LIB\\src\\Shaders\\SeparableFilter\\VerticalFilter.hlsl"
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
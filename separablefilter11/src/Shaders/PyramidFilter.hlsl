@@ -0,0 +1,86 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: PyramidFilter.hlsl
+//
+// Implements the downsample and upsample passes of the pyramid used for Gaussians wider
+// than the kernels, the GPU equivalents of CPUFilter::PyramidDownsample and
+// CPUFilter::PyramidUpsample.
+//--------------------------------------------------------------------------------------
+
+
+// Size of the level sampled by a pass
+cbuffer cbPyramid : register( b4 )
+{
+    float4 g_f4InputSize;   // ( [0] = Width, [1] = Height, [2] = Inv Width, [3] = Inv Height )
+}
+
+// The input texture
+Texture2D g_txInput : register( t0 );
+
+// Samplers
+SamplerState g_LinearClampSampler : register( s0 );
+
+// Input structure used by the screen quad PS
+struct PS_RenderQuadInput
+{
+    float4 f4Position : SV_POSITION;
+    float2 f2TexCoord : TEXCOORD0;
+};
+
+
+//--------------------------------------------------------------------------------------
+// Fused blur and decimate: output texel i is centered between input texels 2i and 2i+1.
+// A bilinear sample 0.75 texels either side of that blends the texels 1:3 and 3:1, so the
+// 4 samples weight the 4 x 4 texels around the center by the [1 3 3 1] / 8 binomial.
+//--------------------------------------------------------------------------------------
+float4 PSPyramidDownsample( PS_RenderQuadInput I ) : SV_TARGET
+{
+    float2 f2Center = I.f4Position.xy * 2.0f * g_f4InputSize.zw;
+    float2 f2Offset = 0.75f * g_f4InputSize.zw;
+
+    float4 f4Output = g_txInput.SampleLevel( g_LinearClampSampler, f2Center + float2( -f2Offset.x, -f2Offset.y ), 0 );
+    f4Output += g_txInput.SampleLevel( g_LinearClampSampler, f2Center + float2( f2Offset.x, -f2Offset.y ), 0 );
+    f4Output += g_txInput.SampleLevel( g_LinearClampSampler, f2Center + float2( -f2Offset.x, f2Offset.y ), 0 );
+    f4Output += g_txInput.SampleLevel( g_LinearClampSampler, f2Center + float2( f2Offset.x, f2Offset.y ), 0 );
+
+    return f4Output * 0.25f;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Bilinear upsample by 2: output texel x lies at coarse texel x / 2 - 1/4, which puts it
+// half the output texel's position across the coarse level, whatever the sizes
+//--------------------------------------------------------------------------------------
+float4 PSPyramidUpsample( PS_RenderQuadInput I ) : SV_TARGET
+{
+    float2 f2TexCoord = I.f4Position.xy * 0.5f * g_f4InputSize.zw;
+
+    return g_txInput.SampleLevel( g_LinearClampSampler, f2TexCoord, 0 );
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,234 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: CPUFilterTest.cpp
+//
+// Console test for the CPU filters. Runs every test, prints a line per failure, and
+// returns the number of failures.
+//
+// Builds from the CPUFilterTest project, or on its own from this directory with:
+//   g++ -O2 -std=c++11 -pthread -I../src *.cpp ../src/CPU/*.cpp
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+using namespace CPUFilter;
+
+
+static int s_iNumFailures = 0;
+static unsigned int s_uSeed = 1;
+
+
+//--------------------------------------------------------------------------------------
+// Linear congruential generator, taking the top 24 bits
+//--------------------------------------------------------------------------------------
+float Random()
+{
+    s_uSeed = s_uSeed * 1664525u + 1013904223u;
+
+    return (float)( s_uSeed >> 8 ) / (float)0xffffff;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Fills the given texels with random colors and an opaque alpha
+//--------------------------------------------------------------------------------------
+void FillRandom( Surface& Dest, int iLeft, int iTop, int iRight, int iBottom )
+{
+    iLeft = ( iLeft < 0 ) ? 0 : iLeft;
+    iTop = ( iTop < 0 ) ? 0 : iTop;
+    iRight = ( iRight > (int)Dest.m_uWidth ) ? (int)Dest.m_uWidth : iRight;
+    iBottom = ( iBottom > (int)Dest.m_uHeight ) ? (int)Dest.m_uHeight : iBottom;
+
+    for( int iY = iTop; iY < iBottom; iY++ )
+    {
+        for( int iX = iLeft; iX < iRight; iX++ )
+        {
+            Dest.Row( iY )[iX] = MakeFloat4( Random(), Random(), Random(), 1.0f );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Largest difference over all channels of two surfaces of the same size
+//--------------------------------------------------------------------------------------
+float MaxDifference( const Surface& A, const Surface& B )
+{
+    float fMax = 0.0f;
+
+    for( unsigned int uY = 0; uY < A.m_uHeight; uY++ )
+    {
+        for( unsigned int uX = 0; uX < A.m_uWidth; uX++ )
+        {
+            const Float4& a = A.Row( uY )[uX];
+            const Float4& b = B.Row( uY )[uX];
+            const float fDiffs[4] = { fabsf( a.x - b.x ), fabsf( a.y - b.y ), fabsf( a.z - b.z ), fabsf( a.w - b.w ) };
+
+            for( int i = 0; i < 4; i++ )
+            {
+                // Written so that a NaN counts as the largest difference
+                fMax = ( fDiffs[i] <= fMax ) ? fMax : ( ( fDiffs[i] == fDiffs[i] ) ? fDiffs[i] : FLT_MAX );
+            }
+        }
+    }
+
+    return fMax;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Bitwise comparison of two surfaces of the same size
+//--------------------------------------------------------------------------------------
+bool IsIdentical( const Surface& A, const Surface& B )
+{
+    for( unsigned int uY = 0; uY < A.m_uHeight; uY++ )
+    {
+        if( memcmp( A.Row( uY ), B.Row( uY ), sizeof( Float4 ) * A.m_uWidth ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Prints a failure, with the description and any details
+//--------------------------------------------------------------------------------------
+static void Fail( const char* pFormat, va_list Args, const char* pDetails, float fDetail0, float fDetail1 )
+{
+    printf( "FAIL " );
+    vprintf( pFormat, Args );
+    if( pDetails )
+    {
+        printf( pDetails, fDetail0, fDetail1 );
+    }
+    printf( "\n" );
+
+    s_iNumFailures++;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Records a failure if the check doesn't hold
+//--------------------------------------------------------------------------------------
+bool Check( bool bPassed, const char* pFormat, ... )
+{
+    if( !bPassed )
+    {
+        va_list Args;
+        va_start( Args, pFormat );
+        Fail( pFormat, Args, NULL, 0.0f, 0.0f );
+        va_end( Args );
+    }
+
+    return bPassed;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Records a failure if the error is over the tolerance, or NaN
+//--------------------------------------------------------------------------------------
+bool CheckError( float fError, float fTolerance, const char* pFormat, ... )
+{
+    const bool bPassed = ( fError <= fTolerance );
+
+    if( !bPassed )
+    {
+        va_list Args;
+        va_start( Args, pFormat );
+        Fail( pFormat, Args, ": error %g over %g", fError, fTolerance );
+        va_end( Args );
+    }
+
+    return bPassed;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Records a failure if the two surfaces differ in any bit
+//--------------------------------------------------------------------------------------
+bool CheckIdentical( const Surface& A, const Surface& B, const char* pFormat, ... )
+{
+    const bool bPassed = IsIdentical( A, B );
+
+    if( !bPassed )
+    {
+        va_list Args;
+        va_start( Args, pFormat );
+        Fail( pFormat, Args, ": differs by up to %g", MaxDifference( A, B ), 0.0f );
+        va_end( Args );
+    }
+
+    return bPassed;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Entry point
+//--------------------------------------------------------------------------------------
+int main()
+{
+    TestHookFilter();
+    TestGaussianSIMD();
+    TestTileScheduler();
+    TestBilateralSIMD();
+    TestGaussianFixed();
+    TestGaussianDeviation();
+    TestGaussianApproximate();
+    TestLDSPrecision();
+    TestHalfFloat();
+    TestRecursiveGaussian();
+    TestBoxFilter();
+    TestSummedAreaTable();
+    TestGaussianPyramid();
+    TestDualFilter();
+    TestOutOfCore();
+    TestSeparableFilterBatch();
+    TestPlanarGaussian();
+    TestGaussianFixedPoint();
+    TestApronSurface();
+    TestDirtyRects();
+    TestTileHashing();
+    TestBilateralGather();
+    TestJointBilateral();
+
+    printf( "%s: %d failures\n", s_iNumFailures ? "FAILED" : "PASSED", s_iNumFailures );
+
+    return s_iNumFailures;
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,91 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: CPUFilterTest.h
+//
+// Declares the helpers shared by the tests of the CPU filters, and the tests themselves.
+// Each test compares a filter against a reference, and records a failure for each case
+// whose error is over its tolerance.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "CPU/FilterCommon.h"
+
+
+//--------------------------------------------------------------------------------------
+// Helpers, implemented in CPUFilterTest.cpp
+//--------------------------------------------------------------------------------------
+
+// Deterministic random number in [0, 1], so failures reproduce across compilers
+float Random();
+
+// Fills the given texels with random colors and an opaque alpha, clipped to the surface
+void FillRandom( CPUFilter::Surface& Dest, int iLeft, int iTop, int iRight, int iBottom );
+
+// Largest difference over all channels of two surfaces of the same size
+float MaxDifference( const CPUFilter::Surface& A, const CPUFilter::Surface& B );
+
+// Bitwise comparison of two surfaces of the same size
+bool IsIdentical( const CPUFilter::Surface& A, const CPUFilter::Surface& B );
+
+// Record a failure, described by the printf style format, if the check doesn't hold
+bool Check( bool bPassed, const char* pFormat, ... );
+bool CheckError( float fError, float fTolerance, const char* pFormat, ... );
+bool CheckIdentical( const CPUFilter::Surface& A, const CPUFilter::Surface& B, const char* pFormat, ... );
+
+
+//--------------------------------------------------------------------------------------
+// Tests, each in its own file
+//--------------------------------------------------------------------------------------
+void TestHookFilter();
+void TestGaussianSIMD();
+void TestTileScheduler();
+void TestBilateralSIMD();
+void TestGaussianFixed();
+void TestGaussianDeviation();
+void TestGaussianApproximate();
+void TestLDSPrecision();
+void TestHalfFloat();
+void TestRecursiveGaussian();
+void TestBoxFilter();
+void TestSummedAreaTable();
+void TestGaussianPyramid();
+void TestDualFilter();
+void TestOutOfCore();
+void TestSeparableFilterBatch();
+void TestPlanarGaussian();
+void TestGaussianFixedPoint();
+void TestApronSurface();
+void TestDirtyRects();
+void TestTileHashing();
+void TestBilateralGather();
+void TestJointBilateral();
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
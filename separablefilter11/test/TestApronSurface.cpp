@@ -0,0 +1,316 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestApronSurface.cpp
+//
+// Tests the filling of the aprons in each border mode, and the Gaussian passes reading
+// them against the clamped passes on an image padded out with the same border.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/GaussianFilterSIMD.h"
+#include "CPU/ApronSurface.h"
+#include "CPU/CPUInfo.h"
+
+#include <string.h>
+#include <math.h>
+
+using namespace CPUFilter;
+
+
+// The padded image is filtered by the same kernels, only addressed differently
+static const float s_fTolerance = 1e-6f;
+
+static const char* s_pBorderModeNames[BORDER_MODE_TYPE_MAX] = { "clamp", "mirror", "wrap", "constant" };
+
+
+//--------------------------------------------------------------------------------------
+// The texel a coordinate beyond the edges reads, worked out by reflecting or shifting it
+// back one period at a time, rather than by the closed forms of BorderTexel
+//--------------------------------------------------------------------------------------
+static int ReferenceBorderTexel( BORDER_MODE_TYPE BorderMode, int iCoord, int iSize )
+{
+    while( iCoord < 0 || iCoord >= iSize )
+    {
+        if( BORDER_MODE_TYPE_MIRROR == BorderMode )
+        {
+            iCoord = ( iCoord < 0 ) ? ( -1 - iCoord ) : ( 2 * iSize - 1 - iCoord );
+        }
+        else if( BORDER_MODE_TYPE_WRAP == BorderMode )
+        {
+            iCoord += ( iCoord < 0 ) ? iSize : -iSize;
+        }
+        else
+        {
+            iCoord = ( iCoord < 0 ) ? 0 : ( iSize - 1 );
+        }
+    }
+
+    return iCoord;
+}
+
+
+//--------------------------------------------------------------------------------------
+// The texel of Source at a coordinate beyond its edges, in a border mode
+//--------------------------------------------------------------------------------------
+static Float4 ReferenceTexel( const Surface& Source, BORDER_MODE_TYPE BorderMode, const Float4& BorderColor, int iX, int iY )
+{
+    if( BORDER_MODE_TYPE_CONSTANT == BorderMode )
+    {
+        const bool bInside = iX >= 0 && iX < (int)Source.m_uWidth && iY >= 0 && iY < (int)Source.m_uHeight;
+        return bInside ? Source.Row( iY )[iX] : BorderColor;
+    }
+
+    return Source.Row( ReferenceBorderTexel( BorderMode, iY, (int)Source.m_uHeight ) )[ReferenceBorderTexel( BorderMode, iX, (int)Source.m_uWidth )];
+}
+
+
+//--------------------------------------------------------------------------------------
+// Every texel of the apron in every mode, with aprons wider than the surface, so mirror
+// and wrap go round more than one period
+//--------------------------------------------------------------------------------------
+static void TestFillApron()
+{
+    static const unsigned int uWidths[] = { 13, 1, 3 };
+    static const unsigned int uHeights[] = { 7, 4, 1 };
+    static const int iAprons[] = { 1, 5, 9 };
+    const Float4 BorderColor = MakeFloat4( 0.25f, -1.0f, 3.0f, 0.5f );
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        Surface Source;
+        Source.Create( uWidths[iSize], uHeights[iSize] );
+        FillRandom( Source, 0, 0, (int)uWidths[iSize], (int)uHeights[iSize] );
+
+        for( int iApron = 0; iApron < (int)( sizeof( iAprons ) / sizeof( iAprons[0] ) ); iApron++ )
+        {
+            const int iApronSize = iAprons[iApron];
+
+            ApronSurface Apron;
+            Apron.Create( uWidths[iSize], uHeights[iSize], iApronSize );
+            Apron.CopyFrom( Source );
+
+            for( int iMode = 0; iMode < BORDER_MODE_TYPE_MAX; iMode++ )
+            {
+                const BORDER_MODE_TYPE BorderMode = (BORDER_MODE_TYPE)iMode;
+                Apron.FillApron( BorderMode, BorderColor );
+
+                int iNumWrong = 0;
+                for( int iY = -iApronSize; iY < (int)uHeights[iSize] + iApronSize; iY++ )
+                {
+                    for( int iX = -iApronSize; iX < (int)uWidths[iSize] + iApronSize; iX++ )
+                    {
+                        const Float4 Expected = ReferenceTexel( Source, BorderMode, BorderColor, iX, iY );
+                        iNumWrong += ( 0 != memcmp( &Expected, &Apron.Row( iY )[iX], sizeof( Float4 ) ) ) ? 1 : 0;
+                    }
+                }
+
+                Check( 0 == iNumWrong, "Apron %s %ux%u apron %d has %d wrong texels", s_pBorderModeNames[iMode], uWidths[iSize], uHeights[iSize], iApronSize,
+                    iNumWrong );
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Largest difference between the output, and the texels of the padded output inside the
+// padding
+//--------------------------------------------------------------------------------------
+static float MaxPaddedDifference( const Surface& Output, const Surface& Padded, int iPadding )
+{
+    float fMaxDifference = 0.0f;
+
+    for( unsigned int uY = 0; uY < Output.m_uHeight; uY++ )
+    {
+        for( unsigned int uX = 0; uX < Output.m_uWidth; uX++ )
+        {
+            const float* pA = &Output.Row( uY )[uX].x;
+            const float* pB = &Padded.Row( uY + iPadding )[uX + iPadding].x;
+
+            for( int iChannel = 0; iChannel < 4; iChannel++ )
+            {
+                const float fDifference = fabsf( pA[iChannel] - pB[iChannel] );
+                fMaxDifference = ( fDifference > fMaxDifference ) ? fDifference : fMaxDifference;
+            }
+        }
+    }
+
+    return fMaxDifference;
+}
+
+
+//--------------------------------------------------------------------------------------
+// The separate and fused passes reading aprons, in every mode and on every ISA, against the
+// clamped separate passes on the image padded with the border by the kernel radius. The
+// clamped passes never reach the edges of the padding for the texels compared, so only the
+// edges of the image are affected by the border mode. Clamp is also compared bit for bit
+// against the clamped passes on the image itself.
+//--------------------------------------------------------------------------------------
+static void TestBorderModes()
+{
+    static const unsigned int uWidths[] = { 97, 5 };
+    static const unsigned int uHeights[] = { 61, 9 };
+    static const int iRadii[] = { 3, 20 };
+    const Float4 BorderColor = MakeFloat4( 0.75f, 0.0f, 2.0f, 1.0f );
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        const unsigned int uWidth = uWidths[iSize];
+        const unsigned int uHeight = uHeights[iSize];
+
+        Surface Input, Temp, Output, Clamped;
+        Input.Create( uWidth, uHeight );
+        Temp.Create( uWidth, uHeight );
+        Output.Create( uWidth, uHeight );
+        Clamped.Create( uWidth, uHeight );
+        FillRandom( Input, 0, 0, (int)uWidth, (int)uHeight );
+
+        for( int iRadius = 0; iRadius < (int)( sizeof( iRadii ) / sizeof( iRadii[0] ) ); iRadius++ )
+        {
+            const int iKernelRadius = iRadii[iRadius];
+            const unsigned int uPaddedWidth = uWidth + 2 * iKernelRadius;
+            const unsigned int uPaddedHeight = uHeight + 2 * iKernelRadius;
+
+            Surface Padded, PaddedTemp, PaddedOutput;
+            Padded.Create( uPaddedWidth, uPaddedHeight );
+            PaddedTemp.Create( uPaddedWidth, uPaddedHeight );
+            PaddedOutput.Create( uPaddedWidth, uPaddedHeight );
+
+            ApronSurface ApronInput, ApronIntermediate;
+            ApronInput.Create( uWidth, uHeight, iKernelRadius );
+            ApronIntermediate.Create( uWidth, uHeight, iKernelRadius );
+
+            for( int iISA = 0; iISA < ISA_TYPE_MAX; iISA++ )
+            {
+                if( !GetCPUInfo().m_bSupportsISA[iISA] )
+                {
+                    continue;
+                }
+
+                const char* pISAName = GetISAName( (ISA_TYPE)iISA );
+
+                GaussianFilterX FilterX;
+                GaussianFilterY FilterY;
+                FilterX.SetISA( (ISA_TYPE)iISA );
+                FilterY.SetISA( (ISA_TYPE)iISA );
+                FilterX.SetKernel( iKernelRadius, false );
+                FilterY.SetKernel( iKernelRadius, false );
+
+                // The clamped passes on the image itself
+                const Surface* pInputs[1] = { &Input };
+                const Surface* pIntermediates[1] = { &Temp };
+
+                SeparableFilterCPU ClampedFilter;
+                ClampedFilter.SetFilters( &FilterX, &FilterY );
+                ClampedFilter.SetOutputSize( uWidth, uHeight );
+                ClampedFilter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+                ClampedFilter.SetOutputSurfaces( &Temp, &Clamped );
+                ClampedFilter.OnRender();
+
+                for( int iMode = 0; iMode < BORDER_MODE_TYPE_MAX; iMode++ )
+                {
+                    const BORDER_MODE_TYPE BorderMode = (BORDER_MODE_TYPE)iMode;
+
+                    for( unsigned int uY = 0; uY < uPaddedHeight; uY++ )
+                    {
+                        for( unsigned int uX = 0; uX < uPaddedWidth; uX++ )
+                        {
+                            Padded.Row( uY )[uX] = ReferenceTexel( Input, BorderMode, BorderColor, (int)uX - iKernelRadius, (int)uY - iKernelRadius );
+                        }
+                    }
+
+                    const Surface* pPaddedInputs[1] = { &Padded };
+                    const Surface* pPaddedIntermediates[1] = { &PaddedTemp };
+
+                    SeparableFilterCPU PaddedFilter;
+                    PaddedFilter.SetFilters( &FilterX, &FilterY );
+                    PaddedFilter.SetOutputSize( uPaddedWidth, uPaddedHeight );
+                    PaddedFilter.SetInputSurfaces( pPaddedInputs, pPaddedIntermediates, 1 );
+                    PaddedFilter.SetOutputSurfaces( &PaddedTemp, &PaddedOutput );
+                    PaddedFilter.OnRender();
+
+                    for( int iFused = 0; iFused < 2; iFused++ )
+                    {
+                        GaussianFilterX ApronX;
+                        GaussianFilterY ApronY;
+                        GaussianFilterFused ApronFused;
+                        ApronX.SetISA( (ISA_TYPE)iISA );
+                        ApronY.SetISA( (ISA_TYPE)iISA );
+                        ApronFused.SetISA( (ISA_TYPE)iISA );
+                        ApronX.SetKernel( iKernelRadius, false );
+                        ApronY.SetKernel( iKernelRadius, false );
+                        ApronFused.SetKernel( iKernelRadius, false );
+                        ApronX.SetApronInput( &ApronInput );
+                        ApronY.SetApronInput( &ApronIntermediate );
+                        ApronFused.SetApronInput( &ApronInput );
+
+                        // The aprons are refilled by the render, so stale texels from the last mode
+                        // don't matter
+                        ApronInput.CopyFrom( Input );
+                        FillRandom( Output, 0, 0, (int)uWidth, (int)uHeight );
+
+                        const Surface* pNoSurfaces[1] = { NULL };
+
+                        SeparableFilterCPU Filter;
+                        Filter.SetFilters( &ApronX, &ApronY );
+                        Filter.SetFusedFilter( iFused ? &ApronFused : NULL );
+                        Filter.SetOutputSize( uWidth, uHeight );
+                        Filter.SetInputSurfaces( pNoSurfaces, pNoSurfaces, 1 );
+                        Filter.SetOutputSurfaces( NULL, &Output );
+                        Filter.SetApronSurfaces( &ApronInput, iFused ? NULL : &ApronIntermediate );
+                        Filter.SetBorderMode( BorderMode, BorderColor );
+                        Filter.OnRender();
+
+                        CheckError( MaxPaddedDifference( Output, PaddedOutput, iKernelRadius ), s_fTolerance, "Apron %s %s %ux%u radius %d %s",
+                            iFused ? "fused" : "separate", s_pBorderModeNames[iMode], uWidth, uHeight, iKernelRadius, pISAName );
+
+                        if( BORDER_MODE_TYPE_CLAMP == BorderMode && !iFused )
+                        {
+                            CheckIdentical( Clamped, Output, "Apron clamp %ux%u radius %d %s", uWidth, uHeight, iKernelRadius, pISAName );
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Runs the apron surface tests
+//--------------------------------------------------------------------------------------
+void TestApronSurface()
+{
+    TestFillApron();
+    TestBorderModes();
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,194 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestBilateralGather.cpp
+//
+// Tests the variable radius gather filter of the vectorized bilateral passes against the
+// hooks, on lines that are in focus, out of focus, and mixed.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/HorizontalFilter.h"
+#include "CPU/VerticalFilter.h"
+#include "CPU/BilateralFilter.h"
+#include "CPU/BilateralFilterSIMD.h"
+#include "CPU/CPUInfo.h"
+
+#include <math.h>
+
+using namespace CPUFilter;
+
+
+// The passes sum in a different order than the hooks
+static const float s_fTolerance = 2e-6f;
+
+
+//--------------------------------------------------------------------------------------
+// Fills the color, and depth in bands of rows: a near plane entirely in focus, a slope
+// through the focal ramp so the reach varies within each vector, and planes in and out of
+// focus so the lines mix both. bFar puts every sample beyond the ramp instead.
+//--------------------------------------------------------------------------------------
+static void FillInputs( Surface& Color, Surface& Depth, const float* pProjParams, bool bFar )
+{
+    for( unsigned int uY = 0; uY < Color.m_uHeight; uY++ )
+    {
+        for( unsigned int uX = 0; uX < Color.m_uWidth; uX++ )
+        {
+            Color.Row( uY )[uX] = MakeFloat4( sinf( uX * 0.3f ) * 0.5f + 0.5f, cosf( uY * 0.2f ) * 0.5f + 0.5f, ( uX * uY % 7 ) / 7.0f, ( uX % 3 ) * 0.3f );
+
+            float fViewDepth;
+            switch( ( uY / 29 ) % 3 )
+            {
+            case 0:
+                fViewDepth = 5.0f + ( uX % 5 ) * 0.1f;
+                break;
+            case 1:
+                fViewDepth = FOCAL_END - 2.0f + ( uX % 37 ) * 0.25f;
+                break;
+            default:
+                fViewDepth = 5.0f + 20.0f * ( ( uX / 23 + uY / 17 ) % 3 ) + ( uX % 5 ) * 0.1f;
+                break;
+            }
+            if( bFar )
+            {
+                fViewDepth = FOCAL_END + FOCAL_END_RAMP + 10.0f + ( ( uX / 23 + uY / 17 ) % 3 ) * 20.0f;
+            }
+
+            Depth.Row( uY )[uX] = MakeFloat4( pProjParams[1] - pProjParams[0] / fViewDepth, 0.0f, 0.0f, 0.0f );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Renders the SIMD passes on the given instruction set and strip width
+//--------------------------------------------------------------------------------------
+static void RenderSIMD( SeparableFilterCPU& Filter, Surface& Temp, Surface& Output, ISA_TYPE ISA, int iKernelRadius,
+    const float* pProjParams, bool bGather, int iStripWidth )
+{
+    BilateralFilterX FilterX;
+    BilateralFilterY FilterY;
+    FilterX.SetISA( ISA );
+    FilterY.SetISA( ISA );
+    FilterX.SetKernel( iKernelRadius, false );
+    FilterY.SetKernel( iKernelRadius, false );
+    FilterX.SetProjParams( pProjParams );
+    FilterY.SetProjParams( pProjParams );
+    FilterX.SetGather( bGather );
+    FilterY.SetGather( bGather );
+    FilterY.SetStripWidth( iStripWidth );
+
+    Filter.SetOutputSurfaces( &Temp, &Output );
+    Filter.SetFilters( &FilterX, &FilterY );
+    Filter.OnRender();
+}
+
+
+//--------------------------------------------------------------------------------------
+// The gather passes against the gather hooks on every instruction set, and against the
+// passes without gather where every sample is out of focus, so reaches every tap
+//--------------------------------------------------------------------------------------
+void TestBilateralGather()
+{
+    static const unsigned int uWidths[] = { 333, 5, 140 };
+    static const unsigned int uHeights[] = { 211, 300, 3 };
+    static const int iRadii[] = { 1, 4, 13, 32 };
+
+    const float fNear = 0.1f;
+    const float fFar = 125.0f;
+    float fProjParams[4];
+    fProjParams[1] = fFar / ( fFar - fNear );
+    fProjParams[0] = fProjParams[1] * fNear;
+    fProjParams[2] = fProjParams[3] = 0.0f;
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        const unsigned int uWidth = uWidths[iSize];
+        const unsigned int uHeight = uHeights[iSize];
+
+        Surface Color, Depth, Temp, Reference, Output;
+        Color.Create( uWidth, uHeight );
+        Depth.Create( uWidth, uHeight );
+        Temp.Create( uWidth, uHeight );
+        Reference.Create( uWidth, uHeight );
+        Output.Create( uWidth, uHeight );
+
+        const Surface* pInputs[2] = { &Color, &Depth };
+        const Surface* pIntermediates[2] = { &Temp, &Depth };
+
+        SeparableFilterCPU Filter;
+        Filter.SetOutputSize( uWidth, uHeight );
+        Filter.SetInputSurfaces( pInputs, pIntermediates, 2 );
+
+        for( int iRadius = 0; iRadius < (int)( sizeof( iRadii ) / sizeof( iRadii[0] ) ); iRadius++ )
+        {
+            const int iKernelRadius = iRadii[iRadius];
+
+            FillInputs( Color, Depth, fProjParams, false );
+
+            HorizontalFilter< BilateralFilter<PASS_TYPE_HORIZONTAL> > HookX;
+            VerticalFilter< BilateralFilter<PASS_TYPE_VERTICAL> > HookY;
+            HookX.SetKernel( iKernelRadius, false );
+            HookY.SetKernel( iKernelRadius, false );
+            HookX.SetProjParams( fProjParams );
+            HookY.SetProjParams( fProjParams );
+            HookX.SetGather( true );
+            HookY.SetGather( true );
+
+            Filter.SetOutputSurfaces( &Temp, &Reference );
+            Filter.SetFilters( &HookX, &HookY );
+            Filter.OnRender();
+
+            for( int iISA = 0; iISA < ISA_TYPE_MAX; iISA++ )
+            {
+                if( !GetCPUInfo().m_bSupportsISA[iISA] )
+                {
+                    continue;
+                }
+
+                // Strips sized from the caches, and a whole number of vectors
+                static const int iStripWidths[] = { 0, 16 };
+                for( int iStrip = 0; iStrip < (int)( sizeof( iStripWidths ) / sizeof( iStripWidths[0] ) ); iStrip++ )
+                {
+                    RenderSIMD( Filter, Temp, Output, (ISA_TYPE)iISA, iKernelRadius, fProjParams, true, iStripWidths[iStrip] );
+                    CheckError( MaxDifference( Reference, Output ), s_fTolerance, "Bilateral gather %s %ux%u radius %d strip %d",
+                        GetISAName( (ISA_TYPE)iISA ), uWidth, uHeight, iKernelRadius, iStripWidths[iStrip] );
+                }
+            }
+
+            // With every sample out of focus, the gather filter skips nothing
+            FillInputs( Color, Depth, fProjParams, true );
+            RenderSIMD( Filter, Temp, Reference, GetCPUInfo().m_BestISA, iKernelRadius, fProjParams, false, 0 );
+            RenderSIMD( Filter, Temp, Output, GetCPUInfo().m_BestISA, iKernelRadius, fProjParams, true, 0 );
+            CheckError( MaxDifference( Reference, Output ), s_fTolerance, "Bilateral gather out of focus %ux%u radius %d",
+                uWidth, uHeight, iKernelRadius );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
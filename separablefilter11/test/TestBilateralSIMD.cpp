@@ -0,0 +1,155 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestBilateralSIMD.cpp
+//
+// Tests the vectorized bilateral depth of field passes of every instruction set against
+// the hooks.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/HorizontalFilter.h"
+#include "CPU/VerticalFilter.h"
+#include "CPU/BilateralFilter.h"
+#include "CPU/BilateralFilterSIMD.h"
+#include "CPU/CPUInfo.h"
+
+#include <math.h>
+
+using namespace CPUFilter;
+
+
+// The passes sum in a different order than the hooks
+static const float s_fTolerance = 2e-6f;
+
+
+//--------------------------------------------------------------------------------------
+// Fills the color, and a depth buffer of planes at three depths, so the depth weights
+// cut off at the edges between them
+//--------------------------------------------------------------------------------------
+static void FillInputs( Surface& Color, Surface& Depth, const float* pProjParams )
+{
+    for( unsigned int uY = 0; uY < Color.m_uHeight; uY++ )
+    {
+        for( unsigned int uX = 0; uX < Color.m_uWidth; uX++ )
+        {
+            Color.Row( uY )[uX] = MakeFloat4( sinf( uX * 0.3f ) * 0.5f + 0.5f, cosf( uY * 0.2f ) * 0.5f + 0.5f, ( uX * uY % 7 ) / 7.0f, ( uX % 3 ) * 0.3f );
+
+            // A small slope across each plane
+            const float fViewDepth = 5.0f + 20.0f * ( ( uX / 23 + uY / 17 ) % 3 ) + ( uX % 5 ) * 0.1f;
+            Depth.Row( uY )[uX] = MakeFloat4( pProjParams[1] - pProjParams[0] / fViewDepth, 0.0f, 0.0f, 0.0f );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Both passes, on sizes that fill a group, leave a vector partly empty, and are narrower
+// or shorter than the kernel
+//--------------------------------------------------------------------------------------
+void TestBilateralSIMD()
+{
+    static const unsigned int uWidths[] = { 333, 5, 140 };
+    static const unsigned int uHeights[] = { 211, 300, 3 };
+    static const int iRadii[] = { 1, 4, 13, 32 };
+
+    const float fNear = 0.1f;
+    const float fFar = 125.0f;
+    float fProjParams[4];
+    fProjParams[1] = fFar / ( fFar - fNear );
+    fProjParams[0] = fProjParams[1] * fNear;
+    fProjParams[2] = fProjParams[3] = 0.0f;
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        const unsigned int uWidth = uWidths[iSize];
+        const unsigned int uHeight = uHeights[iSize];
+
+        Surface Color, Depth, Temp, Reference, Output;
+        Color.Create( uWidth, uHeight );
+        Depth.Create( uWidth, uHeight );
+        Temp.Create( uWidth, uHeight );
+        Reference.Create( uWidth, uHeight );
+        Output.Create( uWidth, uHeight );
+        FillInputs( Color, Depth, fProjParams );
+
+        const Surface* pInputs[2] = { &Color, &Depth };
+        const Surface* pIntermediates[2] = { &Temp, &Depth };
+
+        SeparableFilterCPU Filter;
+        Filter.SetOutputSize( uWidth, uHeight );
+        Filter.SetInputSurfaces( pInputs, pIntermediates, 2 );
+
+        for( int iRadius = 0; iRadius < (int)( sizeof( iRadii ) / sizeof( iRadii[0] ) ); iRadius++ )
+        {
+            const int iKernelRadius = iRadii[iRadius];
+
+            HorizontalFilter< BilateralFilter<PASS_TYPE_HORIZONTAL> > HookX;
+            VerticalFilter< BilateralFilter<PASS_TYPE_VERTICAL> > HookY;
+            HookX.SetKernel( iKernelRadius, false );
+            HookY.SetKernel( iKernelRadius, false );
+            HookX.SetProjParams( fProjParams );
+            HookY.SetProjParams( fProjParams );
+
+            Filter.SetOutputSurfaces( &Temp, &Reference );
+            Filter.SetFilters( &HookX, &HookY );
+            Filter.OnRender();
+
+            for( int iISA = 0; iISA < ISA_TYPE_MAX; iISA++ )
+            {
+                if( !GetCPUInfo().m_bSupportsISA[iISA] )
+                {
+                    continue;
+                }
+
+                // Strips sized from the caches, and a whole number of vectors
+                static const int iStripWidths[] = { 0, 16 };
+                for( int iStrip = 0; iStrip < (int)( sizeof( iStripWidths ) / sizeof( iStripWidths[0] ) ); iStrip++ )
+                {
+                    BilateralFilterX FilterX;
+                    BilateralFilterY FilterY;
+                    FilterX.SetISA( (ISA_TYPE)iISA );
+                    FilterY.SetISA( (ISA_TYPE)iISA );
+                    FilterX.SetKernel( iKernelRadius, false );
+                    FilterY.SetKernel( iKernelRadius, false );
+                    FilterX.SetProjParams( fProjParams );
+                    FilterY.SetProjParams( fProjParams );
+                    FilterY.SetStripWidth( iStripWidths[iStrip] );
+
+                    Filter.SetOutputSurfaces( &Temp, &Output );
+                    Filter.SetFilters( &FilterX, &FilterY );
+                    Filter.OnRender();
+                    CheckError( MaxDifference( Reference, Output ), s_fTolerance, "Bilateral %s %ux%u radius %d strip %d",
+                        GetISAName( (ISA_TYPE)iISA ), uWidth, uHeight, iKernelRadius, iStripWidths[iStrip] );
+                }
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,280 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestBoxFilter.cpp
+//
+// Tests the box filter cascade: the radii against the variance of the Gaussian, the 8 bit
+// passes bit for bit against an integer cascade, and the float passes against doubles.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/BoxFilter.h"
+
+#include <math.h>
+#include <vector>
+
+using namespace CPUFilter;
+
+
+// The float passes sum in doubles, so only the final conversions differ
+static const float s_fTolerance = 1e-6f;
+
+
+//--------------------------------------------------------------------------------------
+// The variance of the cascade is as close to the deviation squared as moving one box to
+// the next odd width allows
+//--------------------------------------------------------------------------------------
+static void TestRadii()
+{
+    for( int iNumPasses = MIN_BOX_PASSES; iNumPasses <= MAX_BOX_PASSES; iNumPasses++ )
+    {
+        for( int iStep = 0; iStep <= 400; iStep++ )
+        {
+            const float fDeviation = (float)iStep * 0.25f;
+
+            int iRadii[MAX_BOX_PASSES];
+            ComputeBoxRadii( fDeviation, iNumPasses, iRadii );
+
+            // A box of width w has a variance of ( w^2 - 1 ) / 12, and widening the narrowest
+            // box by 2 adds ( w + 1 ) / 3
+            double dVariance = 0.0;
+            int iMinRadius = iRadii[0];
+            int iMaxRadius = iRadii[0];
+            for( int iPass = 0; iPass < iNumPasses; iPass++ )
+            {
+                dVariance += ( 4.0 * iRadii[iPass] * iRadii[iPass] + 4.0 * iRadii[iPass] ) / 12.0;
+                iMinRadius = ( iRadii[iPass] < iMinRadius ) ? iRadii[iPass] : iMinRadius;
+                iMaxRadius = ( iRadii[iPass] > iMaxRadius ) ? iRadii[iPass] : iMaxRadius;
+            }
+            const double dStep = ( 2.0 * iMinRadius + 2.0 ) / 3.0;
+
+            Check( iMaxRadius - iMinRadius <= 1, "Box radii for deviation %g, %d passes span %d to %d", fDeviation, iNumPasses, iMinRadius, iMaxRadius );
+            Check( fabs( dVariance - (double)fDeviation * fDeviation ) <= dStep * 0.5 + 1e-9, "Box radii for deviation %g, %d passes have a variance of %g",
+                fDeviation, iNumPasses, dVariance );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Every box along a line of iCount channels iStride apart, clamped at the ends. 8 bit
+// values are rounded to nearest after each box, which the odd widths never leave a tie
+// for, and floats are kept in doubles.
+//--------------------------------------------------------------------------------------
+static void BoxLine( std::vector<double>& Line, const int* pRadii, int iNumPasses, bool bRound )
+{
+    const int iCount = (int)Line.size();
+    std::vector<double> Source;
+
+    for( int iPass = 0; iPass < iNumPasses; iPass++ )
+    {
+        Source = Line;
+
+        const int iRadius = pRadii[iPass];
+        for( int i = 0; i < iCount; i++ )
+        {
+            double dSum = 0.0;
+            for( int iTap = -iRadius; iTap <= iRadius; iTap++ )
+            {
+                const int iIndex = i + iTap;
+                dSum += Source[( iIndex < 0 ) ? 0 : ( iIndex >= iCount ) ? iCount - 1 : iIndex];
+            }
+            Line[i] = bRound ? floor( dSum / ( 2 * iRadius + 1 ) + 0.5 ) : dSum / ( 2 * iRadius + 1 );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// The cascade along the rows, with an alpha of 1, then down the columns, of a surface of
+// uWidth x uHeight texels held as doubles
+//--------------------------------------------------------------------------------------
+static void BoxReference( std::vector<double>& Texels, unsigned int uWidth, unsigned int uHeight, const int* pRadii, int iNumPasses, bool bRound, double dOne )
+{
+    std::vector<double> Line;
+
+    for( unsigned int uY = 0; uY < uHeight; uY++ )
+    {
+        for( unsigned int uChannel = 0; uChannel < 4; uChannel++ )
+        {
+            Line.resize( uWidth );
+            for( unsigned int uX = 0; uX < uWidth; uX++ )
+            {
+                Line[uX] = ( 3 == uChannel ) ? dOne : Texels[( uY * uWidth + uX ) * 4 + uChannel];
+            }
+            BoxLine( Line, pRadii, iNumPasses, bRound && 3 != uChannel );
+            for( unsigned int uX = 0; uX < uWidth; uX++ )
+            {
+                Texels[( uY * uWidth + uX ) * 4 + uChannel] = ( 3 == uChannel ) ? dOne : Line[uX];
+            }
+        }
+    }
+
+    for( unsigned int uX = 0; uX < uWidth * 4; uX++ )
+    {
+        Line.resize( uHeight );
+        for( unsigned int uY = 0; uY < uHeight; uY++ )
+        {
+            Line[uY] = Texels[uY * uWidth * 4 + uX];
+        }
+        BoxLine( Line, pRadii, iNumPasses, bRound );
+        for( unsigned int uY = 0; uY < uHeight; uY++ )
+        {
+            Texels[uY * uWidth * 4 + uX] = Line[uY];
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// The passes on 8 bit and float surfaces, against the reference cascades
+//--------------------------------------------------------------------------------------
+static void TestPasses()
+{
+    static const unsigned int uWidths[] = { 213, 5, 300 };
+    static const unsigned int uHeights[] = { 97, 300, 2 };
+    static const float fDeviations[] = { 0.5f, 2.0f, 7.0f, 30.0f, 120.0f };
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        const unsigned int uWidth = uWidths[iSize];
+        const unsigned int uHeight = uHeights[iSize];
+
+        Surface Input, Temp, Output, Reference;
+        SurfaceUNorm8 Input8, Temp8, Output8;
+        Input.Create( uWidth, uHeight );
+        Temp.Create( uWidth, uHeight );
+        Output.Create( uWidth, uHeight );
+        Reference.Create( uWidth, uHeight );
+        Input8.Create( uWidth, uHeight );
+        Temp8.Create( uWidth, uHeight );
+        Output8.Create( uWidth, uHeight );
+        FillRandom( Input, 0, 0, uWidth, uHeight );
+
+        for( unsigned int uY = 0; uY < uHeight; uY++ )
+        {
+            for( unsigned int uChannel = 0; uChannel < uWidth * 4; uChannel++ )
+            {
+                Input8.Row( uY )[uChannel] = (unsigned char)( Random() * 255.0f + 0.5f );
+            }
+        }
+
+        const Surface* pInputs[1] = { &Input };
+        const Surface* pIntermediates[1] = { &Temp };
+
+        SeparableFilterCPU Filter;
+        Filter.SetOutputSize( uWidth, uHeight );
+        Filter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+
+        for( int iNumPasses = MIN_BOX_PASSES; iNumPasses <= MAX_BOX_PASSES; iNumPasses++ )
+        {
+            for( int iDeviation = 0; iDeviation < (int)( sizeof( fDeviations ) / sizeof( fDeviations[0] ) ); iDeviation++ )
+            {
+                BoxFilterX FilterX;
+                BoxFilterY FilterY;
+                FilterX.SetDeviation( fDeviations[iDeviation] );
+                FilterY.SetDeviation( fDeviations[iDeviation] );
+                FilterX.SetNumPasses( iNumPasses );
+                FilterY.SetNumPasses( iNumPasses );
+                Filter.SetFilters( &FilterX, &FilterY );
+
+                int iRadii[MAX_BOX_PASSES];
+                for( int iPass = 0; iPass < iNumPasses; iPass++ )
+                {
+                    iRadii[iPass] = FilterX.GetBoxRadius( iPass );
+                }
+
+                // 8 bit, bit for bit
+                std::vector<double> Texels( (size_t)uWidth * uHeight * 4 );
+                for( unsigned int uY = 0; uY < uHeight; uY++ )
+                {
+                    for( unsigned int uChannel = 0; uChannel < uWidth * 4; uChannel++ )
+                    {
+                        Texels[uY * uWidth * 4 + uChannel] = Input8.Row( uY )[uChannel];
+                    }
+                }
+                BoxReference( Texels, uWidth, uHeight, iRadii, iNumPasses, true, 255.0 );
+
+                FilterX.SetUNorm8Surfaces( &Input8, &Temp8 );
+                FilterY.SetUNorm8Surfaces( &Temp8, &Output8 );
+                Filter.SetOutputSurfaces( NULL, NULL );
+                Filter.OnRender();
+
+                int iMismatches = 0;
+                for( unsigned int uY = 0; uY < uHeight; uY++ )
+                {
+                    for( unsigned int uChannel = 0; uChannel < uWidth * 4; uChannel++ )
+                    {
+                        iMismatches += ( (double)Output8.Row( uY )[uChannel] != Texels[uY * uWidth * 4 + uChannel] ) ? 1 : 0;
+                    }
+                }
+                Check( 0 == iMismatches, "Box cascade 8 bit %ux%u deviation %g, %d passes has %d mismatches",
+                    uWidth, uHeight, fDeviations[iDeviation], iNumPasses, iMismatches );
+
+                // Float
+                for( unsigned int uY = 0; uY < uHeight; uY++ )
+                {
+                    for( unsigned int uChannel = 0; uChannel < uWidth * 4; uChannel++ )
+                    {
+                        Texels[uY * uWidth * 4 + uChannel] = ( &Input.Row( uY )->x )[uChannel];
+                    }
+                }
+                BoxReference( Texels, uWidth, uHeight, iRadii, iNumPasses, false, 1.0 );
+                for( unsigned int uY = 0; uY < uHeight; uY++ )
+                {
+                    for( unsigned int uChannel = 0; uChannel < uWidth * 4; uChannel++ )
+                    {
+                        ( &Reference.Row( uY )->x )[uChannel] = (float)Texels[uY * uWidth * 4 + uChannel];
+                    }
+                }
+
+                FilterX.SetUNorm8Surfaces( NULL, NULL );
+                FilterY.SetUNorm8Surfaces( NULL, NULL );
+                FillRandom( Output, 0, 0, uWidth, uHeight );
+                Filter.SetOutputSurfaces( &Temp, &Output );
+                Filter.OnRender();
+                CheckError( MaxDifference( Reference, Output ), s_fTolerance, "Box cascade float %ux%u deviation %g, %d passes",
+                    uWidth, uHeight, fDeviations[iDeviation], iNumPasses );
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Runs the box filter tests
+//--------------------------------------------------------------------------------------
+void TestBoxFilter()
+{
+    TestRadii();
+    TestPasses();
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
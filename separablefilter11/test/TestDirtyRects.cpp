@@ -0,0 +1,517 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestDirtyRects.cpp
+//
+// Tests that re-filtering only the dirty rectangles of an edited input gives the same
+// output, bit for bit, as filtering it all again, on the CPU and for the groups the
+// compute shaders are dispatched over. Also tests the tile hashes, which find what
+// changed themselves.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/HorizontalFilter.h"
+#include "CPU/VerticalFilter.h"
+#include "CPU/GaussianFilter.h"
+#include "CPU/GaussianFilterSIMD.h"
+#include "CPU/RecursiveGaussian.h"
+#include "CPU/ApronSurface.h"
+
+using namespace CPUFilter;
+
+
+//--------------------------------------------------------------------------------------
+// The filter configurations re-filtered, and hashed
+//--------------------------------------------------------------------------------------
+enum CONFIG_TYPE
+{
+    CONFIG_TYPE_HOOK,
+    CONFIG_TYPE_SIMD,
+    CONFIG_TYPE_FUSED,
+    CONFIG_TYPE_RECURSIVE,
+    CONFIG_TYPE_WRAP,
+    CONFIG_TYPE_WRAP_FUSED,
+    CONFIG_TYPE_MAX
+};
+
+static const char* s_pConfigNames[CONFIG_TYPE_MAX] = { "hook", "SIMD", "fused", "recursive", "wrap", "wrap fused" };
+
+
+//--------------------------------------------------------------------------------------
+// Owns the passes and surfaces of one configuration, and sets up a filter with them.
+// The input is shared by the filter under test and the reference, which each render
+// through their own intermediate and output.
+//--------------------------------------------------------------------------------------
+struct TestConfig
+{
+    CONFIG_TYPE                         m_Config;
+    Surface                             m_Input;
+    HorizontalFilter<GaussianFilter>    m_HookX;
+    VerticalFilter<GaussianFilter>      m_HookY;
+    GaussianFilterX                     m_FilterX;
+    GaussianFilterY                     m_FilterY;
+    GaussianFilterFused                 m_FilterFused;
+    RecursiveGaussianX                  m_RecursiveX;
+    ApronSurface                        m_ApronInput;
+    ApronSurface                        m_ApronIntermediate;
+
+    void Create( CONFIG_TYPE Config, unsigned int uWidth, unsigned int uHeight, int iKernelRadius )
+    {
+        m_Config = Config;
+        m_Input.Create( uWidth, uHeight );
+        FillRandom( m_Input, 0, 0, uWidth, uHeight );
+
+        m_HookX.SetKernel( iKernelRadius, false );
+        m_HookY.SetKernel( iKernelRadius, false );
+        m_FilterX.SetKernel( iKernelRadius, false );
+        m_FilterY.SetKernel( iKernelRadius, false );
+        m_FilterFused.SetKernel( iKernelRadius, false );
+        m_RecursiveX.SetKernel( iKernelRadius, false );
+
+        if( IsWrapped() )
+        {
+            m_ApronInput.Create( uWidth, uHeight, iKernelRadius );
+            m_ApronIntermediate.Create( uWidth, uHeight, iKernelRadius );
+            m_ApronInput.CopyFrom( m_Input );
+            m_FilterX.SetApronInput( &m_ApronInput );
+            m_FilterY.SetApronInput( &m_ApronIntermediate );
+            m_FilterFused.SetApronInput( &m_ApronInput );
+        }
+    }
+
+    bool IsWrapped() const
+    {
+        return ( CONFIG_TYPE_WRAP == m_Config || CONFIG_TYPE_WRAP_FUSED == m_Config );
+    }
+
+    // Refreshes the input apron after the input changed
+    void OnInputChanged()
+    {
+        if( IsWrapped() )
+        {
+            m_ApronInput.CopyFrom( m_Input );
+        }
+    }
+
+    void Setup( SeparableFilterCPU& Filter, Surface* pIntermediate, Surface* pOutput )
+    {
+        const Surface* pInputs[1] = { &m_Input };
+        const Surface* pIntermediates[1] = { pIntermediate };
+        FilterPass* pFilterX = ( CONFIG_TYPE_HOOK == m_Config ) ? (FilterPass*)&m_HookX : ( CONFIG_TYPE_RECURSIVE == m_Config ) ? (FilterPass*)&m_RecursiveX : (FilterPass*)&m_FilterX;
+        FilterPass* pFilterY = ( CONFIG_TYPE_HOOK == m_Config ) ? (FilterPass*)&m_HookY : (FilterPass*)&m_FilterY;
+        const bool bFused = ( CONFIG_TYPE_FUSED == m_Config || CONFIG_TYPE_WRAP_FUSED == m_Config );
+
+        Filter.SetOutputSize( m_Input.m_uWidth, m_Input.m_uHeight );
+        Filter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+        Filter.SetOutputSurfaces( pIntermediate, pOutput );
+        Filter.SetFilters( pFilterX, pFilterY );
+        Filter.SetFusedFilter( bFused ? &m_FilterFused : NULL );
+
+        if( IsWrapped() )
+        {
+            Filter.SetApronSurfaces( &m_ApronInput, &m_ApronIntermediate );
+            Filter.SetBorderMode( BORDER_MODE_TYPE_WRAP, MakeFloat4( 0.0f, 0.0f, 0.0f, 0.0f ) );
+        }
+    }
+};
+
+
+//--------------------------------------------------------------------------------------
+// Edits of two rectangles each: an interior block and a single texel, both corners, spans
+// straddling the edges, and rectangles entirely outside
+//--------------------------------------------------------------------------------------
+static const int s_iNumEdits = 4;
+
+static void GetEdits( int iWidth, int iHeight, Rect Edits[s_iNumEdits][2] )
+{
+    Edits[0][0] = MakeRect( iWidth / 3, iHeight / 4, iWidth / 3 + 20, iHeight / 4 + 9 );
+    Edits[0][1] = MakeRect( iWidth / 2, iHeight / 2, iWidth / 2 + 1, iHeight / 2 + 1 );
+    Edits[1][0] = MakeRect( 0, 0, 4, 5 );
+    Edits[1][1] = MakeRect( iWidth - 2, iHeight - 3, iWidth, iHeight );
+    Edits[2][0] = MakeRect( -5, iHeight / 2, iWidth + 5, iHeight / 2 + 2 );
+    Edits[2][1] = MakeRect( iWidth / 2, -5, iWidth / 2 + 3, iHeight + 5 );
+    Edits[3][0] = MakeRect( -100, -100, -50, -50 );
+    Edits[3][1] = MakeRect( iWidth + 10, 0, iWidth + 20, iHeight );
+}
+
+
+//--------------------------------------------------------------------------------------
+// SeparableFilterCPU::OnRenderDirty after each edit against a full render. With the wrapped
+// aprons, edits near an edge change the output at the opposite edge too.
+//--------------------------------------------------------------------------------------
+static void TestRenderDirty()
+{
+    static const unsigned int uWidths[] = { 77, 1000 };
+    static const int iRadii[] = { 3, 16 };
+
+    for( int iConfig = 0; iConfig < CONFIG_TYPE_MAX; iConfig++ )
+    {
+        for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+        {
+            for( int iRadius = 0; iRadius < (int)( sizeof( iRadii ) / sizeof( iRadii[0] ) ); iRadius++ )
+            {
+                const unsigned int uWidth = uWidths[iSize];
+                const unsigned int uHeight = uWidth * 2 / 3 + 5;
+                const int iKernelRadius = iRadii[iRadius];
+
+                TestConfig Config;
+                Config.Create( (CONFIG_TYPE)iConfig, uWidth, uHeight, iKernelRadius );
+
+                Surface Temp, Output, ReferenceTemp, Reference;
+                Temp.Create( uWidth, uHeight );
+                Output.Create( uWidth, uHeight );
+                ReferenceTemp.Create( uWidth, uHeight );
+                Reference.Create( uWidth, uHeight );
+
+                SeparableFilterCPU Filter;
+                Config.Setup( Filter, &Temp, &Output );
+                Filter.OnRender();
+
+                Rect Edits[s_iNumEdits][2];
+                GetEdits( (int)uWidth, (int)uHeight, Edits );
+
+                for( int iEdit = 0; iEdit < s_iNumEdits; iEdit++ )
+                {
+                    for( int iRect = 0; iRect < 2; iRect++ )
+                    {
+                        const Rect& rc = Edits[iEdit][iRect];
+                        FillRandom( Config.m_Input, rc.left, rc.top, rc.right, rc.bottom );
+                    }
+                    Config.OnInputChanged();
+
+                    Filter.OnRenderDirty( Edits[iEdit], 2 );
+
+                    SeparableFilterCPU ReferenceFilter;
+                    Config.Setup( ReferenceFilter, &ReferenceTemp, &Reference );
+                    ReferenceFilter.OnRender();
+
+                    CheckIdentical( Reference, Output, "Dirty rectangles %s %ux%u radius %d edit %d", s_pConfigNames[iConfig], uWidth, uHeight, iKernelRadius, iEdit );
+                }
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Computes the groups SeparableFilter::OnRenderDirty dispatches the compute shaders over
+// for one pass, with the HLSL mirror of the shader: for each rectangle, grown with
+// GrowDirtyRect, the groups covering it from its origin
+//--------------------------------------------------------------------------------------
+template< class Pass >
+static void DispatchDirty( Pass& Filter, int iPass, const Surface* pInput, Surface* pOutput, const Rect* pDirtyRects, int iNumRects )
+{
+    const int iWidth = (int)pOutput->m_uWidth;
+    const int iHeight = (int)pOutput->m_uHeight;
+    const float fOutputSize[4] = { (float)iWidth, (float)iHeight, 1.0f / (float)iWidth, 1.0f / (float)iHeight };
+    Scratch LDS;
+
+    Filter.Bind( &pInput, 1, pOutput, fOutputSize );
+
+    unsigned int uGroupWidth, uGroupHeight;
+    Filter.GetGroupSize( uGroupWidth, uGroupHeight );
+
+    for( int iRect = 0; iRect < iNumRects; iRect++ )
+    {
+        Rect Grown;
+        if( !GrowDirtyRect( pDirtyRects[iRect], iPass, Filter.KernelRadius(), iWidth, iHeight, Grown ) )
+        {
+            continue;
+        }
+
+        Filter.SetDispatchOrigin( Grown.left, Grown.top );
+
+        const unsigned int uX = DivRoundUp( (unsigned int)( Grown.right - Grown.left ), uGroupWidth );
+        const unsigned int uY = DivRoundUp( (unsigned int)( Grown.bottom - Grown.top ), uGroupHeight );
+        for( unsigned int uGroupY = 0; uGroupY < uY; uGroupY++ )
+        {
+            for( unsigned int uGroupX = 0; uGroupX < uX; uGroupX++ )
+            {
+                Filter.ComputeGroup( uGroupX, uGroupY, LDS );
+            }
+        }
+    }
+
+    Filter.SetDispatchOrigin( 0, 0 );
+}
+
+
+//--------------------------------------------------------------------------------------
+// The compute shader path of SeparableFilter::OnRenderDirty, through the HLSL mirrors,
+// against a full render. The rectangles are grown by the radius of the permutation, as
+// SetComputeShaders records it, and the groups are offset by g_i4DispatchOrigin, so the
+// mirrors only pass if both are right.
+//--------------------------------------------------------------------------------------
+static void TestComputeDirty()
+{
+    static const unsigned int uWidths[] = { 300, 77 };
+    static const unsigned int uHeights[] = { 170, 260 };
+    static const KERNEL_RADIUS_TYPE KernelRadii[] = { KERNEL_RADIUS_TYPE_4, KERNEL_RADIUS_TYPE_16 };
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        for( int iRadius = 0; iRadius < (int)( sizeof( KernelRadii ) / sizeof( KernelRadii[0] ) ); iRadius++ )
+        {
+            const unsigned int uWidth = uWidths[iSize];
+            const unsigned int uHeight = uHeights[iSize];
+
+            // As SeparableFilter::GetKernelRadius
+            const int iKernelRadius = ( KernelRadii[iRadius] + 1 ) * 2;
+
+            Surface Input, Temp, Output, ReferenceTemp, Reference;
+            Input.Create( uWidth, uHeight );
+            Temp.Create( uWidth, uHeight );
+            Output.Create( uWidth, uHeight );
+            ReferenceTemp.Create( uWidth, uHeight );
+            Reference.Create( uWidth, uHeight );
+            FillRandom( Input, 0, 0, uWidth, uHeight );
+
+            HorizontalFilter<GaussianFilter> HookX;
+            VerticalFilter<GaussianFilter> HookY;
+            HookX.SetKernel( iKernelRadius, false );
+            HookY.SetKernel( iKernelRadius, false );
+
+            const Surface* pInputs[1] = { &Input };
+            const Surface* pIntermediates[1] = { &Temp };
+            const Surface* pReferenceIntermediates[1] = { &ReferenceTemp };
+
+            SeparableFilterCPU Filter;
+            Filter.SetOutputSize( uWidth, uHeight );
+            Filter.SetFilters( &HookX, &HookY );
+            Filter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+            Filter.SetOutputSurfaces( &Temp, &Output );
+            Filter.OnRender();
+
+            Rect Edits[s_iNumEdits][2];
+            GetEdits( (int)uWidth, (int)uHeight, Edits );
+
+            for( int iEdit = 0; iEdit < s_iNumEdits; iEdit++ )
+            {
+                for( int iRect = 0; iRect < 2; iRect++ )
+                {
+                    const Rect& rc = Edits[iEdit][iRect];
+                    FillRandom( Input, rc.left, rc.top, rc.right, rc.bottom );
+                }
+
+                DispatchDirty( HookX, 0, &Input, &Temp, Edits[iEdit], 2 );
+                DispatchDirty( HookY, 1, &Temp, &Output, Edits[iEdit], 2 );
+
+                SeparableFilterCPU ReferenceFilter;
+                ReferenceFilter.SetOutputSize( uWidth, uHeight );
+                ReferenceFilter.SetFilters( &HookX, &HookY );
+                ReferenceFilter.SetInputSurfaces( pInputs, pReferenceIntermediates, 1 );
+                ReferenceFilter.SetOutputSurfaces( &ReferenceTemp, &Reference );
+                ReferenceFilter.OnRender();
+
+                CheckIdentical( Reference, Output, "Compute dirty rectangles %ux%u radius %d edit %d", uWidth, uHeight, iKernelRadius, iEdit );
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Runs the dirty rectangle tests
+//--------------------------------------------------------------------------------------
+void TestDirtyRects()
+{
+    TestRenderDirty();
+    TestComputeDirty();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Hashed renders after no change, small edits, a full change and a corner texel, against
+// a full render, in each configuration with tiles to hash. Unchanged inputs must skip
+// every group, and a full change none.
+//--------------------------------------------------------------------------------------
+static void TestHashedRenders()
+{
+    static const unsigned int uWidths[] = { 77, 1000 };
+    static const int iRadii[] = { 3, 16 };
+
+    for( int iConfig = 0; iConfig < CONFIG_TYPE_MAX; iConfig++ )
+    {
+        // The recursive pass runs a row per group, so never has tiles to hash
+        if( CONFIG_TYPE_RECURSIVE == iConfig )
+        {
+            continue;
+        }
+
+        for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+        {
+            for( int iRadius = 0; iRadius < (int)( sizeof( iRadii ) / sizeof( iRadii[0] ) ); iRadius++ )
+            {
+                const unsigned int uWidth = uWidths[iSize];
+                const unsigned int uHeight = uWidth * 2 / 3 + 5;
+                const int iKernelRadius = iRadii[iRadius];
+                const int iW = (int)uWidth;
+                const int iH = (int)uHeight;
+
+                TestConfig Config;
+                Config.Create( (CONFIG_TYPE)iConfig, uWidth, uHeight, iKernelRadius );
+
+                Surface Temp, Output, ReferenceTemp, Reference;
+                Temp.Create( uWidth, uHeight );
+                Output.Create( uWidth, uHeight );
+                ReferenceTemp.Create( uWidth, uHeight );
+                Reference.Create( uWidth, uHeight );
+
+                SeparableFilterCPU Filter;
+                Config.Setup( Filter, &Temp, &Output );
+                Filter.SetTileHashing( true );
+
+                for( int iEdit = 0; iEdit < 5; iEdit++ )
+                {
+                    switch( iEdit )
+                    {
+                    case 2:
+                        FillRandom( Config.m_Input, iW / 3, iH / 2, iW / 3 + 7, iH / 2 + 1 );
+                        FillRandom( Config.m_Input, 0, iH - 1, 1, iH );
+                        break;
+                    case 3:
+                        FillRandom( Config.m_Input, 0, 0, iW, iH );
+                        break;
+                    case 4:
+                        FillRandom( Config.m_Input, iW - 1, iH - 1, iW, iH );
+                        break;
+                    }
+                    Config.OnInputChanged();
+
+                    Filter.OnRender();
+
+                    SeparableFilterCPU ReferenceFilter;
+                    Config.Setup( ReferenceFilter, &ReferenceTemp, &Reference );
+                    ReferenceFilter.OnRender();
+
+                    CheckIdentical( Reference, Output, "Tile hashing %s %ux%u radius %d edit %d", s_pConfigNames[iConfig], uWidth, uHeight, iKernelRadius, iEdit );
+
+                    unsigned int uNumHits, uNumGroups;
+                    Filter.GetTileHashCounters( uNumHits, uNumGroups );
+                    if( 1 == iEdit )
+                    {
+                        Check( uNumGroups > 0 && uNumHits == uNumGroups, "Tile hashing %s %ux%u radius %d skipped %u of %u unchanged groups", s_pConfigNames[iConfig],
+                            uWidth, uHeight, iKernelRadius, uNumHits, uNumGroups );
+                    }
+                    else if( 3 == iEdit )
+                    {
+                        Check( 0 == uNumHits, "Tile hashing %s %ux%u radius %d skipped %u of %u changed groups", s_pConfigNames[iConfig], uWidth, uHeight,
+                            iKernelRadius, uNumHits, uNumGroups );
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Changes to the filter setup that leave the input, and so the hashes of the horizontal
+// pass, unchanged: the vertical output, the vertical filter, its radius, and a fused
+// filter in place of both
+//--------------------------------------------------------------------------------------
+static void TestHashedSetupChanges()
+{
+    const unsigned int uWidth = 600;
+    const unsigned int uHeight = 400;
+
+    Surface Input, Temp, Output, OtherOutput, ReferenceTemp, Reference;
+    Input.Create( uWidth, uHeight );
+    Temp.Create( uWidth, uHeight );
+    Output.Create( uWidth, uHeight );
+    OtherOutput.Create( uWidth, uHeight );
+    ReferenceTemp.Create( uWidth, uHeight );
+    Reference.Create( uWidth, uHeight );
+    FillRandom( Input, 0, 0, uWidth, uHeight );
+    FillRandom( OtherOutput, 0, 0, uWidth, uHeight );
+
+    GaussianFilterX FilterX;
+    GaussianFilterY FilterY, OtherFilterY;
+    GaussianFilterFused FilterFused;
+    FilterX.SetKernel( 8, false );
+    FilterY.SetKernel( 8, false );
+    OtherFilterY.SetKernel( 16, false );
+    FilterFused.SetKernel( 8, false );
+
+    // Strips sized from the caches change with the radius, and so would the dispatch
+    OtherFilterY.SetStripWidth( 16 );
+
+    const Surface* pInputs[1] = { &Input };
+    const Surface* pIntermediates[1] = { &Temp };
+    const Surface* pReferenceIntermediates[1] = { &ReferenceTemp };
+
+    SeparableFilterCPU Filter, ReferenceFilter;
+    Filter.SetOutputSize( uWidth, uHeight );
+    Filter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+    Filter.SetOutputSurfaces( &Temp, &Output );
+    Filter.SetFilters( &FilterX, &FilterY );
+    Filter.SetTileHashing( true );
+    Filter.OnRender();
+    Filter.OnRender();
+
+    ReferenceFilter.SetOutputSize( uWidth, uHeight );
+    ReferenceFilter.SetInputSurfaces( pInputs, pReferenceIntermediates, 1 );
+    ReferenceFilter.SetOutputSurfaces( &ReferenceTemp, &Reference );
+
+    Filter.SetOutputSurfaces( &Temp, &OtherOutput );
+    Filter.OnRender();
+    ReferenceFilter.SetFilters( &FilterX, &FilterY );
+    ReferenceFilter.OnRender();
+    CheckIdentical( Reference, OtherOutput, "Tile hashing after an output change" );
+
+    Filter.SetFilters( &FilterX, &OtherFilterY );
+    Filter.OnRender();
+    ReferenceFilter.SetFilters( &FilterX, &OtherFilterY );
+    ReferenceFilter.OnRender();
+    CheckIdentical( Reference, OtherOutput, "Tile hashing after a filter change" );
+
+    OtherFilterY.SetKernel( 4, false );
+    Filter.OnRender();
+    ReferenceFilter.OnRender();
+    CheckIdentical( Reference, OtherOutput, "Tile hashing after a radius change" );
+
+    Filter.SetFusedFilter( &FilterFused );
+    Filter.OnRender();
+    ReferenceFilter.SetFusedFilter( &FilterFused );
+    ReferenceFilter.OnRender();
+    CheckIdentical( Reference, OtherOutput, "Tile hashing after a fused filter change" );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Runs the tile hashing tests
+//--------------------------------------------------------------------------------------
+void TestTileHashing()
+{
+    TestHashedRenders();
+    TestHashedSetupChanges();
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,265 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestDualFilter.cpp
+//
+// Tests the dual filter chain against a reference built from the bilinear samples of
+// DualFilter.hlsl, and the deviation of its blur.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/DualFilter.h"
+
+#include <math.h>
+#include <vector>
+
+using namespace CPUFilter;
+
+
+// The passes sum in floats, the reference in doubles
+static const float s_fTolerance = 1e-5f;
+
+// Of the impulse response's deviation against ComputeDualFilterDeviation, whose variances
+// add exactly away from the borders
+static const float s_fDeviationTolerance = 1e-4f;
+
+
+//--------------------------------------------------------------------------------------
+// One channel of an image in doubles, sampled as a linear clamp sampler would
+//--------------------------------------------------------------------------------------
+struct Image
+{
+    int                 iWidth;
+    int                 iHeight;
+    std::vector<double> Texels;
+
+    double Texel( int iX, int iY ) const
+    {
+        iX = ( iX < 0 ) ? 0 : ( iX >= iWidth ) ? iWidth - 1 : iX;
+        iY = ( iY < 0 ) ? 0 : ( iY >= iHeight ) ? iHeight - 1 : iY;
+
+        return Texels[iY * iWidth + iX];
+    }
+
+    // At a position in texels, where texel ( x, y ) is centered on ( x, y )
+    double Sample( double dX, double dY ) const
+    {
+        const int iX = (int)floor( dX );
+        const int iY = (int)floor( dY );
+        const double dFracX = dX - iX;
+        const double dFracY = dY - iY;
+
+        return ( Texel( iX, iY ) * ( 1.0 - dFracX ) + Texel( iX + 1, iY ) * dFracX ) * ( 1.0 - dFracY ) +
+               ( Texel( iX, iY + 1 ) * ( 1.0 - dFracX ) + Texel( iX + 1, iY + 1 ) * dFracX ) * dFracY;
+    }
+
+    void Create( int iNewWidth, int iNewHeight )
+    {
+        iWidth = iNewWidth;
+        iHeight = iNewHeight;
+        Texels.assign( (size_t)iWidth * iHeight, 0.0 );
+    }
+};
+
+
+//--------------------------------------------------------------------------------------
+// The 5 taps of the downsample around the center of each output texel, at input texel
+// 2i + 1/2
+//--------------------------------------------------------------------------------------
+static void Downsample( const Image& Input, Image& Output )
+{
+    Output.Create( ( Input.iWidth + 1 ) / 2, ( Input.iHeight + 1 ) / 2 );
+
+    for( int iY = 0; iY < Output.iHeight; iY++ )
+    {
+        for( int iX = 0; iX < Output.iWidth; iX++ )
+        {
+            const double dX = 2.0 * iX + 0.5;
+            const double dY = 2.0 * iY + 0.5;
+
+            Output.Texels[iY * Output.iWidth + iX] = Input.Sample( dX, dY ) * 0.5 +
+                ( Input.Sample( dX - 1.0, dY - 1.0 ) + Input.Sample( dX + 1.0, dY - 1.0 ) +
+                  Input.Sample( dX - 1.0, dY + 1.0 ) + Input.Sample( dX + 1.0, dY + 1.0 ) ) * 0.125;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// The 8 taps of the upsample around each output texel, at coarse texel x / 2 - 1/4
+//--------------------------------------------------------------------------------------
+static void Upsample( const Image& Input, int iWidth, int iHeight, Image& Output )
+{
+    Output.Create( iWidth, iHeight );
+
+    for( int iY = 0; iY < Output.iHeight; iY++ )
+    {
+        for( int iX = 0; iX < Output.iWidth; iX++ )
+        {
+            const double dX = iX * 0.5 - 0.25;
+            const double dY = iY * 0.5 - 0.25;
+
+            Output.Texels[iY * Output.iWidth + iX] =
+                ( Input.Sample( dX - 1.0, dY ) + Input.Sample( dX + 1.0, dY ) + Input.Sample( dX, dY - 1.0 ) + Input.Sample( dX, dY + 1.0 ) ) / 12.0 +
+                ( Input.Sample( dX - 0.5, dY - 0.5 ) + Input.Sample( dX + 0.5, dY - 0.5 ) +
+                  Input.Sample( dX - 0.5, dY + 0.5 ) + Input.Sample( dX + 0.5, dY + 0.5 ) ) * ( 2.0 / 12.0 );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// The chain of iNumLevels on one channel
+//--------------------------------------------------------------------------------------
+static void DualFilterReference( const Image& Input, int iNumLevels, Image& Output )
+{
+    std::vector<Image> Levels( iNumLevels + 1 );
+    Levels[0] = Input;
+
+    for( int iLevel = 1; iLevel <= iNumLevels; iLevel++ )
+    {
+        Downsample( Levels[iLevel - 1], Levels[iLevel] );
+    }
+
+    Image Upsampled = Levels[iNumLevels];
+    for( int iLevel = iNumLevels - 1; iLevel >= 0; iLevel-- )
+    {
+        Image Finer;
+        Upsample( Upsampled, Levels[iLevel].iWidth, Levels[iLevel].iHeight, Finer );
+        Upsampled = Finer;
+    }
+
+    Output = Upsampled;
+}
+
+
+//--------------------------------------------------------------------------------------
+// The chain of each depth on random inputs of odd and even sizes against the reference,
+// then the deviation of its response to an impulse
+//--------------------------------------------------------------------------------------
+void TestDualFilter()
+{
+    static const unsigned int uWidths[] = { 128, 101, 7 };
+    static const unsigned int uHeights[] = { 96, 77, 30 };
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        const unsigned int uWidth = uWidths[iSize];
+        const unsigned int uHeight = uHeights[iSize];
+
+        Surface Input, Output;
+        Input.Create( uWidth, uHeight );
+        Output.Create( uWidth, uHeight );
+        FillRandom( Input, 0, 0, uWidth, uHeight );
+
+        Image Channel, Reference;
+        Channel.Create( (int)uWidth, (int)uHeight );
+        for( unsigned int uY = 0; uY < uHeight; uY++ )
+        {
+            for( unsigned int uX = 0; uX < uWidth; uX++ )
+            {
+                Channel.Texels[uY * uWidth + uX] = Input.Row( uY )[uX].y;
+            }
+        }
+
+        DualFilter Filter;
+        Filter.Create( uWidth, uHeight );
+
+        for( int iLevels = 1; iLevels <= MAX_DUAL_FILTER_LEVELS; iLevels++ )
+        {
+            // The deviation of a depth picks that depth, unless the image caps it
+            Filter.SetDeviation( ComputeDualFilterDeviation( iLevels ) );
+            if( Filter.GetNumLevels() != iLevels )
+            {
+                Check( Filter.GetNumLevels() < iLevels && ( uWidth >> ( iLevels + 1 ) ) < 2, "Dual filter %ux%u picked %d levels for the deviation of %d",
+                    uWidth, uHeight, Filter.GetNumLevels(), iLevels );
+                break;
+            }
+
+            FillRandom( Output, 0, 0, uWidth, uHeight );
+            Filter.OnRender( Input, Output );
+            DualFilterReference( Channel, iLevels, Reference );
+
+            float fMaxError = 0.0f;
+            for( unsigned int uY = 0; uY < uHeight; uY++ )
+            {
+                for( unsigned int uX = 0; uX < uWidth; uX++ )
+                {
+                    const float fError = fabsf( Output.Row( uY )[uX].y - (float)Reference.Texels[uY * uWidth + uX] );
+                    fMaxError = ( fError > fMaxError ) ? fError : fMaxError;
+                }
+            }
+            CheckError( fMaxError, s_fTolerance, "Dual filter %ux%u, %d levels", uWidth, uHeight, iLevels );
+        }
+    }
+
+    // Far enough from the borders that the response is not clamped
+    static const unsigned int uSize = 512;
+
+    Surface Impulse, Output;
+    Impulse.Create( uSize, uSize );
+    Output.Create( uSize, uSize );
+    for( unsigned int uY = 0; uY < uSize; uY++ )
+    {
+        for( unsigned int uX = 0; uX < uSize; uX++ )
+        {
+            Impulse.Row( uY )[uX] = MakeFloat4( ( uX == uSize / 2 && uY == uSize / 2 ) ? 1.0f : 0.0f, 0.0f, 0.0f, 1.0f );
+        }
+    }
+
+    DualFilter Filter;
+    Filter.Create( uSize, uSize );
+
+    for( int iLevels = 1; iLevels <= 4; iLevels++ )
+    {
+        Filter.SetDeviation( ComputeDualFilterDeviation( iLevels ) );
+        Filter.OnRender( Impulse, Output );
+
+        double dSum = 0.0, dSumX = 0.0, dSumX2 = 0.0;
+        for( unsigned int uY = 0; uY < uSize; uY++ )
+        {
+            for( unsigned int uX = 0; uX < uSize; uX++ )
+            {
+                const double dValue = Output.Row( uY )[uX].x;
+                dSum += dValue;
+                dSumX += dValue * uX;
+                dSumX2 += dValue * uX * uX;
+            }
+        }
+
+        const double dCenter = dSumX / dSum;
+        const double dDeviation = sqrt( dSumX2 / dSum - dCenter * dCenter );
+        const double dExpected = ComputeDualFilterDeviation( iLevels );
+        CheckError( (float)( fabs( dSum - 1.0 ) ), 1e-5f, "Dual filter impulse response of %d levels sums to %g", iLevels, dSum );
+        CheckError( (float)( fabs( dDeviation - dExpected ) / dExpected ), s_fDeviationTolerance, "Dual filter impulse response of %d levels has a deviation of %g, not %g",
+            iLevels, dDeviation, dExpected );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
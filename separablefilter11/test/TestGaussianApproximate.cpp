@@ -0,0 +1,204 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestGaussianApproximate.cpp
+//
+// Tests the merged taps of the approximate Gaussian filter: their weights and offsets, and
+// the bilinear PS equivalent, the LDS blending CS equivalent and the vectorized passes
+// against the full filter.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/HorizontalFilter.h"
+#include "CPU/VerticalFilter.h"
+#include "CPU/GaussianFilter.h"
+#include "CPU/GaussianFilterSIMD.h"
+#include "CPU/CPUInfo.h"
+
+#include <math.h>
+
+using namespace CPUFilter;
+
+
+// The merged taps equal the full filter up to rounding
+static const float s_fTolerance = 1e-5f;
+
+
+//--------------------------------------------------------------------------------------
+// Each merged pair has the summed weight, and the offset that weights each texel exactly
+//--------------------------------------------------------------------------------------
+static void TestTaps()
+{
+    static const float fDeviations[] = { 0.0f, 1.5f, 9.0f };
+
+    for( int iKernelRadius = 2; iKernelRadius <= MAX_KERNEL_RADIUS; iKernelRadius += 2 )
+    {
+        for( int iDeviation = 0; iDeviation < (int)( sizeof( fDeviations ) / sizeof( fDeviations[0] ) ); iDeviation++ )
+        {
+            const float fDeviation = ( fDeviations[iDeviation] > 0.0f ) ? fDeviations[iDeviation] : (float)iKernelRadius * 0.5f;
+
+            float fWeights[MAX_KERNEL_RADIUS * 2 + 1];
+            float fOffsets[MAX_KERNEL_RADIUS * 2 + 1];
+            ComputeGaussianTaps( iKernelRadius, 2, fDeviation, fWeights, fOffsets );
+
+            // Where each texel's weight ends up when the bilinear samples are taken
+            float fTexelWeights[MAX_KERNEL_RADIUS * 2 + 2] = { 0 };
+            float fError = 0.0f;
+            for( int iIteration = 0; iIteration < iKernelRadius * 2 + 1; iIteration++ )
+            {
+                if( iIteration == iKernelRadius )
+                {
+                    fTexelWeights[iIteration] += fWeights[iIteration];
+                    fError = ( fOffsets[iIteration] != 0.0f ) ? 1.0f : fError;
+                    continue;
+                }
+
+                fTexelWeights[iIteration] += fWeights[iIteration] * ( 1.0f - fOffsets[iIteration] );
+                fTexelWeights[iIteration + 1] += fWeights[iIteration] * fOffsets[iIteration];
+            }
+            // Relative to the center, as the tails of narrow kernels underflow
+            const float fCenterWeight = GaussianWeight( 0.0f, fDeviation );
+            for( int iTap = 0; iTap < iKernelRadius * 2 + 1; iTap++ )
+            {
+                const float fExpected = GaussianWeight( (float)( iTap - iKernelRadius ), fDeviation );
+                const float fDifference = fabsf( fTexelWeights[iTap] - fExpected ) / fCenterWeight;
+                fError = ( fDifference > fError ) ? fDifference : fError;
+            }
+            CheckError( fError, 1e-5f, "Gaussian merged taps radius %d deviation %g", iKernelRadius, fDeviation );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// The bilinear samples of GaussianFilterLinear, and the hooks blending texels read from the
+// LDS, against the full filter for every radius the shaders have
+//--------------------------------------------------------------------------------------
+static void TestFilters()
+{
+    const unsigned int uWidth = 173;
+    const unsigned int uHeight = 67;
+
+    Surface Input, Temp, Output, Reference;
+    Input.Create( uWidth, uHeight );
+    Temp.Create( uWidth, uHeight );
+    Output.Create( uWidth, uHeight );
+    Reference.Create( uWidth, uHeight );
+
+    // High contrast, so misweighted taps show
+    for( unsigned int uY = 0; uY < uHeight; uY++ )
+    {
+        for( unsigned int uX = 0; uX < uWidth; uX++ )
+        {
+            const float fValue = ( ( uX ^ uY ) & 1 ) ? 1.0f : 0.0f;
+            Input.Row( uY )[uX] = MakeFloat4( fValue, Random(), 1.0f - fValue, 1.0f );
+        }
+    }
+
+    const Surface* pInputs[1] = { &Input };
+    const Surface* pIntermediates[1] = { &Temp };
+
+    SeparableFilterCPU Filter;
+    Filter.SetOutputSize( uWidth, uHeight );
+    Filter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+
+    for( int iKernelRadius = 2; iKernelRadius <= 32; iKernelRadius += 2 )
+    {
+        HorizontalFilter<GaussianFilter> HookX;
+        VerticalFilter<GaussianFilter> HookY;
+        HookX.SetKernel( iKernelRadius, false );
+        HookY.SetKernel( iKernelRadius, false );
+
+        Filter.SetOutputSurfaces( &Temp, &Reference );
+        Filter.SetFilters( &HookX, &HookY );
+        Filter.OnRender();
+
+        GaussianFilterLinear( Input, Temp, PASS_TYPE_HORIZONTAL, iKernelRadius, 0.0f );
+        GaussianFilterLinear( Temp, Output, PASS_TYPE_VERTICAL, iKernelRadius, 0.0f );
+        CheckError( MaxDifference( Reference, Output ), s_fTolerance, "Gaussian linear radius %d", iKernelRadius );
+
+        HorizontalFilter<GaussianFilter> ApproximateX;
+        VerticalFilter<GaussianFilter> ApproximateY;
+        ApproximateX.SetKernel( iKernelRadius, true );
+        ApproximateY.SetKernel( iKernelRadius, true );
+
+        Filter.SetOutputSurfaces( &Temp, &Output );
+        Filter.SetFilters( &ApproximateX, &ApproximateY );
+        Filter.OnRender();
+        CheckError( MaxDifference( Reference, Output ), s_fTolerance, "Gaussian approximate hook radius %d", iKernelRadius );
+
+        // The vectorized passes compute the full filter either way
+        for( int iISA = 0; iISA < ISA_TYPE_MAX; iISA++ )
+        {
+            if( !GetCPUInfo().m_bSupportsISA[iISA] )
+            {
+                continue;
+            }
+
+            GaussianFilterX FilterX;
+            GaussianFilterY FilterY;
+            FilterX.SetISA( (ISA_TYPE)iISA );
+            FilterY.SetISA( (ISA_TYPE)iISA );
+            FilterX.SetKernel( iKernelRadius, true );
+            FilterY.SetKernel( iKernelRadius, true );
+
+            Filter.SetFilters( &FilterX, &FilterY );
+            Filter.OnRender();
+            CheckError( MaxDifference( Reference, Output ), s_fTolerance, "Gaussian approximate %s radius %d",
+                GetISAName( (ISA_TYPE)iISA ), iKernelRadius );
+        }
+    }
+
+    // A deviation other than half the radius
+    HorizontalFilter<GaussianFilter> HookX;
+    VerticalFilter<GaussianFilter> HookY;
+    HookX.SetKernel( 8, false );
+    HookY.SetKernel( 8, false );
+    HookX.SetDeviation( 6.0f );
+    HookY.SetDeviation( 6.0f );
+
+    Filter.SetOutputSurfaces( &Temp, &Reference );
+    Filter.SetFilters( &HookX, &HookY );
+    Filter.OnRender();
+
+    GaussianFilterLinear( Input, Temp, PASS_TYPE_HORIZONTAL, 8, 6.0f );
+    GaussianFilterLinear( Temp, Output, PASS_TYPE_VERTICAL, 8, 6.0f );
+    CheckError( MaxDifference( Reference, Output ), s_fTolerance, "Gaussian linear radius 8 deviation 6" );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Entry point of the tests of this file
+//--------------------------------------------------------------------------------------
+void TestGaussianApproximate()
+{
+    TestTaps();
+    TestFilters();
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,271 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestGaussianDeviation.cpp
+//
+// Tests the radius selected for a deviation by ComputeGaussianRadius, and the Gaussian
+// passes given a deviation other than half their radius.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/HorizontalFilter.h"
+#include "CPU/VerticalFilter.h"
+#include "CPU/GaussianFilter.h"
+#include "CPU/GaussianFilterSIMD.h"
+#include "CPU/CPUInfo.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+using namespace CPUFilter;
+
+
+// The passes sum in a different order than the hooks
+static const float s_fTolerance = 1e-5f;
+
+
+//--------------------------------------------------------------------------------------
+// Fraction of the weight of an untruncated Gaussian that lies outside the radius, summed
+// directly from the tails rather than by subtraction
+//--------------------------------------------------------------------------------------
+static double WeightOutside( double dDeviation, int iRadius )
+{
+    const int iExtent = (int)( 40.0 * dDeviation ) + 1;
+
+    double dTotal = 1.0;
+    double dOutside = 0.0;
+    for( int iX = 1; iX <= iExtent; iX++ )
+    {
+        const double dWeight = 2.0 * exp( -( (double)iX * iX ) / ( 2.0 * dDeviation * dDeviation ) );
+        dTotal += dWeight;
+        dOutside += ( iX > iRadius ) ? dWeight : 0.0;
+    }
+
+    return dOutside / dTotal;
+}
+
+
+//--------------------------------------------------------------------------------------
+// The radius is the smallest that leaves out no more than the tolerance, up to the clamp
+//--------------------------------------------------------------------------------------
+static void TestComputeRadius()
+{
+    static const float fDeviations[] = { 0.25f, 0.5f, 1.0f, 2.5f, 5.0f, 9.5f, 10.0f, 16.0f, 21.0f };
+    static const float fTolerances[] = { 1e-2f, 1e-3f, 1e-5f };
+
+    for( int iDeviation = 0; iDeviation < (int)( sizeof( fDeviations ) / sizeof( fDeviations[0] ) ); iDeviation++ )
+    {
+        for( int iTolerance = 0; iTolerance < (int)( sizeof( fTolerances ) / sizeof( fTolerances[0] ) ); iTolerance++ )
+        {
+            const double dDeviation = fDeviations[iDeviation];
+            const double dTolerance = fTolerances[iTolerance];
+            const int iRadius = ComputeGaussianRadius( fDeviations[iDeviation], fTolerances[iTolerance] );
+
+            // Allow for rounding when the weight outside lands right on the tolerance
+            const bool bCovers = ( iRadius == MAX_KERNEL_RADIUS ) || ( WeightOutside( dDeviation, iRadius ) <= dTolerance * ( 1.0 + 1e-9 ) );
+            const bool bSmallest = ( iRadius == 1 ) || ( WeightOutside( dDeviation, iRadius - 1 ) > dTolerance * ( 1.0 - 1e-9 ) );
+            Check( iRadius >= 1 && iRadius <= MAX_KERNEL_RADIUS && bCovers && bSmallest, "Gaussian radius of deviation %g tolerance %g: %d",
+                dDeviation, dTolerance, iRadius );
+        }
+    }
+
+    // Past the clamp, the kernel is truncated at MAX_KERNEL_RADIUS
+    Check( MAX_KERNEL_RADIUS == 64, "Gaussian radius clamp %d", MAX_KERNEL_RADIUS );
+    Check( ComputeGaussianRadius( 40.0f, 1e-3f ) == MAX_KERNEL_RADIUS, "Gaussian radius of deviation 40 not clamped to %d", MAX_KERNEL_RADIUS );
+    Check( ComputeGaussianRadius( 1000.0f, 1e-3f ) == MAX_KERNEL_RADIUS, "Gaussian radius of deviation 1000 not clamped to %d", MAX_KERNEL_RADIUS );
+    Check( WeightOutside( 19.0, MAX_KERNEL_RADIUS ) <= 1e-3 && WeightOutside( 20.0, MAX_KERNEL_RADIUS ) > 1e-3,
+        "Gaussian radius clamp holds deviations up to 19 at a tolerance of 0.001" );
+    Check( ComputeGaussianRadius( 19.0f, 1e-3f ) < MAX_KERNEL_RADIUS, "Gaussian radius of deviation 19 reaches the clamp" );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Filtering an impulse outputs the product of the horizontal and vertical weights, which
+// are the Gaussian of the deviation normalized over the taps of the radius
+//--------------------------------------------------------------------------------------
+static void TestImpulse()
+{
+    static const int iRadii[] = { 3, 7, 40, 64 };
+    static const float fDeviations[] = { 1.0f, 5.0f, 12.0f, 20.0f };
+
+    for( int iCase = 0; iCase < (int)( sizeof( iRadii ) / sizeof( iRadii[0] ) ); iCase++ )
+    {
+        const int iKernelRadius = iRadii[iCase];
+        const double dDeviation = fDeviations[iCase];
+        const unsigned int uSize = iKernelRadius * 2 + 11;
+        const int iCenter = (int)uSize / 2;
+
+        Surface Input, Temp, Output;
+        Input.Create( uSize, uSize );
+        Temp.Create( uSize, uSize );
+        Output.Create( uSize, uSize );
+        for( unsigned int uY = 0; uY < uSize; uY++ )
+        {
+            for( unsigned int uX = 0; uX < uSize; uX++ )
+            {
+                const float fValue = ( (int)uX == iCenter && (int)uY == iCenter ) ? 1.0f : 0.0f;
+                Input.Row( uY )[uX] = MakeFloat4( fValue, fValue, fValue, 1.0f );
+            }
+        }
+
+        double dWeights[MAX_KERNEL_RADIUS * 2 + 1];
+        double dSum = 0.0;
+        for( int iTap = -iKernelRadius; iTap <= iKernelRadius; iTap++ )
+        {
+            dWeights[iTap + iKernelRadius] = exp( -( (double)iTap * iTap ) / ( 2.0 * dDeviation * dDeviation ) );
+            dSum += dWeights[iTap + iKernelRadius];
+        }
+
+        const Surface* pInputs[1] = { &Input };
+        const Surface* pIntermediates[1] = { &Temp };
+
+        HorizontalFilter<GaussianFilter> HookX;
+        VerticalFilter<GaussianFilter> HookY;
+        HookX.SetKernel( iKernelRadius, false );
+        HookY.SetKernel( iKernelRadius, false );
+        HookX.SetDeviation( fDeviations[iCase] );
+        HookY.SetDeviation( fDeviations[iCase] );
+
+        SeparableFilterCPU Filter;
+        Filter.SetOutputSize( uSize, uSize );
+        Filter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+        Filter.SetOutputSurfaces( &Temp, &Output );
+        Filter.SetFilters( &HookX, &HookY );
+        Filter.OnRender();
+
+        float fError = 0.0f;
+        for( int iY = 0; iY < (int)uSize; iY++ )
+        {
+            for( int iX = 0; iX < (int)uSize; iX++ )
+            {
+                const int iDX = iX - iCenter;
+                const int iDY = iY - iCenter;
+                const bool bInside = ( abs( iDX ) <= iKernelRadius && abs( iDY ) <= iKernelRadius );
+                const double dExpected = bInside ? dWeights[iDX + iKernelRadius] * dWeights[iDY + iKernelRadius] / ( dSum * dSum ) : 0.0;
+                const float fDifference = (float)fabs( Output.Row( iY )[iX].x - dExpected );
+                fError = ( fDifference > fError ) ? fDifference : fError;
+            }
+        }
+        CheckError( fError, 1e-6f, "Gaussian impulse radius %d deviation %g", iKernelRadius, dDeviation );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// The vectorized passes with custom deviations, odd radii and radii past the permutations,
+// against the hooks
+//--------------------------------------------------------------------------------------
+static void TestPasses()
+{
+    static const int iRadii[] = { 3, 8, 33, 64 };
+    static const float fDeviations[] = { 0.0f, 0.7f, 6.0f, 30.0f };
+
+    const unsigned int uWidth = 157;
+    const unsigned int uHeight = 75;
+
+    Surface Input, Temp, Output, Reference;
+    Input.Create( uWidth, uHeight );
+    Temp.Create( uWidth, uHeight );
+    Output.Create( uWidth, uHeight );
+    Reference.Create( uWidth, uHeight );
+    FillRandom( Input, 0, 0, uWidth, uHeight );
+
+    const Surface* pInputs[1] = { &Input };
+    const Surface* pIntermediates[1] = { &Temp };
+
+    SeparableFilterCPU Filter;
+    Filter.SetOutputSize( uWidth, uHeight );
+    Filter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+
+    for( int iRadius = 0; iRadius < (int)( sizeof( iRadii ) / sizeof( iRadii[0] ) ); iRadius++ )
+    {
+        for( int iDeviation = 0; iDeviation < (int)( sizeof( fDeviations ) / sizeof( fDeviations[0] ) ); iDeviation++ )
+        {
+            const int iKernelRadius = iRadii[iRadius];
+            const float fDeviation = fDeviations[iDeviation];
+
+            HorizontalFilter<GaussianFilter> HookX;
+            VerticalFilter<GaussianFilter> HookY;
+            HookX.SetKernel( iKernelRadius, false );
+            HookY.SetKernel( iKernelRadius, false );
+            HookX.SetDeviation( fDeviation );
+            HookY.SetDeviation( fDeviation );
+
+            Filter.SetOutputSurfaces( &Temp, &Reference );
+            Filter.SetFilters( &HookX, &HookY );
+            Filter.OnRender();
+
+            for( int iISA = 0; iISA < ISA_TYPE_MAX; iISA++ )
+            {
+                if( !GetCPUInfo().m_bSupportsISA[iISA] )
+                {
+                    continue;
+                }
+
+                GaussianFilterX FilterX;
+                GaussianFilterY FilterY;
+                GaussianFilterFused FilterFused;
+                FilterX.SetISA( (ISA_TYPE)iISA );
+                FilterY.SetISA( (ISA_TYPE)iISA );
+                FilterFused.SetISA( (ISA_TYPE)iISA );
+                FilterX.SetKernel( iKernelRadius, false );
+                FilterY.SetKernel( iKernelRadius, false );
+                FilterFused.SetKernel( iKernelRadius, false );
+                FilterX.SetDeviation( fDeviation );
+                FilterY.SetDeviation( fDeviation );
+                FilterFused.SetDeviation( fDeviation );
+
+                Filter.SetOutputSurfaces( &Temp, &Output );
+                Filter.SetFilters( &FilterX, &FilterY );
+                Filter.OnRender();
+                CheckError( MaxDifference( Reference, Output ), s_fTolerance, "Gaussian deviation X/Y %s radius %d deviation %g",
+                    GetISAName( (ISA_TYPE)iISA ), iKernelRadius, fDeviation );
+
+                FillRandom( Output, 0, 0, uWidth, uHeight );
+                Filter.SetFusedFilter( &FilterFused );
+                Filter.OnRender();
+                Filter.SetFusedFilter( NULL );
+                CheckError( MaxDifference( Reference, Output ), s_fTolerance, "Gaussian deviation fused %s radius %d deviation %g",
+                    GetISAName( (ISA_TYPE)iISA ), iKernelRadius, fDeviation );
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Entry point of the tests of this file
+//--------------------------------------------------------------------------------------
+void TestGaussianDeviation()
+{
+    TestComputeRadius();
+    TestImpulse();
+    TestPasses();
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,226 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestGaussianFixed.cpp
+//
+// Tests the Gaussian kernels specialized for each KERNEL_RADIUS_TYPE: their compiled in
+// weights, that they match the looped kernels bit for bit, and the passes using them
+// against the hooks.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/HorizontalFilter.h"
+#include "CPU/VerticalFilter.h"
+#include "CPU/GaussianFilter.h"
+#include "CPU/GaussianFilterSIMD.h"
+#include "CPU/CPUInfo.h"
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+using namespace CPUFilter;
+
+
+// The passes sum in a different order than the hooks
+static const float s_fTolerance = 1e-5f;
+
+
+//--------------------------------------------------------------------------------------
+// The tables hold a Gaussian of deviation R / 2, normalized, to single precision
+//--------------------------------------------------------------------------------------
+static void TestWeights()
+{
+    for( int iType = 0; iType < KERNEL_RADIUS_TYPE_MAX; iType++ )
+    {
+        const int iKernelRadius = ( iType + 1 ) * 2;
+        const double dDeviation = iKernelRadius * 0.5;
+
+        double dWeights[MAX_KERNEL_RADIUS * 2 + 1];
+        double dSum = 0.0;
+        for( int iTap = -iKernelRadius; iTap <= iKernelRadius; iTap++ )
+        {
+            dWeights[iTap + iKernelRadius] = exp( -( iTap * iTap ) / ( 2.0 * dDeviation * dDeviation ) );
+            dSum += dWeights[iTap + iKernelRadius];
+        }
+
+        float fError = 0.0f;
+        for( int iTap = 0; iTap <= iKernelRadius * 2; iTap++ )
+        {
+            const float fRelative = (float)( fabs( s_fGaussianWeights[iType][iTap] - dWeights[iTap] / dSum ) * dSum / dWeights[iTap] );
+            fError = ( fRelative > fError ) ? fRelative : fError;
+        }
+        CheckError( fError, 1e-6f, "Gaussian weights radius %d", iKernelRadius );
+
+        Check( GetKernelRadiusType( iKernelRadius ) == (KERNEL_RADIUS_TYPE)iType && GetKernelRadiusType( iKernelRadius + 1 ) == KERNEL_RADIUS_TYPE_MAX,
+            "Gaussian radius type of %d", iKernelRadius );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Runs the specialized and the looped row and column kernels on the same random planes,
+// over counts that leave the vectors of each instruction set partly empty
+//--------------------------------------------------------------------------------------
+static void TestKernels()
+{
+    static const int iNumPixels[] = { 1, 7, 37, 130 };
+
+    for( int iISA = 0; iISA < ISA_TYPE_MAX; iISA++ )
+    {
+        if( !GetCPUInfo().m_bSupportsISA[iISA] )
+        {
+            continue;
+        }
+
+        const FilterKernels& Kernels = GetFilterKernels( (ISA_TYPE)iISA );
+
+        for( int iType = 0; iType < KERNEL_RADIUS_TYPE_MAX; iType++ )
+        {
+            if( NULL == Kernels.m_pfnGaussianRowFixed[iType] )
+            {
+                continue;
+            }
+
+            const int iKernelDiameter = ( iType + 1 ) * 4 + 1;
+            const float* pWeights = s_fGaussianWeights[iType];
+
+            for( int iCount = 0; iCount < (int)( sizeof( iNumPixels ) / sizeof( iNumPixels[0] ) ); iCount++ )
+            {
+                const int iPixels = iNumPixels[iCount];
+                const int iPlaneSize = iPixels + iKernelDiameter + 2 * MAX_VECTOR_WIDTH;
+
+                std::vector<float> Planes( iPlaneSize * 3 );
+                for( size_t i = 0; i < Planes.size(); i++ )
+                {
+                    Planes[i] = Random();
+                }
+
+                // Room for a whole vector past the end
+                std::vector<Float4> Looped( iPixels + MAX_VECTOR_WIDTH ), Fixed( iPixels + MAX_VECTOR_WIDTH );
+                memset( &Looped[0], 0, Looped.size() * sizeof( Float4 ) );
+                memset( &Fixed[0], 0, Fixed.size() * sizeof( Float4 ) );
+
+                Kernels.m_pfnGaussianRow( pWeights, iKernelDiameter, &Planes[0], &Planes[iPlaneSize], &Planes[iPlaneSize * 2], iPixels, &Looped[0] );
+                Kernels.m_pfnGaussianRowFixed[iType]( NULL, 0, &Planes[0], &Planes[iPlaneSize], &Planes[iPlaneSize * 2], iPixels, &Fixed[0] );
+                Check( 0 == memcmp( &Looped[0], &Fixed[0], iPixels * sizeof( Float4 ) ), "Gaussian fixed row %s radius %d pixels %d",
+                    GetISAName( (ISA_TYPE)iISA ), iKernelDiameter / 2, iPixels );
+
+                // Interleaved texels down the rows
+                const int iFloats = iPixels * 4;
+                std::vector<float> Rows( iKernelDiameter * iFloats );
+                const float* pRows[MAX_KERNEL_RADIUS * 2 + 1];
+                for( int iTap = 0; iTap < iKernelDiameter; iTap++ )
+                {
+                    pRows[iTap] = &Rows[iTap * iFloats];
+                }
+                for( size_t i = 0; i < Rows.size(); i++ )
+                {
+                    Rows[i] = Random();
+                }
+
+                Kernels.m_pfnGaussianColumn( pWeights, iKernelDiameter, pRows, iFloats, &Looped[0].x );
+                Kernels.m_pfnGaussianColumnFixed[iType]( NULL, 0, pRows, iFloats, &Fixed[0].x );
+                Check( 0 == memcmp( &Looped[0], &Fixed[0], iPixels * sizeof( Float4 ) ), "Gaussian fixed column %s radius %d pixels %d",
+                    GetISAName( (ISA_TYPE)iISA ), iKernelDiameter / 2, iPixels );
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// The passes of every radius type, which pick the specialized kernels, against the hooks
+//--------------------------------------------------------------------------------------
+static void TestPasses()
+{
+    const unsigned int uWidth = 157;
+    const unsigned int uHeight = 45;
+
+    Surface Input, Temp, Output, Reference;
+    Input.Create( uWidth, uHeight );
+    Temp.Create( uWidth, uHeight );
+    Output.Create( uWidth, uHeight );
+    Reference.Create( uWidth, uHeight );
+    FillRandom( Input, 0, 0, uWidth, uHeight );
+
+    const Surface* pInputs[1] = { &Input };
+    const Surface* pIntermediates[1] = { &Temp };
+
+    SeparableFilterCPU Filter;
+    Filter.SetOutputSize( uWidth, uHeight );
+    Filter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+
+    for( int iType = 0; iType < KERNEL_RADIUS_TYPE_MAX; iType++ )
+    {
+        const int iKernelRadius = ( iType + 1 ) * 2;
+
+        HorizontalFilter<GaussianFilter> HookX;
+        VerticalFilter<GaussianFilter> HookY;
+        HookX.SetKernel( iKernelRadius, false );
+        HookY.SetKernel( iKernelRadius, false );
+
+        Filter.SetOutputSurfaces( &Temp, &Reference );
+        Filter.SetFilters( &HookX, &HookY );
+        Filter.OnRender();
+
+        for( int iISA = 0; iISA < ISA_TYPE_MAX; iISA++ )
+        {
+            if( !GetCPUInfo().m_bSupportsISA[iISA] )
+            {
+                continue;
+            }
+
+            GaussianFilterX FilterX;
+            GaussianFilterY FilterY;
+            FilterX.SetISA( (ISA_TYPE)iISA );
+            FilterY.SetISA( (ISA_TYPE)iISA );
+            FilterX.SetKernel( iKernelRadius, false );
+            FilterY.SetKernel( iKernelRadius, false );
+
+            Filter.SetOutputSurfaces( &Temp, &Output );
+            Filter.SetFilters( &FilterX, &FilterY );
+            Filter.OnRender();
+            CheckError( MaxDifference( Reference, Output ), s_fTolerance, "Gaussian fixed X/Y %s radius %d",
+                GetISAName( (ISA_TYPE)iISA ), iKernelRadius );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Entry point of the tests of this file
+//--------------------------------------------------------------------------------------
+void TestGaussianFixed()
+{
+    TestWeights();
+    TestKernels();
+    TestPasses();
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,198 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestGaussianFixedPoint.cpp
+//
+// Tests the fixed point Gaussian of 8 bit surfaces against the float passes rounded to
+// 8 bits.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/GaussianFilterSIMD.h"
+#include "CPU/GaussianFilterFixedPoint.h"
+#include "CPU/CPUInfo.h"
+
+#include <stdlib.h>
+
+using namespace CPUFilter;
+
+
+// In 8 bit steps: the sums are rounded once in each pass, rather than once at the end
+static const float s_fTolerance = 1.0f;
+
+
+//--------------------------------------------------------------------------------------
+// Fills both copies of the input: a smooth gradient, random noise, or a flat color. The
+// rounding error of the quantized weights goes to the center tap, so they sum to exactly
+// one and the flat color is kept exactly.
+//--------------------------------------------------------------------------------------
+static void FillInputs( SurfaceUNorm8& Input8, Surface& Input, int iPattern )
+{
+    for( unsigned int uY = 0; uY < Input8.m_uHeight; uY++ )
+    {
+        for( unsigned int uX = 0; uX < Input8.m_uWidth; uX++ )
+        {
+            unsigned char* pTexel = Input8.Row( uY ) + uX * 4;
+            for( unsigned int uChannel = 0; uChannel < 3; uChannel++ )
+            {
+                if( 0 == iPattern )
+                {
+                    pTexel[uChannel] = (unsigned char)( ( ( uX * 7 + uY * 3 + uChannel * 50 ) / 3 ) & 255 );
+                }
+                else if( 1 == iPattern )
+                {
+                    pTexel[uChannel] = (unsigned char)( Random() * 255.0f + 0.5f );
+                }
+                else
+                {
+                    pTexel[uChannel] = (unsigned char)( 37 + uChannel * 100 );
+                }
+            }
+            pTexel[3] = 255;
+            Input.Row( uY )[uX] = MakeFloat4( pTexel[0] / 255.0f, pTexel[1] / 255.0f, pTexel[2] / 255.0f, 1.0f );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Every ISA, on sizes narrower than a vector, narrower than the kernel and several strips
+// wide, with a strip and band that divide neither the surface nor the vectors
+//--------------------------------------------------------------------------------------
+void TestGaussianFixedPoint()
+{
+    static const unsigned int uWidths[] = { 5, 37, 333 };
+    static const int iRadii[] = { 1, 2, 5, 16, 33, 64 };
+    static const char* pPatternNames[] = { "gradient", "noise", "flat" };
+    const unsigned int uHeight = 150;
+    const Surface* pNoSurfaces[1] = { NULL };
+
+    for( int iISA = 0; iISA < ISA_TYPE_MAX; iISA++ )
+    {
+        if( !GetCPUInfo().m_bSupportsISA[iISA] )
+        {
+            continue;
+        }
+
+        for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+        {
+            const unsigned int uWidth = uWidths[iSize];
+
+            SurfaceUNorm8 Input8, Output8;
+            Input8.Create( uWidth, uHeight );
+            Output8.Create( uWidth, uHeight );
+
+            Surface Input, Temp, Reference;
+            Input.Create( uWidth, uHeight );
+            Temp.Create( uWidth, uHeight );
+            Reference.Create( uWidth, uHeight );
+
+            for( int iPattern = 0; iPattern < (int)( sizeof( pPatternNames ) / sizeof( pPatternNames[0] ) ); iPattern++ )
+            {
+                FillInputs( Input8, Input, iPattern );
+
+                for( int iRadius = 0; iRadius < (int)( sizeof( iRadii ) / sizeof( iRadii[0] ) ); iRadius++ )
+                {
+                    const int iKernelRadius = iRadii[iRadius];
+                    const Surface* pInputs[1] = { &Input };
+                    const Surface* pIntermediates[1] = { &Temp };
+
+                    GaussianFilterX FilterX;
+                    GaussianFilterY FilterY;
+                    FilterX.SetISA( (ISA_TYPE)iISA );
+                    FilterY.SetISA( (ISA_TYPE)iISA );
+                    FilterX.SetKernel( iKernelRadius, false );
+                    FilterY.SetKernel( iKernelRadius, false );
+
+                    SeparableFilterCPU Filter;
+                    Filter.SetOutputSize( uWidth, uHeight );
+                    Filter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+                    Filter.SetOutputSurfaces( &Temp, &Reference );
+                    Filter.SetFilters( &FilterX, &FilterY );
+                    Filter.OnRender();
+
+                    GaussianFilterFixedPoint FilterFixed;
+                    FilterFixed.SetISA( (ISA_TYPE)iISA );
+                    FilterFixed.SetKernel( iKernelRadius, false );
+                    FilterFixed.SetUNorm8Surfaces( &Input8, &Output8 );
+                    if( 37 == uWidth )
+                    {
+                        FilterFixed.SetStripWidth( 7 );
+                        FilterFixed.SetBandHeight( 11 );
+                    }
+
+                    // The fixed point pass reads and writes its own surfaces
+                    Filter.SetInputSurfaces( pNoSurfaces, pNoSurfaces, 1 );
+                    Filter.SetOutputSurfaces( NULL, NULL );
+                    Filter.SetFusedFilter( &FilterFixed );
+                    Filter.OnRender();
+
+                    int iMaxError = 0;
+                    int iMaxFlatError = 0;
+                    int iMaxAlphaError = 0;
+                    for( unsigned int uY = 0; uY < uHeight; uY++ )
+                    {
+                        for( unsigned int uX = 0; uX < uWidth; uX++ )
+                        {
+                            const unsigned char* pInput = Input8.Row( uY ) + uX * 4;
+                            const unsigned char* pTexel = Output8.Row( uY ) + uX * 4;
+                            const Float4& Expected = Reference.Row( uY )[uX];
+                            const float fExpected[3] = { Expected.x, Expected.y, Expected.z };
+
+                            for( int iChannel = 0; iChannel < 3; iChannel++ )
+                            {
+                                const int iError = abs( (int)( fExpected[iChannel] * 255.0f + 0.5f ) - (int)pTexel[iChannel] );
+                                iMaxError = ( iError > iMaxError ) ? iError : iMaxError;
+
+                                const int iFlatError = abs( (int)pInput[iChannel] - (int)pTexel[iChannel] );
+                                iMaxFlatError = ( iFlatError > iMaxFlatError ) ? iFlatError : iMaxFlatError;
+                            }
+
+                            const int iAlphaError = 255 - (int)pTexel[3];
+                            iMaxAlphaError = ( iAlphaError > iMaxAlphaError ) ? iAlphaError : iMaxAlphaError;
+                        }
+                    }
+
+                    CheckError( (float)iMaxError, s_fTolerance, "Fixed point %s %s width %u radius %d", pPatternNames[iPattern], GetISAName( (ISA_TYPE)iISA ),
+                        uWidth, iKernelRadius );
+                    CheckError( (float)iMaxAlphaError, 0.0f, "Fixed point %s alpha %s width %u radius %d", pPatternNames[iPattern], GetISAName( (ISA_TYPE)iISA ),
+                        uWidth, iKernelRadius );
+                    if( 2 == iPattern )
+                    {
+                        CheckError( (float)iMaxFlatError, 0.0f, "Fixed point flat %s width %u radius %d is not kept", GetISAName( (ISA_TYPE)iISA ), uWidth,
+                            iKernelRadius );
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
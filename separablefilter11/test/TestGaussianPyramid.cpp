@@ -0,0 +1,243 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestGaussianPyramid.cpp
+//
+// Tests which deviations are routed through the pyramid, and the pyramid's output against
+// a direct Gaussian of its deviation.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/GaussianPyramid.h"
+#include "CPU/GaussianFilter.h"
+
+#include <math.h>
+#include <vector>
+
+using namespace CPUFilter;
+
+
+// As g_fGaussianTolerance in the sample
+static const float s_fGaussianTolerance = 0.001f;
+
+// Away from the borders, where each level clamps to its own edge texels
+static const float s_fInteriorTolerance = 1.5e-3f;
+
+// Of the impulse response's deviation
+static const float s_fDeviationTolerance = 0.01f;
+
+
+//--------------------------------------------------------------------------------------
+// Every step of the sample's deviation slider either has a radius permutation that holds
+// it within the tolerance, or requires the pyramid, whose coarse level then fits one
+//--------------------------------------------------------------------------------------
+static void TestRouting()
+{
+    Check( !RequiresPyramid( 0.0f, s_fGaussianTolerance ), "The default deviation requires the pyramid" );
+
+    bool bAnyPyramid = false;
+    for( int iStep = 1; iStep <= 32; iStep++ )
+    {
+        const float fDeviation = (float)iStep * 0.5f;
+        const int iRadius = ComputeGaussianRadius( fDeviation, s_fGaussianTolerance );
+        const bool bPyramid = RequiresPyramid( fDeviation, s_fGaussianTolerance );
+        bAnyPyramid = bAnyPyramid || bPyramid;
+
+        if( !bPyramid )
+        {
+            Check( KERNEL_RADIUS_TYPE_MAX != GetKernelRadiusType( ( iRadius + 1 ) & ~1 ), "Deviation %g needs radius %d, but is not routed through the pyramid",
+                fDeviation, iRadius );
+            continue;
+        }
+
+        Check( iRadius > ( KERNEL_RADIUS_TYPE_32 + 1 ) * 2, "Deviation %g fits radius %d, but is routed through the pyramid", fDeviation, iRadius );
+
+        float fCoarseDeviation = 0.0f;
+        const int iNumLevels = ComputePyramidLevels( fDeviation, 4.0f, &fCoarseDeviation );
+        const int iCoarseRadius = ComputeGaussianRadius( fCoarseDeviation, s_fGaussianTolerance );
+        Check( iNumLevels > 0 && KERNEL_RADIUS_TYPE_MAX != GetKernelRadiusType( ( iCoarseRadius + 1 ) & ~1 ),
+            "Deviation %g leaves %g for the coarse level of %d levels, radius %d", fDeviation, fCoarseDeviation, iNumLevels, iCoarseRadius );
+    }
+
+    Check( bAnyPyramid, "No step of the deviation slider reaches the pyramid" );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Direct Gaussian of a line of iCount values in doubles, clamped at its ends, out to 5
+// deviations
+//--------------------------------------------------------------------------------------
+static void GaussianLine( const double* pSrc, int iStride, int iCount, double dDeviation, double* pDst )
+{
+    const int iRadius = (int)ceil( dDeviation * 5.0 );
+
+    std::vector<double> Weights( iRadius + 1 );
+    double dSum = 0.0;
+    for( int i = 0; i <= iRadius; i++ )
+    {
+        Weights[i] = exp( -0.5 * i * i / ( dDeviation * dDeviation ) );
+        dSum += ( 0 == i ) ? Weights[i] : 2.0 * Weights[i];
+    }
+
+    for( int iOut = 0; iOut < iCount; iOut++ )
+    {
+        double dValue = 0.0;
+        for( int i = -iRadius; i <= iRadius; i++ )
+        {
+            const int iIn = iOut + i;
+            dValue += Weights[( i < 0 ) ? -i : i] * pSrc[( ( iIn < 0 ) ? 0 : ( iIn >= iCount ) ? iCount - 1 : iIn ) * iStride];
+        }
+        pDst[iOut * iStride] = dValue / dSum;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// The pyramid on a checkerboard against the direct Gaussian away from the borders, and the
+// deviation of its response to an impulse
+//--------------------------------------------------------------------------------------
+static void TestPyramid()
+{
+    static const float fDeviations[] = { 10.0f, 16.0f, 24.0f, 40.0f };
+    static const unsigned int uWidth = 400;
+    static const unsigned int uHeight = 320;
+
+    Surface Input, Impulse, Output;
+    Input.Create( uWidth, uHeight );
+    Impulse.Create( uWidth, uHeight );
+    Output.Create( uWidth, uHeight );
+
+    // Squares of 64 texels, with one channel of noise
+    std::vector<double> Texels( uWidth * uHeight );
+    for( unsigned int uY = 0; uY < uHeight; uY++ )
+    {
+        for( unsigned int uX = 0; uX < uWidth; uX++ )
+        {
+            const float fValue = ( 0 != ( ( uX / 64 + uY / 64 ) & 1 ) ) ? 1.0f : 0.0f;
+            Input.Row( uY )[uX] = MakeFloat4( fValue, Random(), 0.5f, 1.0f );
+            Impulse.Row( uY )[uX] = MakeFloat4( ( uX == uWidth / 2 && uY == uHeight / 2 ) ? 1.0f : 0.0f, 0.0f, 0.0f, 1.0f );
+            Texels[uY * uWidth + uX] = fValue;
+        }
+    }
+
+    GaussianPyramid Pyramid;
+    Pyramid.Create( uWidth, uHeight );
+
+    std::vector<double> Temp( uWidth * uHeight ), Reference( uWidth * uHeight );
+    for( int iDeviation = 0; iDeviation < (int)( sizeof( fDeviations ) / sizeof( fDeviations[0] ) ); iDeviation++ )
+    {
+        const float fDeviation = fDeviations[iDeviation];
+        Pyramid.SetDeviation( fDeviation );
+
+        for( unsigned int uY = 0; uY < uHeight; uY++ )
+        {
+            GaussianLine( &Texels[uY * uWidth], 1, (int)uWidth, fDeviation, &Temp[uY * uWidth] );
+        }
+        for( unsigned int uX = 0; uX < uWidth; uX++ )
+        {
+            GaussianLine( &Temp[uX], (int)uWidth, (int)uHeight, fDeviation, &Reference[uX] );
+        }
+
+        FillRandom( Output, 0, 0, uWidth, uHeight );
+        Pyramid.OnRender( Input, Output );
+
+        // 3 deviations in from the borders
+        const int iMargin = (int)( fDeviation * 3.0f );
+        float fMaxError = 0.0f;
+        for( int iY = iMargin; iY < (int)uHeight - iMargin; iY++ )
+        {
+            for( int iX = iMargin; iX < (int)uWidth - iMargin; iX++ )
+            {
+                const float fError = fabsf( Output.Row( iY )[iX].x - (float)Reference[iY * uWidth + iX] );
+                fMaxError = ( fError > fMaxError ) ? fError : fMaxError;
+            }
+        }
+        CheckError( fMaxError, s_fInteriorTolerance, "Gaussian pyramid deviation %g, %d levels", fDeviation, Pyramid.GetNumLevels() );
+
+        // The weights sum to 1, so constant channels stay constant
+        float fMaxConstantError = 0.0f;
+        for( unsigned int uY = 0; uY < uHeight; uY++ )
+        {
+            for( unsigned int uX = 0; uX < uWidth; uX++ )
+            {
+                const Float4& f4Texel = Output.Row( uY )[uX];
+                const float fError = ( fabsf( f4Texel.z - 0.5f ) > fabsf( f4Texel.w - 1.0f ) ) ? fabsf( f4Texel.z - 0.5f ) : fabsf( f4Texel.w - 1.0f );
+                fMaxConstantError = ( fError > fMaxConstantError ) ? fError : fMaxConstantError;
+            }
+        }
+        CheckError( fMaxConstantError, 1e-6f, "Gaussian pyramid deviation %g on constant channels", fDeviation );
+
+        // The second moments of the impulse response about its center
+        Pyramid.OnRender( Impulse, Output );
+
+        double dSum = 0.0, dSumX = 0.0, dSumY = 0.0;
+        for( unsigned int uY = 0; uY < uHeight; uY++ )
+        {
+            for( unsigned int uX = 0; uX < uWidth; uX++ )
+            {
+                const double dValue = Output.Row( uY )[uX].x;
+                dSum += dValue;
+                dSumX += dValue * uX;
+                dSumY += dValue * uY;
+            }
+        }
+        const double dCenterX = dSumX / dSum;
+        const double dCenterY = dSumY / dSum;
+
+        double dVarianceX = 0.0, dVarianceY = 0.0;
+        for( unsigned int uY = 0; uY < uHeight; uY++ )
+        {
+            for( unsigned int uX = 0; uX < uWidth; uX++ )
+            {
+                const double dValue = Output.Row( uY )[uX].x;
+                dVarianceX += dValue * ( uX - dCenterX ) * ( uX - dCenterX );
+                dVarianceY += dValue * ( uY - dCenterY ) * ( uY - dCenterY );
+            }
+        }
+
+        const double dDeviationX = sqrt( dVarianceX / dSum );
+        const double dDeviationY = sqrt( dVarianceY / dSum );
+        CheckError( (float)( fabs( dDeviationX - fDeviation ) / fDeviation ), s_fDeviationTolerance, "Gaussian pyramid deviation %g, impulse response in x of %g",
+            fDeviation, dDeviationX );
+        CheckError( (float)( fabs( dDeviationY - fDeviation ) / fDeviation ), s_fDeviationTolerance, "Gaussian pyramid deviation %g, impulse response in y of %g",
+            fDeviation, dDeviationY );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Runs the pyramid tests
+//--------------------------------------------------------------------------------------
+void TestGaussianPyramid()
+{
+    TestRouting();
+    TestPyramid();
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
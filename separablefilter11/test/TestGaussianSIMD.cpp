@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestGaussianSIMD.cpp
+//
+// Tests the vectorized Gaussian passes of every instruction set, separate and fused,
+// against the hooks.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/HorizontalFilter.h"
+#include "CPU/VerticalFilter.h"
+#include "CPU/GaussianFilter.h"
+#include "CPU/GaussianFilterSIMD.h"
+#include "CPU/CPUInfo.h"
+
+using namespace CPUFilter;
+
+
+// The passes sum in a different order than the hooks
+static const float s_fTolerance = 1e-5f;
+
+
+//--------------------------------------------------------------------------------------
+// Each pass, on sizes that fill a group, leave a vector partly empty, and are narrower
+// or shorter than the kernel
+//--------------------------------------------------------------------------------------
+void TestGaussianSIMD()
+{
+    static const unsigned int uWidths[] = { 333, 5, 140 };
+    static const unsigned int uHeights[] = { 61, 40, 3 };
+    static const int iRadii[] = { 1, 2, 7, 16, MAX_KERNEL_RADIUS };
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        const unsigned int uWidth = uWidths[iSize];
+        const unsigned int uHeight = uHeights[iSize];
+
+        Surface Input, Temp, Output, Reference;
+        Input.Create( uWidth, uHeight );
+        Temp.Create( uWidth, uHeight );
+        Output.Create( uWidth, uHeight );
+        Reference.Create( uWidth, uHeight );
+        FillRandom( Input, 0, 0, uWidth, uHeight );
+
+        const Surface* pInputs[1] = { &Input };
+        const Surface* pIntermediates[1] = { &Temp };
+
+        SeparableFilterCPU Filter;
+        Filter.SetOutputSize( uWidth, uHeight );
+        Filter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+
+        for( int iRadius = 0; iRadius < (int)( sizeof( iRadii ) / sizeof( iRadii[0] ) ); iRadius++ )
+        {
+            const int iKernelRadius = iRadii[iRadius];
+
+            HorizontalFilter<GaussianFilter> HookX;
+            VerticalFilter<GaussianFilter> HookY;
+            HookX.SetKernel( iKernelRadius, false );
+            HookY.SetKernel( iKernelRadius, false );
+
+            Filter.SetOutputSurfaces( &Temp, &Reference );
+            Filter.SetFilters( &HookX, &HookY );
+            Filter.OnRender();
+
+            for( int iISA = 0; iISA < ISA_TYPE_MAX; iISA++ )
+            {
+                if( !GetCPUInfo().m_bSupportsISA[iISA] )
+                {
+                    continue;
+                }
+
+                GaussianFilterX FilterX;
+                FilterX.SetISA( (ISA_TYPE)iISA );
+                FilterX.SetKernel( iKernelRadius, false );
+
+                Filter.SetOutputSurfaces( &Temp, &Output );
+                Filter.SetFilters( &FilterX, &HookY );
+                Filter.OnRender();
+                CheckError( MaxDifference( Reference, Output ), s_fTolerance, "Gaussian X %s %ux%u radius %d",
+                    GetISAName( (ISA_TYPE)iISA ), uWidth, uHeight, iKernelRadius );
+
+                // Strips sized from the caches, a whole number of vectors, and a partial vector
+                static const int iStripWidths[] = { 0, 16, 7 };
+                for( int iStrip = 0; iStrip < (int)( sizeof( iStripWidths ) / sizeof( iStripWidths[0] ) ); iStrip++ )
+                {
+                    GaussianFilterY FilterY;
+                    FilterY.SetISA( (ISA_TYPE)iISA );
+                    FilterY.SetKernel( iKernelRadius, false );
+                    FilterY.SetStripWidth( iStripWidths[iStrip] );
+
+                    Filter.SetFilters( &HookX, &FilterY );
+                    Filter.OnRender();
+                    CheckError( MaxDifference( Reference, Output ), s_fTolerance, "Gaussian Y %s %ux%u radius %d strip %d",
+                        GetISAName( (ISA_TYPE)iISA ), uWidth, uHeight, iKernelRadius, iStripWidths[iStrip] );
+                }
+
+                // Bands sized from the kernel, one line, and a height that is not a multiple of
+                // RUN_SIZE, so a band may end before the surface does
+                static const int iBandHeights[] = { 0, 1, 13 };
+                for( int iStrip = 0; iStrip < (int)( sizeof( iStripWidths ) / sizeof( iStripWidths[0] ) ); iStrip++ )
+                {
+                    for( int iBand = 0; iBand < (int)( sizeof( iBandHeights ) / sizeof( iBandHeights[0] ) ); iBand++ )
+                    {
+                        GaussianFilterFused FilterFused;
+                        FilterFused.SetISA( (ISA_TYPE)iISA );
+                        FilterFused.SetKernel( iKernelRadius, false );
+                        FilterFused.SetStripWidth( iStripWidths[iStrip] );
+                        FilterFused.SetBandHeight( iBandHeights[iBand] );
+
+                        // Start from stale content, so a band left unwritten is caught
+                        FillRandom( Output, 0, 0, uWidth, uHeight );
+                        Filter.SetOutputSurfaces( NULL, &Output );
+                        Filter.SetFusedFilter( &FilterFused );
+                        Filter.OnRender();
+                        Filter.SetFusedFilter( NULL );
+                        Filter.SetOutputSurfaces( &Temp, &Output );
+                        CheckError( MaxDifference( Reference, Output ), s_fTolerance, "Gaussian fused %s %ux%u radius %d strip %d band %d",
+                            GetISAName( (ISA_TYPE)iISA ), uWidth, uHeight, iKernelRadius, iStripWidths[iStrip], iBandHeights[iBand] );
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,362 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestHalfFloat.cpp
+//
+// Tests the half conversions, scalar and of every instruction set, and the Gaussian passes
+// with a half intermediate.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/HorizontalFilter.h"
+#include "CPU/VerticalFilter.h"
+#include "CPU/GaussianFilter.h"
+#include "CPU/GaussianFilterSIMD.h"
+#include "CPU/HalfFloat.h"
+#include "CPU/SIMD.h"
+#include "CPU/CPUInfo.h"
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+using namespace CPUFilter;
+
+
+// Relative to the output, as a half keeps 11 significant bits
+static const float s_fHalfTolerance = 1e-3f;
+
+// Largest HDR input
+static const float s_fHDRScale = 1000.0f;
+
+
+//--------------------------------------------------------------------------------------
+// Float of the given bits
+//--------------------------------------------------------------------------------------
+static float FloatFromBits( unsigned int uBits )
+{
+    float fValue;
+    memcpy( &fValue, &uBits, sizeof( fValue ) );
+
+    return fValue;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Bits of the given float
+//--------------------------------------------------------------------------------------
+static unsigned int BitsFromFloat( float fValue )
+{
+    unsigned int uBits;
+    memcpy( &uBits, &fValue, sizeof( uBits ) );
+
+    return uBits;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Every half converts to the float of its value, and back to itself. NaNs come back quiet.
+//--------------------------------------------------------------------------------------
+static void TestRoundTrip()
+{
+    for( unsigned int uHalf = 0; uHalf < 0x10000; uHalf++ )
+    {
+        const unsigned int uExponent = ( uHalf >> 10 ) & 0x1F;
+        const unsigned int uMantissa = uHalf & 0x3FF;
+        const float fValue = HalfToFloat( (unsigned short)uHalf );
+
+        if( 0x1F == uExponent && 0 != uMantissa )
+        {
+            Check( fValue != fValue && 0 != ( BitsFromFloat( fValue ) & 0x400000 ), "Half 0x%04x is not a quiet NaN", uHalf );
+            Check( FloatToHalf( fValue ) == ( uHalf | 0x200 ), "Half 0x%04x round trips to 0x%04x", uHalf, FloatToHalf( fValue ) );
+            continue;
+        }
+
+        // The value from its fields, 2^-24 units for denormals
+        double dValue = ( 0x1F == uExponent ) ? HUGE_VAL :
+            ( 0 == uExponent ) ? ldexp( (double)uMantissa, -24 ) : ldexp( (double)( uMantissa | 0x400 ), (int)uExponent - 25 );
+        dValue = ( uHalf & 0x8000 ) ? -dValue : dValue;
+
+        Check( (double)fValue == dValue && ( BitsFromFloat( fValue ) >> 31 ) == ( uHalf >> 15 ), "Half 0x%04x converts to %g, not %g", uHalf, fValue, dValue );
+        Check( FloatToHalf( fValue ) == uHalf, "Half 0x%04x round trips to 0x%04x", uHalf, FloatToHalf( fValue ) );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Floats at the roundings and limits of a half
+//--------------------------------------------------------------------------------------
+struct EdgeCase
+{
+    unsigned int    uFloat;
+    unsigned short  uHalf;
+};
+
+static const EdgeCase s_EdgeCases[] =
+{
+    { 0x00000000, 0x0000 },     // 0
+    { 0x80000000, 0x8000 },     // -0
+    { 0x3F800000, 0x3C00 },     // 1
+    { 0x3F801000, 0x3C00 },     // 1 + 2^-11, a tie to the even 1
+    { 0x3F801001, 0x3C01 },     // Just above the tie
+    { 0x3F803000, 0x3C02 },     // 1 + 3 * 2^-11, a tie to the even 1 + 2^-9
+    { 0x3F802FFF, 0x3C01 },     // Just below that tie
+    { 0x3FFFF000, 0x4000 },     // A tie that carries into the exponent
+    { 0x38800000, 0x0400 },     // 2^-14, the smallest normal
+    { 0x387FC000, 0x03FF },     // The largest denormal
+    { 0x387FE000, 0x0400 },     // A tie between the largest denormal and the smallest normal
+    { 0x33800000, 0x0001 },     // 2^-24, the smallest denormal
+    { 0x33000000, 0x0000 },     // 2^-25, a tie to the even 0
+    { 0x33000001, 0x0001 },     // Just above 2^-25
+    { 0x33C00000, 0x0002 },     // 3 * 2^-25, a tie to the even 2 * 2^-24
+    { 0x34200000, 0x0002 },     // 5 * 2^-25, a tie to the even 2 * 2^-24
+    { 0x00000001, 0x0000 },     // The smallest float denormal
+    { 0x80000001, 0x8000 },     // Its negative
+    { 0x477FE000, 0x7BFF },     // 65504, the largest half
+    { 0x477FEFFF, 0x7BFF },     // Just below 65520
+    { 0x477FF000, 0x7C00 },     // 65520, the tie to infinity
+    { 0xC77FF000, 0xFC00 },     // -65520
+    { 0x7F7FFFFF, 0x7C00 },     // The largest float
+    { 0x7F800000, 0x7C00 },     // Infinity
+    { 0xFF800000, 0xFC00 },     // -Infinity
+    { 0x7FC00000, 0x7E00 },     // Quiet NaN
+    { 0x7F800001, 0x7E00 },     // Signaling NaN with its payload below a half's mantissa
+    { 0xFFFFE000, 0xFFFF },     // Negative NaN with a full payload
+    { 0xC0490FDB, 0xC248 },     // -pi
+};
+
+
+//--------------------------------------------------------------------------------------
+// The scalar conversion of each edge case
+//--------------------------------------------------------------------------------------
+static void TestEdgeCases()
+{
+    for( int iCase = 0; iCase < (int)( sizeof( s_EdgeCases ) / sizeof( s_EdgeCases[0] ) ); iCase++ )
+    {
+        const unsigned short uHalf = FloatToHalf( FloatFromBits( s_EdgeCases[iCase].uFloat ) );
+        Check( uHalf == s_EdgeCases[iCase].uHalf, "Float 0x%08x converts to half 0x%04x, not 0x%04x",
+            s_EdgeCases[iCase].uFloat, uHalf, s_EdgeCases[iCase].uHalf );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// The row conversions of every instruction set match the scalar ones, bit for bit, on the
+// edge cases, every half, and a sweep over the floats, with counts that end in a partial
+// vector
+//--------------------------------------------------------------------------------------
+static void TestRows()
+{
+    std::vector<float> Floats;
+    for( int iCase = 0; iCase < (int)( sizeof( s_EdgeCases ) / sizeof( s_EdgeCases[0] ) ); iCase++ )
+    {
+        Floats.push_back( FloatFromBits( s_EdgeCases[iCase].uFloat ) );
+    }
+    for( unsigned int uHalf = 0; uHalf < 0x10000; uHalf++ )
+    {
+        Floats.push_back( HalfToFloat( (unsigned short)uHalf ) );
+    }
+    for( unsigned long long uBits = 0; uBits <= 0xFFFFFFFFull; uBits += 4093 )
+    {
+        Floats.push_back( FloatFromBits( (unsigned int)uBits ) );
+    }
+
+    std::vector<unsigned short> Halves( 0x10000 );
+    for( unsigned int uHalf = 0; uHalf < 0x10000; uHalf++ )
+    {
+        Halves[uHalf] = (unsigned short)uHalf;
+    }
+
+    std::vector<unsigned short> HalfResult( Floats.size() + 1 );
+    std::vector<float> FloatResult( Halves.size() + 1 );
+
+    for( int iISA = 0; iISA < ISA_TYPE_MAX; iISA++ )
+    {
+        if( !GetCPUInfo().m_bSupportsISA[iISA] )
+        {
+            continue;
+        }
+
+        const FilterKernels& Kernels = GetFilterKernels( (ISA_TYPE)iISA );
+
+        static const int iCounts[] = { -1, 13, 1 };
+        for( int iCount = 0; iCount < (int)( sizeof( iCounts ) / sizeof( iCounts[0] ) ); iCount++ )
+        {
+            // A sentinel past the end catches writes beyond the count
+            const int iNumFloats = ( iCounts[iCount] < 0 ) ? (int)Floats.size() : iCounts[iCount];
+            HalfResult[iNumFloats] = 0xABCD;
+            Kernels.m_pfnFloatToHalfRow( &Floats[0], iNumFloats, &HalfResult[0] );
+
+            int iMismatches = 0;
+            for( int i = 0; i < iNumFloats; i++ )
+            {
+                iMismatches += ( HalfResult[i] != FloatToHalf( Floats[i] ) ) ? 1 : 0;
+            }
+            Check( 0 == iMismatches, "FloatToHalfRow %s of %d floats has %d mismatches", GetISAName( (ISA_TYPE)iISA ), iNumFloats, iMismatches );
+            Check( 0xABCD == HalfResult[iNumFloats], "FloatToHalfRow %s of %d floats wrote past the end", GetISAName( (ISA_TYPE)iISA ), iNumFloats );
+
+            const int iNumHalves = ( iCounts[iCount] < 0 ) ? (int)Halves.size() : iCounts[iCount];
+            FloatResult[iNumHalves] = 1234.0f;
+            Kernels.m_pfnHalfToFloatRow( &Halves[0], iNumHalves, &FloatResult[0] );
+
+            iMismatches = 0;
+            for( int i = 0; i < iNumHalves; i++ )
+            {
+                iMismatches += ( BitsFromFloat( FloatResult[i] ) != BitsFromFloat( HalfToFloat( Halves[i] ) ) ) ? 1 : 0;
+            }
+            Check( 0 == iMismatches, "HalfToFloatRow %s of %d halves has %d mismatches", GetISAName( (ISA_TYPE)iISA ), iNumHalves, iMismatches );
+            Check( 1234.0f == FloatResult[iNumHalves], "HalfToFloatRow %s of %d halves wrote past the end", GetISAName( (ISA_TYPE)iISA ), iNumHalves );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Largest difference over the color channels relative to the reference, or to 1 for
+// references under 1
+//--------------------------------------------------------------------------------------
+static float MaxRelativeDifference( const Surface& Reference, const Surface& Output )
+{
+    float fMax = 0.0f;
+
+    for( unsigned int uY = 0; uY < Reference.m_uHeight; uY++ )
+    {
+        const float* pReference = &Reference.Row( uY )->x;
+        const float* pOutput = &Output.Row( uY )->x;
+        for( unsigned int uChannel = 0; uChannel < Reference.m_uWidth * 4; uChannel++ )
+        {
+            const float fScale = ( fabsf( pReference[uChannel] ) > 1.0f ) ? fabsf( pReference[uChannel] ) : 1.0f;
+            const float fDifference = fabsf( pOutput[uChannel] - pReference[uChannel] ) / fScale;
+            fMax = ( fDifference > fMax ) ? fDifference : fMax;
+        }
+    }
+
+    return fMax;
+}
+
+
+//--------------------------------------------------------------------------------------
+// The separate passes through a half intermediate against the hooks, on HDR inputs
+//--------------------------------------------------------------------------------------
+static void TestIntermediate()
+{
+    static const unsigned int uWidths[] = { 213, 5 };
+    static const unsigned int uHeights[] = { 97, 40 };
+    static const int iRadii[] = { 1, 4, 16, 40 };
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        const unsigned int uWidth = uWidths[iSize];
+        const unsigned int uHeight = uHeights[iSize];
+
+        Surface Input, Temp, Output, Reference;
+        HalfSurface HalfTemp;
+        Input.Create( uWidth, uHeight );
+        Temp.Create( uWidth, uHeight );
+        Output.Create( uWidth, uHeight );
+        Reference.Create( uWidth, uHeight );
+        HalfTemp.Create( uWidth, uHeight );
+
+        // Mostly above 1, over several orders of magnitude
+        for( unsigned int uY = 0; uY < uHeight; uY++ )
+        {
+            for( unsigned int uX = 0; uX < uWidth; uX++ )
+            {
+                Input.Row( uY )[uX] = MakeFloat4( Random() * s_fHDRScale, powf( s_fHDRScale, Random() ), Random() * 4.0f, 1.0f );
+            }
+        }
+
+        const Surface* pInputs[1] = { &Input };
+        const Surface* pIntermediates[1] = { &Temp };
+
+        SeparableFilterCPU Filter;
+        Filter.SetOutputSize( uWidth, uHeight );
+        Filter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+
+        for( int iRadius = 0; iRadius < (int)( sizeof( iRadii ) / sizeof( iRadii[0] ) ); iRadius++ )
+        {
+            const int iKernelRadius = iRadii[iRadius];
+
+            HorizontalFilter<GaussianFilter> HookX;
+            VerticalFilter<GaussianFilter> HookY;
+            HookX.SetKernel( iKernelRadius, false );
+            HookY.SetKernel( iKernelRadius, false );
+
+            Filter.SetOutputSurfaces( &Temp, &Reference );
+            Filter.SetFilters( &HookX, &HookY );
+            Filter.OnRender();
+
+            for( int iISA = 0; iISA < ISA_TYPE_MAX; iISA++ )
+            {
+                if( !GetCPUInfo().m_bSupportsISA[iISA] )
+                {
+                    continue;
+                }
+
+                GaussianFilterX FilterX;
+                FilterX.SetISA( (ISA_TYPE)iISA );
+                FilterX.SetKernel( iKernelRadius, false );
+                FilterX.SetHalfOutput( &HalfTemp );
+
+                // Strips sized from the caches and a partial vector
+                static const int iStripWidths[] = { 0, 7 };
+                for( int iStrip = 0; iStrip < (int)( sizeof( iStripWidths ) / sizeof( iStripWidths[0] ) ); iStrip++ )
+                {
+                    GaussianFilterY FilterY;
+                    FilterY.SetISA( (ISA_TYPE)iISA );
+                    FilterY.SetKernel( iKernelRadius, false );
+                    FilterY.SetStripWidth( iStripWidths[iStrip] );
+                    FilterY.SetHalfInput( &HalfTemp );
+
+                    FillRandom( Output, 0, 0, uWidth, uHeight );
+                    Filter.SetOutputSurfaces( NULL, &Output );
+                    Filter.SetFilters( &FilterX, &FilterY );
+                    Filter.OnRender();
+                    CheckError( MaxRelativeDifference( Reference, Output ), s_fHalfTolerance, "Half intermediate %s %ux%u radius %d strip %d",
+                        GetISAName( (ISA_TYPE)iISA ), uWidth, uHeight, iKernelRadius, iStripWidths[iStrip] );
+                }
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Runs the half float tests
+//--------------------------------------------------------------------------------------
+void TestHalfFloat()
+{
+    TestRoundTrip();
+    TestEdgeCases();
+    TestRows();
+    TestIntermediate();
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,130 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestHookFilter.cpp
+//
+// Tests the hook driven passes of the CPU filter engine against a direct convolution.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/HorizontalFilter.h"
+#include "CPU/VerticalFilter.h"
+#include "CPU/GaussianFilter.h"
+
+using namespace CPUFilter;
+
+
+//--------------------------------------------------------------------------------------
+// Gaussian of the default deviation, half the radius, applied along one axis with the
+// edges clamped, normalized by the sum of the weights
+//--------------------------------------------------------------------------------------
+static void ConvolveGaussian( const Surface& Input, Surface& Output, int iKernelRadius, bool bVertical )
+{
+    const int iWidth = (int)Input.m_uWidth;
+    const int iHeight = (int)Input.m_uHeight;
+
+    for( int iY = 0; iY < iHeight; iY++ )
+    {
+        for( int iX = 0; iX < iWidth; iX++ )
+        {
+            double dSum[3] = { 0.0, 0.0, 0.0 };
+            double dWeightSum = 0.0;
+
+            for( int iTap = -iKernelRadius; iTap <= iKernelRadius; iTap++ )
+            {
+                const int iTapX = bVertical ? iX : Clamp( iX + iTap, 0, iWidth - 1 );
+                const int iTapY = bVertical ? Clamp( iY + iTap, 0, iHeight - 1 ) : iY;
+                const Float4& Texel = Input.Row( iTapY )[iTapX];
+                const double dWeight = GaussianWeight( (float)iTap, (float)iKernelRadius * 0.5f );
+
+                dSum[0] += Texel.x * dWeight;
+                dSum[1] += Texel.y * dWeight;
+                dSum[2] += Texel.z * dWeight;
+                dWeightSum += dWeight;
+            }
+
+            Output.Row( iY )[iX] = MakeFloat4( (float)( dSum[0] / dWeightSum ), (float)( dSum[1] / dWeightSum ), (float)( dSum[2] / dWeightSum ), 1.0f );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Both passes of the Gaussian hooks, on sizes that fill a group, leave a group partly
+// empty, and are narrower or shorter than the kernel
+//--------------------------------------------------------------------------------------
+void TestHookFilter()
+{
+    static const unsigned int uWidths[] = { 97, 5, 140 };
+    static const unsigned int uHeights[] = { 61, 40, 3 };
+    static const int iRadii[] = { 1, 2, 7, 16, MAX_KERNEL_RADIUS };
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        const unsigned int uWidth = uWidths[iSize];
+        const unsigned int uHeight = uHeights[iSize];
+
+        Surface Input, Temp, Output, ReferenceTemp, Reference;
+        Input.Create( uWidth, uHeight );
+        Temp.Create( uWidth, uHeight );
+        Output.Create( uWidth, uHeight );
+        ReferenceTemp.Create( uWidth, uHeight );
+        Reference.Create( uWidth, uHeight );
+        FillRandom( Input, 0, 0, uWidth, uHeight );
+
+        const Surface* pInputs[1] = { &Input };
+        const Surface* pIntermediates[1] = { &Temp };
+
+        SeparableFilterCPU Filter;
+        Filter.SetOutputSize( uWidth, uHeight );
+        Filter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+        Filter.SetOutputSurfaces( &Temp, &Output );
+
+        for( int iRadius = 0; iRadius < (int)( sizeof( iRadii ) / sizeof( iRadii[0] ) ); iRadius++ )
+        {
+            const int iKernelRadius = iRadii[iRadius];
+
+            HorizontalFilter<GaussianFilter> FilterX;
+            VerticalFilter<GaussianFilter> FilterY;
+            FilterX.SetKernel( iKernelRadius, false );
+            FilterY.SetKernel( iKernelRadius, false );
+            Filter.SetFilters( &FilterX, &FilterY );
+            Filter.OnRender();
+
+            ConvolveGaussian( Input, ReferenceTemp, iKernelRadius, false );
+            ConvolveGaussian( ReferenceTemp, Reference, iKernelRadius, true );
+
+            CheckError( MaxDifference( Temp, ReferenceTemp ), 1e-5f, "Hook filter horizontal %ux%u radius %d", uWidth, uHeight, iKernelRadius );
+            CheckError( MaxDifference( Output, Reference ), 1e-5f, "Hook filter %ux%u radius %d", uWidth, uHeight, iKernelRadius );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
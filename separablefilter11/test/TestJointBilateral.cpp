@@ -0,0 +1,275 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestJointBilateral.cpp
+//
+// Tests the vectorized joint bilateral passes of every instruction set against the hooks,
+// with depth and color guides, and that neither mixes across a guide edge.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/HorizontalFilter.h"
+#include "CPU/VerticalFilter.h"
+#include "CPU/JointBilateralFilter.h"
+#include "CPU/JointBilateralFilterSIMD.h"
+#include "CPU/CPUInfo.h"
+
+#include <math.h>
+
+using namespace CPUFilter;
+
+
+// The passes sum in a different order than the hooks, and a guide distance rounding across
+// an entry of the range table changes the weight by a step
+static const float s_fTolerance = 1e-5f;
+
+// Averaging a flat region only rounds
+static const float s_fEdgeTolerance = 1e-6f;
+
+
+//--------------------------------------------------------------------------------------
+// Fills the input, and either a depth buffer of planes at three depths or a color guide
+// of smooth gradients and blocks
+//--------------------------------------------------------------------------------------
+static void FillInputs( Surface& Input, Surface& Guide, const float* pProjParams, bool bDepthGuide )
+{
+    for( unsigned int uY = 0; uY < Input.m_uHeight; uY++ )
+    {
+        for( unsigned int uX = 0; uX < Input.m_uWidth; uX++ )
+        {
+            Input.Row( uY )[uX] = MakeFloat4( sinf( uX * 0.3f ) * 0.5f + 0.5f, cosf( uY * 0.2f ) * 0.5f + 0.5f, ( uX * uY % 7 ) / 7.0f, ( uX % 3 ) * 0.3f );
+
+            if( bDepthGuide )
+            {
+                // A small slope across each plane
+                const float fViewDepth = 5.0f + 20.0f * ( ( uX / 23 + uY / 17 ) % 3 ) + ( uX % 5 ) * 0.1f;
+                Guide.Row( uY )[uX] = MakeFloat4( pProjParams[1] - pProjParams[0] / fViewDepth, 0.0f, 0.0f, 0.0f );
+            }
+            else
+            {
+                Guide.Row( uY )[uX] = MakeFloat4( sinf( uX * 0.05f ), cosf( uY * 0.07f ), ( ( uX / 9 + uY / 13 ) % 2 ) * 0.5f, ( uX % 4 ) * 0.2f );
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Both passes with a depth guide, with color guides weighting all channels or a subset,
+// and with a range table of the application's own
+//--------------------------------------------------------------------------------------
+static void TestAgainstHooks()
+{
+    static const unsigned int uWidths[] = { 333, 5, 140 };
+    static const unsigned int uHeights[] = { 211, 300, 3 };
+    static const int iRadii[] = { 1, 4, 13, 32 };
+
+    const float fNear = 0.1f;
+    const float fFar = 125.0f;
+    float fProjParams[4];
+    fProjParams[1] = fFar / ( fFar - fNear );
+    fProjParams[0] = fProjParams[1] * fNear;
+    fProjParams[2] = fProjParams[3] = 0.0f;
+
+    // A linear falloff rather than the Gaussian
+    float fLinearWeights[RANGE_TABLE_SIZE];
+    for( int iEntry = 0; iEntry < RANGE_TABLE_SIZE; iEntry++ )
+    {
+        fLinearWeights[iEntry] = 1.0f - (float)iEntry / (float)( RANGE_TABLE_SIZE - 1 );
+    }
+
+    static const int iNumGuideModes = 4;
+    static const char* pModeNames[iNumGuideModes] = { "depth guide", "color guide", "color guide subset", "color guide linear range" };
+    static const float fGuideScales[iNumGuideModes][4] = { { 2.0f, 0, 0, 0 }, { 4.0f, 4.0f, 4.0f, 0 }, { 0, 3.0f, 0, 1.5f }, { 4.0f, 4.0f, 4.0f, 4.0f } };
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        const unsigned int uWidth = uWidths[iSize];
+        const unsigned int uHeight = uHeights[iSize];
+
+        Surface Input, Guide, Temp, Reference, Output;
+        Input.Create( uWidth, uHeight );
+        Guide.Create( uWidth, uHeight );
+        Temp.Create( uWidth, uHeight );
+        Reference.Create( uWidth, uHeight );
+        Output.Create( uWidth, uHeight );
+
+        const Surface* pInputs[2] = { &Input, &Guide };
+        const Surface* pIntermediates[2] = { &Temp, &Guide };
+
+        SeparableFilterCPU Filter;
+        Filter.SetOutputSize( uWidth, uHeight );
+        Filter.SetInputSurfaces( pInputs, pIntermediates, 2 );
+
+        for( int iMode = 0; iMode < iNumGuideModes; iMode++ )
+        {
+            const float* pDepthGuide = ( 0 == iMode ) ? fProjParams : NULL;
+
+            float fRangeWeights[RANGE_TABLE_SIZE];
+            ComputeRangeWeights( fRangeWeights );
+            const float* pRangeWeights = ( 3 == iMode ) ? fLinearWeights : fRangeWeights;
+
+            FillInputs( Input, Guide, fProjParams, 0 == iMode );
+
+            for( int iRadius = 0; iRadius < (int)( sizeof( iRadii ) / sizeof( iRadii[0] ) ); iRadius++ )
+            {
+                const int iKernelRadius = iRadii[iRadius];
+
+                HorizontalFilter< JointBilateralFilter<PASS_TYPE_HORIZONTAL> > HookX;
+                VerticalFilter< JointBilateralFilter<PASS_TYPE_VERTICAL> > HookY;
+                HookX.SetKernel( iKernelRadius, false );
+                HookY.SetKernel( iKernelRadius, false );
+                HookX.SetDepthGuide( pDepthGuide );
+                HookY.SetDepthGuide( pDepthGuide );
+                HookX.SetGuideScale( fGuideScales[iMode] );
+                HookY.SetGuideScale( fGuideScales[iMode] );
+                HookX.SetRangeWeights( pRangeWeights );
+                HookY.SetRangeWeights( pRangeWeights );
+
+                Filter.SetOutputSurfaces( &Temp, &Reference );
+                Filter.SetFilters( &HookX, &HookY );
+                Filter.OnRender();
+
+                for( int iISA = 0; iISA < ISA_TYPE_MAX; iISA++ )
+                {
+                    if( !GetCPUInfo().m_bSupportsISA[iISA] )
+                    {
+                        continue;
+                    }
+
+                    // Strips sized from the caches, and a whole number of vectors
+                    static const int iStripWidths[] = { 0, 16 };
+                    for( int iStrip = 0; iStrip < (int)( sizeof( iStripWidths ) / sizeof( iStripWidths[0] ) ); iStrip++ )
+                    {
+                        JointBilateralFilterX FilterX;
+                        JointBilateralFilterY FilterY;
+                        FilterX.SetISA( (ISA_TYPE)iISA );
+                        FilterY.SetISA( (ISA_TYPE)iISA );
+                        FilterX.SetKernel( iKernelRadius, false );
+                        FilterY.SetKernel( iKernelRadius, false );
+                        FilterX.SetDepthGuide( pDepthGuide );
+                        FilterY.SetDepthGuide( pDepthGuide );
+                        FilterX.SetGuideScale( fGuideScales[iMode] );
+                        FilterY.SetGuideScale( fGuideScales[iMode] );
+                        FilterX.SetRangeWeights( pRangeWeights );
+                        FilterY.SetRangeWeights( pRangeWeights );
+                        FilterY.SetStripWidth( iStripWidths[iStrip] );
+
+                        Filter.SetOutputSurfaces( &Temp, &Output );
+                        Filter.SetFilters( &FilterX, &FilterY );
+                        Filter.OnRender();
+                        CheckError( MaxDifference( Reference, Output ), s_fTolerance, "Joint bilateral %s %s %ux%u radius %d strip %d",
+                            pModeNames[iMode], GetISAName( (ISA_TYPE)iISA ), uWidth, uHeight, iKernelRadius, iStripWidths[iStrip] );
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Regions of a flat input, whose guides are further apart than the range table reaches,
+// come out flat: the last entry of the table keeps them from mixing
+//--------------------------------------------------------------------------------------
+static void TestGuideEdges()
+{
+    const unsigned int uWidth = 97;
+    const unsigned int uHeight = 61;
+    const int iKernelRadius = 16;
+
+    Surface Input, Guide, Temp, Output;
+    Input.Create( uWidth, uHeight );
+    Guide.Create( uWidth, uHeight );
+    Temp.Create( uWidth, uHeight );
+    Output.Create( uWidth, uHeight );
+
+    // Checkered regions, with the guide a full table apart between neighbours
+    static const float fGuideScale[4] = { 1.0f, 1.0f, 0, 0 };
+    for( unsigned int uY = 0; uY < uHeight; uY++ )
+    {
+        for( unsigned int uX = 0; uX < uWidth; uX++ )
+        {
+            const bool bOdd = ( ( uX / 13 + uY / 11 ) % 2 ) != 0;
+            Input.Row( uY )[uX] = bOdd ? MakeFloat4( 0.9f, 0.1f, 0.6f, 1.0f ) : MakeFloat4( 0.2f, 0.7f, 0.3f, 0.5f );
+            Guide.Row( uY )[uX] = bOdd ? MakeFloat4( 20.0f, 0.0f, 0.0f, 0.0f ) : MakeFloat4( 0.0f, 0.0f, 0.0f, 0.0f );
+        }
+    }
+
+    const Surface* pInputs[2] = { &Input, &Guide };
+    const Surface* pIntermediates[2] = { &Temp, &Guide };
+
+    SeparableFilterCPU Filter;
+    Filter.SetOutputSize( uWidth, uHeight );
+    Filter.SetInputSurfaces( pInputs, pIntermediates, 2 );
+    Filter.SetOutputSurfaces( &Temp, &Output );
+
+    HorizontalFilter< JointBilateralFilter<PASS_TYPE_HORIZONTAL> > HookX;
+    VerticalFilter< JointBilateralFilter<PASS_TYPE_VERTICAL> > HookY;
+    HookX.SetKernel( iKernelRadius, false );
+    HookY.SetKernel( iKernelRadius, false );
+    HookX.SetGuideScale( fGuideScale );
+    HookY.SetGuideScale( fGuideScale );
+
+    Filter.SetFilters( &HookX, &HookY );
+    Filter.OnRender();
+    CheckError( MaxDifference( Input, Output ), s_fEdgeTolerance, "Joint bilateral guide edges hook" );
+
+    for( int iISA = 0; iISA < ISA_TYPE_MAX; iISA++ )
+    {
+        if( !GetCPUInfo().m_bSupportsISA[iISA] )
+        {
+            continue;
+        }
+
+        JointBilateralFilterX FilterX;
+        JointBilateralFilterY FilterY;
+        FilterX.SetISA( (ISA_TYPE)iISA );
+        FilterY.SetISA( (ISA_TYPE)iISA );
+        FilterX.SetKernel( iKernelRadius, false );
+        FilterY.SetKernel( iKernelRadius, false );
+        FilterX.SetGuideScale( fGuideScale );
+        FilterY.SetGuideScale( fGuideScale );
+
+        Filter.SetFilters( &FilterX, &FilterY );
+        Filter.OnRender();
+        CheckError( MaxDifference( Input, Output ), s_fEdgeTolerance, "Joint bilateral guide edges %s", GetISAName( (ISA_TYPE)iISA ) );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Runs the joint bilateral tests
+//--------------------------------------------------------------------------------------
+void TestJointBilateral()
+{
+    TestAgainstHooks();
+    TestGuideEdges();
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,187 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestLDSPrecision.cpp
+//
+// Tests the ring buffer precisions of the fused Gaussian pass against the float path, for
+// inputs in [0,1] and HDR inputs.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/HorizontalFilter.h"
+#include "CPU/VerticalFilter.h"
+#include "CPU/GaussianFilter.h"
+#include "CPU/GaussianFilterSIMD.h"
+#include "CPU/CPUInfo.h"
+
+#include <math.h>
+
+using namespace CPUFilter;
+
+
+// The passes sum in a different order than the hooks, and the unorm ring buffers add up to
+// half a step of their format, as the vertical weights sum to 1
+static const float s_fTolerance = 1e-5f;
+static const float s_fUNormTolerance[LDS_PRECISION_TYPE_MAX] = { 0.5f / 255.0f + 1e-5f, 0.5f / 65535.0f + 1e-5f, 1e-5f };
+
+// Relative to the output, for HDR inputs, which the 16 bit ring buffer stores as halves
+// of 11 significant bits
+static const float s_fHDRTolerance[LDS_PRECISION_TYPE_MAX] = { 0.0f, 1e-3f, 1e-5f };
+
+// Largest HDR input
+static const float s_fHDRScale = 1000.0f;
+
+
+//--------------------------------------------------------------------------------------
+// Largest difference over the color channels relative to the reference, or to 1 for
+// references under 1
+//--------------------------------------------------------------------------------------
+static float MaxRelativeDifference( const Surface& Reference, const Surface& Output )
+{
+    float fMax = 0.0f;
+
+    for( unsigned int uY = 0; uY < Reference.m_uHeight; uY++ )
+    {
+        const float* pReference = &Reference.Row( uY )->x;
+        const float* pOutput = &Output.Row( uY )->x;
+        for( unsigned int uChannel = 0; uChannel < Reference.m_uWidth * 4; uChannel++ )
+        {
+            const float fScale = ( fabsf( pReference[uChannel] ) > 1.0f ) ? fabsf( pReference[uChannel] ) : 1.0f;
+            const float fDifference = fabsf( pOutput[uChannel] - pReference[uChannel] ) / fScale;
+            fMax = ( fDifference > fMax ) ? fDifference : fMax;
+        }
+    }
+
+    return fMax;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Each precision on inputs in [0,1], then HDR inputs with each precision that allows them
+//--------------------------------------------------------------------------------------
+void TestLDSPrecision()
+{
+    static const unsigned int uWidths[] = { 213, 5 };
+    static const unsigned int uHeights[] = { 97, 40 };
+    static const int iRadii[] = { 1, 4, 16, 40 };
+    static const char* pPrecisionNames[LDS_PRECISION_TYPE_MAX] = { "8 bit", "16 bit", "32 bit" };
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        const unsigned int uWidth = uWidths[iSize];
+        const unsigned int uHeight = uHeights[iSize];
+
+        Surface Input, HDRInput, Temp, Output, Reference, HDRReference;
+        Input.Create( uWidth, uHeight );
+        HDRInput.Create( uWidth, uHeight );
+        Temp.Create( uWidth, uHeight );
+        Output.Create( uWidth, uHeight );
+        Reference.Create( uWidth, uHeight );
+        HDRReference.Create( uWidth, uHeight );
+        FillRandom( Input, 0, 0, uWidth, uHeight );
+
+        // Mostly above 1, over several orders of magnitude
+        for( unsigned int uY = 0; uY < uHeight; uY++ )
+        {
+            for( unsigned int uX = 0; uX < uWidth; uX++ )
+            {
+                HDRInput.Row( uY )[uX] = MakeFloat4( Random() * s_fHDRScale, powf( s_fHDRScale, Random() ), Random() * 4.0f, 1.0f );
+            }
+        }
+
+        const Surface* pInputs[1] = { &Input };
+        const Surface* pHDRInputs[1] = { &HDRInput };
+        const Surface* pIntermediates[1] = { &Temp };
+
+        SeparableFilterCPU Filter;
+        Filter.SetOutputSize( uWidth, uHeight );
+
+        for( int iRadius = 0; iRadius < (int)( sizeof( iRadii ) / sizeof( iRadii[0] ) ); iRadius++ )
+        {
+            const int iKernelRadius = iRadii[iRadius];
+
+            HorizontalFilter<GaussianFilter> HookX;
+            VerticalFilter<GaussianFilter> HookY;
+            HookX.SetKernel( iKernelRadius, false );
+            HookY.SetKernel( iKernelRadius, false );
+
+            Filter.SetFilters( &HookX, &HookY );
+            Filter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+            Filter.SetOutputSurfaces( &Temp, &Reference );
+            Filter.OnRender();
+            Filter.SetInputSurfaces( pHDRInputs, pIntermediates, 1 );
+            Filter.SetOutputSurfaces( &Temp, &HDRReference );
+            Filter.OnRender();
+
+            for( int iISA = 0; iISA < ISA_TYPE_MAX; iISA++ )
+            {
+                if( !GetCPUInfo().m_bSupportsISA[iISA] )
+                {
+                    continue;
+                }
+
+                for( int iPrecision = 0; iPrecision < LDS_PRECISION_TYPE_MAX; iPrecision++ )
+                {
+                    const LDS_PRECISION_TYPE LDSPrecision = (LDS_PRECISION_TYPE)iPrecision;
+
+                    GaussianFilterFused FilterFused;
+                    FilterFused.SetISA( (ISA_TYPE)iISA );
+                    FilterFused.SetKernel( iKernelRadius, false );
+                    FilterFused.SetLDSPrecision( LDSPrecision );
+
+                    Filter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+                    Filter.SetOutputSurfaces( NULL, &Output );
+                    Filter.SetFusedFilter( &FilterFused );
+                    Filter.OnRender();
+                    CheckError( MaxDifference( Reference, Output ), s_fUNormTolerance[iPrecision], "LDS precision %s %s %ux%u radius %d",
+                        pPrecisionNames[iPrecision], GetISAName( (ISA_TYPE)iISA ), uWidth, uHeight, iKernelRadius );
+
+                    // The unorm ring buffers clip HDR inputs, so only the others are checked
+                    Filter.SetInputSurfaces( pHDRInputs, pIntermediates, 1 );
+                    if( LDS_PRECISION_TYPE_8_BIT != LDSPrecision )
+                    {
+                        FilterFused.SetRequireHDR( true );
+                        Filter.OnRender();
+                        CheckError( MaxRelativeDifference( HDRReference, Output ), s_fHDRTolerance[iPrecision], "LDS precision %s HDR %s %ux%u radius %d",
+                            pPrecisionNames[iPrecision], GetISAName( (ISA_TYPE)iISA ), uWidth, uHeight, iKernelRadius );
+                    }
+                    if( LDS_PRECISION_TYPE_16_BIT == LDSPrecision )
+                    {
+                        FilterFused.SetRequireHDR( false );
+                        Filter.OnRender();
+                        Check( MaxRelativeDifference( HDRReference, Output ) > 0.5f, "LDS precision 16 bit unorm %s %ux%u radius %d did not clip HDR inputs",
+                            GetISAName( (ISA_TYPE)iISA ), uWidth, uHeight, iKernelRadius );
+                    }
+                    Filter.SetFusedFilter( NULL );
+                }
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
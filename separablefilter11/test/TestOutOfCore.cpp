@@ -0,0 +1,149 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestOutOfCore.cpp
+//
+// Tests that streaming a tiled image file through the filters in bands gives the same
+// image, bit for bit, as filtering it whole in memory.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/GaussianFilterSIMD.h"
+#include "CPU/OutOfCoreFilter.h"
+
+#include <stdio.h>
+
+using namespace CPUFilter;
+
+
+// Written to the working directory, and removed at the end
+static const char* s_szInputPath = "CPUFilterTest_Input.sfti";
+static const char* s_szOutputPath = "CPUFilterTest_Output.sfti";
+static const char* s_szReferencePath = "CPUFilterTest_Reference.sfti";
+
+
+//--------------------------------------------------------------------------------------
+// Each format, with separate and fused passes, and bands sized from the memory budget, a
+// small budget, one tile, and a height that is rounded up to whole tiles
+//--------------------------------------------------------------------------------------
+void TestOutOfCore()
+{
+    static const unsigned int uWidth = 300;
+    static const unsigned int uHeight = 211;
+    static const unsigned int uTileSize = 32;
+    static const int iRadii[] = { 4, 40 };
+    static const int iBandHeights[] = { 0, 0, 32, 50 };
+    static const char* pFormatNames[TEXEL_FORMAT_TYPE_MAX] = { "R8G8B8A8_UNORM", "R32G32B32A32_FLOAT" };
+
+    Surface Source, Input, Temp, Output, Reference;
+    Source.Create( uWidth, uHeight );
+    Input.Create( uWidth, uHeight );
+    Temp.Create( uWidth, uHeight );
+    Output.Create( uWidth, uHeight );
+    Reference.Create( uWidth, uHeight );
+    FillRandom( Source, 0, 0, uWidth, uHeight );
+
+    for( int iFormat = 0; iFormat < TEXEL_FORMAT_TYPE_MAX; iFormat++ )
+    {
+        const TEXEL_FORMAT_TYPE Format = (TEXEL_FORMAT_TYPE)iFormat;
+
+        // The input as stored, so 8 bit texels are filtered as quantized
+        TiledImageFile InputFile;
+        bool bCreated = InputFile.Create( s_szInputPath, uWidth, uHeight, Format, uTileSize );
+        bCreated = bCreated && InputFile.WriteLines( Source, 0, 0, (int)uHeight ) && InputFile.ReadLines( 0, (int)uHeight, Input, 0 );
+        if( !Check( bCreated, "Out of core %s could not write the input", pFormatNames[iFormat] ) )
+        {
+            continue;
+        }
+
+        const Surface* pInputs[1] = { &Input };
+        const Surface* pIntermediates[1] = { &Temp };
+
+        for( int iRadius = 0; iRadius < (int)( sizeof( iRadii ) / sizeof( iRadii[0] ) ); iRadius++ )
+        {
+            const int iKernelRadius = iRadii[iRadius];
+
+            GaussianFilterX FilterX;
+            GaussianFilterY FilterY;
+            GaussianFilterFused FilterFused;
+            FilterX.SetKernel( iKernelRadius, false );
+            FilterY.SetKernel( iKernelRadius, false );
+            FilterFused.SetKernel( iKernelRadius, false );
+
+            for( int iFused = 0; iFused < 2; iFused++ )
+            {
+                // The whole image in memory, stored in the same format
+                SeparableFilterCPU Filter;
+                Filter.SetFilters( &FilterX, &FilterY );
+                Filter.SetFusedFilter( iFused ? &FilterFused : NULL );
+                Filter.SetOutputSize( uWidth, uHeight );
+                Filter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+                Filter.SetOutputSurfaces( &Temp, &Output );
+                Filter.OnRender();
+
+                TiledImageFile ReferenceFile;
+                if( !Check( ReferenceFile.Create( s_szReferencePath, uWidth, uHeight, Format, uTileSize ) && ReferenceFile.WriteLines( Output, 0, 0, (int)uHeight ) &&
+                    ReferenceFile.ReadLines( 0, (int)uHeight, Reference, 0 ), "Out of core %s could not write the reference", pFormatNames[iFormat] ) )
+                {
+                    continue;
+                }
+
+                for( int iBand = 0; iBand < (int)( sizeof( iBandHeights ) / sizeof( iBandHeights[0] ) ); iBand++ )
+                {
+                    OutOfCoreFilter OutOfCore;
+                    OutOfCore.SetBandHeight( iBandHeights[iBand] );
+                    if( 1 == iBand )
+                    {
+                        // Under a tile, so the bands are a tile high
+                        OutOfCore.SetMemoryBudget( 1024 );
+                    }
+
+                    TiledImageFile OutputFile;
+                    const bool bRendered = OutputFile.Create( s_szOutputPath, uWidth, uHeight, Format, uTileSize ) && OutOfCore.OnRender( Filter, iKernelRadius, InputFile, OutputFile );
+
+                    FillRandom( Output, 0, 0, uWidth, uHeight );
+                    if( Check( bRendered && OutputFile.ReadLines( 0, (int)uHeight, Output, 0 ), "Out of core %s radius %d %s band %d failed",
+                        pFormatNames[iFormat], iKernelRadius, iFused ? "fused" : "separate", OutOfCore.GetBandHeight() ) )
+                    {
+                        CheckIdentical( Reference, Output, "Out of core %s radius %d %s band %d", pFormatNames[iFormat], iKernelRadius, iFused ? "fused" : "separate",
+                            OutOfCore.GetBandHeight() );
+                    }
+                    Check( 0 != iBandHeights[iBand] || 0 == OutOfCore.GetBandHeight() % uTileSize, "Out of core band of %d is not whole tiles", OutOfCore.GetBandHeight() );
+                }
+            }
+        }
+    }
+
+    remove( s_szInputPath );
+    remove( s_szOutputPath );
+    remove( s_szReferencePath );
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
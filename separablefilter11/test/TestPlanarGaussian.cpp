@@ -0,0 +1,242 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestPlanarGaussian.cpp
+//
+// Tests the conversions between the interleaved and planar layouts, and that the planar
+// Gaussian passes of every instruction set match the interleaved passes bit for bit.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/GaussianFilterSIMD.h"
+#include "CPU/GaussianFilterPlanar.h"
+#include "CPU/PlanarSurface.h"
+#include "CPU/CPUInfo.h"
+
+#include <string.h>
+#include <vector>
+
+using namespace CPUFilter;
+
+
+//--------------------------------------------------------------------------------------
+// Whether the first uWidth floats of every row of two planes match
+//--------------------------------------------------------------------------------------
+static bool IsPlaneIdentical( const PlanarSurface& A, int iPlaneA, const PlanarSurface& B, int iPlaneB, unsigned int uWidth, unsigned int uHeight )
+{
+    for( unsigned int uY = 0; uY < uHeight; uY++ )
+    {
+        if( 0 != memcmp( A.Row( iPlaneA, uY ), B.Row( iPlaneB, uY ), uWidth * sizeof( float ) ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Deinterleaving and interleaving round trip, into larger surfaces, with and without an
+// alpha plane
+//--------------------------------------------------------------------------------------
+static void TestConversions()
+{
+    static const unsigned int uWidths[] = { 333, 5, 17 };
+    static const unsigned int uHeights[] = { 61, 40, 1 };
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        const unsigned int uWidth = uWidths[iSize];
+        const unsigned int uHeight = uHeights[iSize];
+
+        Surface Input, Output;
+        Input.Create( uWidth, uHeight );
+        Output.Create( uWidth, uHeight );
+        FillRandom( Input, 0, 0, uWidth, uHeight );
+
+        for( int iNumPlanes = 3; iNumPlanes <= 4; iNumPlanes++ )
+        {
+            PlanarSurface Planes;
+            Planes.Create( uWidth + 3, uHeight + 1, iNumPlanes );
+            DeinterleaveSurface( Input, Planes );
+
+            bool bPlanesMatch = true;
+            for( unsigned int uY = 0; uY < uHeight; uY++ )
+            {
+                for( unsigned int uX = 0; uX < uWidth; uX++ )
+                {
+                    const Float4& f4Texel = Input.Row( uY )[uX];
+                    bPlanesMatch = bPlanesMatch && Planes.Row( 0, uY )[uX] == f4Texel.x && Planes.Row( 1, uY )[uX] == f4Texel.y && Planes.Row( 2, uY )[uX] == f4Texel.z;
+                    bPlanesMatch = bPlanesMatch && ( 3 == iNumPlanes || Planes.Row( 3, uY )[uX] == f4Texel.w );
+                }
+            }
+            Check( bPlanesMatch, "Deinterleave %ux%u %d planes", uWidth, uHeight, iNumPlanes );
+
+            // Interleave only the region of the input, as the planes are larger than the output
+            PlanarSurface View;
+            float* pViewPlanes[4] = { Planes.m_pPlanes[0], Planes.m_pPlanes[1], Planes.m_pPlanes[2], Planes.m_pPlanes[3] };
+            View.CreateView( pViewPlanes, iNumPlanes, uWidth, uHeight, Planes.m_uPitch );
+            InterleaveSurface( View, Output );
+
+            bool bTexelsMatch = true;
+            for( unsigned int uY = 0; uY < uHeight; uY++ )
+            {
+                for( unsigned int uX = 0; uX < uWidth; uX++ )
+                {
+                    const Float4& f4In = Input.Row( uY )[uX];
+                    const Float4& f4Out = Output.Row( uY )[uX];
+                    const float fAlpha = ( 4 == iNumPlanes ) ? f4In.w : 1.0f;
+                    bTexelsMatch = bTexelsMatch && f4Out.x == f4In.x && f4Out.y == f4In.y && f4Out.z == f4In.z && f4Out.w == fAlpha;
+                }
+            }
+            Check( bTexelsMatch, "Interleave %ux%u %d planes", uWidth, uHeight, iNumPlanes );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// The planar passes against the interleaved passes, on sizes that fill a group, leave a
+// vector partly empty, and are narrower or shorter than the kernel. The alpha plane is a
+// copy of red, so it must come out the same as red, and the intermediate planes are a
+// view of caller owned memory with a pitch wider than a whole number of vectors.
+//--------------------------------------------------------------------------------------
+static void TestPasses()
+{
+    static const unsigned int uWidths[] = { 333, 5, 140 };
+    static const unsigned int uHeights[] = { 61, 40, 3 };
+    static const int iRadii[] = { 1, 2, 7, 16, MAX_KERNEL_RADIUS };
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        const unsigned int uWidth = uWidths[iSize];
+        const unsigned int uHeight = uHeights[iSize];
+
+        Surface Input, Temp, Reference, Output;
+        Input.Create( uWidth, uHeight );
+        Temp.Create( uWidth, uHeight );
+        Reference.Create( uWidth, uHeight );
+        Output.Create( uWidth, uHeight );
+        FillRandom( Input, 0, 0, uWidth, uHeight );
+
+        PlanarSurface PlanarInput, PlanarOutput, PlanarTemp, ColorOutput;
+        PlanarInput.Create( uWidth, uHeight, 4 );
+        PlanarOutput.Create( uWidth, uHeight, 4 );
+        DeinterleaveSurface( Input, PlanarInput );
+        for( unsigned int uY = 0; uY < uHeight; uY++ )
+        {
+            memcpy( PlanarInput.Row( 3, uY ), PlanarInput.Row( 0, uY ), uWidth * sizeof( float ) );
+        }
+        ColorOutput.CreateView( PlanarOutput, 0, 3 );
+
+        const unsigned int uTempPitch = uWidth + 3;
+        std::vector<float> TempData( (size_t)uTempPitch * uHeight * 4 );
+        float* pTempPlanes[4];
+        for( int iPlane = 0; iPlane < 4; iPlane++ )
+        {
+            pTempPlanes[iPlane] = &TempData[0] + (size_t)uTempPitch * uHeight * iPlane;
+        }
+        PlanarTemp.CreateView( pTempPlanes, 4, uWidth, uHeight, uTempPitch );
+
+        const Surface* pInputs[1] = { &Input };
+        const Surface* pIntermediates[1] = { &Temp };
+
+        SeparableFilterCPU Filter;
+        Filter.SetOutputSize( uWidth, uHeight );
+        Filter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+        Filter.SetOutputSurfaces( &Temp, &Reference );
+
+        // The planar passes bind no surfaces
+        SeparableFilterCPU PlanarFilter;
+        PlanarFilter.SetOutputSize( uWidth, uHeight );
+
+        for( int iRadius = 0; iRadius < (int)( sizeof( iRadii ) / sizeof( iRadii[0] ) ); iRadius++ )
+        {
+            const int iKernelRadius = iRadii[iRadius];
+
+            for( int iApproximate = 0; iApproximate < 2; iApproximate++ )
+            {
+                for( int iISA = 0; iISA < ISA_TYPE_MAX; iISA++ )
+                {
+                    if( !GetCPUInfo().m_bSupportsISA[iISA] )
+                    {
+                        continue;
+                    }
+
+                    GaussianFilterX FilterX;
+                    GaussianFilterY FilterY;
+                    FilterX.SetISA( (ISA_TYPE)iISA );
+                    FilterY.SetISA( (ISA_TYPE)iISA );
+                    FilterX.SetKernel( iKernelRadius, iApproximate != 0 );
+                    FilterY.SetKernel( iKernelRadius, iApproximate != 0 );
+
+                    Filter.SetFilters( &FilterX, &FilterY );
+                    Filter.OnRender();
+
+                    // Strips sized from the caches, a whole number of vectors, and a partial vector
+                    static const int iStripWidths[] = { 0, 16, 7 };
+                    for( int iStrip = 0; iStrip < (int)( sizeof( iStripWidths ) / sizeof( iStripWidths[0] ) ); iStrip++ )
+                    {
+                        GaussianFilterPlanarX PlanarX;
+                        GaussianFilterPlanarY PlanarY;
+                        PlanarX.SetISA( (ISA_TYPE)iISA );
+                        PlanarY.SetISA( (ISA_TYPE)iISA );
+                        PlanarX.SetKernel( iKernelRadius, iApproximate != 0 );
+                        PlanarY.SetKernel( iKernelRadius, iApproximate != 0 );
+                        PlanarY.SetStripWidth( iStripWidths[iStrip] );
+                        PlanarX.SetPlanarSurfaces( &PlanarInput, &PlanarTemp );
+                        PlanarY.SetPlanarSurfaces( &PlanarTemp, &PlanarOutput );
+
+                        PlanarFilter.SetFilters( &PlanarX, &PlanarY );
+                        PlanarFilter.OnRender();
+
+                        // Without the alpha plane, interleaving sets alpha to 1 as the interleaved passes do
+                        InterleaveSurface( ColorOutput, Output );
+                        CheckIdentical( Reference, Output, "Planar Gaussian %s %ux%u radius %d%s strip %d",
+                            GetISAName( (ISA_TYPE)iISA ), uWidth, uHeight, iKernelRadius, iApproximate ? " approximate" : "", iStripWidths[iStrip] );
+                        Check( IsPlaneIdentical( PlanarOutput, 3, PlanarOutput, 0, uWidth, uHeight ), "Planar Gaussian alpha %s %ux%u radius %d%s strip %d",
+                            GetISAName( (ISA_TYPE)iISA ), uWidth, uHeight, iKernelRadius, iApproximate ? " approximate" : "", iStripWidths[iStrip] );
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Runs the planar Gaussian tests
+//--------------------------------------------------------------------------------------
+void TestPlanarGaussian()
+{
+    TestConversions();
+    TestPasses();
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
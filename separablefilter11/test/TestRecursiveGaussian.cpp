@@ -0,0 +1,226 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestRecursiveGaussian.cpp
+//
+// Tests the recursive Gaussian passes of every instruction set against an exact Gaussian,
+// for deviations far beyond the kernel radii.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/RecursiveGaussian.h"
+#include "CPU/CPUInfo.h"
+
+#include <math.h>
+#include <vector>
+
+using namespace CPUFilter;
+
+
+// Between instruction sets, which only differ in the order of the transposes
+static const float s_fISATolerance = 1e-6f;
+
+
+//--------------------------------------------------------------------------------------
+// The weights of a line of iCount pixels clamped at its ends: for each output, the sum of
+// the Gaussian weights of every input that clamps to each pixel, out to 5 deviations
+//--------------------------------------------------------------------------------------
+static void ComputeClampedWeights( double dDeviation, int iCount, std::vector<double>& Weights )
+{
+    const int iRadius = (int)ceil( dDeviation * 5.0 );
+
+    Weights.assign( (size_t)iCount * iCount, 0.0 );
+    for( int iOut = 0; iOut < iCount; iOut++ )
+    {
+        double dSum = 0.0;
+        for( int i = -iRadius; i <= iRadius; i++ )
+        {
+            const double dWeight = exp( -0.5 * i * i / ( dDeviation * dDeviation ) );
+            const int iIn = iOut + i;
+            Weights[(size_t)iOut * iCount + ( ( iIn < 0 ) ? 0 : ( iIn >= iCount ) ? iCount - 1 : iIn )] += dWeight;
+            dSum += dWeight;
+        }
+        for( int iIn = 0; iIn < iCount; iIn++ )
+        {
+            Weights[(size_t)iOut * iCount + iIn] /= dSum;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Exact Gaussian of Input in double precision, with clamped edges
+//--------------------------------------------------------------------------------------
+static void ComputeReference( const Surface& Input, double dDeviation, Surface& Reference )
+{
+    const int iWidth = (int)Input.m_uWidth;
+    const int iHeight = (int)Input.m_uHeight;
+
+    std::vector<double> WeightsX, WeightsY;
+    ComputeClampedWeights( dDeviation, iWidth, WeightsX );
+    ComputeClampedWeights( dDeviation, iHeight, WeightsY );
+
+    std::vector<double> Temp( (size_t)iWidth * iHeight * 4, 0.0 );
+    for( int iY = 0; iY < iHeight; iY++ )
+    {
+        const float* pInput = &Input.Row( iY )->x;
+        for( int iX = 0; iX < iWidth; iX++ )
+        {
+            for( int iIn = 0; iIn < iWidth; iIn++ )
+            {
+                const double dWeight = WeightsX[(size_t)iX * iWidth + iIn];
+                for( int iChannel = 0; iChannel < 4; iChannel++ )
+                {
+                    Temp[( (size_t)iY * iWidth + iX ) * 4 + iChannel] += dWeight * pInput[iIn * 4 + iChannel];
+                }
+            }
+        }
+    }
+
+    for( int iY = 0; iY < iHeight; iY++ )
+    {
+        float* pReference = &Reference.Row( iY )->x;
+        for( int iChannel = 0; iChannel < iWidth * 4; iChannel++ )
+        {
+            double dSum = 0.0;
+            for( int iIn = 0; iIn < iHeight; iIn++ )
+            {
+                dSum += WeightsY[(size_t)iY * iHeight + iIn] * Temp[(size_t)iIn * iWidth * 4 + iChannel];
+            }
+            pReference[iChannel] = (float)dSum;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Each instruction set against the exact Gaussian and the scalar passes, on random inputs
+// and a step, at deviations from the kernel radii up to 200
+//--------------------------------------------------------------------------------------
+void TestRecursiveGaussian()
+{
+    static const unsigned int uWidths[] = { 260, 37, 1 };
+    static const unsigned int uHeights[] = { 150, 3, 90 };
+    static const float fDeviations[] = { 0.5f, 4.0f, 16.0f, 50.0f, 200.0f };
+
+    // Young and van Vliet's response is furthest from a true Gaussian at small deviations,
+    // and approaches it as the deviation grows: at most about 2.5% of a step at 4, and
+    // 0.2% at 200
+    static const float fTolerances[] = { 0.1f, 0.03f, 0.015f, 0.005f, 0.002f };
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        const unsigned int uWidth = uWidths[iSize];
+        const unsigned int uHeight = uHeights[iSize];
+
+        Surface Input, Step, Temp, Output, ScalarOutput, Reference, StepReference;
+        Input.Create( uWidth, uHeight );
+        Step.Create( uWidth, uHeight );
+        Temp.Create( uWidth, uHeight );
+        Output.Create( uWidth, uHeight );
+        ScalarOutput.Create( uWidth, uHeight );
+        Reference.Create( uWidth, uHeight );
+        StepReference.Create( uWidth, uHeight );
+        FillRandom( Input, 0, 0, uWidth, uHeight );
+
+        // A dark square in the upper left corner of a bright image
+        for( unsigned int uY = 0; uY < uHeight; uY++ )
+        {
+            for( unsigned int uX = 0; uX < uWidth; uX++ )
+            {
+                const float fValue = ( uX < uWidth / 3 && uY < uHeight / 3 ) ? 0.0f : 1.0f;
+                Step.Row( uY )[uX] = MakeFloat4( fValue, 1.0f - fValue, 0.5f, 1.0f );
+            }
+        }
+
+        const Surface* pInputs[2][1] = { { &Input }, { &Step } };
+        const Surface* pIntermediates[1] = { &Temp };
+        const Surface* pReferences[2] = { &Reference, &StepReference };
+        static const char* pInputNames[2] = { "random", "step" };
+
+        SeparableFilterCPU Filter;
+        Filter.SetOutputSize( uWidth, uHeight );
+
+        for( int iDeviation = 0; iDeviation < (int)( sizeof( fDeviations ) / sizeof( fDeviations[0] ) ); iDeviation++ )
+        {
+            const float fDeviation = fDeviations[iDeviation];
+            ComputeReference( Input, fDeviation, Reference );
+            ComputeReference( Step, fDeviation, StepReference );
+
+            for( int iInput = 0; iInput < 2; iInput++ )
+            {
+                Filter.SetInputSurfaces( pInputs[iInput], pIntermediates, 1 );
+
+                for( int iISA = 0; iISA < ISA_TYPE_MAX; iISA++ )
+                {
+                    if( !GetCPUInfo().m_bSupportsISA[iISA] )
+                    {
+                        continue;
+                    }
+
+                    RecursiveGaussianX FilterX;
+                    RecursiveGaussianY FilterY;
+                    FilterX.SetISA( (ISA_TYPE)iISA );
+                    FilterY.SetISA( (ISA_TYPE)iISA );
+                    FilterX.SetDeviation( fDeviation );
+                    FilterY.SetDeviation( fDeviation );
+
+                    Surface& Result = ( ISA_TYPE_SCALAR == iISA ) ? ScalarOutput : Output;
+                    FillRandom( Result, 0, 0, uWidth, uHeight );
+                    Filter.SetOutputSurfaces( &Temp, &Result );
+                    Filter.SetFilters( &FilterX, &FilterY );
+                    Filter.OnRender();
+
+                    CheckError( MaxDifference( *pReferences[iInput], Result ), fTolerances[iDeviation], "Recursive Gaussian %s %s %ux%u deviation %g",
+                        pInputNames[iInput], GetISAName( (ISA_TYPE)iISA ), uWidth, uHeight, fDeviation );
+                    if( ISA_TYPE_SCALAR != iISA )
+                    {
+                        CheckError( MaxDifference( ScalarOutput, Result ), s_fISATolerance, "Recursive Gaussian %s %s %ux%u deviation %g against scalar",
+                            pInputNames[iInput], GetISAName( (ISA_TYPE)iISA ), uWidth, uHeight, fDeviation );
+                    }
+
+                    // The weights sum to 1, so a constant alpha is kept exactly
+                    bool bAlpha = true;
+                    for( unsigned int uY = 0; uY < uHeight; uY++ )
+                    {
+                        for( unsigned int uX = 0; uX < uWidth; uX++ )
+                        {
+                            bAlpha = bAlpha && ( 1.0f == Result.Row( uY )[uX].w );
+                        }
+                    }
+                    Check( bAlpha, "Recursive Gaussian %s %s %ux%u deviation %g changed a constant alpha",
+                        pInputNames[iInput], GetISAName( (ISA_TYPE)iISA ), uWidth, uHeight, fDeviation );
+                }
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
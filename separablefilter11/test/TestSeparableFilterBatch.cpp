@@ -0,0 +1,209 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestSeparableFilterBatch.cpp
+//
+// Tests that filtering a batch of images in one work queue gives each image, bit for
+// bit, what filtering it on its own gives.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/SeparableFilterBatch.h"
+#include "CPU/GaussianFilterSIMD.h"
+#include "CPU/BilateralFilterSIMD.h"
+
+using namespace CPUFilter;
+
+
+static const int s_iNumImages = 5;
+
+
+//--------------------------------------------------------------------------------------
+// Holds the surfaces of each image of the batch, each filled differently, so an image
+// filtered from or into another's surfaces shows
+//--------------------------------------------------------------------------------------
+struct BatchImages
+{
+    Surface         m_Color[s_iNumImages];
+    Surface         m_Depth[s_iNumImages];
+    Surface         m_Temp[s_iNumImages];
+    Surface         m_Output[s_iNumImages];
+    const Surface*  m_pHorizInputs[s_iNumImages * 2];   // Color, depth per image
+    const Surface*  m_pVertInputs[s_iNumImages * 2];    // Temp, depth per image
+    Surface*        m_pTemps[s_iNumImages];
+    Surface*        m_pOutputs[s_iNumImages];
+
+    void Create( unsigned int uWidth, unsigned int uHeight )
+    {
+        for( int iImage = 0; iImage < s_iNumImages; iImage++ )
+        {
+            m_Color[iImage].Create( uWidth, uHeight );
+            m_Depth[iImage].Create( uWidth, uHeight );
+            m_Temp[iImage].Create( uWidth, uHeight );
+            m_Output[iImage].Create( uWidth, uHeight );
+            FillRandom( m_Color[iImage], 0, 0, uWidth, uHeight );
+            FillRandom( m_Depth[iImage], 0, 0, uWidth, uHeight );
+
+            m_pHorizInputs[iImage * 2 + 0] = &m_Color[iImage];
+            m_pHorizInputs[iImage * 2 + 1] = &m_Depth[iImage];
+            m_pVertInputs[iImage * 2 + 0] = &m_Temp[iImage];
+            m_pVertInputs[iImage * 2 + 1] = &m_Depth[iImage];
+            m_pTemps[iImage] = &m_Temp[iImage];
+            m_pOutputs[iImage] = &m_Output[iImage];
+        }
+    }
+};
+
+
+//--------------------------------------------------------------------------------------
+// Filters each image on its own with its own passes, then all of them as a batch, and
+// compares the outputs. The bilateral passes read a second input, so an input taken from
+// the wrong image also shows.
+//--------------------------------------------------------------------------------------
+static void TestBatch( BatchImages& Images, unsigned int uWidth, unsigned int uHeight, int iNumInputs, FilterPass** ppHoriz, FilterPass** ppVert,
+                       FilterPass** ppFused, const char* szName )
+{
+    static const int iMaxCores[] = { MAXCORES_SINGLE_THREADED, MAXCORES_USE_ALL_CORES, 3 };
+
+    Surface Reference[s_iNumImages];
+    for( int iImage = 0; iImage < s_iNumImages; iImage++ )
+    {
+        Reference[iImage].Create( uWidth, uHeight );
+
+        SeparableFilterCPU Filter;
+        Filter.SetFilters( ppHoriz[iImage], ppVert[iImage] );
+        Filter.SetFusedFilter( ppFused ? ppFused[iImage] : NULL );
+        Filter.SetOutputSize( uWidth, uHeight );
+        Filter.SetInputSurfaces( &Images.m_pHorizInputs[iImage * 2], &Images.m_pVertInputs[iImage * 2], iNumInputs );
+        Filter.SetOutputSurfaces( &Images.m_Temp[iImage], &Reference[iImage] );
+        Filter.OnRender();
+    }
+
+    // With a single input, the depths are never read, so the inputs are packed
+    const Surface* pHorizInputs[s_iNumImages * 2];
+    const Surface* pVertInputs[s_iNumImages * 2];
+    for( int iImage = 0; iImage < s_iNumImages; iImage++ )
+    {
+        for( int iInput = 0; iInput < iNumInputs; iInput++ )
+        {
+            pHorizInputs[iImage * iNumInputs + iInput] = Images.m_pHorizInputs[iImage * 2 + iInput];
+            pVertInputs[iImage * iNumInputs + iInput] = Images.m_pVertInputs[iImage * 2 + iInput];
+        }
+    }
+
+    for( int iCores = 0; iCores < (int)( sizeof( iMaxCores ) / sizeof( iMaxCores[0] ) ); iCores++ )
+    {
+        for( int iImage = 0; iImage < s_iNumImages; iImage++ )
+        {
+            FillRandom( Images.m_Output[iImage], 0, 0, uWidth, uHeight );
+        }
+
+        SeparableFilterBatch Batch;
+        Batch.SetMaximumCores( iMaxCores[iCores] );
+        Batch.SetOutputSize( uWidth, uHeight );
+        Batch.SetInputSurfaces( pHorizInputs, pVertInputs, iNumInputs, s_iNumImages );
+        Batch.SetOutputSurfaces( ppFused ? NULL : Images.m_pTemps, Images.m_pOutputs );
+        Batch.SetFilters( ppHoriz, ppVert );
+        Batch.SetFusedFilters( ppFused );
+        Batch.OnRender();
+
+        Check( s_iNumImages == Batch.GetNumImages(), "Batch %s has %d images", szName, Batch.GetNumImages() );
+        for( int iImage = 0; iImage < s_iNumImages; iImage++ )
+        {
+            CheckIdentical( Reference[iImage], Images.m_Output[iImage], "Batch %s %ux%u image %d on %u threads", szName, uWidth, uHeight, iImage,
+                Batch.GetNumThreads() );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Separate, fused and two input passes, on images that fill many groups and images smaller
+// than one group
+//--------------------------------------------------------------------------------------
+void TestSeparableFilterBatch()
+{
+    static const unsigned int uWidths[] = { 133, 7 };
+    static const unsigned int uHeights[] = { 71, 5 };
+    static const int iRadii[] = { 3, 20 };
+
+    const float fNear = 0.1f;
+    const float fFar = 125.0f;
+    float fProjParams[4];
+    fProjParams[1] = fFar / ( fFar - fNear );
+    fProjParams[0] = fProjParams[1] * fNear;
+    fProjParams[2] = fProjParams[3] = 0.0f;
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        const unsigned int uWidth = uWidths[iSize];
+        const unsigned int uHeight = uHeights[iSize];
+
+        BatchImages Images;
+        Images.Create( uWidth, uHeight );
+
+        for( int iRadius = 0; iRadius < (int)( sizeof( iRadii ) / sizeof( iRadii[0] ) ); iRadius++ )
+        {
+            const int iKernelRadius = iRadii[iRadius];
+
+            GaussianFilterX GaussianX[s_iNumImages];
+            GaussianFilterY GaussianY[s_iNumImages];
+            GaussianFilterFused GaussianFused[s_iNumImages];
+            BilateralFilterX BilateralX[s_iNumImages];
+            BilateralFilterY BilateralY[s_iNumImages];
+            FilterPass* pGaussianX[s_iNumImages];
+            FilterPass* pGaussianY[s_iNumImages];
+            FilterPass* pGaussianFused[s_iNumImages];
+            FilterPass* pBilateralX[s_iNumImages];
+            FilterPass* pBilateralY[s_iNumImages];
+            for( int iImage = 0; iImage < s_iNumImages; iImage++ )
+            {
+                GaussianX[iImage].SetKernel( iKernelRadius, false );
+                GaussianY[iImage].SetKernel( iKernelRadius, false );
+                GaussianFused[iImage].SetKernel( iKernelRadius, false );
+                BilateralX[iImage].SetKernel( iKernelRadius, false );
+                BilateralY[iImage].SetKernel( iKernelRadius, false );
+                BilateralX[iImage].SetProjParams( fProjParams );
+                BilateralY[iImage].SetProjParams( fProjParams );
+                pGaussianX[iImage] = &GaussianX[iImage];
+                pGaussianY[iImage] = &GaussianY[iImage];
+                pGaussianFused[iImage] = &GaussianFused[iImage];
+                pBilateralX[iImage] = &BilateralX[iImage];
+                pBilateralY[iImage] = &BilateralY[iImage];
+            }
+
+            TestBatch( Images, uWidth, uHeight, 1, pGaussianX, pGaussianY, NULL, "Gaussian" );
+            TestBatch( Images, uWidth, uHeight, 1, pGaussianX, pGaussianY, pGaussianFused, "Gaussian fused" );
+            TestBatch( Images, uWidth, uHeight, 2, pBilateralX, pBilateralY, NULL, "bilateral" );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,227 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestSummedAreaTable.cpp
+//
+// Tests the summed area table and the variable blur against brute force box means, on
+// HDR images large enough that a float table would lose the input's precision.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/SummedAreaTable.h"
+
+#include <math.h>
+
+using namespace CPUFilter;
+
+
+// Relative to the mean, or to 1 for means under 1
+static const double s_dTolerance = 1e-5;
+
+// Largest HDR input
+static const float s_fHDRScale = 1000.0f;
+
+
+//--------------------------------------------------------------------------------------
+// Mean of a rectangle of texels, in doubles
+//--------------------------------------------------------------------------------------
+static void BoxMean( const Surface& Input, int iX0, int iY0, int iX1, int iY1, double* pMean )
+{
+    pMean[0] = pMean[1] = pMean[2] = pMean[3] = 0.0;
+
+    for( int iY = iY0; iY <= iY1; iY++ )
+    {
+        for( int iX = iX0; iX <= iX1; iX++ )
+        {
+            const float* pTexel = &Input.Row( iY )[iX].x;
+            for( int c = 0; c < 4; c++ )
+            {
+                pMean[c] += pTexel[c];
+            }
+        }
+    }
+
+    const double dCount = (double)( iX1 - iX0 + 1 ) * (double)( iY1 - iY0 + 1 );
+    for( int c = 0; c < 4; c++ )
+    {
+        pMean[c] /= dCount;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Difference of a texel from the reference, relative to the reference or to 1
+//--------------------------------------------------------------------------------------
+static double RelativeDifference( const Float4& f4Value, const double* pReference, int iNumChannels )
+{
+    const float* pValue = &f4Value.x;
+    double dMax = 0.0;
+
+    for( int c = 0; c < iNumChannels; c++ )
+    {
+        const double dScale = ( fabs( pReference[c] ) > 1.0 ) ? fabs( pReference[c] ) : 1.0;
+        const double dDifference = fabs( pValue[c] - pReference[c] ) / dScale;
+        dMax = ( dDifference > dMax ) ? dDifference : dMax;
+    }
+
+    return dMax;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Builds the table of images up to 2048x1024 with HDR values up to 1000, whose sums reach
+// 2^31. Small rectangles at the far corner, where the differences of the sums cancel the
+// most, and random rectangles must keep the input's precision, as must the variable blur
+// at a sample of pixels.
+//--------------------------------------------------------------------------------------
+void TestSummedAreaTable()
+{
+    static const unsigned int uWidths[] = { 257, 2048 };
+    static const unsigned int uHeights[] = { 67, 1024 };
+    static const float fMaxRadius = 8.0f;
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        const unsigned int uWidth = uWidths[iSize];
+        const unsigned int uHeight = uHeights[iSize];
+        const int iLastX = (int)uWidth - 1;
+        const int iLastY = (int)uHeight - 1;
+
+        Surface Input, Radii, Output;
+        SummedAreaTable Table;
+        Input.Create( uWidth, uHeight );
+        Radii.Create( uWidth, uHeight );
+        Output.Create( uWidth, uHeight );
+        Table.Create( uWidth, uHeight );
+        FillRandom( Radii, 0, 0, uWidth, uHeight );
+
+        for( unsigned int uY = 0; uY < uHeight; uY++ )
+        {
+            for( unsigned int uX = 0; uX < uWidth; uX++ )
+            {
+                Input.Row( uY )[uX] = MakeFloat4( Random() * s_fHDRScale, Random() * s_fHDRScale, Random(), 1.0f );
+            }
+        }
+
+        const Surface* pInputs[2] = { &Input, &Radii };
+
+        SummedAreaTableX TableX;
+        SummedAreaTableY TableY;
+        TableX.SetTable( &Table );
+        TableY.SetTable( &Table );
+
+        SeparableFilterCPU Filter;
+        Filter.SetOutputSize( uWidth, uHeight );
+        Filter.SetInputSurfaces( pInputs, pInputs, 2 );
+        Filter.SetOutputSurfaces( NULL, NULL );
+        Filter.SetFilters( &TableX, &TableY );
+        Filter.OnRender();
+
+        // Rectangles of 1, 2x2 and 3x5 texels at the far corner, then random ones
+        double dMaxError = 0.0;
+        double dMean[4];
+        for( int iRect = 0; iRect < 1003; iRect++ )
+        {
+            static const int iCornerSizes[3][2] = { { 1, 1 }, { 2, 2 }, { 3, 5 } };
+
+            int iX0, iY0, iX1, iY1;
+            if( iRect < 3 )
+            {
+                iX1 = iLastX;
+                iY1 = iLastY;
+                iX0 = iX1 - iCornerSizes[iRect][0] + 1;
+                iY0 = iY1 - iCornerSizes[iRect][1] + 1;
+            }
+            else
+            {
+                iX0 = (int)( Random() * iLastX );
+                iY0 = (int)( Random() * iLastY );
+                iX1 = iX0 + (int)( Random() * 20.0f );
+                iY1 = iY0 + (int)( Random() * 20.0f );
+                iX1 = ( iX1 < iLastX ) ? iX1 : iLastX;
+                iY1 = ( iY1 < iLastY ) ? iY1 : iLastY;
+            }
+
+            BoxMean( Input, iX0, iY0, iX1, iY1, dMean );
+            const double dError = RelativeDifference( Table.Mean( iX0, iY0, iX1, iY1 ), dMean, 4 );
+            dMaxError = ( dError > dMaxError ) ? dError : dMaxError;
+        }
+        BoxMean( Input, 0, 0, iLastX, iLastY, dMean );
+        const double dError = RelativeDifference( Table.Mean( 0, 0, iLastX, iLastY ), dMean, 4 );
+        dMaxError = ( dError > dMaxError ) ? dError : dMaxError;
+
+        CheckError( (float)dMaxError, (float)s_dTolerance, "Summed area table %ux%u", uWidth, uHeight );
+
+        // The blur of a sample of pixels, and every pixel of the far corner, against the
+        // brute force boxes of their radius and the next, clipped to the image
+        VariableBlurSAT Blur;
+        Blur.SetTable( &Table );
+        Blur.SetMaxRadius( fMaxRadius );
+
+        FillRandom( Output, 0, 0, uWidth, uHeight );
+        Filter.SetOutputSurfaces( NULL, &Output );
+        Filter.SetFusedFilter( &Blur );
+        Filter.OnRender();
+        Filter.SetFusedFilter( NULL );
+
+        dMaxError = 0.0;
+        for( int iY = 0; iY < (int)uHeight; iY++ )
+        {
+            for( int iX = 0; iX < (int)uWidth; iX++ )
+            {
+                if( 0 != ( iY * uWidth + iX ) % 97 && ( iX < iLastX - 16 || iY < iLastY - 16 ) )
+                {
+                    continue;
+                }
+
+                const float fRadius = Radii.Row( iY )[iX].w * fMaxRadius;
+                const int iRadius = (int)fRadius;
+                const double dBlend = fRadius - (float)iRadius;
+
+                double dNext[4];
+                BoxMean( Input, ( iX - iRadius > 0 ) ? iX - iRadius : 0, ( iY - iRadius > 0 ) ? iY - iRadius : 0,
+                    ( iX + iRadius < iLastX ) ? iX + iRadius : iLastX, ( iY + iRadius < iLastY ) ? iY + iRadius : iLastY, dMean );
+                BoxMean( Input, ( iX - iRadius - 1 > 0 ) ? iX - iRadius - 1 : 0, ( iY - iRadius - 1 > 0 ) ? iY - iRadius - 1 : 0,
+                    ( iX + iRadius + 1 < iLastX ) ? iX + iRadius + 1 : iLastX, ( iY + iRadius + 1 < iLastY ) ? iY + iRadius + 1 : iLastY, dNext );
+                for( int c = 0; c < 3; c++ )
+                {
+                    dMean[c] = dMean[c] * ( 1.0 - dBlend ) + dNext[c] * dBlend;
+                }
+
+                const double dBlurError = RelativeDifference( Output.Row( iY )[iX], dMean, 3 );
+                dMaxError = ( dBlurError > dMaxError ) ? dBlurError : dMaxError;
+            }
+        }
+
+        CheckError( (float)dMaxError, (float)s_dTolerance, "Variable blur %ux%u", uWidth, uHeight );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
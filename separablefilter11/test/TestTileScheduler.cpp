@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//--------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------
+// File: TestTileScheduler.cpp
+//
+// Tests the thread counts set on the tile scheduler, and that the output does not depend
+// on how many threads computed the tiles.
+//--------------------------------------------------------------------------------------
+
+
+#include "CPUFilterTest.h"
+#include "CPU/SeparableFilterCPU.h"
+#include "CPU/HorizontalFilter.h"
+#include "CPU/VerticalFilter.h"
+#include "CPU/GaussianFilter.h"
+#include "CPU/GaussianFilterSIMD.h"
+#include "CPU/CPUInfo.h"
+
+using namespace CPUFilter;
+
+
+//--------------------------------------------------------------------------------------
+// Each max cores type, and explicit counts, are reported back as set
+//--------------------------------------------------------------------------------------
+static void TestMaximumCores()
+{
+    const unsigned int uNumCores = GetCPUInfo().m_uNumLogicalCores;
+
+    TileScheduler Scheduler;
+    Check( Scheduler.GetMaximumCores() == MAXCORES_USE_ALL_CORES && Scheduler.GetNumThreads() == uNumCores,
+        "Scheduler default %d cores %u threads", Scheduler.GetMaximumCores(), Scheduler.GetNumThreads() );
+
+    Scheduler.SetMaximumCores( MAXCORES_SINGLE_THREADED );
+    Check( Scheduler.GetMaximumCores() == MAXCORES_SINGLE_THREADED && Scheduler.GetNumThreads() == 1,
+        "Scheduler single threaded %d cores %u threads", Scheduler.GetMaximumCores(), Scheduler.GetNumThreads() );
+
+    const unsigned int uAllButOne = ( uNumCores > 1 ) ? ( uNumCores - 1 ) : 1;
+    Scheduler.SetMaximumCores( MAXCORES_USE_ALL_BUT_ONE );
+    Check( Scheduler.GetMaximumCores() == MAXCORES_USE_ALL_BUT_ONE && Scheduler.GetNumThreads() == uAllButOne,
+        "Scheduler all but one %d cores %u threads", Scheduler.GetMaximumCores(), Scheduler.GetNumThreads() );
+
+    Scheduler.SetMaximumCores( MAXCORES_MULTI_THREADED );
+    Check( Scheduler.GetMaximumCores() == MAXCORES_USE_ALL_BUT_ONE && Scheduler.GetNumThreads() == uAllButOne,
+        "Scheduler multi threaded %d cores %u threads", Scheduler.GetMaximumCores(), Scheduler.GetNumThreads() );
+
+    Scheduler.SetMaximumCores( MAXCORES_2X_CPU_CORES );
+    Check( Scheduler.GetMaximumCores() == MAXCORES_2X_CPU_CORES && Scheduler.GetNumThreads() == uNumCores * 2,
+        "Scheduler 2x cores %d cores %u threads", Scheduler.GetMaximumCores(), Scheduler.GetNumThreads() );
+
+    static const int iCounts[] = { 2, 3, 7 };
+    for( int iCount = 0; iCount < (int)( sizeof( iCounts ) / sizeof( iCounts[0] ) ); iCount++ )
+    {
+        Scheduler.SetMaximumCores( iCounts[iCount] );
+        Check( Scheduler.GetMaximumCores() == iCounts[iCount] && Scheduler.GetNumThreads() == (unsigned int)iCounts[iCount],
+            "Scheduler explicit %d: %d cores %u threads", iCounts[iCount], Scheduler.GetMaximumCores(), Scheduler.GetNumThreads() );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Renders with several thread counts, which must match the single threaded output exactly
+//--------------------------------------------------------------------------------------
+static void TestThreadCounts()
+{
+    static const unsigned int uWidths[] = { 333, 5, 1000 };
+    static const unsigned int uHeights[] = { 61, 300, 2 };
+    static const int iMaxCores[] = { 2, 3, 7, MAXCORES_USE_ALL_CORES, MAXCORES_2X_CPU_CORES };
+    static const int iKernelRadius = 16;
+
+    for( int iSize = 0; iSize < (int)( sizeof( uWidths ) / sizeof( uWidths[0] ) ); iSize++ )
+    {
+        const unsigned int uWidth = uWidths[iSize];
+        const unsigned int uHeight = uHeights[iSize];
+
+        Surface Input, Temp, Output, Reference;
+        Input.Create( uWidth, uHeight );
+        Temp.Create( uWidth, uHeight );
+        Output.Create( uWidth, uHeight );
+        Reference.Create( uWidth, uHeight );
+        FillRandom( Input, 0, 0, uWidth, uHeight );
+
+        const Surface* pInputs[1] = { &Input };
+        const Surface* pIntermediates[1] = { &Temp };
+
+        HorizontalFilter<GaussianFilter> HookX;
+        VerticalFilter<GaussianFilter> HookY;
+        GaussianFilterX FilterX;
+        GaussianFilterY FilterY;
+        HookX.SetKernel( iKernelRadius, false );
+        HookY.SetKernel( iKernelRadius, false );
+        FilterX.SetKernel( iKernelRadius, false );
+        FilterY.SetKernel( iKernelRadius, false );
+
+        FilterPass* pFilters[2][2] = { { &HookX, &HookY }, { &FilterX, &FilterY } };
+        static const char* pFilterNames[2] = { "hook", "SIMD" };
+
+        SeparableFilterCPU Filter;
+        Filter.SetOutputSize( uWidth, uHeight );
+        Filter.SetInputSurfaces( pInputs, pIntermediates, 1 );
+
+        for( int iFilter = 0; iFilter < 2; iFilter++ )
+        {
+            Filter.SetFilters( pFilters[iFilter][0], pFilters[iFilter][1] );
+
+            Filter.SetMaximumCores( MAXCORES_SINGLE_THREADED );
+            Filter.SetOutputSurfaces( &Temp, &Reference );
+            Filter.OnRender();
+
+            Filter.SetOutputSurfaces( &Temp, &Output );
+            for( int iCores = 0; iCores < (int)( sizeof( iMaxCores ) / sizeof( iMaxCores[0] ) ); iCores++ )
+            {
+                Filter.SetMaximumCores( iMaxCores[iCores] );
+                Filter.OnRender();
+                CheckIdentical( Reference, Output, "Scheduler %s %ux%u max cores %d (%u threads)",
+                    pFilterNames[iFilter], uWidth, uHeight, iMaxCores[iCores], Filter.GetNumThreads() );
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Entry point of the tests of this file
+//--------------------------------------------------------------------------------------
+void TestTileScheduler()
+{
+    TestMaximumCores();
+    TestThreadCounts();
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------